@@ -46,6 +46,7 @@
 #include "extensions/PxRevoluteJoint.h"
 #include "extensions/PxSphericalJoint.h"
 #include "extensions/PxD6Joint.h"
+#include "extensions/PxJointBatchSolverPrep.h"
 
 #include "extensions/PxDefaultSimulationFilterShader.h"
 #include "extensions/PxDefaultErrorCallback.h"
@@ -63,6 +64,8 @@
 #include "extensions/PxSimpleFactory.h"
 
 #include "extensions/PxVisualDebuggerExt.h"
+#include "extensions/PxVisualDebuggerCapture.h"
+#include "extensions/PxProfileZoneAggregator.h"
 #include "extensions/PxStringTableExt.h"
 
 #ifdef PX_PS3
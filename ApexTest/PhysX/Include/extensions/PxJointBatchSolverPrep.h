@@ -0,0 +1,89 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_JOINT_BATCH_SOLVER_PREP_H
+#define PX_PHYSICS_EXTENSIONS_JOINT_BATCH_SOLVER_PREP_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "PxPhysX.h"
+
+#ifndef PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxJoint;
+struct Px1DConstraint;
+
+/**
+\brief The most solver rows PxJointBatchSolverPrep() writes for a single joint.
+*/
+#define PX_JOINT_MAX_SOLVER_ROWS 16
+
+/**
+\brief Prepares the solver rows of many joints at once.
+
+This computes the same rows as the solver prep functions the SDK calls one joint at a time, for use by 
+applications that run their own constraint solver or solver setup. Joints are grouped by type and the 
+frame math of D6, revolute, spherical, fixed and prismatic joints runs four joints at a time on SIMD
+registers. Distance joints use the single joint path.
+
+The rows of a joint are contiguous and start at rows[firstRows[i]]. Rows are written in the order in 
+which the joints are prepared, which is not the input order. A joint is only prepared while at least 
+PX_JOINT_MAX_SOLVER_ROWS rows are left, joints that do not fit get a firstRows entry of 0xffffffff and
+an nbRows entry of 0. A buffer of nbJoints * PX_JOINT_MAX_SOLVER_ROWS rows always suffices.
+
+The constant block of each joint is updated the way the SDK updates it before a simulation step, so the 
+joints must not be modified while this runs. Different threads may prepare disjoint sets of joints.
+
+\param[in] joints The joints, which must have been created by the joint creation functions of PhysXExtensions.
+\param[in] body0ToWorld The world transform of the center of mass frame of each joint's first body, the identity for a static actor or the world.
+\param[in] body1ToWorld The same for each joint's second body.
+\param[in] nbJoints The number of joints.
+\param[out] rows The row buffer, 16 byte aligned.
+\param[in] maxRows The size of the row buffer.
+\param[out] firstRows The index of the first row of each joint.
+\param[out] nbRows The number of rows of each joint.
+\param[out] body0WorldOffsets The body0WorldOffset of each joint, see PxConstraintSolverPrep.
+\return The number of rows written.
+
+@see PxConstraintSolverPrep PxJoint
+*/
+PxU32 PxJointBatchSolverPrep(PxJoint* const* joints, const PxTransform* body0ToWorld, const PxTransform* body1ToWorld, PxU32 nbJoints,
+							 Px1DConstraint* rows, PxU32 maxRows, PxU32* firstRows, PxU32* nbRows, PxVec3* body0WorldOffsets);
+
+#ifndef PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif // PX_PHYSICS_EXTENSIONS_JOINT_BATCH_SOLVER_PREP_H
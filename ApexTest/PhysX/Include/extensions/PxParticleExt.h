@@ -100,6 +100,71 @@ public:
 								 const PxU32 maxBounds,
 								 const PxReal gridSpacing);
 
+	/**
+	\brief Scratch memory and worker threads for repeated PxParticleExt::buildBoundsHash() calls.
+
+	A context keeps its internal arrays between calls, so building bounds every frame does not
+	allocate once the largest particle count has been seen. If the context was created with worker
+	threads, particles are binned in parallel with per-thread histograms and bounds, which are
+	merged and scattered in a deterministic order. The output is identical to the context-free
+	PxParticleExt::buildBoundsHash() version.
+
+	A context must not be used by more than one thread at a time.
+	The instance can be created with PxParticleExt::createBoundsHashContext().
+	*/
+	class BoundsHashContext
+	{
+	public:
+		/**
+		\brief Returns the number of worker threads owned by the context.
+		*/
+		virtual		PxU32	getNbWorkerThreads() const													= 0;
+
+		/**
+		\brief Releases BoundsHashContext instance and joins its worker threads.
+		*/
+		virtual		void	release()																	= 0;
+
+		/**
+		\brief virtual destructor
+		*/
+		virtual ~BoundsHashContext() {};
+	};
+
+	/**
+	\brief Creates a PxParticleExt::BoundsHashContext instance.
+	\param[in] numWorkerThreads Number of additional threads helping the calling thread. Zero runs everything on the calling thread.
+	*/
+	static BoundsHashContext* createBoundsHashContext(PxU32 numWorkerThreads = 0);
+
+	/**
+	\brief Computes particle bounds by sorting particle positions into a spatial hash grid, reusing the scratch memory and threads of a context.
+
+	Parameters and results are the same as for the context-free version of buildBoundsHash().
+
+	\param[in] context Context created with PxParticleExt::createBoundsHashContext().
+	\param[out] sortedParticleIndices Pointer to user allocated array of size numParticles where the sorted particle indices will be written to.
+	\param[out] particleBounds Pointer to user allocated array of size maxBounds where the ParticleBounds will be written to.
+	\param[in] positionBuffer Strided data of input particle positions.
+	\param[in] validParticleRange Range of valid particles within validParticleBitmap. (See PxParticleReadData.validParticleRange).
+	\param[in] validParticleBitmap  Bitmap specifying valid slots in positionBuffer. (See PxParticleReadData.validParticleBitmap).
+	\param[in] hashSize Hash size used internally by the hashing algorithm. Must be a power of two.
+	\param[in] maxBounds Maximum number of bounds to be returned. Must be smaller or equal than hashSize.
+	\param[in] gridSpacing Side length of each cubical grid cell.
+	\return PxU32. Number of ParticleBounds data structures written to the particleBounds buffer. Smaller or equal than maxBounds.
+
+	@see buildBoundsHash() createBoundsHashContext()
+	*/
+	static PxU32 buildBoundsHash(BoundsHashContext& context,
+								 PxU32* sortedParticleIndices,
+								 ParticleBounds* particleBounds,
+								 const PxStrideIterator<const PxVec3>& positionBuffer,
+								 const PxU32 validParticleRange,
+								 const PxU32* validParticleBitmap,
+								 const PxU32 hashSize,
+								 const PxU32 maxBounds,
+								 const PxReal gridSpacing);
+
 	/**
 	\brief Class to manage particle indices.
 	Extension particle index management can be useful if no application side particle index allocation 
@@ -0,0 +1,195 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_PROFILE_ZONE_AGGREGATOR_H
+#define PX_PHYSICS_EXTENSIONS_PROFILE_ZONE_AGGREGATOR_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "PxPhysX.h"
+
+#ifndef PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxProfileZoneManager;
+class PxOutputStream;
+
+/**
+\brief Timing summary of one profile event of one profile zone.
+
+Times are in milliseconds. The inclusive time of an event is the time between its start and stop event, the
+exclusive time is the inclusive time minus the inclusive time of the events nested in it on the same thread.
+Percentiles are taken over the per frame sums of the frames in which the event was stopped at least once.
+
+@see PxProfileZoneAggregator
+*/
+struct PxProfileZoneEventStats
+{
+	const char*	zoneName;			//!< Name of the profile zone.
+	const char*	eventName;			//!< Name of the event, as registered with the zone.
+	PxU16		eventId;			//!< Id of the event in its zone.
+	PxU32		numFrames;			//!< Number of frames in which the event was stopped.
+	PxU32		numCalls;			//!< Number of times the event was stopped.
+	PxF64		inclusiveTotal;		//!< Sum of the inclusive times.
+	PxF64		inclusiveP50;		//!< Median inclusive time per frame.
+	PxF64		inclusiveP95;		//!< 95th percentile of the inclusive time per frame.
+	PxF64		inclusiveP99;		//!< 99th percentile of the inclusive time per frame.
+	PxF64		inclusiveMax;		//!< Maximum inclusive time per frame.
+	PxF64		exclusiveTotal;		//!< Sum of the exclusive times.
+	PxF64		exclusiveP50;		//!< Median exclusive time per frame.
+	PxF64		exclusiveP95;		//!< 95th percentile of the exclusive time per frame.
+	PxF64		exclusiveP99;		//!< 99th percentile of the exclusive time per frame.
+	PxF64		exclusiveMax;		//!< Maximum exclusive time per frame.
+};
+
+struct PxProfileZoneReportFormat
+{
+	enum Enum
+	{
+		eJSON,
+		eCSV
+	};
+};
+
+/**
+\brief Header of a profile event stream written by PxProfileZoneAggregator::saveStream().
+
+The header is followed by records until the end of the file. Each record starts with two PxU32 values, the
+PxProfileZoneStreamRecord::Enum type of the record and the number of payload bytes that follow:
+
+\li eZONE: PxU32 zone index, followed by the null terminated zone name. Zone indices are assigned in order.
+\li eEVENT_NAME: PxU32 zone index, PxU32 event id, followed by the null terminated event name.
+\li eEVENTS: PxU32 zone index, followed by a block of serialized profile events as passed to
+PxProfileEventBufferClient::handleBufferFlush(). It can be parsed with PxProfileEventHandler::parseEventBuffer().
+\li eEND_FRAME: no payload, closes the current frame.
+
+All values are stored in the byte order of the writing platform. Event timestamps are in counter ticks,
+ticks * timestampNumerator / timestampDenominator gives tens of nanoseconds.
+*/
+struct PxProfileZoneStreamFileHeader
+{
+	enum
+	{
+		eMAGIC		= 0x505A5346,	//'PZSF'
+		eVERSION	= 1
+	};
+
+	PxU32	magic;					//!< eMAGIC
+	PxU32	version;				//!< eVERSION
+	PxU64	timestampNumerator;		//!< Counter ticks to tens of nanoseconds.
+	PxU64	timestampDenominator;	//!< Counter ticks to tens of nanoseconds.
+};
+
+struct PxProfileZoneStreamRecord
+{
+	enum Enum
+	{
+		eZONE		= 1,
+		eEVENT_NAME	= 2,
+		eEVENTS		= 3,
+		eEND_FRAME	= 4
+	};
+};
+
+/**
+\brief Collects the events of all profile zones of a profile zone manager and summarizes them per frame.
+
+This allows profiling on machines that cannot run PVD, and comparing the results of automated runs. Frames are
+delimited by calling endFrame() after PxScene::fetchResults(); it flushes the profile zone manager, so all
+events recorded during the frame are attributed to it. The raw event stream can optionally be kept and saved to 
+a file that the ProfileZoneStats command line tool turns into the same report, or compares against a baseline.
+
+The instance can be created with PxProfileZoneAggregatorCreate().
+*/
+class PxProfileZoneAggregator
+{
+public:
+	/**
+	\brief Flushes the profile zone manager and closes the current frame.
+	*/
+	virtual		void	endFrame()																		= 0;
+
+	/**
+	\brief Returns the number of frames closed by endFrame().
+	*/
+	virtual		PxU32	getNbFrames() const																= 0;
+
+	/**
+	\brief Returns the number of profile events seen so far.
+	*/
+	virtual		PxU32	getNbEventStats() const															= 0;
+
+	/**
+	\brief Returns the summary of a profile event. The names stay valid until the next call on this instance.
+	\return False if index is out of range.
+	*/
+	virtual		bool	getEventStats(PxU32 index, PxProfileZoneEventStats& stats) const				= 0;
+
+	/**
+	\brief Writes the summary of all profile events, one row or object per event.
+	\return False if the stream did not accept all the data.
+	*/
+	virtual		bool	writeReport(PxOutputStream& stream, PxProfileZoneReportFormat::Enum format) const	= 0;
+
+	/**
+	\brief Writes the recorded event stream, see PxProfileZoneStreamFileHeader for the layout.
+	\return False if the stream was not recorded or the file could not be written.
+	*/
+	virtual		bool	saveStream(const char* filename) const											= 0;
+
+	/**
+	\brief Detaches from the profile zone manager and releases the instance.
+	*/
+	virtual		void	release()																		= 0;
+
+protected:
+	virtual ~PxProfileZoneAggregator() {}
+};
+
+/**
+\brief Creates an aggregator that subscribes to all current and future zones of a profile zone manager.
+
+\param[in] manager The profile zone manager, for example PxPhysics::getProfileZoneManager().
+\param[in] recordStream Keep the raw event stream so it can be written with PxProfileZoneAggregator::saveStream().
+The recording grows with every frame.
+
+@see PxProfileZoneAggregator
+*/
+PxProfileZoneAggregator* PxProfileZoneAggregatorCreate(PxProfileZoneManager& manager, bool recordStream = false);
+
+#ifndef PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif // PX_PHYSICS_EXTENSIONS_PROFILE_ZONE_AGGREGATOR_H
@@ -148,6 +148,68 @@ public:
 	@see PxRigidBody::setCMassLocalPose PxRigidBody::setMassSpaceInertia PxRigidBody::setMass
 	*/
 	static		bool			setMassAndUpdateInertia(PxRigidBody& body, PxReal mass, const PxVec3* massLocalPose = NULL);
+
+	/**
+	\brief Cache of the unit density mass properties of convex meshes, used by the multi-body versions of 
+	updateMassAndInertia() and setMassAndUpdateInertia().
+
+	Entries are kept per convex mesh and mesh scale. Call clear() before releasing a convex mesh that went 
+	through the cache, a mesh created later at the same address would get its entries otherwise.
+
+	A cache must not be used by more than one thread at a time.
+	The instance can be created with PxRigidBodyExt::createMassPropertiesCache().
+	*/
+	class MassPropertiesCache
+	{
+	public:
+		/**
+		\brief Drops the cached convex mesh entries.
+		*/
+		virtual		void	clear()		= 0;
+
+		/**
+		\brief Releases MassPropertiesCache instance.
+		*/
+		virtual		void	release()	= 0;
+
+		/**
+		\brief virtual destructor
+		*/
+		virtual ~MassPropertiesCache() {};
+	};
+
+	/**
+	\brief Creates a PxRigidBodyExt::MassPropertiesCache instance.
+	*/
+	static		MassPropertiesCache*	createMassPropertiesCache();
+
+	/**
+	\brief Computation of mass properties for many rigid body actors
+
+	Does the same as updateMassAndInertia() with a single density for each body. The shapes of all bodies are 
+	summed together, which gives the same results up to float rounding.
+
+	\param[in] cache Cache created with PxRigidBodyExt::createMassPropertiesCache().
+	\param[in,out] bodies The rigid bodies.
+	\param[in] nbBodies Number of bodies.
+	\param[in] densities The density of each body. The densities must be greater than 0.
+	\param[in] massLocalPoses The center of mass relative to the actor frame for each body. If set to null then the computed center of mass is used.
+	\param[out] results Optional array of size nbBodies. Receives for each body what updateMassAndInertia() would return.
+	\return The number of bodies the computation succeeded for.
+
+	@see updateMassAndInertia() createMassPropertiesCache()
+	*/
+	static		PxU32			updateMassAndInertia(MassPropertiesCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* densities, const PxVec3* massLocalPoses = NULL, bool* results = NULL);
+
+	/**
+	\brief Computation of mass properties for many rigid body actors
+
+	Does the same as setMassAndUpdateInertia() with a single mass for each body. Parameters and return value
+	are the same as for the multi-body version of updateMassAndInertia(), with a mass instead of a density per body.
+
+	@see setMassAndUpdateInertia() createMassPropertiesCache()
+	*/
+	static		PxU32			setMassAndUpdateInertia(MassPropertiesCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* masses, const PxVec3* massLocalPoses = NULL, bool* results = NULL);
 	
 
 	/**
@@ -334,6 +396,83 @@ public:
 	*/
 	static		void			linearSweepMultiple(PxRigidBody& body, PxBatchQuery& batchQuery, const PxVec3& unitDir, const PxReal distance,  PxSceneQueryFilterFlags filterFlags, bool useShapeFilterData = true, PxFilterData* filterDataList=NULL, PxU32 filterDataCount=0, void* userData=NULL, const PxSweepCache* sweepCache=NULL);
 
+	/**
+	\brief Cache of the shape descriptors (shape list, geometry, local pose and simulation filter data) of rigid bodies,
+	used by the multi-body versions of linearSweepSingle() and linearSweepMultiple().
+
+	The descriptors of a body are read on its first sweep and reused by later sweeps, so a sweep per frame
+	only reads the global pose of the body. Adding shapes to or removing shapes from a body is detected. Changing 
+	the geometry, local pose or simulation filter data of a shape is not, call invalidate() for the body afterwards. 
+	A body must also be invalidated before it is released.
+
+	A cache must not be used by more than one thread at a time.
+	The instance can be created with PxRigidBodyExt::createShapeCache().
+	*/
+	class ShapeCache
+	{
+	public:
+		/**
+		\brief Drops the cached descriptors of a body. They are read again on the next sweep of the body.
+		*/
+		virtual		void	invalidate(const PxRigidBody& body)		= 0;
+
+		/**
+		\brief Drops the cached descriptors of all bodies.
+		*/
+		virtual		void	invalidateAll()							= 0;
+
+		/**
+		\brief Releases ShapeCache instance.
+		*/
+		virtual		void	release()								= 0;
+
+		/**
+		\brief virtual destructor
+		*/
+		virtual ~ShapeCache() {};
+	};
+
+	/**
+	\brief Creates a PxRigidBodyExt::ShapeCache instance.
+	*/
+	static		ShapeCache*		createShapeCache();
+
+	/**
+	\brief Performs a linear sweep through space with the geometry objects of each body, using the descriptors of a shape cache.
+
+	Issues one PxBatchQuery::linearCompoundGeometrySweepSingle() per body, in body order, with the same 
+	arguments as linearSweepSingle(). The batch query reports the closest hit over all the shapes of a body 
+	as one result. Bodies without shapes issue no query.
+
+	\param[in] cache Cache created with PxRigidBodyExt::createShapeCache().
+	\param[in] bodies The rigid bodies to sweep.
+	\param[in] nbBodies Number of bodies.
+	\param[in] batchQuery The scene query object to process the queries.
+	\param[in] unitDirs Normalized direction of the sweep for each body.
+	\param[in] distances Sweep distance for each body. Need to be larger than 0.
+	\param[in] filterFlags Choose if to sweep against static, dynamic or both types of objects, or other filter logic. See #PxSceneQueryFilterFlags.
+	\param[in] useShapeFilterData True if the filter data of the body shapes should be used for the queries. False if no filtering is needed.
+	\param[in] userData User data for each body, or NULL to pass NULL for all queries.
+	\param[in] sweepCache Sweep cache to use with the queries
+	\param[out] resultIndices Optional array of size nbBodies. Receives for each body the index of its result among the sweeps issued by this call, or 0xffffffff if no query was issued for the body. Add the number of sweeps issued to batchQuery before this call to index the sweep results of the batch query.
+	\return The number of sweep queries issued.
+
+	@see linearSweepSingle() createShapeCache() PxBatchQuery::linearCompoundGeometrySweepSingle
+	*/
+	static		PxU32			linearSweepSingle(ShapeCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, PxBatchQuery& batchQuery, const PxVec3* unitDirs, const PxReal* distances, PxSceneQueryFilterFlags filterFlags, bool useShapeFilterData = true, void* const* userData=NULL, const PxSweepCache* sweepCache=NULL, PxU32* resultIndices=NULL);
+
+	/**
+	\brief Performs a linear sweep through space with the geometry objects of each body, using the descriptors of a shape cache and returning all overlaps.
+
+	Issues one PxBatchQuery::linearCompoundGeometrySweepMultiple() per body, in body order, with the same 
+	arguments as linearSweepMultiple(). Bodies without shapes issue no query.
+
+	Parameters and return value are the same as for the multi-body version of linearSweepSingle().
+
+	@see linearSweepMultiple() createShapeCache() PxBatchQuery::linearCompoundGeometrySweepMultiple
+	*/
+	static		PxU32			linearSweepMultiple(ShapeCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, PxBatchQuery& batchQuery, const PxVec3* unitDirs, const PxReal* distances, PxSceneQueryFilterFlags filterFlags, bool useShapeFilterData = true, void* const* userData=NULL, const PxSweepCache* sweepCache=NULL, PxU32* resultIndices=NULL);
+
 };
 
 #ifndef PX_DOXYGEN
@@ -0,0 +1,164 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_VISUAL_DEBUGGER_CAPTURE_H
+#define PX_PHYSICS_EXTENSIONS_VISUAL_DEBUGGER_CAPTURE_H
+/** \addtogroup extensions
+  @{
+*/
+
+#include "PxPhysX.h"
+#include "extensions/PxVisualDebuggerExt.h"
+
+#ifndef PX_DOXYGEN
+namespace physx
+{
+#endif
+
+class PxScene;
+
+/**
+\brief Per frame summary stored next to the PVD stream data of each captured frame.
+
+@see PxVisualDebuggerCapture
+*/
+struct PxVisualDebuggerCaptureFrameStats
+{
+	PxU32	frameIndex;				//!< Number of PxVisualDebuggerCapture::endFrame() calls before this frame.
+	PxReal	frameTime;				//!< Wall clock time since the previous PxVisualDebuggerCapture::endFrame() call, in seconds.
+	PxU32	numStaticBodies;		//!< See PxSimulationStatistics::numStaticBodies.
+	PxU32	numDynamicBodies;		//!< See PxSimulationStatistics::numDynamicBodies.
+	PxU32	numActiveDynamicBodies;	//!< See PxSimulationStatistics::numActiveDynamicBodies.
+	PxU32	numActiveConstraints;	//!< See PxSimulationStatistics::numActiveConstraints.
+	PxU32	numContactPairs;		//!< Sum of all PxSimulationStatistics::numDiscreteContactPairs entries.
+	PxU32	numProfileZones;		//!< Number of profile zones that flushed events during the frame.
+	PxU32	numProfileEvents;		//!< Number of profile zone start events flushed during the frame.
+	PxU32	numAllocations;			//!< Foundation allocations during the frame. Only recorded with PxVisualDebuggerConnectionFlag::Memory.
+	PxU32	numDeallocations;		//!< Foundation deallocations during the frame. Only recorded with PxVisualDebuggerConnectionFlag::Memory.
+	PxU32	allocatedBytes;			//!< Bytes allocated during the frame, saturating at 0x7fffffff. Only recorded with PxVisualDebuggerConnectionFlag::Memory.
+	PxU32	pvdByteCount;			//!< Size of the PVD stream data recorded for the frame.
+};
+
+/**
+\brief Header of a capture file written by PxVisualDebuggerCapture::save().
+
+The header is followed by prologueByteCount bytes of PVD stream data that were sent before the first frame
+(class descriptions and the initial scene contents). After that numFrames frames follow, each stored as a 
+PxVisualDebuggerCaptureFrameStats structure followed by PxVisualDebuggerCaptureFrameStats::pvdByteCount bytes 
+of PVD stream data. All values are stored in the byte order of the writing platform.
+
+If numDroppedFrames is zero, the prologue and frame data concatenated form a complete PVD stream that can be 
+loaded by PVD. Otherwise the objects created during the dropped frames are missing from the stream.
+*/
+struct PxVisualDebuggerCaptureFileHeader
+{
+	enum
+	{
+		eMAGIC		= 0x50564443,	//'PVDC'
+		eVERSION	= 1
+	};
+
+	PxU32	magic;					//!< eMAGIC
+	PxU32	version;				//!< eVERSION
+	PxU32	frameStatsSize;			//!< sizeof(PxVisualDebuggerCaptureFrameStats) of the writer.
+	PxU32	numFrames;				//!< Number of frames stored in the file.
+	PxU32	numDroppedFrames;		//!< Number of older frames that were dropped from the ring.
+	PxU32	prologueByteCount;		//!< Size of the PVD stream data preceding the first frame.
+};
+
+/**
+\brief Records the PVD event stream to memory, keeping the stream prologue and a bounded ring of recent frames.
+
+This is intended for machines that cannot run PVD: the capture can be written to disk on demand, for example 
+after a slow frame was detected, or when the capture is released. The resulting file can be inspected with
+the PvdCaptureStats command line tool.
+
+Frames are delimited by calling endFrame() after PxScene::fetchResults(). All PVD data written between two 
+endFrame() calls is attributed to the frame. The profile events and memory statistics are attributed to
+the frame in which they were flushed by the profile zones or reported by the foundation allocator.
+
+The capture is held in memory only; nothing is written to disk before save() or release() is called. If the
+process crashes, everything recorded since the last save() is lost. Applications that need the frames leading
+up to a crash should call save() from their crash handler or periodically, for example every few hundred frames.
+With maxFrames set to zero the memory use grows with every frame until the capture is released.
+
+The instance can be created with PxVisualDebuggerExt::createCapture().
+*/
+class PxVisualDebuggerCapture
+{
+public:
+	/**
+	\brief Closes the current frame and starts a new one.
+
+	If the ring is full the oldest frame is dropped.
+
+	\param[in] scene Scene whose simulation statistics are stored with the frame.
+	*/
+	virtual		void	endFrame(const PxScene& scene)											= 0;
+
+	/**
+	\brief Returns the number of frames currently held in the ring.
+	*/
+	virtual		PxU32	getNbFrames() const														= 0;
+
+	/**
+	\brief Returns the maximum number of frames held in the ring. Zero means all frames are kept.
+	*/
+	virtual		PxU32	getMaxFrames() const													= 0;
+
+	/**
+	\brief Returns the statistics of a frame in the ring, 0 being the oldest.
+	\return False if index is out of range.
+	*/
+	virtual		bool	getFrameStats(PxU32 index, PxVisualDebuggerCaptureFrameStats& stats) const	= 0;
+
+	/**
+	\brief Writes the prologue and all frames in the ring to a file. The capture keeps recording.
+	\param[in] filename File to write, see PxVisualDebuggerCaptureFileHeader for the layout.
+	\return False if the file could not be written.
+	*/
+	virtual		bool	save(const char* filename)												= 0;
+
+	/**
+	\brief Disconnects from the PVD connection manager, saves the capture to the file name passed to 
+	PxVisualDebuggerExt::createCapture() (if any) and releases the instance.
+	*/
+	virtual		void	release()																= 0;
+
+protected:
+	virtual ~PxVisualDebuggerCapture() {}
+};
+
+#ifndef PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif // PX_PHYSICS_EXTENSIONS_VISUAL_DEBUGGER_CAPTURE_H
@@ -111,6 +111,9 @@ struct PxVisualDebuggerConnectionFlag
 typedef physx::PxFlags<PxVisualDebuggerConnectionFlag::Enum, PxU32> PxVisualDebuggerConnectionFlags;
 PX_FLAGS_OPERATORS( PxVisualDebuggerConnectionFlag::Enum, PxU32 );
 
+class PxPhysics;
+class PxVisualDebuggerCapture;
+
 /**
 class that contains all the data relevant for updating and visualizing extensions like joints in PVD
 */
@@ -147,6 +150,24 @@ public:
 													, const char* filename
 													, PxVisualDebuggerConnectionFlags inConnectionType = getDefaultConnectionFlags() );
 
+	/**
+		Connect to pvd through an in-memory capture that keeps the stream prologue and the most recent
+		frames.  The capture can be written to disk at any time and is written to filename when it is released.
+		The connection is made through the connection manager of inPhysics, which must not be connected already.
+		Releasing the capture only closes its own connection.
+		\param inPhysics The physics instance whose visual debugger data, profile zones and allocations are captured.
+		\param filename The file to write on PxVisualDebuggerCapture::release(), may be NULL.
+		\param maxFrames The number of recent frames kept in the capture.  Zero keeps every frame.
+		\param inConnectionType The type information you want sent over the connection.
+		\return The capture, or NULL if the visual debugger is not supported or the manager is already connected.
+
+		@see PxVisualDebuggerCapture
+	*/
+	static PxVisualDebuggerCapture* createCapture( PxPhysics& inPhysics
+													, const char* filename
+													, PxU32 maxFrames
+													, PxVisualDebuggerConnectionFlags inConnectionType = getDefaultConnectionFlags() );
+
 	/**	get the default connection flags
 
 	\return the default connection flags: debug data and profiling
@@ -404,12 +404,12 @@ protected:
 	/**
 	@see PxVehicleDrive4W::allocate, PxVehicleDriveTank::allocate
 	*/
-	static PxU32 computeByteSize(const PxU32 numWheels4);
+	static PxU32 computeByteSize(const PxU32 numWheels4, const bool sharedWheelsSimData=false);
 
 	/**
 	@see PxVehicleDrive4W::allocate, PxVehicleDriveTank::allocate
 	*/
-	static PxU8* patchupPointers(PxVehicleDrive* vehDrive, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels);
+	static PxU8* patchupPointers(PxVehicleDrive* vehDrive, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData=NULL);
 
 	/**
 	\brief Deallocate a PxVehicle4WDrive instance.
@@ -123,6 +123,7 @@ class PxVehicleDrive4W : public PxVehicleDrive
 public:
 
 	friend class PxVehicleUpdate;
+	friend class PxVehicleFleet;
 
 	/**
 	\brief The ordering of the driven and steered wheels
@@ -232,6 +233,18 @@ private:
 	\brief Test if the instanced dynamics and configuration data has legal values.
 	*/
 	bool isValid() const;
+
+	/**
+	\brief Byte size of a vehicle with numWheels, leaving out the wheels simulation data if sharedWheelsSimData is true.
+	@see allocate, PxVehicleFleet
+	*/
+	static PxU32 computeInstanceByteSize(const PxU32 numWheels, const bool sharedWheelsSimData);
+
+	/**
+	\brief Lay out a vehicle with numWheels in the memory at ptr, referencing the blocks of sharedWheelsSimData if it is not NULL.
+	@see allocate, PxVehicleFleet
+	*/
+	static PxVehicleDrive4W* patchupInstance(PxU8* ptr, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData);
 };
 PX_COMPILE_TIME_ASSERT(0==(sizeof(PxVehicleDrive4W) & 15));
 
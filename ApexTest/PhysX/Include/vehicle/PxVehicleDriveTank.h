@@ -62,6 +62,7 @@ class PxVehicleDriveTank : public PxVehicleDrive
 public:
 
 	friend class PxVehicleUpdate;
+	friend class PxVehicleFleet;
 
 	/**
 	\brief The ordering of the driven wheels
@@ -211,6 +212,18 @@ private:
 	*/
 	bool isValid() const;
 
+	/**
+	\brief Byte size of a vehicle with numWheels, leaving out the wheels simulation data if sharedWheelsSimData is true.
+	@see allocate, PxVehicleFleet
+	*/
+	static PxU32 computeInstanceByteSize(const PxU32 numWheels, const bool sharedWheelsSimData);
+
+	/**
+	\brief Lay out a vehicle with numWheels in the memory at ptr, referencing the blocks of sharedWheelsSimData if it is not NULL.
+	@see allocate, PxVehicleFleet
+	*/
+	static PxVehicleDriveTank* patchupInstance(PxU8* ptr, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData);
+
 	/**
 	\brief Drive model
 	@see setDriveModel, eDriveModel
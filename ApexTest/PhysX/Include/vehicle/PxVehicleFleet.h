@@ -0,0 +1,192 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_VEHICLE_FLEET_H
+#define PX_VEHICLE_FLEET_H
+/** \addtogroup vehicle
+  @{
+*/
+
+#include "vehicle/PxVehicleSDK.h"
+#include "foundation/PxSimpleTypes.h"
+#include "foundation/PxAssert.h"
+
+#ifndef PX_DOXYGEN
+namespace physx
+{
+#endif
+
+	class PxPhysics;
+	class PxRigidDynamic;
+	class PxVehicleWheels;
+	class PxVehicleWheelsSimData;
+	class PxVehicleDriveSimData;
+	class PxVehicleDriveSimData4W;
+	class PxVehicleDrive4W;
+	class PxVehicleDriveTank;
+	class PxVehicleNoDrive;
+
+/**
+\brief Memory arena for many vehicles built from a few wheels simulation data archetypes.
+\brief The archetypes are copied into the fleet when it is allocated, each starting on a 64-byte boundary.  The vehicles of 
+the fleet reference the blocks of 4 wheels of their archetype instead of owning a copy of the suspension, wheel and tire data.  
+Their instanced dynamics data is packed one vehicle after the other in creation order, each vehicle starting on a 64-byte boundary.
+\brief The archetypes are immutable: the suspension, wheel and tire setters of the mWheelsSimData of a fleet vehicle, and 
+everything built on them such as copy, disableWheel, setChassisMass and assigning other wheels simulation data, would modify 
+every vehicle built from the same archetype, so they report an error and leave the data unchanged.  To change a wheel, free the 
+vehicle and create it again from another archetype.  The tire load filter and the sub-step counts of mWheelsSimData, and the 
+drive simulation data, are still copied into each vehicle and may be set per vehicle.
+\brief Vehicles of a fleet are released with their free() function as usual but their memory is only returned when the fleet
+is freed, which is legal only after the constraints of all its vehicles have been released.
+@see PxVehicleUpdates
+*/
+class PxVehicleFleet
+{
+public:
+
+	/**
+	\brief Allocate a fleet with copies of numArchetypes archetypes that holds up to maxNumVehicles vehicles with up to maxNumWheels wheels in total.
+	\brief Returns NULL if the memory could not be allocated.
+	@see free
+	*/
+	static PxVehicleFleet* allocate(const PxU32 numArchetypes, const PxVehicleWheelsSimData* const* archetypes, const PxU32 maxNumVehicles, const PxU32 maxNumWheels);
+
+	/**
+	\brief Free a PxVehicleFleet instance and the memory of all its vehicles.
+	@see allocate
+	*/
+	void free();
+
+	/**
+	\brief Return the number of archetypes of the fleet.
+	*/
+	PxU32 getNumArchetypes() const {return mNumArchetypes;}
+
+	/**
+	\brief Return the fleet's copy of the specified archetype.
+	*/
+	const PxVehicleWheelsSimData& getArchetype(const PxU32 archetype) const 
+	{
+		PX_ASSERT(archetype<mNumArchetypes);
+		return *mArchetypes[archetype];
+	}
+
+	/**
+	\brief Create a PxVehicleDrive4W in the fleet from the specified archetype, see PxVehicleDrive4W::create.
+	\brief Returns NULL if the fleet is full.
+	*/
+	PxVehicleDrive4W* createDrive4W
+		(PxPhysics* physics, PxRigidDynamic* vehActor, 
+		 const PxU32 archetype, const PxVehicleDriveSimData4W& driveData, 
+		 const PxU32 numNonDrivenWheels);
+
+	/**
+	\brief Create a PxVehicleDriveTank in the fleet from the specified archetype, see PxVehicleDriveTank::create.
+	\brief Returns NULL if the fleet is full.
+	*/
+	PxVehicleDriveTank* createDriveTank
+		(PxPhysics* physics, PxRigidDynamic* vehActor, 
+		 const PxU32 archetype, const PxVehicleDriveSimData& driveData, 
+		 const PxU32 numDrivenWheels);
+
+	/**
+	\brief Create a PxVehicleNoDrive in the fleet from the specified archetype, see PxVehicleNoDrive::create.
+	\brief Returns NULL if the fleet is full.
+	*/
+	PxVehicleNoDrive* createNoDrive(PxPhysics* physics, PxRigidDynamic* vehActor, const PxU32 archetype);
+
+	/**
+	\brief Return the number of vehicles created in the fleet.
+	*/
+	PxU32 getNumVehicles() const {return mNumVehicles;}
+
+	/**
+	\brief Return the vehicles of the fleet in creation order, which is also their order in memory.
+	\brief The array can be passed directly to PxVehicleSuspensionRaycasts and PxVehicleUpdates as long as no vehicle has been freed.
+	*/
+	PxVehicleWheels** getVehicles() const {return mVehicles;}
+
+	/**
+	\brief Return the number of bytes allocated by the fleet.
+	*/
+	PxU32 getByteSize() const {return mByteSize;}
+
+	/**
+	\brief Return the number of bytes of the vehicle arena used by the vehicles created so far.
+	*/
+	PxU32 getVehicleArenaUsedByteSize() const {return mArenaUsedByteSize;}
+
+private:
+
+	/**
+	\brief Reserve a 64-byte aligned vehicle of byteSize bytes with numWheels wheels at the end of the vehicle arena.
+	\brief Returns NULL if the fleet is full.
+	*/
+	PxU8* allocateVehicle(const PxU32 byteSize, const PxU32 numWheels);
+
+	/**
+	\brief Register a vehicle laid out by allocateVehicle.
+	*/
+	void addVehicle(PxVehicleWheels* veh);
+
+	/**
+	\brief Fleet copies of the archetypes.
+	*/
+	PxVehicleWheelsSimData** mArchetypes;
+
+	/**
+	\brief Vehicles in creation order.
+	*/
+	PxVehicleWheels** mVehicles;
+
+	/**
+	\brief Memory of the vehicles.
+	*/
+	PxU8* mArena;
+	PxU32 mArenaByteSize;
+	PxU32 mArenaUsedByteSize;
+
+	PxU32 mByteSize;
+	PxU32 mNumArchetypes;
+	PxU32 mNumVehicles;
+	PxU32 mMaxNumVehicles;
+	PxU32 mNumWheels;
+	PxU32 mMaxNumWheels;
+
+	PxVehicleFleet(){}
+	~PxVehicleFleet(){}
+};
+
+#ifndef PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif //PX_VEHICLE_FLEET_H
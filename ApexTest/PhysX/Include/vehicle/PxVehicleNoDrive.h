@@ -60,6 +60,7 @@ class PxVehicleNoDrive : public PxVehicleWheels
 public:
 
 	friend class PxVehicleUpdate;
+	friend class PxVehicleFleet;
 
 	/**
 	\brief Allocate a PxVehicleNoDrive instance for a vehicle without drive model with numWheels
@@ -150,6 +151,18 @@ private:
 	\brief Test if the instanced dynamics and configuration data has legal values.
 	*/
 	bool isValid() const;
+
+	/**
+	\brief Byte size of a vehicle with numWheels, leaving out the wheels simulation data if sharedWheelsSimData is true.
+	@see allocate, PxVehicleFleet
+	*/
+	static PxU32 computeInstanceByteSize(const PxU32 numWheels, const bool sharedWheelsSimData);
+
+	/**
+	\brief Lay out a vehicle with numWheels in the memory at ptr, referencing the blocks of sharedWheelsSimData if it is not NULL.
+	@see allocate, PxVehicleFleet
+	*/
+	static PxVehicleNoDrive* patchupInstance(PxU8* ptr, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData);
 };
 PX_COMPILE_TIME_ASSERT(0==(sizeof(PxVehicleNoDrive) & 15));
 
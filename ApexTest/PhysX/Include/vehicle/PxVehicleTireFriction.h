@@ -89,6 +89,7 @@ public:
 	\brief type is drivableSurfaceTypes[x].mType
 	\brief The friction of each surface-type/tire-type pair is determined by the corresponding value set by setTypePairFriction.
 	\brief A friction value of 1.0 will be assigned to each combination of tire and surface type.  To override this use setTypePairFriction.
+	\brief The lookup table from material to drivable surface type is built here, call setup again if the materials change.
 	@see release, setTypePairFriction, getTypePairFriction, PxVehicleTireData.mType
 	*/
 	void setup
@@ -176,11 +177,32 @@ private:
 	*/	
 	PxU32 mMaxNumTireTypes;			
 
+	/**
+	\brief Ptr to 1d array of material ptrs with (1<<mHashNumSlotBits) slots, the collision-free hash table built by setup.
+	\brief Unused slots are NULL.
+	*/
+	const PxMaterial** mHashMaterials;
+
+	/**
+	\brief Ptr to 1d array of drivable surface types, one for each slot of mHashMaterials.
+	*/
+	PxU32* mHashSurfaceTypes;
+
+	/**
+	\brief Ptr to 1d array of per-bucket displacements that move the materials of each bucket to unique slots.
+	*/
+	PxU16* mHashDisplacements;
+
+	/**
+	\brief Log2 of the number of slots in mHashMaterials, computed from mMaxNumSurfaceTypes.
+	\brief Zero if the hash table is not available and lookups search mDrivableSurfaceMaterials instead.
+	*/
+	PxU32 mHashNumSlotBits;
 
 #ifndef PX_X64
 	PxU32 mPad[1];
 #else
-	PxU32 mPad[2];
+	PxU32 mPad[3];
 #endif
 
 	PxVehicleDrivableSurfaceToTireFrictionPairs(){}
@@ -46,6 +46,8 @@ namespace physx
 	class PxVehicleWheels;
 	class PxVehicleDrivableSurfaceToTireFrictionPairs;
 	class PxVehicleTelemetryData;
+	class PxMaterial;
+	class PxShape;
 
 	/**
 	\brief Start raycasts of all suspension lines.
@@ -56,11 +58,239 @@ namespace physx
 	*/
 	void PxVehicleSuspensionRaycasts(PxBatchQuery* batchQuery, const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults);
 
+	/**
+	\brief Cache of the suspension raycast hits of the last frame, used to skip the raycasts of wheels that barely moved.
+	\brief A wheel reuses its cached hit if the hit was against a static actor, its suspension line moved less than the
+	position and direction tolerances and the hit is no older than the maximum number of cached frames.  The cached hit is
+	treated as a plane and intersected with the new suspension line; shape, face index and material are kept.
+	\brief The plane approximation is exact on flat ground and its error is bounded by the tolerances elsewhere.
+	\brief The cache keeps pointers to the hit shapes: call invalidate() whenever static geometry is moved, released or
+	has its query filter data changed.
+	@see PxVehicleSuspensionRaycasts
+	*/
+	class PxVehicleSuspensionRaycastCache
+	{
+	public:
+
+		friend class PxVehicleUpdate;
+
+		/**
+		\brief Allocate a cache for up to maxNumWheels wheels in total.
+		\brief The tolerances start at 0.01 for the position, 0.001 for the direction and 8 cached frames.
+		@see free, setTolerances
+		*/
+		static PxVehicleSuspensionRaycastCache* allocate(const PxU32 maxNumWheels);
+
+		/**
+		\brief Free a PxVehicleSuspensionRaycastCache instance.
+		@see allocate
+		*/
+		void free();
+
+		/**
+		\brief Set the largest move of the suspension line start (positionTolerance, in the same units as the suspension
+		data), the largest change of the unit suspension direction (directionTolerance) and the largest number of
+		consecutive frames (maxCachedFrames) that still allow the cached hit to be reused.  maxCachedFrames of zero disables the cache.
+		*/
+		void setTolerances(const PxReal positionTolerance, const PxReal directionTolerance, const PxU32 maxCachedFrames);
+
+		/**
+		\brief Drop all cached hits so that every wheel is raycast again next frame.
+		*/
+		void invalidate();
+
+		/**
+		\brief Get the number of raycasts issued to the batch query since the last call to resetStatistics.
+		*/
+		PxU32 getNumRaycasts() const {return mNumRaycasts;}
+
+		/**
+		\brief Get the number of raycasts skipped by reusing a cached hit since the last call to resetStatistics.
+		*/
+		PxU32 getNumCachedHits() const {return mNumCachedHits;}
+
+		/**
+		\brief Get the fraction of suspension lines answered by the cache since the last call to resetStatistics.
+		*/
+		PxReal getCacheHitRate() const
+		{
+			const PxU32 numQueries=mNumRaycasts+mNumCachedHits;
+			return (numQueries>0 ? PxReal(mNumCachedHits)/PxReal(numQueries) : 0.0f);
+		}
+
+		/**
+		\brief Reset the raycast and cached hit counts.
+		*/
+		void resetStatistics() {mNumRaycasts=0; mNumCachedHits=0;}
+
+	private:
+
+		struct CachedHit;
+
+		/**
+		\brief Suspension line results of each wheel, the wheels packed one vehicle after the other.
+		\brief The vehicles point their raycast results at these.
+		*/
+		PxRaycastQueryResult* mResults;
+
+		/**
+		\brief Cached hit of each wheel.
+		*/
+		CachedHit* mCachedHits;
+
+		/**
+		\brief Wheel of each raycast issued to the batch query this frame.
+		*/
+		PxU32* mRaycastWheels;
+
+		PxU32 mMaxNumWheels;
+
+		PxReal mPositionTolerance;
+		PxReal mDirectionTolerance;
+		PxU32 mMaxCachedFrames;
+
+		PxU32 mNumRaycasts;
+		PxU32 mNumCachedHits;
+
+		PxVehicleSuspensionRaycastCache(){}
+		~PxVehicleSuspensionRaycastCache(){}
+	};
+
+	/**
+	\brief Start raycasts of the suspension lines that cannot be answered by raycastCache, execute the batch query and
+	update raycastCache with the results.
+	\brief numSceneQueryResults specifies the size of the sceneQueryResults array, which must be the raycast result buffer of batchQuery.
+	It must be large enough for one raycast per wheel; fewer entries are written when wheels reuse a cached hit.
+	\brief The vehicles read their suspension line results from raycastCache, so raycastCache must outlive the following PxVehicleUpdates.
+	@see PxVehicleSuspensionRaycastCache
+	*/
+	void PxVehicleSuspensionRaycasts(PxBatchQuery* batchQuery, const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults, PxVehicleSuspensionRaycastCache& raycastCache);
+
 	/**
 	\brief Update an array of vehicles.
 	*/
 	void PxVehicleUpdates(const PxReal timestep, const PxVec3& gravity, const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, const PxU32 numVehicles, PxVehicleWheels** vehicles);
 
+	/**
+	\brief Caller-provided structure of arrays that receives the per-wheel state of many vehicles.
+	\brief The wheels of all vehicles are packed one after the other: the wheels of vehicles[i] start at the sum of 
+	vehicles[j]->mWheelsSimData.getNumWheels() over all j<i.
+	\brief Each array must be either NULL or hold at least numWheels entries.  Arrays left NULL are not written.
+	@see PxVehicleUpdates, PxVehicleGetWheelQueryResults
+	*/
+	struct PxVehicleWheelQueryResults
+	{
+		PxVehicleWheelQueryResults()
+			: suspJounce(NULL), suspSpringForce(NULL),
+			  tireLongSlip(NULL), tireLatSlip(NULL), tireFriction(NULL),
+			  tireSurfaceType(NULL), tireSurfaceMaterial(NULL), tireContactShape(NULL),
+			  tireContactPoint(NULL), tireContactNormal(NULL), tireLongitudinalDir(NULL), tireLateralDir(NULL),
+			  wheelRotationSpeed(NULL), wheelRotationAngle(NULL), steerAngle(NULL), isInAir(NULL),
+			  numWheels(0)
+		{
+		}
+
+		/**
+		\brief Suspension jounce, see PxVehicleWheelsDynData::getSuspJounce.
+		*/
+		PxReal* suspJounce;
+
+		/**
+		\brief Suspension spring force, see PxVehicleWheelsDynData::getSuspensionForce.
+		*/
+		PxReal* suspSpringForce;
+
+		/**
+		\brief Tire longitudinal slip, see PxVehicleWheelsDynData::getTireLongSlip.
+		*/
+		PxReal* tireLongSlip;
+
+		/**
+		\brief Tire lateral slip, see PxVehicleWheelsDynData::getTireLatSlip.
+		*/
+		PxReal* tireLatSlip;
+
+		/**
+		\brief Tire friction, see PxVehicleWheelsDynData::getTireFriction.
+		*/
+		PxReal* tireFriction;
+
+		/**
+		\brief Drivable surface type under the tire, see PxVehicleWheelsDynData::getTireDrivableSurfaceType.
+		*/
+		PxU32* tireSurfaceType;
+
+		/**
+		\brief Material under the tire, see PxVehicleWheelsDynData::getTireDrivableSurfaceMaterial.
+		*/
+		const PxMaterial** tireSurfaceMaterial;
+
+		/**
+		\brief Shape under the tire, see PxVehicleWheelsDynData::getTireDrivableSurfaceShape.
+		*/
+		const PxShape** tireContactShape;
+
+		/**
+		\brief Contact point under the tire, see PxVehicleWheelsDynData::getTireDrivableSurfaceContactPoint.
+		*/
+		PxVec3* tireContactPoint;
+
+		/**
+		\brief Contact normal under the tire, see PxVehicleWheelsDynData::getTireDrivableSurfaceContactNormal.
+		*/
+		PxVec3* tireContactNormal;
+
+		/**
+		\brief Tire longitudinal direction, see PxVehicleWheelsDynData::getTireLongitudinalDir.
+		*/
+		PxVec3* tireLongitudinalDir;
+
+		/**
+		\brief Tire lateral direction, see PxVehicleWheelsDynData::getTireLateralDir.
+		*/
+		PxVec3* tireLateralDir;
+
+		/**
+		\brief Wheel rotation speed, see PxVehicleWheelsDynData::getWheelRotationSpeed.
+		*/
+		PxReal* wheelRotationSpeed;
+
+		/**
+		\brief Wheel rotation angle, see PxVehicleWheelsDynData::getWheelRotationAngle.
+		*/
+		PxReal* wheelRotationAngle;
+
+		/**
+		\brief Steer angle, see PxVehicleWheelsDynData::getSteer.
+		*/
+		PxReal* steerAngle;
+
+		/**
+		\brief True if the wheel has no contact, see PxVehicleWheels::isInAir.
+		*/
+		bool* isInAir;
+
+		/**
+		\brief Number of entries in each non-NULL array.
+		\brief Must be greater than or equal to the total number of wheels of all the vehicles.
+		*/
+		PxU32 numWheels;
+	};
+
+	/**
+	\brief Update an array of vehicles and write the wheel state of all vehicles to wheelQueryResults.
+	\brief Each vehicle's wheels are written right after the vehicle is updated, so the results match what 
+	the PxVehicleWheelsDynData getters return after PxVehicleUpdates.
+	@see PxVehicleWheelQueryResults
+	*/
+	void PxVehicleUpdates(const PxReal timestep, const PxVec3& gravity, const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, const PxU32 numVehicles, PxVehicleWheels** vehicles, PxVehicleWheelQueryResults& wheelQueryResults);
+
+	/**
+	\brief Write the current wheel state of an array of vehicles to wheelQueryResults without updating the vehicles.
+	@see PxVehicleWheelQueryResults
+	*/
+	void PxVehicleGetWheelQueryResults(const PxU32 numVehicles, const PxVehicleWheels* const* vehicles, PxVehicleWheelQueryResults& wheelQueryResults);
+
 #if PX_DEBUG_VEHICLE_ON
 	/**
 	\brief Update the focus vehicle and also store key debug data for the specified focus vehicle.
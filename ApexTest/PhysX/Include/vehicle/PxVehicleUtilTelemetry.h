@@ -381,6 +381,130 @@ PX_COMPILE_TIME_ASSERT(0==(sizeof(PxVehicleTelemetryData) & 15));
 
 //#endif // PX_DEBUG_VEHICLE_ON
 
+class PxVehicleWheels;
+
+/**
+\brief Ring buffer of wheel and engine samples for any number of vehicles.
+\brief Each call to record() stores one sample of every vehicle passed in, overwriting the oldest sample once numSamples 
+samples have been recorded.
+\brief The recorder reads the state that PxVehicleUpdates leaves in the vehicles so, unlike PxVehicleTelemetryData, it 
+neither needs PX_DEBUG_VEHICLE_ON nor is limited to a single focus vehicle.
+@see PxVehicleGetWheelQueryResults
+*/
+class PxVehicleTelemetryRecorder
+{
+public:
+
+	enum
+	{
+		eCHANNEL_JOUNCE=0,
+		eCHANNEL_SUSPFORCE,
+		eCHANNEL_TIRE_LONG_SLIP,
+		eCHANNEL_TIRE_LAT_SLIP,
+		eCHANNEL_TIRE_FRICTION,
+		eCHANNEL_WHEEL_OMEGA,
+		eCHANNEL_STEER_ANGLE,
+		eMAX_NUM_WHEEL_CHANNELS
+	};
+
+	enum
+	{
+		eCHANNEL_ENGINE_REVS=0,
+		eCHANNEL_GEAR,
+		eMAX_NUM_VEHICLE_CHANNELS
+	};
+
+	/**
+	\brief Allocate a recorder for up to maxNumVehicles vehicles with up to maxNumWheels wheels in total, keeping the last numSamples samples.
+	@see free
+	*/
+	static PxVehicleTelemetryRecorder* allocate(const PxU32 maxNumVehicles, const PxU32 maxNumWheels, const PxU32 numSamples);
+
+	/**
+	\brief Free a PxVehicleTelemetryRecorder instance.
+	@see allocate
+	*/
+	void free();
+
+	/**
+	\brief Drop all recorded samples.
+	*/
+	void clear();
+
+	/**
+	\brief Record one sample of each vehicle, normally right after PxVehicleUpdates.
+	\brief The wheels are packed in the same order as PxVehicleWheelQueryResults.
+	\brief Vehicles without an engine record zero engine revs and gear.
+	*/
+	void record(const PxU32 numVehicles, const PxVehicleWheels* const* vehicles);
+
+	/**
+	\brief Get the number of samples that can be read, at most the numSamples passed to allocate.
+	*/
+	PxU32 getNumSamples() const {return mNumRecordedSamples;}
+
+	/**
+	\brief Get the number of vehicles of a sample, sample 0 being the most recent one.
+	*/
+	PxU32 getNumVehicles(const PxU32 sample) const {return mSampleNumVehicles[getSampleSlot(sample)];}
+
+	/**
+	\brief Get the number of wheels of a sample, sample 0 being the most recent one.
+	*/
+	PxU32 getNumWheels(const PxU32 sample) const {return mSampleNumWheels[getSampleSlot(sample)];}
+
+	/**
+	\brief Get the values of a wheel channel for all wheels of a sample, sample 0 being the most recent one.
+	*/
+	const PxReal* getWheelChannel(const PxU32 channel, const PxU32 sample) const
+	{
+		PX_ASSERT(channel<eMAX_NUM_WHEEL_CHANNELS);
+		return mSamples + getSampleSlot(sample)*mSampleSize + channel*mMaxNumWheels;
+	}
+
+	/**
+	\brief Get the values of a vehicle channel for all vehicles of a sample, sample 0 being the most recent one.
+	*/
+	const PxReal* getVehicleChannel(const PxU32 channel, const PxU32 sample) const
+	{
+		PX_ASSERT(channel<eMAX_NUM_VEHICLE_CHANNELS);
+		return mSamples + getSampleSlot(sample)*mSampleSize + eMAX_NUM_WHEEL_CHANNELS*mMaxNumWheels + channel*mMaxNumVehicles;
+	}
+
+private:
+
+	PxU32 getSampleSlot(const PxU32 sample) const
+	{
+		PX_ASSERT(sample<mNumRecordedSamples);
+		return (mSampleTide+mNumSamples-sample)%mNumSamples;
+	}
+
+	/**
+	\brief Channel data of all samples, each sample holds the wheel channels followed by the vehicle channels.
+	*/
+	PxReal* mSamples;
+
+	/**
+	\brief Number of vehicles and wheels of each sample.
+	*/
+	PxU32* mSampleNumVehicles;
+	PxU32* mSampleNumWheels;
+
+	PxU32 mMaxNumVehicles;
+	PxU32 mMaxNumWheels;
+	PxU32 mSampleSize;
+	PxU32 mNumSamples;
+
+	/**
+	\brief Slot of the most recent sample.
+	*/
+	PxU32 mSampleTide;
+	PxU32 mNumRecordedSamples;
+
+	PxVehicleTelemetryRecorder(){}
+	~PxVehicleTelemetryRecorder(){}
+};
+
 #ifndef PX_DOXYGEN
 } // namespace physx
 #endif
@@ -63,6 +63,7 @@ public:
 	friend class PxVehicleDrive4W;
 	friend class PxVehicleDriveTank;
 	friend class PxVehicleUpdate;
+	friend class PxVehicleFleet;
 
 	/**
 	\brief Allocate a PxVehicleWheelsSimData instance for with numWheels.
@@ -256,10 +257,15 @@ private:
 	*/
 	PxU32 mHighForwardSpeedSubStepCount;
 
+	/**
+	\brief Set for the vehicles of a PxVehicleFleet, whose blocks of 4 wheels belong to their archetype and must not be modified.
+	*/
+	PxU8 mIsShared;
+
 #ifdef PX_X64
-	PxU32 mPad[1];
+	PxU8 mPad[3];
 #else
-	PxU32 mPad[2];
+	PxU8 mPad[7];
 #endif
 
 	/**
@@ -476,6 +482,7 @@ public:
 
 	friend class PxVehicleUpdate;
 	friend class PxVehicleConstraintShader;
+	friend class PxVehicleFleet;
 
 	/**
 	\brief Return the type of vehicle 
@@ -568,14 +575,16 @@ protected:
 	bool isValid() const;
 
 	/**
-	@see PxVehicleDrive4W::allocate, PxVehicleDriveTank::allocate
+	\brief No memory is reserved for the wheels simulation data if sharedWheelsSimData is true.
+	@see PxVehicleDrive4W::allocate, PxVehicleDriveTank::allocate, PxVehicleFleet
 	*/
-	static PxU32 computeByteSize(const PxU32 numWheels4);
+	static PxU32 computeByteSize(const PxU32 numWheels4, const bool sharedWheelsSimData=false);
 
 	/**
-	@see PxVehicleDrive4W::allocate, PxVehicleDriveTank::allocate
+	\brief If sharedWheelsSimData is not NULL the vehicle references its blocks of 4 wheels instead of owning a copy.
+	@see PxVehicleDrive4W::allocate, PxVehicleDriveTank::allocate, PxVehicleFleet
 	*/
-	static PxU8* patchupPointers(PxVehicleWheels* veh, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels);
+	static PxU8* patchupPointers(PxVehicleWheels* veh, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData=NULL);
 
 	/**
 	\brief Deallocate a PxVehicleWheels instance.
@@ -623,10 +632,16 @@ private:
 	*/
 	PxU8 mOnConstraintReleaseCounter;
 
+	/**
+	\brief Non-zero if the vehicle lives in the memory of a PxVehicleFleet, which must not be freed when the last constraint connector is released.
+	@see PxVehicleFleet
+	*/
+	PxU8 mIsFleetVehicle;
+
 #ifndef PX_X64
-	PxU8 mPad[2];
+	PxU8 mPad[1];
 #else
-	PxU8 mPad2[10];
+	PxU8 mPad2[9];
 #endif
 
 };
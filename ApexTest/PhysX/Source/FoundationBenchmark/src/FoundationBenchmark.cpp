@@ -0,0 +1,285 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+// Headless micro benchmarks of the foundation platform layer.
+//
+//	FoundationBenchmark [options]
+//		-csv			print the results as comma separated values
+//		-scale <n>		multiply the iteration counts by n, default 1
+
+#include "CmPhysXCommon.h"
+#include "foundation/PxTransform.h"
+#include "PsVecMath.h"
+#include "PsVecTransform.h"
+#include "PsAllocator.h"
+#include "PsMutex.h"
+#include "PsSync.h"
+#include "PsThread.h"
+#include "PsAtomic.h"
+#include "PsTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+using namespace physx::shdfnd;
+using namespace physx::shdfnd::aos;
+
+namespace
+{
+	typedef MutexT<RawAllocator> RawMutex;
+
+	struct Result
+	{
+		const char*	name;
+		double		value;
+		const char*	unit;
+	};
+
+	double elapsedNanos(Time& timer)
+	{
+		return timer.getElapsedSeconds() * 1e9;
+	}
+
+	// Keeps the optimizer from discarding the benchmarked work.
+	volatile PxF32 gSink;
+
+	PxF32 randomFloat(PxF32 lo, PxF32 hi)
+	{
+		return lo + (hi - lo) * (PxF32(rand()) / PxF32(RAND_MAX));
+	}
+
+	void transformScalar(const PxTransform& pose, const std::vector<PxVec3>& src, std::vector<PxVec3>& dst)
+	{
+		for(size_t i = 0; i < src.size(); i++)
+			dst[i] = pose.transform(src[i]);
+	}
+
+	void transformVecMath(const PxTransform& pose, const std::vector<PxVec3>& src, std::vector<PxVec3>& dst)
+	{
+		const PsTransformV poseV(pose);
+		for(size_t i = 0; i < src.size(); i++)
+			PxVec3_From_Vec3V(poseV.transform(Vec3V_From_PxVec3(src[i])), dst[i]);
+	}
+
+	struct PingPong
+	{
+		Sync	ping;
+		Sync	pong;
+		PxU32	count;
+	};
+
+	void* pingPongThread(void* arg)
+	{
+		PingPong& pp = *reinterpret_cast<PingPong*>(arg);
+		for(PxU32 i = 0; i < pp.count; i++)
+		{
+			pp.ping.wait();
+			pp.ping.reset();
+			pp.pong.set();
+		}
+		return NULL;
+	}
+
+	struct AtomicWorker
+	{
+		volatile PxI32*	counter;
+		PxU32			count;
+	};
+
+	void* atomicThread(void* arg)
+	{
+		AtomicWorker& w = *reinterpret_cast<AtomicWorker*>(arg);
+		for(PxU32 i = 0; i < w.count; i++)
+			atomicIncrement(w.counter);
+		return NULL;
+	}
+
+	struct MutexWorker
+	{
+		RawMutex*	mutex;
+		PxU32*		counter;
+		PxU32		count;
+	};
+
+	void* mutexThread(void* arg)
+	{
+		MutexWorker& w = *reinterpret_cast<MutexWorker*>(arg);
+		for(PxU32 i = 0; i < w.count; i++)
+		{
+			RawMutex::ScopedLock lock(*w.mutex);
+			(*w.counter)++;
+		}
+		return NULL;
+	}
+
+	void benchmarkTransforms(PxU32 scale, std::vector<Result>& results)
+	{
+		const PxU32 numPoints = 4096, numPasses = 1000 * scale;
+		std::vector<PxVec3> src(numPoints), dst(numPoints);
+		for(PxU32 i = 0; i < numPoints; i++)
+			src[i] = PxVec3(randomFloat(-10.0f, 10.0f), randomFloat(-10.0f, 10.0f), randomFloat(-10.0f, 10.0f));
+		const PxTransform pose(PxVec3(1.0f, 2.0f, 3.0f), PxQuat(0.7f, PxVec3(0.0f, 0.6f, 0.8f)));
+
+		Time timer;
+		for(PxU32 i = 0; i < numPasses; i++)
+			transformScalar(pose, src, dst);
+		const double scalarNanos = elapsedNanos(timer);
+		gSink = dst[numPoints - 1].x;
+
+		for(PxU32 i = 0; i < numPasses; i++)
+			transformVecMath(pose, src, dst);
+		const double vecMathNanos = elapsedNanos(timer);
+		gSink = dst[numPoints - 1].x;
+
+		Result scalar = { "transform_scalar", scalarNanos / (double(numPoints) * numPasses), "ns/point" };
+		Result vecMath = { "transform_vecmath", vecMathNanos / (double(numPoints) * numPasses), "ns/point" };
+		results.push_back(scalar);
+		results.push_back(vecMath);
+	}
+
+	void benchmarkLocks(PxU32 scale, std::vector<Result>& results)
+	{
+		const PxU32 count = 10000000 * scale;
+		volatile PxI32 atomicCounter = 0;
+		RawMutex mutex;
+		PxU32 mutexCounter = 0;
+
+		Time timer;
+		for(PxU32 i = 0; i < count; i++)
+			atomicIncrement(&atomicCounter);
+		const double atomicNanos = elapsedNanos(timer);
+
+		for(PxU32 i = 0; i < count; i++)
+		{
+			RawMutex::ScopedLock lock(mutex);
+			mutexCounter++;
+		}
+		const double mutexNanos = elapsedNanos(timer);
+
+		// two threads hammering the same counter
+		const PxU32 contendedCount = count / 4;
+		AtomicWorker atomicWorker = { &atomicCounter, contendedCount };
+		{
+			Thread thread(atomicThread, &atomicWorker);
+			atomicThread(&atomicWorker);
+			thread.waitForQuit();
+		}
+		const double contendedAtomicNanos = elapsedNanos(timer);
+
+		MutexWorker mutexWorker = { &mutex, &mutexCounter, contendedCount };
+		{
+			Thread thread(mutexThread, &mutexWorker);
+			mutexThread(&mutexWorker);
+			thread.waitForQuit();
+		}
+		const double contendedMutexNanos = elapsedNanos(timer);
+
+		if(PxU32(atomicCounter) != count + 2 * contendedCount || mutexCounter != count + 2 * contendedCount)
+			fprintf(stderr, "error: lost updates, atomic %u mutex %u expected %u\n", PxU32(atomicCounter), mutexCounter, count + 2 * contendedCount);
+
+		Result atomic = { "atomic_increment", atomicNanos / count, "ns/op" };
+		Result lock = { "mutex_lock_unlock", mutexNanos / count, "ns/op" };
+		Result contendedAtomic = { "atomic_increment_2_threads", contendedAtomicNanos / (2.0 * contendedCount), "ns/op" };
+		Result contendedLock = { "mutex_lock_unlock_2_threads", contendedMutexNanos / (2.0 * contendedCount), "ns/op" };
+		results.push_back(atomic);
+		results.push_back(lock);
+		results.push_back(contendedAtomic);
+		results.push_back(contendedLock);
+	}
+
+	void benchmarkSync(PxU32 scale, std::vector<Result>& results)
+	{
+		PingPong pp;
+		pp.count = 20000 * scale;
+
+		Time timer;
+		Thread thread(pingPongThread, &pp);
+		for(PxU32 i = 0; i < pp.count; i++)
+		{
+			pp.ping.set();
+			pp.pong.wait();
+			pp.pong.reset();
+		}
+		thread.waitForQuit();
+		const double nanos = elapsedNanos(timer);
+
+		Result roundTrip = { "sync_round_trip", nanos / 1000.0 / pp.count, "us/op" };
+		results.push_back(roundTrip);
+	}
+
+	void benchmarkTime(PxU32 scale, std::vector<Result>& results)
+	{
+		const PxU32 count = 10000000 * scale;
+		PxU64 sum = 0;
+
+		Time timer;
+		for(PxU32 i = 0; i < count; i++)
+			sum += Time::getCurrentCounterValue();
+		const double nanos = elapsedNanos(timer);
+		gSink = PxF32(sum & 1);
+
+		Result counter = { "time_counter_read", nanos / count, "ns/op" };
+		results.push_back(counter);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 scale = 1;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-scale") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			scale = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-scale <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	srand(1);
+	std::vector<Result> results;
+	benchmarkTransforms(scale, results);
+	benchmarkLocks(scale, results);
+	benchmarkSync(scale, results);
+	benchmarkTime(scale, results);
+
+	if(csv)
+		printf("benchmark,value,unit\n");
+	for(size_t i = 0; i < results.size(); i++)
+		printf(csv ? "%s,%.3f,%s\n" : "%-28s %10.3f %s\n", results[i].name, results[i].value, results[i].unit);
+	return 0;
+}
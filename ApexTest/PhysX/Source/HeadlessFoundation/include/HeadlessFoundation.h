@@ -0,0 +1,55 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+#ifndef PX_HEADLESS_FOUNDATION_H
+#define PX_HEADLESS_FOUNDATION_H
+
+#include "foundation/Px.h"
+
+// The foundation core is binary-only and not part of the Linux build. HeadlessFoundation provides the
+// parts of it that the source libraries reach from the benchmarks and checks: the global allocator,
+// the named and temp allocators of the checked builds, and the error stream. There is no foundation
+// object; Foundation::error() is the only member called through getFoundation() and does not use it.
+
+namespace physx
+{
+namespace shdfnd
+{
+	// Number of errors reported through Foundation::error() since startup.
+	PxU32 getHeadlessErrorCount();
+
+	// Number of bytes currently allocated through the global allocator, not counting its bookkeeping.
+	PxU32 getHeadlessAllocatedByteCount();
+
+} // namespace shdfnd
+} // namespace physx
+
+#endif
@@ -0,0 +1,179 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+#include "HeadlessFoundation.h"
+#include "PsFoundation.h"
+#include "PsAllocator.h"
+#include "PsTempAllocator.h"
+#include "PsAtomic.h"
+#include "PxDefaultAllocator.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+namespace physx
+{
+namespace shdfnd
+{
+	static volatile PxI32 gErrorCount = 0;
+
+	PxU32 getHeadlessErrorCount()
+	{
+		return PxU32(gErrorCount);
+	}
+
+	Foundation* Foundation::mInstance = NULL;
+	PxU32 Foundation::mRefCount = 0;
+
+	Foundation& Foundation::getInstance()
+	{
+		return *mInstance;
+	}
+
+	void Foundation::incRefCount()
+	{
+		mRefCount++;
+	}
+
+	void Foundation::decRefCount()
+	{
+		PX_ASSERT(mRefCount > 0);
+		mRefCount--;
+	}
+
+	void Foundation::error(PxErrorCode::Enum, const char* file, int line, const char* messageFmt, ...)
+	{
+		va_list va;
+		va_start(va, messageFmt);
+		fprintf(stderr, "%s(%d): ", file, line);
+		vfprintf(stderr, messageFmt, va);
+		fprintf(stderr, "\n");
+		va_end(va);
+		atomicIncrement(&gErrorCount);
+	}
+
+	static volatile PxI32 gAllocatedByteCount = 0;
+
+	PxU32 getHeadlessAllocatedByteCount()
+	{
+		return PxU32(gAllocatedByteCount);
+	}
+
+	// Keeps the size of each allocation in a 16-byte header so that the live bytes can be counted
+	// without losing the 16-byte alignment of the default allocator.
+	class CountingAllocator : public PxAllocatorCallback
+	{
+	public:
+		void* allocate(size_t size, const char* typeName, const char* file, int line)
+		{
+			PxU8* ptr = reinterpret_cast<PxU8*>(mAllocator.allocate(size + 16, typeName, file, line));
+			if(!ptr)
+				return NULL;
+			*reinterpret_cast<size_t*>(ptr) = size;
+			atomicAdd(&gAllocatedByteCount, PxI32(size));
+			return ptr + 16;
+		}
+
+		void deallocate(void* ptr)
+		{
+			PxU8* base = reinterpret_cast<PxU8*>(ptr) - 16;
+			atomicAdd(&gAllocatedByteCount, -PxI32(*reinterpret_cast<size_t*>(base)));
+			mAllocator.deallocate(base);
+		}
+
+	private:
+		PxDefaultAllocator mAllocator;
+	};
+
+	PxAllocatorCallback& getAllocator()
+	{
+		static CountingAllocator allocator;
+		return allocator;
+	}
+
+	void* Allocator::allocate(size_t size, const char* file, int line)
+	{
+		return size ? getAllocator().allocate(size, "", file, line) : NULL;
+	}
+
+	void Allocator::deallocate(void* ptr)
+	{
+		if(ptr)
+			getAllocator().deallocate(ptr);
+	}
+
+	void* TempAllocator::allocate(size_t size, const char* file, int line)
+	{
+		return Allocator::allocate(size, file, line);
+	}
+
+	void TempAllocator::deallocate(void* ptr)
+	{
+		Allocator::deallocate(ptr);
+	}
+
+#if defined(_DEBUG) || defined(PX_CHECKED)
+	// The named allocator of the debug and checked builds records the name in the foundation object, the headless one drops it.
+	NamedAllocator::NamedAllocator(const PxEmpty&)
+	{
+	}
+
+	NamedAllocator::NamedAllocator(const char*)
+	{
+	}
+
+	NamedAllocator::NamedAllocator(const NamedAllocator&)
+	{
+	}
+
+	NamedAllocator::~NamedAllocator()
+	{
+	}
+
+	NamedAllocator& NamedAllocator::operator=(const NamedAllocator&)
+	{
+		return *this;
+	}
+
+	void* NamedAllocator::allocate(size_t size, const char* file, int line)
+	{
+		return size ? getAllocator().allocate(size, "", file, line) : NULL;
+	}
+
+	void NamedAllocator::deallocate(void* ptr)
+	{
+		if(ptr)
+			getAllocator().deallocate(ptr);
+	}
+#endif
+
+} // namespace shdfnd
+} // namespace physx
@@ -0,0 +1,373 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+#ifndef HEADLESS_VEHICLE_SCENE_MOCKS_H
+#define HEADLESS_VEHICLE_SCENE_MOCKS_H
+
+// Stand-ins for the SDK objects the vehicle library talks to: a rigid dynamic chassis, static or dynamic
+// ground, a PxPhysics that creates the vehicle constraints and a batch query that raycasts against a
+// ground plane. With them the vehicle checks and benchmarks run without the binary-only PhysX core.
+// There is no rigid body solver: the vehicle updates change the chassis velocities, and the chassis only
+// moves when the caller integrates it.
+
+#include "PxRigidDynamic.h"
+#include "PxRigidStatic.h"
+#include "PxShape.h"
+#include "PxConstraint.h"
+#include "PxBatchQuery.h"
+#include "PxBatchQueryDesc.h"
+#include "PxPhysics.h"
+#include "PxTolerancesScale.h"
+#include "PsFoundation.h"
+
+#include <vector>
+
+namespace physx
+{
+namespace headless
+{
+	// Only the functions the vehicle library calls do anything.
+	template<class Base>
+	class MockRigidActor : public Base
+	{
+	public:
+		MockRigidActor(PxType type) : mPose(PxTransform::createIdentity())	{ this->setSerialType(type);	}
+
+		virtual	PxTransform getGlobalPose() const { return mPose; }
+		virtual	PxU32 getObjectSize() const { return sizeof(*this); }
+
+		// unused
+		virtual	void release() {}
+		virtual	PxActorType::Enum getType() const { return PxActorType::Enum(); }
+		virtual	PxScene* getScene() const { return NULL; }
+		virtual	void setName(const char*) {}
+		virtual	const char* getName() const { return NULL; }
+		virtual	PxBounds3 getWorldBounds() const { return PxBounds3::empty(); }
+		virtual	void setActorFlag(PxActorFlag::Enum, bool) {}
+		virtual	void setActorFlags(PxActorFlags) {}
+		virtual	PxActorFlags getActorFlags() const { return PxActorFlags(); }
+		virtual	void setDominanceGroup(PxDominanceGroup) {}
+		virtual	PxDominanceGroup getDominanceGroup() const { return 0; }
+		virtual	void setOwnerClient(PxClientID) {}
+		virtual	PxClientID getOwnerClient() const { return 0; }
+		virtual	void setClientBehaviorBits(PxU32) {}
+		virtual	PxU32 getClientBehaviorBits() const { return 0; }
+		virtual	PxAggregate* getAggregate() const { return NULL; }
+		virtual	void setGlobalPose(const PxTransform&, bool) {}
+		virtual	PxShape* createShape(const PxGeometry&, PxMaterial*const*, PxU32, const PxTransform&) { return NULL; }
+		virtual	PxU32 getNbShapes() const { return 0; }
+		virtual	PxU32 getShapes(PxShape**, PxU32, PxU32) const { return 0; }
+		virtual	PxU32 getNbConstraints() const { return 0; }
+		virtual	PxU32 getConstraints(PxConstraint**, PxU32, PxU32) const { return 0; }
+		virtual	PxObservableType::Enum getObservableType() const { return PxObservableType::Enum(); }
+		virtual	void registerObserver(PxObserver&) {}
+		virtual	void unregisterObserver(PxObserver&) {}
+		virtual	PxU32 getNbObservers() const { return 0; }
+		virtual	PxU32 getObservers(PxObserver**, PxU32) const { return 0; }
+
+		PxTransform	mPose;
+	};
+
+	typedef MockRigidActor<PxRigidStatic> MockRigidStatic;
+
+	class MockRigidDynamic : public MockRigidActor<PxRigidDynamic>
+	{
+	public:
+		MockRigidDynamic()
+		: MockRigidActor<PxRigidDynamic>(PxConcreteType::eRIGID_DYNAMIC), mMass(0.0f), mInertia(0.0f), mLinearVelocity(0.0f), mAngularVelocity(0.0f)
+		{
+		}
+
+		virtual	PxTransform getCMassLocalPose() const { return PxTransform::createIdentity(); }
+		virtual	PxReal getMass() const { return mMass; }
+		virtual	PxVec3 getMassSpaceInertiaTensor() const { return mInertia; }
+		virtual	PxVec3 getLinearVelocity() const { return mLinearVelocity; }
+		virtual	void setLinearVelocity(const PxVec3& v, bool) { mLinearVelocity = v; }
+		virtual	PxVec3 getAngularVelocity() const { return mAngularVelocity; }
+		virtual	void setAngularVelocity(const PxVec3& v, bool) { mAngularVelocity = v; }
+
+		// explicit Euler step of the pose from the velocities
+		void integrate(PxReal dt)
+		{
+			mPose.p += mLinearVelocity * dt;
+			const PxReal angle = mAngularVelocity.magnitude() * dt;
+			if(angle > 0.0f)
+				mPose.q = (PxQuat(angle, mAngularVelocity.getNormalized()) * mPose.q).getNormalized();
+		}
+
+		// unused
+		virtual	void setCMassLocalPose(const PxTransform&) {}
+		virtual	void setMass(PxReal) {}
+		virtual	void setMassSpaceInertiaTensor(const PxVec3&) {}
+		virtual	void addForce(const PxVec3&, PxForceMode::Enum, bool) {}
+		virtual	void addTorque(const PxVec3&, PxForceMode::Enum, bool) {}
+		virtual	void clearForce(PxForceMode::Enum, bool) {}
+		virtual	void clearTorque(PxForceMode::Enum, bool) {}
+		virtual	void setKinematicTarget(const PxTransform&) {}
+		virtual	bool getKinematicTarget(PxTransform&) { return false; }
+		virtual	void setLinearDamping(PxReal) {}
+		virtual	PxReal getLinearDamping() const { return 0; }
+		virtual	void setAngularDamping(PxReal) {}
+		virtual	PxReal getAngularDamping() const { return 0; }
+		virtual	void setMaxAngularVelocity(PxReal) {}
+		virtual	PxReal getMaxAngularVelocity() const { return 0; }
+		virtual	bool isSleeping() const { return false; }
+		virtual	void setSleepThreshold(PxReal) {}
+		virtual	PxReal getSleepThreshold() const { return 0; }
+		virtual	void wakeUp(PxReal) {}
+		virtual	void putToSleep() {}
+		virtual	void setSolverIterationCounts(PxU32, PxU32) {}
+		virtual	void getSolverIterationCounts(PxU32&, PxU32&) const {}
+		virtual	PxReal getContactReportThreshold() const { return 0; }
+		virtual	void setContactReportThreshold(PxReal) {}
+		virtual	void setRigidDynamicFlag(PxRigidDynamicFlag::Enum, bool) {}
+		virtual	void setRigidDynamicFlags(PxRigidDynamicFlags) {}
+		virtual	PxRigidDynamicFlags getRigidDynamicFlags() const { return PxRigidDynamicFlags(); }
+
+		PxReal	mMass;
+		PxVec3	mInertia;
+		PxVec3	mLinearVelocity;
+		PxVec3	mAngularVelocity;
+	};
+
+	class MockShape : public PxShape
+	{
+	public:
+		MockShape(PxRigidActor& actor, PxMaterial* material = NULL) : mActor(actor), mMaterial(material)	{}
+
+		virtual	PxRigidActor& getActor() const { return mActor; }
+		virtual	PxMaterial* getMaterialFromInternalFaceIndex(PxU32) const { return mMaterial; }
+		virtual	PxU32 getObjectSize() const { return sizeof(*this); }
+
+		// unused
+		virtual	void release() {}
+		virtual	PxGeometryType::Enum getGeometryType() const { return PxGeometryType::Enum(); }
+		virtual	void setGeometry(const PxGeometry&) {}
+		virtual	PxGeometryHolder getGeometry() const { return PxGeometryHolder(); }
+		virtual	bool getBoxGeometry(PxBoxGeometry&) const { return false; }
+		virtual	bool getSphereGeometry(PxSphereGeometry&) const { return false; }
+		virtual	bool getCapsuleGeometry(PxCapsuleGeometry&) const { return false; }
+		virtual	bool getPlaneGeometry(PxPlaneGeometry&) const { return false; }
+		virtual	bool getConvexMeshGeometry(PxConvexMeshGeometry&) const { return false; }
+		virtual	bool getTriangleMeshGeometry(PxTriangleMeshGeometry&) const { return false; }
+		virtual	bool getHeightFieldGeometry(PxHeightFieldGeometry&) const { return false; }
+		virtual	PxBounds3 getWorldBounds() const { return PxBounds3::empty(); }
+		virtual	void setLocalPose(const PxTransform&) {}
+		virtual	PxTransform getLocalPose() const { return PxTransform::createIdentity(); }
+		virtual	void setSimulationFilterData(const PxFilterData&) {}
+		virtual	PxFilterData getSimulationFilterData() const { return PxFilterData(); }
+		virtual	void resetFiltering() {}
+		virtual	void setQueryFilterData(const PxFilterData&) {}
+		virtual	PxFilterData getQueryFilterData() const { return PxFilterData(); }
+		virtual	void setMaterials(PxMaterial*const*, PxU32) {}
+		virtual	PxU32 getNbMaterials() const { return 0; }
+		virtual	PxU32 getMaterials(PxMaterial**, PxU32) const { return 0; }
+		virtual	void setContactOffset(PxReal) {}
+		virtual	PxReal getContactOffset() const { return 0; }
+		virtual	void setRestOffset(PxReal) {}
+		virtual	PxReal getRestOffset() const { return 0; }
+		virtual	void setFlag(PxShapeFlag::Enum, bool) {}
+		virtual	void setFlags(PxShapeFlags) {}
+		virtual	PxShapeFlags getFlags() const { return PxShapeFlags(); }
+		virtual	void setName(const char*) {}
+		virtual	const char* getName() const { return NULL; }
+		virtual	PxU32 raycast(const PxVec3&, const PxVec3&, PxReal, PxSceneQueryFlags, PxU32, PxRaycastHit*, bool, const PxTransform*) const { return 0; }
+		virtual	bool overlap(const PxGeometry&, const PxTransform&, const PxTransform*) const { return false; }
+		virtual	bool sweep(const PxVec3&, const PxReal, const PxGeometry&, const PxTransform&, PxSweepHit&, PxSceneQueryFlags, const PxTransform*) const { return false; }
+		virtual	PxObservableType::Enum getObservableType() const { return PxObservableType::Enum(); }
+		virtual	void registerObserver(PxObserver&) {}
+		virtual	void unregisterObserver(PxObserver&) {}
+		virtual	PxU32 getNbObservers() const { return 0; }
+		virtual	PxU32 getObservers(PxObserver**, PxU32) const { return 0; }
+
+		PxRigidActor&	mActor;
+		PxMaterial*		mMaterial;	// only compared by the vehicle library, never dereferenced
+	};
+
+	// Releasing the constraint tells the connector, as the SDK does, so that freed vehicles return their memory.
+	class MockConstraint : public PxConstraint
+	{
+	public:
+		MockConstraint(PxConstraintConnector& connector) : mConnector(connector) {}
+
+		virtual	void release() { mConnector.onConstraintRelease(); delete this; }
+		virtual	PxU32 getObjectSize() const { return sizeof(*this); }
+
+		// unused
+		virtual	PxScene* getScene() const { return NULL; }
+		virtual	void getActors(PxRigidActor*&, PxRigidActor*&) const {}
+		virtual	void setActors(PxRigidActor*, PxRigidActor*) {}
+		virtual	void markDirty() {}
+		virtual	void setFlags(PxConstraintFlags) {}
+		virtual	PxConstraintFlags getFlags() const { return PxConstraintFlags(); }
+		virtual	void getForce(PxVec3&, PxVec3&) const {}
+		virtual	void setBreakForce(PxReal, PxReal) {}
+		virtual	void getBreakForce(PxReal&, PxReal&) const {}
+		virtual	void* getExternalReference(PxU32&) { return NULL; }
+		virtual	void setConstraintFunctions(PxConstraintConnector&, const PxConstraintShaderTable&) {}
+
+	private:
+		PxConstraintConnector& mConnector;
+	};
+
+	class MockPhysics : public PxPhysics
+	{
+	public:
+		virtual	PxConstraint* createConstraint(PxRigidActor*, PxRigidActor*, PxConstraintConnector& connector, const PxConstraintShaderTable&, PxU32) { return new MockConstraint(connector); }
+		virtual	const PxTolerancesScale& getTolerancesScale() const { return mScale; }
+		virtual	PxFoundation& getFoundation() { return shdfnd::getFoundation(); }
+
+		// unused
+		virtual	bool registerClass(PxType, PxClassCreationCallback) { return false; }
+		virtual	PxUserReferences* createUserReferences() { return NULL; }
+		virtual	void releaseUserReferences(PxUserReferences&) {}
+		virtual	PxCollection* createCollection() { return NULL; }
+		virtual	void releaseCollection(PxCollection&) {}
+		virtual	void addCollection(const PxCollection&, PxScene&) {}
+		virtual	void release() {}
+		virtual	PxScene* createScene(const PxSceneDesc&) { return NULL; }
+		virtual	PxU32 getNbScenes() const { return 0; }
+		virtual	PxU32 getScenes(PxScene**, PxU32, PxU32) const { return 0; }
+		virtual	PxRigidStatic* createRigidStatic(const PxTransform&) { return NULL; }
+		virtual	PxRigidDynamic* createRigidDynamic(const PxTransform&) { return NULL; }
+		virtual	PxArticulation* createArticulation() { return NULL; }
+		virtual	PxAggregate* createAggregate(PxU32, bool) { return NULL; }
+		virtual	PxParticleSystem* createParticleSystem(PxU32, bool) { return NULL; }
+		virtual	PxParticleFluid* createParticleFluid(PxU32, bool) { return NULL; }
+		virtual	PxCloth* createCloth(const PxTransform&, PxClothFabric&, const PxClothParticle*, const PxClothCollisionData&, PxClothFlags) { return NULL; }
+		virtual	PxMaterial* createMaterial(PxReal, PxReal, PxReal) { return NULL; }
+		virtual	PxU32 getNbMaterials() const { return 0; }
+		virtual	PxU32 getMaterials(PxMaterial**, PxU32, PxU32) const { return 0; }
+		virtual	PxTriangleMesh* createTriangleMesh(PxInputStream&) { return NULL; }
+		virtual	PxU32 getNbTriangleMeshes() const { return 0; }
+		virtual	PxU32 getTriangleMeshes(PxTriangleMesh**, PxU32, PxU32) const { return 0; }
+		virtual	PxHeightField* createHeightField(const PxHeightFieldDesc&) { return NULL; }
+		virtual	PxU32 getNbHeightFields() const { return 0; }
+		virtual	PxU32 getHeightFields(PxHeightField**, PxU32, PxU32) const { return 0; }
+		virtual	PxConvexMesh* createConvexMesh(PxInputStream&) { return NULL; }
+		virtual	PxU32 getNbConvexMeshes() const { return 0; }
+		virtual	PxU32 getConvexMeshes(PxConvexMesh**, PxU32, PxU32) const { return 0; }
+		virtual	PxClothFabric* createClothFabric(PxInputStream&) { return NULL; }
+		virtual	PxClothFabric* createClothFabric(PxU32, PxU32, const PxU32*, const PxClothFabricPhaseType::Enum*, PxU32, const PxReal*, PxU32, const PxU32*, const PxU32*, const PxU32*) { return NULL; }
+		virtual	PxU32 getNbClothFabrics() const { return 0; }
+		virtual	PxU32 getClothFabrics(PxClothFabric**, PxU32) const { return 0; }
+		virtual	PxVisualDebugger* getVisualDebugger() { return NULL; }
+		virtual	physx::debugger::comm::PvdConnectionManager* getPvdConnectionManager() { return NULL; }
+		virtual	physx::PxProfileZoneManager* getProfileZoneManager() { return NULL; }
+
+		PxTolerancesScale	mScale;
+	};
+
+	// Answers the raycasts against the plane normal.dot(x) + d = 0 when the query is executed, like the SDK's
+	// batch query it writes the results to the buffer passed in and the hits to its own hit buffer.
+	class MockBatchQuery : public PxBatchQuery
+	{
+	public:
+		MockBatchQuery(PxRaycastQueryResult* results, PxShape& ground, const PxVec3& normal, PxReal d)
+		: mResults(results), mGround(ground), mNormal(normal), mD(d), mNbRaycasts(0), mNbRaycastsLastQuery(0)
+		{
+		}
+
+		virtual	void raycastSingle(const PxVec3& origin, const PxVec3& unitDir, PxReal distance, const PxSceneQueryFilterData&, PxSceneQueryFlags, void*, const PxSceneQueryCache*) const
+		{
+			const Ray ray = { origin, unitDir, distance };
+			mRays.push_back(ray);
+		}
+
+		virtual	void execute()
+		{
+			mHits.resize(mRays.size());
+			for(size_t i = 0; i < mRays.size(); i++)
+			{
+				PxRaycastQueryResult& result = mResults[i];
+				result.hits = NULL;
+				result.nbHits = 0;
+				result.queryStatus = 0;
+				result.userData = NULL;
+
+				const PxReal cosAngle = mNormal.dot(mRays[i].dir);
+				const PxReal distance = cosAngle < 0.0f ? -(mNormal.dot(mRays[i].origin) + mD) / cosAngle : -1.0f;
+				if(distance >= 0.0f && distance <= mRays[i].length)
+				{
+					PxRaycastHit& hit = mHits[i];
+					hit.shape = &mGround;
+					hit.impact = mRays[i].origin + mRays[i].dir * distance;
+					hit.normal = mNormal;
+					hit.distance = distance;
+					result.hits = &hit;
+					result.nbHits = 1;
+				}
+			}
+			mNbRaycastsLastQuery = PxU32(mRays.size());
+			mNbRaycasts += mNbRaycastsLastQuery;
+			mRays.clear();
+		}
+
+		PxU32 getNbRaycasts() const { return mNbRaycasts; }
+		PxU32 getNbRaycastsLastQuery() const { return mNbRaycastsLastQuery; }
+
+		// unused
+		virtual	PxBatchQueryPreFilterShader getPreFilterShader() const { return PxBatchQueryPreFilterShader(); }
+		virtual	PxBatchQueryPostFilterShader getPostFilterShader() const { return PxBatchQueryPostFilterShader(); }
+		virtual	const void* getFilterShaderData() const { return NULL; }
+		virtual	PxU32 getFilterShaderDataSize() const { return 0; }
+		virtual	PxClientID getOwnerClient() const { return 0; }
+		virtual	void release() {}
+		virtual	void raycastAny(const PxVec3&, const PxVec3&, PxReal, const PxSceneQueryFilterData&, void*, const PxSceneQueryCache*) const {}
+		virtual	void raycastMultiple(const PxVec3&, const PxVec3&, PxReal, const PxSceneQueryFilterData&, PxSceneQueryFlags, void*, const PxSceneQueryCache*) const {}
+		virtual	void overlapMultiple(const PxGeometry&, const PxTransform&, const PxSceneQueryFilterData&, void*, const PxSceneQueryCache*, PxU32) const {}
+		virtual	void sweepSingle(const PxGeometry&, const PxTransform&, const PxVec3&, const PxReal, PxSceneQueryFlags, const PxSceneQueryFilterData&, void*, const PxSceneQueryCache*, const PxReal) const {}
+		virtual	void linearCompoundGeometrySweepSingle(const PxGeometry**, const PxTransform*, const PxFilterData*, PxU32, const PxVec3&, const PxReal, PxSceneQueryFilterFlags, PxSceneQueryFlags, void*, const PxSweepCache*, const PxReal) const {}
+		virtual	void sweepMultiple(const PxGeometry&, const PxTransform&, const PxVec3&, const PxReal, PxSceneQueryFlags, const PxSceneQueryFilterData&, void*, const PxSceneQueryCache*, const PxReal) const {}
+		virtual	void linearCompoundGeometrySweepMultiple(const PxGeometry**, const PxTransform*, const PxFilterData*, PxU32, const PxVec3&, const PxReal, PxSceneQueryFilterFlags, PxSceneQueryFlags, void*, const PxSweepCache*, const PxReal) const {}
+
+	private:
+		struct Ray
+		{
+			PxVec3	origin;
+			PxVec3	dir;
+			PxReal	length;
+		};
+
+		PxRaycastQueryResult*			mResults;
+		PxShape&						mGround;
+		PxVec3							mNormal;
+		PxReal							mD;
+		PxU32							mNbRaycasts;
+		PxU32							mNbRaycastsLastQuery;
+		mutable std::vector<Ray>		mRays;
+		std::vector<PxRaycastHit>		mHits;
+	};
+
+} // namespace headless
+} // namespace physx
+
+#endif // HEADLESS_VEHICLE_SCENE_MOCKS_H
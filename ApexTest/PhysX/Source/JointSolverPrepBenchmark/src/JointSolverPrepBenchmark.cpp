@@ -0,0 +1,375 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+// Headless joints per millisecond benchmark of the joint solver prep, comparing the single joint
+// shaders the SDK calls through a function pointer with the batch path of PxJointBatchSolverPrep().
+// The joint data is generated directly, so no PxPhysics instance is needed.
+//
+//	JointSolverPrepBenchmark [options]
+//		-csv			print the results as comma separated values
+//		-joints <n>		number of joints per set, default 20000
+//		-scale <n>		multiply the repetition count by n, default 1
+
+#include "ExtD6Joint.h"
+#include "ExtRevoluteJoint.h"
+#include "ExtSphericalJoint.h"
+#include "ExtPrismaticJoint.h"
+#include "ExtFixedJoint.h"
+#include "ExtJointSolverPrep.h"
+#include "extensions/PxJointBatchSolverPrep.h"
+#include "PxDefaultAllocator.h"
+#include "PsTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+using namespace physx::Ext;
+
+namespace
+{
+	typedef PxU32 (*SolverPrep)(Px1DConstraint*, PxVec3&, PxU32, const void*, const PxTransform&, const PxTransform&);
+
+	const PxU32 MAX_ROWS = PX_JOINT_MAX_SOLVER_ROWS;
+
+	struct Joint
+	{
+		PxJointType::Enum	type;
+		JointData*			data;
+		SolverPrep			prep;
+	};
+
+	PxDefaultAllocator gAllocator;
+
+	PxReal randomFloat(PxReal lo, PxReal hi)
+	{
+		return lo + (hi - lo) * (PxReal(rand()) / PxReal(RAND_MAX));
+	}
+
+	PxTransform randomTransform()
+	{
+		const PxVec3 p(randomFloat(-5.0f, 5.0f), randomFloat(-5.0f, 5.0f), randomFloat(-5.0f, 5.0f));
+		if(rand() % 8 == 0)
+			return PxTransform(p);
+		return PxTransform(p, PxQuat(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f)).getNormalized());
+	}
+
+	void randomLimit(PxJointLimitParameters& limit)
+	{
+		limit.restitution		= rand() % 2 ? 0.0f : randomFloat(0.0f, 1.0f);
+		limit.spring			= rand() % 2 ? 0.0f : randomFloat(0.0f, 100.0f);
+		limit.damping			= randomFloat(0.0f, 10.0f);
+		limit.contactDistance	= randomFloat(0.01f, 0.1f);
+	}
+
+	template<class T>
+	T* allocateData()
+	{
+		T* data = reinterpret_cast<T*>(gAllocator.allocate(sizeof(T), "JointData", __FILE__, __LINE__));
+		memset(data, 0, sizeof(T));
+		data->c2b[0] = randomTransform();
+		data->c2b[1] = randomTransform();
+		return data;
+	}
+
+	// The derived limit values are set up the way the joints' setters do it.
+	JointData* createD6Data()
+	{
+		D6JointData* d = allocateData<D6JointData>();
+		for(PxU32 i = 0; i < 6; i++)
+		{
+			const PxU32 motion = PxU32(rand() % 3);
+			d->motion[i] = PxD6Motion::Enum(motion);
+			if(motion == PxD6Motion::eLOCKED)
+				d->locked |= 1 << i;
+			else if(motion == PxD6Motion::eLIMITED)
+				d->limited |= 1 << i;
+		}
+		randomLimit(d->linearLimit);
+		d->linearLimit.value = randomFloat(0.1f, 2.0f);
+		randomLimit(d->twistLimit);
+		d->twistLimit.lower = randomFloat(-1.0f, -0.1f);
+		d->twistLimit.upper = randomFloat(0.1f, 1.0f);
+		randomLimit(d->swingLimit);
+		d->swingLimit.yAngle = randomFloat(0.2f, 1.4f);
+		d->swingLimit.zAngle = randomFloat(0.2f, 1.4f);
+		for(PxU32 i = 0; i < 6; i++)
+		{
+			if(rand() % 2)
+			{
+				d->driving |= 1 << i;
+				d->drive[i].spring = randomFloat(0.0f, 100.0f);
+				d->drive[i].damping = randomFloat(0.0f, 10.0f);
+				d->drive[i].forceLimit = randomFloat(1.0f, 1000.0f);
+			}
+		}
+		if(rand() % 2)
+			d->driving &= ~(1 << PxD6Drive::eSLERP);
+		else
+			d->driving &= ~((1 << PxD6Drive::eSWING) | (1 << PxD6Drive::eTWIST));
+		d->drivePosition = randomTransform();
+		d->driveLinearVelocity = PxVec3(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f));
+		d->driveAngularVelocity = PxVec3(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f));
+
+		d->thSwingY = PxTan(d->swingLimit.yAngle / 2);
+		d->thSwingZ = PxTan(d->swingLimit.zAngle / 2);
+		d->thSwingPad = PxTan(d->swingLimit.contactDistance / 2);
+		d->tqSwingY = PxTan(d->swingLimit.yAngle / 4);
+		d->tqSwingZ = PxTan(d->swingLimit.zAngle / 4);
+		d->tqSwingPad = PxTan(d->swingLimit.contactDistance / 4);
+		d->tqTwistLow = PxTan(d->twistLimit.lower / 4);
+		d->tqTwistHigh = PxTan(d->twistLimit.upper / 4);
+		d->tqTwistPad = PxTan(d->twistLimit.contactDistance / 4);
+		d->linearMinDist = 1e-6f;
+		return d;
+	}
+
+	JointData* createRevoluteData()
+	{
+		RevoluteJointData* d = allocateData<RevoluteJointData>();
+		d->driveVelocity = randomFloat(-3.0f, 3.0f);
+		d->driveForceLimit = randomFloat(1.0f, 100.0f);
+		d->driveGearRatio = randomFloat(0.5f, 2.0f);
+		randomLimit(d->limit);
+		d->limit.lower = randomFloat(-2.0f, -0.1f);
+		d->limit.upper = randomFloat(0.1f, 2.0f);
+		d->tqHigh = PxTan(d->limit.upper / 4);
+		d->tqLow = PxTan(d->limit.lower / 4);
+		d->tqPad = PxTan(d->limit.contactDistance / 4);
+		d->jointFlags = PxRevoluteJointFlags(PxU16(rand() % 8));
+		return d;
+	}
+
+	JointData* createSphericalData()
+	{
+		SphericalJointData* d = allocateData<SphericalJointData>();
+		randomLimit(d->limit);
+		d->limit.yAngle = randomFloat(0.2f, 1.4f);
+		d->limit.zAngle = randomFloat(0.2f, 1.4f);
+		d->tanQYLimit = PxTan(d->limit.yAngle / 4);
+		d->tanQZLimit = PxTan(d->limit.zAngle / 4);
+		d->tanQPad = PxTan(d->limit.contactDistance / 4);
+		d->jointFlags = PxSphericalJointFlags(PxU16(rand() % 4));
+		return d;
+	}
+
+	JointData* createPrismaticData()
+	{
+		PrismaticJointData* d = allocateData<PrismaticJointData>();
+		randomLimit(d->limit);
+		d->limit.lower = randomFloat(-2.0f, -0.1f);
+		d->limit.upper = randomFloat(0.1f, 2.0f);
+		d->jointFlags = PxPrismaticJointFlags(PxU16(rand() % 4));
+		return d;
+	}
+
+	Joint createJoint(PxJointType::Enum type)
+	{
+		Joint joint;
+		joint.type = type;
+		switch(type)
+		{
+		case PxJointType::eD6:			joint.data = createD6Data();					joint.prep = D6JointSolverPrep;			break;
+		case PxJointType::eREVOLUTE:	joint.data = createRevoluteData();				joint.prep = RevoluteJointSolverPrep;	break;
+		case PxJointType::eSPHERICAL:	joint.data = createSphericalData();				joint.prep = SphericalJointSolverPrep;	break;
+		case PxJointType::ePRISMATIC:	joint.data = createPrismaticData();				joint.prep = PrismaticJointSolverPrep;	break;
+		default:						joint.data = allocateData<FixedJointData>();	joint.prep = FixedJointSolverPrep;		break;
+		}
+		return joint;
+	}
+
+	// what the SDK does before it calls a joint's solver prep
+	void initRows(Px1DConstraint* rows, PxU32 count)
+	{
+		memset(rows, 0, sizeof(Px1DConstraint) * count);
+		for(PxU32 i = 0; i < count; i++)
+		{
+			rows[i].minImpulse = -PX_MAX_REAL;
+			rows[i].maxImpulse = PX_MAX_REAL;
+		}
+	}
+
+	struct JointSet
+	{
+		const char*					name;
+		std::vector<Joint>			joints;
+		std::vector<PxTransform>	body0ToWorld;
+		std::vector<PxTransform>	body1ToWorld;
+	};
+
+	// weights per joint type, in the order D6, revolute, spherical, prismatic, fixed
+	void createJointSet(JointSet& set, const char* name, PxU32 nbJoints, const PxU32* weights)
+	{
+		static const PxJointType::Enum types[5] = { PxJointType::eD6, PxJointType::eREVOLUTE, PxJointType::eSPHERICAL, PxJointType::ePRISMATIC, PxJointType::eFIXED };
+		PxU32 totalWeight = 0;
+		for(PxU32 i = 0; i < 5; i++)
+			totalWeight += weights[i];
+
+		set.name = name;
+		for(PxU32 i = 0; i < nbJoints; i++)
+		{
+			PxU32 r = PxU32(rand()) % totalWeight, t = 0;
+			while(r >= weights[t])
+				r -= weights[t++];
+			set.joints.push_back(createJoint(types[t]));
+			set.body0ToWorld.push_back(randomTransform());
+			set.body1ToWorld.push_back(rand() % 10 ? randomTransform() : PxTransform::createIdentity());
+		}
+	}
+
+	void releaseJointSet(JointSet& set)
+	{
+		for(size_t i = 0; i < set.joints.size(); i++)
+			gAllocator.deallocate(set.joints[i].data);
+	}
+
+	struct Result
+	{
+		const char*	set;
+		const char*	path;
+		double		jointsPerMs;
+	};
+
+	// Best of several runs of each path, also checks the batch rows against the single joint shaders.
+	PxU32 benchmarkJointSet(const JointSet& set, PxU32 reps, std::vector<Result>& results)
+	{
+		const PxU32 nbJoints = PxU32(set.joints.size());
+		std::vector<Px1DConstraint> scalarRows(nbJoints * MAX_ROWS), batchRows(nbJoints * MAX_ROWS);
+		std::vector<PxU32> scalarNbRows(nbJoints), firstRows(nbJoints), nbRows(nbJoints);
+		std::vector<PxVec3> body0WorldOffsets(nbJoints);
+
+		double bestScalar = 1e30, bestBatch = 1e30;
+		for(PxU32 run = 0; run < 5; run++)
+		{
+			shdfnd::Time timer;
+			for(PxU32 r = 0; r < reps; r++)
+			{
+				for(PxU32 i = 0; i < nbJoints; i++)
+				{
+					const Joint& joint = set.joints[i];
+					Px1DConstraint* rows = &scalarRows[i * MAX_ROWS];
+					PxVec3 body0WorldOffset;
+					initRows(rows, MAX_ROWS);
+					scalarNbRows[i] = joint.prep(rows, body0WorldOffset, MAX_ROWS, joint.data, set.body0ToWorld[i], set.body1ToWorld[i]);
+				}
+			}
+			bestScalar = PxMin(bestScalar, timer.getElapsedSeconds());
+
+			for(PxU32 r = 0; r < reps; r++)
+			{
+				JointBatchSolverPrep prep(&set.body0ToWorld[0], &set.body1ToWorld[0], &batchRows[0], nbJoints * MAX_ROWS,
+										  &firstRows[0], &nbRows[0], &body0WorldOffsets[0]);
+				for(PxU32 i = 0; i < nbJoints; i++)
+					prep.add(i, set.joints[i].type, *set.joints[i].data);
+				prep.flush();
+			}
+			bestBatch = PxMin(bestBatch, timer.getElapsedSeconds());
+		}
+
+		PxU32 nbMismatches = 0;
+		for(PxU32 i = 0; i < nbJoints; i++)
+		{
+			bool match = nbRows[i] == scalarNbRows[i];
+			for(PxU32 r = 0; match && r < nbRows[i]; r++)
+			{
+				const Px1DConstraint& a = scalarRows[i * MAX_ROWS + r];
+				const Px1DConstraint& b = batchRows[firstRows[i] + r];
+				match = a.flags == b.flags && a.solveGroup == b.solveGroup &&
+						(a.linear0 - b.linear0).magnitude() <= 1e-3f * (1.0f + a.linear0.magnitude()) &&
+						(a.angular0 - b.angular0).magnitude() <= 1e-3f * (1.0f + a.angular0.magnitude()) &&
+						PxAbs(a.geometricError - b.geometricError) <= 1e-3f * (1.0f + PxAbs(a.geometricError));
+			}
+			nbMismatches += match ? 0u : 1u;
+		}
+
+		const double nbPrepared = double(nbJoints) * reps;
+		Result scalar = { set.name, "scalar", nbPrepared / (bestScalar * 1000.0) };
+		Result batch = { set.name, "batch", nbPrepared / (bestBatch * 1000.0) };
+		results.push_back(scalar);
+		results.push_back(batch);
+		return nbMismatches;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 nbJoints = 20000, scale = 1;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-joints") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbJoints = PxU32(atoi(argv[++i]));
+		else if(!strcmp(argv[i], "-scale") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			scale = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-joints <n>] [-scale <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	static const PxU32 mixedWeights[5]		= { 1, 1, 1, 1, 1 };
+	static const PxU32 ragdollWeights[5]	= { 2, 4, 4, 0, 0 };
+	static const PxU32 d6Weights[5]			= { 1, 0, 0, 0, 0 };
+	static const PxU32 revoluteWeights[5]	= { 0, 1, 0, 0, 0 };
+	static const PxU32 sphericalWeights[5]	= { 0, 0, 1, 0, 0 };
+
+	srand(1);
+	JointSet sets[5];
+	createJointSet(sets[0], "mixed", nbJoints, mixedWeights);
+	createJointSet(sets[1], "ragdoll", nbJoints, ragdollWeights);
+	createJointSet(sets[2], "d6", nbJoints, d6Weights);
+	createJointSet(sets[3], "revolute", nbJoints, revoluteWeights);
+	createJointSet(sets[4], "spherical", nbJoints, sphericalWeights);
+
+	std::vector<Result> results;
+	PxU32 nbMismatches = 0;
+	for(PxU32 i = 0; i < 5; i++)
+		nbMismatches += benchmarkJointSet(sets[i], 10 * scale, results);
+
+	if(csv)
+		printf("set,path,joints_per_ms\n");
+	for(size_t i = 0; i < results.size(); i++)
+		printf(csv ? "%s,%s,%.0f\n" : "%-10s %-7s %10.0f joints/ms\n", results[i].set, results[i].path, results[i].jointsPerMs);
+
+	for(PxU32 i = 0; i < 5; i++)
+		releaseJointSet(sets[i]);
+
+	if(nbMismatches)
+	{
+		fprintf(stderr, "error: the batch rows of %u joints differ from the single joint path\n", nbMismatches);
+		return 2;
+	}
+	return 0;
+}
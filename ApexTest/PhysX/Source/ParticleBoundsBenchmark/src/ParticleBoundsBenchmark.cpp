@@ -0,0 +1,372 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+// Headless particles per millisecond benchmark of PxParticleExt::buildBoundsHash(). The context-free call
+// and BoundsHashContext with and without worker threads are compared with a copy of the original
+// implementation that allocated its cell and particle maps on every call. Every path must produce the
+// same bounds and sorted indices as the original. The particles fill a slab like a settled fluid, with a
+// tenth of the slots invalid, so no PxPhysics instance is needed.
+//
+//	ParticleBoundsBenchmark [options]
+//		-csv				print the results as comma separated values
+//		-particles <n>		number of particle slots, default 131072
+//		-scale <n>			multiply the repetition count by n, default 1
+
+#include "PxParticleExt.h"
+#include "HeadlessFoundation.h"
+#include "PsHash.h"
+#include "PsBitUtils.h"
+#include "PsMathUtils.h"
+#include "PsTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+
+namespace
+{
+	const PxU32 sInvalidIndex = 0xffffffff;
+
+	// The original implementation, kept as the reference for the output and the speed.
+	namespace reference
+	{
+		struct CellCoords
+		{
+			void set(const PxVec3& realVec, PxReal scale)
+			{
+				x = static_cast<PxI16>(shdfnd::floor(realVec.x * scale));
+				y = static_cast<PxI16>(shdfnd::floor(realVec.y * scale));
+				z = static_cast<PxI16>(shdfnd::floor(realVec.z * scale));
+			}
+
+			bool operator==(const CellCoords& v) const
+			{
+				return ((x == v.x) && (y == v.y) && (z == v.z));
+			}
+
+			PxI16 x;
+			PxI16 y;
+			PxI16 z;
+		};
+
+		struct Cell
+		{
+			CellCoords coords;
+			PxBounds3 aabb;
+			PxU32 start;
+			PxU32 size;
+		};
+
+		PxU32 getEntry(const CellCoords& coords, const PxU32 hashSize, const Cell* cells)
+		{
+			const PxU32 mix = static_cast<PxU32>(coords.x) + 101 * static_cast<PxU32>(coords.y) + 7919 * static_cast<PxU32>(coords.z);
+			PxU32 index = shdfnd::hash(mix) & (hashSize - 1);
+			for (;;)
+			{
+				const Cell& cell = cells[index];
+				if (cell.size == sInvalidIndex || cell.coords == coords)
+					break;
+				index = (index + 1) & (hashSize - 1);
+			}
+			return index;
+		}
+
+		PxU32 buildBoundsHash(PxU32* sortedParticleIndices,
+							  PxParticleExt::ParticleBounds* particleBounds,
+							  const PxStrideIterator<const PxVec3>& positionBuffer,
+							  const PxU32 validParticleRange,
+							  const PxU32* validParticleBitmap,
+							  const PxU32 hashSize,
+							  const PxU32 maxBounds,
+							  const PxReal gridSpacing)
+		{
+			const PxReal cellSizeInv = 1.0f / gridSpacing;
+
+			std::vector<PxU32> particleToCellMap(validParticleRange);
+			std::vector<Cell> cells(hashSize);
+			memset(&cells[0], 0xff, sizeof(Cell) * hashSize);
+
+			PxU32 entryCounter = 0;
+			if (validParticleRange > 0)
+			{
+				for (PxU32 w = 0; w <= (validParticleRange-1) >> 5; w++)
+					for (PxU32 b = validParticleBitmap[w]; b; b &= b-1)
+					{
+						const PxU32 index = (w<<5|shdfnd::lowestSetBit(b));
+						const PxVec3& position = positionBuffer[index];
+
+						PxU32& cellIndex = particleToCellMap[index];
+						cellIndex = sInvalidIndex;
+						if (entryCounter < maxBounds)
+						{
+							CellCoords particleCoords;
+							particleCoords.set(position, cellSizeInv);
+							cellIndex = getEntry(particleCoords, hashSize, &cells[0]);
+
+							Cell& cell = cells[cellIndex];
+							if (cell.size == sInvalidIndex)
+							{
+								cell.coords = particleCoords;
+								cell.aabb = PxBounds3(position, position);
+								cell.size = 1;
+								++entryCounter;
+							}
+							else
+							{
+								cell.aabb.include(position);
+								++cell.size;
+							}
+						}
+					}
+			}
+
+			PxU32 numBounds = 0;
+			for (PxU32 i = 0, counter = 0; i < cells.size(); i++)
+			{
+				Cell& cell = cells[i];
+				if (cell.size != sInvalidIndex)
+				{
+					cell.start = counter;
+					counter += cell.size;
+
+					PxParticleExt::ParticleBounds& cellBounds = particleBounds[numBounds++];
+					cellBounds.bounds = cell.aabb;
+					cellBounds.firstParticle = cell.start;
+					cellBounds.numParticles = cell.size;
+
+					cell.size = 0;
+				}
+			}
+
+			if (validParticleRange > 0)
+			{
+				for (PxU32 w = 0; w <= (validParticleRange-1) >> 5; w++)
+					for (PxU32 b = validParticleBitmap[w]; b; b &= b-1)
+					{
+						const PxU32 index = (w<<5|shdfnd::lowestSetBit(b));
+						const PxU32 cellIndex = particleToCellMap[index];
+						if (cellIndex != sInvalidIndex)
+						{
+							Cell& cell = cells[cellIndex];
+							sortedParticleIndices[cell.start + cell.size] = index;
+							++cell.size;
+						}
+					}
+			}
+
+			return numBounds;
+		}
+	}
+
+	struct Particles
+	{
+		std::vector<PxVec3>	positions;
+		std::vector<PxU32>	validBitmap;
+		PxU32				nbValid;
+	};
+
+	struct Scenario
+	{
+		const char*	name;
+		PxU32		hashSize;
+		PxU32		maxBounds;
+		PxReal		gridSpacing;
+	};
+
+	enum Path
+	{
+		eREFERENCE,
+		eCONTEXT_FREE,
+		eCONTEXT,
+		eCONTEXT_1_WORKER,
+		eCONTEXT_3_WORKERS,
+		eNB_PATHS
+	};
+
+	const char* const gPathNames[eNB_PATHS] = { "reference", "context_free", "context", "context_1w", "context_3w" };
+
+	struct Output
+	{
+		std::vector<PxU32>							sortedIndices;
+		std::vector<PxParticleExt::ParticleBounds>	bounds;
+		PxU32										nbBounds;
+	};
+
+	struct Result
+	{
+		const char*	scenario;
+		const char*	path;
+		PxU32		nbBounds;
+		double		particlesPerMs;
+	};
+
+	PxReal randomFloat(PxReal lo, PxReal hi)
+	{
+		return lo + (hi - lo) * (PxReal(rand()) / PxReal(RAND_MAX));
+	}
+
+	// A 40m x 40m slab 4m deep, with every tenth slot on average left invalid like a fluid after some deletions.
+	void createParticles(Particles& particles, PxU32 nbSlots)
+	{
+		particles.positions.resize(nbSlots);
+		particles.validBitmap.assign((nbSlots + 31) >> 5, 0);
+		particles.nbValid = 0;
+		for(PxU32 i = 0; i < nbSlots; i++)
+		{
+			particles.positions[i] = PxVec3(randomFloat(-20.0f, 20.0f), randomFloat(0.0f, 4.0f), randomFloat(-20.0f, 20.0f));
+			if(rand() % 10)
+			{
+				particles.validBitmap[i >> 5] |= 1u << (i & 31);
+				particles.nbValid++;
+			}
+		}
+	}
+
+	bool sameOutput(const Output& a, const Output& b, PxU32 nbValid)
+	{
+		if(a.nbBounds != b.nbBounds)
+			return false;
+		for(PxU32 i = 0; i < a.nbBounds; i++)
+		{
+			const PxParticleExt::ParticleBounds& x = a.bounds[i];
+			const PxParticleExt::ParticleBounds& y = b.bounds[i];
+			if(x.firstParticle != y.firstParticle || x.numParticles != y.numParticles ||
+			   !(x.bounds.minimum == y.bounds.minimum) || !(x.bounds.maximum == y.bounds.maximum))
+				return false;
+		}
+		const PxU32 nbSorted = a.nbBounds ? a.bounds[a.nbBounds - 1].firstParticle + a.bounds[a.nbBounds - 1].numParticles : 0;
+		PX_ASSERT(nbSorted <= nbValid);
+		PX_UNUSED(nbValid);
+		return !nbSorted || !memcmp(&a.sortedIndices[0], &b.sortedIndices[0], nbSorted * sizeof(PxU32));
+	}
+
+	PxU32 benchmarkScenario(const Scenario& scenario, const Particles& particles, PxU32 nbRepetitions, std::vector<Result>& results)
+	{
+		const PxU32 nbSlots = PxU32(particles.positions.size());
+		const PxStrideIterator<const PxVec3> positions(&particles.positions[0]);
+
+		PxParticleExt::BoundsHashContext* contexts[eNB_PATHS] = { NULL, NULL, 
+			PxParticleExt::createBoundsHashContext(0), PxParticleExt::createBoundsHashContext(1), PxParticleExt::createBoundsHashContext(3) };
+
+		Output outputs[eNB_PATHS];
+		PxU32 nbMismatches = 0;
+		for(PxU32 path = 0; path < eNB_PATHS; path++)
+		{
+			Output& output = outputs[path];
+			output.sortedIndices.assign(particles.nbValid, sInvalidIndex);
+			output.bounds.resize(scenario.maxBounds);
+
+			shdfnd::Time timer;
+			for(PxU32 r = 0; r < nbRepetitions; r++)
+			{
+				if(path == eREFERENCE)
+					output.nbBounds = reference::buildBoundsHash(&output.sortedIndices[0], &output.bounds[0], positions, nbSlots, 
+						&particles.validBitmap[0], scenario.hashSize, scenario.maxBounds, scenario.gridSpacing);
+				else if(path == eCONTEXT_FREE)
+					output.nbBounds = PxParticleExt::buildBoundsHash(&output.sortedIndices[0], &output.bounds[0], positions, nbSlots, 
+						&particles.validBitmap[0], scenario.hashSize, scenario.maxBounds, scenario.gridSpacing);
+				else
+					output.nbBounds = PxParticleExt::buildBoundsHash(*contexts[path], &output.sortedIndices[0], &output.bounds[0], positions, nbSlots, 
+						&particles.validBitmap[0], scenario.hashSize, scenario.maxBounds, scenario.gridSpacing);
+			}
+			const double seconds = timer.getElapsedSeconds();
+
+			const Result result = { scenario.name, gPathNames[path], output.nbBounds, double(particles.nbValid) * nbRepetitions / (seconds * 1000.0) };
+			results.push_back(result);
+
+			if(path != eREFERENCE && !sameOutput(outputs[eREFERENCE], output, particles.nbValid))
+			{
+				fprintf(stderr, "error: %s %s differs from the reference output\n", scenario.name, gPathNames[path]);
+				nbMismatches++;
+			}
+		}
+
+		for(PxU32 path = 0; path < eNB_PATHS; path++)
+		{
+			if(contexts[path])
+				contexts[path]->release();
+		}
+		return nbMismatches;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 nbSlots = 131072, scale = 1;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-particles") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbSlots = PxU32(atoi(argv[++i]));
+		else if(!strcmp(argv[i], "-scale") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			scale = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-particles <n>] [-scale <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// 1m cells give 6400 bounds, 4m cells 100; the last one stops at maxBounds
+	const Scenario scenarios[] =
+	{
+		{ "cells_1m",		8192,	8192,	1.0f },
+		{ "cells_4m",		1024,	1024,	4.0f },
+		{ "cells_1m_max1k",	8192,	1024,	1.0f }
+	};
+	const PxU32 nbScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+
+	srand(1);
+	Particles particles;
+	createParticles(particles, nbSlots);
+
+	std::vector<Result> results;
+	PxU32 nbMismatches = 0;
+	for(PxU32 i = 0; i < nbScenarios; i++)
+		nbMismatches += benchmarkScenario(scenarios[i], particles, 20 * scale, results);
+
+	if(csv)
+		printf("scenario,path,bounds,particles_per_ms\n");
+	for(size_t i = 0; i < results.size(); i++)
+		printf(csv ? "%s,%s,%u,%.0f\n" : "%-15s %-13s %5u bounds %10.0f particles/ms\n", results[i].scenario, results[i].path, results[i].nbBounds, results[i].particlesPerMs);
+
+	if(nbMismatches || shdfnd::getHeadlessErrorCount())
+	{
+		fprintf(stderr, "error: %u paths differ from the reference, the extensions reported %u errors\n", nbMismatches, shdfnd::getHeadlessErrorCount());
+		return 2;
+	}
+	return 0;
+}
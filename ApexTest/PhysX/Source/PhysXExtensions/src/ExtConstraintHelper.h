@@ -34,6 +34,7 @@
 #include "PxTransform.h"
 #include "PxJointLimit.h"
 #include "PxMat33.h"
+#include "PsIntrinsics.h"
 #include "ExtJoint.h"
 
 namespace physx
@@ -137,15 +138,59 @@ namespace Ext
 			row[2] = va * vb.z + vb * va.z + PxVec3(c.y,   -c.x,   d);
 		}
 
+		// The joint frames in world space and the quantities derived from them that the solver 
+		// prep functions share. Computed four joints at a time by the batch prep.
+		struct JointFrames
+		{
+			PxTransform		cA2w;
+			PxTransform		cB2w;
+			PxTransform		cB2cA;			// cA2w.transformInv(cB2w)
+			PxVec3			ra, rb;			// cB2w.p relative to the body origins
+			PxMat33			axesA;			// PxMat33(cA2w.q)
+			PxMat33			axesB;			// PxMat33(cB2w.q)
+			PxVec3			jacobian[3];	// computeJacobianAxes(cA2w.q, cB2w.q)
+		};
+
+		// minimumDistance flips cB2w.q into the hemisphere of cA2w.q.
+		PX_INLINE void computeJointFrames(JointFrames& frames,
+										  const JointData& data,
+										  const PxTransform& bA2w,
+										  const PxTransform& bB2w,
+										  bool minimumDistance)
+		{
+			frames.cA2w = bA2w.transform(data.c2b[0]);
+			frames.cB2w = bB2w.transform(data.c2b[1]);
+
+			if(minimumDistance && frames.cA2w.q.dot(frames.cB2w.q)<0)
+				frames.cB2w.q = -frames.cB2w.q;
+
+			frames.cB2cA = frames.cA2w.transformInv(frames.cB2w);
+			frames.ra = frames.cB2w.p - bA2w.p;
+			frames.rb = frames.cB2w.p - bB2w.p;
+			frames.axesA = PxMat33(frames.cA2w.q);
+			frames.axesB = PxMat33(frames.cB2w.q);
+			computeJacobianAxes(frames.jacobian, frames.cA2w.q, frames.cB2w.q);
+		}
+
+		// The state the solver initializes a row to before calling the solver prep.
+		PX_FORCE_INLINE void initConstraintRow(Px1DConstraint& c)
+		{
+			Ps::memZero(&c, sizeof(Px1DConstraint));
+			c.minImpulse = -PX_MAX_REAL;
+			c.maxImpulse = PX_MAX_REAL;
+		}
+
 		class ConstraintHelper
 		{
 			Px1DConstraint* mConstraints;
 			Px1DConstraint* mCurrent;
 			PxVec3 mRa, mRb;
+			bool mInitRows;
 
 		public:
-			ConstraintHelper(Px1DConstraint* c, const PxVec3& ra, const PxVec3& rb)
-				: mConstraints(c), mCurrent(c), mRa(ra), mRb(rb)	{}
+			// The solver passes in initialized rows, callers with their own row buffer set initRows.
+			ConstraintHelper(Px1DConstraint* c, const PxVec3& ra, const PxVec3& rb, bool initRows = false)
+				: mConstraints(c), mCurrent(c), mRa(ra), mRb(rb), mInitRows(initRows)	{}
 
 			// hard linear & angular
 			void linear(const PxVec3& axis, PxReal posErr)
@@ -214,17 +259,16 @@ namespace Ext
 
 			PxU32 getCount() { return PxU32(mCurrent - mConstraints); }
 
-			void prepareLockedAxes(const PxQuat& qA, const PxQuat& qB, const PxVec3& cB2cAp, PxU32 lin, PxU32 ang)
+			void prepareLockedAxes(const JointFrames& frames, PxU32 lin, PxU32 ang)
 			{
 				Px1DConstraint* current = mCurrent;
 				if(ang)
 				{
-					PxQuat qB2qA = qA.getConjugate() * qB;
+					PxQuat qB2qA = frames.cB2cA.q;
 					if(qB2qA.w<0)
 						qB2qA = -qB2qA;
 
-					PxVec3 row[3];
-					computeJacobianAxes(row, qA, qB);
+					const PxVec3* row = frames.jacobian;
 					PxVec3 imp = qB2qA.getImaginaryPart();
 					if(ang&1) angular(row[0], -2.0f*imp.x);
 					if(ang&2) angular(row[1], -2.0f*imp.y);
@@ -233,7 +277,8 @@ namespace Ext
 
 				if(lin)
 				{
-					PxMat33 axes(qA);
+					const PxMat33& axes = frames.axesA;
+					const PxVec3& cB2cAp = frames.cB2cA.p;
 					if(lin&1) linear(axes[0], -cB2cAp[0]);
 					if(lin&2) linear(axes[1], -cB2cAp[1]);
 					if(lin&4) linear(axes[2], -cB2cAp[2]);
@@ -245,13 +290,21 @@ namespace Ext
 
 			Px1DConstraint *getConstraintRow()
 			{
-				return mCurrent++;
+				return nextRow();
 			}
 
 		private:
-			Px1DConstraint* linear(const PxVec3& axis, PxReal posErr, PxU32 group)
+			Px1DConstraint* nextRow()
 			{
 				Px1DConstraint* c = mCurrent++;
+				if(mInitRows)
+					initConstraintRow(*c);
+				return c;
+			}
+
+			Px1DConstraint* linear(const PxVec3& axis, PxReal posErr, PxU32 group)
+			{
+				Px1DConstraint* c = nextRow();
 
 				c->linear0 = axis;					c->angular0	= mRa.cross(c->linear0);
 				c->linear1 = axis;					c->angular1 = mRb.cross(c->linear1);
@@ -268,7 +321,7 @@ namespace Ext
 
 			Px1DConstraint* angular(const PxVec3& axis, PxReal posErr, PxU32 group)
 			{
-				Px1DConstraint* c = mCurrent++;
+				Px1DConstraint* c = nextRow();
 
 				c->linear0 = PxVec3(0);		c->angular0			= axis;
 				c->linear1 = PxVec3(0);		c->angular1			= axis;
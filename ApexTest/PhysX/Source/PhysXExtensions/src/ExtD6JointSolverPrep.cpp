@@ -30,7 +30,7 @@
 
 #include <stdio.h>
 #include "ExtD6Joint.h"
-#include "ExtConstraintHelper.h"
+#include "ExtJointSolverPrep.h"
 #include "CmRenderOutput.h"
 #include "CmConeLimitHelper.h"
 
@@ -38,18 +38,10 @@ namespace physx
 {
 namespace Ext
 {
-	PxU32 D6JointSolverPrep(Px1DConstraint* constraints,
-		PxVec3& body0WorldOffset,
-		PxU32 maxConstraints,
-		const void* constantBlock,
-		const PxTransform& bA2w,
-		const PxTransform& bB2w)
+	void D6JointPrepareRows(joint::ConstraintHelper& g, const D6JointData& data, const joint::JointFrames& frames)
 	{
 		using namespace joint;
 
-		const D6JointData& data = 
-			*reinterpret_cast<const D6JointData*>(constantBlock);
-
 		const PxU32 SWING1_FLAG = 1<<PxD6Axis::eSWING1, 
 			SWING2_FLAG = 1<<PxD6Axis::eSWING2, 
 			TWIST_FLAG  = 1<<PxD6Axis::eTWIST;
@@ -60,16 +52,9 @@ namespace Ext
 		const PxD6JointDrive* drives = data.drive;
 		PxU32 locked = data.locked, limited = data.limited, driving = data.driving;
 
-		PxTransform cA2w = bA2w.transform(data.c2b[0]);
-		PxTransform cB2w = bB2w.transform(data.c2b[1]);
-
-		body0WorldOffset = cB2w.p-bA2w.p;
-		ConstraintHelper g(constraints, cB2w.p-bA2w.p, cB2w.p-bB2w.p);
-
-		if(cA2w.q.dot(cB2w.q)<0)	// minimum dist quat (equiv to flipping cB2bB.q, which we don't use anywhere)
-			cB2w.q = -cB2w.q;
-
-		PxTransform cB2cA = cA2w.transformInv(cB2w);	
+		const PxTransform& cA2w = frames.cA2w;
+		const PxTransform& cB2w = frames.cB2w;
+		const PxTransform& cB2cA = frames.cB2cA;
 
 		PX_ASSERT(data.c2b[0].isValid());
 		PX_ASSERT(data.c2b[1].isValid());
@@ -77,7 +62,8 @@ namespace Ext
 		PX_ASSERT(cB2w.isValid());
 		PX_ASSERT(cB2cA.isValid());
 
-		PxMat33 cA2w_m(cA2w.q), cB2w_m(cB2w.q);
+		const PxMat33& cA2w_m = frames.axesA;
+		const PxMat33& cB2w_m = frames.axesB;
 
 		// handy for swing computation
 		PxVec3 bX = cB2w_m[0], aY = cA2w_m[1], aZ = cA2w_m[2];
@@ -218,8 +204,26 @@ namespace Ext
 			g.angular(bX.cross(aY), -bX.dot(aY));
 		}
 
-		g.prepareLockedAxes(cA2w.q, cB2w.q, cB2cA.p,locked&7, locked>>3);
+		g.prepareLockedAxes(frames, locked&7, locked>>3);
+	}
+
+	PxU32 D6JointSolverPrep(Px1DConstraint* constraints,
+		PxVec3& body0WorldOffset,
+		PxU32 maxConstraints,
+		const void* constantBlock,
+		const PxTransform& bA2w,
+		const PxTransform& bB2w)
+	{
+		const D6JointData& data = 
+			*reinterpret_cast<const D6JointData*>(constantBlock);
+
+		// minimum dist quat (equiv to flipping cB2bB.q, which we don't use anywhere)
+		joint::JointFrames frames;
+		joint::computeJointFrames(frames, data, bA2w, bB2w, true);
 
+		body0WorldOffset = frames.ra;
+		joint::ConstraintHelper g(constraints, frames.ra, frames.rb);
+		D6JointPrepareRows(g, data, frames);
 		return g.getCount();
 	}
 }//namespace
@@ -29,13 +29,18 @@
 
 
 #include "ExtFixedJoint.h"
-#include "ExtConstraintHelper.h"
+#include "ExtJointSolverPrep.h"
 
 namespace physx
 {
 namespace Ext
 {
 
+	void FixedJointPrepareRows(joint::ConstraintHelper& ch, const FixedJointData&, const joint::JointFrames& frames)
+	{
+		ch.prepareLockedAxes(frames, 7, 7);
+	}
+
 	PxU32 FixedJointSolverPrep(Px1DConstraint* constraints,
 		PxVec3& body0WorldOffset,
 		PxU32 maxConstraints,
@@ -45,15 +50,12 @@ namespace Ext
 	{
 		const FixedJointData& data = *reinterpret_cast<const FixedJointData*>(constantBlock);
 
-		PxTransform cA2w = bA2w.transform(data.c2b[0]);
-		PxTransform cB2w = bB2w.transform(data.c2b[1]);
-
-		PxVec3 bOriginInA = cA2w.transformInv(cB2w.p);
-
-		body0WorldOffset = cB2w.p-bA2w.p;
-		joint::ConstraintHelper ch(constraints,cB2w.p-bA2w.p, cB2w.p-bB2w.p);
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, bOriginInA, 7, 7);
+		joint::JointFrames frames;
+		joint::computeJointFrames(frames, data, bA2w, bB2w, false);
 
+		body0WorldOffset = frames.ra;
+		joint::ConstraintHelper ch(constraints, frames.ra, frames.rb);
+		FixedJointPrepareRows(ch, data, frames);
 		return ch.getCount();
 	}
 
@@ -0,0 +1,233 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+  
+
+
+
+#include "ExtInertiaTensorBatch.h"
+#include "ExtSoaMath.h"
+#include "PsIntrinsics.h"
+
+using namespace physx;
+using namespace Ext;
+using namespace Ps::aos;
+using namespace Ext::soa;
+
+namespace
+{
+	PX_FORCE_INLINE PxF32* getLanes(Vec4V& v)
+	{
+		return reinterpret_cast<PxF32*>(&v);
+	}
+}
+
+InertiaTensorBatch::InertiaTensorBatch() :
+	mNbShapes(0)
+{
+}
+
+void InertiaTensorBatch::clear()
+{
+	mBlocks.clear();
+	mBodies.clear();
+	mShapeBodies.clear();
+	mNbShapes = 0;
+}
+
+void InertiaTensorBatch::beginBody()
+{
+	Body body;
+	body.firstShape = mNbShapes;
+	body.nbShapes = 0;
+	body.mass = 0.0f;
+	body.com = PxVec3(0);
+	for(PxU32 i=0; i<6; i++)
+		body.inertia[i] = 0.0f;
+	mBodies.pushBack(body);
+}
+
+void InertiaTensorBatch::cancelBody()
+{
+	PX_ASSERT(mBodies.size());
+	mNbShapes = mBodies.back().firstShape;
+	mShapeBodies.resize(mNbShapes);
+	mBlocks.resize((mNbShapes + 3) >> 2);
+	mBodies.popBack();
+}
+
+void InertiaTensorBatch::addShape(const PxTransform& pose, PxReal mass, const PxVec3& com, const PxMat33& inertia, PxReal density)
+{
+	PX_ASSERT(mBodies.size());
+
+	const PxU32 lane = mNbShapes & 3;
+	if(!lane)
+	{
+		ShapeBlock block;
+		Ps::memZero(&block, sizeof(ShapeBlock));
+		mBlocks.pushBack(block);
+	}
+
+	// move the inertia to the center of mass so that compute() only needs one parallel axis step
+	const PxReal cc = com.magnitudeSquared();
+
+	ShapeBlock& b = mBlocks.back();
+	getLanes(b.mass)[lane] = mass * density;
+	getLanes(b.com[0])[lane] = com.x;
+	getLanes(b.com[1])[lane] = com.y;
+	getLanes(b.com[2])[lane] = com.z;
+	getLanes(b.inertia[0])[lane] = (inertia.column0.x - mass * (cc - com.x * com.x)) * density;
+	getLanes(b.inertia[1])[lane] = (inertia.column1.y - mass * (cc - com.y * com.y)) * density;
+	getLanes(b.inertia[2])[lane] = (inertia.column2.z - mass * (cc - com.z * com.z)) * density;
+	getLanes(b.inertia[3])[lane] = (inertia.column1.x + mass * com.x * com.y) * density;
+	getLanes(b.inertia[4])[lane] = (inertia.column2.x + mass * com.x * com.z) * density;
+	getLanes(b.inertia[5])[lane] = (inertia.column2.y + mass * com.y * com.z) * density;
+	getLanes(b.q[0])[lane] = pose.q.x;
+	getLanes(b.q[1])[lane] = pose.q.y;
+	getLanes(b.q[2])[lane] = pose.q.z;
+	getLanes(b.q[3])[lane] = pose.q.w;
+	getLanes(b.p[0])[lane] = pose.p.x;
+	getLanes(b.p[1])[lane] = pose.p.y;
+	getLanes(b.p[2])[lane] = pose.p.z;
+
+	mShapeBodies.pushBack(mBodies.size() - 1);
+	mBodies.back().nbShapes++;
+	mNbShapes++;
+}
+
+void InertiaTensorBatch::compute(const PxVec3* lockedComs)
+{
+	const PxU32 nbBlocks = mBlocks.size();
+
+	// move the shapes into the body frames, R I R' and R com + p
+	for(PxU32 i=0; i<nbBlocks; i++)
+	{
+		ShapeBlock& b = mBlocks[i];
+
+		Quatx4 q;
+		q.x = b.q[0];	q.y = b.q[1];	q.z = b.q[2];	q.w = b.q[3];
+		Vec3x4 com;
+		com.x = b.com[0];	com.y = b.com[1];	com.z = b.com[2];
+		Vec3x4 p;
+		p.x = b.p[0];	p.y = b.p[1];	p.z = b.p[2];
+
+		com = add(rotate(q, com), p);
+		b.com[0] = com.x;	b.com[1] = com.y;	b.com[2] = com.z;
+
+		Vec3x4 r[3];
+		quatToMatrix(q, r);
+
+		const Vec4V* in = b.inertia;
+		Vec3x4 m[3];	// R I, columns
+		for(PxU32 c=0; c<3; c++)
+		{
+			const Vec4V i0 = c == 0 ? in[0] : c == 1 ? in[3] : in[4];
+			const Vec4V i1 = c == 0 ? in[3] : c == 1 ? in[1] : in[5];
+			const Vec4V i2 = c == 0 ? in[4] : c == 1 ? in[5] : in[2];
+			m[c].x = V4Add(V4Add(V4Mul(r[0].x, i0), V4Mul(r[1].x, i1)), V4Mul(r[2].x, i2));
+			m[c].y = V4Add(V4Add(V4Mul(r[0].y, i0), V4Mul(r[1].y, i1)), V4Mul(r[2].y, i2));
+			m[c].z = V4Add(V4Add(V4Mul(r[0].z, i0), V4Mul(r[1].z, i1)), V4Mul(r[2].z, i2));
+		}
+
+		// (R I) R', element ab is the sum over k of (R I)_ak R_bk
+		b.inertia[0] = V4Add(V4Add(V4Mul(m[0].x, r[0].x), V4Mul(m[1].x, r[1].x)), V4Mul(m[2].x, r[2].x));
+		b.inertia[1] = V4Add(V4Add(V4Mul(m[0].y, r[0].y), V4Mul(m[1].y, r[1].y)), V4Mul(m[2].y, r[2].y));
+		b.inertia[2] = V4Add(V4Add(V4Mul(m[0].z, r[0].z), V4Mul(m[1].z, r[1].z)), V4Mul(m[2].z, r[2].z));
+		b.inertia[3] = V4Add(V4Add(V4Mul(m[0].x, r[0].y), V4Mul(m[1].x, r[1].y)), V4Mul(m[2].x, r[2].y));
+		b.inertia[4] = V4Add(V4Add(V4Mul(m[0].x, r[0].z), V4Mul(m[1].x, r[1].z)), V4Mul(m[2].x, r[2].z));
+		b.inertia[5] = V4Add(V4Add(V4Mul(m[0].y, r[0].z), V4Mul(m[1].y, r[1].z)), V4Mul(m[2].y, r[2].z));
+	}
+
+	// masses and centers of mass
+	const PxU32 nbBodies = mBodies.size();
+	for(PxU32 i=0; i<nbBodies; i++)
+	{
+		Body& body = mBodies[i];
+		PxReal mass = 0.0f;
+		PxVec3 com(0);
+		for(PxU32 s=body.firstShape; s<body.firstShape+body.nbShapes; s++)
+		{
+			ShapeBlock& b = mBlocks[s>>2];
+			const PxReal m = getLanes(b.mass)[s&3];
+			mass += m;
+			com += PxVec3(getLanes(b.com[0])[s&3], getLanes(b.com[1])[s&3], getLanes(b.com[2])[s&3]) * m;
+		}
+		body.mass = mass;
+		if(lockedComs)
+			body.com = lockedComs[i];
+		else
+			body.com = mass != 0.0f ? com / mass : PxVec3(0);
+	}
+
+	// parallel axis theorem, m (|r|^2 E - r r') with r from the body reference point to the shape center of mass
+	for(PxU32 i=0; i<nbBlocks; i++)
+	{
+		ShapeBlock& b = mBlocks[i];
+
+		Vec3x4 ref;
+		ref.x = ref.y = ref.z = V4Zero();
+		for(PxU32 lane=0; lane<4 && (i<<2)+lane < mNbShapes; lane++)
+		{
+			const PxVec3& c = mBodies[mShapeBodies[(i<<2)+lane]].com;
+			getLanes(ref.x)[lane] = c.x;
+			getLanes(ref.y)[lane] = c.y;
+			getLanes(ref.z)[lane] = c.z;
+		}
+
+		Vec3x4 com;
+		com.x = b.com[0];	com.y = b.com[1];	com.z = b.com[2];
+		const Vec3x4 r = sub(com, ref);
+		const Vec4V xx = V4Mul(r.x, r.x), yy = V4Mul(r.y, r.y), zz = V4Mul(r.z, r.z);
+
+		b.inertia[0] = V4Add(b.inertia[0], V4Mul(b.mass, V4Add(yy, zz)));
+		b.inertia[1] = V4Add(b.inertia[1], V4Mul(b.mass, V4Add(xx, zz)));
+		b.inertia[2] = V4Add(b.inertia[2], V4Mul(b.mass, V4Add(xx, yy)));
+		b.inertia[3] = V4Sub(b.inertia[3], V4Mul(b.mass, V4Mul(r.x, r.y)));
+		b.inertia[4] = V4Sub(b.inertia[4], V4Mul(b.mass, V4Mul(r.x, r.z)));
+		b.inertia[5] = V4Sub(b.inertia[5], V4Mul(b.mass, V4Mul(r.y, r.z)));
+	}
+
+	for(PxU32 i=0; i<nbBodies; i++)
+	{
+		Body& body = mBodies[i];
+		for(PxU32 s=body.firstShape; s<body.firstShape+body.nbShapes; s++)
+		{
+			ShapeBlock& b = mBlocks[s>>2];
+			for(PxU32 j=0; j<6; j++)
+				body.inertia[j] += getLanes(b.inertia[j])[s&3];
+		}
+	}
+}
+
+PxMat33 InertiaTensorBatch::getInertia(PxU32 body) const
+{
+	const PxReal* i = mBodies[body].inertia;
+	return PxMat33(PxVec3(i[0], i[3], i[4]),
+				   PxVec3(i[3], i[1], i[5]),
+				   PxVec3(i[4], i[5], i[2]));
+}
@@ -0,0 +1,104 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef PX_PHYSICS_EXTENSIONS_INERTIATENSOR_BATCH_H
+#define PX_PHYSICS_EXTENSIONS_INERTIATENSOR_BATCH_H
+
+#include "CmPhysXCommon.h"
+#include "PxTransform.h"
+#include "PxMat33.h"
+#include "PsArray.h"
+#include "PsAlignedMalloc.h"
+#include "PsVecMath.h"
+
+namespace physx
+{
+namespace Ext
+{
+	// Sums the mass properties of the shapes of many bodies. The shapes are added body by body, 
+	// the rotation into the body frame and the parallel axis sums run four shapes at a time. 
+	// The results match InertiaTensorComputer up to the order of the float operations.
+	class InertiaTensorBatch
+	{
+	public:
+						InertiaTensorBatch();
+
+		void			clear();
+
+		// Starts the shapes of the next body.
+		void			beginBody();
+
+		// Drops the shapes added since beginBody() together with the body.
+		void			cancelBody();
+
+		// mass, com and inertia are for unit density in the shape frame, inertia is about the frame origin
+		// like InertiaTensorComputer keeps it.
+		void			addShape(const PxTransform& pose, PxReal mass, const PxVec3& com, const PxMat33& inertia, PxReal density);
+
+		// The inertia of a body is expressed about its center of mass, or about lockedComs[body] if 
+		// lockedComs is not NULL. Bodies without mass get a zero inertia.
+		void			compute(const PxVec3* lockedComs);
+
+		PxU32			getNbBodies()					const	{ return mBodies.size();			}
+		PxReal			getMass(PxU32 body)				const	{ return mBodies[body].mass;		}
+		const PxVec3&	getCenterOfMass(PxU32 body)		const	{ return mBodies[body].com;		}
+		PxMat33			getInertia(PxU32 body)			const;
+
+	private:
+		// Four shapes, one per lane. Inertia is the upper triangle of the symmetric tensor.
+		struct ShapeBlock
+		{
+			Ps::aos::Vec4V	mass;
+			Ps::aos::Vec4V	com[3];
+			Ps::aos::Vec4V	inertia[6];		// xx, yy, zz, xy, xz, yz
+			Ps::aos::Vec4V	q[4];
+			Ps::aos::Vec4V	p[3];
+		};
+
+		struct Body
+		{
+			PxU32	firstShape;
+			PxU32	nbShapes;
+			PxReal	mass;
+			PxVec3	com;
+			PxReal	inertia[6];
+		};
+
+		Ps::Array<ShapeBlock, Ps::AlignedAllocator<16> >	mBlocks;
+		Ps::Array<Body>										mBodies;
+		Ps::Array<PxU32>									mShapeBodies;
+		PxU32												mNbShapes;
+	};
+
+} // namespace Ext
+
+}
+
+#endif
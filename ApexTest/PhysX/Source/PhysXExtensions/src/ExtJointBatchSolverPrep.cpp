@@ -0,0 +1,274 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+  
+
+
+#include "PxJointBatchSolverPrep.h"
+#include "ExtJointSolverPrep.h"
+#include "ExtD6Joint.h"
+#include "ExtDistanceJoint.h"
+#include "ExtFixedJoint.h"
+#include "ExtPrismaticJoint.h"
+#include "ExtRevoluteJoint.h"
+#include "ExtSphericalJoint.h"
+#include "ExtSoaMath.h"
+
+using namespace physx;
+using namespace Ext;
+using namespace Ps::aos;
+using namespace Ext::soa;
+
+namespace
+{
+	// joint::computeJacobianAxes
+	PX_FORCE_INLINE void computeJacobianAxes(const Quatx4& qa, const Quatx4& qb, Vec3x4* row)
+	{
+		Vec3x4 c;
+		c.x = V4Add(V4Mul(qb.x, qa.w), V4Mul(qa.x, qb.w));
+		c.y = V4Add(V4Mul(qb.y, qa.w), V4Mul(qa.y, qb.w));
+		c.z = V4Add(V4Mul(qb.z, qa.w), V4Mul(qa.z, qb.w));
+		const Vec4V d = V4Sub(V4Mul(qa.w, qb.w), V4Add(V4Add(V4Mul(qa.x, qb.x), V4Mul(qa.y, qb.y)), V4Mul(qa.z, qb.z)));
+
+		const Vec4V* va = &qa.x;
+		const Vec4V* vb = &qb.x;
+		for(PxU32 i = 0; i < 3; i++)
+		{
+			// va * vb[i] + vb * va[i]
+			row[i].x = V4Add(V4Mul(qa.x, vb[i]), V4Mul(qb.x, va[i]));
+			row[i].y = V4Add(V4Mul(qa.y, vb[i]), V4Mul(qb.y, va[i]));
+			row[i].z = V4Add(V4Mul(qa.z, vb[i]), V4Mul(qb.z, va[i]));
+		}
+		row[0].x = V4Add(row[0].x, d);		row[0].y = V4Add(row[0].y, c.z);	row[0].z = V4Sub(row[0].z, c.y);
+		row[1].x = V4Sub(row[1].x, c.z);	row[1].y = V4Add(row[1].y, d);		row[1].z = V4Add(row[1].z, c.x);
+		row[2].x = V4Add(row[2].x, c.y);	row[2].y = V4Sub(row[2].y, c.x);	row[2].z = V4Add(row[2].z, d);
+	}
+
+	// joint::computeJointFrames for four joints
+	void computeJointFrames4(joint::JointFrames* frames, const JointData* const* data, 
+							 const PxTransform* const* bA2w, const PxTransform* const* bB2w, bool minimumDistance)
+	{
+		const PxTransform* c2bA[4] = { &data[0]->c2b[0], &data[1]->c2b[0], &data[2]->c2b[0], &data[3]->c2b[0] };
+		const PxTransform* c2bB[4] = { &data[0]->c2b[1], &data[1]->c2b[1], &data[2]->c2b[1], &data[3]->c2b[1] };
+
+		Quatx4 bAq, bBq, cAq, cBq;
+		Vec3x4 bAp, bBp, cAp, cBp;
+		loadTransforms(bA2w, bAq, bAp);
+		loadTransforms(bB2w, bBq, bBp);
+		loadTransforms(c2bA, cAq, cAp);
+		loadTransforms(c2bB, cBq, cBp);
+
+		// PxTransform::transform
+		cAp = add(rotate(bAq, cAp), bAp);
+		cAq = mul(bAq, cAq);
+		cBp = add(rotate(bBq, cBp), bBp);
+		cBq = mul(bBq, cBq);
+
+		if(minimumDistance)
+		{
+			const Vec4V dot = V4Add(V4Add(V4Add(V4Mul(cAq.x, cBq.x), V4Mul(cAq.y, cBq.y)), V4Mul(cAq.z, cBq.z)), V4Mul(cAq.w, cBq.w));
+			const BoolV flip = V4IsGrtr(V4Zero(), dot);
+			cBq.x = V4Sel(flip, V4Neg(cBq.x), cBq.x);
+			cBq.y = V4Sel(flip, V4Neg(cBq.y), cBq.y);
+			cBq.z = V4Sel(flip, V4Neg(cBq.z), cBq.z);
+			cBq.w = V4Sel(flip, V4Neg(cBq.w), cBq.w);
+		}
+
+		// PxTransform::transformInv
+		const Quatx4 cAqInv = conjugate(cAq);
+		const Quatx4 cB2cAq = mul(cAqInv, cBq);
+		const Vec3x4 cB2cAp = rotate(cAqInv, sub(cBp, cAp));
+
+		const Vec3x4 ra = sub(cBp, bAp);
+		const Vec3x4 rb = sub(cBp, bBp);
+
+		Vec3x4 axesA[3], axesB[3], jacobian[3];
+		quatToMatrix(cAq, axesA);
+		quatToMatrix(cBq, axesB);
+		computeJacobianAxes(cAq, cBq, jacobian);
+
+		for(PxU32 i = 0; i < 4; i++)
+		{
+			joint::JointFrames& f = frames[i];
+			f.cA2w = PxTransform(getLane(cAp, i), getLane(cAq, i));
+			f.cB2w = PxTransform(getLane(cBp, i), getLane(cBq, i));
+			f.cB2cA = PxTransform(getLane(cB2cAp, i), getLane(cB2cAq, i));
+			f.ra = getLane(ra, i);
+			f.rb = getLane(rb, i);
+			f.axesA = PxMat33(getLane(axesA[0], i), getLane(axesA[1], i), getLane(axesA[2], i));
+			f.axesB = PxMat33(getLane(axesB[0], i), getLane(axesB[1], i), getLane(axesB[2], i));
+			f.jacobian[0] = getLane(jacobian[0], i);
+			f.jacobian[1] = getLane(jacobian[1], i);
+			f.jacobian[2] = getLane(jacobian[2], i);
+		}
+	}
+
+	// Goes through the connector like the SDK so the derived limit data is up to date.
+	const JointData* getJointData(PxJoint& joint)
+	{
+		PxConstraintConnector* connector = NULL;
+		switch(joint.getType())
+		{
+		case PxJointType::eD6:			connector = static_cast<D6Joint&>(joint).getConnector();			break;
+		case PxJointType::eDISTANCE:	connector = static_cast<DistanceJoint&>(joint).getConnector();		break;
+		case PxJointType::eFIXED:		connector = static_cast<FixedJoint&>(joint).getConnector();			break;
+		case PxJointType::ePRISMATIC:	connector = static_cast<PrismaticJoint&>(joint).getConnector();		break;
+		case PxJointType::eREVOLUTE:	connector = static_cast<RevoluteJoint&>(joint).getConnector();		break;
+		case PxJointType::eSPHERICAL:	connector = static_cast<SphericalJoint&>(joint).getConnector();		break;
+		}
+		return reinterpret_cast<const JointData*>(connector->prepareData());
+	}
+}
+
+JointBatchSolverPrep::JointBatchSolverPrep(const PxTransform* body0ToWorld, const PxTransform* body1ToWorld, 
+										   Px1DConstraint* rows, PxU32 maxRows, 
+										   PxU32* firstRows, PxU32* nbRows, PxVec3* body0WorldOffsets)
+: mBody0ToWorld(body0ToWorld)
+, mBody1ToWorld(body1ToWorld)
+, mRows(rows)
+, mMaxRows(maxRows)
+, mNbRows(0)
+, mFirstRows(firstRows)
+, mNbJointRows(nbRows)
+, mBody0WorldOffsets(body0WorldOffsets)
+{
+	for(PxU32 i = 0; i <= PxJointType::eSPHERICAL; i++)
+		mBatches[i].size = 0;
+}
+
+Px1DConstraint* JointBatchSolverPrep::beginJoint(PxU32 index)
+{
+	if(mMaxRows - mNbRows >= PX_JOINT_MAX_SOLVER_ROWS)
+		return mRows + mNbRows;
+
+	mFirstRows[index] = 0xffffffff;
+	mNbJointRows[index] = 0;
+	mBody0WorldOffsets[index] = PxVec3(0);
+	return NULL;
+}
+
+void JointBatchSolverPrep::endJoint(PxU32 index, Px1DConstraint* first, PxU32 count, const PxVec3& body0WorldOffset)
+{
+	PX_ASSERT(count <= PX_JOINT_MAX_SOLVER_ROWS);
+	mFirstRows[index] = PxU32(first - mRows);
+	mNbJointRows[index] = count;
+	mBody0WorldOffsets[index] = body0WorldOffset;
+	mNbRows += count;
+}
+
+template<class Data, void (*prepareRows)(joint::ConstraintHelper&, const Data&, const joint::JointFrames&)>
+void JointBatchSolverPrep::prepare(Batch& batch, bool minimumDistance)
+{
+	// unused lanes repeat the last joint
+	const JointData* data[4];
+	const PxTransform* bA2w[4];
+	const PxTransform* bB2w[4];
+	for(PxU32 i = 0; i < 4; i++)
+	{
+		const PxU32 lane = PxMin(i, batch.size - 1);
+		data[i] = batch.data[lane];
+		bA2w[i] = mBody0ToWorld + batch.index[lane];
+		bB2w[i] = mBody1ToWorld + batch.index[lane];
+	}
+
+	joint::JointFrames frames[4];
+	computeJointFrames4(frames, data, bA2w, bB2w, minimumDistance);
+
+	for(PxU32 i = 0; i < batch.size; i++)
+	{
+		const PxU32 index = batch.index[i];
+		Px1DConstraint* rows = beginJoint(index);
+		if(!rows)
+			continue;
+
+		joint::ConstraintHelper ch(rows, frames[i].ra, frames[i].rb, true);
+		prepareRows(ch, *static_cast<const Data*>(batch.data[i]), frames[i]);
+		endJoint(index, rows, ch.getCount(), frames[i].ra);
+	}
+	batch.size = 0;
+}
+
+void JointBatchSolverPrep::add(PxU32 index, PxJointType::Enum type, const JointData& data)
+{
+	if(type == PxJointType::eDISTANCE)
+	{
+		// a single row that hardly needs the frames, prepared as the SDK would
+		Px1DConstraint* rows = beginJoint(index);
+		if(rows)
+		{
+			PxVec3 body0WorldOffset;
+			joint::initConstraintRow(rows[0]);
+			const PxU32 count = DistanceJointSolverPrep(rows, body0WorldOffset, mMaxRows - mNbRows, &data, mBody0ToWorld[index], mBody1ToWorld[index]);
+			endJoint(index, rows, count, body0WorldOffset);
+		}
+		return;
+	}
+
+	Batch& batch = mBatches[type];
+	batch.data[batch.size] = &data;
+	batch.index[batch.size] = index;
+	if(++batch.size < 4)
+		return;
+
+	switch(type)
+	{
+	case PxJointType::eD6:			prepare<D6JointData, D6JointPrepareRows>(batch, true);					break;
+	case PxJointType::eFIXED:		prepare<FixedJointData, FixedJointPrepareRows>(batch, false);			break;
+	case PxJointType::ePRISMATIC:	prepare<PrismaticJointData, PrismaticJointPrepareRows>(batch, false);	break;
+	case PxJointType::eREVOLUTE:	prepare<RevoluteJointData, RevoluteJointPrepareRows>(batch, true);		break;
+	case PxJointType::eSPHERICAL:	prepare<SphericalJointData, SphericalJointPrepareRows>(batch, true);	break;
+	case PxJointType::eDISTANCE:	break;
+	}
+}
+
+PxU32 JointBatchSolverPrep::flush()
+{
+	if(mBatches[PxJointType::eD6].size)
+		prepare<D6JointData, D6JointPrepareRows>(mBatches[PxJointType::eD6], true);
+	if(mBatches[PxJointType::eFIXED].size)
+		prepare<FixedJointData, FixedJointPrepareRows>(mBatches[PxJointType::eFIXED], false);
+	if(mBatches[PxJointType::ePRISMATIC].size)
+		prepare<PrismaticJointData, PrismaticJointPrepareRows>(mBatches[PxJointType::ePRISMATIC], false);
+	if(mBatches[PxJointType::eREVOLUTE].size)
+		prepare<RevoluteJointData, RevoluteJointPrepareRows>(mBatches[PxJointType::eREVOLUTE], true);
+	if(mBatches[PxJointType::eSPHERICAL].size)
+		prepare<SphericalJointData, SphericalJointPrepareRows>(mBatches[PxJointType::eSPHERICAL], true);
+	return mNbRows;
+}
+
+PxU32 physx::PxJointBatchSolverPrep(PxJoint* const* joints, const PxTransform* body0ToWorld, const PxTransform* body1ToWorld, PxU32 nbJoints,
+									Px1DConstraint* rows, PxU32 maxRows, PxU32* firstRows, PxU32* nbRows, PxVec3* body0WorldOffsets)
+{
+	PX_CHECK_AND_RETURN_NULL(!nbJoints || (joints && body0ToWorld && body1ToWorld && rows && firstRows && nbRows && body0WorldOffsets), "PxJointBatchSolverPrep: NULL argument");
+	PX_CHECK_AND_RETURN_NULL(!(size_t(rows) & 15), "PxJointBatchSolverPrep: rows must be 16 byte aligned");
+
+	JointBatchSolverPrep prep(body0ToWorld, body1ToWorld, rows, maxRows, firstRows, nbRows, body0WorldOffsets);
+	for(PxU32 i = 0; i < nbJoints; i++)
+		prep.add(i, joints[i]->getType(), *getJointData(*joints[i]));
+	return prep.flush();
+}
@@ -0,0 +1,98 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef EXT_JOINT_SOLVER_PREP_H
+#define EXT_JOINT_SOLVER_PREP_H
+
+#include "ExtConstraintHelper.h"
+
+namespace physx
+{
+namespace Ext
+{
+	struct D6JointData;
+	struct FixedJointData;
+	struct PrismaticJointData;
+	struct RevoluteJointData;
+	struct SphericalJointData;
+
+	// The row generation of the solver prep functions, shared by the single joint path the SDK 
+	// calls and the batch path of PxJointBatchSolverPrep().
+	void D6JointPrepareRows(joint::ConstraintHelper& ch, const D6JointData& data, const joint::JointFrames& frames);
+	void FixedJointPrepareRows(joint::ConstraintHelper& ch, const FixedJointData& data, const joint::JointFrames& frames);
+	void PrismaticJointPrepareRows(joint::ConstraintHelper& ch, const PrismaticJointData& data, const joint::JointFrames& frames);
+	void RevoluteJointPrepareRows(joint::ConstraintHelper& ch, const RevoluteJointData& data, const joint::JointFrames& frames);
+	void SphericalJointPrepareRows(joint::ConstraintHelper& ch, const SphericalJointData& data, const joint::JointFrames& frames);
+
+	// Prepares joints added in any order. Joints are queued per type and prepared four at a time, 
+	// index selects the body transforms and the per joint outputs. See PxJointBatchSolverPrep().
+	class JointBatchSolverPrep
+	{
+	public:
+		JointBatchSolverPrep(const PxTransform* body0ToWorld, const PxTransform* body1ToWorld, 
+							 Px1DConstraint* rows, PxU32 maxRows, 
+							 PxU32* firstRows, PxU32* nbRows, PxVec3* body0WorldOffsets);
+
+		void	add(PxU32 index, PxJointType::Enum type, const JointData& data);
+
+		// Prepares the joints still queued and returns the number of rows written.
+		PxU32	flush();
+
+	private:
+		struct Batch
+		{
+			const JointData*	data[4];
+			PxU32				index[4];
+			PxU32				size;
+		};
+
+		template<class Data, void (*prepareRows)(joint::ConstraintHelper&, const Data&, const joint::JointFrames&)>
+		void	prepare(Batch& batch, bool minimumDistance);
+
+		// Returns the rows for the joint or NULL if the buffer is full.
+		Px1DConstraint*	beginJoint(PxU32 index);
+		void			endJoint(PxU32 index, Px1DConstraint* first, PxU32 count, const PxVec3& body0WorldOffset);
+
+		const PxTransform*	mBody0ToWorld;
+		const PxTransform*	mBody1ToWorld;
+		Px1DConstraint*		mRows;
+		PxU32				mMaxRows;
+		PxU32				mNbRows;
+		PxU32*				mFirstRows;
+		PxU32*				mNbJointRows;
+		PxVec3*				mBody0WorldOffsets;
+		Batch				mBatches[PxJointType::eSPHERICAL + 1];
+	};
+
+} // namespace Ext
+
+}
+
+#endif
@@ -37,6 +37,10 @@
 #include "PxBounds3.h"
 #include "PsMathUtils.h"
 #include "PsIntrinsics.h"
+#include "PsThread.h"
+#include "PsSync.h"
+#include "PsAtomic.h"
+#include "PsString.h"
 
 using namespace physx;
 
@@ -68,144 +72,544 @@ struct CellCoords
 
 //----------------------------------------------------------------------------//
 
-struct Cell
+PxU32 PX_INLINE hashFunction(const CellCoords& coords)
+{
+	PxU32 mix = static_cast<PxU32>(coords.x) + 101 * static_cast<PxU32>(coords.y) + 7919 * static_cast<PxU32>(coords.z);
+	PxU32 hash = Ps::hash(mix);
+	return hash;
+}
+
+//----------------------------------------------------------------------------//
+
+class BoundsHashWorker;
+
+/**
+Keeps the scratch arrays of buildBoundsHash alive across calls and owns the helper threads.
+
+The build runs in phases. Gathering, hashing (cell coordinates and hashes) and the bounds/histogram
+reduction and scatter are split over threads, while hash table insertion stays serial so that
+the cell slots and the maxBounds cut-off match the original single threaded algorithm exactly.
+Hashing and insertion alternate in batches, so particles after the cut-off are never hashed.
+*/
+class InternalBoundsHashContext : public PxParticleExt::BoundsHashContext, public Ps::UserAllocated
 {
-	CellCoords coords;
-	PxBounds3 aabb;
-	PxU32 start;
-	PxU32 size;
+public:
+	InternalBoundsHashContext(PxU32 numWorkerThreads);
+	virtual ~InternalBoundsHashContext();
+
+	virtual	PxU32	getNbWorkerThreads() const	{ return mNumWorkers; }
+	virtual	void	release();
+
+	PxU32			build(PxU32* sortedParticleIndices,
+						  PxParticleExt::ParticleBounds* particleBounds,
+						  const PxStrideIterator<const PxVec3>& positionBuffer,
+						  const PxU32 validParticleRange,
+						  const PxU32* validParticleBitmap,
+						  const PxU32 hashSize,
+						  const PxU32 maxBounds,
+						  const PxReal gridSpacing);
+
+	void			runJob(PxU32 threadIndex);
+	void			finishJob();
+
+private:
+	enum Phase
+	{
+		ePHASE_GATHER,
+		ePHASE_HASH,
+		ePHASE_REDUCE,
+		ePHASE_SCATTER
+	};
+
+	void			runPhase(Phase phase);
+	void			gather(PxU32 threadIndex);
+	void			hash(PxU32 threadIndex);
+	void			reduce(PxU32 threadIndex);
+	void			scatter(PxU32 threadIndex);
+	PxU32			insertCells(const PxU32 hashSize, const PxU32 maxBounds);
+
+	PX_FORCE_INLINE PxU32 getNbThreads() const { return mNumWorkers + 1; }
+	PX_FORCE_INLINE PxU32 getChunkBegin(PxU32 threadIndex, PxU32 count) const { return PxU32((PxU64(count) * threadIndex) / getNbThreads()); }
+	PX_FORCE_INLINE PxU32 getChunkBegin(PxU32 threadIndex, PxU32 begin, PxU32 end) const { return begin + getChunkBegin(threadIndex, end - begin); }
+
+	// worker threads
+	BoundsHashWorker*				mWorkers;
+	PxU32							mNumWorkers;
+	Phase							mPhase;
+	volatile PxI32					mPendingWorkers;
+	Ps::Sync						mJobDone;
+
+	// per call parameters
+	const PxStrideIterator<const PxVec3>*	mPositionBuffer;
+	const PxU32*					mValidParticleBitmap;
+	PxU32*							mSortedParticleIndices;
+	PxReal							mCellSizeInv;
+	PxU32							mNumWords;
+	PxU32							mNumParticles;
+	PxU32							mNumBinnedParticles;	// compact particles before the maxBounds cut-off
+	PxU32							mNumCells;
+	PxU32							mBatchBegin;			// compact particles hashed and inserted in the current batch
+	PxU32							mBatchEnd;
+
+	// per thread bitmap word ranges and their first compact particle slot
+	Ps::Array<PxU32>				mWordChunkOffsets;
+
+	// compact per particle streams, indexed in bitmap order
+	Ps::Array<PxU32>				mParticleIndices;
+	Ps::Array<PxReal>				mPositions;			// SoA: x[mNumParticles], y[mNumParticles], z[mNumParticles]
+	Ps::Array<CellCoords>			mParticleCoords;
+	Ps::Array<PxU32>				mParticleHashes;
+	Ps::Array<PxU32>				mParticleCells;		// dense cell index of the binned particles
+
+	// hash table slots holding dense cell indices, and per cell data
+	Ps::Array<PxU32>				mCellTable;
+	Ps::Array<CellCoords>			mCellCoords;
+
+	// per thread histograms (turned into scatter offsets in place) and SoA bounds
+	Ps::Array<PxU32>				mCellCounts;		// [thread][cell]
+	Ps::Array<PxReal>				mCellBounds;		// [thread][minX, minY, minZ, maxX, maxY, maxZ][cell]
 };
 
 //----------------------------------------------------------------------------//
 
-PxU32 PX_INLINE hashFunction(const CellCoords& coords)
+class BoundsHashWorker : public Ps::Thread
 {
-	PxU32 mix = static_cast<PxU32>(coords.x) + 101 * static_cast<PxU32>(coords.y) + 7919 * static_cast<PxU32>(coords.z);
-	PxU32 hash = Ps::hash(mix);
-	return hash;
+public:
+	BoundsHashWorker() : mOwner(NULL), mThreadIndex(0) {}
+
+	void			initialize(InternalBoundsHashContext* owner, PxU32 threadIndex)
+	{
+		mOwner = owner;
+		mThreadIndex = threadIndex;
+	}
+
+	void			kick()	{ mWorkReady.set(); }
+
+	virtual void	execute()
+	{
+		for (;;)
+		{
+			mWorkReady.wait();
+			mWorkReady.reset();
+			if (quitIsSignalled())
+				break;
+
+			mOwner->runJob(mThreadIndex);
+			mOwner->finishJob();
+		}
+		quit();
+	}
+
+private:
+	InternalBoundsHashContext*	mOwner;
+	PxU32						mThreadIndex;
+	Ps::Sync					mWorkReady;
+};
+
+//----------------------------------------------------------------------------//
+
+InternalBoundsHashContext::InternalBoundsHashContext(PxU32 numWorkerThreads) :
+	mWorkers(NULL),
+	mNumWorkers(0),
+	mPhase(ePHASE_GATHER),
+	mPendingWorkers(0),
+	mPositionBuffer(NULL),
+	mValidParticleBitmap(NULL),
+	mSortedParticleIndices(NULL),
+	mCellSizeInv(0.0f),
+	mNumWords(0),
+	mNumParticles(0),
+	mNumBinnedParticles(0),
+	mNumCells(0),
+	mBatchBegin(0),
+	mBatchEnd(0),
+	mWordChunkOffsets(PX_DEBUG_EXP("buildBoundsHashWordChunks")),
+	mParticleIndices(PX_DEBUG_EXP("buildBoundsHashParticleIndices")),
+	mPositions(PX_DEBUG_EXP("buildBoundsHashPositions")),
+	mParticleCoords(PX_DEBUG_EXP("buildBoundsHashParticleCoords")),
+	mParticleHashes(PX_DEBUG_EXP("buildBoundsHashParticleHashes")),
+	mParticleCells(PX_DEBUG_EXP("buildBoundsHashCellMap")),
+	mCellTable(PX_DEBUG_EXP("buildBoundsCells")),
+	mCellCoords(PX_DEBUG_EXP("buildBoundsCellCoords")),
+	mCellCounts(PX_DEBUG_EXP("buildBoundsCellCounts")),
+	mCellBounds(PX_DEBUG_EXP("buildBoundsCellBounds"))
+{
+	if (numWorkerThreads == 0)
+		return;
+
+	mWorkers = reinterpret_cast<BoundsHashWorker*>(PX_ALLOC(numWorkerThreads * sizeof(BoundsHashWorker), PX_DEBUG_EXP("BoundsHashWorker")));
+	if (!mWorkers)
+		return;
+
+	mNumWorkers = numWorkerThreads;
+	for (PxU32 i = 0; i < mNumWorkers; ++i)
+	{
+		PX_PLACEMENT_NEW(mWorkers + i, BoundsHashWorker)();
+		mWorkers[i].initialize(this, i + 1);
+	}
+
+	for (PxU32 i = 0; i < mNumWorkers; ++i)
+	{
+		mWorkers[i].start(Ps::Thread::getDefaultStackSize());
+
+		char threadName[32];
+		string::sprintf_s(threadName, 32, "PxBoundsHash%02d", i);
+		mWorkers[i].setName(threadName);
+	}
+}
+
+InternalBoundsHashContext::~InternalBoundsHashContext()
+{
+	for (PxU32 i = 0; i < mNumWorkers; ++i)
+	{
+		mWorkers[i].signalQuit();
+		mWorkers[i].kick();
+	}
+
+	for (PxU32 i = 0; i < mNumWorkers; ++i)
+		mWorkers[i].waitForQuit();
+
+	for (PxU32 i = 0; i < mNumWorkers; ++i)
+		mWorkers[i].~BoundsHashWorker();
+
+	if (mWorkers)
+		PX_FREE(mWorkers);
+}
+
+void InternalBoundsHashContext::release()
+{
+	PX_DELETE(this);
 }
 
 //----------------------------------------------------------------------------//
 
-PxU32 PX_INLINE getEntry(const CellCoords& coords, const PxU32 hashSize, const Cell* cells)
+void InternalBoundsHashContext::runPhase(Phase phase)
 {
-	PxU32 hash = hashFunction(coords);
-	PxU32 index = hash & (hashSize - 1);
-	for (;;)
+	mPhase = phase;
+
+	if (mNumWorkers > 0)
 	{
-		const Cell& cell = cells[index];
-		if (cell.size == sInvalidIndex || cell.coords == coords)
-			break;
-		index = (index + 1) & (hashSize - 1);
+		mJobDone.reset();
+		mPendingWorkers = PxI32(mNumWorkers);
+		for (PxU32 i = 0; i < mNumWorkers; ++i)
+			mWorkers[i].kick();
+	}
+
+	// the calling thread always processes the first chunk
+	runJob(0);
+
+	if (mNumWorkers > 0)
+		mJobDone.wait();
+}
+
+void InternalBoundsHashContext::runJob(PxU32 threadIndex)
+{
+	switch (mPhase)
+	{
+	case ePHASE_GATHER:		gather(threadIndex);	break;
+	case ePHASE_HASH:		hash(threadIndex);		break;
+	case ePHASE_REDUCE:		reduce(threadIndex);	break;
+	case ePHASE_SCATTER:	scatter(threadIndex);	break;
 	}
-	return index;
+}
+
+void InternalBoundsHashContext::finishJob()
+{
+	if (Ps::atomicDecrement(&mPendingWorkers) == 0)
+		mJobDone.set();
 }
 
 //----------------------------------------------------------------------------//
 
-PxU32 PxParticleExt::buildBoundsHash(PxU32* sortedParticleIndices,
-									 ParticleBounds* particleBounds,
-									 const PxStrideIterator<const PxVec3>& positionBuffer,
-									 const PxU32 validParticleRange,
-									 const PxU32* validParticleBitmap,
-									 const PxU32 hashSize,
-									 const PxU32 maxBounds,
-									 const PxReal gridSpacing)
+// Decodes a range of bitmap words into the compact particle streams.
+void InternalBoundsHashContext::gather(PxU32 threadIndex)
+{
+	const PxStrideIterator<const PxVec3>& positionBuffer = *mPositionBuffer;
+	const PxU32 wordEnd = getChunkBegin(threadIndex + 1, mNumWords);
+
+	PxU32* PX_RESTRICT particleIndices = mParticleIndices.begin();
+	PxReal* PX_RESTRICT posX = mPositions.begin();
+	PxReal* PX_RESTRICT posY = posX + mNumParticles;
+	PxReal* PX_RESTRICT posZ = posY + mNumParticles;
+
+	PxU32 slot = mWordChunkOffsets[threadIndex];
+	for (PxU32 w = getChunkBegin(threadIndex, mNumWords); w < wordEnd; w++)
+		for (PxU32 b = mValidParticleBitmap[w]; b; b &= b-1)
+		{
+			PxU32 index = (w<<5|Ps::lowestSetBit(b));
+			const PxVec3& position = positionBuffer[index];
+
+			particleIndices[slot] = index;
+			posX[slot] = position.x;
+			posY[slot] = position.y;
+			posZ[slot] = position.z;
+			++slot;
+		}
+
+	PX_ASSERT(slot == mWordChunkOffsets[threadIndex + 1]);
+}
+
+// Cell coordinates and hashes of a range of the current batch.
+void InternalBoundsHashContext::hash(PxU32 threadIndex)
+{
+	CellCoords* PX_RESTRICT particleCoords = mParticleCoords.begin();
+	PxU32* PX_RESTRICT particleHashes = mParticleHashes.begin();
+	const PxReal* PX_RESTRICT posX = mPositions.begin();
+	const PxReal* PX_RESTRICT posY = posX + mNumParticles;
+	const PxReal* PX_RESTRICT posZ = posY + mNumParticles;
+
+	const PxU32 end = getChunkBegin(threadIndex + 1, mBatchBegin, mBatchEnd);
+	for (PxU32 p = getChunkBegin(threadIndex, mBatchBegin, mBatchEnd); p < end; p++)
+	{
+		CellCoords& coords = particleCoords[p];
+		coords.set(PxVec3(posX[p], posY[p], posZ[p]), mCellSizeInv);
+		particleHashes[p] = hashFunction(coords);
+	}
+}
+
+// Serial linear probing of the current batch in particle order, identical to the original single threaded insertion.
+// Returns the end of the inserted particles, which is before the end of the batch if maxBounds was reached.
+PxU32 InternalBoundsHashContext::insertCells(const PxU32 hashSize, const PxU32 maxBounds)
+{
+	const CellCoords* PX_RESTRICT particleCoords = mParticleCoords.begin();
+	const PxU32* PX_RESTRICT particleHashes = mParticleHashes.begin();
+	PxU32* PX_RESTRICT particleCells = mParticleCells.begin();
+	PxU32* PX_RESTRICT cellTable = mCellTable.begin();
+
+	PxU32 numCells = mNumCells;
+	PxU32 p = mBatchBegin;
+	for (; p < mBatchEnd && numCells < maxBounds; p++)
+	{
+		const CellCoords& coords = particleCoords[p];
+		PxU32 index = particleHashes[p] & (hashSize - 1);
+		for (;;)
+		{
+			const PxU32 cell = cellTable[index];
+			if (cell == sInvalidIndex)
+			{
+				// this is the first particle in this cell
+				cellTable[index] = numCells;
+				mCellCoords.pushBack(coords);
+				particleCells[p] = numCells++;
+				break;
+			}
+			if (mCellCoords[cell] == coords)
+			{
+				particleCells[p] = cell;
+				break;
+			}
+			index = (index + 1) & (hashSize - 1);
+		}
+	}
+
+	mNumCells = numCells;
+	return p;
+}
+
+// Per thread cell histogram and SoA bounds over a contiguous range of compact particles.
+void InternalBoundsHashContext::reduce(PxU32 threadIndex)
+{
+	const PxU32 numCells = mNumCells;
+	PxU32* PX_RESTRICT counts = mCellCounts.begin() + threadIndex * numCells;
+	PxReal* PX_RESTRICT minX = mCellBounds.begin() + threadIndex * numCells * 6;
+	PxReal* PX_RESTRICT minY = minX + numCells;
+	PxReal* PX_RESTRICT minZ = minY + numCells;
+	PxReal* PX_RESTRICT maxX = minZ + numCells;
+	PxReal* PX_RESTRICT maxY = maxX + numCells;
+	PxReal* PX_RESTRICT maxZ = maxY + numCells;
+
+	for (PxU32 c = 0; c < numCells; c++)
+	{
+		counts[c] = 0;
+		minX[c] = minY[c] = minZ[c] = PX_MAX_REAL;
+		maxX[c] = maxY[c] = maxZ[c] = -PX_MAX_REAL;
+	}
+
+	const PxU32* PX_RESTRICT particleCells = mParticleCells.begin();
+	const PxReal* PX_RESTRICT posX = mPositions.begin();
+	const PxReal* PX_RESTRICT posY = posX + mNumParticles;
+	const PxReal* PX_RESTRICT posZ = posY + mNumParticles;
+
+	const PxU32 end = getChunkBegin(threadIndex + 1, mNumBinnedParticles);
+	for (PxU32 p = getChunkBegin(threadIndex, mNumBinnedParticles); p < end; p++)
+	{
+		const PxU32 c = particleCells[p];
+		++counts[c];
+		minX[c] = PxMin(minX[c], posX[p]);
+		minY[c] = PxMin(minY[c], posY[p]);
+		minZ[c] = PxMin(minZ[c], posZ[p]);
+		maxX[c] = PxMax(maxX[c], posX[p]);
+		maxY[c] = PxMax(maxY[c], posY[p]);
+		maxZ[c] = PxMax(maxZ[c], posZ[p]);
+	}
+}
+
+// Writes particle indices to the per thread offsets computed from the histograms.
+void InternalBoundsHashContext::scatter(PxU32 threadIndex)
+{
+	PxU32* PX_RESTRICT offsets = mCellCounts.begin() + threadIndex * mNumCells;
+	const PxU32* PX_RESTRICT particleCells = mParticleCells.begin();
+	const PxU32* PX_RESTRICT particleIndices = mParticleIndices.begin();
+	PxU32* PX_RESTRICT sortedParticleIndices = mSortedParticleIndices;
+
+	const PxU32 end = getChunkBegin(threadIndex + 1, mNumBinnedParticles);
+	for (PxU32 p = getChunkBegin(threadIndex, mNumBinnedParticles); p < end; p++)
+		sortedParticleIndices[offsets[particleCells[p]]++] = particleIndices[p];
+}
+
+//----------------------------------------------------------------------------//
+
+PxU32 InternalBoundsHashContext::build(PxU32* sortedParticleIndices,
+									   PxParticleExt::ParticleBounds* particleBounds,
+									   const PxStrideIterator<const PxVec3>& positionBuffer,
+									   const PxU32 validParticleRange,
+									   const PxU32* validParticleBitmap,
+									   const PxU32 hashSize,
+									   const PxU32 maxBounds,
+									   const PxReal gridSpacing)
 {
 	// test if hash size is a multiple of 2
 	PX_ASSERT((((hashSize - 1) ^ hashSize) + 1) == (2 * hashSize));
 	PX_ASSERT(maxBounds <= hashSize);
 
-	PxReal cellSizeInv = 1.0f / gridSpacing;
+	if (validParticleRange == 0)
+		return 0;
 
-	Ps::Array<PxU32> particleToCellMap PX_DEBUG_EXP("buildBoundsHashCellMap"); 	
-	particleToCellMap.resize(validParticleRange);
+	const PxU32 numThreads = getNbThreads();
 
-	// initialize cells
-	Ps::Array<Cell> cells PX_DEBUG_EXP("buildBoundsCells");
-	cells.resize(hashSize);
-	Ps::memSet(cells.begin(), sInvalidIndex, sizeof(Cell) * hashSize);
+	mPositionBuffer = &positionBuffer;
+	mValidParticleBitmap = validParticleBitmap;
+	mSortedParticleIndices = sortedParticleIndices;
+	mCellSizeInv = 1.0f / gridSpacing;
+	mNumWords = ((validParticleRange-1) >> 5) + 1;
+
+	// count valid particles per thread word range to find each thread's first compact slot
+	mWordChunkOffsets.resizeUninitialized(numThreads + 1);
+	mWordChunkOffsets[0] = 0;
+	for (PxU32 t = 0; t < numThreads; t++)
+	{
+		PxU32 count = mWordChunkOffsets[t];
+		const PxU32 wordEnd = getChunkBegin(t + 1, mNumWords);
+		for (PxU32 w = getChunkBegin(t, mNumWords); w < wordEnd; w++)
+			count += Ps::bitCount(validParticleBitmap[w]);
+		mWordChunkOffsets[t + 1] = count;
+	}
+	mNumParticles = mWordChunkOffsets[numThreads];
 
-	// count number of particles per cell
-	PxU32 entryCounter = 0;
+	mParticleIndices.resizeUninitialized(mNumParticles);
+	mPositions.resizeUninitialized(mNumParticles * 3);
+	mParticleCoords.resizeUninitialized(mNumParticles);
+	mParticleHashes.resizeUninitialized(mNumParticles);
+	mParticleCells.resizeUninitialized(mNumParticles);
 
-	if (validParticleRange > 0)
+	runPhase(ePHASE_GATHER);
+
+	// initialize cells
+	mCellTable.resizeUninitialized(hashSize);
+	Ps::memSet(mCellTable.begin(), sInvalidIndex, sizeof(PxU32) * hashSize);
+	mCellCoords.clear();
+	mCellCoords.reserve(maxBounds);
+	mNumCells = 0;
+
+	// particles after reaching maxBounds are skipped, even if their cell exists: the first batch is
+	// sized to usually reach a small maxBounds, the second one takes the remaining particles
+	mBatchBegin = 0;
+	mBatchEnd = PxMin(mNumParticles, PxMax(4 * maxBounds, PxU32(4096)));
+	for (;;)
 	{
-		for (PxU32 w = 0; w <= (validParticleRange-1) >> 5; w++)
-			for (PxU32 b = validParticleBitmap[w]; b; b &= b-1)
-			{
-				PxU32 index = (w<<5|Ps::lowestSetBit(b));
-				const PxVec3& position = positionBuffer[index];
-
-				PxU32& cellIndex = particleToCellMap[index];
-				cellIndex = sInvalidIndex;	// initialize to invalid in case we reach maxBounds	
-				if (entryCounter < maxBounds)
-				{
-					CellCoords particleCoords;
-					particleCoords.set(position, cellSizeInv);
-					cellIndex = getEntry(particleCoords, hashSize, cells.begin());
-					PX_ASSERT(cellIndex != sInvalidIndex);
-
-					Cell& cell = cells[cellIndex];
-					if (cell.size == sInvalidIndex)
-					{
-						// this is the first particle in this cell
-						cell.coords = particleCoords;
-						cell.aabb = PxBounds3(position, position);
-						cell.size = 1;
-						++entryCounter;
-					}
-					else
-					{
-						// the cell is already occupied
-						cell.aabb.include(position);
-						++cell.size;
-					}
-				}
-			}
+		runPhase(ePHASE_HASH);
+		mNumBinnedParticles = insertCells(hashSize, maxBounds);
+		if (mNumCells == maxBounds || mBatchEnd == mNumParticles)
+			break;
+		mBatchBegin = mBatchEnd;
+		mBatchEnd = mNumParticles;
 	}
+	if (mNumCells == 0)
+		return 0;
+
+	mCellCounts.resizeUninitialized(numThreads * mNumCells);
+	mCellBounds.resizeUninitialized(numThreads * mNumCells * 6);
 
+	runPhase(ePHASE_REDUCE);
 
-	// accumulate start indices from cell size histogram and write to the user's particleBounds buffer
+	// merge per thread bounds and turn the histograms into scatter offsets, in hash table order
+	const PxU32 numCells = mNumCells;
+	const PxU32 boundsStride = numCells * 6;
 	PxU32 numBounds = 0;
-	for (PxU32 i = 0, counter = 0; i < cells.size(); i++)
+	for (PxU32 i = 0, counter = 0; i < hashSize; i++)
 	{
-		Cell& cell = cells[i];
-		if (cell.size != sInvalidIndex)
+		const PxU32 c = mCellTable[i];
+		if (c == sInvalidIndex)
+			continue;
+
+		PxVec3 minimum(PX_MAX_REAL), maximum(-PX_MAX_REAL);
+		const PxU32 start = counter;
+		for (PxU32 t = 0; t < numThreads; t++)
 		{
-			cell.start = counter;
-			counter += cell.size;
-			
-			PxParticleExt::ParticleBounds& cellBounds = particleBounds[numBounds++];
-			cellBounds.bounds = cell.aabb;
-			cellBounds.firstParticle = cell.start;
-			cellBounds.numParticles = cell.size;
-			
-			cell.size = 0;
+			const PxReal* bounds = mCellBounds.begin() + t * boundsStride + c;
+			minimum.x = PxMin(minimum.x, bounds[0 * numCells]);
+			minimum.y = PxMin(minimum.y, bounds[1 * numCells]);
+			minimum.z = PxMin(minimum.z, bounds[2 * numCells]);
+			maximum.x = PxMax(maximum.x, bounds[3 * numCells]);
+			maximum.y = PxMax(maximum.y, bounds[4 * numCells]);
+			maximum.z = PxMax(maximum.z, bounds[5 * numCells]);
+
+			PxU32& count = mCellCounts[t * numCells + c];
+			const PxU32 threadCount = count;
+			count = counter;
+			counter += threadCount;
 		}
+
+		PxParticleExt::ParticleBounds& cellBounds = particleBounds[numBounds++];
+		cellBounds.bounds = PxBounds3(minimum, maximum);
+		cellBounds.firstParticle = start;
+		cellBounds.numParticles = counter - start;
 	}
+	PX_ASSERT(numBounds == numCells);
 
 	// sort output particle indices by cell
-	if (validParticleRange > 0)
-	{
-		for (PxU32 w = 0; w <= (validParticleRange-1) >> 5; w++)
-			for (PxU32 b = validParticleBitmap[w]; b; b &= b-1)
-			{
-				PxU32 index = (w<<5|Ps::lowestSetBit(b));
-				PxU32 cellIndex = particleToCellMap[index];
-				if (cellIndex != sInvalidIndex)
-				{
-					Cell& cell = cells[cellIndex];
-					PX_ASSERT(cell.start != sInvalidIndex && cell.size != sInvalidIndex);
-					sortedParticleIndices[cell.start + cell.size] = index;
-					++cell.size;
-				}
-			}
-	}
-	
+	runPhase(ePHASE_SCATTER);
+
 	return numBounds;
 }
 
+//----------------------------------------------------------------------------//
+
+PxU32 PxParticleExt::buildBoundsHash(PxU32* sortedParticleIndices,
+									 ParticleBounds* particleBounds,
+									 const PxStrideIterator<const PxVec3>& positionBuffer,
+									 const PxU32 validParticleRange,
+									 const PxU32* validParticleBitmap,
+									 const PxU32 hashSize,
+									 const PxU32 maxBounds,
+									 const PxReal gridSpacing)
+{
+	InternalBoundsHashContext context(0);
+	return context.build(sortedParticleIndices, particleBounds, positionBuffer, validParticleRange, validParticleBitmap, hashSize, maxBounds, gridSpacing);
+}
+
+//----------------------------------------------------------------------------//
+
+PxU32 PxParticleExt::buildBoundsHash(BoundsHashContext& context,
+									 PxU32* sortedParticleIndices,
+									 ParticleBounds* particleBounds,
+									 const PxStrideIterator<const PxVec3>& positionBuffer,
+									 const PxU32 validParticleRange,
+									 const PxU32* validParticleBitmap,
+									 const PxU32 hashSize,
+									 const PxU32 maxBounds,
+									 const PxReal gridSpacing)
+{
+	return static_cast<InternalBoundsHashContext&>(context).build(sortedParticleIndices, particleBounds, positionBuffer, validParticleRange, validParticleBitmap, hashSize, maxBounds, gridSpacing);
+}
+
+//----------------------------------------------------------------------------//
+
+PxParticleExt::BoundsHashContext* PxParticleExt::createBoundsHashContext(PxU32 numWorkerThreads)
+{
+	return PX_NEW(InternalBoundsHashContext)(numWorkerThreads);
+}
+
 //----------------------------------------------------------------------------//
 	
 class InternalIndexPool : public PxParticleExt::IndexPool, public Ps::UserAllocated
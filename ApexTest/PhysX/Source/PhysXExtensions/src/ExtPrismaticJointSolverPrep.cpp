@@ -29,42 +29,46 @@
 
 
 #include "ExtPrismaticJoint.h"
-#include "ExtConstraintHelper.h"
+#include "ExtJointSolverPrep.h"
 #include "CmRenderOutput.h"
 
 namespace physx
 {
 namespace Ext
 {
-	PxU32 PrismaticJointSolverPrep(Px1DConstraint* constraints,
-		PxVec3& body0WorldOffset,
-		PxU32 maxConstraints,
-		const void* constantBlock,
-		const PxTransform& bA2w,
-		const PxTransform& bB2w)
+	void PrismaticJointPrepareRows(joint::ConstraintHelper& ch, const PrismaticJointData& data, const joint::JointFrames& frames)
 	{
-		const PrismaticJointData& data = *reinterpret_cast<const PrismaticJointData*>(constantBlock);
-
-		PxTransform cA2w = bA2w.transform(data.c2b[0]);
-		PxTransform cB2w = bB2w.transform(data.c2b[1]);
-
 		bool limitEnabled = data.jointFlags & PxPrismaticJointFlag::eLIMIT_ENABLED;
 		const PxJointLimitPair &limit = data.limit;
 		bool limitIsLocked = limitEnabled && limit.lower >= limit.upper;
 
-		PxVec3 bOriginInA = cA2w.transformInv(cB2w.p);
+		const PxVec3& bOriginInA = frames.cB2cA.p;
 
-		body0WorldOffset = cB2w.p-bA2w.p;
-		joint::ConstraintHelper ch(constraints,cB2w.p-bA2w.p, cB2w.p-bB2w.p);
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, bOriginInA, limitIsLocked ? 7 : 6, 7);
+		ch.prepareLockedAxes(frames, limitIsLocked ? 7 : 6, 7);
 
 		if(limitEnabled && !limitIsLocked)
 		{
-			PxVec3 axis = cA2w.rotate(PxVec3(1,0,0));
+			PxVec3 axis = frames.cA2w.rotate(PxVec3(1,0,0));
 			PxReal ordinate = axis.dot(bOriginInA);
 			ch.linearLimitPair(ordinate, limit.lower, limit.upper, limit.contactDistance, axis, limit);
 		}
+	}
+
+	PxU32 PrismaticJointSolverPrep(Px1DConstraint* constraints,
+		PxVec3& body0WorldOffset,
+		PxU32 maxConstraints,
+		const void* constantBlock,
+		const PxTransform& bA2w,
+		const PxTransform& bB2w)
+	{
+		const PrismaticJointData& data = *reinterpret_cast<const PrismaticJointData*>(constantBlock);
+
+		joint::JointFrames frames;
+		joint::computeJointFrames(frames, data, bA2w, bB2w, false);
 
+		body0WorldOffset = frames.ra;
+		joint::ConstraintHelper ch(constraints, frames.ra, frames.rb);
+		PrismaticJointPrepareRows(ch, data, frames);
 		return ch.getCount();
 	}
 }//namespace
@@ -0,0 +1,224 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+  
+
+#include "PxProfileZoneAggregator.h"
+#include "ExtProfileZoneAggregator.h"
+#include "PxProfileZone.h"
+#include "PxIO.h"
+#include "PsFoundation.h"
+#include "PsTime.h"
+#include "PsFile.h"
+#include <string.h>
+
+using namespace physx;
+using namespace Ext;
+
+void ProfileZoneAggregatorClient::handleBufferFlush(const PxU8* data, PxU32 length)
+{
+	mAggregator.addEvents(mZoneIndex, data, length);
+}
+
+void ProfileZoneAggregatorClient::handleEventAdded(const PxProfileEventName& name)
+{
+	mAggregator.addEventName(mZoneIndex, name.mEventId.mEventId, name.mName);
+}
+
+ProfileZoneAggregator::ProfileZoneAggregator(PxProfileZoneManager& manager, bool recordStream)
+: mManager(manager)
+, mRecordStream(recordStream)
+, mStatistics(Ps::getAllocator())
+, mEventStatsValid(false)
+{
+	const Ps::CounterFrequencyToTensOfNanos frequency = Ps::Time::getCounterFrequency();
+	mStatistics.setTimestampFrequency(frequency.mNumerator, frequency.mDenominator);
+}
+
+ProfileZoneAggregator::~ProfileZoneAggregator()
+{
+	PX_ASSERT(mClients.empty());
+}
+
+void ProfileZoneAggregator::record(PxProfileZoneStreamRecord::Enum type, const PxU32* words, PxU32 nbWords, const void* data, PxU32 length)
+{
+	if(!mRecordStream)
+		return;
+	const PxU32 header[2] = { PxU32(type), nbWords * sizeof(PxU32) + length };
+	const PxU32 offset = mStream.size();
+	mStream.resizeUninitialized(offset + sizeof(header) + header[1]);
+	PxU8* dst = mStream.begin() + offset;
+	memcpy(dst, header, sizeof(header));
+	memcpy(dst + sizeof(header), words, nbWords * sizeof(PxU32));
+	memcpy(dst + sizeof(header) + nbWords * sizeof(PxU32), data, length);
+}
+
+void ProfileZoneAggregator::addEvents(PxU32 zoneIndex, const PxU8* data, PxU32 length)
+{
+	if(!length)
+		return;
+	Ps::Mutex::ScopedLock lock(mMutex);
+	mStatistics.addEvents(zoneIndex, data, length);
+	record(PxProfileZoneStreamRecord::eEVENTS, &zoneIndex, 1, data, length);
+	mEventStatsValid = false;
+}
+
+void ProfileZoneAggregator::addEventName(PxU32 zoneIndex, PxU16 eventId, const char* name)
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	mStatistics.addEventName(zoneIndex, eventId, name);
+	const PxU32 words[2] = { zoneIndex, eventId };
+	record(PxProfileZoneStreamRecord::eEVENT_NAME, words, 2, name, PxU32(strlen(name)) + 1);
+	mEventStatsValid = false;
+}
+
+void ProfileZoneAggregator::endFrame()
+{
+	// not under the lock, the zones call back into addEvents()
+	mManager.flushProfileEvents();
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+	mStatistics.endFrame();
+	record(PxProfileZoneStreamRecord::eEND_FRAME, NULL, 0, NULL, 0);
+	mEventStatsValid = false;
+}
+
+PxU32 ProfileZoneAggregator::getNbFrames() const
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	return mStatistics.getNbFrames();
+}
+
+PxU32 ProfileZoneAggregator::getNbEventStats() const
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	return mStatistics.getNbEventStats();
+}
+
+bool ProfileZoneAggregator::getEventStats(PxU32 index, PxProfileZoneEventStats& stats) const
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	if(index >= mStatistics.getNbEventStats())
+		return false;
+	if(!mEventStatsValid)
+	{
+		mEventStats.resize(mStatistics.getNbEventStats());
+		mStatistics.computeEventStats(mEventStats.begin());
+		mEventStatsValid = true;
+	}
+	stats = mEventStats[index];
+	return true;
+}
+
+bool ProfileZoneAggregator::writeReport(PxOutputStream& stream, PxProfileZoneReportFormat::Enum format) const
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	mEventStatsValid = false;	// the names may move
+	return mStatistics.writeReport(stream, format);
+}
+
+bool ProfileZoneAggregator::saveStream(const char* filename) const
+{
+	if(!mRecordStream)
+		return false;
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+
+	FILE* fp = NULL;
+	Ps::fopen_s(&fp, filename, "wb");
+	if(!fp)
+		return false;
+
+	const Ps::CounterFrequencyToTensOfNanos frequency = Ps::Time::getCounterFrequency();
+	PxProfileZoneStreamFileHeader header;
+	header.magic				= PxProfileZoneStreamFileHeader::eMAGIC;
+	header.version				= PxProfileZoneStreamFileHeader::eVERSION;
+	header.timestampNumerator	= frequency.mNumerator;
+	header.timestampDenominator	= frequency.mDenominator;
+
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+	if(ok && mStream.size())
+		ok = fwrite(mStream.begin(), mStream.size(), 1, fp) == 1;
+	ok = (fclose(fp) == 0) && ok;
+	return ok;
+}
+
+void ProfileZoneAggregator::release()
+{
+	// detaches from all zones through onZoneRemoved()
+	mManager.removeProfileZoneHandler(*this);
+	PX_DELETE(this);
+}
+
+void ProfileZoneAggregator::onZoneAdded(PxProfileZone& zone)
+{
+	// the names are fetched before taking our lock, zones call into us with their own lock held
+	const PxProfileNames names = zone.getProfileNames();
+
+	ProfileZoneAggregatorClient* client;
+	{
+		Ps::Mutex::ScopedLock lock(mMutex);
+		const char* zoneName = zone.getName();
+		const PxU32 zoneIndex = mStatistics.addZone(zoneName);
+		record(PxProfileZoneStreamRecord::eZONE, &zoneIndex, 1, zoneName, PxU32(strlen(zoneName)) + 1);
+		client = PX_NEW(ProfileZoneAggregatorClient)(*this, zone, zoneIndex);
+		mClients.pushBack(client);
+	}
+	for(PxU32 i = 0; i < names.mEventCount; i++)
+		addEventName(client->getZoneIndex(), names.mEvents[i].mEventId.mEventId, names.mEvents[i].mName);
+	zone.addClient(*client);
+}
+
+void ProfileZoneAggregator::onZoneRemoved(PxProfileZone& zone)
+{
+	ProfileZoneAggregatorClient* client = NULL;
+	{
+		Ps::Mutex::ScopedLock lock(mMutex);
+		for(PxU32 i = 0; i < mClients.size(); i++)
+		{
+			if(&mClients[i]->getZone() == &zone)
+			{
+				client = mClients[i];
+				mClients.replaceWithLast(i);
+				break;
+			}
+		}
+	}
+	if(client)
+	{
+		zone.removeClient(*client);
+		PX_DELETE(client);
+	}
+}
+
+PxProfileZoneAggregator* physx::PxProfileZoneAggregatorCreate(PxProfileZoneManager& manager, bool recordStream)
+{
+	ProfileZoneAggregator* aggregator = PX_NEW(ProfileZoneAggregator)(manager, recordStream);
+	manager.addProfileZoneHandler(*aggregator);
+	return aggregator;
+}
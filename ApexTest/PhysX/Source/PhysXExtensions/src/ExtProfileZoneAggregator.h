@@ -0,0 +1,117 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef EXT_PROFILE_ZONE_AGGREGATOR_H
+#define EXT_PROFILE_ZONE_AGGREGATOR_H
+
+#include "PxProfileZoneAggregator.h"
+#include "PxProfileZoneManager.h"
+#include "PxProfileEventBufferClient.h"
+#include "ExtProfileZoneStatistics.h"
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PsArray.h"
+#include "PsMutex.h"
+
+namespace physx
+{
+namespace Ext
+{
+	class ProfileZoneAggregator;
+
+	// One client per zone, so flushed events can be attributed to their zone.
+	class ProfileZoneAggregatorClient : public PxProfileZoneClient, public Ps::UserAllocated
+	{
+	public:
+		ProfileZoneAggregatorClient(ProfileZoneAggregator& aggregator, PxProfileZone& zone, PxU32 zoneIndex) 
+			: mAggregator(aggregator), mZone(zone), mZoneIndex(zoneIndex)	{}
+
+		PxProfileZone&		getZone() const			{ return mZone;		}
+		PxU32				getZoneIndex() const	{ return mZoneIndex;	}
+
+		// PxProfileZoneClient
+		virtual		void	handleBufferFlush(const PxU8* data, PxU32 length);
+		virtual		void	handleClientRemoved()	{}
+		virtual		void	handleEventAdded(const PxProfileEventName& name);
+		//~PxProfileZoneClient
+
+	private:
+		ProfileZoneAggregatorClient& operator=(const ProfileZoneAggregatorClient&);
+
+		ProfileZoneAggregator&	mAggregator;
+		PxProfileZone&			mZone;
+		const PxU32				mZoneIndex;
+	};
+
+	class ProfileZoneAggregator : public PxProfileZoneAggregator, public PxProfileZoneHandler, public Ps::UserAllocated
+	{
+	public:
+										ProfileZoneAggregator(PxProfileZoneManager& manager, bool recordStream);
+		virtual							~ProfileZoneAggregator();
+
+		void							addEvents(PxU32 zoneIndex, const PxU8* data, PxU32 length);
+		void							addEventName(PxU32 zoneIndex, PxU16 eventId, const char* name);
+
+		// PxProfileZoneAggregator
+		virtual		void				endFrame();
+		virtual		PxU32				getNbFrames() const;
+		virtual		PxU32				getNbEventStats() const;
+		virtual		bool				getEventStats(PxU32 index, PxProfileZoneEventStats& stats) const;
+		virtual		bool				writeReport(PxOutputStream& stream, PxProfileZoneReportFormat::Enum format) const;
+		virtual		bool				saveStream(const char* filename) const;
+		virtual		void				release();
+		//~PxProfileZoneAggregator
+
+		// PxProfileZoneHandler
+		virtual		void				onZoneAdded(PxProfileZone& zone);
+		virtual		void				onZoneRemoved(PxProfileZone& zone);
+		//~PxProfileZoneHandler
+
+	private:
+		ProfileZoneAggregator& operator=(const ProfileZoneAggregator&);
+
+		void							record(PxProfileZoneStreamRecord::Enum type, const PxU32* words, PxU32 nbWords, const void* data, PxU32 length);
+
+		PxProfileZoneManager&					mManager;
+		const bool								mRecordStream;
+
+		mutable Ps::Mutex						mMutex;			// zones flush from any thread
+		mutable ProfileZoneStatistics			mStatistics;
+		Ps::Array<ProfileZoneAggregatorClient*>	mClients;
+		Ps::Array<PxU8>							mStream;		// records as described by PxProfileZoneStreamFileHeader
+		mutable Ps::Array<PxProfileZoneEventStats>	mEventStats;	// computed on demand by getEventStats()
+		mutable bool							mEventStatsValid;
+	};
+
+} // namespace Ext
+
+}
+
+#endif //EXT_PROFILE_ZONE_AGGREGATOR_H
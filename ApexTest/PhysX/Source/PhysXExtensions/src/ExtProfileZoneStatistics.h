@@ -0,0 +1,458 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef EXT_PROFILE_ZONE_STATISTICS_H
+#define EXT_PROFILE_ZONE_STATISTICS_H
+
+#include "PxProfileZoneAggregator.h"
+#include "PxProfileFoundationWrapper.h"
+#include "PxProfileEventParser.h"
+#include "common/PxIO.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+namespace physx
+{
+namespace Ext
+{
+	// Per frame timing of the profile events of several profile zones, see PxProfileZoneEventStats.
+	//
+	// Header only and all memory goes through the allocator callback passed in, so the ProfileZoneStats 
+	// tool can use it without the foundation library. Not thread safe.
+	class ProfileZoneStatistics
+	{
+		typedef profile::FoundationWrapper FoundationWrapper;
+
+		struct EventStat
+		{
+			PxU32	key;				// zone index << 16 | event id
+			PxU32	numFrames;
+			PxU32	numCalls;
+			PxU64	inclusiveTotal;
+			PxU64	exclusiveTotal;
+			PxU64	frameInclusive;		// sums of the current frame
+			PxU64	frameExclusive;
+			PxU32	frameCalls;
+		};
+
+		struct FrameSample
+		{
+			PxU32	stat;
+			PxU64	inclusive;
+			PxU64	exclusive;
+		};
+
+		// An event that was started but not stopped yet. The open events of a thread form a stack
+		// linked through previous, which is an index + 1 into mOpenEvents or 0.
+		struct OpenEvent
+		{
+			PxU32	stat;
+			PxU16	eventId;
+			PxU64	start;
+			PxU64	children;
+			PxU32	previous;
+		};
+
+		struct LessInclusive
+		{
+			bool operator()(const FrameSample& a, const FrameSample& b) const
+			{
+				return a.stat != b.stat ? a.stat < b.stat : a.inclusive < b.inclusive;
+			}
+		};
+
+		struct LessExclusive
+		{
+			bool operator()(const FrameSample& a, const FrameSample& b) const
+			{
+				return a.stat != b.stat ? a.stat < b.stat : a.exclusive < b.exclusive;
+			}
+		};
+
+		// In place heap sort. shdfnd::sort takes its stack from PX_ALLOCA, which needs the foundation's temp allocator.
+		template<class Predicate>
+		static void heapSort(FrameSample* elements, PxU32 count, const Predicate& less)
+		{
+			for(PxU32 i = count / 2; i--; )
+				siftDown(elements, i, count, less);
+			for(PxU32 end = count; end > 1; )
+			{
+				end--;
+				const FrameSample top = elements[0];
+				elements[0] = elements[end];
+				elements[end] = top;
+				siftDown(elements, 0, end, less);
+			}
+		}
+
+		template<class Predicate>
+		static void siftDown(FrameSample* elements, PxU32 root, PxU32 count, const Predicate& less)
+		{
+			const FrameSample value = elements[root];
+			for(PxU32 child = 2 * root + 1; child < count; child = 2 * root + 1)
+			{
+				if(child + 1 < count && less(elements[child], elements[child + 1]))
+					child++;
+				if(!less(value, elements[child]))
+					break;
+				elements[root] = elements[child];
+				root = child;
+			}
+			elements[root] = value;
+		}
+
+		// Receives the events of one block from the event parser.
+		struct ZoneParser
+		{
+			ProfileZoneStatistics&	mStats;
+			PxU32					mZone;
+
+			ZoneParser(ProfileZoneStatistics& stats, PxU32 zone) : mStats(stats), mZone(zone) {}
+
+			void onStartEvent(const PxProfileEventId& id, PxU32 threadId, PxU64, PxU8, PxU8, PxU64 timestamp)	{ mStats.startEvent(mZone, id.mEventId, threadId, timestamp);	}
+			void onStopEvent(const PxProfileEventId& id, PxU32 threadId, PxU64, PxU8, PxU8, PxU64 timestamp)	{ mStats.stopEvent(mZone, id.mEventId, threadId, timestamp);	}
+			void onEventValue(const PxProfileEventId&, PxU32, PxU64, PxI64)										{}
+			void onCUDAProfileBuffer(PxU64, PxF32, const PxU8*, PxU32, PxU32)									{}
+
+		private:
+			ZoneParser& operator=(const ZoneParser&);
+		};
+
+	public:
+		ProfileZoneStatistics(PxAllocatorCallback& allocator)
+		: mWrapper(allocator)
+		, mNames(mWrapper)
+		, mZoneNames(mWrapper)
+		, mEventNames(mWrapper)
+		, mStats(mWrapper)
+		, mStatIndices(mWrapper)
+		, mSamples(mWrapper)
+		, mOpenEvents(mWrapper)
+		, mThreadTops(mWrapper)
+		, mFreeOpenEvent(0)
+		, mNbFrames(0)
+		, mTicksToMs(1.0e-5)
+		{
+		}
+
+		// Event timestamps times numerator / denominator are tens of nanoseconds.
+		void setTimestampFrequency(PxU64 numerator, PxU64 denominator)
+		{
+			mTicksToMs = PxF64(numerator) / (PxF64(denominator) * 1.0e5);
+		}
+
+		PxU32 addZone(const char* name)
+		{
+			mZoneNames.pushBack(addName(name));
+			return mZoneNames.size() - 1;
+		}
+
+		void addEventName(PxU32 zone, PxU16 eventId, const char* name)
+		{
+			mEventNames[zone << 16 | eventId] = addName(name);
+		}
+
+		// Adds a block of serialized events as passed to PxProfileEventBufferClient::handleBufferFlush().
+		bool addEvents(PxU32 zone, const PxU8* data, PxU32 length)
+		{
+			ZoneParser parser(*this, zone);
+			return profile::parseEventData<false>(data, length, &parser);
+		}
+
+		// Events are attributed to the frame in which they stop.
+		void endFrame()
+		{
+			for(PxU32 i = 0; i < mStats.size(); i++)
+			{
+				EventStat& stat = mStats[i];
+				if(!stat.frameCalls)
+					continue;
+				FrameSample sample;
+				sample.stat			= i;
+				sample.inclusive	= stat.frameInclusive;
+				sample.exclusive	= stat.frameExclusive;
+				mSamples.pushBack(sample);
+				stat.numFrames++;
+				stat.numCalls		+= stat.frameCalls;
+				stat.inclusiveTotal	+= stat.frameInclusive;
+				stat.exclusiveTotal	+= stat.frameExclusive;
+				stat.frameInclusive	= 0;
+				stat.frameExclusive	= 0;
+				stat.frameCalls		= 0;
+			}
+			mNbFrames++;
+		}
+
+		PxU32 getNbZones() const		{ return mZoneNames.size();	}
+		PxU32 getNbFrames() const		{ return mNbFrames;			}
+		PxU32 getNbEventStats() const	{ return mStats.size();		}
+
+		// Fills one entry per event. The names point into this object and stay valid until the next non-const call.
+		void computeEventStats(PxProfileZoneEventStats* stats)
+		{
+			// events without a registered name are reported by id
+			for(PxU32 i = 0; i < mStats.size(); i++)
+			{
+				if(!mEventNames.find(mStats[i].key))
+				{
+					char name[16];
+					sprintf(name, "%u", mStats[i].key & 0xffff);
+					mEventNames[mStats[i].key] = addName(name);
+				}
+			}
+
+			for(PxU32 i = 0; i < mStats.size(); i++)
+			{
+				const EventStat& src = mStats[i];
+				PxProfileZoneEventStats& dst = stats[i];
+				dst.zoneName		= mNames.begin() + mZoneNames[src.key >> 16];
+				dst.eventName		= mNames.begin() + mEventNames[src.key];
+				dst.eventId			= PxU16(src.key & 0xffff);
+				dst.numFrames		= src.numFrames;
+				dst.numCalls		= src.numCalls;
+				dst.inclusiveTotal	= PxF64(src.inclusiveTotal) * mTicksToMs;
+				dst.exclusiveTotal	= PxF64(src.exclusiveTotal) * mTicksToMs;
+			}
+
+			profile::ProfileArray<FrameSample> samples(mSamples);
+			heapSort(samples.begin(), samples.size(), LessInclusive());
+			for(PxU32 first = 0, last = 0; first < samples.size(); first = last)
+			{
+				while(last < samples.size() && samples[last].stat == samples[first].stat)
+					last++;
+				PxProfileZoneEventStats& dst = stats[samples[first].stat];
+				dst.inclusiveP50 = PxF64(samples[first + percentileIndex(0.50, last - first)].inclusive) * mTicksToMs;
+				dst.inclusiveP95 = PxF64(samples[first + percentileIndex(0.95, last - first)].inclusive) * mTicksToMs;
+				dst.inclusiveP99 = PxF64(samples[first + percentileIndex(0.99, last - first)].inclusive) * mTicksToMs;
+				dst.inclusiveMax = PxF64(samples[last - 1].inclusive) * mTicksToMs;
+			}
+			heapSort(samples.begin(), samples.size(), LessExclusive());
+			for(PxU32 first = 0, last = 0; first < samples.size(); first = last)
+			{
+				while(last < samples.size() && samples[last].stat == samples[first].stat)
+					last++;
+				PxProfileZoneEventStats& dst = stats[samples[first].stat];
+				dst.exclusiveP50 = PxF64(samples[first + percentileIndex(0.50, last - first)].exclusive) * mTicksToMs;
+				dst.exclusiveP95 = PxF64(samples[first + percentileIndex(0.95, last - first)].exclusive) * mTicksToMs;
+				dst.exclusiveP99 = PxF64(samples[first + percentileIndex(0.99, last - first)].exclusive) * mTicksToMs;
+				dst.exclusiveMax = PxF64(samples[last - 1].exclusive) * mTicksToMs;
+			}
+
+			// events that did not stop in any closed frame yet
+			for(PxU32 i = 0; i < mStats.size(); i++)
+			{
+				PxProfileZoneEventStats& dst = stats[i];
+				if(!dst.numFrames)
+					dst.inclusiveP50 = dst.inclusiveP95 = dst.inclusiveP99 = dst.inclusiveMax = dst.exclusiveP50 = dst.exclusiveP95 = dst.exclusiveP99 = dst.exclusiveMax = 0.0;
+			}
+		}
+
+		bool writeReport(PxOutputStream& stream, PxProfileZoneReportFormat::Enum format)
+		{
+			profile::ProfileArray<PxProfileZoneEventStats> stats(mWrapper);
+			stats.resize(mStats.size());
+			if(stats.size())
+				computeEventStats(stats.begin());
+
+			const bool json = format == PxProfileZoneReportFormat::eJSON;
+			bool ok = json ? print(stream, "{\n\t\"frames\": %u,\n\t\"events\": [", mNbFrames)
+				: print(stream, "zone,event,id,frames,calls,"
+					"incl_total_ms,incl_p50_ms,incl_p95_ms,incl_p99_ms,incl_max_ms,"
+					"excl_total_ms,excl_p50_ms,excl_p95_ms,excl_p99_ms,excl_max_ms\n");
+			for(PxU32 i = 0; ok && i < stats.size(); i++)
+			{
+				const PxProfileZoneEventStats& s = stats[i];
+				if(json)
+				{
+					ok = print(stream, "%s\n\t\t{ \"zone\": ", i ? "," : "");
+					ok = ok && writeString(stream, s.zoneName, true) && print(stream, ", \"event\": ");
+					ok = ok && writeString(stream, s.eventName, true);
+					ok = ok && print(stream, ", \"id\": %u, \"frames\": %u, \"calls\": %u,\n", PxU32(s.eventId), s.numFrames, s.numCalls);
+					ok = ok && print(stream, "\t\t  \"inclusive\": { \"total\": %.6f, \"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f },\n",
+						s.inclusiveTotal, s.inclusiveP50, s.inclusiveP95, s.inclusiveP99, s.inclusiveMax);
+					ok = ok && print(stream, "\t\t  \"exclusive\": { \"total\": %.6f, \"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f } }",
+						s.exclusiveTotal, s.exclusiveP50, s.exclusiveP95, s.exclusiveP99, s.exclusiveMax);
+				}
+				else
+				{
+					ok = writeString(stream, s.zoneName, false) && print(stream, ",");
+					ok = ok && writeString(stream, s.eventName, false);
+					ok = ok && print(stream, ",%u,%u,%u,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n", PxU32(s.eventId), s.numFrames, s.numCalls,
+						s.inclusiveTotal, s.inclusiveP50, s.inclusiveP95, s.inclusiveP99, s.inclusiveMax,
+						s.exclusiveTotal, s.exclusiveP50, s.exclusiveP95, s.exclusiveP99, s.exclusiveMax);
+				}
+			}
+			if(ok && json)
+				ok = print(stream, "\n\t]\n}\n");
+			return ok;
+		}
+
+	private:
+		ProfileZoneStatistics& operator=(const ProfileZoneStatistics&);
+
+		static PxU32 percentileIndex(PxF64 p, PxU32 count)
+		{
+			// nearest rank
+			const PxU32 rank = PxU32(ceil(p * PxF64(count)));
+			return rank ? PxMin(rank, count) - 1 : 0;
+		}
+
+		static bool print(PxOutputStream& stream, const char* format, ...)
+		{
+			char buffer[512];
+			va_list args;
+			va_start(args, format);
+			const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+			va_end(args);
+			if(length < 0 || length >= int(sizeof(buffer)))
+				return false;
+			return stream.write(buffer, PxU32(length)) == PxU32(length);
+		}
+
+		// Quoted and escaped for JSON, quoted only if needed for CSV.
+		static bool writeString(PxOutputStream& stream, const char* str, bool json)
+		{
+			const bool quote = json || strpbrk(str, ",\"\r\n") != NULL;
+			bool ok = !quote || stream.write("\"", 1) == 1;
+			for(const char* c = str; ok && *c; c++)
+			{
+				if(json && (*c == '"' || *c == '\\'))
+					ok = print(stream, "\\%c", *c);
+				else if(json && PxU8(*c) < 0x20)
+					ok = print(stream, "\\u%04x", PxU32(PxU8(*c)));
+				else if(!json && *c == '"')
+					ok = stream.write("\"\"", 2) == 2;
+				else
+					ok = stream.write(c, 1) == 1;
+			}
+			return ok && (!quote || stream.write("\"", 1) == 1);
+		}
+
+		PxU32 addName(const char* name)
+		{
+			const PxU32 offset = mNames.size();
+			const PxU32 length = PxU32(strlen(name)) + 1;
+			mNames.resize(offset + length);
+			memcpy(mNames.begin() + offset, name, length);
+			return offset;
+		}
+
+		PxU32 getStat(PxU32 zone, PxU16 eventId)
+		{
+			const PxU32 key = zone << 16 | eventId;
+			if(const profile::ProfileHashMap<PxU32, PxU32>::Entry* entry = mStatIndices.find(key))
+				return entry->second;
+			EventStat stat;
+			memset(&stat, 0, sizeof(stat));
+			stat.key = key;
+			mStats.pushBack(stat);
+			mStatIndices[key] = mStats.size() - 1;
+			return mStats.size() - 1;
+		}
+
+		void startEvent(PxU32 zone, PxU16 eventId, PxU32 threadId, PxU64 timestamp)
+		{
+			PxU32& top = mThreadTops[PxU64(zone) << 32 | threadId];
+			PxU32 index;
+			if(mFreeOpenEvent)
+			{
+				index = mFreeOpenEvent - 1;
+				mFreeOpenEvent = mOpenEvents[index].previous;
+			}
+			else
+			{
+				index = mOpenEvents.size();
+				mOpenEvents.pushBack(OpenEvent());
+			}
+			OpenEvent& open = mOpenEvents[index];
+			open.stat		= getStat(zone, eventId);
+			open.eventId	= eventId;
+			open.start		= timestamp;
+			open.children	= 0;
+			open.previous	= top;
+			top = index + 1;
+		}
+
+		void stopEvent(PxU32 zone, PxU16 eventId, PxU32 threadId, PxU64 timestamp)
+		{
+			PxU32& top = mThreadTops[PxU64(zone) << 32 | threadId];
+
+			// unmatched stops are ignored, unmatched starts above a matching one are dropped
+			PxU32 match = top;
+			while(match && mOpenEvents[match - 1].eventId != eventId)
+				match = mOpenEvents[match - 1].previous;
+			if(!match)
+				return;
+			while(top != match)
+				top = freeOpenEvent(top);
+
+			const OpenEvent& open = mOpenEvents[match - 1];
+			const PxU64 inclusive = timestamp > open.start ? timestamp - open.start : 0;
+			const PxU64 exclusive = inclusive > open.children ? inclusive - open.children : 0;
+			EventStat& stat = mStats[open.stat];
+			stat.frameInclusive += inclusive;
+			stat.frameExclusive += exclusive;
+			stat.frameCalls++;
+
+			top = freeOpenEvent(match);
+			if(top)
+				mOpenEvents[top - 1].children += inclusive;
+		}
+
+		// Returns the previous open event of the freed one.
+		PxU32 freeOpenEvent(PxU32 openEvent)
+		{
+			const PxU32 previous = mOpenEvents[openEvent - 1].previous;
+			mOpenEvents[openEvent - 1].previous = mFreeOpenEvent;
+			mFreeOpenEvent = openEvent;
+			return previous;
+		}
+
+		FoundationWrapper								mWrapper;
+		profile::ProfileArray<char>						mNames;			// null terminated names, referenced by offset
+		profile::ProfileArray<PxU32>					mZoneNames;
+		profile::ProfileHashMap<PxU32, PxU32>			mEventNames;	// zone << 16 | event id to name
+		profile::ProfileArray<EventStat>				mStats;
+		profile::ProfileHashMap<PxU32, PxU32>			mStatIndices;
+		profile::ProfileArray<FrameSample>				mSamples;		// one per event and closed frame in which it was stopped
+		profile::ProfileArray<OpenEvent>				mOpenEvents;
+		profile::ProfileHashMap<PxU64, PxU32>			mThreadTops;	// zone << 32 | thread id to the top open event
+		PxU32											mFreeOpenEvent;
+		PxU32											mNbFrames;
+		PxF64											mTicksToMs;
+	};
+
+} // namespace Ext
+
+}
+
+#endif //EXT_PROFILE_ZONE_STATISTICS_H
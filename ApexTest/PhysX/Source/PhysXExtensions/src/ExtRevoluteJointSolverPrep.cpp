@@ -30,7 +30,7 @@
 
 #include "ExtRevoluteJoint.h"
 #include "PsUtilities.h"
-#include "ExtConstraintHelper.h"
+#include "ExtJointSolverPrep.h"
 #include "CmRenderOutput.h"
 #include "PsMathUtils.h"
 
@@ -38,33 +38,19 @@ namespace physx
 {
 namespace Ext
 {
-	PxU32 RevoluteJointSolverPrep(Px1DConstraint* constraints,
-		PxVec3& body0WorldOffset,
-		PxU32 maxConstraints,
-		const void* constantBlock,
-		const PxTransform& bA2w,
-		const PxTransform& bB2w)
+	void RevoluteJointPrepareRows(joint::ConstraintHelper& ch, const RevoluteJointData& data, const joint::JointFrames& frames)
 	{
-		const RevoluteJointData& data = *reinterpret_cast<const RevoluteJointData*>(constantBlock);
-
 		const PxJointLimitPair& limit = data.limit;
 
 		bool limitEnabled = data.jointFlags & PxRevoluteJointFlag::eLIMIT_ENABLED;
 		bool limitIsLocked = limitEnabled && limit.lower >= limit.upper;
 
-		PxTransform cA2w = bA2w * data.c2b[0];
-		PxTransform cB2w = bB2w * data.c2b[1];
-
-		if(cB2w.q.dot(cA2w.q)<0) 
-			cB2w.q = -cB2w.q;
+		const PxTransform& cA2w = frames.cA2w;
 
-		body0WorldOffset = cB2w.p-bA2w.p;
-		Ext::joint::ConstraintHelper ch(constraints, cB2w.p - bA2w.p, cB2w.p - bB2w.p);
-
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, cA2w.transformInv(cB2w.p), 7, limitIsLocked ? 7 : 6);
+		ch.prepareLockedAxes(frames, 7, limitIsLocked ? 7 : 6);
 
 		if(limitIsLocked)
-			return ch.getCount();
+			return;
 
 		PxVec3 axis = cA2w.rotate(PxVec3(1,0,0));
 
@@ -89,7 +75,7 @@ namespace Ext
 
 		if(limitEnabled)
 		{
-			PxQuat cB2cAq = cA2w.q.getConjugate() * cB2w.q;
+			const PxQuat& cB2cAq = frames.cB2cA.q;
 			PxQuat twist(cB2cAq.x,0,0,cB2cAq.w);
 
 			PxReal magnitude = twist.normalize();
@@ -97,7 +83,23 @@ namespace Ext
 
 			ch.quarterAnglePair(tqPhi, data.tqLow, data.tqHigh, data.tqPad, axis, limit);
 		}
+	}
+
+	PxU32 RevoluteJointSolverPrep(Px1DConstraint* constraints,
+		PxVec3& body0WorldOffset,
+		PxU32 maxConstraints,
+		const void* constantBlock,
+		const PxTransform& bA2w,
+		const PxTransform& bB2w)
+	{
+		const RevoluteJointData& data = *reinterpret_cast<const RevoluteJointData*>(constantBlock);
+
+		joint::JointFrames frames;
+		joint::computeJointFrames(frames, data, bA2w, bB2w, true);
 
+		body0WorldOffset = frames.ra;
+		joint::ConstraintHelper ch(constraints, frames.ra, frames.rb);
+		RevoluteJointPrepareRows(ch, data, frames);
 		return ch.getCount();
 	}
 }//namespace
@@ -32,9 +32,12 @@
 #include "PxShapeExt.h"
 
 #include "ExtInertiaTensor.h"
+#include "ExtInertiaTensorBatch.h"
 
 #include "PsUserAllocated.h"
 #include "PsAlloca.h"
+#include "PsArray.h"
+#include "PsHashMap.h"
 
 #include "PxShape.h"
 
@@ -547,6 +550,256 @@ bool PxRigidBodyExt::setMassAndUpdateInertia(PxRigidBody& body, PxReal mass, con
 	return ::setMassAndUpdateInertia(false, body, &mass, 1, massLocalPose);
 }
 
+//----------------------------------------------------------------------------//
+
+namespace
+{
+	struct ConvexMassKey
+	{
+		const PxConvexMesh*	mesh;
+		PxMeshScale			scale;
+	};
+
+	struct ConvexMassKeyHash
+	{
+		PxU32 operator()(const ConvexMassKey& k) const
+		{
+			const PxU32* words = reinterpret_cast<const PxU32*>(&k.scale);
+			PxU32 h = Ps::hash(k.mesh);
+			for(PxU32 i=0; i < sizeof(PxMeshScale)/sizeof(PxU32); i++)
+				h ^= Ps::hash(words[i]) + 0x9e3779b9 + (h<<6) + (h>>2);
+			return h;
+		}
+
+		bool operator()(const ConvexMassKey& k0, const ConvexMassKey& k1) const
+		{
+			return k0.mesh == k1.mesh && !memcmp(&k0.scale, &k1.scale, sizeof(PxMeshScale));
+		}
+	};
+
+	// unit density mass properties of a scaled convex mesh in the shape frame
+	struct ConvexMass
+	{
+		PxMat33	inertia;
+		PxVec3	com;
+		PxReal	mass;
+	};
+}
+
+/**
+Keeps the scaled unit density mass properties of convex meshes across calls and the scratch 
+memory of the batched mass property computation.
+*/
+class InternalMassPropertiesCache : public PxRigidBodyExt::MassPropertiesCache, public Ps::UserAllocated
+{
+public:
+	InternalMassPropertiesCache()				{}
+	virtual ~InternalMassPropertiesCache()		{}
+
+	virtual	void	clear()		{ mConvexMasses.clear();	}
+	virtual	void	release()	{ PX_DELETE(this);			}
+
+	PxU32			compute(PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* densitiesOrMasses, bool masses, 
+							const PxVec3* massLocalPoses, bool* results);
+
+private:
+	const ConvexMass&	getConvexMass(const PxConvexMeshGeometry& g);
+	bool				addShapes(PxRigidBody& body, PxReal density);
+
+	Ps::HashMap<ConvexMassKey, ConvexMass, ConvexMassKeyHash>	mConvexMasses;
+	Ext::InertiaTensorBatch										mBatch;
+	Ps::Array<PxU32>											mBatchBodies;	// batch body per body, 0xffffffff if the computation failed
+	Ps::Array<PxVec3>											mLockedComs;	// per batch body
+	Ps::Array<PxShape*>											mShapes;
+};
+
+const ConvexMass& InternalMassPropertiesCache::getConvexMass(const PxConvexMeshGeometry& g)
+{
+	ConvexMassKey key;
+	key.mesh = g.convexMesh;
+	key.scale = g.scale;
+
+	const Ps::HashMap<ConvexMassKey, ConvexMass, ConvexMassKeyHash>::Entry* e = mConvexMasses.find(key);
+	if(e)
+		return e->second;
+
+	ConvexMass& m = mConvexMasses[key];
+	g.convexMesh->getMassInformation(m.mass, m.inertia, m.com);
+
+	// same scaling as computeMassAndInertia()
+	m.mass *= (g.scale.scale.x * g.scale.scale.y * g.scale.scale.z);
+	m.com = g.scale.rotation.rotateInv(g.scale.scale.multiply(g.scale.rotation.rotate(m.com)));
+	m.inertia = Ext::MassProps::scaleInertia(m.inertia, g.scale.rotation, g.scale.scale);
+	return m;
+}
+
+bool InternalMassPropertiesCache::addShapes(PxRigidBody& body, PxReal density)
+{
+	const PxU32 nbShapes = body.getNbShapes();
+	if(mShapes.size() < nbShapes)
+		mShapes.resize(nbShapes);
+	body.getShapes(mShapes.begin(), nbShapes);
+
+	for(PxU32 i=0; i < nbShapes; i++)
+	{
+		PxShape* shape = mShapes[i];
+		if (!(shape->getFlags() & PxShapeFlag::eSIMULATION_SHAPE))
+			continue; 
+
+		const PxGeometryHolder g = shape->getGeometry();
+		Ext::InertiaTensorComputer it(false);
+
+		switch(g.getType())
+		{
+		case PxGeometryType::eSPHERE : 
+			it.setSphere(g.sphere().radius);
+			break;
+
+		case PxGeometryType::eBOX : 
+			it.setBox(g.box().halfExtents);
+			break;
+
+		case PxGeometryType::eCAPSULE : 
+			it.setCapsule(0, g.capsule().radius, g.capsule().halfHeight);
+			break;
+
+		case PxGeometryType::eCONVEXMESH : 
+			{
+				const ConvexMass& m = getConvexMass(g.convexMesh());
+				mBatch.addShape(shape->getLocalPose(), m.mass, m.com, m.inertia, density);
+			}
+			continue;
+
+		default :
+			{
+				Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+					"computeMassAndInertia: Dynamic actor with illegal collision shapes");
+				return false;
+			}
+		}
+
+		mBatch.addShape(shape->getLocalPose(), it.getMass(), it.getCenterOfMass(), it.getInertia(), density);
+	}
+	return true;
+}
+
+PxU32 InternalMassPropertiesCache::compute(PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* densitiesOrMasses, bool masses, 
+										   const PxVec3* massLocalPoses, bool* results)
+{
+	mBatch.clear();
+	mBatchBodies.resize(nbBodies);
+	mLockedComs.clear();
+
+	for(PxU32 i=0; i < nbBodies; i++)
+	{
+		mBatchBodies[i] = 0xffffffff;
+
+		const PxReal value = densitiesOrMasses[i];
+		if (!PxIsFinite(value))
+		{
+			Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+				"computeMassAndInertia: Provided mass or density has no valid value");
+			continue;
+		}
+
+		// a single mass is distributed at the end, like computeMassAndInertia() does
+		mBatch.beginBody();
+		if(!addShapes(*bodies[i], masses ? 1.0f : value))
+		{
+			mBatch.cancelBody();
+			continue;
+		}
+
+		mBatchBodies[i] = mBatch.getNbBodies() - 1;
+		if(massLocalPoses)
+			mLockedComs.pushBack(massLocalPoses[i]);
+	}
+
+	mBatch.compute(massLocalPoses ? mLockedComs.begin() : NULL);
+
+	PxU32 nbSucceeded = 0;
+	for(PxU32 i=0; i < nbBodies; i++)
+	{
+		bool success;
+
+		// default values in case there were no shapes
+		PxReal massOut = 1.0f;
+		PxVec3 diagTensor(1,1,1);
+		PxQuat orient = PxQuat::createIdentity();
+		PxVec3 com = massLocalPoses ? massLocalPoses[i] : PxVec3(0);
+
+		const PxU32 index = mBatchBodies[i];
+		if(index == 0xffffffff)
+		{
+			if(masses)
+				Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+					"PxRigidBodyExt::setMassAndUpdateInertia: Mass and inertia computation failed, setting mass to 1 and inertia to (1,1,1)");
+			else
+				Ps::getFoundation().error(PxErrorCode::eINVALID_PARAMETER, __FILE__, __LINE__, 
+					"PxRigidBodyExt::updateMassAndInertia: Mass and inertia computation failed, setting mass to 1 and inertia to (1,1,1)");
+			success = false;
+		}
+		else if(masses)
+		{
+			success = true;
+
+			const PxReal mass = mBatch.getMass(index);
+			if(mass != 0)
+			{
+				diagTensor = PxDiagonalize(mBatch.getInertia(index) * (densitiesOrMasses[i] / mass), orient);
+				com = mBatch.getCenterOfMass(index);
+			}
+			massOut = densitiesOrMasses[i];	// to cover special case where body has no simulation shape
+		}
+		else
+		{
+			massOut = mBatch.getMass(index);
+			success = massOut != 0;		// body with no shapes provided
+			if(success)
+			{
+				diagTensor = PxDiagonalize(mBatch.getInertia(index), orient);
+				com = mBatch.getCenterOfMass(index);
+			}
+			else
+			{
+				massOut = 1.0f;
+			}
+		}
+
+		PX_ASSERT(orient.isFinite());
+		PX_ASSERT(diagTensor.isFinite());
+		PX_ASSERT(PxIsFinite(massOut));
+
+		PxRigidBody& body = *bodies[i];
+		body.setMass(massOut);
+		body.setMassSpaceInertiaTensor(diagTensor);
+		body.setCMassLocalPose(PxTransform(com, orient));
+
+		if(results)
+			results[i] = success;
+		if(success)
+			nbSucceeded++;
+	}
+	return nbSucceeded;
+}
+
+PxRigidBodyExt::MassPropertiesCache* PxRigidBodyExt::createMassPropertiesCache()
+{
+	return PX_NEW(InternalMassPropertiesCache);
+}
+
+PxU32 PxRigidBodyExt::updateMassAndInertia(MassPropertiesCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* densities, const PxVec3* massLocalPoses, bool* results)
+{
+	PX_CHECK_AND_RETURN_NULL(!nbBodies || (bodies && densities), "PxRigidBodyExt::updateMassAndInertia: NULL argument");
+	return static_cast<InternalMassPropertiesCache&>(cache).compute(bodies, nbBodies, densities, false, massLocalPoses, results);
+}
+
+PxU32 PxRigidBodyExt::setMassAndUpdateInertia(MassPropertiesCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, const PxReal* masses, const PxVec3* massLocalPoses, bool* results)
+{
+	PX_CHECK_AND_RETURN_NULL(!nbBodies || (bodies && masses), "PxRigidBodyExt::setMassAndUpdateInertia: NULL argument");
+	return static_cast<InternalMassPropertiesCache&>(cache).compute(bodies, nbBodies, masses, true, massLocalPoses, results);
+}
+
 PX_INLINE void addForceAtPosInternal(PxRigidBody& body, const PxVec3& force, const PxVec3& pos, PxForceMode::Enum mode, bool wakeup)
 {
 	if(mode == PxForceMode::eACCELERATION || mode == PxForceMode::eVELOCITY_CHANGE)
@@ -638,5 +891,207 @@ void PxRigidBodyExt::linearSweepMultiple(PxRigidBody& body, PxBatchQuery& batchQ
 	sweepRigidBody(body, batchQuery, false, unitDir, distance, filterFlags, useShapeFilterData, filterDataList, filterDataCount, userData, sweepCache);
 }
 
+//----------------------------------------------------------------------------//
 
+/**
+Keeps the shape descriptors of swept bodies across calls. The descriptors of a body occupy a range of 
+the shared arrays so that the geometry, pose and filter data lists of a body can be handed to the batch 
+query without copying. A range that becomes too small is abandoned and the arrays are rebuilt once half 
+of them is abandoned.
+*/
+class InternalShapeCache : public PxRigidBodyExt::ShapeCache, public Ps::UserAllocated
+{
+public:
+	InternalShapeCache() : mNbAbandonedShapes(0)	{}
+	virtual ~InternalShapeCache()					{}
+
+	virtual	void	invalidate(const PxRigidBody& body);
+	virtual	void	invalidateAll();
+	virtual	void	release();
+
+	PxU32			sweep(PxRigidBody* const* bodies, PxU32 nbBodies, PxBatchQuery& batchQuery, bool closestObject, 
+						  const PxVec3* unitDirs, const PxReal* distances, PxSceneQueryFilterFlags filterFlags, bool useShapeFilterData, 
+						  void* const* userData, const PxSweepCache* sweepCache, PxU32* resultIndices);
+
+private:
+	struct Entry
+	{
+		PxU32	firstShape;
+		PxU32	nbShapes;
+		PxU32	capacity;
+	};
+
+	// Returns the descriptors of the body, read again if its shape list changed.
+	const Entry&	getEntry(PxRigidBody& body);
+	void			readShapes(const Entry& entry);
 
+	Ps::HashMap<const PxRigidBody*, Entry>	mEntries;
+
+	Ps::Array<PxShape*>						mShapes;
+	Ps::Array<PxGeometryHolder>				mGeometries;
+	Ps::Array<const PxGeometry*>			mGeometryPointers;	// into mGeometries
+	Ps::Array<PxTransform>					mLocalPoses;
+	Ps::Array<PxFilterData>					mFilterData;
+	PxU32									mNbAbandonedShapes;
+
+	Ps::Array<PxShape*>						mScratchShapes;
+	Ps::Array<PxTransform>					mScratchPoses;
+};
+
+void InternalShapeCache::invalidate(const PxRigidBody& body)
+{
+	const Ps::HashMap<const PxRigidBody*, Entry>::Entry* e = mEntries.find(&body);
+	if(e)
+	{
+		mNbAbandonedShapes += e->second.capacity;
+		mEntries.erase(&body);
+	}
+}
+
+void InternalShapeCache::invalidateAll()
+{
+	mEntries.clear();
+	mShapes.clear();
+	mGeometries.clear();
+	mGeometryPointers.clear();
+	mLocalPoses.clear();
+	mFilterData.clear();
+	mNbAbandonedShapes = 0;
+}
+
+void InternalShapeCache::release()
+{
+	PX_DELETE(this);
+}
+
+void InternalShapeCache::readShapes(const Entry& entry)
+{
+	for(PxU32 i=0; i < entry.nbShapes; i++)
+	{
+		const PxU32 s = entry.firstShape + i;
+		PxShape* shape = mScratchShapes[i];
+		mShapes[s] = shape;
+		mGeometries[s] = shape->getGeometry();
+		mGeometryPointers[s] = &mGeometries[s].any();
+		mLocalPoses[s] = shape->getLocalPose();
+		mFilterData[s] = shape->getSimulationFilterData();
+	}
+}
+
+const InternalShapeCache::Entry& InternalShapeCache::getEntry(PxRigidBody& body)
+{
+	const PxU32 nbShapes = body.getNbShapes();
+	if(mScratchShapes.size() < nbShapes)
+		mScratchShapes.resize(nbShapes);
+	body.getShapes(mScratchShapes.begin(), nbShapes);
+
+	const Ps::HashMap<const PxRigidBody*, Entry>::Entry* e = mEntries.find(&body);
+	if(e && e->second.nbShapes == nbShapes && 
+	   (nbShapes == 0 || !memcmp(&mShapes[e->second.firstShape], mScratchShapes.begin(), sizeof(PxShape*)*nbShapes)))
+		return e->second;
+
+	Entry& entry = mEntries[&body];
+	if(!e)
+	{
+		entry.firstShape = 0;
+		entry.capacity = 0;
+	}
+
+	if(nbShapes > entry.capacity)
+	{
+		mNbAbandonedShapes += entry.capacity;
+		if(mNbAbandonedShapes > mShapes.size()/2)
+		{
+			// drop all descriptors, the other bodies read theirs again on their next sweep
+			mEntries.clear();
+			mShapes.clear();
+			mGeometries.clear();
+			mGeometryPointers.clear();
+			mLocalPoses.clear();
+			mFilterData.clear();
+			mNbAbandonedShapes = 0;
+		}
+
+		Entry& newEntry = mEntries[&body];
+		newEntry.firstShape = mShapes.size();
+		newEntry.capacity = nbShapes;
+
+		const PxGeometryHolder* oldGeometries = mGeometries.begin();
+		const PxU32 size = mShapes.size() + nbShapes;
+		mShapes.resize(size);
+		mGeometries.resize(size);
+		mGeometryPointers.resize(size);
+		mLocalPoses.resize(size);
+		mFilterData.resize(size);
+
+		if(mGeometries.begin() != oldGeometries)
+		{
+			for(PxU32 i=0; i < newEntry.firstShape; i++)
+				mGeometryPointers[i] = &mGeometries[i].any();
+		}
+
+		newEntry.nbShapes = nbShapes;
+		readShapes(newEntry);
+		return newEntry;
+	}
+
+	entry.nbShapes = nbShapes;
+	readShapes(entry);
+	return entry;
+}
+
+PxU32 InternalShapeCache::sweep(PxRigidBody* const* bodies, PxU32 nbBodies, PxBatchQuery& batchQuery, bool closestObject, 
+								const PxVec3* unitDirs, const PxReal* distances, PxSceneQueryFilterFlags filterFlags, bool useShapeFilterData, 
+								void* const* userData, const PxSweepCache* sweepCache, PxU32* resultIndices)
+{
+	const PxSceneQueryFlags outputFlags = PxSceneQueryFlag::eIMPACT|PxSceneQueryFlag::eNORMAL|PxSceneQueryFlag::eDISTANCE|PxSceneQueryFlag::eUV;
+
+	PxU32 nbQueries = 0;
+	for(PxU32 b=0; b < nbBodies; b++)
+	{
+		PxRigidBody& body = *bodies[b];
+		const Entry& entry = getEntry(body);
+		if(entry.nbShapes == 0)
+		{
+			if(resultIndices)
+				resultIndices[b] = 0xffffffff;
+			continue;
+		}
+
+		// the batch query copies the lists when the query is issued
+		if(mScratchPoses.size() < entry.nbShapes)
+			mScratchPoses.resize(entry.nbShapes);
+		const PxTransform bodyPose = body.getGlobalPose();
+		for(PxU32 i=0; i < entry.nbShapes; i++)
+			mScratchPoses[i] = bodyPose * mLocalPoses[entry.firstShape + i];
+
+		const PxGeometry** geoms = &mGeometryPointers[entry.firstShape];
+		const PxFilterData* filterData = useShapeFilterData ? &mFilterData[entry.firstShape] : NULL;
+		void* queryUserData = userData ? userData[b] : NULL;
+
+		if (closestObject)
+			batchQuery.linearCompoundGeometrySweepSingle(geoms, mScratchPoses.begin(), filterData, entry.nbShapes, unitDirs[b], distances[b], filterFlags, outputFlags, queryUserData, sweepCache);
+		else
+			batchQuery.linearCompoundGeometrySweepMultiple(geoms, mScratchPoses.begin(), filterData, entry.nbShapes, unitDirs[b], distances[b], filterFlags, outputFlags, queryUserData, sweepCache);
+
+		if(resultIndices)
+			resultIndices[b] = nbQueries;
+		nbQueries++;
+	}
+	return nbQueries;
+}
+
+PxRigidBodyExt::ShapeCache* PxRigidBodyExt::createShapeCache()
+{
+	return PX_NEW(InternalShapeCache);
+}
+
+PxU32 PxRigidBodyExt::linearSweepSingle(ShapeCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, PxBatchQuery& batchQuery, const PxVec3* unitDirs, const PxReal* distances, PxSceneQueryFilterFlags filterFlags, bool useShapeFilterData, void* const* userData, const PxSweepCache* sweepCache, PxU32* resultIndices)
+{
+	return static_cast<InternalShapeCache&>(cache).sweep(bodies, nbBodies, batchQuery, true, unitDirs, distances, filterFlags, useShapeFilterData, userData, sweepCache, resultIndices);
+}
+
+PxU32 PxRigidBodyExt::linearSweepMultiple(ShapeCache& cache, PxRigidBody* const* bodies, PxU32 nbBodies, PxBatchQuery& batchQuery, const PxVec3* unitDirs, const PxReal* distances, PxSceneQueryFilterFlags filterFlags, bool useShapeFilterData, void* const* userData, const PxSweepCache* sweepCache, PxU32* resultIndices)
+{
+	return static_cast<InternalShapeCache&>(cache).sweep(bodies, nbBodies, batchQuery, false, unitDirs, distances, filterFlags, useShapeFilterData, userData, sweepCache, resultIndices);
+}
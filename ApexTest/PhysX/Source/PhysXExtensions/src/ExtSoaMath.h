@@ -0,0 +1,177 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef EXT_SOA_MATH_H
+#define EXT_SOA_MATH_H
+
+#include "PxTransform.h"
+#include "PsVecMath.h"
+
+namespace physx
+{
+namespace Ext
+{
+namespace soa
+{
+	using namespace Ps::aos;
+
+	// Four vectors or quaternions in structure of arrays layout, one per SIMD lane. The math
+	// follows the operation order of PxQuat, PxTransform and PxMat33 so the lanes come out 
+	// as close as possible to the scalar code.
+	struct Vec3x4
+	{
+		Vec4V x, y, z;
+	};
+
+	struct Quatx4
+	{
+		Vec4V x, y, z, w;
+	};
+
+	PX_FORCE_INLINE Vec4V loadUnaligned(const PxF32* src)
+	{
+		return V4LoadUnaligned(const_cast<Vec4V*>(reinterpret_cast<const Vec4V*>(src)));
+	}
+
+	// The position is loaded together with q.w so that the load stays inside the transform.
+	PX_FORCE_INLINE void loadTransforms(const PxTransform* const* t, Quatx4& q, Vec3x4& p)
+	{
+		const Vec4V q0 = loadUnaligned(&t[0]->q.x), q1 = loadUnaligned(&t[1]->q.x), q2 = loadUnaligned(&t[2]->q.x), q3 = loadUnaligned(&t[3]->q.x);
+		q.x = V4MergeX(q0, q1, q2, q3);
+		q.y = V4MergeY(q0, q1, q2, q3);
+		q.z = V4MergeZ(q0, q1, q2, q3);
+		q.w = V4MergeW(q0, q1, q2, q3);
+
+		const Vec4V p0 = loadUnaligned(&t[0]->q.w), p1 = loadUnaligned(&t[1]->q.w), p2 = loadUnaligned(&t[2]->q.w), p3 = loadUnaligned(&t[3]->q.w);
+		p.x = V4MergeY(p0, p1, p2, p3);
+		p.y = V4MergeZ(p0, p1, p2, p3);
+		p.z = V4MergeW(p0, p1, p2, p3);
+	}
+
+	PX_FORCE_INLINE Vec3x4 sub(const Vec3x4& a, const Vec3x4& b)
+	{
+		Vec3x4 r;
+		r.x = V4Sub(a.x, b.x);
+		r.y = V4Sub(a.y, b.y);
+		r.z = V4Sub(a.z, b.z);
+		return r;
+	}
+
+	PX_FORCE_INLINE Vec3x4 add(const Vec3x4& a, const Vec3x4& b)
+	{
+		Vec3x4 r;
+		r.x = V4Add(a.x, b.x);
+		r.y = V4Add(a.y, b.y);
+		r.z = V4Add(a.z, b.z);
+		return r;
+	}
+
+	// PxQuat::operator*
+	PX_FORCE_INLINE Quatx4 mul(const Quatx4& a, const Quatx4& b)
+	{
+		Quatx4 r;
+		r.x = V4Sub(V4Add(V4Add(V4Mul(a.w, b.x), V4Mul(b.w, a.x)), V4Mul(a.y, b.z)), V4Mul(b.y, a.z));
+		r.y = V4Sub(V4Add(V4Add(V4Mul(a.w, b.y), V4Mul(b.w, a.y)), V4Mul(a.z, b.x)), V4Mul(b.z, a.x));
+		r.z = V4Sub(V4Add(V4Add(V4Mul(a.w, b.z), V4Mul(b.w, a.z)), V4Mul(a.x, b.y)), V4Mul(b.x, a.y));
+		r.w = V4Sub(V4Sub(V4Sub(V4Mul(a.w, b.w), V4Mul(a.x, b.x)), V4Mul(a.y, b.y)), V4Mul(a.z, b.z));
+		return r;
+	}
+
+	PX_FORCE_INLINE Quatx4 conjugate(const Quatx4& q)
+	{
+		Quatx4 r;
+		r.x = V4Neg(q.x);
+		r.y = V4Neg(q.y);
+		r.z = V4Neg(q.z);
+		r.w = q.w;
+		return r;
+	}
+
+	// PxQuat::rotate
+	PX_FORCE_INLINE Vec3x4 rotate(const Quatx4& q, const Vec3x4& v)
+	{
+		const Vec4V vx = V4Add(v.x, v.x);
+		const Vec4V vy = V4Add(v.y, v.y);
+		const Vec4V vz = V4Add(v.z, v.z);
+		const Vec4V w2 = V4Sub(V4Mul(q.w, q.w), V4Splat(FHalf()));
+		const Vec4V dot2 = V4Add(V4Add(V4Mul(q.x, vx), V4Mul(q.y, vy)), V4Mul(q.z, vz));
+
+		Vec3x4 r;
+		r.x = V4Add(V4Add(V4Mul(vx, w2), V4Mul(V4Sub(V4Mul(q.y, vz), V4Mul(q.z, vy)), q.w)), V4Mul(q.x, dot2));
+		r.y = V4Add(V4Add(V4Mul(vy, w2), V4Mul(V4Sub(V4Mul(q.z, vx), V4Mul(q.x, vz)), q.w)), V4Mul(q.y, dot2));
+		r.z = V4Add(V4Add(V4Mul(vz, w2), V4Mul(V4Sub(V4Mul(q.x, vy), V4Mul(q.y, vx)), q.w)), V4Mul(q.z, dot2));
+		return r;
+	}
+
+	// PxMat33(const PxQuat&)
+	PX_FORCE_INLINE void quatToMatrix(const Quatx4& q, Vec3x4* columns)
+	{
+		const Vec4V one = V4One();
+		const Vec4V x2 = V4Add(q.x, q.x);
+		const Vec4V y2 = V4Add(q.y, q.y);
+		const Vec4V z2 = V4Add(q.z, q.z);
+
+		const Vec4V xx = V4Mul(x2, q.x);
+		const Vec4V yy = V4Mul(y2, q.y);
+		const Vec4V zz = V4Mul(z2, q.z);
+		const Vec4V xy = V4Mul(x2, q.y);
+		const Vec4V xz = V4Mul(x2, q.z);
+		const Vec4V xw = V4Mul(x2, q.w);
+		const Vec4V yz = V4Mul(y2, q.z);
+		const Vec4V yw = V4Mul(y2, q.w);
+		const Vec4V zw = V4Mul(z2, q.w);
+
+		columns[0].x = V4Sub(V4Sub(one, yy), zz);	columns[0].y = V4Add(xy, zw);					columns[0].z = V4Sub(xz, yw);
+		columns[1].x = V4Sub(xy, zw);				columns[1].y = V4Sub(V4Sub(one, xx), zz);		columns[1].z = V4Add(yz, xw);
+		columns[2].x = V4Add(xz, yw);				columns[2].y = V4Sub(yz, xw);					columns[2].z = V4Sub(V4Sub(one, xx), yy);
+	}
+
+	PX_FORCE_INLINE PxF32 getLane(const Vec4V& v, PxU32 lane)
+	{
+		return reinterpret_cast<const PxF32*>(&v)[lane];
+	}
+
+	PX_FORCE_INLINE PxVec3 getLane(const Vec3x4& v, PxU32 lane)
+	{
+		return PxVec3(getLane(v.x, lane), getLane(v.y, lane), getLane(v.z, lane));
+	}
+
+	PX_FORCE_INLINE PxQuat getLane(const Quatx4& q, PxU32 lane)
+	{
+		return PxQuat(getLane(q.x, lane), getLane(q.y, lane), getLane(q.z, lane), getLane(q.w, lane));
+	}
+
+} // namespace soa
+
+} // namespace Ext
+
+}
+
+#endif
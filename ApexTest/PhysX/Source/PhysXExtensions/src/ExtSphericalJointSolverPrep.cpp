@@ -29,7 +29,7 @@
 
 
 #include "ExtSphericalJoint.h"
-#include "ExtConstraintHelper.h"
+#include "ExtJointSolverPrep.h"
 #include "CmConeLimitHelper.h"
 #include "CmRenderOutput.h"
 
@@ -37,30 +37,14 @@ namespace physx
 {
 namespace Ext
 {
-	PxU32 SphericalJointSolverPrep(Px1DConstraint* constraints,
-		PxVec3& body0WorldOffset,
-		PxU32 maxConstraints,
-		const void* constantBlock,							  
-		const PxTransform& bA2w,
-		const PxTransform& bB2w)
+	void SphericalJointPrepareRows(joint::ConstraintHelper& ch, const SphericalJointData& data, const joint::JointFrames& frames)
 	{
-
 		using namespace joint;
-		const SphericalJointData& data = *reinterpret_cast<const SphericalJointData*>(constantBlock);
-
-		PxTransform cA2w = bA2w * data.c2b[0];
-		PxTransform cB2w = bB2w * data.c2b[1];
-
-		if(cB2w.q.dot(cA2w.q)<0) 
-			cB2w.q = -cB2w.q;
-
-		body0WorldOffset = cB2w.p-bA2w.p;
-		joint::ConstraintHelper ch(constraints, cB2w.p - bA2w.p, cB2w.p - bB2w.p);
 
 		if(data.jointFlags & PxSphericalJointFlag::eLIMIT_ENABLED)
 		{
 			PxQuat swing, twist;
-			Ps::separateSwingTwist(cA2w.q.getConjugate() * cB2w.q, swing, twist);
+			Ps::separateSwingTwist(frames.cB2cA.q, swing, twist);
 			PX_ASSERT(PxAbs(swing.x)<1e-6f);
 
 			Cm::ConeLimitHelper coneHelper(data.tanQZLimit, data.tanQYLimit, data.tanQPad);
@@ -68,12 +52,28 @@ namespace Ext
 			PxVec3 axis;
 			PxReal error;
 			if(coneHelper.getLimit(swing, axis, error))
-				ch.angular(cA2w.rotate(axis),error,data.limit);
+				ch.angular(frames.cA2w.rotate(axis),error,data.limit);
 
 		}
 
-		ch.prepareLockedAxes(cA2w.q, cB2w.q, cA2w.transformInv(cB2w.p), 7, 0);
+		ch.prepareLockedAxes(frames, 7, 0);
+	}
+
+	PxU32 SphericalJointSolverPrep(Px1DConstraint* constraints,
+		PxVec3& body0WorldOffset,
+		PxU32 maxConstraints,
+		const void* constantBlock,
+		const PxTransform& bA2w,
+		const PxTransform& bB2w)
+	{
+		const SphericalJointData& data = *reinterpret_cast<const SphericalJointData*>(constantBlock);
+
+		joint::JointFrames frames;
+		joint::computeJointFrames(frames, data, bA2w, bB2w, true);
 
+		body0WorldOffset = frames.ra;
+		joint::ConstraintHelper ch(constraints, frames.ra, frames.rb);
+		SphericalJointPrepareRows(ch, data, frames);
 		return ch.getCount();
 	}
 }//namespace
@@ -0,0 +1,364 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+  
+
+#include "PxVisualDebuggerExt.h"
+#include "PxVisualDebuggerCapture.h"
+
+#if PX_SUPPORT_VISUAL_DEBUGGER
+#include "ExtVisualDebuggerCapture.h"
+#include "PvdConnectionManager.h"
+#include "PxProfileEventHandler.h"
+#include "PxProfileZone.h"
+#include "PxPhysics.h"
+#include "PxScene.h"
+#include "PxSimulationStatistics.h"
+#include "PxFoundation.h"
+#include "PsFoundation.h"
+#include "PsAtomic.h"
+#include "PsString.h"
+#include "PsFile.h"
+#include <string.h>
+
+using namespace physx;
+using namespace physx::debugger;
+using namespace Ext;
+
+namespace
+{
+	struct ProfileEventCounter : public PxProfileEventHandler
+	{
+		PxU32 mNumStartEvents;
+
+		ProfileEventCounter() : mNumStartEvents(0) {}
+
+		virtual void onStartEvent(const PxProfileEventId&, PxU32, PxU64, PxU8, PxU8, PxU64)	{ mNumStartEvents++; }
+		virtual void onStopEvent(const PxProfileEventId&, PxU32, PxU64, PxU8, PxU8, PxU64)	{}
+		virtual void onEventValue(const PxProfileEventId&, PxU32, PxU64, PxI64)				{}
+		virtual void onCUDAProfileBuffer(PxU64, PxF32, const PxU8*, PxU32, PxU32)			{}
+	};
+}
+
+PvdError VisualDebuggerCaptureStream::write(const PxU8* inBytes, PxU32 inLength)
+{
+	if(!mConnected)
+		return PvdErrorType::NetworkError;
+	mCapture.write(inBytes, inLength);
+	return PvdErrorType::Success;
+}
+
+VisualDebuggerCapture::VisualDebuggerCapture(PxPhysics& physics, const char* filename, PxU32 maxFrames, PxVisualDebuggerConnectionFlags flags)
+: mPhysics(physics)
+, mFilename(NULL)
+, mMaxFrames(maxFrames)
+, mFlags(flags)
+, mStream(*this)
+, mConnection(NULL)
+, mFirstFrame(0)
+, mNbFrames(0)
+, mNbDroppedFrames(0)
+, mFrameIndex(0)
+, mInPrologue(true)
+, mCurrentProfileEvents(0)
+, mNumAllocations(0)
+, mNumDeallocations(0)
+, mAllocatedBytes(0)
+{
+	if(filename)
+	{
+		const PxU32 size = PxU32(strlen(filename)) + 1;
+		mFilename = reinterpret_cast<char*>(PX_ALLOC(size, PX_DEBUG_EXP("VisualDebuggerCapture")));
+		string::strcpy_s(mFilename, size, filename);
+	}
+	if(mMaxFrames)
+		mFrames.reserve(mMaxFrames);
+}
+
+VisualDebuggerCapture::~VisualDebuggerCapture()
+{
+	for(PxU32 i = 0; i < mFrames.size(); i++)
+		PX_DELETE(mFrames[i]);
+	if(mFilename)
+		PX_FREE(mFilename);
+}
+
+bool VisualDebuggerCapture::connect()
+{
+	physx::debugger::comm::PvdConnectionManager* mgr = mPhysics.getPvdConnectionManager();
+	if(!mgr)
+		return false;
+
+	// The manager hosts a single connection, an application connection to PVD is left alone.
+	if(mgr->isConnected())
+	{
+		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxVisualDebuggerExt::createCapture: the PVD connection manager is already connected.");
+		return false;
+	}
+
+	if(mFlags & PxVisualDebuggerConnectionFlag::Memory)
+		mPhysics.getFoundation().getAllocator().registerAllocationListener(*this);
+	if(PxProfileZoneManager* zoneManager = mPhysics.getProfileZoneManager())
+		zoneManager->addProfileZoneHandler(*this);
+
+	// Not double buffered, so everything the connection sends on connect lands in the prologue.
+	// The reference is kept so release() can tell whether the manager still hosts this connection.
+	mConnection = mgr->connectAddRef(NULL, mStream, TConnectionFlagsType(PxU32(mFlags)), false);
+	if(!mConnection)
+		return false;
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+	mInPrologue = false;
+	mCurrentProfileEvents = 0;
+	Ps::atomicExchange(&mNumAllocations, 0);
+	Ps::atomicExchange(&mNumDeallocations, 0);
+	Ps::atomicExchange(&mAllocatedBytes, 0);
+	mTimer.getElapsedSeconds();
+	return true;
+}
+
+void VisualDebuggerCapture::write(const PxU8* data, PxU32 length)
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	Ps::Array<PxU8>& dst = mInPrologue ? mPrologue : mCurrentData;
+	const PxU32 offset = dst.size();
+	dst.resizeUninitialized(offset + length);
+	memcpy(dst.begin() + offset, data, length);
+}
+
+void VisualDebuggerCapture::endFrame(const PxScene& scene)
+{
+	PxSimulationStatistics simStats;
+	scene.getSimulationStatistics(simStats);
+
+	PxVisualDebuggerCaptureFrameStats stats;
+	stats.frameTime					= PxReal(mTimer.getElapsedSeconds());
+	stats.numStaticBodies			= simStats.numStaticBodies;
+	stats.numDynamicBodies			= simStats.numDynamicBodies;
+	stats.numActiveDynamicBodies	= simStats.numActiveDynamicBodies;
+	stats.numActiveConstraints		= simStats.numActiveConstraints;
+	stats.numContactPairs			= 0;
+	for(PxU32 i = 0; i < PxGeometryType::eGEOMETRY_COUNT; i++)
+		for(PxU32 j = 0; j < PxGeometryType::eGEOMETRY_COUNT; j++)
+			stats.numContactPairs += simStats.numDiscreteContactPairs[i][j];
+	stats.numAllocations			= PxU32(Ps::atomicExchange(&mNumAllocations, 0));
+	stats.numDeallocations			= PxU32(Ps::atomicExchange(&mNumDeallocations, 0));
+	stats.allocatedBytes			= PxU32(Ps::atomicExchange(&mAllocatedBytes, 0));
+
+	Ps::Mutex::ScopedLock lock(mMutex);
+	stats.frameIndex				= mFrameIndex++;
+	stats.numProfileZones			= 0;
+	for(PxU32 i = 0; i < mZoneClients.size(); i++)
+	{
+		stats.numProfileZones += mZoneClients[i]->mFlushed ? 1u : 0u;
+		mZoneClients[i]->mFlushed = false;
+	}
+	stats.numProfileEvents			= mCurrentProfileEvents;
+	stats.pvdByteCount				= mCurrentData.size();
+	mCurrentProfileEvents = 0;
+
+	Frame* frame;
+	if(mMaxFrames == 0 || mFrames.size() < mMaxFrames)
+	{
+		frame = PX_NEW(Frame);
+		mFrames.pushBack(frame);
+		mNbFrames++;
+	}
+	else
+	{
+		// recycle the oldest frame, its data array keeps its capacity
+		frame = mFrames[mFirstFrame];
+		mFirstFrame = (mFirstFrame + 1) % mFrames.size();
+		mNbDroppedFrames++;
+	}
+	frame->stats = stats;
+	frame->data.swap(mCurrentData);
+	mCurrentData.clear();
+}
+
+PxU32 VisualDebuggerCapture::getNbFrames() const
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	return mNbFrames;
+}
+
+bool VisualDebuggerCapture::getFrameStats(PxU32 index, PxVisualDebuggerCaptureFrameStats& stats) const
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+	if(index >= mNbFrames)
+		return false;
+	stats = getFrame(index)->stats;
+	return true;
+}
+
+bool VisualDebuggerCapture::save(const char* filename)
+{
+	Ps::Mutex::ScopedLock lock(mMutex);
+
+	FILE* fp = NULL;
+	Ps::fopen_s(&fp, filename, "wb");
+	if(!fp)
+		return false;
+
+	PxVisualDebuggerCaptureFileHeader header;
+	header.magic				= PxVisualDebuggerCaptureFileHeader::eMAGIC;
+	header.version				= PxVisualDebuggerCaptureFileHeader::eVERSION;
+	header.frameStatsSize		= sizeof(PxVisualDebuggerCaptureFrameStats);
+	header.numFrames			= mNbFrames;
+	header.numDroppedFrames		= mNbDroppedFrames;
+	header.prologueByteCount	= mPrologue.size();
+
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+	if(ok && mPrologue.size())
+		ok = fwrite(mPrologue.begin(), mPrologue.size(), 1, fp) == 1;
+	for(PxU32 i = 0; ok && i < mNbFrames; i++)
+	{
+		const Frame* frame = getFrame(i);
+		ok = fwrite(&frame->stats, sizeof(frame->stats), 1, fp) == 1;
+		if(ok && frame->data.size())
+			ok = fwrite(frame->data.begin(), frame->data.size(), 1, fp) == 1;
+	}
+	ok = (fclose(fp) == 0) && ok;
+	return ok;
+}
+
+void VisualDebuggerCapture::release()
+{
+	if(mConnection)
+	{
+		physx::debugger::comm::PvdConnectionManager* mgr = mPhysics.getPvdConnectionManager();
+		physx::debugger::comm::PvdConnection* current = mgr->getAndAddRefCurrentConnection();
+		if(current == mConnection)
+			mgr->disconnect();
+		if(current)
+			current->release();
+		mConnection->release();
+		mConnection = NULL;
+	}
+	if(PxProfileZoneManager* zoneManager = mPhysics.getProfileZoneManager())
+		zoneManager->removeProfileZoneHandler(*this);
+	if(mFlags & PxVisualDebuggerConnectionFlag::Memory)
+		mPhysics.getFoundation().getAllocator().deregisterAllocationListener(*this);
+	while(mZoneClients.size())
+		onZoneRemoved(mZoneClients.back()->mZone);
+
+	if(mFilename && !mInPrologue && !save(mFilename))
+		Ps::getFoundation().error(PxErrorCode::eDEBUG_WARNING, __FILE__, __LINE__, "PxVisualDebuggerCapture: failed to write %s.", mFilename);
+
+	PX_DELETE(this);
+}
+
+void VisualDebuggerCaptureZoneClient::handleBufferFlush(const PxU8* data, PxU32 length)
+{
+	mCapture.onZoneFlush(*this, data, length);
+}
+
+void VisualDebuggerCapture::onZoneAdded(PxProfileZone& zone)
+{
+	VisualDebuggerCaptureZoneClient* client = PX_NEW(VisualDebuggerCaptureZoneClient)(*this, zone);
+	{
+		Ps::Mutex::ScopedLock lock(mMutex);
+		mZoneClients.pushBack(client);
+	}
+	zone.addClient(*client);
+}
+
+void VisualDebuggerCapture::onZoneRemoved(PxProfileZone& zone)
+{
+	VisualDebuggerCaptureZoneClient* client = NULL;
+	{
+		Ps::Mutex::ScopedLock lock(mMutex);
+		for(PxU32 i = 0; i < mZoneClients.size(); i++)
+		{
+			if(&mZoneClients[i]->mZone == &zone)
+			{
+				client = mZoneClients[i];
+				mZoneClients.replaceWithLast(i);
+				break;
+			}
+		}
+	}
+	// The zone may flush into the client while it is removed, so this happens outside the lock.
+	if(client)
+	{
+		zone.removeClient(*client);
+		PX_DELETE(client);
+	}
+}
+
+void VisualDebuggerCapture::onZoneFlush(VisualDebuggerCaptureZoneClient& client, const PxU8* data, PxU32 length)
+{
+	ProfileEventCounter counter;
+	PxProfileEventHandler::parseEventBuffer(data, length, counter, false);
+	Ps::Mutex::ScopedLock lock(mMutex);
+	mCurrentProfileEvents += counter.mNumStartEvents;
+	client.mFlushed = true;
+}
+
+void VisualDebuggerCapture::onAllocation(size_t size, const char*, const char*, int, void*)
+{
+	Ps::atomicIncrement(&mNumAllocations);
+
+	// saturates instead of wrapping, a frame can allocate more than 2GB
+	const PxI32 maxBytes = 0x7fffffff;
+	const PxI32 bytes = size < size_t(maxBytes) ? PxI32(size) : maxBytes;
+	PxI32 allocatedBytes;
+	do
+	{
+		allocatedBytes = mAllocatedBytes;
+	}
+	while(Ps::atomicCompareExchange(&mAllocatedBytes, allocatedBytes < maxBytes - bytes ? allocatedBytes + bytes : maxBytes, allocatedBytes) != allocatedBytes);
+}
+
+void VisualDebuggerCapture::onDeallocation(void*)
+{
+	Ps::atomicIncrement(&mNumDeallocations);
+}
+
+PxVisualDebuggerCapture* PxVisualDebuggerExt::createCapture( PxPhysics& inPhysics
+												, const char* filename
+												, PxU32 maxFrames
+												, PxVisualDebuggerConnectionFlags inConnectionType )
+{
+	VisualDebuggerCapture* capture = PX_NEW(VisualDebuggerCapture)(inPhysics, filename, maxFrames, inConnectionType);
+	if(!capture->connect())
+	{
+		capture->release();
+		return NULL;
+	}
+	return capture;
+}
+
+#else
+
+physx::PxVisualDebuggerCapture* physx::PxVisualDebuggerExt::createCapture( physx::PxPhysics&
+												, const char*
+												, physx::PxU32
+												, physx::PxVisualDebuggerConnectionFlags ) { return NULL; }
+
+#endif //PX_SUPPORT_VISUAL_DEBUGGER
@@ -0,0 +1,162 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#ifndef EXT_VISUAL_DEBUGGER_CAPTURE_H
+#define EXT_VISUAL_DEBUGGER_CAPTURE_H
+
+#if PX_SUPPORT_VISUAL_DEBUGGER
+
+#include "PxVisualDebuggerCapture.h"
+#include "PvdNetworkStreams.h"
+#include "PxProfileZoneManager.h"
+#include "PxProfileEventBufferClient.h"
+#include "PxBroadcastingAllocator.h"
+#include "CmPhysXCommon.h"
+#include "PsUserAllocated.h"
+#include "PsArray.h"
+#include "PsMutex.h"
+#include "PsTime.h"
+
+namespace physx
+{
+namespace Ext
+{
+	class VisualDebuggerCapture;
+
+	// The PVD connection releases its out stream when it disconnects, so the stream
+	// is a separate object owned by the capture instead of a base class.
+	class VisualDebuggerCaptureStream : public physx::debugger::PvdNetworkOutStream
+	{
+	public:
+		VisualDebuggerCaptureStream(VisualDebuggerCapture& capture) : mCapture(capture), mConnected(true)	{}
+
+		virtual physx::debugger::PvdError	write(const PxU8* inBytes, PxU32 inLength);
+		virtual bool						isConnected() const	{ return mConnected;	}
+		virtual void						disconnect()		{ mConnected = false;	}
+		virtual void						release()			{ mConnected = false;	}
+		virtual physx::debugger::PvdError	flush()				{ return physx::debugger::PvdErrorType::Success; }
+
+	private:
+		VisualDebuggerCaptureStream& operator=(const VisualDebuggerCaptureStream&);
+
+		VisualDebuggerCapture&	mCapture;
+		bool					mConnected;
+	};
+
+	// One client per profile zone, so the capture can tell which zones flushed during a frame.
+	class VisualDebuggerCaptureZoneClient : public PxProfileZoneClient, public Ps::UserAllocated
+	{
+	public:
+		VisualDebuggerCaptureZoneClient(VisualDebuggerCapture& capture, PxProfileZone& zone) : mCapture(capture), mZone(zone), mFlushed(false)	{}
+		virtual ~VisualDebuggerCaptureZoneClient() {}
+
+		virtual		void				handleBufferFlush(const PxU8* data, PxU32 length);
+		virtual		void				handleClientRemoved()	{}
+		virtual		void				handleEventAdded(const PxProfileEventName&)	{}
+
+		VisualDebuggerCapture&			mCapture;
+		PxProfileZone&					mZone;
+		bool							mFlushed;		// guarded by the capture mutex
+
+	private:
+		VisualDebuggerCaptureZoneClient& operator=(const VisualDebuggerCaptureZoneClient&);
+	};
+
+	class VisualDebuggerCapture : public PxVisualDebuggerCapture, public PxProfileZoneHandler, 
+		public PxAllocationListener, public Ps::UserAllocated
+	{
+	public:
+										VisualDebuggerCapture(PxPhysics& physics, const char* filename, PxU32 maxFrames, PxVisualDebuggerConnectionFlags flags);
+		virtual							~VisualDebuggerCapture();
+
+		bool							connect();
+		void							write(const PxU8* data, PxU32 length);
+
+		// PxVisualDebuggerCapture
+		virtual		void				endFrame(const PxScene& scene);
+		virtual		PxU32				getNbFrames() const;
+		virtual		PxU32				getMaxFrames() const	{ return mMaxFrames; }
+		virtual		bool				getFrameStats(PxU32 index, PxVisualDebuggerCaptureFrameStats& stats) const;
+		virtual		bool				save(const char* filename);
+		virtual		void				release();
+		//~PxVisualDebuggerCapture
+
+		// PxProfileZoneHandler
+		virtual		void				onZoneAdded(PxProfileZone& zone);
+		virtual		void				onZoneRemoved(PxProfileZone& zone);
+		//~PxProfileZoneHandler
+
+		void							onZoneFlush(VisualDebuggerCaptureZoneClient& client, const PxU8* data, PxU32 length);
+
+		// PxAllocationListener
+		virtual		void				onAllocation(size_t size, const char* typeName, const char* filename, int line, void* allocatedMemory);
+		virtual		void				onDeallocation(void* allocatedMemory);
+		//~PxAllocationListener
+
+	private:
+		struct Frame : public Ps::UserAllocated
+		{
+			PxVisualDebuggerCaptureFrameStats	stats;
+			Ps::Array<PxU8>						data;
+		};
+
+		PX_FORCE_INLINE	Frame*			getFrame(PxU32 index) const	{ return mFrames[(mFirstFrame + index) % mFrames.size()]; }
+
+		PxPhysics&						mPhysics;
+		char*							mFilename;
+		const PxU32						mMaxFrames;
+		const PxVisualDebuggerConnectionFlags	mFlags;
+		VisualDebuggerCaptureStream		mStream;
+		physx::debugger::comm::PvdConnection*	mConnection;	// referenced while the capture exists
+
+		mutable Ps::Mutex				mMutex;			// guards the frame data and profile zones, PVD and profile flushes can come from any thread
+		Ps::Array<PxU8>					mPrologue;
+		Ps::Array<Frame*>				mFrames;		// ring of frames, all used slots are allocated
+		PxU32							mFirstFrame;
+		PxU32							mNbFrames;
+		PxU32							mNbDroppedFrames;
+		PxU32							mFrameIndex;
+		bool							mInPrologue;
+		Ps::Array<PxU8>					mCurrentData;
+		PxU32							mCurrentProfileEvents;
+		Ps::Array<VisualDebuggerCaptureZoneClient*>	mZoneClients;
+		Ps::Time						mTimer;
+
+		volatile PxI32					mNumAllocations;
+		volatile PxI32					mNumDeallocations;
+		volatile PxI32					mAllocatedBytes;	// saturates at 0x7fffffff
+	};
+
+} // namespace Ext
+
+}
+
+#endif //PX_SUPPORT_VISUAL_DEBUGGER
+#endif //EXT_VISUAL_DEBUGGER_CAPTURE_H
@@ -45,6 +45,30 @@ namespace physx {
 			return static_cast<PxU32>( Thread::getId() ); 
 		}
 	};
+
+	/**
+	 *	Context provider for an event buffer that only ever receives events from one thread.
+	 *	The thread id is looked up once when the buffer is created.
+	 */
+	struct PxCachedThreadContextProvider
+	{
+		PxU32 mThreadId;
+
+		PxCachedThreadContextProvider( PxU32 inThreadId = static_cast<PxU32>( Thread::getId() ) ) 
+			: mThreadId( inThreadId ) 
+		{
+		}
+
+		PxProfileEventExecutionContext getExecutionContext() 
+		{ 
+			return PxProfileEventExecutionContext( mThreadId, static_cast<PxU8>( ThreadPriority::eNORMAL ), 0 );
+		}
+
+		PxU32 getThreadId() 
+		{ 
+			return mThreadId; 
+		}
+	};
 }
 
 #endif
\ No newline at end of file
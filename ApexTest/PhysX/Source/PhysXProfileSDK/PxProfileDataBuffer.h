@@ -119,6 +119,11 @@ namespace physx { namespace profile {
 			return mHasClients;
 		}
 
+		PxU32 getDataSize() const
+		{
+			return mDataArray.size();
+		}
+
 		virtual void flushEvents()
 		{	
 			TScopedLockType lock( mBufferMutex );
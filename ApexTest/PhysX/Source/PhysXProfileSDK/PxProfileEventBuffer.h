@@ -225,7 +225,7 @@ namespace physx { namespace profile {
 
 		void release()
 		{
-			PX_PROFILE_DELETE( TBaseType::mWrapper.mUserFoundation, this );
+			PX_PROFILE_DELETE( TBaseType::mWrapper.getAllocator(), this );
 		}
 	protected:
 		//Clears the cache meaning event compression
@@ -44,6 +44,8 @@ namespace physx { namespace profile {
 	typedef MutexT<WrapperReflectionAllocator<PxU8> >	TZoneMutexType;
 	typedef ScopedLockImpl<TZoneMutexType>				TZoneLockType;
 	typedef EventBuffer< PxDefaultContextProvider, TZoneMutexType, TZoneLockType, PxProfileNullEventFilter > TZoneEventBufferType;
+	//Only ever written by the thread that owns it so it needs no lock.
+	typedef EventBuffer< PxCachedThreadContextProvider, TZoneMutexType, NullLock, PxProfileNullEventFilter > TZoneThreadEventBufferType;
 
 	template<typename TNameProvider>
 	class ZoneImpl : TZoneEventBufferType //private inheritance intended
@@ -70,6 +72,11 @@ namespace physx { namespace profile {
 		volatile bool									mEventsActive;
 		PxUserCustomProfiler							*mUserCustomProfiler;
 
+		//Per-thread event buffers, the tls slot holds the calling thread's buffer.
+		ProfileArray<TZoneThreadEventBufferType*>		mThreadEventBuffers;
+		PxU32											mThreadEventBufferTls;
+		volatile bool									mThreadEventBuffersEnabled;
+
 	public:
 		ZoneImpl( PxAllocatorCallback* inAllocator, const char* inName, PxU32 bufferSize = 0x4000 /*16k*/, const TNameProvider& inProvider = TNameProvider() )
 			: TZoneEventBufferType( inAllocator, bufferSize, PxDefaultContextProvider(), NULL, PxProfileNullEventFilter() )
@@ -83,6 +90,9 @@ namespace physx { namespace profile {
 			, mClients( mWrapper )
 			, mEventsActive( false )
 			, mUserCustomProfiler(NULL)
+			, mThreadEventBuffers( mWrapper )
+			, mThreadEventBufferTls( TlsAlloc() )
+			, mThreadEventBuffersEnabled( false )
 		{
 			TZoneEventBufferType::setBufferMutex( &mMutex );
 			//Initialize the event name structure with existing names from the name provider.
@@ -99,6 +109,9 @@ namespace physx { namespace profile {
 			if ( mProfileZoneManager != NULL )
 				mProfileZoneManager->removeProfileZone( *this );
 			mProfileZoneManager = NULL;
+			for ( PxU32 idx = 0; idx < mThreadEventBuffers.size(); ++idx )
+				mThreadEventBuffers[idx]->release();
+			TlsFree( mThreadEventBufferTls );
 			TZoneEventBufferType::removeClient( *this );
 		}
 
@@ -160,6 +173,57 @@ namespace physx { namespace profile {
 			return eventId;
 		}
 
+		/**
+			Records events into a separate unlocked buffer for each sending thread.  Not part of
+			PxProfileZone: zones normally come from the prebuilt profile SDK, whose vtable must not change.
+			Flushing the zone collects the per-thread buffers, so flushing and changing this setting must
+			only happen at frame boundaries while no other thread sends events to the zone.
+		*/
+		void setPerThreadEventBuffers( bool inEnabled )
+		{
+			if ( mThreadEventBuffersEnabled && !inEnabled )
+				flushThreadEventBuffers();
+			mThreadEventBuffersEnabled = inEnabled;
+		}
+
+		bool getPerThreadEventBuffers() const
+		{
+			return mThreadEventBuffersEnabled;
+		}
+
+		//Called without any lock held, only the calling thread ever touches its buffer.
+		TZoneThreadEventBufferType& getThreadEventBuffer()
+		{
+			TZoneThreadEventBufferType* theBuffer = static_cast<TZoneThreadEventBufferType*>( TlsGet( mThreadEventBufferTls ) );
+			if ( theBuffer == NULL )
+				theBuffer = createThreadEventBuffer();
+			return *theBuffer;
+		}
+
+		TZoneThreadEventBufferType* createThreadEventBuffer()
+		{
+			TLockType theLocker( mMutex );
+			TZoneThreadEventBufferType* theBuffer = PX_PROFILE_NEW( mWrapper.getAllocator(), TZoneThreadEventBufferType )
+				( &mWrapper.getAllocator(), TZoneEventBufferType::mBufferFullAmount, PxCachedThreadContextProvider(), NULL, PxProfileNullEventFilter() );
+			//Full buffers are sent straight to our clients like the zone's own buffer.
+			theBuffer->addClient( *this );
+			mThreadEventBuffers.pushBack( theBuffer );
+			TlsSet( mThreadEventBufferTls, theBuffer );
+			return theBuffer;
+		}
+
+		//Collects every thread's buffer.  Each flush restarts the buffer's timestamp
+		//compression so the blocks can be handed to clients in any order.
+		void flushThreadEventBuffers()
+		{
+			TLockType theLocker( mMutex );
+			for ( PxU32 idx = 0; idx < mThreadEventBuffers.size(); ++idx )
+			{
+				if ( mThreadEventBuffers[idx]->getDataSize() )
+					mThreadEventBuffers[idx]->flushProfileEvents();
+			}
+		}
+
 		virtual void setProfileZoneManager(PxProfileZoneManager* inMgr)
 		{
 			mProfileZoneManager = inMgr;
@@ -240,7 +304,10 @@ namespace physx { namespace profile {
 			}
 			if( mEventsActive ) 
 			{
-				TZoneEventBufferType::startEvent( inId, contextId ); 
+				if ( mThreadEventBuffersEnabled )
+					getThreadEventBuffer().startEvent( inId, contextId );
+				else
+					TZoneEventBufferType::startEvent( inId, contextId ); 
 			}
 		}
 		virtual void stopEvent( PxU16 inId, PxU64 contextId) 
@@ -252,7 +319,10 @@ namespace physx { namespace profile {
 			}
 			if( mEventsActive ) 
 			{
-				TZoneEventBufferType::stopEvent( inId, contextId ); 
+				if ( mThreadEventBuffersEnabled )
+					getThreadEventBuffer().stopEvent( inId, contextId );
+				else
+					TZoneEventBufferType::stopEvent( inId, contextId ); 
 			}
 		}
 
@@ -265,7 +335,10 @@ namespace physx { namespace profile {
 			}
 			if( mEventsActive ) 
 			{
-				TZoneEventBufferType::startEvent( inId, contextId, threadId ); 
+				if ( mThreadEventBuffersEnabled )
+					getThreadEventBuffer().startEvent( inId, contextId, threadId );
+				else
+					TZoneEventBufferType::startEvent( inId, contextId, threadId ); 
 			}
 		}
 		virtual void stopEvent( PxU16 inId, PxU64 contextId, PxU32 threadId ) 
@@ -277,7 +350,10 @@ namespace physx { namespace profile {
 			}
 			if( mEventsActive ) 
 			{
-				TZoneEventBufferType::stopEvent( inId, contextId, threadId ); 
+				if ( mThreadEventBuffersEnabled )
+					getThreadEventBuffer().stopEvent( inId, contextId, threadId );
+				else
+					TZoneEventBufferType::stopEvent( inId, contextId, threadId ); 
 			}
 		}
 
@@ -295,14 +371,21 @@ namespace physx { namespace profile {
 			}
 			if( mEventsActive ) 
 			{
-				TZoneEventBufferType::eventValue( inId, contextId, inValue ); 
+				if ( mThreadEventBuffersEnabled )
+					getThreadEventBuffer().eventValue( inId, contextId, inValue );
+				else
+					TZoneEventBufferType::eventValue( inId, contextId, inValue ); 
 			}
 		}
 		virtual void CUDAProfileBuffer( PxF32 batchRuntimeInMilliseconds, const PxU8* cudaData, PxU32 bufLenInBytes, PxU32 bufferVersion ) 
 		{
 			if( mEventsActive ) TZoneEventBufferType::CUDAProfileBuffer( batchRuntimeInMilliseconds, cudaData, bufLenInBytes, bufferVersion ); 
 		}
-		virtual void flushProfileEvents() { TZoneEventBufferType::flushProfileEvents(); }
+		virtual void flushProfileEvents() 
+		{ 
+			flushThreadEventBuffers();
+			TZoneEventBufferType::flushProfileEvents(); 
+		}
 	};
 
 }}
@@ -171,14 +171,14 @@ bool PxVehicleDrive::isValid() const
 	return true;
 }
 
-PxU32 PxVehicleDrive::computeByteSize(const PxU32 numWheels4)
+PxU32 PxVehicleDrive::computeByteSize(const PxU32 numWheels4, const bool sharedWheelsSimData)
 {
-	return PxVehicleWheels::computeByteSize(numWheels4);
+	return PxVehicleWheels::computeByteSize(numWheels4,sharedWheelsSimData);
 }
 
-PxU8* PxVehicleDrive::patchupPointers(PxVehicleDrive* veh, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels)
+PxU8* PxVehicleDrive::patchupPointers(PxVehicleDrive* veh, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData)
 {
-	return PxVehicleWheels::patchupPointers(veh,ptr,numWheels4,numWheels);
+	return PxVehicleWheels::patchupPointers(veh,ptr,numWheels4,numWheels,sharedWheelsSimData);
 }
 
 void PxVehicleDrive::free()
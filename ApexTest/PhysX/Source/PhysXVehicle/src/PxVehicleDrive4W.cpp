@@ -81,20 +81,20 @@ bool PxVehicleDrive4W::isValid() const
 	return true;
 }
 
-PxVehicleDrive4W* PxVehicleDrive4W::allocate(const PxU32 numWheels)
+PxU32 PxVehicleDrive4W::computeInstanceByteSize(const PxU32 numWheels, const bool sharedWheelsSimData)
 {
-	PX_CHECK_AND_RETURN_NULL(numWheels>0, "Cars with zero wheels are illegal");
-
-	//Compute the bytes needed.
 	const PxU32 numWheels4 = (((numWheels + 3) & ~3) >> 2);
-	const PxU32 byteSize = sizeof(PxVehicleDrive4W) + PxVehicleDrive::computeByteSize(numWheels4);
+	return sizeof(PxVehicleDrive4W) + PxVehicleDrive::computeByteSize(numWheels4,sharedWheelsSimData);
+}
 
-	//Allocate the memory.
-	PxVehicleDrive4W* veh = (PxVehicleDrive4W*)PX_ALLOC(byteSize, PX_DEBUG_EXP("PxVehicleDrive4W"));
+PxVehicleDrive4W* PxVehicleDrive4W::patchupInstance(PxU8* ptr, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData)
+{
+	const PxU32 numWheels4 = (((numWheels + 3) & ~3) >> 2);
+	PxVehicleDrive4W* veh = (PxVehicleDrive4W*)ptr;
 
 	//Patch up the pointers.
-	PxU8* ptr = (PxU8*)veh + sizeof(PxVehicleDrive4W);
-	ptr=PxVehicleDrive::patchupPointers(veh,ptr,numWheels4,numWheels);
+	ptr += sizeof(PxVehicleDrive4W);
+	ptr=PxVehicleDrive::patchupPointers(veh,ptr,numWheels4,numWheels,sharedWheelsSimData);
 
 	//Set the vehicle type.
 	veh->mType = eVEHICLE_TYPE_DRIVE4W;
@@ -102,6 +102,20 @@ PxVehicleDrive4W* PxVehicleDrive4W::allocate(const PxU32 numWheels)
 	return veh;
 }
 
+PxVehicleDrive4W* PxVehicleDrive4W::allocate(const PxU32 numWheels)
+{
+	PX_CHECK_AND_RETURN_NULL(numWheels>0, "Cars with zero wheels are illegal");
+
+	//Compute the bytes needed.
+	const PxU32 byteSize = computeInstanceByteSize(numWheels,false);
+
+	//Allocate the memory.
+	PxU8* ptr = (PxU8*)PX_ALLOC(byteSize, PX_DEBUG_EXP("PxVehicleDrive4W"));
+
+	//Patch up the pointers.
+	return patchupInstance(ptr,numWheels,NULL);
+}
+
 void PxVehicleDrive4W::free()
 {
 	PxVehicleDrive::free();
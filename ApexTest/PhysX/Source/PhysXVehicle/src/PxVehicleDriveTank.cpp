@@ -50,20 +50,20 @@ bool PxVehicleDriveTank::isValid() const
 	return true;
 }
 
-PxVehicleDriveTank* PxVehicleDriveTank::allocate(const PxU32 numWheels)
+PxU32 PxVehicleDriveTank::computeInstanceByteSize(const PxU32 numWheels, const bool sharedWheelsSimData)
 {
-	PX_CHECK_AND_RETURN_NULL(numWheels>0, "Cars with zero wheels are illegal");
-
-	//Compute the bytes needed.
 	const PxU32 numWheels4 = (((numWheels + 3) & ~3) >> 2);
-	const PxU32 byteSize = sizeof(PxVehicleDriveTank) + + PxVehicleDrive::computeByteSize(numWheels4);
+	return sizeof(PxVehicleDriveTank) + PxVehicleDrive::computeByteSize(numWheels4,sharedWheelsSimData);
+}
 
-	//Allocate the memory.
-	PxVehicleDriveTank* veh = (PxVehicleDriveTank*)PX_ALLOC(byteSize, PX_DEBUG_EXP("PxVehicleDriveTank"));
+PxVehicleDriveTank* PxVehicleDriveTank::patchupInstance(PxU8* ptr, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData)
+{
+	const PxU32 numWheels4 = (((numWheels + 3) & ~3) >> 2);
+	PxVehicleDriveTank* veh = (PxVehicleDriveTank*)ptr;
 
 	//Patch up the pointers.
-	PxU8* ptr = (PxU8*)veh + sizeof(PxVehicleDriveTank);
-	PxVehicleDrive::patchupPointers(veh,ptr,numWheels4,numWheels);
+	ptr += sizeof(PxVehicleDriveTank);
+	PxVehicleDrive::patchupPointers(veh,ptr,numWheels4,numWheels,sharedWheelsSimData);
 
 	//Set the vehicle type.
 	veh->mType = eVEHICLE_TYPE_DRIVETANK;
@@ -74,6 +74,20 @@ PxVehicleDriveTank* PxVehicleDriveTank::allocate(const PxU32 numWheels)
 	return veh;
 }
 
+PxVehicleDriveTank* PxVehicleDriveTank::allocate(const PxU32 numWheels)
+{
+	PX_CHECK_AND_RETURN_NULL(numWheels>0, "Cars with zero wheels are illegal");
+
+	//Compute the bytes needed.
+	const PxU32 byteSize = computeInstanceByteSize(numWheels,false);
+
+	//Allocate the memory.
+	PxU8* ptr = (PxU8*)PX_ALLOC(byteSize, PX_DEBUG_EXP("PxVehicleDriveTank"));
+
+	//Patch up the pointers.
+	return patchupInstance(ptr,numWheels,NULL);
+}
+
 void PxVehicleDriveTank::free()
 {
 	PxVehicleDrive::free();
@@ -0,0 +1,239 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "PxVehicleFleet.h"
+#include "PxVehicleWheels.h"
+#include "PxVehicleDrive4W.h"
+#include "PxVehicleDriveTank.h"
+#include "PxVehicleNoDrive.h"
+#include "PxVehicleSuspWheelTire4.h"
+#include "PsFoundation.h"
+#include "PsUtilities.h"
+#include "PsAlignedMalloc.h"
+#include "CmPhysXCommon.h"
+
+namespace physx
+{
+
+static PX_FORCE_INLINE PxU32 computeAlignedByteSize64(const PxU32 byteSize)
+{
+	return (byteSize + 63) & ~63;
+}
+
+static PX_FORCE_INLINE PxU32 computeArchetypeByteSize(const PxVehicleWheelsSimData& archetype)
+{
+	const PxU32 numWheels = archetype.getNumWheels();
+	const PxU32 numWheels4 = (((numWheels + 3) & ~3) >> 2);
+	return computeAlignedByteSize64(sizeof(PxVehicleWheelsSimData) + sizeof(PxVehicleWheels4SimData)*numWheels4);
+}
+
+PxVehicleFleet* PxVehicleFleet::allocate(const PxU32 numArchetypes, const PxVehicleWheelsSimData* const* archetypes, const PxU32 maxNumVehicles, const PxU32 maxNumWheels)
+{
+	PX_CHECK_AND_RETURN_NULL(numArchetypes>0 && archetypes, "PxVehicleFleet::allocate - a fleet needs at least one archetype");
+	PX_CHECK_AND_RETURN_NULL(maxNumVehicles>0 && maxNumWheels>0, "PxVehicleFleet::allocate - a fleet needs space for at least one vehicle");
+
+	//The vehicle byte sizes are affine in the number of blocks of 4 wheels: take the largest of all vehicle types.
+	const PxU32 baseByteSize = 
+		PxMax(PxVehicleDrive4W::computeInstanceByteSize(0,true), 
+		PxMax(PxVehicleDriveTank::computeInstanceByteSize(0,true), PxVehicleNoDrive::computeInstanceByteSize(0,true)));
+	const PxU32 blockByteSize = 
+		PxMax(PxVehicleDrive4W::computeInstanceByteSize(4,true) - PxVehicleDrive4W::computeInstanceByteSize(0,true), 
+		PxMax(PxVehicleDriveTank::computeInstanceByteSize(4,true) - PxVehicleDriveTank::computeInstanceByteSize(0,true), 
+			  PxVehicleNoDrive::computeInstanceByteSize(4,true) - PxVehicleNoDrive::computeInstanceByteSize(0,true)));
+
+	//Every vehicle rounds its number of wheels up to a block of 4 and its byte size up to 64.
+	const PxU32 maxNumWheels4 = (maxNumWheels + 3*maxNumVehicles) >> 2;
+	const PxU32 wheelsBoundByteSize = maxNumVehicles*(baseByteSize + 63) + maxNumWheels4*blockByteSize;
+
+	//Every vehicle is also built from an archetype so it is never larger than the largest vehicle of any archetype.
+	PxU32 maxVehicleByteSize = 0;
+	for(PxU32 i=0;i<numArchetypes;i++)
+	{
+		const PxU32 numWheels = archetypes[i]->getNumWheels();
+		const PxU32 vehicleByteSize = 
+			PxMax(PxVehicleDrive4W::computeInstanceByteSize(numWheels,true), 
+			PxMax(PxVehicleDriveTank::computeInstanceByteSize(numWheels,true), PxVehicleNoDrive::computeInstanceByteSize(numWheels,true)));
+		maxVehicleByteSize = PxMax(maxVehicleByteSize, computeAlignedByteSize64(vehicleByteSize));
+	}
+	const PxU32 arenaByteSize = PxMin(wheelsBoundByteSize, maxNumVehicles*maxVehicleByteSize);
+
+	//Work out the byte size required.
+	const PxU32 headerByteSize = computeAlignedByteSize64(sizeof(PxVehicleFleet) + sizeof(PxVehicleWheelsSimData*)*numArchetypes + sizeof(PxVehicleWheels*)*maxNumVehicles);
+	PxU32 byteSize = headerByteSize;
+	for(PxU32 i=0;i<numArchetypes;i++)
+	{
+		byteSize += computeArchetypeByteSize(*archetypes[i]);
+	}
+	byteSize += arenaByteSize;
+
+	//Allocate the memory.
+	PxU8* ptr = (PxU8*)Ps::AlignedAllocator<64>().allocate(byteSize, __FILE__, __LINE__);
+	if(!ptr)
+	{
+		return NULL;
+	}
+	PxVehicleFleet* fleet = (PxVehicleFleet*)ptr;
+
+	//Patch up the pointers.
+	ptr += sizeof(PxVehicleFleet);
+	fleet->mArchetypes = (PxVehicleWheelsSimData**)ptr;
+	ptr += sizeof(PxVehicleWheelsSimData*)*numArchetypes;
+	fleet->mVehicles = (PxVehicleWheels**)ptr;
+	ptr = (PxU8*)fleet + headerByteSize;
+
+	//Copy the archetypes.
+	for(PxU32 i=0;i<numArchetypes;i++)
+	{
+		const PxVehicleWheelsSimData& src = *archetypes[i];
+		PxVehicleWheelsSimData* simData = (PxVehicleWheelsSimData*)ptr;
+		simData->mWheels4SimData = (PxVehicleWheels4SimData*)(ptr + sizeof(PxVehicleWheelsSimData));
+		simData->mNumWheels4 = src.mNumWheels4;
+		simData->mNumActiveWheels = src.mNumActiveWheels;
+		simData->mIsShared = 0;
+		for(PxU32 j=0;j<src.mNumWheels4;j++)
+		{
+			new(&simData->mWheels4SimData[j]) PxVehicleWheels4SimData();
+		}
+		new(&simData->mNormalisedLoadFilter) PxVehicleTireLoadFilterData();
+		*simData = src;
+		simData->mIsShared = 1;
+
+		fleet->mArchetypes[i] = simData;
+		ptr += computeArchetypeByteSize(src);
+	}
+
+	fleet->mArena = ptr;
+	fleet->mArenaByteSize = arenaByteSize;
+	fleet->mArenaUsedByteSize = 0;
+	fleet->mByteSize = byteSize;
+	fleet->mNumArchetypes = numArchetypes;
+	fleet->mNumVehicles = 0;
+	fleet->mMaxNumVehicles = maxNumVehicles;
+	fleet->mNumWheels = 0;
+	fleet->mMaxNumWheels = maxNumWheels;
+
+	//Finished.
+	return fleet;
+}
+
+void PxVehicleFleet::free()
+{
+	for(PxU32 i=0;i<mNumVehicles;i++)
+	{
+		PX_CHECK_AND_RETURN(0==mVehicles[i]->mOnConstraintReleaseCounter, "PxVehicleFleet::free - free all vehicles of the fleet and let their constraints be released before freeing the fleet");
+	}
+
+	Ps::AlignedAllocator<64>().deallocate(this);
+}
+
+PxU8* PxVehicleFleet::allocateVehicle(const PxU32 byteSize, const PxU32 numWheels)
+{
+	const PxU32 alignedByteSize = computeAlignedByteSize64(byteSize);
+	PX_CHECK_AND_RETURN_NULL(mNumVehicles<mMaxNumVehicles, "PxVehicleFleet - too many vehicles");
+	PX_CHECK_AND_RETURN_NULL((mNumWheels+numWheels)<=mMaxNumWheels, "PxVehicleFleet - too many wheels");
+	PX_CHECK_AND_RETURN_NULL((mArenaUsedByteSize+alignedByteSize)<=mArenaByteSize, "PxVehicleFleet - vehicle arena is full");
+
+	PxU8* ptr = mArena + mArenaUsedByteSize;
+	mArenaUsedByteSize += alignedByteSize;
+	mNumWheels += numWheels;
+	return ptr;
+}
+
+void PxVehicleFleet::addVehicle(PxVehicleWheels* veh)
+{
+	mVehicles[mNumVehicles] = veh;
+	mNumVehicles++;
+}
+
+PxVehicleDrive4W* PxVehicleFleet::createDrive4W
+(PxPhysics* physics, PxRigidDynamic* vehActor, 
+ const PxU32 archetype, const PxVehicleDriveSimData4W& driveData, 
+ const PxU32 numNonDrivenWheels)
+{
+	PX_CHECK_AND_RETURN_NULL(archetype<mNumArchetypes, "PxVehicleFleet::createDrive4W - illegal archetype");
+	const PxVehicleWheelsSimData& wheelsData = *mArchetypes[archetype];
+	const PxU32 numWheels = 4 + numNonDrivenWheels;
+	PX_CHECK_AND_RETURN_NULL(numWheels==wheelsData.getNumWheels(), "PxVehicleFleet::createDrive4W - archetype must have 4+numNonDrivenWheels wheels");
+
+	PxU8* ptr = allocateVehicle(PxVehicleDrive4W::computeInstanceByteSize(numWheels,true), numWheels);
+	if(!ptr)
+	{
+		return NULL;
+	}
+
+	PxVehicleDrive4W* veh = PxVehicleDrive4W::patchupInstance(ptr,numWheels,&wheelsData);
+	veh->mIsFleetVehicle = 1;
+	veh->setup(physics,vehActor,wheelsData,driveData,numNonDrivenWheels);
+	addVehicle(veh);
+	return veh;
+}
+
+PxVehicleDriveTank* PxVehicleFleet::createDriveTank
+(PxPhysics* physics, PxRigidDynamic* vehActor, 
+ const PxU32 archetype, const PxVehicleDriveSimData& driveData, 
+ const PxU32 numDrivenWheels)
+{
+	PX_CHECK_AND_RETURN_NULL(archetype<mNumArchetypes, "PxVehicleFleet::createDriveTank - illegal archetype");
+	const PxVehicleWheelsSimData& wheelsData = *mArchetypes[archetype];
+	PX_CHECK_AND_RETURN_NULL(numDrivenWheels==wheelsData.getNumWheels(), "PxVehicleFleet::createDriveTank - archetype must have numDrivenWheels wheels");
+
+	PxU8* ptr = allocateVehicle(PxVehicleDriveTank::computeInstanceByteSize(numDrivenWheels,true), numDrivenWheels);
+	if(!ptr)
+	{
+		return NULL;
+	}
+
+	PxVehicleDriveTank* veh = PxVehicleDriveTank::patchupInstance(ptr,numDrivenWheels,&wheelsData);
+	veh->mIsFleetVehicle = 1;
+	veh->setup(physics,vehActor,wheelsData,driveData,numDrivenWheels);
+	addVehicle(veh);
+	return veh;
+}
+
+PxVehicleNoDrive* PxVehicleFleet::createNoDrive(PxPhysics* physics, PxRigidDynamic* vehActor, const PxU32 archetype)
+{
+	PX_CHECK_AND_RETURN_NULL(archetype<mNumArchetypes, "PxVehicleFleet::createNoDrive - illegal archetype");
+	const PxVehicleWheelsSimData& wheelsData = *mArchetypes[archetype];
+	const PxU32 numWheels = wheelsData.getNumWheels();
+
+	PxU8* ptr = allocateVehicle(PxVehicleNoDrive::computeInstanceByteSize(numWheels,true), numWheels);
+	if(!ptr)
+	{
+		return NULL;
+	}
+
+	PxVehicleNoDrive* veh = PxVehicleNoDrive::patchupInstance(ptr,numWheels,&wheelsData);
+	veh->mIsFleetVehicle = 1;
+	veh->setup(physics,vehActor,wheelsData);
+	addVehicle(veh);
+	return veh;
+}
+
+} //namespace physx
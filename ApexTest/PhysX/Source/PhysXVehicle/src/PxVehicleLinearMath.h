@@ -49,7 +49,7 @@ public:
 	VectorN(const PxU32 size)
 		: mSize(size)
 	{
-		PX_ASSERT(mSize<MAX_VECTORN_SIZE);
+		PX_ASSERT(mSize<=MAX_VECTORN_SIZE);
 	}
 	~VectorN()
 	{
@@ -105,7 +105,7 @@ public:
 	MatrixNN(const PxU32 size)
 		: mSize(size)
 	{
-		PX_ASSERT(mSize<MAX_VECTORN_SIZE);
+		PX_ASSERT(mSize<=MAX_VECTORN_SIZE);
 	}
 	MatrixNN(const MatrixNN& src)
 	{
@@ -303,6 +303,44 @@ public:
 	}
 };
 
+//Solver for the implicit update of an engine driving n wheels through the clutch:
+//  d[i]*w[i] + a[i]*(G*x - we) = b[i]  for each wheel i, where x = sum_j c[j]*w[j] is the average wheel speed at the clutch
+//  -ae*x + de*we = be                  for the engine
+//Apart from the rank one coupling through x the wheel block is diagonal and the engine only borders it.
+//Eliminating the wheels leaves a scalar Schur complement for the clutch slip s=G*x-we, so the cost
+//is O(n) instead of the O(n^3) of building the dense matrix and using MatrixNNLUSolver.
+//For the drivetrain (ae=dt*K*G, de=1+dt*(K+damping), G*a[i]*c[i]>=0, d[i]>=1) the denominator
+//equals de + G*Q*(1+dt*damping) >= 1, so no pivoting is needed.
+class EnginePlusDrivenWheelsSolver
+{
+public:
+
+	static void solve
+		(const PxU32 numWheels, const PxF32* PX_RESTRICT d, const PxF32* PX_RESTRICT a, const PxF32* PX_RESTRICT c, const PxF32* PX_RESTRICT b, 
+		 const PxF32 G, const PxF32 ae, const PxF32 de, const PxF32 be,
+		 PxF32* PX_RESTRICT w, PxF32& we)
+	{
+		//x = P - Q*s with P=sum c[i]*b[i]/d[i] and Q=sum c[i]*a[i]/d[i].
+		PxF32 recipD[MAX_VECTORN_SIZE];
+		PxF32 P=0.0f;
+		PxF32 Q=0.0f;
+		for(PxU32 i=0;i<numWheels;i++)
+		{
+			recipD[i]=1.0f/d[i];
+			P+=c[i]*b[i]*recipD[i];
+			Q+=c[i]*a[i]*recipD[i];
+		}
+
+		//Substitute x into the engine row and the definition of s.
+		const PxF32 s=(de*G*P - ae*P - be)/(de*(1.0f + G*Q) - ae*Q);
+		we=G*P - s*(1.0f + G*Q);
+		for(PxU32 i=0;i<numWheels;i++)
+		{
+			w[i]=(b[i] - a[i]*s)*recipD[i];
+		}
+	}
+};
+
 
 #ifndef PX_DOXYGEN
 } // namespace physx
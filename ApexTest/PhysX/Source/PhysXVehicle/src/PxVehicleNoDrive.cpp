@@ -49,28 +49,30 @@ bool PxVehicleNoDrive::isValid() const
 	return true;
 }
 
-PxVehicleNoDrive* PxVehicleNoDrive::allocate(const PxU32 numWheels)
+PxU32 PxVehicleNoDrive::computeInstanceByteSize(const PxU32 numWheels, const bool sharedWheelsSimData)
 {
-	PX_CHECK_AND_RETURN_NULL(numWheels>0, "Cars with zero wheels are illegal");
-
-	//Compute the bytes needed.
 	const PxU32 numWheels4 = (((numWheels + 3) & ~3) >> 2);
 	const PxU32 inputByteSize = sizeof(PxReal)*numWheels4*4;
 	const PxU32 inputByteSize16 = (inputByteSize + 15) & ~15;
-	const PxU32 byteSize = sizeof(PxVehicleNoDrive) + 3*inputByteSize16 + PxVehicleWheels::computeByteSize(numWheels4);
+	return sizeof(PxVehicleNoDrive) + 3*inputByteSize16 + PxVehicleWheels::computeByteSize(numWheels4,sharedWheelsSimData);
+}
 
-	//Allocate the memory.
-	PxVehicleNoDrive* veh = (PxVehicleNoDrive*)PX_ALLOC(byteSize, PX_DEBUG_EXP("PxVehicleNoDrive"));
+PxVehicleNoDrive* PxVehicleNoDrive::patchupInstance(PxU8* ptr, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData)
+{
+	const PxU32 numWheels4 = (((numWheels + 3) & ~3) >> 2);
+	const PxU32 inputByteSize = sizeof(PxReal)*numWheels4*4;
+	const PxU32 inputByteSize16 = (inputByteSize + 15) & ~15;
+	PxVehicleNoDrive* veh = (PxVehicleNoDrive*)ptr;
 
 	//Patch up the pointers.
-	PxU8* ptr = (PxU8*)veh + sizeof(PxVehicleNoDrive);
+	ptr += sizeof(PxVehicleNoDrive);
 	veh->mSteerAngles = (PxReal*)ptr;
 	ptr+=inputByteSize16;
 	veh->mBrakeTorques = (PxReal*)ptr;
 	ptr+=inputByteSize16;
 	veh->mDriveTorques = (PxReal*)ptr;
 	ptr+=inputByteSize16;
-	PxVehicleWheels::patchupPointers(veh,ptr,numWheels4,numWheels);
+	PxVehicleWheels::patchupPointers(veh,ptr,numWheels4,numWheels,sharedWheelsSimData);
 
 	Ps::memZero(veh->mSteerAngles, 3*inputByteSize16);
 
@@ -80,6 +82,20 @@ PxVehicleNoDrive* PxVehicleNoDrive::allocate(const PxU32 numWheels)
 	return veh;
 }
 
+PxVehicleNoDrive* PxVehicleNoDrive::allocate(const PxU32 numWheels)
+{
+	PX_CHECK_AND_RETURN_NULL(numWheels>0, "Cars with zero wheels are illegal");
+
+	//Compute the bytes needed.
+	const PxU32 byteSize = computeInstanceByteSize(numWheels,false);
+
+	//Allocate the memory.
+	PxU8* ptr = (PxU8*)PX_ALLOC(byteSize, PX_DEBUG_EXP("PxVehicleNoDrive"));
+
+	//Patch up the pointers.
+	return patchupInstance(ptr,numWheels,NULL);
+}
+
 void PxVehicleNoDrive::free()
 {
 	PxVehicleWheels::free();
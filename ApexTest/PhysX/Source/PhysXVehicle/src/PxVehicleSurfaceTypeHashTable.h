@@ -0,0 +1,170 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#ifndef PX_VEHICLE_SURFACE_TYPE_HASH_TABLE_H
+#define PX_VEHICLE_SURFACE_TYPE_HASH_TABLE_H
+/** \addtogroup vehicle
+  @{
+*/
+
+#include "PxVehicleTireFriction.h"
+#include "foundation/PxAssert.h"
+
+#ifndef PX_DOXYGEN
+namespace physx
+{
+#endif
+
+//Collision-free hash table from PxMaterial to drivable surface type.
+//The table is built once by PxVehicleDrivableSurfaceToTireFrictionPairs::setup and lives in the same allocation.
+//Keys are spread over buckets by their pointer hash, each bucket stores a displacement that was chosen so that
+//all keys of all buckets land in different slots (hash and displace).  A lookup is one bucket read, one slot read
+//and one compare, without probing or chains.
+class VehicleSurfaceTypeHashTable
+{
+public:
+
+	VehicleSurfaceTypeHashTable(const PxVehicleDrivableSurfaceToTireFrictionPairs& pairs)
+		: mNumEntries(pairs.mNumSurfaceTypes),
+		  mMaterials(pairs.mDrivableSurfaceMaterials),
+		  mDrivableSurfaceTypes(pairs.mDrivableSurfaceTypes),
+		  mSlotMaterials(pairs.mHashMaterials),
+		  mSlotSurfaceTypes(pairs.mHashSurfaceTypes),
+		  mDisplacements(pairs.mHashDisplacements),
+		  mNumSlotBits(pairs.mHashNumSlotBits),
+		  mBucketMask(computeNumBuckets(pairs.mHashNumSlotBits)-1)
+	{
+	}
+	~VehicleSurfaceTypeHashTable()
+	{
+	}
+
+	PX_FORCE_INLINE PxU32 get(const PxMaterial* const key) const 
+	{
+		PX_ASSERT(key);
+		if(0==mNumSlotBits)
+		{
+			return search(key);
+		}
+		const PxU32 hash=computeHash(key);
+		const PxU32 slot=computeSlot(hash,mDisplacements[hash & mBucketMask],mNumSlotBits);
+		return (key==mSlotMaterials[slot]) ? mSlotSurfaceTypes[slot] : 0;
+	}
+
+	//Look up four materials at once, null materials get surface type 0.
+	//The hashes are computed up front so the four table reads don't wait on each other.
+	PX_FORCE_INLINE void get4(const PxMaterial* const* PX_RESTRICT keys, PxU32* PX_RESTRICT surfaceTypes) const 
+	{
+		if(0==mNumSlotBits)
+		{
+			for(PxU32 i=0;i<4;i++)
+			{
+				surfaceTypes[i]=keys[i] ? search(keys[i]) : 0;
+			}
+			return;
+		}
+
+		const PxU32 hash0=computeHash(keys[0]);
+		const PxU32 hash1=computeHash(keys[1]);
+		const PxU32 hash2=computeHash(keys[2]);
+		const PxU32 hash3=computeHash(keys[3]);
+		const PxU32 slot0=computeSlot(hash0,mDisplacements[hash0 & mBucketMask],mNumSlotBits);
+		const PxU32 slot1=computeSlot(hash1,mDisplacements[hash1 & mBucketMask],mNumSlotBits);
+		const PxU32 slot2=computeSlot(hash2,mDisplacements[hash2 & mBucketMask],mNumSlotBits);
+		const PxU32 slot3=computeSlot(hash3,mDisplacements[hash3 & mBucketMask],mNumSlotBits);
+		//Empty slots hold a null material so a null key can only match an empty slot, which stores surface type 0.
+		surfaceTypes[0]=(keys[0]==mSlotMaterials[slot0]) ? mSlotSurfaceTypes[slot0] : 0;
+		surfaceTypes[1]=(keys[1]==mSlotMaterials[slot1]) ? mSlotSurfaceTypes[slot1] : 0;
+		surfaceTypes[2]=(keys[2]==mSlotMaterials[slot2]) ? mSlotSurfaceTypes[slot2] : 0;
+		surfaceTypes[3]=(keys[3]==mSlotMaterials[slot3]) ? mSlotSurfaceTypes[slot3] : 0;
+	}
+
+	//Number of slots for a table that holds up to maxNumSurfaceTypes materials at a load factor of at most one half.
+	static PX_FORCE_INLINE PxU32 computeNumSlotBits(const PxU32 maxNumSurfaceTypes)
+	{
+		PxU32 numSlotBits=1;
+		while((1u << numSlotBits) < 2*maxNumSurfaceTypes)
+		{
+			numSlotBits++;
+		}
+		return numSlotBits;
+	}
+
+	//Four slots per bucket, so on average half a key per bucket.
+	static PX_FORCE_INLINE PxU32 computeNumBuckets(const PxU32 numSlotBits)
+	{
+		return numSlotBits > 2 ? (1u << (numSlotBits-2)) : 1;
+	}
+
+	//Fill the slots and displacements of pairs from its materials and surface types.
+	static void build(PxVehicleDrivableSurfaceToTireFrictionPairs& pairs);
+
+private:
+
+	PxU32 mNumEntries; 
+	const PxMaterial* const* mMaterials;
+	const PxVehicleDrivableSurfaceType* mDrivableSurfaceTypes;
+
+	const PxMaterial* const* mSlotMaterials;
+	const PxU32* mSlotSurfaceTypes;
+	const PxU16* mDisplacements;
+	PxU32 mNumSlotBits;
+	PxU32 mBucketMask;
+
+	static PX_FORCE_INLINE PxU32 computeHash(const PxMaterial* const key) 
+	{
+		const PxU64 ptr=(PxU64)(size_t)key;
+		return (PxU32)((ptr*PxU64(0x9e3779b97f4a7c15ULL)) >> 32);
+	}
+
+	static PX_FORCE_INLINE PxU32 computeSlot(const PxU32 hash, const PxU32 displacement, const PxU32 numSlotBits)
+	{
+		return ((hash ^ (displacement*0x9e3779b9u))*0x85ebca6bu) >> (32-numSlotBits);
+	}
+
+	//Fallback for the unlikely case that build found no collision-free displacements.
+	PxU32 search(const PxMaterial* const key) const
+	{
+		for(PxU32 i=mNumEntries;i>0;i--)
+		{
+			if(key==mMaterials[i-1])
+			{
+				return mDrivableSurfaceTypes[i-1].mType;
+			}
+		}
+		return 0;
+	}
+};
+
+#ifndef PX_DOXYGEN
+} // namespace physx
+#endif
+
+/** @} */
+#endif //PX_VEHICLE_SURFACE_TYPE_HASH_TABLE_H
@@ -81,7 +81,7 @@ public:
 	virtual void			onConstraintRelease()
 	{
 		mVehicle->mOnConstraintReleaseCounter--;
-		if(0==mVehicle->mOnConstraintReleaseCounter)
+		if(0==mVehicle->mOnConstraintReleaseCounter && !mVehicle->mIsFleetVehicle)
 		{
 			PX_FREE(mVehicle);
 		}
@@ -28,6 +28,7 @@
 // Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
 
 #include "PxVehicleTireFriction.h"
+#include "PxVehicleSurfaceTypeHashTable.h"
 #include "PxPhysics.h"
 #include "CmPhysXCommon.h"
 #include "PsFoundation.h"
@@ -41,10 +42,128 @@ PX_FORCE_INLINE PxU32 computeByteSize(const PxU32 maxNumTireTypes, const PxU32 m
 	PxU32 byteSize = ((sizeof(PxU32)*(maxNumTireTypes*maxNumSurfaceTypes) + 15) & ~15);
 	byteSize += ((sizeof(PxMaterial*)*maxNumSurfaceTypes + 15) & ~15);
 	byteSize += ((sizeof(PxVehicleDrivableSurfaceType)*maxNumSurfaceTypes + 15) & ~15);
+	const PxU32 numSlots = (1u << VehicleSurfaceTypeHashTable::computeNumSlotBits(maxNumSurfaceTypes));
+	const PxU32 numBuckets = VehicleSurfaceTypeHashTable::computeNumBuckets(VehicleSurfaceTypeHashTable::computeNumSlotBits(maxNumSurfaceTypes));
+	byteSize += ((sizeof(PxMaterial*)*numSlots + 15) & ~15);
+	byteSize += ((sizeof(PxU32)*numSlots + 15) & ~15);
+	byteSize += ((sizeof(PxU16)*numBuckets + 15) & ~15);
 	byteSize += ((sizeof(PxVehicleDrivableSurfaceToTireFrictionPairs) + 15) & ~ 15);
 	return byteSize;
 }
 
+void VehicleSurfaceTypeHashTable::build(PxVehicleDrivableSurfaceToTireFrictionPairs& pairs)
+{
+	const PxU32 numSlotBits = computeNumSlotBits(pairs.mMaxNumSurfaceTypes);
+	const PxU32 numSlots = (1u << numSlotBits);
+	const PxU32 numBuckets = computeNumBuckets(numSlotBits);
+	const PxU32 numEntries = pairs.mNumSurfaceTypes;
+	PX_ASSERT(numEntries <= PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES);
+	PX_ASSERT(numBuckets <= PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES);
+
+	//Hash each material once. If a material appears more than once the last entry wins, as it always did.
+	PxU32 hashes[PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES];
+	PxU32 keys[PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES];
+	PxU32 numKeys = 0;
+	for(PxU32 i = 0; i < numEntries; i++)
+	{
+		const PxMaterial* material = pairs.mDrivableSurfaceMaterials[i];
+		bool isLast = (NULL != material);
+		for(PxU32 j = i + 1; j < numEntries && isLast; j++)
+		{
+			isLast = (material != pairs.mDrivableSurfaceMaterials[j]);
+		}
+		if(isLast)
+		{
+			hashes[numKeys] = computeHash(material);
+			keys[numKeys] = i;
+			numKeys++;
+		}
+	}
+
+	//Sort the keys by bucket and the buckets by size, the crowded buckets pick their displacements first.
+	PxU32 bucketSizes[PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES];
+	PxU32 bucketStarts[PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES + 1];
+	PxU32 bucketKeys[PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES];
+	PxU32 bucketOrder[PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES];
+	Ps::memZero(bucketSizes, sizeof(PxU32)*numBuckets);
+	for(PxU32 i = 0; i < numKeys; i++)
+	{
+		bucketSizes[hashes[i] & (numBuckets - 1)]++;
+	}
+	bucketStarts[0] = 0;
+	for(PxU32 b = 0; b < numBuckets; b++)
+	{
+		bucketStarts[b + 1] = bucketStarts[b] + bucketSizes[b];
+		bucketOrder[b] = b;
+	}
+	for(PxU32 i = 0; i < numKeys; i++)
+	{
+		const PxU32 b = hashes[i] & (numBuckets - 1);
+		bucketKeys[bucketStarts[b + 1] - bucketSizes[b]] = i;
+		bucketSizes[b]--;
+	}
+	for(PxU32 b = 0; b < numBuckets; b++)
+	{
+		bucketSizes[b] = bucketStarts[b + 1] - bucketStarts[b];
+	}
+	for(PxU32 i = 1; i < numBuckets; i++)
+	{
+		const PxU32 b = bucketOrder[i];
+		PxU32 j = i;
+		for(; j > 0 && bucketSizes[bucketOrder[j - 1]] < bucketSizes[b]; j--)
+		{
+			bucketOrder[j] = bucketOrder[j - 1];
+		}
+		bucketOrder[j] = b;
+	}
+
+	//Find a displacement for each bucket that moves all of its keys to free slots.
+	for(PxU32 i = 0; i < numBuckets && bucketSizes[bucketOrder[i]] > 0; i++)
+	{
+		const PxU32 b = bucketOrder[i];
+		const PxU32* members = bucketKeys + bucketStarts[b];
+		const PxU32 numMembers = bucketSizes[b];
+
+		PxU32 displacement = 0;
+		for(; displacement <= 0xffff; displacement++)
+		{
+			PxU32 slots[PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES];
+			bool isFree = true;
+			for(PxU32 k = 0; k < numMembers && isFree; k++)
+			{
+				slots[k] = computeSlot(hashes[members[k]], displacement, numSlotBits);
+				isFree = (NULL == pairs.mHashMaterials[slots[k]]);
+				for(PxU32 l = 0; l < k && isFree; l++)
+				{
+					isFree = (slots[l] != slots[k]);
+				}
+			}
+			if(isFree)
+			{
+				for(PxU32 k = 0; k < numMembers; k++)
+				{
+					const PxU32 entry = keys[members[k]];
+					pairs.mHashMaterials[slots[k]] = pairs.mDrivableSurfaceMaterials[entry];
+					pairs.mHashSurfaceTypes[slots[k]] = pairs.mDrivableSurfaceTypes[entry].mType;
+				}
+				pairs.mHashDisplacements[b] = (PxU16)displacement;
+				break;
+			}
+		}
+
+		if(displacement > 0xffff)
+		{
+			//Only possible if two materials share a hash, lookups fall back to searching the materials.
+			Ps::memZero(pairs.mHashMaterials, sizeof(PxMaterial*)*numSlots);
+			Ps::memZero(pairs.mHashSurfaceTypes, sizeof(PxU32)*numSlots);
+			pairs.mHashNumSlotBits = 0;
+			return;
+		}
+	}
+
+	pairs.mHashNumSlotBits = numSlotBits;
+}
+
 PxVehicleDrivableSurfaceToTireFrictionPairs* PxVehicleDrivableSurfaceToTireFrictionPairs::allocate
 (const PxU32 maxNumTireTypes, const PxU32 maxNumSurfaceTypes)
 {
@@ -58,6 +177,10 @@ PxVehicleDrivableSurfaceToTireFrictionPairs* PxVehicleDrivableSurfaceToTireFrict
 	pairs->mPairs = NULL;
 	pairs->mDrivableSurfaceMaterials = NULL;
 	pairs->mDrivableSurfaceTypes = NULL;
+	pairs->mHashMaterials = NULL;
+	pairs->mHashSurfaceTypes = NULL;
+	pairs->mHashDisplacements = NULL;
+	pairs->mHashNumSlotBits = 0;
 	pairs->mNumTireTypes = 0;
 	pairs->mMaxNumTireTypes = maxNumTireTypes;
 	pairs->mNumSurfaceTypes = 0;
@@ -90,6 +213,13 @@ void PxVehicleDrivableSurfaceToTireFrictionPairs::setup
 	ptr += ((sizeof(PxMaterial*)*numSurfaceTypes + 15) & ~15);
 	mDrivableSurfaceTypes = (PxVehicleDrivableSurfaceType*)ptr;
 	ptr += ((sizeof(PxVehicleDrivableSurfaceType)*numSurfaceTypes +15) & ~15);
+	const PxU32 numSlotBits = VehicleSurfaceTypeHashTable::computeNumSlotBits(maxNumSurfaceTypes);
+	mHashMaterials = (const PxMaterial**)ptr;
+	ptr += ((sizeof(PxMaterial*)*(1u << numSlotBits) + 15) & ~15);
+	mHashSurfaceTypes = (PxU32*)ptr;
+	ptr += ((sizeof(PxU32)*(1u << numSlotBits) + 15) & ~15);
+	mHashDisplacements = (PxU16*)ptr;
+	ptr += ((sizeof(PxU16)*VehicleSurfaceTypeHashTable::computeNumBuckets(numSlotBits) + 15) & ~15);
 
 	for(PxU32 i=0;i<numSurfaceTypes;i++)
 	{
@@ -103,6 +233,8 @@ void PxVehicleDrivableSurfaceToTireFrictionPairs::setup
 
 	pairs->mNumTireTypes=numTireTypes;
 	pairs->mNumSurfaceTypes=numSurfaceTypes;
+
+	VehicleSurfaceTypeHashTable::build(*pairs);
 }
 
 void PxVehicleDrivableSurfaceToTireFrictionPairs::release()
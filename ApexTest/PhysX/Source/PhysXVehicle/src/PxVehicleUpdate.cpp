@@ -38,9 +38,11 @@
 #include "PxVehicleTireFriction.h"
 #include "PxVehicleUtilTelemetry.h"
 #include "PxVehicleLinearMath.h"
+#include "PxVehicleSurfaceTypeHashTable.h"
 #include "PxQuat.h"
 #include "PxShape.h"
 #include "PxRigidDynamic.h"
+#include "PxRigidStatic.h"
 #include "PxBatchQuery.h"
 #include "PxHeightField.h"
 #include "PxTriangleMesh.h"
@@ -52,7 +54,7 @@
 #include "PxRigidBodyExt.h"
 #include "PsFoundation.h"
 #include "PsUtilities.h"
-#include "CmBitMap.h"
+#include "CmPhysXCommon.h"
 
 #if defined (PX_PSP2)
 #include <stdint.h> // intptr_t
@@ -295,144 +297,6 @@ PX_FORCE_INLINE void updateGraphDataNormTireAligningMoment(const PxU32 startInde
 
 #endif //DEBUG_VEHICLE_ON
 
-//It would be great to use PsHashSet for the hash table of PxMaterials but
-//PsHashSet will never, ever work on spu so this will need to do instead.
-//Perf isn't really critical so this will do in the meantime.
-//It is probably wasteful to compute the hash table each update
-//but this is really not an expensive operation so keeping the api as 
-//simple as possible wins out at the cost of a relatively very small number of wasted cycles.
-class VehicleSurfaceTypeHashTable
-{
-public:
-
-	VehicleSurfaceTypeHashTable(const PxVehicleDrivableSurfaceToTireFrictionPairs& pairs)
-		: mNumEntries(pairs.mNumSurfaceTypes),
- 	      mMaterials(pairs.mDrivableSurfaceMaterials),
-	      mDrivableSurfaceTypes(pairs.mDrivableSurfaceTypes)
-	{
-		for(PxU32 i=0;i<eHASH_SIZE;i++)
-		{
-			mHeadIds[i]=PX_MAX_U32;
-		}
-		for(PxU32 i=0;i<eMAX_NUM_KEYS;i++)
-		{
-			mNextIds[i]=PX_MAX_U32;
-		}
-
-		if(mNumEntries>0)
-		{
-			//Compute the number of bits to right-shift that gives the maximum number of unique hashes.
-			//Keep searching until we find either a set of completely unique hashes or a peak count of unique hashes.
-			PxU32 prevShift=0;
-			PxU32 shift=2;
-			PxU32 prevNumUniqueHashes=0;
-			PxU32 currNumUniqueHashes=0;
-			while( ((currNumUniqueHashes=computeNumUniqueHashes(shift)) > prevNumUniqueHashes) && currNumUniqueHashes!=mNumEntries)
-			{
-				prevNumUniqueHashes=currNumUniqueHashes;
-				prevShift=shift;
-				shift = (shift << 1);
-			}
-			if(currNumUniqueHashes!=mNumEntries)
-			{
-				//Stopped searching because we have gone past the peak number of unqiue hashes.
-				mShift = prevShift;
-			}
-			else
-			{
-				//Stopped searching because we found a unique hash for each key.
-				mShift = shift;
-			}
-
-			//Compute the hash values with the optimum shift.
-			for(PxU32 i=0;i<mNumEntries;i++)
-			{
-				const PxMaterial* const material=mMaterials[i];
-				const PxU32 hash=computeHash(material,mShift);
-				if(PX_MAX_U32==mHeadIds[hash])
-				{
-					mNextIds[i]=PX_MAX_U32;
-					mHeadIds[hash]=i;
-				}
-				else
-				{
-					mNextIds[i]=mHeadIds[hash];
-					mHeadIds[hash]=i;
-				}
-			}
-		}
-	}
-	~VehicleSurfaceTypeHashTable()
-	{
-	}
-
-	PX_FORCE_INLINE PxU32 get(const PxMaterial* const key) const 
-	{
-		PX_ASSERT(key);
-		const PxU32 hash=computeHash(key, mShift);
-		PxU32 id=mHeadIds[hash];
-		while(PX_MAX_U32!=id)
-		{
-			const PxMaterial* const mat=mMaterials[id];
-			if(key==mat)
-			{
-				return mDrivableSurfaceTypes[id].mType;
-			}
-			id=mNextIds[id];
-		}
-
-		return 0;
-	}
-
-private:
-
-	PxU32 mNumEntries; 
-	const PxMaterial* const* mMaterials;
-	const PxVehicleDrivableSurfaceType* mDrivableSurfaceTypes;
-
-	static PX_FORCE_INLINE PxU32 computeHash(const PxMaterial* const key, const PxU32 shift) 
-	{
-		const uintptr_t ptr = (((uintptr_t) key) >> shift);
-		const uintptr_t hash = (ptr & (eHASH_SIZE-1));
-		return (PxU32)hash;
-	}
-
-	PxU32 computeNumUniqueHashes(const PxU32 shift) const
-	{
-		PxU32 words[eHASH_SIZE >>5];
-		PxU8* bitmapBuffer[sizeof(Cm::BitMap)];
-		Cm::BitMap* bitmap=(Cm::BitMap*)bitmapBuffer;
-		bitmap->setWords(words, eHASH_SIZE >>5);
-
-		PxU32 numUniqueHashes=0;
-		Ps::memZero(words, sizeof(PxU32)*(eHASH_SIZE >>5));
-		for(PxU32 i=0;i<mNumEntries;i++)
-		{
-			const PxMaterial* const material=mMaterials[i];
-			const PxU32 hash=computeHash(material, shift);
-			if(!bitmap->test(hash))
-			{
-				bitmap->set(hash);
-				numUniqueHashes++;
-			}
-		}
-		return numUniqueHashes;
-	}
-
-	enum
-	{
-		eHASH_SIZE=PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES
-	};
-	PxU32 mHeadIds[eHASH_SIZE];
-	enum
-	{
-		eMAX_NUM_KEYS=PxVehicleDrivableSurfaceToTireFrictionPairs::eMAX_NUM_SURFACE_TYPES
-	};
-	PxU32 mNextIds[eMAX_NUM_KEYS];
-
-	PxU32 mShift;
-};
-
 void addForceToBody(const PxVec3& force, const PxF32 timeStep, PxRigidDynamic* actor)
 {
 	const PxF32 mass = actor->getMass();
@@ -1236,9 +1100,6 @@ void processSuspTireWheels
 	//Compute the right direction for later.
 	const PxVec3 latDir=carChassisTrnsfm.rotate(gRight);
 
-	//Hash table for quick lookup of drivable surface type from material
-	VehicleSurfaceTypeHashTable surfaceTypeHashTable(*frictionPairs);
-
 	//Arrays of hits (need to mask out wheels that had no raycast).
 	PxU32 numHits4[4]={0,0,0,0};
 	PxRaycastHit* hits4[4]={NULL,NULL,NULL,NULL};
@@ -1251,6 +1112,20 @@ void processSuspTireWheels
 		}
 	}
 
+	//Drivable surface types of all four wheels from the table prebuilt by the friction pairs.
+	PxMaterial* materials4[4]={NULL,NULL,NULL,NULL};
+	for(PxU32 i=0;i<4;i++)
+	{
+		if(numHits4[i]>0)
+		{
+			materials4[i]=hits4[i][0].shape->getMaterialFromInternalFaceIndex(hits4[i][0].faceIndex);
+			PX_CHECK_MSG(materials4[i], "material is null ptr");
+		}
+	}
+	const VehicleSurfaceTypeHashTable surfaceTypeHashTable(*frictionPairs);
+	PxU32 surfaceTypes4[4];
+	surfaceTypeHashTable.get4(materials4,surfaceTypes4);
+
 	PxF32 newLowForwardSpeedTimers[4];
 	for(PxU32 i=0;i<4;i++)
 	{
@@ -1280,18 +1155,8 @@ void processSuspTireWheels
 
 			const PxVec3 hitPos=hits[0].impact;
 			const PxVec3 hitNorm=hits[0].normal;
-			PxMaterial* material = hits[0].shape->getMaterialFromInternalFaceIndex(hits[0].faceIndex);
-			tireSurfaceMaterials[i]=material;
-			PxU32 surfaceType;
-			if(NULL!=material)
-			{
-				surfaceType=surfaceTypeHashTable.get(material);
-			}
-			else
-			{
-				PX_CHECK_MSG(material, "material is null ptr");
-				surfaceType=0;
-			}
+			tireSurfaceMaterials[i]=materials4[i];
+			const PxU32 surfaceType=surfaceTypes4[i];
 
 			//Get the tire type.
 			const PxU32 tireType=vehWheels4SimData.getTireData(i).mType;
@@ -1616,6 +1481,30 @@ bool isValid(const MatrixNN& A, const VectorN& b, const VectorN& result)
 	const PxF32 error=PxSqrt(rLength/(bLength+1e-5f));
 	return (error<1e-5f);
 }
+
+//Dense form of the system solved by EnginePlusDrivenWheelsSolver, only used to check its results.
+void computeEnginePlusDrivenWheelsMatrix
+(const PxU32 numWheels, const PxF32* PX_RESTRICT d, const PxF32* PX_RESTRICT a, const PxF32* PX_RESTRICT c, const PxF32* PX_RESTRICT b, 
+ const PxF32 G, const PxF32 ae, const PxF32 de, const PxF32 be, 
+ MatrixNN& M, VectorN& rhs)
+{
+	for(PxU32 i=0;i<numWheels;i++)
+	{
+		for(PxU32 j=0;j<numWheels;j++)
+		{
+			M.set(i,j,a[i]*G*c[j]);
+		}
+		M.set(i,i,d[i]+a[i]*G*c[i]);
+		M.set(i,numWheels,-a[i]);
+		rhs[i]=b[i];
+	}
+	for(PxU32 j=0;j<numWheels;j++)
+	{
+		M.set(numWheels,j,-ae*c[j]);
+	}
+	M.set(numWheels,numWheels,de);
+	rhs[numWheels]=be;
+}
 #endif
 
 void solveDrive4WInternaDynamicsEnginePlusDrivenWheels
@@ -1629,10 +1518,6 @@ void solveDrive4WInternaDynamicsEnginePlusDrivenWheels
  PxVehicleDriveDynData& vehCore, PxVehicleWheels4DynData& vehSuspWheelTire4)
 {
 	const PxF32 KG=K*G;
-	const PxF32 KGG=K*G*G;
-
-	MatrixNN A(4+1);
-	VectorN b(4+1);
 
 	const PxVehicleEngineData& engineData=vehCoreSimData.getEngineData();
 
@@ -1640,40 +1525,40 @@ void solveDrive4WInternaDynamicsEnginePlusDrivenWheels
 	const PxF32 engineOmega=vehCore.mEnginespeed;
 
 	//Wheels.
+	PxF32 d[4];
+	PxF32 a[4];
+	PxF32 b[4];
+	for(PxU32 i=0;i<4;i++)
 	{
-		for(PxU32 i=0;i<4;i++)
-		{
-			const PxF32 dt=subTimestep*vehSuspWheelTire4SimData.getWheelData(i).getRecipMOI();
-			const PxF32 R=diffTorqueRatios[i];
-			const PxF32 dtKGGR=dt*KGG*R;
-			A.set(i,0,dtKGGR*aveWheelSpeedContributions[0]);
-			A.set(i,1,dtKGGR*aveWheelSpeedContributions[1]);
-			A.set(i,2,dtKGGR*aveWheelSpeedContributions[2]);
-			A.set(i,3,dtKGGR*aveWheelSpeedContributions[3]);
-			A.set(i,i,1.0f+dtKGGR*aveWheelSpeedContributions[i]+dt*vehSuspWheelTire4SimData.getWheelData(i).mDampingRate);
-			A.set(i,4,-dt*KG*R);
-			b[i] = wheelSpeeds[i] + dt*(brakeTorques[i]+tireTorques[i]);
-		}
+		const PxF32 dt=subTimestep*vehSuspWheelTire4SimData.getWheelData(i).getRecipMOI();
+		const PxF32 R=diffTorqueRatios[i];
+		d[i]=1.0f+dt*vehSuspWheelTire4SimData.getWheelData(i).mDampingRate;
+		a[i]=dt*KG*R;
+		b[i]=wheelSpeeds[i] + dt*(brakeTorques[i]+tireTorques[i]);
 	}
 
 	//Engine.
+	const PxF32 dt=subTimestep;
+	const PxF32 ae=dt*KG;
+	const PxF32 de=1.0f + dt*(K+engineDampingRate);
+	const PxF32 be=engineOmega + dt*engineDriveTorque;
+
+	//Solve Aw=b, A only couples each wheel to the engine through the clutch.
+	PxF32 result[4+1];
+	EnginePlusDrivenWheelsSolver::solve(4,d,a,aveWheelSpeedContributions,b,G,ae,de,be,result,result[4]);
+#ifndef NDEBUG
 	{
-		const PxF32 dt=subTimestep;
-		const PxF32 dtKG=dt*K*G;
-		A.set(4,0,-dtKG*aveWheelSpeedContributions[0]);
-		A.set(4,1,-dtKG*aveWheelSpeedContributions[1]);
-		A.set(4,2,-dtKG*aveWheelSpeedContributions[2]);
-		A.set(4,3,-dtKG*aveWheelSpeedContributions[3]);
-		A.set(4,4,1.0f + dt*(K+engineDampingRate));
-		b[4] = engineOmega + dt*engineDriveTorque;
+		MatrixNN A(4+1);
+		VectorN rhs(4+1);
+		VectorN x(4+1);
+		computeEnginePlusDrivenWheelsMatrix(4,d,a,aveWheelSpeedContributions,b,G,ae,de,be,A,rhs);
+		for(PxU32 i=0;i<4+1;i++)
+		{
+			x[i]=result[i];
+		}
+		PX_ASSERT(isValid(A,rhs,x));
 	}
-
-	//Solve Aw=b
-	VectorN result(4+1);
-	MatrixNNLUSolver solver;
-	solver.decomposeLU(A);
-	solver.solve(b,result);
-	PX_ASSERT(isValid(A,b,result));
+#endif
 
 	//Check for sanity in the resultant internal rotation speeds.
 	//If the brakes are on and the wheels have switched direction then lock them at zero.
@@ -1703,7 +1588,6 @@ void solveTankInternaDynamicsEnginePlusDrivenWheels
  const PxVehicleDriveSimData& driveSimData, PxVehicleDriveDynData& driveDynData)
 {
 	const PxF32 KG=K*G;
-	const PxF32 KGG=K*G*G;
 
 	//Rearrange data in a single array rather than scattered in blocks of 4.
 	//This makes it easier later on.
@@ -1754,108 +1638,129 @@ void solveTankInternaDynamicsEnginePlusDrivenWheels
 	const PxF32 wheelRadius0=wheels4SimDatas[0].getWheelData(0).mRadius;
 	const PxF32 wheelRadius1=wheels4SimDatas[0].getWheelData(1).mRadius;
 
-	//Matrix M and rhs vector b that we use to solve Mw=b.
-	MatrixNN M(numActiveWheels+1);
-	VectorN b(numActiveWheels+1);
+	//Wheel and engine terms of the system Mw=b, see EnginePlusDrivenWheelsSolver for its form.
+	//The gearing of each track folds into the wheel coupling and the clutch contribution.
+	PxF32 d[PX_MAX_NUM_WHEELS];
+	PxF32 a[PX_MAX_NUM_WHEELS];
+	PxF32 c[PX_MAX_NUM_WHEELS];
+	PxF32 b[PX_MAX_NUM_WHEELS];
 
 	//Wheels.
+	for(PxU32 i=0;i<numActiveWheels;i++)
 	{
-		for(PxU32 i=0;i<numActiveWheels;i++)
-		{
-			const PxF32 dt=subTimestep*recipMOI[i];
-			const PxF32 R=diffTorqueRatios[i];
-			const PxF32 g=wheelGearings[i];
-			const PxF32 dtKGGRg=dt*KGG*R*g;
-			for(PxU32 j=0;j<numActiveWheels;j++)
-			{
-				M.set(i,j,dtKGGRg*aveWheelSpeedContributions[j]*wheelGearings[j]);
-			}
-			M.set(i,i,1.0f+dtKGGRg*aveWheelSpeedContributions[i]*wheelGearings[i]+dt*dampingRates[i]);
-			M.set(i,numActiveWheels,-dt*KG*R*g);
-			b[i] = wheelSpeeds[i] + dt*(brakeTorques[i]+tireTorques[i]);
-		}
+		const PxF32 dt=subTimestep*recipMOI[i];
+		const PxF32 R=diffTorqueRatios[i];
+		const PxF32 g=wheelGearings[i];
+		d[i]=1.0f+dt*dampingRates[i];
+		a[i]=dt*KG*R*g;
+		c[i]=aveWheelSpeedContributions[i]*g;
+		b[i]=wheelSpeeds[i] + dt*(brakeTorques[i]+tireTorques[i]);
 	}
 
 	//Engine.
-	{
-		//const PxVehicleEngineData& engineData=driveSimData.getEngineData();
-		const PxF32 engineOmega=driveDynData.mEnginespeed;
-
-		const PxF32 dt=subTimestep;
-		const PxF32 dtKG=dt*K*G;
-		for(PxU32 i=0;i<numActiveWheels;i++)
-		{
-			M.set(numActiveWheels,i,-dtKG*aveWheelSpeedContributions[i]*wheelGearings[i]);
-		}
-		M.set(numActiveWheels,numActiveWheels,1.0f + dt*(K+engineDampingRate));
-		b[numActiveWheels] = engineOmega + dt*engineDriveTorque;
-	}
+	const PxF32 engineOmega=driveDynData.mEnginespeed;
+	const PxF32 dt=subTimestep;
+	const PxF32 ae=dt*KG;
+	const PxF32 de=1.0f + dt*(K+engineDampingRate);
+	const PxF32 be=engineOmega + dt*engineDriveTorque;
 
 	//Now apply the constraints that all the odd numbers are equal and all the even numbers are equal.
-	//ie w2,w4,w6 are all equal to w0 and w3,w5,w7 are all equal to w1.
+	//ie w2,w4,w6 are all equal to w0 and w3,w5,w7 are all equal to w1 (scaled by the wheel radii).
 	//That leaves (4*N+1) equations but only 3 unknowns: two wheels speeds and the engine speed.
-	//Substitute these extra constraints into the matrix.
-	MatrixNN A(numActiveWheels+1);
-	for(PxU32 i=0;i<numActiveWheels+1;i++)
+	//Substituting w[j]=rho[j]*w0 or w[j]=rho[j]*w1 into M gives a matrix A with 3 columns.  The dense part of M 
+	//is G*a*c^T so each row of A only needs the sums of c[j]*rho[j] over the even and the odd wheels.
+	PxF32 rho[PX_MAX_NUM_WHEELS];
+	rho[0]=1.0f;
+	rho[1]=1.0f;
+	PxF32 cRho0=c[0];
+	PxF32 cRho1=c[1];
+	for(PxU32 j=2;j<numActiveWheels;j+=2)
 	{
-		PxF32 sum0=M.get(i,0+0);
-		PxF32 sum1=M.get(i,0+1);
-		for(PxU32 j=2;j<numActiveWheels;j+=2)
-		{
-			sum0+=M.get(i,j+0)*wheelRadius0*wheelRecipRadii[j+0];
-			sum1+=M.get(i,j+1)*wheelRadius1*wheelRecipRadii[j+1];
-		}
-		A.set(i,0,sum0);
-		A.set(i,1,sum1);
-		A.set(i,2,M.get(i,numActiveWheels));
+		rho[j+0]=wheelRadius0*wheelRecipRadii[j+0];
+		rho[j+1]=wheelRadius1*wheelRecipRadii[j+1];
+		cRho0+=c[j+0]*rho[j+0];
+		cRho1+=c[j+1]*rho[j+1];
 	}
-	
+
 	//We have an over-determined problem because of the extra constraints 
 	//on equal wheel speeds. Solve using the least squares method as in
 	//http://s-mat-pcs.oulu.fi/~mpa/matreng/ematr5_5.htm
-
-	//Work out the transpose
-	MatrixNN AT(numActiveWheels+1);
+	//A^T*A and A^T*b are accumulated row by row so the whole solve is O(n).
+	PxF32 ATA[3][3]={{0,0,0},{0,0,0},{0,0,0}};
+	PxF32 ATb[3]={0,0,0};
 	for(PxU32 i=0;i<numActiveWheels+1;i++)
 	{
+		PxF32 row[3];
+		PxF32 rhs;
+		if(i<numActiveWheels)
+		{
+			const PxF32 aG=a[i]*G;
+			row[0]=aG*cRho0 + ((i & 1) ? 0.0f : d[i]*rho[i]);
+			row[1]=aG*cRho1 + ((i & 1) ? d[i]*rho[i] : 0.0f);
+			row[2]=-a[i];
+			rhs=b[i];
+		}
+		else
+		{
+			row[0]=-ae*cRho0;
+			row[1]=-ae*cRho1;
+			row[2]=de;
+			rhs=be;
+		}
 		for(PxU32 j=0;j<3;j++)
 		{
-			AT.set(j,i,A.get(i,j));
+			ATA[j][0]+=row[j]*row[0];
+			ATA[j][1]+=row[j]*row[1];
+			ATA[j][2]+=row[j]*row[2];
+			ATb[j]+=row[j]*rhs;
 		}
 	}
 
-	//Compute A^T*A
-	MatrixNN ATA(3);
-	for(PxU32 i=0;i<3;i++)
+	//Solve (A^T*A)*x = A^T*b
+	const PxMat33 ATAMatrix(PxVec3(ATA[0][0],ATA[1][0],ATA[2][0]),PxVec3(ATA[0][1],ATA[1][1],ATA[2][1]),PxVec3(ATA[0][2],ATA[1][2],ATA[2][2]));
+	const PxVec3 result=ATAMatrix.getInverse()*PxVec3(ATb[0],ATb[1],ATb[2]);
+#ifndef NDEBUG
 	{
-		for(PxU32 j=0;j<3;j++)
+		//Check against the normal equations of the dense system.
+		MatrixNN M(numActiveWheels+1);
+		VectorN rhs(numActiveWheels+1);
+		computeEnginePlusDrivenWheelsMatrix(numActiveWheels,d,a,c,b,G,ae,de,be,M,rhs);
+		PxF32 A[MAX_VECTORN_SIZE][3];
+		for(PxU32 i=0;i<numActiveWheels+1;i++)
 		{
-			PxF32 sum=0.0f;
-			for(PxU32 k=0;k<numActiveWheels+1;k++)
+			A[i][0]=0.0f;
+			A[i][1]=0.0f;
+			for(PxU32 j=0;j<numActiveWheels;j++)
 			{
-				sum+=AT.get(i,k)*A.get(k,j);
+				A[i][j & 1]+=M.get(i,j)*rho[j];
 			}
-			ATA.set(i,j,sum);
+			A[i][2]=M.get(i,numActiveWheels);
 		}
-	}
-
-	//Compute A^T*b;
-	VectorN ATb(3);
-	for(PxU32 i=0;i<3;i++)
-	{
-		PxF32 sum=0;
-		for(PxU32 j=0;j<numActiveWheels+1;j++)
+		MatrixNN denseATA(3);
+		VectorN denseATb(3);
+		VectorN x(3);
+		for(PxU32 j=0;j<3;j++)
 		{
-			sum+=AT.get(i,j)*b[j];
+			for(PxU32 k=0;k<3;k++)
+			{
+				PxF32 sum=0.0f;
+				for(PxU32 i=0;i<numActiveWheels+1;i++)
+				{
+					sum+=A[i][j]*A[i][k];
+				}
+				denseATA.set(j,k,sum);
+			}
+			PxF32 sum=0.0f;
+			for(PxU32 i=0;i<numActiveWheels+1;i++)
+			{
+				sum+=A[i][j]*rhs[i];
+			}
+			denseATb[j]=sum;
+			x[j]=result[j];
 		}
-		ATb[i]=sum;
+		PX_ASSERT(isValid(denseATA,denseATb,x));
 	}
-
-	//Solve (A^T*A)*x = A^T*b
-	MatrixNNLUSolver solver;
-	VectorN result(3);
-	solver.decomposeLU(ATA);
-	solver.solve(ATb,result);
+#endif
 
 	//Clamp the engine revs between zero and maxOmega
 	const PxF32 maxEngineOmega=driveSimData.getEngineData().mMaxOmega;
@@ -2113,6 +2018,18 @@ template<class T> PX_FORCE_INLINE void initialiseAll4(const PxU32 numSuspWheelTi
 	}
 }
 
+template<class S, class D> PX_FORCE_INLINE void storeWheelQueryResult
+(const PxU32 numWheels, const PxVehicleWheels4DynData* PX_RESTRICT wheels4DynData, S (PxVehicleWheels4DynData::*values)[4], D* PX_RESTRICT dst)
+{
+	if(dst)
+	{
+		for(PxU32 i=0;i<numWheels;i++)
+		{
+			dst[i]=(wheels4DynData[i>>2].*values)[i & 3];
+		}
+	}
+}
+
 class PxVehicleUpdate
 {
 public:
@@ -2125,12 +2042,21 @@ public:
 
 	static void update(
 		const PxF32 timestep, const PxVec3& gravity, const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, 
-		const PxU32 numVehicles, PxVehicleWheels** vehicles);
+		const PxU32 numVehicles, PxVehicleWheels** vehicles, PxVehicleWheelQueryResults* wheelQueryResults);
+
+	static void storeWheelQueryResults(const PxVehicleWheels& vehWheels, const PxU32 firstWheel, const PxVehicleWheelQueryResults& wheelQueryResults);
+
+	static void getWheelQueryResults(const PxU32 numVehicles, const PxVehicleWheels* const* vehicles, PxVehicleWheelQueryResults& wheelQueryResults);
 
 	static void suspensionRaycasts(
 		PxBatchQuery* batchQuery, 
 		const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults);
 
+	static void suspensionRaycasts(
+		PxBatchQuery* batchQuery, 
+		const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults,
+		PxVehicleSuspensionRaycastCache& raycastCache);
+
 	static void updateDrive4W(
 		const PxF32 timestep, 
 		const PxVec3& gravity, const PxF32 gravityMagnitude, const PxF32 recipGravityMagnitude, 
@@ -2756,7 +2682,7 @@ void PxVehicleUpdate::updateTank
 	//Ready to do the update.
 	PxVec3 carChassisLinVel=vehActor->getLinearVelocity();
 	PxVec3 carChassisAngVel=vehActor->getAngularVelocity();
-	const PxU32 numSubSteps=8;//computeNumberOfSubsteps(vehDriveTank->mWheelsSimData,carChassisLinVel,carChassisTransform,gForward);
+	const PxU32 numSubSteps=computeNumberOfSubsteps(vehDriveTank->mWheelsSimData,carChassisLinVel,carChassisTransform,gForward);
 	const PxF32 timeFraction=1.0f/(1.0f*numSubSteps);
 	const PxF32 subTimestep=timestep*timeFraction;
 	for(PxU32 k=0;k<numSubSteps;k++)
@@ -2854,7 +2780,7 @@ void PxVehicleUpdate::updateTank
 			engineDampingRate=computeEngineDampingRate(engineData,currentGear,accel);
 		}
 
-		//Update the wheel and engine speeds - 5x5 matrix coupling engine and wheels.
+		//Update the wheel and engine speeds - engine coupled to two tracks of wheels.
 		solveTankInternaDynamicsEnginePlusDrivenWheels(
 			subTimestep, 
 			K,G,
@@ -3233,13 +3159,20 @@ void physx::PxVehicleUpdateSingleVehicleAndStoreTelemetryData
 
 void PxVehicleUpdate::update
 (const PxF32 timestep, const PxVec3& gravity, const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, 
- const PxU32 numVehicles, PxVehicleWheels** vehicles)
+ const PxU32 numVehicles, PxVehicleWheels** vehicles, PxVehicleWheelQueryResults* wheelQueryResults)
 {
 	PX_CHECK_AND_RETURN(gravity.magnitude()>0, "gravity vector must have non-zero length");
 	PX_CHECK_AND_RETURN(timestep>0, "timestep must be greater than zero");
 	PX_CHECK_AND_RETURN(gThresholdForwardSpeedForWheelAngleIntegration>0, "PxInitVehicleSDK needs to be called before ever calling PxVehicleUpdates");
 
 #ifdef PX_CHECKED
+	PxU32 numWheels=0;
+	for(PxU32 i=0;i<numVehicles;i++)
+	{
+		numWheels+=vehicles[i]->mWheelsSimData.mNumActiveWheels;
+	}
+	PX_CHECK_AND_RETURN(!wheelQueryResults || numWheels<=wheelQueryResults->numWheels, "PxVehicleWheelQueryResults::numWheels must be greater than or equal to the total number of wheels of all the vehicles");
+
 	for(PxU32 i=0;i<numVehicles;i++)
 	{
 		const PxVehicleWheels* const vehWheels=vehicles[i];
@@ -3268,6 +3201,7 @@ void PxVehicleUpdate::update
 	const PxF32 gravityMagnitude=gravity.magnitude();
 	const PxF32 recipGravityMagnitude=1.0f/gravityMagnitude;
 
+	PxU32 firstWheel=0;
 	for(PxU32 i=0;i<numVehicles;i++)
 	{
 		PxVehicleWheels* vehWheels=vehicles[i];
@@ -3314,6 +3248,13 @@ void PxVehicleUpdate::update
 			PX_CHECK_MSG(false, "update - unsupported vehicle type"); 
 			break;
 		}
+
+		//Store the wheel state while the vehicle is still in the cache.
+		if(wheelQueryResults)
+		{
+			storeWheelQueryResults(*vehWheels, firstWheel, *wheelQueryResults);
+			firstWheel+=vehWheels->mWheelsSimData.mNumActiveWheels;
+		}
 	}
 }
 
@@ -3321,11 +3262,103 @@ void physx::PxVehicleUpdates
 (const PxReal timestep, const PxVec3& gravity, const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, 
  const PxU32 numVehicles, PxVehicleWheels** vehicles)
 {
-	PxVehicleUpdate::update(timestep, gravity, vehicleDrivableSurfaceToTireFrictionPairs, numVehicles, vehicles);
+	PxVehicleUpdate::update(timestep, gravity, vehicleDrivableSurfaceToTireFrictionPairs, numVehicles, vehicles, NULL);
+}
+
+void physx::PxVehicleUpdates
+(const PxReal timestep, const PxVec3& gravity, const PxVehicleDrivableSurfaceToTireFrictionPairs& vehicleDrivableSurfaceToTireFrictionPairs, 
+ const PxU32 numVehicles, PxVehicleWheels** vehicles, PxVehicleWheelQueryResults& wheelQueryResults)
+{
+	PxVehicleUpdate::update(timestep, gravity, vehicleDrivableSurfaceToTireFrictionPairs, numVehicles, vehicles, &wheelQueryResults);
 }
 
 ////////////////////////////////////////////////////////////
 
+void PxVehicleUpdate::storeWheelQueryResults(const PxVehicleWheels& vehWheels, const PxU32 firstWheel, const PxVehicleWheelQueryResults& wheelQueryResults)
+{
+	const PxVehicleWheels4DynData* PX_RESTRICT wheels4DynData=vehWheels.mWheelsDynData.mWheels4DynData;
+	const PxU32 numWheels=vehWheels.mWheelsSimData.mNumActiveWheels;
+
+	//One pass per requested array so that arrays left NULL cost nothing.
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mSuspJounces, wheelQueryResults.suspJounce ? wheelQueryResults.suspJounce+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mSuspensionSpringForces, wheelQueryResults.suspSpringForce ? wheelQueryResults.suspSpringForce+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mLongSlips, wheelQueryResults.tireLongSlip ? wheelQueryResults.tireLongSlip+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mLatSlips, wheelQueryResults.tireLatSlip ? wheelQueryResults.tireLatSlip+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireFrictions, wheelQueryResults.tireFriction ? wheelQueryResults.tireFriction+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireSurfaceTypes, wheelQueryResults.tireSurfaceType ? wheelQueryResults.tireSurfaceType+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireSurfaceMaterials, wheelQueryResults.tireSurfaceMaterial ? wheelQueryResults.tireSurfaceMaterial+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireContactShapes, wheelQueryResults.tireContactShape ? wheelQueryResults.tireContactShape+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireContactPoints, wheelQueryResults.tireContactPoint ? wheelQueryResults.tireContactPoint+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireContactNormals, wheelQueryResults.tireContactNormal ? wheelQueryResults.tireContactNormal+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireLongitudinalDirs, wheelQueryResults.tireLongitudinalDir ? wheelQueryResults.tireLongitudinalDir+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mTireLateralDirs, wheelQueryResults.tireLateralDir ? wheelQueryResults.tireLateralDir+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mCorrectedWheelSpeeds, wheelQueryResults.wheelRotationSpeed ? wheelQueryResults.wheelRotationSpeed+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mWheelRotationAngles, wheelQueryResults.wheelRotationAngle ? wheelQueryResults.wheelRotationAngle+firstWheel : NULL);
+	storeWheelQueryResult(numWheels, wheels4DynData, &PxVehicleWheels4DynData::mSteerAngles, wheelQueryResults.steerAngle ? wheelQueryResults.steerAngle+firstWheel : NULL);
+
+	if(wheelQueryResults.isInAir)
+	{
+		//Same test as PxVehicleWheels::isInAir.
+		const PxVehicleWheels4SimData* PX_RESTRICT wheels4SimData=vehWheels.mWheelsSimData.mWheels4SimData;
+		bool* PX_RESTRICT isInAir=wheelQueryResults.isInAir+firstWheel;
+		for(PxU32 i=0;i<numWheels;i++)
+		{
+			isInAir[i]=(wheels4DynData[i>>2].mSuspJounces[i & 3]==-wheels4SimData[i>>2].getSuspensionData(i & 3).mMaxDroop);
+		}
+	}
+}
+
+void PxVehicleUpdate::getWheelQueryResults(const PxU32 numVehicles, const PxVehicleWheels* const* vehicles, PxVehicleWheelQueryResults& wheelQueryResults)
+{
+#ifdef PX_CHECKED
+	PxU32 numWheels=0;
+	for(PxU32 i=0;i<numVehicles;i++)
+	{
+		numWheels+=vehicles[i]->mWheelsSimData.mNumActiveWheels;
+	}
+	PX_CHECK_AND_RETURN(numWheels<=wheelQueryResults.numWheels, "PxVehicleWheelQueryResults::numWheels must be greater than or equal to the total number of wheels of all the vehicles");
+#endif
+
+	PxU32 firstWheel=0;
+	for(PxU32 i=0;i<numVehicles;i++)
+	{
+		storeWheelQueryResults(*vehicles[i], firstWheel, wheelQueryResults);
+		firstWheel+=vehicles[i]->mWheelsSimData.mNumActiveWheels;
+	}
+}
+
+void physx::PxVehicleGetWheelQueryResults(const PxU32 numVehicles, const PxVehicleWheels* const* vehicles, PxVehicleWheelQueryResults& wheelQueryResults)
+{
+	PxVehicleUpdate::getWheelQueryResults(numVehicles, vehicles, wheelQueryResults);
+}
+
+////////////////////////////////////////////////////////////
+
+static PX_FORCE_INLINE void computeSuspensionLine
+(const PxTransform& carChassisTrnsfm, const PxVehicleWheels4SimData& wheels4SimData, const PxU32 j,
+ PxVec3& wheelPosition, PxVec3& downwardSuspensionTravelDir, PxF32& rayLength)
+{
+	const PxVehicleSuspensionData& susp=wheels4SimData.getSuspensionData(j);
+	const PxF32 maxDroop=susp.mMaxDroop;
+	const PxF32 maxBounce=susp.mMaxCompression;
+	const PxVehicleWheelData& wheel=wheels4SimData.getWheelData(j);
+	const PxF32 radius=wheel.mRadius;
+	PX_ASSERT(maxBounce>=0);
+	PX_ASSERT(maxDroop>=0);
+
+	//Direction of raycast.
+	downwardSuspensionTravelDir=carChassisTrnsfm.rotate(wheels4SimData.getSuspTravelDirection(j));
+
+	//Position at top of wheel at maximum compression.
+	wheelPosition=carChassisTrnsfm.transform(wheels4SimData.getWheelCentreOffset(j));
+	wheelPosition-=downwardSuspensionTravelDir*(radius+maxBounce);
+
+	//Total length from top of wheel at max compression to bottom of wheel at max droop.
+	rayLength=radius + maxBounce  + maxDroop + radius;
+	//Add another radius on for good measure.
+	rayLength+=radius;
+}
+
 void PxVehicleWheels4SuspensionRaycasts
 (PxBatchQuery* batchQuery, const PxU32 numVehicles, PxRaycastQueryResult* sceneQueryResults, 
  const PxVehicleWheels4SimData& wheels4SimData, PxVehicleWheels4DynData& wheels4DynData, const PxSceneQueryFilterData* PX_RESTRICT carFilterData, const PxU32 numActiveWheels,
@@ -3337,25 +3370,10 @@ void PxVehicleWheels4SuspensionRaycasts
 	//Add a raycast for each wheel.
 	for(PxU32 j=0;j<numActiveWheels;j++)
 	{
-		const PxVehicleSuspensionData& susp=wheels4SimData.getSuspensionData(j);
-		const PxF32 maxDroop=susp.mMaxDroop;
-		const PxF32 maxBounce=susp.mMaxCompression;
-		const PxVehicleWheelData& wheel=wheels4SimData.getWheelData(j);
-		const PxF32 radius=wheel.mRadius;
-		PX_ASSERT(maxBounce>=0);
-		PX_ASSERT(maxDroop>=0);
-
-		//Direction of raycast.
-		const PxVec3 downwardSuspensionTravelDir=carChassisTrnsfm.rotate(wheels4SimData.getSuspTravelDirection(j));
-
-		//Position at top of wheel at maximum compression.
-		PxVec3 wheelPosition=carChassisTrnsfm.transform(wheels4SimData.getWheelCentreOffset(j));
-		wheelPosition-=downwardSuspensionTravelDir*(radius+maxBounce);
-
-		//Total length from top of wheel at max compression to bottom of wheel at max droop.
-		PxF32 rayLength=radius + maxBounce  + maxDroop + radius;
-		//Add another radius on for good measure.
-		rayLength+=radius;
+		PxVec3 wheelPosition;
+		PxVec3 downwardSuspensionTravelDir;
+		PxF32 rayLength;
+		computeSuspensionLine(carChassisTrnsfm, wheels4SimData, j, wheelPosition, downwardSuspensionTravelDir, rayLength);
 
 		//Store the susp line ray for later use.
 		wheels4DynData.mSuspLineStarts[j]=wheelPosition;
@@ -3445,3 +3463,220 @@ void physx::PxVehicleSuspensionRaycasts(PxBatchQuery* batchQuery, const PxU32 nu
 {
 	PxVehicleUpdate::suspensionRaycasts(batchQuery, numVehicles, vehicles, numSceneQueryesults, sceneQueryResults);
 }
+
+////////////////////////////////////////////////////////////
+
+#define PX_VEHICLE_SUSP_RAYCAST_CACHE_NOT_REUSABLE 0xffffffff
+
+struct PxVehicleSuspensionRaycastCache::CachedHit
+{
+	//Hit of the last raycast of the wheel, its impact and distance are updated each time the hit is reused.
+	PxRaycastHit hit;
+
+	//Suspension line of the last raycast.
+	PxVec3 lineStart;
+	PxVec3 lineDir;
+
+	//Plane of the hit: hit.normal.dot(x)+planeD=0
+	PxF32 planeD;
+
+	//Wheel that owns the hit and the number of frames the hit has been reused.
+	const PxVehicleWheels* vehicle;
+	PxU32 wheel;
+	PxU32 age;
+};
+
+PxVehicleSuspensionRaycastCache* physx::PxVehicleSuspensionRaycastCache::allocate(const PxU32 maxNumWheels)
+{
+	//Work out the byte size required.
+	PxU32 size = sizeof(PxVehicleSuspensionRaycastCache);
+	size += sizeof(PxRaycastQueryResult)*maxNumWheels;	//results
+	size += sizeof(CachedHit)*maxNumWheels;				//cached hits
+	size += sizeof(PxU32)*maxNumWheels;					//raycast wheels
+
+	//Allocate the memory.
+	PxVehicleSuspensionRaycastCache* cache=(PxVehicleSuspensionRaycastCache*)PX_ALLOC(size, PX_DEBUG_EXP("PxVehicleSuspensionRaycastCache"));
+
+	//Patch up the pointers.
+	PxU8* ptr = (PxU8*)cache + sizeof(PxVehicleSuspensionRaycastCache);
+	cache->mResults = (PxRaycastQueryResult*)ptr;
+	ptr += sizeof(PxRaycastQueryResult)*maxNumWheels;
+	cache->mCachedHits = (CachedHit*)ptr;
+	ptr += sizeof(CachedHit)*maxNumWheels;
+	cache->mRaycastWheels = (PxU32*)ptr;
+	ptr += sizeof(PxU32)*maxNumWheels;
+
+	cache->mMaxNumWheels=maxNumWheels;
+	cache->setTolerances(0.01f, 0.001f, 8);
+	cache->invalidate();
+	cache->resetStatistics();
+
+	//Finished.
+	return cache;
+}
+
+void PxVehicleSuspensionRaycastCache::free()
+{
+	PX_FREE(this);
+}
+
+void physx::PxVehicleSuspensionRaycastCache::setTolerances(const PxReal positionTolerance, const PxReal directionTolerance, const PxU32 maxCachedFrames)
+{
+	PX_CHECK_AND_RETURN(positionTolerance>=0 && directionTolerance>=0, "PxVehicleSuspensionRaycastCache::setTolerances - tolerances must be greater than or equal to zero");
+	mPositionTolerance=positionTolerance;
+	mDirectionTolerance=directionTolerance;
+	mMaxCachedFrames=maxCachedFrames;
+}
+
+void physx::PxVehicleSuspensionRaycastCache::invalidate()
+{
+	for(PxU32 i=0;i<mMaxNumWheels;i++)
+	{
+		mCachedHits[i].vehicle=NULL;
+		mCachedHits[i].age=PX_VEHICLE_SUSP_RAYCAST_CACHE_NOT_REUSABLE;
+	}
+}
+
+void PxVehicleUpdate::suspensionRaycasts
+(PxBatchQuery* batchQuery, const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults,
+ PxVehicleSuspensionRaycastCache& raycastCache)
+{
+	PxRaycastQueryResult* PX_RESTRICT results=raycastCache.mResults;
+	PxVehicleSuspensionRaycastCache::CachedHit* PX_RESTRICT cachedHits=raycastCache.mCachedHits;
+	PxU32* PX_RESTRICT raycastWheels=raycastCache.mRaycastWheels;
+	const PxF32 positionTolerance2=raycastCache.mPositionTolerance*raycastCache.mPositionTolerance;
+	const PxF32 directionTolerance2=raycastCache.mDirectionTolerance*raycastCache.mDirectionTolerance;
+	const PxU32 maxCachedFrames=raycastCache.mMaxCachedFrames;
+
+	PxSceneQueryFilterData carFilterData;
+	carFilterData.flags=PxSceneQueryFilterFlag::eSTATIC|PxSceneQueryFilterFlag::eDYNAMIC|PxSceneQueryFilterFlag::ePREFILTER;
+
+	PxU32 numRaycasts=0;
+	PxU32 numCachedHits=0;
+	PxU32 firstWheel=0;
+
+	//Answer each suspension line from the cache if possible, otherwise add a raycast.
+	for(PxU32 i=0;i<numVehicles;i++)
+	{
+		//Get the current car.
+		PxVehicleWheels& veh=*vehicles[i];
+		const PxVehicleWheels4SimData* PX_RESTRICT wheels4SimData=veh.mWheelsSimData.mWheels4SimData;
+		PxVehicleWheels4DynData* PX_RESTRICT wheels4DynData=veh.mWheelsDynData.mWheels4DynData;
+		const PxU32 numActiveWheels=veh.mWheelsSimData.mNumActiveWheels;
+		const PxU32 numActiveWheels4=((numActiveWheels + 3) >> 2);
+
+		if((firstWheel+numActiveWheels) > raycastCache.mMaxNumWheels)
+		{
+			PX_CHECK_MSG(false, "PxVehicleUpdate::suspensionRaycasts - raycastCache not big enough to support one raycast hit report per wheel.  Allocate raycastCache with more wheels");
+			for(PxU32 j=0;j<numActiveWheels4;j++)
+			{
+				wheels4DynData[j].mSqResults=NULL;
+			}
+			continue;
+		}
+
+		//Get the transform of the chassis.
+		PxRigidDynamic* vehActor=veh.mActor;
+		const PxTransform carChassisTrnsfm=vehActor->getGlobalPose().transform(vehActor->getCMassLocalPose());
+
+		for(PxU32 j=0;j<numActiveWheels;j++)
+		{
+			PxVec3 wheelPosition;
+			PxVec3 downwardSuspensionTravelDir;
+			PxF32 rayLength;
+			computeSuspensionLine(carChassisTrnsfm, wheels4SimData[j>>2], j & 3, wheelPosition, downwardSuspensionTravelDir, rayLength);
+
+			//Store the susp line ray for later use.
+			PxVehicleWheels4DynData& dynData4=wheels4DynData[j>>2];
+			dynData4.mSuspLineStarts[j & 3]=wheelPosition;
+			dynData4.mSuspLineDirs[j & 3]=downwardSuspensionTravelDir;
+			dynData4.mSuspLineLengths[j & 3]=rayLength;
+
+			const PxU32 wheel=firstWheel+j;
+			PxVehicleSuspensionRaycastCache::CachedHit& cachedHit=cachedHits[wheel];
+			PxRaycastQueryResult& result=results[wheel];
+
+			//Intersect the suspension line with the plane of the cached hit if the line barely moved since the hit.
+			if(cachedHit.vehicle==&veh && cachedHit.wheel==j && cachedHit.age<maxCachedFrames &&
+			   (wheelPosition-cachedHit.lineStart).magnitudeSquared()<=positionTolerance2 &&
+			   (downwardSuspensionTravelDir-cachedHit.lineDir).magnitudeSquared()<=directionTolerance2)
+			{
+				const PxF32 cosAngle=cachedHit.hit.normal.dot(downwardSuspensionTravelDir);
+				if(cosAngle<0)
+				{
+					const PxF32 distance=-(cachedHit.hit.normal.dot(wheelPosition)+cachedHit.planeD)/cosAngle;
+					if(distance>=0 && distance<=rayLength)
+					{
+						cachedHit.hit.impact=wheelPosition+downwardSuspensionTravelDir*distance;
+						cachedHit.hit.distance=distance;
+						cachedHit.age++;
+						result.hits=&cachedHit.hit;
+						result.nbHits=1;
+						numCachedHits++;
+						continue;
+					}
+				}
+			}
+
+			//Add the raycast to the scene query.
+			cachedHit.vehicle=&veh;
+			cachedHit.wheel=j;
+			cachedHit.age=PX_VEHICLE_SUSP_RAYCAST_CACHE_NOT_REUSABLE;
+			cachedHit.lineStart=wheelPosition;
+			cachedHit.lineDir=downwardSuspensionTravelDir;
+			result.hits=NULL;
+			result.nbHits=0;
+			if(numRaycasts<numSceneQueryResults)
+			{
+				carFilterData.data=veh.mSqFilterData[j];
+				raycastWheels[numRaycasts]=wheel;
+				numRaycasts++;
+				batchQuery->raycastSingle(wheelPosition, downwardSuspensionTravelDir, rayLength, carFilterData, PxSceneQueryFlag::eIMPACT|PxSceneQueryFlag::eNORMAL|PxSceneQueryFlag::eDISTANCE|PxSceneQueryFlag::eUV);
+			}
+			else
+			{
+				PX_CHECK_MSG(false, "PxVehicleUpdate::suspensionRaycasts - numSceneQueryResults not big enough to support one raycast hit report per wheel.  Increase size of sceneQueryResults");
+			}
+		}
+
+		//The vehicle reads its results from the cache.
+		for(PxU32 j=0;j<numActiveWheels4;j++)
+		{
+			wheels4DynData[j].mSqResults=results + firstWheel + 4*j;
+		}
+
+		firstWheel+=numActiveWheels;
+	}
+
+	batchQuery->execute();
+
+	//Copy the hits to the cache because the batch query reuses its hit buffer.  Only hits against static actors may be reused.
+	for(PxU32 i=0;i<numRaycasts;i++)
+	{
+		const PxRaycastQueryResult& sqResult=sceneQueryResults[i];
+		const PxU32 wheel=raycastWheels[i];
+		PxVehicleSuspensionRaycastCache::CachedHit& cachedHit=cachedHits[wheel];
+		PxRaycastQueryResult& result=results[wheel];
+		result.queryStatus=sqResult.queryStatus;
+		result.userData=sqResult.userData;
+		if(sqResult.nbHits>0)
+		{
+			cachedHit.hit=sqResult.hits[0];
+			result.hits=&cachedHit.hit;
+			result.nbHits=1;
+			if(cachedHit.hit.shape->getActor().is<PxRigidStatic>())
+			{
+				cachedHit.planeD=-cachedHit.hit.normal.dot(cachedHit.hit.impact);
+				cachedHit.age=0;
+			}
+		}
+	}
+
+	raycastCache.mNumRaycasts+=numRaycasts;
+	raycastCache.mNumCachedHits+=numCachedHits;
+}
+
+void physx::PxVehicleSuspensionRaycasts(PxBatchQuery* batchQuery, const PxU32 numVehicles, PxVehicleWheels** vehicles, const PxU32 numSceneQueryResults, PxRaycastQueryResult* sceneQueryResults, PxVehicleSuspensionRaycastCache& raycastCache)
+{
+	PxVehicleUpdate::suspensionRaycasts(batchQuery, numVehicles, vehicles, numSceneQueryResults, sceneQueryResults, raycastCache);
+}
@@ -67,6 +67,7 @@ PxVehicleWheelsSimData* PxVehicleWheelsSimData::allocate(const PxU32 numWheels)
 	simData->mWheels4SimData = (PxVehicleWheels4SimData*)ptr;
 	simData->mNumWheels4 = numWheels4;
 	simData->mNumActiveWheels = numWheels;
+	simData->mIsShared = 0;
 
 	//Placement new.
 	for(PxU32 i=0;i<numWheels4;i++)
@@ -121,10 +122,15 @@ void PxVehicleWheelsSimData::free()
 PxVehicleWheelsSimData& PxVehicleWheelsSimData::operator=(const PxVehicleWheelsSimData& src)
 {
 	PX_CHECK_MSG(mNumActiveWheels == src.mNumActiveWheels, "target PxVehicleSuspWheelTireNSimData must match the number of wheels in src");
+	PX_CHECK_AND_RETURN_VAL(!mIsShared || mWheels4SimData == src.mWheels4SimData, "PxVehicleWheelsSimData::operator= - the wheels simulation data of a fleet vehicle is shared with its archetype", *this);
 
-	for(PxU32 i=0;i<src.mNumWheels4;i++)
+	//Vehicles of a fleet reference the blocks of their archetype.
+	if(mWheels4SimData != src.mWheels4SimData)
 	{
-		mWheels4SimData[i] = src.mWheels4SimData[i];
+		for(PxU32 i=0;i<src.mNumWheels4;i++)
+		{
+			mWheels4SimData[i] = src.mWheels4SimData[i];
+		}
 	}
 
 	mNormalisedLoadFilter = src.mNormalisedLoadFilter;
@@ -252,42 +258,49 @@ const PxVec3& PxVehicleWheelsSimData::getWheelCentreOffset(const PxU32 id) const
 void PxVehicleWheelsSimData::setSuspensionData(const PxU32 id, const PxVehicleSuspensionData& susp)
 {
 	PX_CHECK_AND_RETURN(id < 4*mNumWheels4, "PxVehicleWheelsSimData::setSuspensionData - Illegal wheel");
+	PX_CHECK_AND_RETURN(!mIsShared, "PxVehicleWheelsSimData::setSuspensionData - the wheels simulation data of a fleet vehicle is shared with its archetype");
 	mWheels4SimData[id>>2].setSuspensionData(susp,id & 3);
 }
 
 void PxVehicleWheelsSimData::setWheelData(const PxU32 id, const PxVehicleWheelData& wheel)
 {
 	PX_CHECK_AND_RETURN(id < 4*mNumWheels4, "PxVehicleWheelsSimData::setWheelData - Illegal wheel");
+	PX_CHECK_AND_RETURN(!mIsShared, "PxVehicleWheelsSimData::setWheelData - the wheels simulation data of a fleet vehicle is shared with its archetype");
 	mWheels4SimData[id>>2].setWheelData(wheel,id & 3);
 }
 
 void PxVehicleWheelsSimData::setTireData(const PxU32 id, const PxVehicleTireData& tire)
 {
 	PX_CHECK_AND_RETURN(id < 4*mNumWheels4, "PxVehicleWheelsSimData::setTireData - Illegal wheel");
+	PX_CHECK_AND_RETURN(!mIsShared, "PxVehicleWheelsSimData::setTireData - the wheels simulation data of a fleet vehicle is shared with its archetype");
 	mWheels4SimData[id>>2].setTireData(tire,id & 3);
 }
 
 void PxVehicleWheelsSimData::setSuspTravelDirection(const PxU32 id, const PxVec3& dir)										
 {
 	PX_CHECK_AND_RETURN(id < 4*mNumWheels4, "PxVehicleWheelsSimData::setSuspTravelDirection - Illegal wheel");
+	PX_CHECK_AND_RETURN(!mIsShared, "PxVehicleWheelsSimData::setSuspTravelDirection - the wheels simulation data of a fleet vehicle is shared with its archetype");
 	mWheels4SimData[id>>2].setSuspTravelDirection(dir,id & 3);
 }
 
 void PxVehicleWheelsSimData::setSuspForceAppPointOffset(const PxU32 id, const PxVec3& offset)									
 {
 	PX_CHECK_AND_RETURN(id < 4*mNumWheels4, "PxVehicleWheelsSimData::setSuspForceAppPointOffset - Illegal wheel");
+	PX_CHECK_AND_RETURN(!mIsShared, "PxVehicleWheelsSimData::setSuspForceAppPointOffset - the wheels simulation data of a fleet vehicle is shared with its archetype");
 	mWheels4SimData[id>>2].setSuspForceAppPointOffset(offset,id & 3);
 }
 
 void PxVehicleWheelsSimData::setTireForceAppPointOffset(const PxU32 id, const PxVec3& offset)									
 {
 	PX_CHECK_AND_RETURN(id < 4*mNumWheels4, "PxVehicleWheelsSimData::setTireForceAppPointOffset - Illegal wheel");
+	PX_CHECK_AND_RETURN(!mIsShared, "PxVehicleWheelsSimData::setTireForceAppPointOffset - the wheels simulation data of a fleet vehicle is shared with its archetype");
 	mWheels4SimData[id>>2].setTireForceAppPointOffset(offset,id & 3);
 }
 
 void PxVehicleWheelsSimData::setWheelCentreOffset(const PxU32 id, const PxVec3& offset)									
 {
 	PX_CHECK_AND_RETURN(id < 4*mNumWheels4, "PxVehicleWheelsSimData::setWheelCentreOffset - Illegal wheel");
+	PX_CHECK_AND_RETURN(!mIsShared, "PxVehicleWheelsSimData::setWheelCentreOffset - the wheels simulation data of a fleet vehicle is shared with its archetype");
 	mWheels4SimData[id>>2].setWheelCentreOffset(offset,id & 3);
 }
 
@@ -528,10 +541,10 @@ bool PxVehicleWheels::isValid() const
 	return true;
 }
 
-PxU32 PxVehicleWheels::computeByteSize(const PxU32 numWheels4)
+PxU32 PxVehicleWheels::computeByteSize(const PxU32 numWheels4, const bool sharedWheelsSimData)
 {
 	return 
-		(sizeof(PxVehicleWheels4SimData)*numWheels4 +
+		((sharedWheelsSimData ? 0 : sizeof(PxVehicleWheels4SimData)*numWheels4) +
 		 sizeof(PxVehicleWheels4DynData)*numWheels4 +
 		 sizeof(PxVehicleTireForceCalculator) + sizeof(void*)*4*numWheels4 +
 		 sizeof(void*)*4*numWheels4 +
@@ -539,11 +552,20 @@ PxU32 PxVehicleWheels::computeByteSize(const PxU32 numWheels4)
 		 sizeof(PxFilterData)*4*numWheels4;
 }
 
-PxU8* PxVehicleWheels::patchupPointers(PxVehicleWheels* veh, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels)
+PxU8* PxVehicleWheels::patchupPointers(PxVehicleWheels* veh, PxU8* ptr, const PxU32 numWheels4, const PxU32 numWheels, const PxVehicleWheelsSimData* sharedWheelsSimData)
 {
+	PX_ASSERT(!sharedWheelsSimData || sharedWheelsSimData->mNumWheels4==numWheels4);
+
 	//Patchup pointers.
-	veh->mWheelsSimData.mWheels4SimData = (PxVehicleWheels4SimData*)ptr;
-	ptr += sizeof(PxVehicleWheels4SimData)*numWheels4;
+	if(sharedWheelsSimData)
+	{
+		veh->mWheelsSimData.mWheels4SimData = sharedWheelsSimData->mWheels4SimData;
+	}
+	else
+	{
+		veh->mWheelsSimData.mWheels4SimData = (PxVehicleWheels4SimData*)ptr;
+		ptr += sizeof(PxVehicleWheels4SimData)*numWheels4;
+	}
 	veh->mWheelsDynData.mWheels4DynData = (PxVehicleWheels4DynData*)ptr;
 	ptr += sizeof(PxVehicleWheels4DynData)*numWheels4;
 	veh->mWheelsDynData.mTireForceCalculators = (PxVehicleTireForceCalculator*)ptr;
@@ -561,7 +583,7 @@ PxU8* PxVehicleWheels::patchupPointers(PxVehicleWheels* veh, PxU8* ptr, const Px
 	ptr+=sizeof(PxFilterData)*4*numWheels4;
 
 	//Placement new.
-	for(PxU32 i=0;i<numWheels4;i++)
+	for(PxU32 i=0;i<numWheels4 && !sharedWheelsSimData;i++)
 	{
 		new(&veh->mWheelsSimData.mWheels4SimData[i]) PxVehicleWheels4SimData();
 	}
@@ -589,11 +611,13 @@ PxU8* PxVehicleWheels::patchupPointers(PxVehicleWheels* veh, PxU8* ptr, const Px
 	veh->mWheelsSimData.mNumWheels4=numWheels4;
 	veh->mWheelsDynData.mNumWheels4=numWheels4;
 	veh->mWheelsSimData.mNumActiveWheels=numWheels;
+	veh->mWheelsSimData.mIsShared=PxU8(sharedWheelsSimData ? 1 : 0);
 	veh->mWheelsSimData.mHighForwardSpeedSubStepCount=gHighLongSpeedSubstepCount;
 	veh->mWheelsSimData.mLowForwardSpeedSubStepCount=gLowLongSpeedSubstepCount;
 	veh->mWheelsSimData.mThresholdLongitudinalSpeed=gThresholdLongSpeed;
 	veh->mWheelsDynData.mNumActiveWheels=numWheels;
 	veh->mOnConstraintReleaseCounter=numWheels4;
+	veh->mIsFleetVehicle=0;
 
 	//Set some more data.
 	for(PxU32 i=0;i<PX_MAX_NUM_WHEELS;i++)
@@ -694,8 +718,8 @@ void PxVehicleWheels::setup
 		mWheelsDynData.setTireForceShaderData(i,&mWheelsSimData.getTireData(i));
 	}
 
-	//Disable the unused wheels.
-	for(PxU32 i=wheelsData.mNumActiveWheels;i<4*mWheelsSimData.mNumWheels4;i++)
+	//Disable the unused wheels (shared wheels simulation data of a fleet is immutable and already has them disabled).
+	for(PxU32 i=wheelsData.mNumActiveWheels;i<4*mWheelsSimData.mNumWheels4 && !mIsFleetVehicle;i++)
 	{
 		mWheelsSimData.disableWheel(i);
 	}
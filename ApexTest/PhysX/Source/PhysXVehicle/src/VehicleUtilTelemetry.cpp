@@ -29,6 +29,8 @@
 
 #include "PxVehicleUtilTelemetry.h"
 #include "PxVehicleSDK.h"
+#include "PxVehicleUpdate.h"
+#include "PxVehicleDrive.h"
 #include "PsFoundation.h"
 #include "PsUtilities.h"
 #include "stdio.h"
@@ -555,6 +557,98 @@ void physx::PxVehicleTelemetryData::clear()
 
 #endif //PX_DEBUG_VEHICLE_ON
 
+PxVehicleTelemetryRecorder* physx::PxVehicleTelemetryRecorder::allocate(const PxU32 maxNumVehicles, const PxU32 maxNumWheels, const PxU32 numSamples)
+{
+	PX_CHECK_AND_RETURN_NULL(numSamples>0, "PxVehicleTelemetryRecorder::allocate - numSamples must be greater than zero");
+
+	const PxU32 sampleSize = eMAX_NUM_WHEEL_CHANNELS*maxNumWheels + eMAX_NUM_VEHICLE_CHANNELS*maxNumVehicles;
+
+	//Work out the byte size required.
+	PxU32 size = sizeof(PxVehicleTelemetryRecorder);
+	size += sizeof(PxU32)*numSamples;				//vehicle counts
+	size += sizeof(PxU32)*numSamples;				//wheel counts
+	size += sizeof(PxReal)*sampleSize*numSamples;	//samples
+
+	//Allocate the memory.
+	PxVehicleTelemetryRecorder* recorder=(PxVehicleTelemetryRecorder*)PX_ALLOC(size, PX_DEBUG_EXP("PxVehicleTelemetryRecorder"));
+
+	//Patch up the pointers.
+	PxU8* ptr = (PxU8*)recorder + sizeof(PxVehicleTelemetryRecorder);
+	recorder->mSampleNumVehicles = (PxU32*)ptr;
+	ptr += sizeof(PxU32)*numSamples;
+	recorder->mSampleNumWheels = (PxU32*)ptr;
+	ptr += sizeof(PxU32)*numSamples;
+	recorder->mSamples = (PxReal*)ptr;
+	ptr += sizeof(PxReal)*sampleSize*numSamples;
+
+	recorder->mMaxNumVehicles=maxNumVehicles;
+	recorder->mMaxNumWheels=maxNumWheels;
+	recorder->mSampleSize=sampleSize;
+	recorder->mNumSamples=numSamples;
+	recorder->clear();
+
+	//Finished.
+	return recorder;
+}
+
+void PxVehicleTelemetryRecorder::free()
+{
+	PX_FREE(this);
+}
+
+void physx::PxVehicleTelemetryRecorder::clear()
+{
+	mSampleTide=mNumSamples-1;
+	mNumRecordedSamples=0;
+}
+
+void physx::PxVehicleTelemetryRecorder::record(const PxU32 numVehicles, const PxVehicleWheels* const* vehicles)
+{
+	PX_CHECK_AND_RETURN(numVehicles<=mMaxNumVehicles, "PxVehicleTelemetryRecorder::record - too many vehicles");
+
+	PxU32 numWheels=0;
+	for(PxU32 i=0;i<numVehicles;i++)
+	{
+		numWheels+=vehicles[i]->mWheelsSimData.getNumWheels();
+	}
+	PX_CHECK_AND_RETURN(numWheels<=mMaxNumWheels, "PxVehicleTelemetryRecorder::record - too many wheels");
+
+	mSampleTide=(mSampleTide+1)%mNumSamples;
+	mNumRecordedSamples=PxMin(mNumRecordedSamples+1, mNumSamples);
+	mSampleNumVehicles[mSampleTide]=numVehicles;
+	mSampleNumWheels[mSampleTide]=numWheels;
+
+	//Let the wheel query write the wheel channels straight into the sample.
+	PxReal* sample=mSamples + mSampleTide*mSampleSize;
+	PxVehicleWheelQueryResults wheelQueryResults;
+	wheelQueryResults.suspJounce=sample + eCHANNEL_JOUNCE*mMaxNumWheels;
+	wheelQueryResults.suspSpringForce=sample + eCHANNEL_SUSPFORCE*mMaxNumWheels;
+	wheelQueryResults.tireLongSlip=sample + eCHANNEL_TIRE_LONG_SLIP*mMaxNumWheels;
+	wheelQueryResults.tireLatSlip=sample + eCHANNEL_TIRE_LAT_SLIP*mMaxNumWheels;
+	wheelQueryResults.tireFriction=sample + eCHANNEL_TIRE_FRICTION*mMaxNumWheels;
+	wheelQueryResults.wheelRotationSpeed=sample + eCHANNEL_WHEEL_OMEGA*mMaxNumWheels;
+	wheelQueryResults.steerAngle=sample + eCHANNEL_STEER_ANGLE*mMaxNumWheels;
+	wheelQueryResults.numWheels=mMaxNumWheels;
+	PxVehicleGetWheelQueryResults(numVehicles, vehicles, wheelQueryResults);
+
+	PxReal* engineRevs=sample + eMAX_NUM_WHEEL_CHANNELS*mMaxNumWheels + eCHANNEL_ENGINE_REVS*mMaxNumVehicles;
+	PxReal* gears=sample + eMAX_NUM_WHEEL_CHANNELS*mMaxNumWheels + eCHANNEL_GEAR*mMaxNumVehicles;
+	for(PxU32 i=0;i<numVehicles;i++)
+	{
+		if(eVEHICLE_TYPE_NODRIVE!=vehicles[i]->getVehicleType())
+		{
+			const PxVehicleDrive* vehDrive=(const PxVehicleDrive*)vehicles[i];
+			engineRevs[i]=vehDrive->mDriveDynData.getEngineRotationSpeed();
+			gears[i]=(PxReal)vehDrive->mDriveDynData.getCurrentGear();
+		}
+		else
+		{
+			engineRevs[i]=0.0f;
+			gears[i]=0.0f;
+		}
+	}
+}
+
 } //physx
 
 
@@ -0,0 +1,413 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+  
+
+
+// Headless summary of profile event streams written by PxProfileZoneAggregator::saveStream().
+//
+//	ProfileZoneStats <stream> [options]
+//		-csv					print the report as comma separated values instead of JSON
+//		-o <file>				write the report to a file instead of stdout
+//		-compare <baseline>		compare against a CSV report of this tool, exit with 2 if an event regressed
+//		-metric <column>		CSV column to compare: incl_p50_ms, incl_p95_ms (default), incl_p99_ms, excl_p95_ms, ...
+//		-threshold <percent>	allowed increase over the baseline, default 10
+//		-min <ms>				ignore increases smaller than this, default 0.01
+
+#include "PxProfileZoneAggregator.h"
+#include "PxDefaultAllocator.h"
+#include "ExtProfileZoneStatistics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace physx;
+
+namespace
+{
+	class FileOutputStream : public PxOutputStream
+	{
+	public:
+		FileOutputStream(FILE* fp) : mFile(fp)	{}
+		virtual PxU32 write(const void* src, PxU32 count)
+		{
+			return PxU32(fwrite(src, 1, count, mFile));
+		}
+	private:
+		FILE* mFile;
+	};
+
+	bool readFile(const char* filename, std::vector<PxU8>& bytes)
+	{
+		FILE* fp = fopen(filename, "rb");
+		if(!fp)
+			return false;
+		fseek(fp, 0, SEEK_END);
+		const long size = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		bool ok = size >= 0;
+		if(ok)
+		{
+			bytes.resize(size_t(size));
+			ok = size == 0 || fread(&bytes[0], size_t(size), 1, fp) == 1;
+		}
+		fclose(fp);
+		return ok;
+	}
+
+	PxU32 readU32(const PxU8* src)
+	{
+		PxU32 value;
+		memcpy(&value, src, sizeof(value));
+		return value;
+	}
+
+	// A name payload has to be null terminated within the record.
+	const char* readName(const PxU8* src, PxU32 length)
+	{
+		return length && src[length - 1] == 0 ? reinterpret_cast<const char*>(src) : NULL;
+	}
+
+	bool loadStream(const char* filename, Ext::ProfileZoneStatistics& statistics)
+	{
+		std::vector<PxU8> bytes;
+		if(!readFile(filename, bytes))
+		{
+			fprintf(stderr, "error: cannot read %s\n", filename);
+			return false;
+		}
+
+		const size_t size = bytes.size();
+		PxProfileZoneStreamFileHeader header;
+		if(size < sizeof(header))
+		{
+			fprintf(stderr, "error: %s is too small for a profile stream\n", filename);
+			return false;
+		}
+		memcpy(&header, &bytes[0], sizeof(header));
+		if(header.magic != PxProfileZoneStreamFileHeader::eMAGIC)
+		{
+			fprintf(stderr, "error: %s is not a profile stream or was written on a platform with different byte order\n", filename);
+			return false;
+		}
+		if(header.version != PxProfileZoneStreamFileHeader::eVERSION)
+		{
+			fprintf(stderr, "error: %s has stream version %u, expected %u\n", filename, header.version, PxU32(PxProfileZoneStreamFileHeader::eVERSION));
+			return false;
+		}
+		if(!header.timestampNumerator || !header.timestampDenominator)
+		{
+			fprintf(stderr, "error: %s has no timestamp frequency\n", filename);
+			return false;
+		}
+		statistics.setTimestampFrequency(header.timestampNumerator, header.timestampDenominator);
+
+		size_t offset = sizeof(header);
+		while(offset < size)
+		{
+			if(size - offset < 2 * sizeof(PxU32) || size - offset - 2 * sizeof(PxU32) < readU32(&bytes[offset + 4]))
+			{
+				fprintf(stderr, "error: %s is truncated\n", filename);
+				return false;
+			}
+			const PxU32 type = readU32(&bytes[offset]);
+			const PxU32 length = readU32(&bytes[offset + 4]);
+			const PxU8* payload = &bytes[offset + 8];
+			offset += 8 + length;
+
+			bool ok = true;
+			switch(type)
+			{
+			case PxProfileZoneStreamRecord::eZONE:
+				{
+					const char* name = length > 4 ? readName(payload + 4, length - 4) : NULL;
+					ok = name && statistics.addZone(name) == readU32(payload);
+				}
+				break;
+			case PxProfileZoneStreamRecord::eEVENT_NAME:
+				{
+					const char* name = length > 8 ? readName(payload + 8, length - 8) : NULL;
+					const PxU32 zone = name ? readU32(payload) : 0;
+					ok = name && zone < statistics.getNbZones();
+					if(ok)
+						statistics.addEventName(zone, PxU16(readU32(payload + 4)), name);
+				}
+				break;
+			case PxProfileZoneStreamRecord::eEVENTS:
+				{
+					const PxU32 zone = length >= 4 ? readU32(payload) : 0;
+					ok = length >= 4 && zone < statistics.getNbZones() && statistics.addEvents(zone, payload + 4, length - 4);
+				}
+				break;
+			case PxProfileZoneStreamRecord::eEND_FRAME:
+				statistics.endFrame();
+				break;
+			default:
+				// unknown records are skipped so older tools can read newer streams
+				break;
+			}
+			if(!ok)
+			{
+				fprintf(stderr, "error: %s has a corrupt record of type %u at offset %u\n", filename, type, PxU32(offset - 8 - length));
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Splits a CSV line, honoring quoted fields with doubled quotes.
+	void splitCsvLine(const std::string& line, std::vector<std::string>& fields)
+	{
+		fields.clear();
+		std::string field;
+		bool quoted = false;
+		for(size_t i = 0; i < line.size(); i++)
+		{
+			const char c = line[i];
+			if(quoted)
+			{
+				if(c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+					field += line[++i];
+				else if(c == '"')
+					quoted = false;
+				else
+					field += c;
+			}
+			else if(c == '"')
+				quoted = true;
+			else if(c == ',')
+			{
+				fields.push_back(field);
+				field.clear();
+			}
+			else if(c != '\r' && c != '\n')
+				field += c;
+		}
+		fields.push_back(field);
+	}
+
+	typedef std::map<std::string, double> MetricMap;	// "zone/event" to value
+
+	bool readBaseline(const char* filename, const char* metric, MetricMap& values)
+	{
+		FILE* fp = fopen(filename, "rb");
+		if(!fp)
+		{
+			fprintf(stderr, "error: cannot read %s\n", filename);
+			return false;
+		}
+		std::vector<std::string> fields;
+		std::string line;
+		size_t zoneColumn = 0, eventColumn = 0, metricColumn = 0;
+		bool haveHeader = false;
+		bool ok = true;
+		for(int c = fgetc(fp); ok && c != EOF; c = fgetc(fp))
+		{
+			if(c != '\n')
+			{
+				line += char(c);
+				continue;
+			}
+			splitCsvLine(line, fields);
+			line.clear();
+			if(!haveHeader)
+			{
+				zoneColumn = eventColumn = metricColumn = fields.size();
+				for(size_t i = 0; i < fields.size(); i++)
+				{
+					if(fields[i] == "zone")		zoneColumn = i;
+					if(fields[i] == "event")	eventColumn = i;
+					if(fields[i] == metric)		metricColumn = i;
+				}
+				if(zoneColumn == fields.size() || eventColumn == fields.size() || metricColumn == fields.size())
+				{
+					fprintf(stderr, "error: %s has no zone, event or %s column\n", filename, metric);
+					ok = false;
+				}
+				haveHeader = true;
+			}
+			else if(fields.size() > metricColumn && fields.size() > zoneColumn && fields.size() > eventColumn)
+				values[fields[zoneColumn] + "/" + fields[eventColumn]] = atof(fields[metricColumn].c_str());
+		}
+		fclose(fp);
+		if(ok && !haveHeader)
+		{
+			fprintf(stderr, "error: %s is empty\n", filename);
+			ok = false;
+		}
+		return ok;
+	}
+
+	bool getMetric(const PxProfileZoneEventStats& s, const char* metric, double& value)
+	{
+		struct Column { const char* name; double value; };
+		const Column columns[] = 
+		{
+			{ "incl_total_ms", s.inclusiveTotal }, { "incl_p50_ms", s.inclusiveP50 }, { "incl_p95_ms", s.inclusiveP95 }, 
+			{ "incl_p99_ms", s.inclusiveP99 }, { "incl_max_ms", s.inclusiveMax },
+			{ "excl_total_ms", s.exclusiveTotal }, { "excl_p50_ms", s.exclusiveP50 }, { "excl_p95_ms", s.exclusiveP95 }, 
+			{ "excl_p99_ms", s.exclusiveP99 }, { "excl_max_ms", s.exclusiveMax },
+			{ "calls", double(s.numCalls) }, { "frames", double(s.numFrames) }
+		};
+		for(size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); i++)
+		{
+			if(!strcmp(metric, columns[i].name))
+			{
+				value = columns[i].value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Returns the number of regressed events.
+	PxU32 compare(const std::vector<PxProfileZoneEventStats>& stats, const MetricMap& baseline, const char* metric, double threshold, double minDelta)
+	{
+		PxU32 numRegressions = 0, numCompared = 0;
+		fprintf(stderr, "comparing %s, threshold %.1f%%, min %.3f ms\n", metric, threshold, minDelta);
+		for(size_t i = 0; i < stats.size(); i++)
+		{
+			const PxProfileZoneEventStats& s = stats[i];
+			const MetricMap::const_iterator base = baseline.find(std::string(s.zoneName) + "/" + s.eventName);
+			if(base == baseline.end())
+			{
+				fprintf(stderr, "  new       %s/%s\n", s.zoneName, s.eventName);
+				continue;
+			}
+			double value = 0.0;
+			getMetric(s, metric, value);
+			numCompared++;
+			const double delta = value - base->second;
+			if(delta > minDelta && value > base->second * (1.0 + threshold / 100.0))
+			{
+				const double percent = base->second > 0.0 ? 100.0 * delta / base->second : 100.0;
+				fprintf(stderr, "  REGRESSED %s/%s: %.3f -> %.3f (+%.1f%%)\n", s.zoneName, s.eventName, base->second, value, percent);
+				numRegressions++;
+			}
+		}
+		fprintf(stderr, "%u of %u events regressed\n", numRegressions, numCompared);
+		return numRegressions;
+	}
+
+	void usage()
+	{
+		fprintf(stderr, 
+			"usage: ProfileZoneStats <stream> [options]\n"
+			"  -csv                  print the report as comma separated values instead of JSON\n"
+			"  -o <file>             write the report to a file instead of stdout\n"
+			"  -compare <baseline>   compare against a CSV report, exit with 2 if an event regressed\n"
+			"  -metric <column>      incl_p95_ms (default), incl_p50_ms, incl_p99_ms, excl_p95_ms, ...\n"
+			"  -threshold <percent>  allowed increase over the baseline, default 10\n"
+			"  -min <ms>             ignore increases smaller than this, default 0.01\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		usage();
+		return 1;
+	}
+
+	const char* streamName = argv[1];
+	const char* outputName = NULL;
+	const char* baselineName = NULL;
+	const char* metric = "incl_p95_ms";
+	double threshold = 10.0, minDelta = 0.01;
+	PxProfileZoneReportFormat::Enum format = PxProfileZoneReportFormat::eJSON;
+
+	for(int i = 2; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		if(!strcmp(arg, "-csv"))
+			format = PxProfileZoneReportFormat::eCSV;
+		else if(!strcmp(arg, "-o") && i + 1 < argc)
+			outputName = argv[++i];
+		else if(!strcmp(arg, "-compare") && i + 1 < argc)
+			baselineName = argv[++i];
+		else if(!strcmp(arg, "-metric") && i + 1 < argc)
+			metric = argv[++i];
+		else if(!strcmp(arg, "-threshold") && i + 1 < argc)
+			threshold = atof(argv[++i]);
+		else if(!strcmp(arg, "-min") && i + 1 < argc)
+			minDelta = atof(argv[++i]);
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+
+	PxProfileZoneEventStats probe;
+	memset(&probe, 0, sizeof(probe));
+	double unused;
+	if(!getMetric(probe, metric, unused))
+	{
+		fprintf(stderr, "error: unknown metric %s\n", metric);
+		return 1;
+	}
+
+	PxDefaultAllocator allocator;
+	Ext::ProfileZoneStatistics statistics(allocator);
+	if(!loadStream(streamName, statistics))
+		return 1;
+
+	FILE* fp = outputName ? fopen(outputName, "wb") : stdout;
+	if(!fp)
+	{
+		fprintf(stderr, "error: cannot write %s\n", outputName);
+		return 1;
+	}
+	FileOutputStream output(fp);
+	bool ok = statistics.writeReport(output, format);
+	ok = (outputName ? fclose(fp) == 0 : fflush(fp) == 0) && ok;
+	if(!ok)
+	{
+		fprintf(stderr, "error: cannot write %s\n", outputName ? outputName : "the report");
+		return 1;
+	}
+
+	if(baselineName)
+	{
+		MetricMap baseline;
+		if(!readBaseline(baselineName, metric, baseline))
+			return 1;
+		std::vector<PxProfileZoneEventStats> stats(statistics.getNbEventStats());
+		if(!stats.empty())
+			statistics.computeEventStats(&stats[0]);
+		if(compare(stats, baseline, metric, threshold, minDelta))
+			return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,388 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+  
+
+// Headless inspection of captures written by PxVisualDebuggerCapture::save().
+//
+//	PvdCaptureStats <capture> [options]
+//		-frames				print one line per frame
+//		-csv				print the frames as comma separated values
+//		-worst <n>			print the n worst frames
+//		-sort <key>			key for -worst and -extract: time (default), contacts, actors, profile, allocs, bytes
+//		-extract <n> <file>	write a capture holding the n worst frames
+//		-pvd <file>			write the raw PVD stream, loadable by PVD if no frames were dropped
+
+#include "extensions/PxVisualDebuggerCapture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+using namespace physx;
+
+namespace
+{
+	struct CaptureFrame
+	{
+		PxVisualDebuggerCaptureFrameStats	stats;
+		PxU32								dataOffset;		// offset of the PVD data in Capture::bytes
+	};
+
+	struct Capture
+	{
+		PxVisualDebuggerCaptureFileHeader	header;
+		std::vector<PxU8>					bytes;
+		PxU32								prologueOffset;
+		std::vector<CaptureFrame>			frames;
+	};
+
+	enum SortKey
+	{
+		eSORT_TIME,
+		eSORT_CONTACTS,
+		eSORT_ACTORS,
+		eSORT_PROFILE,
+		eSORT_ALLOCS,
+		eSORT_BYTES
+	};
+
+	const char* gSortKeyNames[] = { "time", "contacts", "actors", "profile", "allocs", "bytes" };
+
+	double sortValue(const PxVisualDebuggerCaptureFrameStats& s, SortKey key)
+	{
+		switch(key)
+		{
+		case eSORT_TIME:		return s.frameTime;
+		case eSORT_CONTACTS:	return s.numContactPairs;
+		case eSORT_ACTORS:		return s.numActiveDynamicBodies;
+		case eSORT_PROFILE:		return s.numProfileEvents;
+		case eSORT_ALLOCS:		return s.numAllocations;
+		case eSORT_BYTES:		return s.pvdByteCount;
+		}
+		return 0.0;
+	}
+
+	struct WorseFrame
+	{
+		SortKey mKey;
+		WorseFrame(SortKey key) : mKey(key) {}
+		bool operator()(const CaptureFrame& a, const CaptureFrame& b) const
+		{
+			const double va = sortValue(a.stats, mKey), vb = sortValue(b.stats, mKey);
+			return va != vb ? va > vb : a.stats.frameIndex < b.stats.frameIndex;
+		}
+	};
+
+	struct EarlierFrame
+	{
+		bool operator()(const CaptureFrame& a, const CaptureFrame& b) const
+		{
+			return a.stats.frameIndex < b.stats.frameIndex;
+		}
+	};
+
+	bool readFile(const char* filename, std::vector<PxU8>& bytes)
+	{
+		FILE* fp = fopen(filename, "rb");
+		if(!fp)
+			return false;
+		fseek(fp, 0, SEEK_END);
+		const long size = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		bool ok = size >= 0;
+		if(ok)
+		{
+			bytes.resize(size_t(size));
+			ok = size == 0 || fread(&bytes[0], size_t(size), 1, fp) == 1;
+		}
+		fclose(fp);
+		return ok;
+	}
+
+	bool loadCapture(const char* filename, Capture& capture)
+	{
+		if(!readFile(filename, capture.bytes))
+		{
+			fprintf(stderr, "error: cannot read %s\n", filename);
+			return false;
+		}
+
+		const size_t size = capture.bytes.size();
+		if(size < sizeof(PxVisualDebuggerCaptureFileHeader))
+		{
+			fprintf(stderr, "error: %s is too small for a capture\n", filename);
+			return false;
+		}
+		memcpy(&capture.header, &capture.bytes[0], sizeof(capture.header));
+		const PxVisualDebuggerCaptureFileHeader& header = capture.header;
+		if(header.magic != PxVisualDebuggerCaptureFileHeader::eMAGIC)
+		{
+			fprintf(stderr, "error: %s is not a capture or was written on a platform with different byte order\n", filename);
+			return false;
+		}
+		if(header.version != PxVisualDebuggerCaptureFileHeader::eVERSION)
+		{
+			fprintf(stderr, "error: %s has capture version %u, expected %u\n", filename, header.version, PxU32(PxVisualDebuggerCaptureFileHeader::eVERSION));
+			return false;
+		}
+		if(header.frameStatsSize < sizeof(PxVisualDebuggerCaptureFrameStats))
+		{
+			fprintf(stderr, "error: %s has %u byte frame records, expected at least %u\n", filename, header.frameStatsSize, PxU32(sizeof(PxVisualDebuggerCaptureFrameStats)));
+			return false;
+		}
+
+		size_t offset = sizeof(header);
+		capture.prologueOffset = PxU32(offset);
+		offset += header.prologueByteCount;
+		capture.frames.resize(header.numFrames);
+		for(PxU32 i = 0; i < header.numFrames; i++)
+		{
+			if(offset > size || size - offset < header.frameStatsSize)
+			{
+				fprintf(stderr, "error: %s is truncated, it holds %u of %u frames\n", filename, i, header.numFrames);
+				return false;
+			}
+			CaptureFrame& frame = capture.frames[i];
+			memcpy(&frame.stats, &capture.bytes[offset], sizeof(frame.stats));
+			offset += header.frameStatsSize;
+			frame.dataOffset = PxU32(offset);
+			offset += frame.stats.pvdByteCount;
+		}
+		if(offset > size)
+		{
+			fprintf(stderr, "error: %s is truncated\n", filename);
+			return false;
+		}
+		return true;
+	}
+
+	void printFrameHeader(bool csv)
+	{
+		if(csv)
+			printf("frame,time_ms,static,dynamic,active,constraints,contacts,zones,profile_events,allocs,deallocs,alloc_bytes,pvd_bytes\n");
+		else
+			printf("%8s %9s %7s %7s %7s %7s %8s %5s %8s %7s %7s %10s %10s\n", 
+				"frame", "time(ms)", "static", "dynamic", "active", "constr", "contacts", "zones", "prof.evt", "allocs", "deallocs", "allocbytes", "pvdbytes");
+	}
+
+	void printFrame(const PxVisualDebuggerCaptureFrameStats& s, bool csv)
+	{
+		const char* format = csv ? "%u,%.3f,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n" : "%8u %9.3f %7u %7u %7u %7u %8u %5u %8u %7u %7u %10u %10u\n";
+		printf(format, s.frameIndex, s.frameTime * 1000.0f, s.numStaticBodies, s.numDynamicBodies, s.numActiveDynamicBodies, s.numActiveConstraints,
+			s.numContactPairs, s.numProfileZones, s.numProfileEvents, s.numAllocations, s.numDeallocations, s.allocatedBytes, s.pvdByteCount);
+	}
+
+	void printSummary(const char* filename, const Capture& capture)
+	{
+		const std::vector<CaptureFrame>& frames = capture.frames;
+		printf("capture          %s\n", filename);
+		printf("frames           %u (%u dropped)\n", capture.header.numFrames, capture.header.numDroppedFrames);
+		printf("prologue         %u bytes\n", capture.header.prologueByteCount);
+		if(frames.empty())
+			return;
+
+		double totalTime = 0.0, maxTime = 0.0;
+		PxU64 totalContacts = 0, totalProfileEvents = 0, totalAllocs = 0, totalAllocBytes = 0, totalBytes = 0;
+		PxU32 maxContacts = 0, maxActive = 0;
+		for(size_t i = 0; i < frames.size(); i++)
+		{
+			const PxVisualDebuggerCaptureFrameStats& s = frames[i].stats;
+			totalTime += s.frameTime;
+			maxTime = std::max<double>(maxTime, s.frameTime);
+			totalContacts += s.numContactPairs;
+			maxContacts = std::max(maxContacts, s.numContactPairs);
+			maxActive = std::max(maxActive, s.numActiveDynamicBodies);
+			totalProfileEvents += s.numProfileEvents;
+			totalAllocs += s.numAllocations;
+			totalAllocBytes += s.allocatedBytes;
+			totalBytes += s.pvdByteCount;
+		}
+		const double n = double(frames.size());
+		printf("frame time       avg %.3f ms, max %.3f ms\n", totalTime * 1000.0 / n, maxTime * 1000.0);
+		printf("contact pairs    avg %.1f, max %u\n", double(totalContacts) / n, maxContacts);
+		printf("active dynamics  max %u\n", maxActive);
+		printf("profile events   avg %.1f\n", double(totalProfileEvents) / n);
+		printf("allocations      avg %.1f, avg %.1f bytes\n", double(totalAllocs) / n, double(totalAllocBytes) / n);
+		printf("pvd data         avg %.1f bytes\n", double(totalBytes) / n);
+	}
+
+	bool writeBytes(FILE* fp, const PxU8* data, size_t size)
+	{
+		return size == 0 || fwrite(data, size, 1, fp) == 1;
+	}
+
+	bool writeCapture(const char* filename, const Capture& capture, const std::vector<CaptureFrame>& frames)
+	{
+		FILE* fp = fopen(filename, "wb");
+		if(!fp)
+			return false;
+		PxVisualDebuggerCaptureFileHeader header = capture.header;
+		header.frameStatsSize = sizeof(PxVisualDebuggerCaptureFrameStats);
+		header.numFrames = PxU32(frames.size());
+		header.numDroppedFrames = capture.header.numDroppedFrames + capture.header.numFrames - header.numFrames;
+		bool ok = writeBytes(fp, reinterpret_cast<const PxU8*>(&header), sizeof(header));
+		ok = ok && writeBytes(fp, &capture.bytes[capture.prologueOffset], header.prologueByteCount);
+		for(size_t i = 0; ok && i < frames.size(); i++)
+		{
+			ok = writeBytes(fp, reinterpret_cast<const PxU8*>(&frames[i].stats), sizeof(frames[i].stats));
+			ok = ok && writeBytes(fp, &capture.bytes[frames[i].dataOffset], frames[i].stats.pvdByteCount);
+		}
+		return (fclose(fp) == 0) && ok;
+	}
+
+	bool writePvdStream(const char* filename, const Capture& capture)
+	{
+		FILE* fp = fopen(filename, "wb");
+		if(!fp)
+			return false;
+		bool ok = writeBytes(fp, &capture.bytes[capture.prologueOffset], capture.header.prologueByteCount);
+		for(size_t i = 0; ok && i < capture.frames.size(); i++)
+			ok = writeBytes(fp, &capture.bytes[capture.frames[i].dataOffset], capture.frames[i].stats.pvdByteCount);
+		return (fclose(fp) == 0) && ok;
+	}
+
+	void usage()
+	{
+		fprintf(stderr, 
+			"usage: PvdCaptureStats <capture> [options]\n"
+			"  -frames              print one line per frame\n"
+			"  -csv                 print the frames as comma separated values\n"
+			"  -worst <n>           print the n worst frames\n"
+			"  -sort <key>          time (default), contacts, actors, profile, allocs, bytes\n"
+			"  -extract <n> <file>  write a capture holding the n worst frames\n"
+			"  -pvd <file>          write the raw PVD stream of the capture\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		usage();
+		return 1;
+	}
+
+	const char* captureName = argv[1];
+	bool printFrames = false, csv = false;
+	PxU32 numWorst = 0, numExtract = 0;
+	const char* extractName = NULL;
+	const char* pvdName = NULL;
+	SortKey sortKey = eSORT_TIME;
+
+	for(int i = 2; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		if(!strcmp(arg, "-frames"))
+			printFrames = true;
+		else if(!strcmp(arg, "-csv"))
+			printFrames = csv = true;
+		else if(!strcmp(arg, "-worst") && i + 1 < argc)
+			numWorst = PxU32(atoi(argv[++i]));
+		else if(!strcmp(arg, "-extract") && i + 2 < argc)
+		{
+			numExtract = PxU32(atoi(argv[++i]));
+			extractName = argv[++i];
+		}
+		else if(!strcmp(arg, "-pvd") && i + 1 < argc)
+			pvdName = argv[++i];
+		else if(!strcmp(arg, "-sort") && i + 1 < argc)
+		{
+			const char* key = argv[++i];
+			PxU32 k = 0;
+			while(k <= eSORT_BYTES && strcmp(key, gSortKeyNames[k]))
+				k++;
+			if(k > eSORT_BYTES)
+			{
+				fprintf(stderr, "error: unknown sort key %s\n", key);
+				return 1;
+			}
+			sortKey = SortKey(k);
+		}
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+
+	Capture capture;
+	if(!loadCapture(captureName, capture))
+		return 1;
+
+	if(!csv)
+		printSummary(captureName, capture);
+
+	if(printFrames)
+	{
+		printFrameHeader(csv);
+		for(size_t i = 0; i < capture.frames.size(); i++)
+			printFrame(capture.frames[i].stats, csv);
+	}
+
+	if(numWorst || numExtract)
+	{
+		std::vector<CaptureFrame> sorted(capture.frames);
+		std::stable_sort(sorted.begin(), sorted.end(), WorseFrame(sortKey));
+
+		if(numWorst)
+		{
+			printf("\nworst %u frames by %s\n", numWorst, gSortKeyNames[sortKey]);
+			printFrameHeader(false);
+			for(size_t i = 0; i < sorted.size() && i < numWorst; i++)
+				printFrame(sorted[i].stats, false);
+		}
+
+		if(numExtract)
+		{
+			// keep the extracted frames in recording order
+			std::vector<CaptureFrame> extracted(sorted.begin(), sorted.begin() + std::min<size_t>(sorted.size(), numExtract));
+			std::sort(extracted.begin(), extracted.end(), EarlierFrame());
+			if(!writeCapture(extractName, capture, extracted))
+			{
+				fprintf(stderr, "error: cannot write %s\n", extractName);
+				return 1;
+			}
+		}
+	}
+
+	if(pvdName)
+	{
+		if(capture.header.numDroppedFrames)
+			fprintf(stderr, "warning: %u frames were dropped, objects created in them are missing from %s\n", capture.header.numDroppedFrames, pvdName);
+		if(!writePvdStream(pvdName, capture))
+		{
+			fprintf(stderr, "error: cannot write %s\n", pvdName);
+			return 1;
+		}
+	}
+
+	return 0;
+}
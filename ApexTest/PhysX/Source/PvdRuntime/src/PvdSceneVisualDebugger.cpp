@@ -287,6 +287,8 @@ void SceneVisualDebugger::setPvdConnection(physx::debugger::comm::PvdDataStream*
 	mConnectionType = inConnectionType;
 
 	mPvdConnection = c;
+	//A new connection has not seen anything yet.
+	mStreamingFilter.reset();
 
 	if(mPvdConnection)
 		c->addRef();
@@ -426,6 +428,10 @@ void SceneVisualDebugger::frameStart(PxReal simElapsedTime)
 {
 	if(!isConnected())
 		return;
+	VisualDebugger& sdkPvd = NpPhysics::getInstance().getPhysics()->getVisualDebugger();
+	mStreamingFilter.setEnabled( sdkPvd.isDeltaStreaming() );
+	mStreamingFilter.setSettings( sdkPvd.getStreamingSettings() );
+	mStreamingFilter.beginFrame( simElapsedTime );
 	mMetaDataBinding.sendBeginFrame( *mPvdConnection, mScbScene.getPxScene(), simElapsedTime );
 	mPvdConnection->flush();
 }
@@ -464,7 +470,8 @@ void SceneVisualDebugger::frameEnd()
 	VisualDebugger& sdkPvd = NpPhysics::getInstance().getPhysics()->getVisualDebugger();
 
 
-	if(isConnectedAndSendingDebugInformation())
+	//With delta streaming, frames skipped by the update rate only carry stats and contacts.
+	if(isConnectedAndSendingDebugInformation() && mStreamingFilter.isTransmitFrame())
 	{
 		const bool visualizeJoints = sdkPvd.isVisualizingConstraints();
 		if ( visualizeJoints && mImmediateRenderer == NULL )
@@ -483,7 +490,7 @@ void SceneVisualDebugger::frameEnd()
 			PvdVisualizer* vizualizer = NULL;
 			if ( visualizeJoints ) vizualizer = this;
 			CM_PROFILE_ZONE_WITH_SUBSYSTEM( mScbScene,PVD,sceneUpdate );
-			mMetaDataBinding.updateDynamicActorsAndArticulations( *mPvdConnection, theScene, vizualizer );
+			mMetaDataBinding.updateDynamicActorsAndArticulations( *mPvdConnection, theScene, vizualizer, &mStreamingFilter );
 		}
 
 #if PX_USE_PARTICLE_SYSTEM_API
@@ -509,6 +516,7 @@ void SceneVisualDebugger::frameEnd()
 #endif
 		// frame end moved to update contacts to have them in the previous frame.
 	}
+	mStreamingFilter.endFrame();
 }
 
 
@@ -627,6 +635,7 @@ void SceneVisualDebugger::updatePvdProperties(const PxActor* scbActor)
 
 void SceneVisualDebugger::releasePvdInstance(const PxActor* scbActor)
 {
+	mStreamingFilter.releaseInstance( scbActor );
 	if ( isConnectedAndSendingDebugInformation() == false ) return;
 	//VisualDebugger& sdkPvd = NpPhysics::getInstance().getPhysics()->getVisualDebugger();
 	PxScene* theScene = mScbScene.getPxScene();
@@ -827,9 +836,9 @@ void SceneVisualDebugger::sendArrays(Scb::ParticleSystem* scbParticleSys)
 	const PxActor* pxActor = getPxActor(scbParticleSys);
 	PxActorType::Enum type = pxActor->getType();
 	if ( type == PxActorType::ePARTICLE_SYSTEM )
-		mMetaDataBinding.sendArrays( *mPvdConnection, *static_cast<const PxParticleSystem*>( pxActor ), readData, rdFlags );
+		mMetaDataBinding.sendArrays( *mPvdConnection, *static_cast<const PxParticleSystem*>( pxActor ), readData, rdFlags, &mStreamingFilter );
 	else if ( type == PxActorType::ePARTICLE_FLUID )
-		mMetaDataBinding.sendArrays( *mPvdConnection, *static_cast<const PxParticleFluid*>( pxActor ), readData, rdFlags );
+		mMetaDataBinding.sendArrays( *mPvdConnection, *static_cast<const PxParticleFluid*>( pxActor ), readData, rdFlags, &mStreamingFilter );
 }
 
 void SceneVisualDebugger::updatePvdProperties(Scb::ParticleSystem* scbParticleSys)
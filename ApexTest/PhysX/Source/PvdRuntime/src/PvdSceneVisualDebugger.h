@@ -37,6 +37,7 @@
 #include "PsArray.h"
 #include "CmPhysXCommon.h"
 #include "PxMetaDataPvdBinding.h"
+#include "PvdStreamingFilter.h"
 
 namespace physx { namespace debugger {
 	namespace comm {
@@ -193,6 +194,8 @@ public:
 
 	void updateJoints();
 
+	PxU32 getBytesSentLastFrame() const { return mStreamingFilter.getBytesSentLastFrame(); }
+
 	//PvdVisualizer
 	virtual void visualize( PxArticulationLink& link );
 	
@@ -206,6 +209,7 @@ private:
 	Ps::Array<PxU64>					mProfileZoneIdList;
 	PxU32								mConnectionType;
 	PvdMetaDataBinding					mMetaDataBinding;
+	StreamingFilter						mStreamingFilter;
 };
 
 } // namespace Pvd
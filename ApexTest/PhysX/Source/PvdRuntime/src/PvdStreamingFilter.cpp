@@ -0,0 +1,210 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+// suppress LNK4221
+#include "PxPreprocessor.h"
+PX_DUMMY_SYMBOL
+
+#if PX_SUPPORT_VISUAL_DEBUGGER
+
+#include "PvdStreamingFilter.h"
+#include "PsMathUtils.h"
+
+namespace physx
+{
+namespace Pvd
+{
+
+StreamingFilter::StreamingFilter()
+: mRotationSinTolerance(0.0f)
+, mElapsedSinceTransmit(0.0f)
+, mBytesSentThisFrame(0)
+, mBytesSentLastFrame(0)
+, mEnabled(false)
+, mTransmitFrame(true)
+, mSentStates(PX_DEBUG_EXP("PvdStreamingFilter::mSentStates"))
+, mSentArrays(PX_DEBUG_EXP("PvdStreamingFilter::mSentArrays"))
+{
+	setSettings(StreamingSettings());
+}
+
+
+StreamingFilter::~StreamingFilter()
+{
+}
+
+
+void StreamingFilter::setSettings(const StreamingSettings& settings)
+{
+	PX_ASSERT(settings.isValid());
+	mSettings = settings;
+	// two unit quaternions q0, q1 are within angle a of each other if the imaginary part of conj(q0)*q1 is at most
+	// sin(a/2) long. Unlike |dot(q0, q1)| >= cos(a/2) this still resolves milliradians in single precision.
+	const PxReal sinHalfAngle = PxSin(PxMin(settings.rotationTolerance, PxPi) * 0.5f);
+	mRotationSinTolerance = sinHalfAngle * sinHalfAngle;
+}
+
+
+void StreamingFilter::setEnabled(bool enabled)
+{
+	if(enabled != mEnabled)
+		reset();
+	mEnabled = enabled;
+}
+
+
+void StreamingFilter::reset()
+{
+	mSentStates.clear();
+	mSentArrays.clear();
+	mElapsedSinceTransmit = 0.0f;
+	mTransmitFrame = true;
+}
+
+
+bool StreamingFilter::beginFrame(PxReal simulateElapsedTime)
+{
+	mBytesSentThisFrame = 0;
+
+	if(!mEnabled || mSettings.maxUpdateRate <= 0.0f)
+	{
+		mTransmitFrame = true;
+		return true;
+	}
+
+	// decimate: send once at least 1/maxUpdateRate of simulated time passed since the last sent frame
+	mElapsedSinceTransmit += simulateElapsedTime;
+	const PxReal period = 1.0f / mSettings.maxUpdateRate;
+	mTransmitFrame = mElapsedSinceTransmit >= period;
+	if(mTransmitFrame)
+		mElapsedSinceTransmit = PxMin(mElapsedSinceTransmit - period, period);
+	return mTransmitFrame;
+}
+
+
+void StreamingFilter::endFrame()
+{
+	mBytesSentLastFrame = mBytesSentThisFrame;
+	mBytesSentThisFrame = 0;
+}
+
+
+bool StreamingFilter::needsUpdate(const void* instance, const PxTransform& pose, const PxVec3& linearVelocity, const PxVec3& angularVelocity)
+{
+	if(!mEnabled)
+		return true;
+
+	const Ps::HashMap<const void*, SentState>::Entry* entry = mSentStates.find(instance);
+	if(entry)
+	{
+		const SentState& last = entry->second;
+		const PxReal positionTolerance = mSettings.positionTolerance;
+		const PxReal velocityTolerance = mSettings.velocityTolerance;
+
+		const bool changed = (pose.p - last.pose.p).magnitudeSquared() > positionTolerance * positionTolerance
+			|| (last.pose.q.getConjugate() * pose.q).getImaginaryPart().magnitudeSquared() > mRotationSinTolerance
+			|| (linearVelocity - last.linearVelocity).magnitudeSquared() > velocityTolerance * velocityTolerance
+			|| (angularVelocity - last.angularVelocity).magnitudeSquared() > velocityTolerance * velocityTolerance;
+
+		if(!changed)
+			return false;
+	}
+
+	SentState& state = mSentStates[instance];
+	state.pose = pose;
+	state.linearVelocity = linearVelocity;
+	state.angularVelocity = angularVelocity;
+	return true;
+}
+
+
+void StreamingFilter::quantizePositions(PxVec3* positions, PxU32 count) const
+{
+	const PxReal quantum = mSettings.particlePositionQuantum;
+	if(!mEnabled || quantum <= 0.0f)
+		return;
+
+	const PxReal invQuantum = 1.0f / quantum;
+	for(PxU32 i = 0; i < count; i++)
+	{
+		PxVec3& p = positions[i];
+		p.x = Ps::floor(p.x * invQuantum + 0.5f) * quantum;
+		p.y = Ps::floor(p.y * invQuantum + 0.5f) * quantum;
+		p.z = Ps::floor(p.z * invQuantum + 0.5f) * quantum;
+	}
+}
+
+
+bool StreamingFilter::needsArrayUpdate(const void* instance, PxU32 propertyKey, const void* data, PxU32 numBytes)
+{
+	if(!mEnabled)
+		return true;
+
+	// FNV-1a over the (quantized) payload
+	PxU32 contentHash = 2166136261u;
+	const PxU8* bytes = reinterpret_cast<const PxU8*>(data);
+	for(PxU32 i = 0; i < numBytes; i++)
+		contentHash = (contentHash ^ bytes[i]) * 16777619u;
+
+	SentArrays& arrays = mSentArrays[instance];
+	for(PxU32 i = 0; i < arrays.nbProperties; i++)
+	{
+		if(arrays.propertyKeys[i] != propertyKey)
+			continue;
+
+		if(arrays.contentHashes[i] == contentHash && arrays.numBytes[i] == numBytes)
+			return false;
+
+		arrays.contentHashes[i] = contentHash;
+		arrays.numBytes[i] = numBytes;
+		return true;
+	}
+
+	if(arrays.nbProperties < MAX_ARRAY_PROPERTIES)
+	{
+		const PxU32 i = arrays.nbProperties++;
+		arrays.propertyKeys[i] = propertyKey;
+		arrays.contentHashes[i] = contentHash;
+		arrays.numBytes[i] = numBytes;
+	}
+	return true;
+}
+
+
+void StreamingFilter::releaseInstance(const void* instance)
+{
+	mSentStates.erase(instance);
+	mSentArrays.erase(instance);
+}
+
+} // namespace Pvd
+
+}
+
+#endif // PX_SUPPORT_VISUAL_DEBUGGER
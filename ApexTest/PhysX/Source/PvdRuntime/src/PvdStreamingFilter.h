@@ -0,0 +1,163 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+#ifndef PVD_STREAMING_FILTER_H
+#define PVD_STREAMING_FILTER_H
+
+#if PX_SUPPORT_VISUAL_DEBUGGER
+
+#include "foundation/PxTransform.h"
+#include "PsUserAllocated.h"
+#include "PsHashMap.h"
+#include "CmPhysXCommon.h"
+
+namespace physx
+{
+namespace Pvd
+{
+
+//////////////////////////////////////////////////////////////////////////
+/*!
+Settings for the reduced per frame PVD stream.
+
+Rigid dynamic and articulation link updates are only sent when the pose or a
+velocity moved more than the given tolerance since the values last sent for
+that actor. Particle positions are snapped to a grid of
+particlePositionQuantum and particle arrays are only sent if their
+(quantized) content changed. Dynamic data is transmitted at most
+maxUpdateRate times per simulated second; frame boundaries and statistics
+are always sent.
+*/
+//////////////////////////////////////////////////////////////////////////
+struct StreamingSettings
+{
+	PxReal	maxUpdateRate;				// maximum number of dynamic updates per simulated second, 0 sends every frame
+	PxReal	positionTolerance;			// distance a pose has to move before it is sent again
+	PxReal	rotationTolerance;			// angle in radians a pose has to rotate before it is sent again
+	PxReal	velocityTolerance;			// change of linear or angular velocity required before it is sent again
+	PxReal	particlePositionQuantum;	// grid spacing particle positions are snapped to, 0 disables quantization
+
+	StreamingSettings()
+		: maxUpdateRate(0.0f)
+		, positionTolerance(1e-3f)
+		, rotationTolerance(1e-3f)
+		, velocityTolerance(1e-2f)
+		, particlePositionQuantum(1e-3f)
+	{
+	}
+
+	bool isValid() const
+	{
+		return maxUpdateRate >= 0.0f && positionTolerance >= 0.0f && rotationTolerance >= 0.0f
+			&& velocityTolerance >= 0.0f && particlePositionQuantum >= 0.0f;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+/*!
+Decides which dynamic data of a scene is sent to PVD when delta streaming
+is enabled, and keeps track of the payload bytes per frame.
+
+The filter only depends on foundation types so the encoding and budget
+decisions can be exercised without a PVD connection.
+*/
+//////////////////////////////////////////////////////////////////////////
+class StreamingFilter : public Ps::UserAllocated
+{
+public:
+	StreamingFilter();
+	~StreamingFilter();
+
+	void	setSettings(const StreamingSettings& settings);
+	const StreamingSettings& getSettings() const				{ return mSettings; }
+
+	void	setEnabled(bool enabled);
+	bool	isEnabled() const										{ return mEnabled; }
+
+	// forget everything sent so far, e.g. after a new connection
+	void	reset();
+
+	// advances the rate limiter, returns true if dynamic data should be sent this frame
+	bool	beginFrame(PxReal simulateElapsedTime);
+	void	endFrame();
+	bool	isTransmitFrame() const									{ return mTransmitFrame; }
+
+	// returns true if the actor moved beyond the tolerances since it was last sent, and records the new state
+	bool	needsUpdate(const void* instance, const PxTransform& pose, const PxVec3& linearVelocity, const PxVec3& angularVelocity);
+
+	// snaps positions to the quantization grid in place
+	void	quantizePositions(PxVec3* positions, PxU32 count) const;
+
+	// returns true if the array content differs from what was last sent for this instance and property
+	bool	needsArrayUpdate(const void* instance, PxU32 propertyKey, const void* data, PxU32 numBytes);
+
+	void	releaseInstance(const void* instance);
+
+	void	addBytesSent(PxU32 numBytes)							{ mBytesSentThisFrame += numBytes; }
+	PxU32	getBytesSentLastFrame() const							{ return mBytesSentLastFrame; }
+
+private:
+	struct SentState
+	{
+		PxTransform	pose;
+		PxVec3		linearVelocity;
+		PxVec3		angularVelocity;
+	};
+
+	static const PxU32 MAX_ARRAY_PROPERTIES = 8;
+
+	struct SentArrays
+	{
+		SentArrays() : nbProperties(0) {}
+
+		PxU32		nbProperties;
+		PxU32		propertyKeys[MAX_ARRAY_PROPERTIES];
+		PxU32		contentHashes[MAX_ARRAY_PROPERTIES];
+		PxU32		numBytes[MAX_ARRAY_PROPERTIES];
+	};
+
+	StreamingSettings						mSettings;
+	PxReal									mRotationSinTolerance;	// squared sine of half the rotation tolerance
+	PxReal									mElapsedSinceTransmit;
+	PxU32									mBytesSentThisFrame;
+	PxU32									mBytesSentLastFrame;
+	bool									mEnabled;
+	bool									mTransmitFrame;
+
+	Ps::HashMap<const void*, SentState>		mSentStates;
+	Ps::HashMap<const void*, SentArrays>	mSentArrays;
+};
+
+} // namespace Pvd
+
+}
+
+#endif // PX_SUPPORT_VISUAL_DEBUGGER
+
+#endif // PVD_STREAMING_FILTER_H
@@ -61,6 +61,7 @@ VisualDebugger::VisualDebugger()
 , mPvdConnectionFactory(NULL)
 , mConstraintVisualize(true)
 , mFlags(0)
+, mDeltaStreaming(false)
 {
 }
 
@@ -137,6 +138,23 @@ PxU32 VisualDebugger::getVisualDebuggerFlags()
 	return mFlags;
 }
 
+void VisualDebugger::setDeltaStreaming(bool enabled)
+{
+	mDeltaStreaming = enabled;
+}
+
+void VisualDebugger::setStreamingSettings(const StreamingSettings& settings)
+{
+	PX_CHECK_AND_RETURN(settings.isValid(), "VisualDebugger::setStreamingSettings: settings are not valid!");
+	mStreamingSettings = settings;
+}
+
+PxU32 VisualDebugger::getBytesSentLastFrame(const PxScene& scene)
+{
+	const NpScene& npScene = static_cast<const NpScene&>(scene);
+	return npScene.getScene().getSceneVisualDebugger().getBytesSentLastFrame();
+}
+
 
 bool VisualDebugger::isConnected()
 { 
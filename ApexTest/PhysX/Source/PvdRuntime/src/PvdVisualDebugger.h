@@ -38,6 +38,7 @@
 #include "PvdConnectionManager.h"
 #include "CmPhysXCommon.h"
 #include "PxMetaDataPvdBinding.h"
+#include "PvdStreamingFilter.h"
 #include "NpFactory.h"
 #include "PxPhysX.h"
 
@@ -103,6 +104,14 @@ public:
 	virtual void setVisualDebuggerFlag(PxVisualDebuggerFlags::Enum flag, bool value);
 	virtual PxU32 getVisualDebuggerFlags();
 
+	// Delta streaming, see StreamingFilter. Not part of PxVisualDebugger, which has to keep the interface of the
+	// prebuilt PvdRuntime library, so it is only available to builds of the runtime from source.
+	void setDeltaStreaming(bool enabled);
+	bool isDeltaStreaming() const										{ return mDeltaStreaming; }
+	void setStreamingSettings(const StreamingSettings& settings);
+	const StreamingSettings& getStreamingSettings() const				{ return mStreamingSettings; }
+	PxU32 getBytesSentLastFrame(const PxScene& scene);
+
 	// internal methods
 	void sendClassDescriptions();
 	bool isConnected();
@@ -182,6 +191,8 @@ private:
 
 	bool							mConstraintVisualize;
 	PxU32							mFlags;
+	bool							mDeltaStreaming;
+	StreamingSettings				mStreamingSettings;
 };
 
 
@@ -61,6 +61,7 @@ PX_DUMMY_SYMBOL
 #include "PvdMetaDataPropertyVisitor.h"
 #include "PvdMetaDataDefineProperties.h"
 #include "PvdMetaDataBindingData.h"
+#include "PvdStreamingFilter.h"
 #include "PxRigidDynamic.h"
 #include "PxArticulation.h"
 #include "PxArticulationLink.h"
@@ -1146,6 +1147,16 @@ void PvdMetaDataBinding::sendAllProperties( PvdDataStream& inStream, const PxArt
 	inStream.setPropertyMessage( &inObj, values );
 }
 
+//Only particle positions are quantized, other buffers are sent as they are.
+template<typename TPropertyType>
+inline void quantizeParticleBuffer( const StreamingFilter&, PxU32, TPropertyType*, PxU32 ) {}
+
+inline void quantizeParticleBuffer( const StreamingFilter& inFilter, PxU32 inKey, PxVec3* inData, PxU32 inCount )
+{
+	if ( inKey == PxPropertyInfoName::PxParticleReadData_PositionBuffer )
+		inFilter.quantizePositions( inData, inCount );
+}
+
 template<typename TReadDataType>
 struct ParticleFluidUpdater
 {
@@ -1154,12 +1165,14 @@ struct ParticleFluidUpdater
 	PvdDataStream& mStream;
 	const void* mInstanceId;
 	PxU32 mRdFlags;
-	ParticleFluidUpdater( TReadDataType& d, PvdDataStream& s, const void* id, PxU32 flags, Array<PxU8>& tempArray )
+	StreamingFilter* mFilter;
+	ParticleFluidUpdater( TReadDataType& d, PvdDataStream& s, const void* id, PxU32 flags, Array<PxU8>& tempArray, StreamingFilter* filter )
 		: mData( d )
 		, mTempU8Array( tempArray )
 		, mStream( s )
 		, mInstanceId( id )
 		, mRdFlags( flags )
+		, mFilter( filter )
 	{
 	}
 
@@ -1197,6 +1210,13 @@ struct ParticleFluidUpdater
 			}
 			PX_ASSERT(tIdx == numValidParticles);
 		}
+		if ( mFilter )
+		{
+			quantizeParticleBuffer( *mFilter, TKey, tmpArray, numValidParticles );
+			if ( !mFilter->needsArrayUpdate( mInstanceId, TKey, propData.begin(), propData.size() ) )
+				return;
+			mFilter->addBytesSent( propData.size() );
+		}
 		mStream.setPropertyValue( mInstanceId, inProp.mName, propData, datatype );
 	}
 	template<PxU32 TKey, typename TObjectType, typename TPropertyType, PxU32 TEnableFlag>
@@ -1231,9 +1251,9 @@ void PvdMetaDataBinding::sendAllProperties( PvdDataStream& inStream, const PxPar
 	PxParticleSystemGeneratedValues values( &inObj );
 	inStream.setPropertyMessage( &inObj, values );
 }
-void PvdMetaDataBinding::sendArrays( PvdDataStream& inStream, const PxParticleSystem& inObj, PxParticleReadData& inData, PxU32 inFlags )
+void PvdMetaDataBinding::sendArrays( PvdDataStream& inStream, const PxParticleSystem& inObj, PxParticleReadData& inData, PxU32 inFlags, StreamingFilter* inFilter )
 {
-	ParticleFluidUpdater<PxParticleReadData> theUpdater( inData, inStream, (const PxActor*)&inObj, inFlags, mBindingData->mTempU8Array );
+	ParticleFluidUpdater<PxParticleReadData> theUpdater( inData, inStream, (const PxActor*)&inObj, inFlags, mBindingData->mTempU8Array, inFilter );
 	visitParticleSystemBufferProperties( makePvdPropertyFilter( theUpdater ) );
 }
 void PvdMetaDataBinding::destroyInstance( PvdDataStream& inStream, const PxParticleSystem& inObj, const PxScene& ownerScene )
@@ -1258,9 +1278,9 @@ void PvdMetaDataBinding::sendAllProperties( PvdDataStream& inStream, const PxPar
 	PxParticleFluidGeneratedValues values( &inObj );
 	inStream.setPropertyMessage( &inObj, values );
 }
-void PvdMetaDataBinding::sendArrays( PvdDataStream& inStream, const PxParticleFluid& inObj, PxParticleFluidReadData& inData, PxU32 inFlags )
+void PvdMetaDataBinding::sendArrays( PvdDataStream& inStream, const PxParticleFluid& inObj, PxParticleFluidReadData& inData, PxU32 inFlags, StreamingFilter* inFilter )
 {
-	ParticleFluidUpdater<PxParticleFluidReadData> theUpdater( inData, inStream, (const PxActor*)&inObj, inFlags, mBindingData->mTempU8Array );
+	ParticleFluidUpdater<PxParticleFluidReadData> theUpdater( inData, inStream, (const PxActor*)&inObj, inFlags, mBindingData->mTempU8Array, inFilter );
 	visitParticleSystemBufferProperties( makePvdPropertyFilter( theUpdater ) );
 	visitParticleFluidBufferProperties( makePvdPropertyFilter( theUpdater ) );
 }
@@ -1271,7 +1291,7 @@ void PvdMetaDataBinding::destroyInstance( PvdDataStream& inStream, const PxParti
 #endif // PX_USE_PARTICLE_SYSTEM_API
 
 template<typename TBlockType, typename TActorType, typename TOperator>
-void updateActor( PvdDataStream& inStream, TActorType** actorGroup, PxU32 numActors, TOperator sleepingOp, PvdMetaDataBindingData& bindingData )
+void updateActor( PvdDataStream& inStream, TActorType** actorGroup, PxU32 numActors, TOperator sleepingOp, PvdMetaDataBindingData& bindingData, StreamingFilter* filter )
 {
 	TBlockType theBlock;
 	if ( numActors == 0 ) return;
@@ -1286,6 +1306,14 @@ void updateActor( PvdDataStream& inStream, TActorType** actorGroup, PxU32 numAct
 			theBlock.GlobalPose = theActor->getGlobalPose();
 			theBlock.AngularVelocity = theActor->getAngularVelocity();
 			theBlock.LinearVelocity = theActor->getLinearVelocity();
+			//Sleep state transitions are always sent, other updates only once the actor moved far enough.
+			if ( filter )
+			{
+				bool changed = filter->needsUpdate( theActor, theBlock.GlobalPose, theBlock.LinearVelocity, theBlock.AngularVelocity );
+				if ( !changed && sleeping == wasSleeping )
+					continue;
+				filter->addBytesSent( sizeof( TBlockType ) );
+			}
 			inStream.sendPropertyMessageFromGroup( theActor, theBlock );
 			if ( sleeping != wasSleeping )
 			{
@@ -1318,7 +1346,7 @@ struct ArticulationLinkUpdateOp
 	}
 };
 
-void PvdMetaDataBinding::updateDynamicActorsAndArticulations( PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz )
+void PvdMetaDataBinding::updateDynamicActorsAndArticulations( PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz, StreamingFilter* inFilter )
 {
 	PX_COMPILE_TIME_ASSERT( sizeof( PxRigidDynamicUpdateBlock ) == 14 * 4 );
 	{
@@ -1329,7 +1357,7 @@ void PvdMetaDataBinding::updateDynamicActorsAndArticulations( PvdDataStream& inS
 			mBindingData->mActors.resize( actorCount );
 			PxActor** theActors = mBindingData->mActors.begin();
 			inScene->getActors( PxActorTypeSelectionFlag::eRIGID_DYNAMIC, theActors, actorCount );
-			updateActor<PxRigidDynamicUpdateBlock>( inStream, reinterpret_cast<PxRigidDynamic**>( theActors ), actorCount, RigidDynamicUpdateOp(), *mBindingData );
+			updateActor<PxRigidDynamicUpdateBlock>( inStream, reinterpret_cast<PxRigidDynamic**>( theActors ), actorCount, RigidDynamicUpdateOp(), *mBindingData, inFilter );
 			inStream.endPropertyMessageGroup();
 		}
 	}
@@ -1351,7 +1379,7 @@ void PvdMetaDataBinding::updateDynamicActorsAndArticulations( PvdDataStream& inS
 					mBindingData->mArticulationLinks.resize( linkCount );
 					PxArticulationLink** theLink = mBindingData->mArticulationLinks.begin();
 					(*firstArticulation)->getLinks( theLink, linkCount );
-					updateActor<PxArticulationLinkUpdateBlock>( inStream, theLink, linkCount, ArticulationLinkUpdateOp( sleeping ), *mBindingData );
+					updateActor<PxArticulationLinkUpdateBlock>( inStream, theLink, linkCount, ArticulationLinkUpdateOp( sleeping ), *mBindingData, inFilter );
 					if ( linkJointViz )
 					{
 						for ( PxU32 idx = 0; idx < linkCount; ++idx ) linkJointViz->visualize( *theLink[idx] );
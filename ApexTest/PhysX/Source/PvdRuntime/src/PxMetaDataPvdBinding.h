@@ -75,6 +75,7 @@ namespace Pvd
 {
 	using namespace physx::debugger::comm;
 	struct PvdMetaDataBindingData;
+	class StreamingFilter;
 
 	class BufferRegistrar
 	{
@@ -154,20 +155,20 @@ namespace Pvd
 		//create them.
 		void sendAllProperties( PvdDataStream& inStream, const PxArticulationJoint& inObj );
 		
-		//per frame update
-		void updateDynamicActorsAndArticulations( PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz );
+		//per frame update, inFilter may be NULL to send every actor
+		void updateDynamicActorsAndArticulations( PvdDataStream& inStream, const PxScene* inScene, PvdVisualizer* linkJointViz, StreamingFilter* inFilter = NULL );
 		
 #if PX_USE_PARTICLE_SYSTEM_API
 		void createInstance( PvdDataStream& inStream, const PxParticleSystem& inObj, const PxScene& ownerScene );
 		void sendAllProperties( PvdDataStream& inStream, const PxParticleSystem& inObj );
 		//per frame update
-		void sendArrays( PvdDataStream& inStream, const PxParticleSystem& inObj, PxParticleReadData& inData, PxU32 inFlags );
+		void sendArrays( PvdDataStream& inStream, const PxParticleSystem& inObj, PxParticleReadData& inData, PxU32 inFlags, StreamingFilter* inFilter = NULL );
 		void destroyInstance( PvdDataStream& inStream, const PxParticleSystem& inObj, const PxScene& ownerScene );
 
 		void createInstance( PvdDataStream& inStream, const PxParticleFluid& inObj, const PxScene& ownerScene );
 		void sendAllProperties( PvdDataStream& inStream, const PxParticleFluid& inObj );
 		//per frame update
-		void sendArrays( PvdDataStream& inStream, const PxParticleFluid& inObj, PxParticleFluidReadData& inData, PxU32 inFlags );
+		void sendArrays( PvdDataStream& inStream, const PxParticleFluid& inObj, PxParticleFluidReadData& inData, PxU32 inFlags, StreamingFilter* inFilter = NULL );
 		void destroyInstance( PvdDataStream& inStream, const PxParticleFluid& inObj, const PxScene& ownerScene );
 #endif
 
@@ -0,0 +1,287 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+
+// Headless check of the PVD delta streaming filter. A set of actors and a particle array is moved for a number of
+// frames and streamed through Pvd::StreamingFilter to a receiver that keeps the last values it got, like the
+// PVD client does. On every transmitted frame the receiver's view must be within the streaming tolerances of
+// the simulated state, and the number of sent updates must match the motion: still actors are sent once, actors
+// moving beyond the tolerance every frame, and only every maxUpdateRate-th of a second is transmitted. Slowly
+// moving actors must be sent less often than every frame; their expected update count is printed as 0.
+//
+//	PvdStreamingFilterCheck [options]
+//		-csv			print the results as comma separated values
+//		-frames <n>		number of frames per scenario, default 128
+//		-actors <n>		number of rigid dynamics, default 256
+//
+// The exit code is the number of failed checks.
+
+#include "PvdStreamingFilter.h"
+#include "HeadlessFoundation.h"
+#include "PsMathUtils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+
+namespace
+{
+	const PxReal	gElapsedTime = 1.0f / 64.0f;	// exact in binary, so the rate limiter period is hit exactly
+	const PxU32		gParticlesPerActor = 4;
+	const PxU32		gUpdateBytes = sizeof(PxTransform) + 2 * sizeof(PxVec3);
+
+	struct Scenario
+	{
+		const char*	name;
+		bool		enabled;
+		PxReal		maxUpdateRate;
+		PxReal		step;			// distance moved per frame, as a multiple of the position tolerance
+		PxReal		spin;			// angle turned per frame, as a multiple of the rotation tolerance
+		PxReal		accel;			// velocity change per frame, as a multiple of the velocity tolerance
+		bool		reconnect;		// reset the filter halfway, like a new PVD connection
+	};
+
+	struct Result
+	{
+		PxU32	nbTransmitFrames;
+		PxU32	nbUpdates;
+		PxU32	nbArrayUpdates;
+		PxU32	nbOutOfTolerance;	// received values further from the simulated state than the settings allow
+		PxU32	nbByteMismatches;	// frames whose getBytesSentLastFrame() differs from the sent payload
+	};
+
+	struct Actor
+	{
+		PxTransform	pose;
+		PxVec3		linearVelocity;
+		PxVec3		angularVelocity;
+		PxVec3		direction;
+		PxVec3		axis;
+	};
+
+	PxU32 gSeed = 1;
+
+	PxReal random(PxReal lo, PxReal hi)
+	{
+		gSeed = gSeed * 1664525u + 1013904223u;
+		return lo + (hi - lo) * PxReal(gSeed >> 8) / PxReal(1 << 24);
+	}
+
+	PxVec3 randomUnitVector()
+	{
+		const PxVec3 v(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f) + 2.0f);
+		return v.getNormalized();
+	}
+
+	bool withinTolerance(const Actor& actor, const Actor& received, const Pvd::StreamingSettings& settings)
+	{
+		const PxReal eps = 1e-5f;
+		const PxReal cosHalfAngle = PxMin(PxAbs(actor.pose.q.dot(received.pose.q)), 1.0f);
+		return (actor.pose.p - received.pose.p).magnitude() <= settings.positionTolerance + eps
+			&& 2.0f * PxAcos(cosHalfAngle) <= settings.rotationTolerance + 1e-3f
+			&& (actor.linearVelocity - received.linearVelocity).magnitude() <= settings.velocityTolerance + eps
+			&& (actor.angularVelocity - received.angularVelocity).magnitude() <= settings.velocityTolerance + eps;
+	}
+
+	Result runScenario(const Scenario& scenario, PxU32 nbFrames, PxU32 nbActors)
+	{
+		Pvd::StreamingSettings settings;
+		settings.maxUpdateRate = scenario.maxUpdateRate;
+
+		Pvd::StreamingFilter filter;
+		filter.setSettings(settings);
+		filter.setEnabled(scenario.enabled);
+
+		gSeed = 1;
+		std::vector<Actor> actors(nbActors);
+		for(PxU32 i = 0; i < nbActors; i++)
+		{
+			Actor& actor = actors[i];
+			actor.pose = PxTransform(PxVec3(random(-50.0f, 50.0f), random(0.0f, 10.0f), random(-50.0f, 50.0f)), PxQuat(random(-PxPi, PxPi), randomUnitVector()));
+			actor.direction = randomUnitVector();
+			actor.axis = randomUnitVector();
+			actor.linearVelocity = actor.direction * (scenario.step * settings.positionTolerance / gElapsedTime);
+			actor.angularVelocity = actor.axis * (scenario.spin * settings.rotationTolerance / gElapsedTime);
+		}
+		std::vector<Actor> received(actors);
+
+		const PxU32 nbParticles = gParticlesPerActor * nbActors;
+		std::vector<PxVec3> particles(nbParticles), quantized(nbParticles), receivedParticles(nbParticles);
+		for(PxU32 i = 0; i < nbParticles; i++)
+			particles[i] = PxVec3(random(-10.0f, 10.0f), random(0.0f, 10.0f), random(-10.0f, 10.0f));
+
+		Result result = { 0, 0, 0, 0, 0 };
+		for(PxU32 frame = 0; frame < nbFrames; frame++)
+		{
+			if(scenario.reconnect && frame == nbFrames / 2)
+				filter.reset();
+
+			PxU32 nbBytes = 0;
+			if(filter.beginFrame(gElapsedTime))
+			{
+				result.nbTransmitFrames++;
+				for(PxU32 i = 0; i < nbActors; i++)
+				{
+					const Actor& actor = actors[i];
+					if(filter.needsUpdate(&actor, actor.pose, actor.linearVelocity, actor.angularVelocity))
+					{
+						received[i] = actor;
+						filter.addBytesSent(gUpdateBytes);
+						nbBytes += gUpdateBytes;
+						result.nbUpdates++;
+					}
+					result.nbOutOfTolerance += withinTolerance(actor, received[i], settings) ? 0u : 1u;
+				}
+
+				quantized = particles;
+				filter.quantizePositions(&quantized[0], nbParticles);
+				const PxU32 arrayBytes = nbParticles * sizeof(PxVec3);
+				if(filter.needsArrayUpdate(&particles, 0, &quantized[0], arrayBytes))
+				{
+					receivedParticles = quantized;
+					filter.addBytesSent(arrayBytes);
+					nbBytes += arrayBytes;
+					result.nbArrayUpdates++;
+				}
+				const PxReal quantum = scenario.enabled ? settings.particlePositionQuantum : 0.0f;
+				for(PxU32 i = 0; i < nbParticles; i++)
+				{
+					const PxVec3 error = particles[i] - receivedParticles[i];
+					const PxReal maxError = 0.5f * quantum + 1e-5f;
+					result.nbOutOfTolerance += PxAbs(error.x) <= maxError && PxAbs(error.y) <= maxError && PxAbs(error.z) <= maxError ? 0u : 1u;
+				}
+			}
+			filter.endFrame();
+			result.nbByteMismatches += filter.getBytesSentLastFrame() == nbBytes ? 0u : 1u;
+
+			// advance the simulated state
+			for(PxU32 i = 0; i < nbActors; i++)
+			{
+				Actor& actor = actors[i];
+				actor.pose.p += actor.linearVelocity * gElapsedTime;
+				const PxReal angle = actor.angularVelocity.magnitude() * gElapsedTime;
+				if(angle > 0.0f)
+					actor.pose.q = (PxQuat(angle, actor.axis) * actor.pose.q).getNormalized();
+				actor.linearVelocity += actor.direction * (scenario.accel * settings.velocityTolerance);
+			}
+			const PxVec3 particleStep = PxVec3(1.0f, 0.0f, 0.0f) * (scenario.step * settings.positionTolerance);
+			for(PxU32 i = 0; i < nbParticles; i++)
+				particles[i] += particleStep;
+		}
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 nbFrames = 128, nbActors = 256;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-frames") && i + 1 < argc && atoi(argv[i + 1]) > 1)
+			nbFrames = PxU32(atoi(argv[++i]));
+		else if(!strcmp(argv[i], "-actors") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbActors = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-frames <n>] [-actors <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// Steps are multiples of the default tolerances. The rate limited scenarios transmit every fourth frame.
+	const Scenario scenarios[] =
+	{
+		{ "disabled_moving",		false,	0.0f,	2.0f,	0.0f,	0.0f,	false },
+		{ "still",					true,	0.0f,	0.0f,	0.0f,	0.0f,	false },
+		{ "still_reconnected",		true,	0.0f,	0.0f,	0.0f,	0.0f,	true },
+		{ "moving",					true,	0.0f,	2.0f,	0.0f,	0.0f,	false },
+		{ "drifting",				true,	0.0f,	0.3f,	0.0f,	0.0f,	false },
+		{ "spinning",				true,	0.0f,	0.0f,	0.3f,	0.0f,	false },
+		{ "accelerating",			true,	0.0f,	0.0f,	0.0f,	0.3f,	false },
+		{ "rate_limited_still",		true,	16.0f,	0.0f,	0.0f,	0.0f,	false },
+		{ "rate_limited_moving",	true,	16.0f,	2.0f,	0.0f,	0.0f,	false }
+	};
+	const PxU32 nbScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+
+	if(csv)
+		printf("scenario,frames,actors,transmit_frames,updates,expected_updates,array_updates,out_of_tolerance,payload_bytes_ok\n");
+
+	PxU32 nbFailures = 0;
+	for(PxU32 i = 0; i < nbScenarios; i++)
+	{
+		const Scenario& scenario = scenarios[i];
+		const Result result = runScenario(scenario, nbFrames, nbActors);
+
+		const bool rateLimited = scenario.enabled && scenario.maxUpdateRate > 0.0f;
+		const PxU32 expectedTransmitFrames = rateLimited ? nbFrames / PxU32(1.0f / (scenario.maxUpdateRate * gElapsedTime)) : nbFrames;
+		const bool still = scenario.step == 0.0f && scenario.spin == 0.0f && scenario.accel == 0.0f;
+		const bool fast = scenario.step > 1.0f || scenario.spin > 1.0f || scenario.accel > 1.0f;
+
+		// still actors are sent once per connection, fast ones on every transmitted frame, drifting ones in between
+		PxU32 expectedUpdates = 0, expectedArrayUpdates = 0;
+		if(!scenario.enabled || fast)
+		{
+			expectedUpdates = nbActors * expectedTransmitFrames;
+			expectedArrayUpdates = expectedTransmitFrames;
+		}
+		else if(still)
+		{
+			expectedUpdates = nbActors * (scenario.reconnect ? 2 : 1);
+			expectedArrayUpdates = scenario.reconnect ? 2 : 1;
+		}
+
+		bool failed = result.nbTransmitFrames != expectedTransmitFrames || result.nbOutOfTolerance != 0 || result.nbByteMismatches != 0;
+		if(expectedUpdates)
+			failed = failed || result.nbUpdates != expectedUpdates || result.nbArrayUpdates != expectedArrayUpdates;
+		else
+			failed = failed || result.nbUpdates <= nbActors || result.nbUpdates >= nbActors * nbFrames;
+		nbFailures += failed ? 1u : 0u;
+
+		printf(csv ? "%s,%u,%u,%u,%u,%u,%u,%u,%u\n" : "%-22s frames %4u actors %5u: transmitted %4u updates %7u (expected %7u) arrays %4u out of tolerance %u payload bytes ok %u\n",
+			   scenario.name, nbFrames, nbActors, result.nbTransmitFrames, result.nbUpdates, expectedUpdates, result.nbArrayUpdates,
+			   result.nbOutOfTolerance, result.nbByteMismatches == 0 ? 1u : 0u);
+		if(failed)
+			fprintf(stderr, "error: scenario %s failed\n", scenario.name);
+	}
+
+	if(shdfnd::getHeadlessErrorCount())
+	{
+		fprintf(stderr, "error: the streaming filter reported %u errors\n", shdfnd::getHeadlessErrorCount());
+		nbFailures++;
+	}
+	return int(nbFailures);
+}
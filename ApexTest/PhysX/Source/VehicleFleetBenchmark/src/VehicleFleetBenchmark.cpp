@@ -0,0 +1,254 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+// Headless memory and throughput benchmark of 10000 four-wheeled cars built from two wheels simulation data
+// archetypes, created once as standalone vehicles that each own a copy of their wheels simulation data and
+// once in a PxVehicleFleet that shares the archetypes and packs the vehicles into one arena. The bytes
+// allocated for the vehicles and the time spent in PxVehicleUpdates() are measured; the raycasts against
+// the stand-in ground plane are not timed. The scene objects are stand-ins, see VehicleSceneMocks.h.
+//
+//	VehicleFleetBenchmark [options]
+//		-csv			print the results as comma separated values
+//		-vehicles <n>	number of vehicles, default 10000
+//		-frames <n>		number of 60Hz frames per layout, default 120
+
+#include "PxVehicleSDK.h"
+#include "PxVehicleFleet.h"
+#include "PxVehicleDrive4W.h"
+#include "PxVehicleUpdate.h"
+#include "PxVehicleTireFriction.h"
+#include "HeadlessFoundation.h"
+#include "VehicleSceneMocks.h"
+#include "PsTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+using namespace physx::headless;
+
+namespace
+{
+	const PxReal	gTimestep = 1.0f / 60.0f;
+	const PxU32		gNbArchetypes = 2;
+	const PxReal	gChassisMasses[gNbArchetypes] = { 1200.0f, 2500.0f };
+
+	enum Layout
+	{
+		eSTANDALONE,
+		eFLEET
+	};
+
+	struct Result
+	{
+		double	bytesPerVehicle;
+		double	vehiclesPerMs;
+		PxReal	meanSpeed;		// forward speed at the end, shows the cars actually drove
+		bool	leaked;			// the allocated byte count did not return to its start value
+	};
+
+	// The wheels in the order PxVehicleDrive4W expects: front left, front right, rear left, rear right. The cars stand
+	// with the suspensions compressed by their sprung weight.
+	PxVehicleWheelsSimData* createWheelsSimData(PxReal chassisMass)
+	{
+		PxVehicleWheelsSimData* wheelsSimData = PxVehicleWheelsSimData::allocate(4);
+		for(PxU32 i = 0; i < 4; i++)
+		{
+			PxVehicleSuspensionData suspension;
+			suspension.mMaxDroop = 0.1f;
+			suspension.mMaxCompression = 0.3f;
+			suspension.mSprungMass = chassisMass / 4.0f;
+			suspension.mSpringStrength = suspension.mSprungMass * 9.81f / 0.1f;
+			suspension.mSpringDamperRate = 0.3f * 2.0f * PxSqrt(suspension.mSpringStrength * suspension.mSprungMass);
+			wheelsSimData->setSuspensionData(i, suspension);
+
+			PxVehicleWheelData wheel;
+			wheel.mRadius = 0.35f;
+			wheel.mWidth = 0.25f;
+			wheel.mMass = 20.0f;
+			wheel.mMOI = 0.5f * wheel.mMass * wheel.mRadius * wheel.mRadius;
+			wheel.mMaxSteer = i < 2 ? PxPi / 3.0f : 0.0f;
+			wheelsSimData->setWheelData(i, wheel);
+
+			wheelsSimData->setTireData(i, PxVehicleTireData());
+
+			const PxReal x = i & 1 ? 0.8f : -0.8f;
+			const PxReal z = i < 2 ? 1.4f : -1.4f;
+			wheelsSimData->setSuspTravelDirection(i, PxVec3(0.0f, -1.0f, 0.0f));
+			wheelsSimData->setWheelCentreOffset(i, PxVec3(x, -0.4f, z));
+			wheelsSimData->setSuspForceAppPointOffset(i, PxVec3(x, -0.6f, z));
+			wheelsSimData->setTireForceAppPointOffset(i, PxVec3(x, -0.6f, z));
+		}
+		return wheelsSimData;
+	}
+
+	Result runLayout(MockPhysics& physics, Layout layout, PxU32 nbVehicles, PxU32 nbFrames)
+	{
+		MockRigidStatic ground(PxConcreteType::eRIGID_STATIC);
+		// the friction pairs only compare material pointers, so any address is a valid material
+		static PxU8 groundMaterialKey;
+		PxMaterial* groundMaterial = reinterpret_cast<PxMaterial*>(&groundMaterialKey);
+		MockShape groundShape(ground, groundMaterial);
+
+		PxVehicleDrivableSurfaceToTireFrictionPairs* frictionPairs = PxVehicleDrivableSurfaceToTireFrictionPairs::allocate(1, 1);
+		const PxMaterial* surfaceMaterials[1] = { groundMaterial };
+		PxVehicleDrivableSurfaceType surfaceTypes[1];
+		surfaceTypes[0].mType = 0;
+		frictionPairs->setup(1, 1, surfaceMaterials, surfaceTypes);
+
+		const PxVehicleWheelsSimData* archetypes[gNbArchetypes];
+		for(PxU32 i = 0; i < gNbArchetypes; i++)
+			archetypes[i] = createWheelsSimData(gChassisMasses[i]);
+
+		PxVehicleDriveSimData4W driveSimData;
+		PxVehicleAckermannGeometryData ackermann;
+		ackermann.mFrontWidth = 1.6f;
+		ackermann.mRearWidth = 1.6f;
+		ackermann.mAxleSeparation = 2.8f;
+		driveSimData.setAckermannGeometryData(ackermann);
+
+		std::vector<MockRigidDynamic> chassis(nbVehicles);
+		std::vector<PxVehicleDrive4W*> cars(nbVehicles);
+		std::vector<PxVehicleWheels*> vehicles(nbVehicles);
+
+		// everything the vehicles allocate is counted, the archetypes passed in are not
+		const PxU32 startByteCount = shdfnd::getHeadlessAllocatedByteCount();
+		PxVehicleFleet* fleet = layout == eFLEET ? PxVehicleFleet::allocate(gNbArchetypes, archetypes, nbVehicles, 4 * nbVehicles) : NULL;
+		for(PxU32 i = 0; i < nbVehicles; i++)
+		{
+			const PxU32 archetype = i % gNbArchetypes;
+			chassis[i].mMass = gChassisMasses[archetype];
+			chassis[i].mInertia = PxVec3(2000.0f, 2500.0f, 800.0f) * (gChassisMasses[archetype] / 1200.0f);
+			chassis[i].mPose = PxTransform(PxVec3(6.0f * PxReal(i % 100), 0.75f, 10.0f * PxReal(i / 100)));
+
+			PxVehicleDrive4W* car = fleet ? 
+				fleet->createDrive4W(&physics, &chassis[i], archetype, driveSimData, 0) : 
+				PxVehicleDrive4W::create(&physics, &chassis[i], *archetypes[archetype], driveSimData, 0);
+			car->setToRestState();
+			car->mDriveDynData.setUseAutoGears(true);
+			car->mDriveDynData.forceGearChange(PxVehicleGearsData::eFIRST);
+			car->mDriveDynData.setAnalogInput(1.0f, PxVehicleDrive4W::eANALOG_INPUT_ACCEL);
+			car->mDriveDynData.setAnalogInput(0.1f, PxVehicleDrive4W::eANALOG_INPUT_STEER_RIGHT);
+			cars[i] = car;
+			vehicles[i] = car;
+		}
+		const PxU32 vehiclesByteCount = shdfnd::getHeadlessAllocatedByteCount() - startByteCount;
+
+		const PxU32 nbWheels = 4 * nbVehicles;
+		std::vector<PxRaycastQueryResult> sceneQueryResults(nbWheels);
+		MockBatchQuery batchQuery(&sceneQueryResults[0], groundShape, PxVec3(0.0f, 1.0f, 0.0f), 0.0f);
+		const PxVec3 gravity(0.0f, -9.81f, 0.0f);
+
+		double seconds = 0.0;
+		for(PxU32 frame = 0; frame < nbFrames; frame++)
+		{
+			PxVehicleSuspensionRaycasts(&batchQuery, nbVehicles, &vehicles[0], nbWheels, &sceneQueryResults[0]);
+
+			shdfnd::Time timer;
+			PxVehicleUpdates(gTimestep, gravity, *frictionPairs, nbVehicles, &vehicles[0]);
+			seconds += timer.getElapsedSeconds();
+
+			for(PxU32 i = 0; i < nbVehicles; i++)
+				chassis[i].integrate(gTimestep);
+		}
+
+		Result result;
+		result.bytesPerVehicle = double(vehiclesByteCount) / nbVehicles;
+		result.vehiclesPerMs = double(nbVehicles) * nbFrames / (seconds * 1000.0);
+		result.meanSpeed = 0.0f;
+		for(PxU32 i = 0; i < nbVehicles; i++)
+			result.meanSpeed += cars[i]->computeForwardSpeed() / nbVehicles;
+
+		// the vehicles release their constraints first, the fleet returns their memory afterwards
+		for(PxU32 i = 0; i < nbVehicles; i++)
+			cars[i]->free();
+		if(fleet)
+			fleet->free();
+		result.leaked = shdfnd::getHeadlessAllocatedByteCount() != startByteCount;
+
+		for(PxU32 i = 0; i < gNbArchetypes; i++)
+			const_cast<PxVehicleWheelsSimData*>(archetypes[i])->free();
+		frictionPairs->release();
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 nbVehicles = 10000, nbFrames = 120;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-vehicles") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbVehicles = PxU32(atoi(argv[++i]));
+		else if(!strcmp(argv[i], "-frames") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbFrames = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-vehicles <n>] [-frames <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	const Layout layouts[] = { eSTANDALONE, eFLEET };
+	const char* const layoutNames[] = { "standalone", "fleet" };
+	const PxU32 nbLayouts = sizeof(layouts) / sizeof(layouts[0]);
+
+	MockPhysics physics;
+	PxInitVehicleSDK(physics);
+
+	if(csv)
+		printf("layout,vehicles,frames,bytes_per_vehicle,vehicles_per_ms,mean_speed\n");
+
+	PxU32 nbInvalid = 0;
+	for(PxU32 i = 0; i < nbLayouts; i++)
+	{
+		const Result result = runLayout(physics, layouts[i], nbVehicles, nbFrames);
+		printf(csv ? "%s,%u,%u,%.0f,%.0f,%.2f\n" : "%-10s vehicles %6u frames %4u: %6.0f bytes/vehicle, %8.0f vehicles/ms, mean speed %6.2f m/s\n",
+			   layoutNames[i], nbVehicles, nbFrames, result.bytesPerVehicle, result.vehiclesPerMs, result.meanSpeed);
+		if(result.leaked)
+			fprintf(stderr, "error: %s leaked vehicle memory\n", layoutNames[i]);
+		nbInvalid += PxIsFinite(result.meanSpeed) && !result.leaked ? 0u : 1u;
+	}
+
+	PxCloseVehicleSDK();
+
+	if(nbInvalid || shdfnd::getHeadlessErrorCount())
+	{
+		fprintf(stderr, "error: %u layouts failed, the vehicle library reported %u errors\n", nbInvalid, shdfnd::getHeadlessErrorCount());
+		return 2;
+	}
+	return 0;
+}
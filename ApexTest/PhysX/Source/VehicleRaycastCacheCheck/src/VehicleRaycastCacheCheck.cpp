@@ -0,0 +1,238 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+// Headless check of PxVehicleSuspensionRaycastCache. Vehicles are driven over a ground plane for a number of
+// frames and the raycasts that reach the batch query are counted: hits against static ground must be reused
+// while the vehicles stand still, until maxCachedFrames is reached or the cache is invalidated, and must be
+// raycast again once the suspension lines move beyond the position tolerance. Hits against dynamic ground
+// must never be reused. The scene objects are stand-ins, so no PxPhysics instance is needed.
+//
+//	VehicleRaycastCacheCheck [options]
+//		-csv			print the results as comma separated values
+//		-frames <n>		number of frames per scenario, default 45
+//		-vehicles <n>	number of four wheeled vehicles, default 8
+//
+// The exit code is the number of failed checks.
+
+#include "PxVehicleNoDrive.h"
+#include "PxVehicleUpdate.h"
+#include "HeadlessFoundation.h"
+#include "VehicleSceneMocks.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+using namespace physx::headless;
+
+namespace
+{
+	struct Scenario
+	{
+		const char*	name;
+		bool		staticGround;
+		PxReal		slope;				// ground slope along x
+		PxReal		step;				// distance the vehicles move along x each frame
+		PxU32		maxCachedFrames;
+		PxU32		invalidateInterval;	// frames between calls to invalidate(), zero for never
+	};
+
+	struct Result
+	{
+		PxU32	nbRaycasts;
+		PxU32	nbCachedHits;
+		PxU32	nbBatchQueryRaycasts;
+		PxU32	nbMissedWheels;
+	};
+
+	PxVehicleWheelsSimData* createWheelsSimData()
+	{
+		PxVehicleWheelsSimData* wheelsSimData = PxVehicleWheelsSimData::allocate(4);
+		for(PxU32 i = 0; i < 4; i++)
+		{
+			PxVehicleSuspensionData suspension;
+			suspension.mMaxDroop = 0.2f;
+			suspension.mMaxCompression = 0.2f;
+			suspension.mSpringStrength = 20000.0f;
+			suspension.mSpringDamperRate = 2000.0f;
+			suspension.mSprungMass = 300.0f;
+			wheelsSimData->setSuspensionData(i, suspension);
+
+			PxVehicleWheelData wheel;
+			wheel.mRadius = 0.4f;
+			wheel.mWidth = 0.3f;
+			wheel.mMass = 20.0f;
+			wheel.mMOI = 1.6f;
+			wheelsSimData->setWheelData(i, wheel);
+
+			wheelsSimData->setTireData(i, PxVehicleTireData());
+			wheelsSimData->setSuspTravelDirection(i, PxVec3(0.0f, -1.0f, 0.0f));
+			wheelsSimData->setWheelCentreOffset(i, PxVec3(i & 1 ? 0.8f : -0.8f, -0.5f, i & 2 ? 1.4f : -1.4f));
+			wheelsSimData->setSuspForceAppPointOffset(i, PxVec3(i & 1 ? 0.8f : -0.8f, -0.8f, i & 2 ? 1.4f : -1.4f));
+			wheelsSimData->setTireForceAppPointOffset(i, PxVec3(i & 1 ? 0.8f : -0.8f, -0.8f, i & 2 ? 1.4f : -1.4f));
+		}
+		return wheelsSimData;
+	}
+
+	Result runScenario(const Scenario& scenario, PxU32 nbFrames, PxU32 nbVehicles)
+	{
+		MockPhysics physics;
+		MockRigidStatic staticGround(PxConcreteType::eRIGID_STATIC);
+		MockRigidDynamic dynamicGround;
+		MockShape groundShape(scenario.staticGround ? static_cast<PxRigidActor&>(staticGround) : static_cast<PxRigidActor&>(dynamicGround));
+
+		// the vehicles stand in a row along z, each turned a little, with the wheels just above the ground
+		PxVehicleWheelsSimData* wheelsSimData = createWheelsSimData();
+		std::vector<MockRigidDynamic> chassis(nbVehicles);
+		std::vector<PxVehicleNoDrive*> noDriveVehicles(nbVehicles);
+		std::vector<PxVehicleWheels*> vehicles(nbVehicles);
+		for(PxU32 i = 0; i < nbVehicles; i++)
+		{
+			chassis[i].mMass = 1200.0f;
+			chassis[i].mPose = PxTransform(PxVec3(0.0f, 1.0f, 10.0f * i), PxQuat(0.05f * i, PxVec3(0.0f, 1.0f, 0.0f)));
+			noDriveVehicles[i] = PxVehicleNoDrive::create(&physics, &chassis[i], *wheelsSimData);
+			vehicles[i] = noDriveVehicles[i];
+		}
+
+		const PxU32 nbWheels = 4 * nbVehicles;
+		std::vector<PxRaycastQueryResult> sceneQueryResults(nbWheels);
+		const PxVec3 groundNormal = PxVec3(scenario.slope, 1.0f, 0.0f).getNormalized();
+		MockBatchQuery batchQuery(&sceneQueryResults[0], groundShape, groundNormal, 0.0f);
+		PxVehicleSuspensionRaycastCache* raycastCache = PxVehicleSuspensionRaycastCache::allocate(nbWheels);
+		raycastCache->setTolerances(0.01f, 0.001f, scenario.maxCachedFrames);
+
+		Result result = { 0, 0, 0, 0 };
+		for(PxU32 frame = 0; frame < nbFrames; frame++)
+		{
+			if(scenario.invalidateInterval && frame && frame % scenario.invalidateInterval == 0)
+				raycastCache->invalidate();
+
+			PxVehicleSuspensionRaycasts(&batchQuery, nbVehicles, &vehicles[0], nbWheels, &sceneQueryResults[0], *raycastCache);
+
+			// every raycast must hit the ground, a miss would make the wheel look airborne
+			for(PxU32 i = 0; i < batchQuery.getNbRaycastsLastQuery(); i++)
+				result.nbMissedWheels += sceneQueryResults[i].nbHits == 1 ? 0u : 1u;
+
+			for(PxU32 i = 0; i < nbVehicles; i++)
+				chassis[i].mPose.p.x += scenario.step;
+		}
+
+		result.nbRaycasts = raycastCache->getNumRaycasts();
+		result.nbCachedHits = raycastCache->getNumCachedHits();
+		result.nbBatchQueryRaycasts = batchQuery.getNbRaycasts();
+
+		raycastCache->free();
+		for(PxU32 i = 0; i < nbVehicles; i++)
+			noDriveVehicles[i]->free();
+		wheelsSimData->free();
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 nbFrames = 45, nbVehicles = 8;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-frames") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbFrames = PxU32(atoi(argv[++i]));
+		else if(!strcmp(argv[i], "-vehicles") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbVehicles = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-frames <n>] [-vehicles <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// The default tolerances are 0.01 and eight cached frames: on still static ground each wheel is raycast
+	// every ninth frame, creeping 0.004 per frame it is raycast every third frame.
+	const Scenario scenarios[] =
+	{
+		{ "static_still",			true,	0.0f,	0.0f,	8,	0 },
+		{ "static_sloped_still",	true,	0.3f,	0.0f,	8,	0 },
+		{ "static_sloped_creeping",	true,	0.3f,	0.004f,	8,	0 },
+		{ "static_moving",			true,	0.0f,	0.05f,	8,	0 },
+		{ "static_invalidated",		true,	0.0f,	0.0f,	8,	5 },
+		{ "static_no_caching",		true,	0.0f,	0.0f,	0,	0 },
+		{ "dynamic_still",			false,	0.0f,	0.0f,	8,	0 }
+	};
+	const PxU32 nbScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+
+	if(csv)
+		printf("scenario,frames,wheels,raycasts,expected_raycasts,cached_hits,missed_wheels\n");
+
+	const PxU32 nbWheels = 4 * nbVehicles;
+	PxU32 nbFailures = 0;
+	for(PxU32 i = 0; i < nbScenarios; i++)
+	{
+		const Scenario& scenario = scenarios[i];
+		const Result result = runScenario(scenario, nbFrames, nbVehicles);
+
+		// a wheel is raycast every raycastInterval frames
+		PxU32 raycastInterval = 1;
+		if(scenario.staticGround && scenario.maxCachedFrames)
+		{
+			raycastInterval = scenario.step > 0.0f ? PxU32(0.01f / scenario.step) + 1 : scenario.maxCachedFrames + 1;
+			raycastInterval = PxMin(raycastInterval, scenario.maxCachedFrames + 1);
+		}
+		PxU32 expectedRaycasts = 0;
+		for(PxU32 frame = 0, lastRaycast = 0; frame < nbFrames; frame++)
+		{
+			const bool invalidated = scenario.invalidateInterval && frame % scenario.invalidateInterval == 0;
+			if(frame == 0 || invalidated || frame - lastRaycast >= raycastInterval)
+			{
+				expectedRaycasts += nbWheels;
+				lastRaycast = frame;
+			}
+		}
+
+		const bool failed = result.nbRaycasts != expectedRaycasts || result.nbBatchQueryRaycasts != result.nbRaycasts ||
+							result.nbRaycasts + result.nbCachedHits != nbFrames * nbWheels || result.nbMissedWheels != 0;
+		nbFailures += failed ? 1u : 0u;
+
+		printf(csv ? "%s,%u,%u,%u,%u,%u,%u\n" : "%-24s frames %4u wheels %4u: raycasts %6u (expected %6u) cached hits %6u missed wheels %u\n",
+			   scenario.name, nbFrames, nbWheels, result.nbRaycasts, expectedRaycasts, result.nbCachedHits, result.nbMissedWheels);
+		if(failed)
+			fprintf(stderr, "error: scenario %s failed\n", scenario.name);
+	}
+
+	if(shdfnd::getHeadlessErrorCount())
+	{
+		fprintf(stderr, "error: the vehicle library reported %u errors\n", shdfnd::getHeadlessErrorCount());
+		nbFailures++;
+	}
+	return int(nbFailures);
+}
@@ -0,0 +1,236 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+
+// Headless tanks per millisecond benchmark of PxVehicleUpdates() for tracked vehicles. Tanks with 20 wheels
+// drive over a ground plane with full throttle, turning slightly; the time spent in PxVehicleUpdates() is
+// measured. The 8 substep scenario runs the fixed substep count tanks used before they took the adaptive
+// count of the other drive types. The scene objects are stand-ins, so no PxPhysics instance is needed.
+//
+//	VehicleTankBenchmark [options]
+//		-csv			print the results as comma separated values
+//		-tanks <n>		number of tanks, default 256
+//		-frames <n>		number of 60Hz frames per scenario, default 300
+
+#include "PxVehicleSDK.h"
+#include "PxVehicleDriveTank.h"
+#include "PxVehicleUpdate.h"
+#include "PxVehicleTireFriction.h"
+#include "HeadlessFoundation.h"
+#include "VehicleSceneMocks.h"
+#include "PsTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+using namespace physx::headless;
+
+namespace
+{
+	const PxReal	gTimestep = 1.0f / 60.0f;
+	const PxReal	gChassisMass = 12000.0f;
+
+	struct Scenario
+	{
+		const char*						name;
+		PxU32							nbWheels;
+		PxVehicleDriveTank::eDriveModel	driveModel;
+		PxU32							nbSubsteps;		// zero for the default adaptive count
+	};
+
+	struct Result
+	{
+		double	tanksPerMs;
+		PxReal	meanSpeed;		// forward speed at the end, shows the tanks actually drove
+	};
+
+	// Even wheels on the left, odd wheels on the right, front to back, as PxVehicleDriveTank expects.
+	PxVehicleWheelsSimData* createWheelsSimData(PxU32 nbWheels)
+	{
+		PxVehicleWheelsSimData* wheelsSimData = PxVehicleWheelsSimData::allocate(nbWheels);
+		const PxU32 nbWheelsPerSide = nbWheels / 2;
+		for(PxU32 i = 0; i < nbWheels; i++)
+		{
+			PxVehicleSuspensionData suspension;
+			suspension.mMaxDroop = 0.2f;
+			suspension.mMaxCompression = 0.2f;
+			suspension.mSprungMass = gChassisMass / nbWheels;
+			suspension.mSpringStrength = suspension.mSprungMass * 9.81f / 0.1f;
+			suspension.mSpringDamperRate = 0.3f * 2.0f * PxSqrt(suspension.mSpringStrength * suspension.mSprungMass);
+			wheelsSimData->setSuspensionData(i, suspension);
+
+			PxVehicleWheelData wheel;
+			wheel.mRadius = 0.4f;
+			wheel.mWidth = 0.5f;
+			wheel.mMass = 50.0f;
+			wheel.mMOI = 0.5f * wheel.mMass * wheel.mRadius * wheel.mRadius;
+			wheelsSimData->setWheelData(i, wheel);
+
+			wheelsSimData->setTireData(i, PxVehicleTireData());
+
+			const PxReal x = i & 1 ? 1.5f : -1.5f;
+			const PxReal z = 3.0f - 6.0f * PxReal(i / 2) / PxReal(nbWheelsPerSide - 1);
+			wheelsSimData->setSuspTravelDirection(i, PxVec3(0.0f, -1.0f, 0.0f));
+			wheelsSimData->setWheelCentreOffset(i, PxVec3(x, -0.5f, z));
+			wheelsSimData->setSuspForceAppPointOffset(i, PxVec3(x, -0.8f, z));
+			wheelsSimData->setTireForceAppPointOffset(i, PxVec3(x, -0.8f, z));
+		}
+		return wheelsSimData;
+	}
+
+	Result runScenario(MockPhysics& physics, const Scenario& scenario, PxU32 nbTanks, PxU32 nbFrames)
+	{
+		MockRigidStatic ground(PxConcreteType::eRIGID_STATIC);
+		// the friction pairs only compare material pointers, so any address is a valid material
+		static PxU8 groundMaterialKey;
+		PxMaterial* groundMaterial = reinterpret_cast<PxMaterial*>(&groundMaterialKey);
+		MockShape groundShape(ground, groundMaterial);
+
+		PxVehicleDrivableSurfaceToTireFrictionPairs* frictionPairs = PxVehicleDrivableSurfaceToTireFrictionPairs::allocate(1, 1);
+		const PxMaterial* surfaceMaterials[1] = { groundMaterial };
+		PxVehicleDrivableSurfaceType surfaceTypes[1];
+		surfaceTypes[0].mType = 0;
+		frictionPairs->setup(1, 1, surfaceMaterials, surfaceTypes);
+
+		PxVehicleWheelsSimData* wheelsSimData = createWheelsSimData(scenario.nbWheels);
+		if(scenario.nbSubsteps)
+			wheelsSimData->setSubStepCount(5.0f, scenario.nbSubsteps, scenario.nbSubsteps);
+		PxVehicleDriveSimData driveSimData;
+
+		// the tanks stand in a grid with the wheels just touching the ground
+		std::vector<MockRigidDynamic> chassis(nbTanks);
+		std::vector<PxVehicleDriveTank*> tanks(nbTanks);
+		std::vector<PxVehicleWheels*> vehicles(nbTanks);
+		for(PxU32 i = 0; i < nbTanks; i++)
+		{
+			chassis[i].mMass = gChassisMass;
+			chassis[i].mInertia = PxVec3(45000.0f, 50000.0f, 15000.0f);
+			chassis[i].mPose = PxTransform(PxVec3(10.0f * PxReal(i % 16), 0.9f, 20.0f * PxReal(i / 16)));
+
+			PxVehicleDriveTank* tank = PxVehicleDriveTank::create(&physics, &chassis[i], *wheelsSimData, driveSimData, scenario.nbWheels);
+			tank->setToRestState();
+			tank->setDriveModel(scenario.driveModel);
+			tank->mDriveDynData.setUseAutoGears(true);
+			tank->mDriveDynData.forceGearChange(PxVehicleGearsData::eFIRST);
+			tank->mDriveDynData.setAnalogInput(1.0f, PxVehicleDriveTank::eANALOG_INPUT_ACCEL);
+			tank->mDriveDynData.setAnalogInput(1.0f, PxVehicleDriveTank::eANALOG_INPUT_THRUST_LEFT);
+			tank->mDriveDynData.setAnalogInput(0.8f, PxVehicleDriveTank::eANALOG_INPUT_THRUST_RIGHT);
+			tanks[i] = tank;
+			vehicles[i] = tank;
+		}
+
+		const PxU32 nbWheels = scenario.nbWheels * nbTanks;
+		std::vector<PxRaycastQueryResult> sceneQueryResults(nbWheels);
+		MockBatchQuery batchQuery(&sceneQueryResults[0], groundShape, PxVec3(0.0f, 1.0f, 0.0f), 0.0f);
+		const PxVec3 gravity(0.0f, -9.81f, 0.0f);
+
+		double seconds = 0.0;
+		for(PxU32 frame = 0; frame < nbFrames; frame++)
+		{
+			PxVehicleSuspensionRaycasts(&batchQuery, nbTanks, &vehicles[0], nbWheels, &sceneQueryResults[0]);
+
+			shdfnd::Time timer;
+			PxVehicleUpdates(gTimestep, gravity, *frictionPairs, nbTanks, &vehicles[0]);
+			seconds += timer.getElapsedSeconds();
+
+			for(PxU32 i = 0; i < nbTanks; i++)
+				chassis[i].integrate(gTimestep);
+		}
+
+		Result result;
+		result.tanksPerMs = double(nbTanks) * nbFrames / (seconds * 1000.0);
+		result.meanSpeed = 0.0f;
+		for(PxU32 i = 0; i < nbTanks; i++)
+			result.meanSpeed += tanks[i]->computeForwardSpeed() / nbTanks;
+
+		for(PxU32 i = 0; i < nbTanks; i++)
+			tanks[i]->free();
+		wheelsSimData->free();
+		frictionPairs->release();
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 nbTanks = 256, nbFrames = 300;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-tanks") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbTanks = PxU32(atoi(argv[++i]));
+		else if(!strcmp(argv[i], "-frames") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbFrames = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-tanks <n>] [-frames <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	const Scenario scenarios[] =
+	{
+		{ "tank20_standard",	20,	PxVehicleDriveTank::eDRIVE_MODEL_STANDARD,	0 },
+		{ "tank20_special",		20,	PxVehicleDriveTank::eDRIVE_MODEL_SPECIAL,	0 },
+		{ "tank20_8_substeps",	20,	PxVehicleDriveTank::eDRIVE_MODEL_STANDARD,	8 },
+		{ "tank8_standard",		8,	PxVehicleDriveTank::eDRIVE_MODEL_STANDARD,	0 }
+	};
+	const PxU32 nbScenarios = sizeof(scenarios) / sizeof(scenarios[0]);
+
+	MockPhysics physics;
+	PxInitVehicleSDK(physics);
+
+	if(csv)
+		printf("scenario,wheels,tanks,frames,tanks_per_ms,mean_speed\n");
+
+	PxU32 nbInvalid = 0;
+	for(PxU32 i = 0; i < nbScenarios; i++)
+	{
+		const Result result = runScenario(physics, scenarios[i], nbTanks, nbFrames);
+		printf(csv ? "%s,%u,%u,%u,%.0f,%.2f\n" : "%-18s wheels %2u tanks %5u frames %4u: %8.0f tanks/ms, mean speed %6.2f m/s\n",
+			   scenarios[i].name, scenarios[i].nbWheels, nbTanks, nbFrames, result.tanksPerMs, result.meanSpeed);
+		nbInvalid += PxIsFinite(result.meanSpeed) ? 0u : 1u;
+	}
+
+	PxCloseVehicleSDK();
+
+	if(nbInvalid || shdfnd::getHeadlessErrorCount())
+	{
+		fprintf(stderr, "error: %u scenarios diverged, the vehicle library reported %u errors\n", nbInvalid, shdfnd::getHeadlessErrorCount());
+		return 2;
+	}
+	return 0;
+}
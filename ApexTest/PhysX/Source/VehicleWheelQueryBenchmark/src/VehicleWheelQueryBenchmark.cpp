@@ -0,0 +1,337 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.
+
+
+
+// Headless wheels per millisecond benchmark of reading the wheel state of many vehicles after PxVehicleUpdates():
+// the per wheel PxVehicleWheelsDynData getters, PxVehicleGetWheelQueryResults() and the wheel query results
+// written by PxVehicleUpdates() itself, plus recording all vehicles with PxVehicleTelemetryRecorder. Every
+// streamed value must match the getters. The scene objects are stand-ins, see VehicleSceneMocks.h.
+//
+//	VehicleWheelQueryBenchmark [options]
+//		-csv			print the results as comma separated values
+//		-vehicles <n>	number of four-wheeled cars, default 2000
+//		-frames <n>		number of 60Hz frames, default 120
+
+#include "PxVehicleSDK.h"
+#include "PxVehicleDrive4W.h"
+#include "PxVehicleUpdate.h"
+#include "PxVehicleTireFriction.h"
+#include "PxVehicleUtilTelemetry.h"
+#include "HeadlessFoundation.h"
+#include "VehicleSceneMocks.h"
+#include "PsTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace physx;
+using namespace physx::headless;
+
+namespace
+{
+	const PxReal	gTimestep = 1.0f / 60.0f;
+	const PxReal	gChassisMass = 1500.0f;
+
+	enum Path
+	{
+		eGETTERS,			// PxVehicleWheelsDynData getters after PxVehicleUpdates
+		eQUERY,				// PxVehicleGetWheelQueryResults after PxVehicleUpdates
+		eUPDATE,			// PxVehicleUpdates alone, the reference for eUPDATE_STREAM
+		eUPDATE_STREAM,		// PxVehicleUpdates writing the wheel query results
+		eRECORD,			// PxVehicleTelemetryRecorder::record after PxVehicleUpdates
+		eNB_PATHS
+	};
+
+	const char* const gPathNames[eNB_PATHS] = { "getters", "query", "update", "update_stream", "record" };
+
+	// All the per wheel arrays of PxVehicleWheelQueryResults.
+	struct WheelState
+	{
+		std::vector<PxReal>				jounce, springForce, longSlip, latSlip, friction, omega, angle, steer;
+		std::vector<PxU32>				surfaceType;
+		std::vector<const PxMaterial*>	material;
+		std::vector<const PxShape*>		shape;
+		std::vector<PxVec3>				contactPoint, contactNormal, longDir, latDir;
+		std::vector<PxU8>				inAir;		// bool arrays of std::vector are packed
+		PxVehicleWheelQueryResults		results;
+
+		void allocate(PxU32 nbWheels)
+		{
+			jounce.resize(nbWheels); springForce.resize(nbWheels); longSlip.resize(nbWheels); latSlip.resize(nbWheels);
+			friction.resize(nbWheels); omega.resize(nbWheels); angle.resize(nbWheels); steer.resize(nbWheels);
+			surfaceType.resize(nbWheels); material.resize(nbWheels); shape.resize(nbWheels);
+			contactPoint.resize(nbWheels); contactNormal.resize(nbWheels); longDir.resize(nbWheels); latDir.resize(nbWheels);
+			inAir.resize(nbWheels);
+
+			results.suspJounce = &jounce[0];
+			results.suspSpringForce = &springForce[0];
+			results.tireLongSlip = &longSlip[0];
+			results.tireLatSlip = &latSlip[0];
+			results.tireFriction = &friction[0];
+			results.tireSurfaceType = &surfaceType[0];
+			results.tireSurfaceMaterial = &material[0];
+			results.tireContactShape = &shape[0];
+			results.tireContactPoint = &contactPoint[0];
+			results.tireContactNormal = &contactNormal[0];
+			results.tireLongitudinalDir = &longDir[0];
+			results.tireLateralDir = &latDir[0];
+			results.wheelRotationSpeed = &omega[0];
+			results.wheelRotationAngle = &angle[0];
+			results.steerAngle = &steer[0];
+			results.isInAir = reinterpret_cast<bool*>(&inAir[0]);
+			results.numWheels = nbWheels;
+		}
+
+		// What an application does without the wheel query results.
+		void readGetters(PxU32 nbVehicles, PxVehicleWheels* const* vehicles)
+		{
+			PxU32 w = 0;
+			for(PxU32 i = 0; i < nbVehicles; i++)
+			{
+				const PxVehicleWheels& vehicle = *vehicles[i];
+				const PxVehicleWheelsDynData& dynData = vehicle.mWheelsDynData;
+				for(PxU32 j = 0; j < vehicle.mWheelsSimData.getNumWheels(); j++, w++)
+				{
+					jounce[w] = dynData.getSuspJounce(j);
+					springForce[w] = dynData.getSuspensionForce(j);
+					longSlip[w] = dynData.getTireLongSlip(j);
+					latSlip[w] = dynData.getTireLatSlip(j);
+					friction[w] = dynData.getTireFriction(j);
+					surfaceType[w] = dynData.getTireDrivableSurfaceType(j);
+					material[w] = dynData.getTireDrivableSurfaceMaterial(j);
+					shape[w] = dynData.getTireDrivableSurfaceShape(j);
+					contactPoint[w] = dynData.getTireDrivableSurfaceContactPoint(j);
+					contactNormal[w] = dynData.getTireDrivableSurfaceContactNormal(j);
+					longDir[w] = dynData.getTireLongitudinalDir(j);
+					latDir[w] = dynData.getTireLateralDir(j);
+					omega[w] = dynData.getWheelRotationSpeed(j);
+					angle[w] = dynData.getWheelRotationAngle(j);
+					steer[w] = dynData.getSteer(j);
+					inAir[w] = vehicle.isInAir(j);
+				}
+			}
+		}
+
+		bool operator==(const WheelState& other) const
+		{
+			return jounce == other.jounce && springForce == other.springForce && longSlip == other.longSlip && latSlip == other.latSlip &&
+				friction == other.friction && surfaceType == other.surfaceType && material == other.material && shape == other.shape &&
+				contactPoint == other.contactPoint && contactNormal == other.contactNormal && longDir == other.longDir && latDir == other.latDir &&
+				omega == other.omega && angle == other.angle && steer == other.steer && inAir == other.inAir;
+		}
+	};
+
+	// The wheels in the order PxVehicleDrive4W expects: front left, front right, rear left, rear right.
+	PxVehicleWheelsSimData* createWheelsSimData()
+	{
+		PxVehicleWheelsSimData* wheelsSimData = PxVehicleWheelsSimData::allocate(4);
+		for(PxU32 i = 0; i < 4; i++)
+		{
+			PxVehicleSuspensionData suspension;
+			suspension.mMaxDroop = 0.1f;
+			suspension.mMaxCompression = 0.3f;
+			suspension.mSprungMass = gChassisMass / 4.0f;
+			suspension.mSpringStrength = suspension.mSprungMass * 9.81f / 0.1f;
+			suspension.mSpringDamperRate = 0.3f * 2.0f * PxSqrt(suspension.mSpringStrength * suspension.mSprungMass);
+			wheelsSimData->setSuspensionData(i, suspension);
+
+			PxVehicleWheelData wheel;
+			wheel.mRadius = 0.35f;
+			wheel.mWidth = 0.25f;
+			wheel.mMass = 20.0f;
+			wheel.mMOI = 0.5f * wheel.mMass * wheel.mRadius * wheel.mRadius;
+			wheel.mMaxSteer = i < 2 ? PxPi / 3.0f : 0.0f;
+			wheelsSimData->setWheelData(i, wheel);
+
+			wheelsSimData->setTireData(i, PxVehicleTireData());
+
+			const PxReal x = i & 1 ? 0.8f : -0.8f;
+			const PxReal z = i < 2 ? 1.4f : -1.4f;
+			wheelsSimData->setSuspTravelDirection(i, PxVec3(0.0f, -1.0f, 0.0f));
+			wheelsSimData->setWheelCentreOffset(i, PxVec3(x, -0.4f, z));
+			wheelsSimData->setSuspForceAppPointOffset(i, PxVec3(x, -0.6f, z));
+			wheelsSimData->setTireForceAppPointOffset(i, PxVec3(x, -0.6f, z));
+		}
+		return wheelsSimData;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool csv = false;
+	PxU32 nbVehicles = 2000, nbFrames = 120;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-csv"))
+			csv = true;
+		else if(!strcmp(argv[i], "-vehicles") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbVehicles = PxU32(atoi(argv[++i]));
+		else if(!strcmp(argv[i], "-frames") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			nbFrames = PxU32(atoi(argv[++i]));
+		else
+		{
+			fprintf(stderr, "usage: %s [-csv] [-vehicles <n>] [-frames <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	MockPhysics physics;
+	PxInitVehicleSDK(physics);
+
+	MockRigidStatic ground(PxConcreteType::eRIGID_STATIC);
+	// the friction pairs only compare material pointers, so any address is a valid material
+	static PxU8 groundMaterialKey;
+	PxMaterial* groundMaterial = reinterpret_cast<PxMaterial*>(&groundMaterialKey);
+	MockShape groundShape(ground, groundMaterial);
+
+	PxVehicleDrivableSurfaceToTireFrictionPairs* frictionPairs = PxVehicleDrivableSurfaceToTireFrictionPairs::allocate(1, 1);
+	const PxMaterial* surfaceMaterials[1] = { groundMaterial };
+	PxVehicleDrivableSurfaceType surfaceTypes[1];
+	surfaceTypes[0].mType = 0;
+	frictionPairs->setup(1, 1, surfaceMaterials, surfaceTypes);
+
+	PxVehicleWheelsSimData* wheelsSimData = createWheelsSimData();
+	PxVehicleDriveSimData4W driveSimData;
+	PxVehicleAckermannGeometryData ackermann;
+	ackermann.mFrontWidth = 1.6f;
+	ackermann.mRearWidth = 1.6f;
+	ackermann.mAxleSeparation = 2.8f;
+	driveSimData.setAckermannGeometryData(ackermann);
+
+	// the cars steer by different amounts so the wheel states differ
+	std::vector<MockRigidDynamic> chassis(nbVehicles);
+	std::vector<PxVehicleDrive4W*> cars(nbVehicles);
+	std::vector<PxVehicleWheels*> vehicles(nbVehicles);
+	for(PxU32 i = 0; i < nbVehicles; i++)
+	{
+		chassis[i].mMass = gChassisMass;
+		chassis[i].mInertia = PxVec3(2500.0f, 3000.0f, 1000.0f);
+		chassis[i].mPose = PxTransform(PxVec3(6.0f * PxReal(i % 100), 0.75f, 10.0f * PxReal(i / 100)));
+
+		PxVehicleDrive4W* car = PxVehicleDrive4W::create(&physics, &chassis[i], *wheelsSimData, driveSimData, 0);
+		car->setToRestState();
+		car->mDriveDynData.setUseAutoGears(true);
+		car->mDriveDynData.forceGearChange(PxVehicleGearsData::eFIRST);
+		car->mDriveDynData.setAnalogInput(1.0f, PxVehicleDrive4W::eANALOG_INPUT_ACCEL);
+		car->mDriveDynData.setAnalogInput(PxReal(i % 5) * 0.1f, PxVehicleDrive4W::eANALOG_INPUT_STEER_RIGHT);
+		cars[i] = car;
+		vehicles[i] = car;
+	}
+
+	const PxU32 nbWheels = 4 * nbVehicles;
+	std::vector<PxRaycastQueryResult> sceneQueryResults(nbWheels);
+	MockBatchQuery batchQuery(&sceneQueryResults[0], groundShape, PxVec3(0.0f, 1.0f, 0.0f), 0.0f);
+	const PxVec3 gravity(0.0f, -9.81f, 0.0f);
+
+	WheelState getterState, streamState;
+	getterState.allocate(nbWheels);
+	streamState.allocate(nbWheels);
+	PxVehicleTelemetryRecorder* recorder = PxVehicleTelemetryRecorder::allocate(nbVehicles, nbWheels, 60);
+
+	// even frames update plainly and read the wheels three ways, odd frames update with the wheel query results
+	double seconds[eNB_PATHS] = { 0.0 };
+	PxU32 nbPathFrames[eNB_PATHS] = { 0 };
+	PxU32 nbMismatches = 0;
+	for(PxU32 frame = 0; frame < nbFrames; frame++)
+	{
+		PxVehicleSuspensionRaycasts(&batchQuery, nbVehicles, &vehicles[0], nbWheels, &sceneQueryResults[0]);
+
+		if(frame & 1)
+		{
+			shdfnd::Time timer;
+			PxVehicleUpdates(gTimestep, gravity, *frictionPairs, nbVehicles, &vehicles[0], streamState.results);
+			seconds[eUPDATE_STREAM] += timer.getElapsedSeconds();
+			nbPathFrames[eUPDATE_STREAM]++;
+
+			getterState.readGetters(nbVehicles, &vehicles[0]);
+			nbMismatches += getterState == streamState ? 0 : 1;
+		}
+		else
+		{
+			shdfnd::Time timer;
+			PxVehicleUpdates(gTimestep, gravity, *frictionPairs, nbVehicles, &vehicles[0]);
+			seconds[eUPDATE] += timer.getElapsedSeconds();
+			nbPathFrames[eUPDATE]++;
+
+			timer.getElapsedSeconds();
+			getterState.readGetters(nbVehicles, &vehicles[0]);
+			seconds[eGETTERS] += timer.getElapsedSeconds();
+			nbPathFrames[eGETTERS]++;
+
+			PxVehicleGetWheelQueryResults(nbVehicles, &vehicles[0], streamState.results);
+			seconds[eQUERY] += timer.getElapsedSeconds();
+			nbPathFrames[eQUERY]++;
+
+			recorder->record(nbVehicles, &vehicles[0]);
+			seconds[eRECORD] += timer.getElapsedSeconds();
+			nbPathFrames[eRECORD]++;
+
+			nbMismatches += getterState == streamState ? 0 : 1;
+			nbMismatches += recorder->getWheelChannel(PxVehicleTelemetryRecorder::eCHANNEL_JOUNCE, 0)[nbWheels - 1] == getterState.jounce[nbWheels - 1] ? 0 : 1;
+		}
+
+		// the scene would apply gravity to the chassis, without it the suspensions push the cars off the ground
+		for(PxU32 i = 0; i < nbVehicles; i++)
+		{
+			chassis[i].mLinearVelocity += gravity * gTimestep;
+			chassis[i].integrate(gTimestep);
+		}
+	}
+
+	PxU32 nbAirborne = 0;
+	for(PxU32 w = 0; w < nbWheels; w++)
+		nbAirborne += getterState.inAir[w];
+
+	if(csv)
+		printf("path,wheels,frames,wheels_per_ms\n");
+	for(PxU32 path = 0; path < eNB_PATHS; path++)
+	{
+		const double wheelsPerMs = double(nbWheels) * nbPathFrames[path] / (seconds[path] * 1000.0);
+		printf(csv ? "%s,%u,%u,%.0f\n" : "%-14s wheels %6u frames %4u: %10.0f wheels/ms\n", gPathNames[path], nbWheels, nbPathFrames[path], wheelsPerMs);
+	}
+	if(!csv)
+		printf("%u of %u wheels in the air at the end\n", nbAirborne, nbWheels);
+
+	recorder->free();
+	for(PxU32 i = 0; i < nbVehicles; i++)
+		cars[i]->free();
+	wheelsSimData->free();
+	frictionPairs->release();
+	PxCloseVehicleSDK();
+
+	if(nbMismatches || shdfnd::getHeadlessErrorCount())
+	{
+		fprintf(stderr, "error: %u frames streamed wheel state different from the getters, the vehicle library reported %u errors\n", nbMismatches, shdfnd::getHeadlessErrorCount());
+		return 2;
+	}
+	return 0;
+}
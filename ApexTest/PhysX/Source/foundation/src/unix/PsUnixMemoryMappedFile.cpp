@@ -0,0 +1,107 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "PsMemoryMappedFile.h"
+#include "PsString.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace physx
+{
+namespace shdfnd
+{
+
+// Named shared memory, the counterpart of a windows page file backed file mapping.
+// All processes opening the same mapping object see the same memory.
+class MemoryMappedFileImpl : public UserAllocated
+{
+public:
+	MemoryMappedFileImpl(const char* mappingObject, unsigned int mapSize)
+	: mBaseAddress(NULL)
+	, mMapSize(mapSize)
+	{
+		// posix shared memory objects are named "/name"
+		char name[256];
+		name[0] = '/';
+		string::strcpy_s(name + 1, sizeof(name) - 1, mappingObject[0] == '/' ? mappingObject + 1 : mappingObject);
+		for(char* c = name + 1; *c; ++c)
+		{
+			if(*c == '/')
+				*c = '_';
+		}
+
+		const int fd = shm_open(name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+		if(fd == -1)
+			return;
+
+		// only grow, a mapping object created larger by another process keeps its size
+		struct stat st;
+		if(fstat(fd, &st) == 0 && st.st_size < off_t(mapSize) && ftruncate(fd, off_t(mapSize)) != 0)
+		{
+			close(fd);
+			return;
+		}
+
+		void* addr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if(addr != MAP_FAILED)
+			mBaseAddress = addr;
+	}
+
+	~MemoryMappedFileImpl()
+	{
+		if(mBaseAddress)
+			munmap(mBaseAddress, mMapSize);
+	}
+
+	void*			mBaseAddress;
+	unsigned int	mMapSize;
+};
+
+MemoryMappedFile::MemoryMappedFile(const char* mappingObject, unsigned int mapSize)
+{
+	mImpl = PX_NEW(MemoryMappedFileImpl)(mappingObject, mapSize);
+}
+
+MemoryMappedFile::~MemoryMappedFile(void)
+{
+	PX_DELETE(mImpl);
+}
+
+void* MemoryMappedFile::getBaseAddress(void)
+{
+	return mImpl->mBaseAddress;
+}
+
+} // namespace shdfnd
+} // namespace physx
@@ -0,0 +1,128 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "PsMutex.h"
+#include "PsUserAllocated.h"
+
+#include <pthread.h>
+
+namespace physx
+{
+namespace shdfnd
+{
+
+namespace
+{
+	// MutexT allocates getSize() bytes and placement-constructs MutexImpl on them,
+	// so the pthread mutex lives directly in that storage.
+	PX_FORCE_INLINE pthread_mutex_t* getMutex(MutexImpl* impl)
+	{
+		return reinterpret_cast<pthread_mutex_t*>(impl);
+	}
+}
+
+MutexImpl::MutexImpl()
+{
+	// recursive to match the critical section semantics of the windows implementation
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(getMutex(this), &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+MutexImpl::~MutexImpl()
+{
+	pthread_mutex_destroy(getMutex(this));
+}
+
+bool MutexImpl::lock()
+{
+	return pthread_mutex_lock(getMutex(this)) == 0;
+}
+
+bool MutexImpl::trylock()
+{
+	return pthread_mutex_trylock(getMutex(this)) == 0;
+}
+
+bool MutexImpl::unlock()
+{
+	return pthread_mutex_unlock(getMutex(this)) == 0;
+}
+
+static const PxU32 gSize = sizeof(pthread_mutex_t);
+
+const PxU32& MutexImpl::getSize()
+{
+	return gSize;
+}
+
+
+class ReadWriteLockImpl : public UserAllocated
+{
+public:
+	pthread_rwlock_t	lock;
+};
+
+ReadWriteLock::ReadWriteLock()
+{
+	mImpl = PX_NEW(ReadWriteLockImpl);
+	pthread_rwlock_init(&mImpl->lock, NULL);
+}
+
+ReadWriteLock::~ReadWriteLock()
+{
+	pthread_rwlock_destroy(&mImpl->lock);
+	PX_DELETE(mImpl);
+}
+
+void ReadWriteLock::lockReader()
+{
+	pthread_rwlock_rdlock(&mImpl->lock);
+}
+
+void ReadWriteLock::lockWriter()
+{
+	pthread_rwlock_wrlock(&mImpl->lock);
+}
+
+void ReadWriteLock::unlockReader()
+{
+	pthread_rwlock_unlock(&mImpl->lock);
+}
+
+void ReadWriteLock::unlockWriter()
+{
+	pthread_rwlock_unlock(&mImpl->lock);
+}
+
+} // namespace shdfnd
+} // namespace physx
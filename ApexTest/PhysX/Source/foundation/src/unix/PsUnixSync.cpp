@@ -0,0 +1,121 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "PsSync.h"
+#include "PsUserAllocated.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+namespace physx
+{
+namespace shdfnd
+{
+
+// manual reset event: set() releases all waiters until reset() is called.
+class SyncImpl : public UserAllocated
+{
+public:
+	pthread_mutex_t		mutex;
+	pthread_cond_t		cond;
+	volatile bool		isSet;
+};
+
+Sync::Sync()
+{
+	mImpl = PX_NEW(SyncImpl);
+	pthread_mutex_init(&mImpl->mutex, NULL);
+
+	// time out against the monotonic clock so that wall clock changes don't stretch waits
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&mImpl->cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	mImpl->isSet = false;
+}
+
+Sync::~Sync()
+{
+	pthread_cond_destroy(&mImpl->cond);
+	pthread_mutex_destroy(&mImpl->mutex);
+	PX_DELETE(mImpl);
+}
+
+void Sync::reset()
+{
+	pthread_mutex_lock(&mImpl->mutex);
+	mImpl->isSet = false;
+	pthread_mutex_unlock(&mImpl->mutex);
+}
+
+void Sync::set()
+{
+	pthread_mutex_lock(&mImpl->mutex);
+	if(!mImpl->isSet)
+	{
+		mImpl->isSet = true;
+		pthread_cond_broadcast(&mImpl->cond);
+	}
+	pthread_mutex_unlock(&mImpl->mutex);
+}
+
+bool Sync::wait(PxU32 ms)
+{
+	pthread_mutex_lock(&mImpl->mutex);
+
+	if(ms == waitForever)
+	{
+		while(!mImpl->isSet)
+			pthread_cond_wait(&mImpl->cond, &mImpl->mutex);
+	}
+	else if(!mImpl->isSet && ms)
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		PxU64 nsec = PxU64(ts.tv_nsec) + PxU64(ms % 1000) * 1000000;
+		ts.tv_sec += time_t(ms / 1000 + nsec / 1000000000);
+		ts.tv_nsec = long(nsec % 1000000000);
+
+		// loop to ignore spurious wakeups
+		int err = 0;
+		while(!mImpl->isSet && err != ETIMEDOUT)
+			err = pthread_cond_timedwait(&mImpl->cond, &mImpl->mutex, &ts);
+	}
+
+	const bool result = mImpl->isSet;
+	pthread_mutex_unlock(&mImpl->mutex);
+	return result;
+}
+
+} // namespace shdfnd
+} // namespace physx
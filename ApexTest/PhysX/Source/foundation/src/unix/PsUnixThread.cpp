@@ -0,0 +1,306 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "PsThread.h"
+#include "PsAtomic.h"
+#include "PsString.h"
+#include "foundation/PxAssert.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+
+namespace physx
+{
+namespace shdfnd
+{
+
+namespace
+{
+	enum ThreadState
+	{
+		eNOT_STARTED,
+		eSTARTED,
+		eSTOPPED
+	};
+}
+
+class ThreadImpl : public UserAllocated
+{
+public:
+	Thread::ExecuteFn	fn;
+	void*				arg;
+	volatile PxI32		quitNow;
+	volatile PxI32		state;
+	pthread_t			thread;
+	char				name[16];	// pthread names are limited to 15 characters plus terminator
+};
+
+namespace
+{
+	void* threadStart(void* arg)
+	{
+		Thread* thread = reinterpret_cast<Thread*>(arg);
+		thread->execute();
+		return NULL;
+	}
+
+	PxI32 toSchedPriority(ThreadPriority::Enum prio, int policy)
+	{
+		// eHIGH is 0 and eLOW is 4, map them onto the range of the current policy.
+		// SCHED_OTHER has an empty range, so this is a no-op unless the process runs real time.
+		const int minPrio = sched_get_priority_min(policy);
+		const int maxPrio = sched_get_priority_max(policy);
+		return PxI32(maxPrio - ((maxPrio - minPrio) * PxI32(prio)) / PxI32(ThreadPriority::eLOW));
+	}
+}
+
+Thread::Id Thread::getId()
+{
+	return Id(pthread_self());
+}
+
+Thread::Thread()
+{
+	mImpl = PX_NEW(ThreadImpl);
+	mImpl->fn = NULL;
+	mImpl->arg = NULL;
+	mImpl->quitNow = 0;
+	mImpl->state = eNOT_STARTED;
+	mImpl->name[0] = 0;
+}
+
+Thread::Thread(ExecuteFn fn, void* arg)
+{
+	mImpl = PX_NEW(ThreadImpl);
+	mImpl->fn = fn;
+	mImpl->arg = arg;
+	mImpl->quitNow = 0;
+	mImpl->state = eNOT_STARTED;
+	mImpl->name[0] = 0;
+
+	start(0);
+}
+
+Thread::~Thread()
+{
+	if(mImpl->state == eSTARTED)
+		kill();
+	PX_DELETE(mImpl);
+}
+
+PxU32 Thread::getDefaultStackSize()
+{
+	return 1048576;
+}
+
+void Thread::start(PxU32 stackSize)
+{
+	if(mImpl->state != eNOT_STARTED)
+		return;
+
+	if(stackSize == 0)
+		stackSize = getDefaultStackSize();
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, stackSize);
+
+	mImpl->state = eSTARTED;
+	const int status = pthread_create(&mImpl->thread, &attr, threadStart, this);
+	pthread_attr_destroy(&attr);
+
+	if(status != 0)
+	{
+		PX_ASSERT(status == 0);
+		mImpl->state = eNOT_STARTED;
+		return;
+	}
+
+	if(mImpl->name[0])
+		pthread_setname_np(mImpl->thread, mImpl->name);
+}
+
+void Thread::signalQuit()
+{
+	atomicIncrement(&mImpl->quitNow);
+}
+
+bool Thread::waitForQuit()
+{
+	if(mImpl->state == eNOT_STARTED)
+		return false;
+
+	if(mImpl->state != eSTOPPED)
+	{
+		pthread_join(mImpl->thread, NULL);
+		mImpl->state = eSTOPPED;
+	}
+	return true;
+}
+
+bool Thread::quitIsSignalled()
+{
+	return atomicCompareExchange(&mImpl->quitNow, 0, 0) != 0;
+}
+
+void Thread::quit()
+{
+	// the spawning thread still joins in waitForQuit()
+	pthread_exit(NULL);
+}
+
+void Thread::kill()
+{
+	if(mImpl->state == eSTARTED)
+	{
+		pthread_cancel(mImpl->thread);
+		pthread_join(mImpl->thread, NULL);
+	}
+	mImpl->state = eSTOPPED;
+}
+
+void Thread::execute(void)
+{
+	mImpl->fn(mImpl->arg);
+}
+
+void Thread::sleep(PxU32 ms)
+{
+	timespec sleepTime;
+	sleepTime.tv_sec = time_t(ms / 1000);
+	sleepTime.tv_nsec = long(ms % 1000) * 1000000;
+	while(nanosleep(&sleepTime, &sleepTime) == -1 && errno == EINTR)
+		;
+}
+
+void Thread::yield()
+{
+	sched_yield();
+}
+
+PxU32 Thread::setAffinityMask(PxU32 mask)
+{
+	if(mImpl->state != eSTARTED || mask == 0)
+		return 0;
+
+	cpu_set_t cpuSet;
+	if(pthread_getaffinity_np(mImpl->thread, sizeof(cpuSet), &cpuSet) != 0)
+		return 0;
+
+	PxU32 previousMask = 0;
+	for(PxU32 i = 0; i < 32; i++)
+	{
+		if(CPU_ISSET(i, &cpuSet))
+			previousMask |= (1u << i);
+	}
+
+	CPU_ZERO(&cpuSet);
+	for(PxU32 i = 0; i < 32; i++)
+	{
+		if(mask & (1u << i))
+			CPU_SET(i, &cpuSet);
+	}
+
+	if(pthread_setaffinity_np(mImpl->thread, sizeof(cpuSet), &cpuSet) != 0)
+		return 0;
+
+	return previousMask;
+}
+
+void Thread::setName(const char* name)
+{
+	string::strcpy_s(mImpl->name, sizeof(mImpl->name), name);
+
+	if(mImpl->state == eSTARTED)
+		pthread_setname_np(mImpl->thread, mImpl->name);
+}
+
+void Thread::setPriority(ThreadPriority::Enum prio)
+{
+	if(mImpl->state != eSTARTED)
+		return;
+
+	int policy;
+	sched_param param;
+	if(pthread_getschedparam(mImpl->thread, &policy, &param) != 0)
+		return;
+
+	param.sched_priority = toSchedPriority(prio, policy);
+	pthread_setschedparam(mImpl->thread, policy, &param);
+}
+
+ThreadPriority::Enum Thread::getPriority(Id threadId)
+{
+	int policy;
+	sched_param param;
+	if(pthread_getschedparam(pthread_t(threadId), &policy, &param) != 0)
+		return ThreadPriority::eNORMAL;
+
+	const int minPrio = sched_get_priority_min(policy);
+	const int maxPrio = sched_get_priority_max(policy);
+	if(maxPrio == minPrio)
+		return ThreadPriority::eNORMAL;
+
+	const PxI32 level = PxI32(((maxPrio - param.sched_priority) * ThreadPriority::eLOW + (maxPrio - minPrio) / 2) / (maxPrio - minPrio));
+	return ThreadPriority::Enum(level);
+}
+
+
+PxU32 TlsAlloc()
+{
+	pthread_key_t key;
+	const int status = pthread_key_create(&key, NULL);
+	PX_ASSERT(status == 0);
+	PX_UNUSED(status);
+	return PxU32(key);
+}
+
+void TlsFree(PxU32 index)
+{
+	const int status = pthread_key_delete(pthread_key_t(index));
+	PX_ASSERT(status == 0);
+	PX_UNUSED(status);
+}
+
+void* TlsGet(PxU32 index)
+{
+	return pthread_getspecific(pthread_key_t(index));
+}
+
+PxU32 TlsSet(PxU32 index, void* value)
+{
+	// windows TlsSetValue returns non-zero on success
+	return PxU32(pthread_setspecific(pthread_key_t(index), value) == 0);
+}
+
+} // namespace shdfnd
+} // namespace physx
@@ -0,0 +1,97 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you 
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and 
+// any modifications thereto. Any use, reproduction, disclosure, or 
+// distribution of this software and related documentation without an express 
+// license agreement from NVIDIA Corporation is strictly prohibited.
+// 
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+// Copyright (c) 2004-2008 AGEIA Technologies, Inc. All rights reserved.
+// Copyright (c) 2001-2004 NovodeX AG. All rights reserved.  
+
+
+#include "PsTime.h"
+
+#include <time.h>
+
+namespace physx
+{
+namespace shdfnd
+{
+
+namespace
+{
+	// CLOCK_MONOTONIC is not affected by wall clock changes, which is what the profiler needs.
+	PX_FORCE_INLINE PxU64 getTimeNanoSeconds()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return PxU64(ts.tv_sec) * 1000000000ULL + PxU64(ts.tv_nsec);
+	}
+
+	PX_FORCE_INLINE Time::Second getTimeSeconds()
+	{
+		return Time::Second(getTimeNanoSeconds()) * 1.0e-9;
+	}
+
+	// the counter is in nanoseconds, so a tick is a tenth of a ten-nanosecond unit.
+	const CounterFrequencyToTensOfNanos gCounterFreq(1, 10);
+}
+
+const CounterFrequencyToTensOfNanos& Time::getBootCounterFrequency()
+{
+	return gCounterFreq;
+}
+
+CounterFrequencyToTensOfNanos Time::getCounterFrequency()
+{
+	return gCounterFreq;
+}
+
+PxU64 Time::getCurrentCounterValue()
+{
+	return getTimeNanoSeconds();
+}
+
+Time::Time()
+: mLastTime(getTimeSeconds())
+{
+}
+
+Time::Second Time::getElapsedSeconds()
+{
+	const Second lastTime = mLastTime;
+	mLastTime = getTimeSeconds();
+	return mLastTime - lastTime;
+}
+
+Time::Second Time::peekElapsedSeconds()
+{
+	return getTimeSeconds() - mLastTime;
+}
+
+Time::Second Time::getLastTime() const
+{
+	return mLastTime;
+}
+
+} // namespace shdfnd
+} // namespace physx
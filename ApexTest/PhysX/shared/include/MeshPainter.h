@@ -29,6 +29,7 @@
 
 #include "PsShare.h"
 #include "foundation/PxVec3.h"
+#include "foundation/PxBounds3.h"
 
 #ifdef PX_WINDOWS
 
@@ -43,9 +44,15 @@ class NxApexRenderDebug;
 }
 }
 
+namespace Samples
+{
+class WorkerPool;
+}
+
 namespace SharedTools
 {
 struct DistTriPair;
+struct BvhNode;
 struct PaintFloatBuffer;
 struct PaintFlagBuffer;
 
@@ -59,6 +66,9 @@ public:
 	void initFrom(const physx::NxClothingPhysicalMesh* mesh);
 	void initFrom(const physx::PxVec3* vertices, int numVertices, int vertexStride, const physx::PxU32* indices, int numIndices, int indexStride);
 
+	// moves the vertices of the mesh given to initFrom, the raycast hierarchy is refitted
+	void updateVertices(const physx::PxVec3* vertices, int vertexStride);
+
 	void clearIndexBufferRange();
 	void addIndexBufferRange(physx::PxU32 start, physx::PxU32 end);
 
@@ -89,6 +99,8 @@ public:
 	void paintFlag(unsigned int id, unsigned int flag, bool useAND) const;
 
 	void smoothFloat(physx::PxU32 id, float smoothingFactor, physx::PxU32 numIterations) const;
+	// smooths several buffers in one pass over the mesh adjacency
+	void smoothFloat(const physx::PxU32* ids, physx::PxU32 numIds, float smoothingFactor, physx::PxU32 numIterations) const;
 	void smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) const;
 
 	void drawBrush(physx::apex::NxApexRenderDebug* batcher) const;
@@ -106,10 +118,15 @@ private:
 
 	void computeSiblingInfo(float distanceThreshold);
 
-	physx::PxVec3 getTriangleCenter(int triNr) const;
-	physx::PxVec3 getTriangleNormal(int triNr) const;
+	void computeTriangleInfo();
+	void buildBvh();
+	void refitBvh();
+
 	void collectTriangles() const;
-	bool isValidRange(int vertexNumber) const;
+	void collectTriangleVertices() const;
+	void collectSphereVertices(const physx::PxVec3& center, float radius) const;
+
+	void buildSmoothingMatrix() const;
 
 	std::vector<physx::PxVec3> mVertices;
 	std::vector<bool> mVerticesDisabled;
@@ -131,6 +148,21 @@ private:
 	std::vector<physx::PxVec3> mNormals;
 	std::vector<physx::PxVec3> mTetraNormals;
 
+	// per triangle
+	std::vector<physx::PxVec3> mTriangleCenters;
+	std::vector<physx::PxVec3> mTriangleNormals;
+	std::vector<bool> mTriangleInRange;
+
+	// bounding volume hierarchy over all triangles, children are stored after their parent
+	std::vector<BvhNode> mBvhNodes;
+	std::vector<physx::PxU32> mBvhTriangles;
+	mutable std::vector<physx::PxU32> mBvhStack;
+	// vertices no triangle references (tetra interiors, stray points), sphere queries test them linearly
+	std::vector<physx::PxU32> mUnreferencedVertices;
+
+	mutable std::vector<int> mVertexMarks;
+	mutable std::vector<physx::PxU32> mVertexSlots;
+
 	std::vector<PaintFloatBuffer> mFloatBuffers;
 	std::vector<PaintFlagBuffer> mFlagBuffers;
 
@@ -150,6 +182,17 @@ private:
 
 	std::vector<physx::PxI32> mFirstSibling;
 	std::vector<physx::PxI32> mSiblings;
+
+	// vertex adjacency of the painted ranges for smoothFloat, in slices of SMOOTH_SLICE_ROWS rows.
+	// Entry k of row r of slice s is at (mSmoothSliceStart[s] + k) * SMOOTH_SLICE_ROWS + r, short
+	// rows are padded with zero weights.
+	enum { SMOOTH_SLICE_ROWS = 4 };
+	mutable std::vector<physx::PxU32> mSmoothSliceStart;
+	mutable std::vector<physx::PxU32> mSmoothColumns;
+	mutable std::vector<float> mSmoothInvLengths;
+	mutable bool mSmoothingMatrixValid;
+	mutable std::vector<float> mSmoothChannels;
+	mutable Samples::WorkerPool* mWorkers;
 };
 
 
@@ -171,6 +214,15 @@ struct DistTriPair
 
 
 
+struct BvhNode
+{
+	physx::PxBounds3 bounds;
+	physx::PxU32 start;	// first entry in mBvhTriangles, or first child for inner nodes
+	physx::PxU32 count;	// number of triangles, 0 for inner nodes
+};
+
+
+
 struct PaintFloatBuffer
 {
 	float& operator[](int i)  const
@@ -34,16 +34,61 @@
 
 #include <vector>
 
+#include "PsMutex.h"
+
+namespace Samples
+{
+class WorkerPool;
+}
+
+class MultiClientWrite;
+template<typename T> class MultiClientBuffer;
+
 
 class MultiClientRenderResourceManager : public physx::apex::NxUserRenderResourceManager
 {
 public:
 
-	MultiClientRenderResourceManager();
+	// How buffer writes reach the children. In the parallel and deferred modes the children are
+	// written from worker threads, one thread per child at a time, while the calling thread waits.
+	enum WriteMode
+	{
+		WRITE_SYNCHRONOUS,	// every child in turn on the calling thread
+		WRITE_PARALLEL,		// children in parallel, the write returns when all children are done
+		WRITE_DEFERRED,		// the data is packed once and shared by all children at the next flush()
+	};
+
+	struct ChildStats
+	{
+		physx::PxU32 numWrites;
+		double writeSeconds;	// time spent in the writeBuffer calls of the child
+		double maxWriteSeconds;
+	};
+
+	MultiClientRenderResourceManager(WriteMode writeMode = WRITE_SYNCHRONOUS);
 	~MultiClientRenderResourceManager();
 
 	void addChild(physx::apex::NxUserRenderResourceManager* rrm, bool destroyAutomatic);
 
+	void setWriteMode(WriteMode writeMode);
+	WriteMode getWriteMode() const
+	{
+		return mWriteMode;
+	}
+
+	// hands all deferred writes to the children, called before a resource is rendered or released
+	void flush();
+
+	size_t getNumChildren() const
+	{
+		return mChildren.size();
+	}
+	const ChildStats& getChildStats(size_t index) const
+	{
+		return mChildren[index].stats;
+	}
+	void resetChildStats();
+
 
 	virtual physx::apex::NxUserRenderVertexBuffer*   createVertexBuffer(const physx::apex::NxUserRenderVertexBufferDesc& desc);
 	virtual void                                     releaseVertexBuffer(physx::apex::NxUserRenderVertexBuffer& buffer);
@@ -66,16 +111,35 @@ public:
 
 	virtual physx::PxU32                             getMaxBonesForMaterial(void* material);
 protected:
+	template<typename T> friend class MultiClientBuffer;
+	friend class MultiClientFanOutJob;
 
 	struct Child
 	{
-		Child(physx::apex::NxUserRenderResourceManager* _rrm, bool destroy) : rrm(_rrm), destroyRrm(destroy) {}
+		Child(physx::apex::NxUserRenderResourceManager* _rrm, bool destroy) : rrm(_rrm), destroyRrm(destroy)
+		{
+			stats.numWrites = 0;
+			stats.writeSeconds = 0.0;
+			stats.maxWriteSeconds = 0.0;
+		}
 
 		physx::apex::NxUserRenderResourceManager* rrm;
 		bool destroyRrm;
+		ChildStats stats;
 	};
 
+	// called by the buffers, takes ownership of the write in deferred mode
+	void submitWrite(MultiClientWrite& write);
+	void applyWrite(MultiClientWrite& write, size_t child);
+	void fanOut(MultiClientWrite** writes, physx::PxU32 numWrites, bool release);
+
 	std::vector<Child> mChildren;
+
+	WriteMode mWriteMode;
+	Samples::WorkerPool* mWorkerPool;
+
+	std::vector<MultiClientWrite*> mPendingWrites;
+	physx::shdfnd::Mutex mPendingMutex;
 };
 
 
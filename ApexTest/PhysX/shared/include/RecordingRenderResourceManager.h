@@ -31,7 +31,11 @@
 #include "NxUserRenderResourceManager.h"
 #include "NxUserRenderer.h"
 
+#include <map>
 #include <string>
+#include <vector>
+
+#include "PsMutex.h"
 
 namespace physx
 {
@@ -43,6 +47,8 @@ class NxApexRenderVertexBufferData;
 }
 
 #include "NxUserRenderBoneBuffer.h"
+#include "NxUserRenderSpriteBuffer.h"
+#include "NxUserRenderSpriteBufferDesc.h"
 
 
 class RecordingRenderResourceManager : public physx::apex::NxUserRenderResourceManager
@@ -66,12 +72,17 @@ public:
 		virtual void writeBoneBuffer(unsigned int id, const physx::apex::NxApexRenderBoneBufferData& data, unsigned int firstBone, unsigned int numBones) = 0;
 		virtual void releaseBoneBuffer(unsigned int id) = 0;
 
+		virtual void createSpriteBuffer(unsigned int id, const physx::apex::NxUserRenderSpriteBufferDesc& desc) = 0;
+		virtual void writeSpriteBuffer(unsigned int id, const physx::apex::NxApexRenderSpriteBufferData& data, unsigned int firstSprite, unsigned int numSprites) = 0;
+		virtual void releaseSpriteBuffer(unsigned int id) = 0;
+
 		virtual void createResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc) = 0;
-		virtual void renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc) = 0;
+		virtual void renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc, const physx::apex::NxApexRenderContext& context) = 0;
 		virtual void releaseResource(unsigned int id) = 0;
 
 		virtual void setMaxBonesForMaterial(void* material, unsigned int maxBones) = 0;
 
+		virtual void endFrame() = 0;
 	};
 
 	RecordingRenderResourceManager(physx::apex::NxUserRenderResourceManager* child, bool ownsChild, RecorderInterface* recorder);
@@ -98,6 +109,9 @@ public:
 	virtual void                                     releaseResource(physx::apex::NxUserRenderResource& resource);
 
 	virtual physx::PxU32                             getMaxBonesForMaterial(void* material);
+
+	// marks a frame boundary in the recording, call once per frame after all resources were rendered
+	void                                             endFrame();
 protected:
 
 	physx::apex::NxUserRenderResourceManager* mChild;
@@ -139,12 +153,18 @@ public:
 	virtual void writeBoneBuffer(unsigned int id, const physx::apex::NxApexRenderBoneBufferData& data, unsigned int firstBone, unsigned int numBones);
 	virtual void releaseBoneBuffer(unsigned int id);
 
+	virtual void createSpriteBuffer(unsigned int id, const physx::apex::NxUserRenderSpriteBufferDesc& desc);
+	virtual void writeSpriteBuffer(unsigned int id, const physx::apex::NxApexRenderSpriteBufferData& data, unsigned int firstSprite, unsigned int numSprites);
+	virtual void releaseSpriteBuffer(unsigned int id);
+
 	virtual void createResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc);
-	virtual void renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc);
+	virtual void renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc, const physx::apex::NxApexRenderContext& context);
 	virtual void releaseResource(unsigned int id);
 
 	virtual void setMaxBonesForMaterial(void* material, unsigned int maxBones);
 
+	virtual void endFrame();
+
 protected:
 	void writeElem(const char* name, unsigned int value);
 
@@ -157,4 +177,124 @@ protected:
 };
 
 
+class RecordingStreamWriter;
+class RecordingStreamReader;
+
+// Writes the recorded calls as a binary stream that RecordingPlayer can replay. Packets are packed
+// into fixed size chunks on the calling thread, a background thread compresses and writes the full
+// chunks. Without captureBufferData only sizes and formats of the buffer writes are stored, the
+// player then uploads zeroes. Compression needs RECORDER_USE_LZ4, otherwise chunks are stored raw.
+class BinaryRecorder : public RecordingRenderResourceManager::RecorderInterface
+{
+public:
+	BinaryRecorder(const char* filename, bool captureBufferData = true, bool compress = true);
+	~BinaryRecorder();
+
+	bool isOpen() const
+	{
+		return mStream != NULL;
+	}
+
+	virtual void createVertexBuffer(unsigned int id, const physx::apex::NxUserRenderVertexBufferDesc& desc);
+	virtual void writeVertexBuffer(unsigned int id, const physx::apex::NxApexRenderVertexBufferData& data, unsigned int firstVertex, unsigned int numVertices);
+	virtual void releaseVertexBuffer(unsigned int id);
+
+	virtual void createIndexBuffer(unsigned int id, const physx::apex::NxUserRenderIndexBufferDesc& desc);
+	virtual void writeIndexBuffer(unsigned int id, const void* srcData, physx::PxU32 srcStride, unsigned int firstDestElement, unsigned int numElements, physx::apex::NxRenderDataFormat::Enum format);
+	virtual void releaseIndexBuffer(unsigned int id);
+
+	virtual void createBoneBuffer(unsigned int id, const physx::apex::NxUserRenderBoneBufferDesc& desc);
+	virtual void writeBoneBuffer(unsigned int id, const physx::apex::NxApexRenderBoneBufferData& data, unsigned int firstBone, unsigned int numBones);
+	virtual void releaseBoneBuffer(unsigned int id);
+
+	virtual void createSpriteBuffer(unsigned int id, const physx::apex::NxUserRenderSpriteBufferDesc& desc);
+	virtual void writeSpriteBuffer(unsigned int id, const physx::apex::NxApexRenderSpriteBufferData& data, unsigned int firstSprite, unsigned int numSprites);
+	virtual void releaseSpriteBuffer(unsigned int id);
+
+	virtual void createResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc);
+	virtual void renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc, const physx::apex::NxApexRenderContext& context);
+	virtual void releaseResource(unsigned int id);
+
+	virtual void setMaxBonesForMaterial(void* material, unsigned int maxBones);
+
+	virtual void endFrame();
+
+protected:
+	template<class SemanticClass, class SemanticEnum>
+	void writeBufferData(physx::PxU32 type, unsigned int id, const physx::apex::NxApexRenderBufferData<SemanticClass, SemanticEnum>& data, physx::PxU32 moduleId, unsigned int first, unsigned int count);
+	void writeRelease(physx::PxU32 type, unsigned int id);
+
+	RecordingStreamWriter* mStream;
+	physx::shdfnd::Mutex mMutex;
+	bool mCaptureBufferData;
+	physx::PxU32 mFrame;
+};
+
+
+// Replays a BinaryRecorder stream against any resource manager and renderer and measures how long
+// the target takes for the create, write, render and release calls of each frame.
+class RecordingPlayer
+{
+public:
+	struct FrameTimings
+	{
+		double create;
+		double write;
+		double render;
+		double release;
+		physx::PxU32 numCalls;
+		physx::PxU64 numBytesWritten;
+	};
+
+	// renderer may be NULL to only replay the resource traffic, recorded materials are replaced
+	// by defaultMaterial unless they were mapped with mapMaterial()
+	RecordingPlayer(physx::apex::NxUserRenderResourceManager& rrm, physx::apex::NxUserRenderer* renderer, void* defaultMaterial = NULL);
+	~RecordingPlayer();
+
+	bool open(const char* filename);
+
+	// releases everything the replay still holds
+	void close();
+
+	// returns false when the end of the recording was reached
+	bool playFrame(FrameTimings* timings = NULL);
+
+	void mapMaterial(physx::PxU64 recordedMaterial, void* material);
+
+	physx::PxU32 getFrame() const
+	{
+		return mFrame;
+	}
+
+protected:
+	struct Resource
+	{
+		physx::apex::NxUserRenderResource* resource;
+		physx::PxU32 ranges[8];
+		physx::PxU64 material;
+	};
+
+	void* resolveMaterial(physx::PxU64 material) const;
+	bool readBufferData(physx::PxU32 numSemantics, bool hasData, physx::PxU32 count);
+
+	physx::apex::NxUserRenderResourceManager& mRrm;
+	physx::apex::NxUserRenderer* mRenderer;
+	void* mDefaultMaterial;
+
+	RecordingStreamReader* mStream;
+	physx::PxU32 mFrame;
+
+	std::map<physx::PxU32, physx::apex::NxUserRenderVertexBuffer*> mVertexBuffers;
+	std::map<physx::PxU32, physx::apex::NxUserRenderIndexBuffer*> mIndexBuffers;
+	std::map<physx::PxU32, physx::apex::NxUserRenderBoneBuffer*> mBoneBuffers;
+	std::map<physx::PxU32, physx::apex::NxUserRenderSpriteBuffer*> mSpriteBuffers;
+	std::map<physx::PxU32, Resource> mResources;
+	std::map<physx::PxU64, void*> mMaterials;
+
+	// semantics and payload of the buffer write being replayed
+	std::vector<physx::PxU32> mSemantics;
+	std::vector<char> mScratch;
+};
+
+
 #endif // RECORDING_RENDER_RESOURCE_MANAGER_H
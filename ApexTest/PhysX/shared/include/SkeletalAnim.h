@@ -59,6 +59,8 @@ namespace Samples
 {
 
 class TriangleMesh;
+class WorkerPool;
+class SkeletalAnimJob;
 
 // ---------------------------------------------------------------------------
 struct SkeletalBone
@@ -113,6 +115,42 @@ struct SkeletalAnimation
 	float maxTime;
 };
 
+// Key frames of one animation converted to SoA streams, one track per bone in the bone
+// order of the skeleton. Built by SkeletalAnim::compileAnimations().
+struct CompiledAnimation
+{
+	void clear();
+	std::vector<physx::PxU32> trackFirstKey;
+	std::vector<physx::PxU32> trackNumKeys;
+	std::vector<float> times;
+	std::vector<physx::PxQuat> rotations;
+	std::vector<physx::PxVec3> translations;
+	std::vector<physx::PxVec3> scales;
+};
+
+// Pose state of one animated character, evaluated with SkeletalAnim::evaluateInstances().
+// The key cursors remember the last key pair of every bone, so advancing time by a frame
+// mostly finds the keys without searching.
+struct SkeletalAnimInstance
+{
+	SkeletalAnimInstance();
+	void clear();
+
+	// input
+	int animNr;
+	float time;
+	bool lockRootbone;
+
+	// output, same layout as SkeletalAnim::getSkinningMatrices() and getSkinningMatricesWorld()
+	std::vector<physx::PxMat44> skinningMatrices;
+	std::vector<physx::PxMat44> skinningMatricesWorld;
+
+	// internal
+	int cursorAnimNr;
+	std::vector<physx::PxU32> keyCursors;
+	std::vector<physx::PxMat34Legacy> worldPoses;
+};
+
 // ---------------------------------------------------------------------------
 class SkeletalAnim : public FAST_XML::FastXml::Callback
 {
@@ -132,6 +170,12 @@ public:
 
 	void setBindPose();
 	void setAnimPose(int animNr, float time, bool lockRootbone = false);
+
+	// converts the key frames into CompiledAnimations and sorts the bones parents first,
+	// done on demand by setAnimPose() and evaluateInstances() after loading
+	void compileAnimations();
+	// evaluates many characters sharing this skeleton, spread over the worker threads
+	void evaluateInstances(SkeletalAnimInstance* instances, physx::PxU32 numInstances);
 	const std::vector<SkeletalBone> &getBones() const
 	{
 		return mBones;
@@ -223,9 +267,9 @@ public:
 private:
 	void init(bool firstTime);
 	void initBindPoses(int boneNr, const physx::PxVec3& scale);
-	void setAnimPoseRec(int animNr, int boneNr, float time, bool lockBoneTranslation);
-
-	void interpolateBonePose(int animNr, int boneNr, float time, physx::PxMat34Legacy& pose, physx::PxVec3& scale);
+	void evaluateInstance(SkeletalAnimInstance& instance) const;
+	void evaluatePose(int animNr, float time, bool lockBoneTranslation, int& cursorAnimNr, physx::PxU32* keyCursors,
+	                  physx::PxMat34Legacy* worldPoses, physx::PxMat44* skinningMatrices, physx::PxMat44* skinningMatricesWorld) const;
 	int  findBone(const std::string& name);
 	void setupConnectivity();
 
@@ -239,9 +283,20 @@ private:
 	std::vector<SkeletalAnimation*> mAnimations;
 	std::vector<BoneKeyFrame> mKeyFrames;
 
+	// compiled animation
+	std::vector<CompiledAnimation> mCompiledAnimations;
+	std::vector<int> mEvalOrder; // bone indices, parents before children
+	bool mAnimationsCompiled;
+	int mCursorAnimNr;
+	std::vector<physx::PxU32> mKeyCursors;
+	std::vector<physx::PxMat34Legacy> mWorldPoses;
+	WorkerPool* mWorkers;
+
 	const SkeletalAnim* mParent;
 
 	bool ragdollMode;
+
+	friend class SkeletalAnimJob;
 };
 
 } // namespace Samples
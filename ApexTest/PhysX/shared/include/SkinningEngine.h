@@ -0,0 +1,110 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+#ifndef SKINNING_ENGINE_H
+#define SKINNING_ENGINE_H
+
+#include <vector>
+
+#include "foundation/PxVec3.h"
+#include "foundation/PxVec4.h"
+#include "foundation/PxMat44.h"
+
+namespace Samples
+{
+
+class WorkerPool;
+class SkinningJob;
+
+// ---------------------------------------------------------------------------
+// CPU linear blend skinning for TriangleMesh.
+//
+// setup() sorts the vertices by their number of bone influences into 1, 2, 3 and 4 bone
+// batches with packed bone and weight streams, so each batch runs a branch free SIMD kernel
+// that blends the bone matrices and transforms position and normal once per vertex.
+// Rest positions and normals are read from the mesh on every skin() call because morphs
+// and painting edit them in place. Large meshes are split into chunks and skinned on a
+// worker pool shared with the animation code.
+class SkinningEngine
+{
+public:
+	SkinningEngine();
+	~SkinningEngine();
+
+	// boneIndices and boneWeights hold 4 entries per vertex, numBoneWeights packs the influence
+	// count minus one in 2 bits per vertex, 16 vertices per word (see TriangleMesh::updateBoneWeights)
+	void setup(physx::PxU32 numVertices, const physx::PxU16* boneIndices, const physx::PxVec4* boneWeights, const physx::PxU32* numBoneWeights);
+	bool isSetUp(physx::PxU32 numVertices, physx::PxU32 version) const
+	{
+		return mNumVertices == numVertices && mVersion == version;
+	}
+	void setVersion(physx::PxU32 version)
+	{
+		mVersion = version;
+	}
+
+	// stores matrices[mapping[i]] * scale as bone matrix i
+	void setBoneMatrices(const physx::PxMat44* matrices, const int* mapping, physx::PxU32 numBones, float scale);
+
+	void skin(const physx::PxVec3* positions, const physx::PxVec3* normals, physx::PxVec3* destPositions, physx::PxVec3* destNormals);
+
+	// only meshes with at least this many vertices are distributed over the worker threads
+	static const physx::PxU32 PARALLEL_THRESHOLD = 8192;
+	static const physx::PxU32 CHUNK_SIZE = 2048;
+
+	struct Batch
+	{
+		std::vector<physx::PxU32> vertices;	// mesh vertex index per batch entry
+		std::vector<physx::PxU16> bones;	// numInfluences per entry
+		std::vector<float> weights;			// numInfluences per entry
+	};
+
+	struct Chunk
+	{
+		physx::PxU32 batch;
+		physx::PxU32 first;
+		physx::PxU32 count;
+	};
+
+private:
+	SkinningEngine(const SkinningEngine&);
+	SkinningEngine& operator=(const SkinningEngine&);
+
+	void skinChunk(const Chunk& chunk, const physx::PxVec3* positions, const physx::PxVec3* normals, physx::PxVec3* destPositions, physx::PxVec3* destNormals) const;
+
+	physx::PxU32 mNumVertices;
+	physx::PxU32 mVersion;
+	Batch mBatches[4];
+	std::vector<Chunk> mChunks;
+	std::vector<physx::PxMat44> mBoneMatrices;
+	WorkerPool* mWorkers;
+
+	friend class SkinningJob;
+};
+
+} // namespace Samples
+
+#endif // SKINNING_ENGINE_H
@@ -38,6 +38,9 @@
 #include "PsUserAllocated.h"
 #include "PxMat34Legacy.h"
 
+#include "SkinningEngine.h"
+#include "VertexCacheOptimizer.h"
+
 
 
 namespace physx
@@ -195,6 +198,67 @@ struct TriangleEdgeSplit		// for mesh subdivision
 	int next;
 };
 
+//------------------------------------------------------------------------------------
+// Sorted, disjoint vertex ranges that need another upload. Touching ranges are merged and
+// beyond MAX_RANGES the two closest ones are joined, so a few writes cover scattered changes.
+class DirtyVertexRanges
+{
+public:
+	enum
+	{
+		MAX_RANGES = 8,
+	};
+
+	DirtyVertexRanges() : mNumRanges(0) {}
+
+	void clear()
+	{
+		mNumRanges = 0;
+	}
+	bool isEmpty() const
+	{
+		return mNumRanges == 0;
+	}
+
+	void add(physx::PxU32 first, physx::PxU32 count);
+	void add(const DirtyVertexRanges& other);
+
+	physx::PxU32 getNumRanges() const
+	{
+		return mNumRanges;
+	}
+	physx::PxU32 getFirst(physx::PxU32 i) const
+	{
+		return mFirst[i];
+	}
+	physx::PxU32 getCount(physx::PxU32 i) const
+	{
+		return mEnd[i] - mFirst[i];
+	}
+
+private:
+	physx::PxU32 mNumRanges;
+	physx::PxU32 mFirst[MAX_RANGES + 1];
+	physx::PxU32 mEnd[MAX_RANGES + 1];
+};
+
+//------------------------------------------------------------------------------------
+struct RenderUploadStats	// data handed to the renderer by the last update
+{
+	RenderUploadStats() : dynamicBytes(0), staticBytes(0), indexBytes(0), boneBytes(0), numWrites(0) {}
+
+	physx::PxU32 getTotalBytes() const
+	{
+		return dynamicBytes + staticBytes + indexBytes + boneBytes;
+	}
+
+	physx::PxU32 dynamicBytes;	// positions and normals
+	physx::PxU32 staticBytes;	// texture coordinates and bone weights
+	physx::PxU32 indexBytes;
+	physx::PxU32 boneBytes;
+	physx::PxU32 numWrites;		// buffer writes or locks
+};
+
 //------------------------------------------------------------------------------------
 struct PaintedVertex
 {
@@ -420,6 +484,42 @@ public:
 	}
 
 	bool hasSkinningVertices();
+
+	// Optional reordering done by optimizeForRendering. It renumbers triangles and vertices, so it
+	// has to be set before vertex numbers are handed out to painting or other meshes.
+	enum RenderOptimization
+	{
+		RO_VERTEX_CACHE = (1 << 0),	// triangle order for the post-transform vertex cache
+		RO_OVERDRAW = (1 << 1),		// outward facing triangle clusters first, implies RO_VERTEX_CACHE
+		RO_VERTEX_FETCH = (1 << 2),	// vertices in order of first use, skipped while meshes loaded from this one exist
+	};
+	void setRenderOptimization(physx::PxU32 flags);
+	physx::PxU32 getRenderOptimization() const
+	{
+		return mRenderOptimization;
+	}
+
+	// vertex cache efficiency of all submeshes before and after the last reordering
+	const VertexCacheStatistics& getVertexCacheStatistics(bool optimized) const
+	{
+		return optimized ? mVertexCacheOptimized : mVertexCacheOriginal;
+	}
+
+	// Channels of the dynamic vertex buffer. Code that moves vertices marks the touched range and
+	// the next update only uploads those, texture coordinates and indices are written once.
+	enum RenderChannel
+	{
+		RC_POSITION = (1 << 0),
+		RC_NORMAL = (1 << 1),
+		RC_ALL = RC_POSITION | RC_NORMAL,
+	};
+	void markVerticesChanged(physx::PxU32 firstVertex, physx::PxU32 numVertices, physx::PxU32 channels = RC_ALL);
+
+	const RenderUploadStats& getRenderUploadStats() const
+	{
+		return mRenderUploadStats;
+	}
+
 private:
 	void operator=(const TriangleMesh& other)
 	{
@@ -429,6 +529,7 @@ private:
 	void updateTangents();
 	void updateBoneWeights();
 	void optimizeForRendering();
+	void optimizeRenderOrder();
 	void complete(bool useCustomChannels);
 	//void drawSubMesh(int nr, const physx::PxMat34Legacy* skinningMatrices);
 	void hasRandomColors(size_t howmany);
@@ -475,6 +576,14 @@ private:
 
 	std::vector<int> mBoneMappingInt2Ext;
 	std::vector<physx::PxMat34Legacy> mSkinningMatrices; // PH: VERY CAREFUL WHEN CHANGING THIS!!! The bone buffer doesn't validate types in writeBuffer calls!
+	SkinningEngine mSkinningEngine;
+	physx::PxU32 mBoneWeightsVersion; // bumped by optimizeForRendering, the skinning engine re-sorts its batches when it changes
+
+	// render order, see RenderOptimization
+	physx::PxU32 mRenderOptimization;
+	bool mRenderOrderOutdated;
+	VertexCacheStatistics mVertexCacheOriginal;
+	VertexCacheStatistics mVertexCacheOptimized;
 
 	// others
 	std::string mName;
@@ -492,6 +601,7 @@ private:
 	int mNextMark;
 
 	TriangleMesh* mParent;
+	physx::PxU32 mNumChildren; // meshes created with loadFromParent, they index the vertices of this mesh
 
 	// temporary, subdivision data structures
 	int addSplitVert(int vertNr0, int vertNr1);
@@ -506,6 +616,15 @@ private:
 	bool oneCullModeChanged;
 	bool textureUvOriginChanged;
 
+	// dynamic vertices changed since the last update, see RenderChannel
+	DirtyVertexRanges mDirtyPositions;
+	DirtyVertexRanges mDirtyNormals;
+	// bumped with every change of the dynamic vertices, children that draw the vertices of their parent compare it
+	// to the version they uploaded last since the parent's dirty ranges are cleared by the parent's own update
+	physx::PxU32 mVertexVersion;
+	physx::PxU32 mParentVertexVersion;
+	RenderUploadStats mRenderUploadStats;
+
 	std::vector<unsigned int> mRandomColors;
 
 	std::string mMaterialPrefix;
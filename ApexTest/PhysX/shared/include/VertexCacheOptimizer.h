@@ -0,0 +1,93 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+#ifndef VERTEX_CACHE_OPTIMIZER_H
+#define VERTEX_CACHE_OPTIMIZER_H
+
+#include <vector>
+
+#include "foundation/PxVec3.h"
+
+namespace Samples
+{
+
+// ---------------------------------------------------------------------------
+// Triangle and vertex reordering for indexed triangle lists, used by
+// TriangleMesh::optimizeForRendering.
+//
+// Triangles are reordered with Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for
+// Vertex Locality and Reduced Overdraw", SIGGRAPH 2007), which runs in linear time and tunes for
+// a FIFO post-transform cache of VERTEX_CACHE_SIZE entries. The same paper splits the output into
+// clusters that can be drawn in any order without losing much cache efficiency, the overdraw
+// pass sorts those so that outward facing clusters are drawn first. Vertex fetch order then
+// follows the first use of each vertex in the final index list.
+
+static const physx::PxU32 VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStatistics
+{
+	VertexCacheStatistics() : numTriangles(0), numVertices(0), numTransforms(0) {}
+
+	void add(const VertexCacheStatistics& other)
+	{
+		numTriangles += other.numTriangles;
+		numVertices += other.numVertices;
+		numTransforms += other.numTransforms;
+	}
+
+	// average cache miss ratio, vertex transforms per triangle (0.5 is the limit for large regular meshes)
+	float getACMR() const
+	{
+		return numTriangles > 0 ? (float)numTransforms / numTriangles : 0.0f;
+	}
+
+	// average transform to vertex ratio, 1 means every vertex is transformed exactly once
+	float getATVR() const
+	{
+		return numVertices > 0 ? (float)numTransforms / numVertices : 0.0f;
+	}
+
+	physx::PxU32 numTriangles;
+	physx::PxU32 numVertices;	// distinct vertices referenced
+	physx::PxU32 numTransforms;	// cache misses
+};
+
+// simulates a FIFO cache of VERTEX_CACHE_SIZE entries, indices are numbered below numVertices
+void measureVertexCache(const physx::PxU32* indices, physx::PxU32 numIndices, physx::PxU32 numVertices, VertexCacheStatistics& stats);
+
+// reorders the triangles in place, clusters receives the first triangle of each overdraw cluster if given
+void optimizeVertexCache(physx::PxU32* indices, physx::PxU32 numIndices, physx::PxU32 numVertices, std::vector<physx::PxU32>* clusters);
+
+// sorts the clusters of optimizeVertexCache by how much they face away from the center of the triangles
+void optimizeOverdraw(physx::PxU32* indices, physx::PxU32 numIndices, const physx::PxVec3* positions, const std::vector<physx::PxU32>& clusters);
+
+// renumbers the vertices in order of first use, oldToNew gets numVertices entries and unused
+// vertices are moved to the end in their old order
+void optimizeVertexFetch(physx::PxU32* indices, physx::PxU32 numIndices, physx::PxU32 numVertices, std::vector<physx::PxU32>& oldToNew);
+
+} // namespace Samples
+
+#endif // VERTEX_CACHE_OPTIMIZER_H
@@ -0,0 +1,93 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <vector>
+
+#include "foundation/PxSimpleTypes.h"
+#include "PsUserAllocated.h"
+#include "PsMutex.h"
+#include "PsSync.h"
+
+namespace Samples
+{
+
+// ---------------------------------------------------------------------------
+// Worker threads shared by the CPU skinning and animation code. run() executes job items
+// 0 .. count - 1, the calling thread takes part and items are handed out through an atomic
+// counter. Calls from different threads are serialized, a job must not call run() itself.
+class WorkerPool : public physx::shdfnd::UserAllocated
+{
+public:
+	class Job
+	{
+	public:
+		virtual void execute(physx::PxU32 item) = 0;
+	protected:
+		virtual ~Job() {}
+	};
+
+	// returns NULL on single processor machines, the caller then runs the items itself
+	static WorkerPool* acquire();
+	static void release(WorkerPool* pool);
+
+	void run(Job& job, physx::PxU32 count);
+
+	// worker threads plus the calling thread
+	physx::PxU32 getNumThreads() const
+	{
+		return (physx::PxU32)mWorkers.size() + 1;
+	}
+
+private:
+	class Worker;
+
+	WorkerPool(physx::PxU32 numWorkers);
+	~WorkerPool();
+
+	void work();
+
+	static physx::PxU32 getNumProcessors();
+
+	std::vector<Worker*> mWorkers;
+	physx::shdfnd::Mutex mRunMutex;
+	physx::shdfnd::Sync mDone;
+	volatile physx::PxI32 mNextItem;
+	volatile physx::PxI32 mPending;
+
+	Job* mJob;
+	physx::PxI32 mCount;
+
+	static WorkerPool* sInstance;
+	static physx::PxU32 sRefCount;
+
+};
+
+} // namespace Samples
+
+#endif // WORKER_POOL_H
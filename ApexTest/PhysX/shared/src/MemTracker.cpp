@@ -29,32 +29,17 @@
 
 #ifdef PX_WINDOWS // only compile this source code for windows!
 
-#define USE_HASH_MAP 1
-
-// VC10 hash maps are abominably slow with iterator debug level == 0
-//   Note: All STL containers are used internally, so their should not be any resultant conflict
-#if defined(PX_VC10) && USE_HASH_MAP
-#define OVERRIDE_ITERATOR_DEBUG_LEVEL 1
-#else 
-#define OVERRIDE_ITERATOR_DEBUG_LEVEL 0
-#endif
-
-#if OVERRIDE_ITERATOR_DEBUG_LEVEL
-#define _ITERATOR_DEBUG_LEVEL 0
-#define _ALLOW_ITERATOR_DEBUG_LEVEL_MISMATCH 1
-#endif
-
 #include "htmltable.h"
 #include "foundation/PxSimpleTypes.h"
 #include "foundation/PxAssert.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
 #include <string.h>
 #include <assert.h>
 #include <time.h>
 #include <sys/types.h>
 #include <sys/timeb.h>
-#include <hash_map>
 #include <map>
 #include <vector>
 #include <windows.h>
@@ -64,98 +49,448 @@
 namespace MEM_TRACKER
 {
 
-class ContextType
+// Number of independently locked sections of the live allocation table.
+static const physx::PxU32 STRIPE_COUNT = 64;
+
+// Number of allocations a thread records before they are published to the shared tables.
+static const physx::PxU32 BATCH_SIZE = 64;
+
+static const physx::PxU32 INVALID_INDEX = 0xFFFFFFFF;
+
+static void getDateTime(char *date_time)
+{
+	time_t ltime;
+	struct tm *today;
+	_tzset();
+	time( &ltime );
+	today = localtime( &ltime );
+	strftime( date_time, 128,"%A-%B-%d-%Y-%I-%M-%S-%p", today );
+}
+
+size_t getPow2(size_t s,size_t &p)
+{
+	size_t ret = 0;
+	while ( s > p )
+	{
+		p = p<<1;
+		ret++;
+	}
+	return ret;
+}
+
+static inline physx::PxU32 hashPointer(const void *p)
+{
+	physx::PxU64 h = (physx::PxU64)(size_t)p;
+	h = (h ^ (h >> 29)) * 0x9E3779B97F4A7C15ULL;
+	return (physx::PxU32)(h >> 32);
+}
+
+static inline physx::PxU32 hashCombine(physx::PxU32 seed,physx::PxU32 value)
+{
+	return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+// The tracker runs underneath the allocator handed to the SDK, so it only relies on the OS for locking.
+class TrackerMutex
 {
 public:
-	ContextType(void)
+	TrackerMutex(void)
 	{
-		mContext = NULL;
-		mType = NULL;
-		mAllocCount = 0;
-		mAllocSize = 0;
+		InitializeCriticalSectionAndSpinCount(&mSection,4000);
 	}
-	ContextType(const char *context,const char *type,size_t size)
+	~TrackerMutex(void)
 	{
-		mContext = context;
-		mType	= type;
-		char scratch[512];
-		sprintf_s(scratch,512,"PlatformAnalyzer/ContextType/%s/%s/Count(AllocCount)", mContext, mType );
-		mAllocCountSpec = scratch;
-		sprintf_s(scratch,512,"PlatformAnalyzer/ContextType/%s/%s/Size(AllocSize)", mContext, mType );
-		mAllocSizeSpec = scratch;
-		mAllocCount = 1;
-		mAllocSize = size;
+		DeleteCriticalSection(&mSection);
+	}
+	void lock(void)
+	{
+		EnterCriticalSection(&mSection);
+	}
+	void unlock(void)
+	{
+		LeaveCriticalSection(&mSection);
 	}
 
-	const	char	*mContext;
-	const	char	*mType;
-	physx::PxU32	mAllocCount;
-	size_t			mAllocSize;
-	std::string		mAllocCountSpec;
-	std::string		mAllocSizeSpec;
+	class ScopedLock
+	{
+	public:
+		ScopedLock(TrackerMutex &mutex) : mMutex(mutex) { mMutex.lock(); }
+		~ScopedLock(void) { mMutex.unlock(); }
+	private:
+		ScopedLock& operator=(const ScopedLock&);
+		TrackerMutex &mMutex;
+	};
+
+private:
+	TrackerMutex(const TrackerMutex&);
+	TrackerMutex& operator=(const TrackerMutex&);
+
+	CRITICAL_SECTION mSection;
 };
 
-class ByContextIndex
+// Everything describing where an allocation came from, shared by all allocations from that place.
+class AllocSite
 {
 public:
-	ByContextIndex(const char *context,const char *type)
+	AllocSite(void) { };
+	AllocSite(const char *context,const char *className,const char *fileName,physx::PxU32 lineNo,MemoryType type,physx::PxU32 source)
 	{
 		mContext = context;
+		mClassName = className;
+		mFileName = fileName;
+		mLineNo = lineNo;
 		mType = type;
+		mSource = source;
 	}
 
-	const	char	*mContext;
-	const	char	*mType;
+	physx::PxU32 hash(void) const
+	{
+		physx::PxU32 h = hashPointer(mContext);
+		h = hashCombine(h,hashPointer(mClassName));
+		h = hashCombine(h,hashPointer(mFileName));
+		h = hashCombine(h,mLineNo);
+		return hashCombine(h,(physx::PxU32)mType);
+	}
+
+	bool operator==(const AllocSite &s) const
+	{
+		return mContext == s.mContext && mClassName == s.mClassName && mFileName == s.mFileName && mLineNo == s.mLineNo && mType == s.mType;
+	}
+
+	const char   *mContext;
+	const char   *mClassName;
+	const char   *mFileName;
+	physx::PxU32  mLineNo;
+	MemoryType    mType;
+	physx::PxU32  mSource;	// index of the file and line number entry counting allocations made there
 };
 
-class ByContextHasher
+class AllocSource
 {
 public:
-	static const size_t bucket_size = 4;
-	static const size_t min_buckets = 8;
+	AllocSource(void) { };
+	AllocSource(const char *fileName,physx::PxU32 lineNo)
+	{
+		mFileName = fileName;
+		mLineNo = lineNo;
+		mCount = 0;
+	}
 
-	size_t operator()(const ByContextIndex &index) const
+	physx::PxU32 hash(void) const
 	{
-		size_t hash1 = (size_t)index.mContext;
-		size_t hash2 = (size_t)index.mType;
-		size_t hash = hash1 ^ hash2;
-		return hash;
+		return hashCombine(hashPointer(mFileName),mLineNo);
 	}
 
-	bool operator()(const ByContextIndex &s1,const ByContextIndex &s2) const
+	bool operator==(const AllocSource &s) const
 	{
-		if ( s1.mContext < s2.mContext ) return true;
-		if ( s1.mContext > s2.mContext ) return false;
-		return s1.mType < s2.mType;
+		return mFileName == s.mFileName && mLineNo == s.mLineNo;
 	}
+
+	const char   *mFileName;
+	physx::PxU32  mLineNo;
+	physx::PxU32  mCount;
 };
 
-#if USE_HASH_MAP
-typedef stdext::hash_map< ByContextIndex, ContextType, ByContextHasher > ByContextTypeHash;
-#else
-typedef std::map< ByContextIndex, ContextType, ByContextHasher > ByContextTypeHash;
-#endif
+// Open addressed table handing out a stable index for every distinct entry it is given.
+template< class Entry >
+class InternTable
+{
+public:
+	InternTable(void)
+	{
+		mSlots = NULL;
+		mMask = 0;
+	}
+	~InternTable(void)
+	{
+		::free(mSlots);
+	}
 
-static void getDateTime(char *date_time)
+	physx::PxU32 intern(const Entry &e)
+	{
+		if ( mSlots == NULL || (mEntries.size()+1)*2 > mMask+1 )
+		{
+			rehash( mSlots ? (mMask+1)*2 : 64 );
+		}
+		physx::PxU32 i = e.hash() & mMask;
+		for (;;)
+		{
+			physx::PxU32 slot = mSlots[i];
+			if ( slot == 0 )
+			{
+				mEntries.push_back(e);
+				mSlots[i] = (physx::PxU32)mEntries.size();
+				return mSlots[i]-1;
+			}
+			if ( mEntries[slot-1] == e )
+			{
+				return slot-1;
+			}
+			i = (i+1)&mMask;
+		}
+	}
+
+	Entry & operator[](physx::PxU32 index) { return mEntries[index]; }
+	const Entry & operator[](physx::PxU32 index) const { return mEntries[index]; }
+
+private:
+	void rehash(physx::PxU32 capacity)
+	{
+		::free(mSlots);
+		mSlots = (physx::PxU32 *)::calloc(capacity,sizeof(physx::PxU32));
+		mMask = capacity-1;
+		for (physx::PxU32 j=0; j<(physx::PxU32)mEntries.size(); j++)
+		{
+			physx::PxU32 i = mEntries[j].hash() & mMask;
+			while ( mSlots[i] )
+			{
+				i = (i+1)&mMask;
+			}
+			mSlots[i] = j+1;
+		}
+	}
+
+	std::vector< Entry > mEntries;
+	physx::PxU32        *mSlots;
+	physx::PxU32         mMask;
+};
+
+typedef InternTable< AllocSite > AllocSiteTable;
+typedef InternTable< AllocSource > AllocSourceTable;
+
+// A live allocation.  Kept to 32 bytes on every platform; an address of zero marks an empty slot.
+struct AllocRecord
 {
-	time_t ltime;
-	struct tm *today;
-	_tzset();
-	time( &ltime );
-	today = localtime( &ltime );
-	strftime( date_time, 128,"%A-%B-%d-%Y-%I-%M-%S-%p", today );
-}
+	physx::PxU64 mAddress;
+	physx::PxU64 mSize;
+	physx::PxU32 mThreadId;
+	physx::PxU32 mAllocCount;
+	physx::PxU32 mSite;
+	physx::PxU32 mPad;
+};
 
-size_t getPow2(size_t s,size_t &p)
+// One lock and one linearly probed slot array.  Neighbouring blocks land in neighbouring slots, so
+// walking through memory allocated in sequence touches few cache lines; folding in the address bits
+// above the table size keeps power of two strides from piling onto the same slots.
+class RecordStripe
 {
-	size_t ret = 0;
-	while ( s > p )
+public:
+	RecordStripe(void)
 	{
-		p = p<<1;
-		ret++;
+		mSlots = NULL;
+		mMask = 0;
+		mShift = 0;
+		mCount = 0;
+	}
+	~RecordStripe(void)
+	{
+		::free(mSlots);
+	}
+
+	// Returns false if the address is already live, leaving the existing record untouched in 'previous'.
+	bool insert(const AllocRecord &r,AllocRecord &previous)
+	{
+		if ( mSlots == NULL || (mCount+1)*4 > (mMask+1)*3 )
+		{
+			grow();
+		}
+		physx::PxU32 i = home(r.mAddress);
+		while ( mSlots[i].mAddress )
+		{
+			if ( mSlots[i].mAddress == r.mAddress )
+			{
+				previous = mSlots[i];
+				return false;
+			}
+			i = (i+1)&mMask;
+		}
+		mSlots[i] = r;
+		mCount++;
+		return true;
+	}
+
+	const AllocRecord * find(physx::PxU64 address) const
+	{
+		if ( mSlots )
+		{
+			physx::PxU32 i = home(address);
+			while ( mSlots[i].mAddress )
+			{
+				if ( mSlots[i].mAddress == address )
+				{
+					return &mSlots[i];
+				}
+				i = (i+1)&mMask;
+			}
+		}
+		return NULL;
+	}
+
+	bool remove(physx::PxU64 address,AllocRecord &r)
+	{
+		const AllocRecord *found = find(address);
+		if ( found == NULL )
+		{
+			return false;
+		}
+		r = *found;
+		mCount--;
+		// backward shift deletion, so lookups never have to skip over tombstones.
+		physx::PxU32 i = (physx::PxU32)(found - mSlots);
+		physx::PxU32 j = i;
+		for (;;)
+		{
+			j = (j+1)&mMask;
+			if ( mSlots[j].mAddress == 0 )
+			{
+				break;
+			}
+			physx::PxU32 k = home(mSlots[j].mAddress);
+			if ( ((j-k)&mMask) >= ((j-i)&mMask) )
+			{
+				mSlots[i] = mSlots[j];
+				i = j;
+			}
+		}
+		mSlots[i].mAddress = 0;
+		return true;
+	}
+
+	physx::PxU32 getCount(void) const { return mCount; }
+
+	template< class Visitor >
+	void visit(Visitor &v) const
+	{
+		if ( mSlots )
+		{
+			for (physx::PxU32 i=0; i<=mMask; i++)
+			{
+				if ( mSlots[i].mAddress )
+				{
+					v(mSlots[i]);
+				}
+			}
+		}
+	}
+
+	TrackerMutex mMutex;
+
+private:
+	RecordStripe(const RecordStripe&);
+	RecordStripe& operator=(const RecordStripe&);
+
+	physx::PxU32 home(physx::PxU64 address) const
+	{
+		physx::PxU64 x = address >> 4;	// blocks are at least 16 byte aligned
+		return (physx::PxU32)(x ^ (x >> mShift) ^ (x >> (mShift*2))) & mMask;
+	}
+
+	void grow(void)
+	{
+		AllocRecord *old = mSlots;
+		physx::PxU32 oldCapacity = old ? mMask+1 : 0;
+		physx::PxU32 capacity = old ? oldCapacity*2 : 256;
+		mSlots = (AllocRecord *)::calloc(capacity,sizeof(AllocRecord));
+		mMask = capacity-1;
+		mShift = 0;
+		while ( (1U << mShift) < capacity )
+		{
+			mShift++;
+		}
+		for (physx::PxU32 j=0; j<oldCapacity; j++)
+		{
+			if ( old[j].mAddress )
+			{
+				physx::PxU32 i = home(old[j].mAddress);
+				while ( mSlots[i].mAddress )
+				{
+					i = (i+1)&mMask;
+				}
+				mSlots[i] = old[j];
+			}
+		}
+		::free(old);
+	}
+
+	AllocRecord  *mSlots;
+	physx::PxU32  mMask;
+	physx::PxU32  mShift;
+	physx::PxU32  mCount;
+};
+
+// An allocation recorded by a thread but not yet published to the shared tables.
+struct PendingAlloc
+{
+	void         *mMemory;
+	size_t        mSize;
+	size_t        mThreadId;
+	const char   *mContext;
+	const char   *mClassName;
+	const char   *mFileName;
+	physx::PxU32  mLineNo;
+	MemoryType    mType;
+};
+
+// Per thread event buffer.  Only the owning thread appends to it; any thread may drain it.
+class ThreadBatch
+{
+public:
+	ThreadBatch(void)
+	{
+		clear();
+		mFrameAllocCount = 0;
+		mFrameAllocSize = 0;
+		mFrameFreeCount = 0;
+		mFrameFreeSize = 0;
+		mNext = NULL;
+	}
+
+	PendingAlloc & push(void *mem)
+	{
+		physx::PxU32 i = hashPointer(mem) & (PENDING_SLOTS-1);
+		while ( mSlots[i] )
+		{
+			i = (i+1)&(PENDING_SLOTS-1);
+		}
+		mSlots[i] = (physx::PxU8)(mAllocCount+1);
+		mLive[mAllocCount] = mem;
+		return mAllocs[mAllocCount++];
+	}
+
+	// Returns BATCH_SIZE if the block is not waiting in this batch.
+	physx::PxU32 findPending(const void *mem) const
+	{
+		physx::PxU32 i = hashPointer(mem) & (PENDING_SLOTS-1);
+		while ( mSlots[i] )
+		{
+			if ( mLive[mSlots[i]-1] == mem )
+			{
+				return mSlots[i]-1;
+			}
+			i = (i+1)&(PENDING_SLOTS-1);
+		}
+		return BATCH_SIZE;
 	}
-	return ret;
-}
+
+	void clear(void)
+	{
+		mAllocCount = 0;
+		memset(mSlots,0,sizeof(mSlots));
+	}
+
+	enum { PENDING_SLOTS = BATCH_SIZE*2 };
+
+	TrackerMutex  mMutex;
+	PendingAlloc  mAllocs[BATCH_SIZE];
+	const void   *mLive[BATCH_SIZE];		// address of each pending allocation, or NULL once it was released again
+	physx::PxU8   mSlots[PENDING_SLOTS];	// open addressed index into mAllocs, so frees do not scan the batch
+	physx::PxU32  mAllocCount;
+	size_t        mFrameAllocCount;
+	size_t        mFrameAllocSize;
+	size_t        mFrameFreeCount;
+	size_t        mFrameFreeSize;
+	ThreadBatch  *mNext;
+};
 
 class MemTrack
 {
@@ -168,6 +503,7 @@ public:
   const char *mFileName;
   physx::PxU32       mLineNo;
   size_t       mAllocCount;
+  size_t       mMemory;
 };
 
 class ByType
@@ -205,11 +541,7 @@ public:
   size_t       mCount;
 };
 
-#if USE_HASH_MAP
-typedef stdext::hash_map< size_t, ByType > ByTypeHash;
-#else
 typedef std::map< size_t, ByType > ByTypeHash;
-#endif
 
 class BySourceIndex
 {
@@ -227,16 +559,6 @@ public:
 class BySourceHasher
 {
 public:
-	static const size_t bucket_size = 4;
-	static const size_t min_buckets = 8;
-
-	size_t operator()(const BySourceIndex &index) const
-	{
-		size_t hash = (size_t)index.mFileName;
-		hash = hash^index.mLineNo;
-		return hash;
-	}
-
 	bool operator()(const BySourceIndex &s1,const BySourceIndex &s2) const
 	{
 		if ( s1.mFileName < s2.mFileName ) return true;
@@ -245,17 +567,11 @@ public:
 	}
 };
 
-#if USE_HASH_MAP
-typedef stdext::hash_map< BySourceIndex, BySource, BySourceHasher > BySourceHash;
-typedef stdext::hash_map< size_t , MemTrack > MemTrackHash;
-#else
 typedef std::map< BySourceIndex, BySource, BySourceHasher > BySourceHash;
-typedef std::map< size_t , MemTrack > MemTrackHash;
-#endif
 
 typedef std::vector< MemTrack > MemTrackVector;
 
-class ReportContext 
+class ReportContext
 {
 public:
   ReportContext(const char *context)
@@ -516,11 +832,8 @@ private:
   MemTrackVector    mMemTracks;
 };
 
-#if USE_HASH_MAP
-typedef stdext::hash_map< size_t , ReportContext * > ReportContextHash;
-#else
+
 typedef std::map< size_t , ReportContext * > ReportContextHash;
-#endif
 
 class MyMemTracker : public MemTracker
 {
@@ -529,6 +842,8 @@ public:
 	MyMemTracker(void)
 	{
 		mSingleThreaded = false;
+	  mLogEveryAllocation = false;
+	  mLogEveryFrame = false;
 	  mFrameNo = 1;
 	  mAllocCount = 0;
 	  mAllocSize = 0;
@@ -539,6 +854,8 @@ public:
 	  mDocument = 0;
 	  mFrameSummary = 0;
 	  mDetailed = 0;
+	  mBatches = NULL;
+	  mTlsIndex = TlsAlloc();
 	  physx::HtmlTableInterface *h = physx::getHtmlTableInterface();
 	  if ( h )
 	  {
@@ -554,94 +871,42 @@ public:
 		physx::HtmlTableInterface *h = physx::getHtmlTableInterface();
 		h->releaseHtmlDocument(mDocument);
 	  }
+	  TlsFree(mTlsIndex);
+	  while ( mBatches )
+	  {
+		  ThreadBatch *next = mBatches->mNext;
+		  delete mBatches;
+		  mBatches = next;
+	  }
 	}
 
+  // Allocations are only appended to the calling thread's batch here; they reach the shared
+  // tables when the batch fills up, or earlier if another thread or a query needs to see them.
   virtual void trackAlloc(size_t threadId,void *mem,size_t size,MemoryType type,const char *context,const char *className,const char *fileName,physx::PxU32 lineno)
   {
 	if ( mem )
 	{
-		addContextType(context,className,size);
-
-	  mAllocCount++;
-	  mAllocSize+=size;
-
-	  mAllocFrameCount++;
-	  mAllocFrameSize+=size;
-
-	  size_t hash = (size_t) mem;
-	  MemTrack t;
-	  t.mType = type;
-	  t.mSize = size;
-	  t.mThreadId  = threadId;
-	  t.mContext   = context;
-	  t.mClassName = className;
-	  t.mFileName  = fileName;
-	  t.mLineNo    = lineno;
-	  t.mAllocCount = 1;
-	  MemTrackHash::iterator found = mMemory.find(hash);
-	  if ( found != mMemory.end()  )
+	  ThreadBatch &b = getBatch();
+	  TrackerMutex::ScopedLock lock(b.mMutex);
+	  if ( b.mAllocCount == BATCH_SIZE )
 	  {
-		  PX_ALWAYS_ASSERT();
-		  const MemTrack &previous = (*found).second;
-		  printf("Prev: %s\r\n", previous.mClassName );
-		  PX_FORCE_PARAMETER_REFERENCE(previous);
-	  }
-	  // track which allocation number this one was.
-	  {
-		BySource b(t);
-		b.mCount = 1;
-		BySourceIndex index(b.mFileName,b.mLineNo);
-		BySourceHash::iterator found = mSourceHash.find(index);
-		if ( found == mSourceHash.end() )
-		{
-			mSourceHash[index] = b;
-		}
-		else
-		{
-			BySource bs = (*found).second;
-			bs.mCount++;
-			t.mAllocCount = bs.mCount;
-			mSourceHash[index] = bs;
-		}
+		  flushBatch(b);
 	  }
+	  PendingAlloc &p = b.push(mem);
+	  p.mMemory    = mem;
+	  p.mSize      = size;
+	  p.mThreadId  = threadId;
+	  p.mContext   = context;
+	  p.mClassName = className;
+	  p.mFileName  = fileName;
+	  p.mLineNo    = lineno;
+	  p.mType      = type;
+	  b.mFrameAllocCount++;
+	  b.mFrameAllocSize+=size;
 	  if ( mDetailed )
 	  {
-		mDetailed->addColumnHex( (size_t)mem );
-		switch ( type )
-		{
-		  case MT_NEW:
-			  mDetailed->addColumn("NEW");
-			  break;
-		  case MT_NEW_ARRAY:
-			  mDetailed->addColumn("NEW_ARRAY");
-			  break;
-		  case MT_MALLOC:
-			  mDetailed->addColumn("MALLOC");
-			  break;
-		  case MT_GLOBAL_NEW:
-			  mDetailed->addColumn("GLOBAL_NEW");
-			  break;
-		  case MT_GLOBAL_NEW_ARRAY:
-			  mDetailed->addColumn("GLOBAL_NEW_ARRAY");
-			  break;
-		  default:
-			  PX_ALWAYS_ASSERT();
-			  mDetailed->addColumn("ERROR");
-			  break;
-		}
-		mDetailed->addColumn((physx::PxU32)size);
-		mDetailed->addColumn((physx::PxU32)t.mAllocCount);
-		mDetailed->addColumnHex(threadId);
-		mDetailed->addColumn(context);
-		mDetailed->addColumn(className);
-		mDetailed->addColumn(fileName);
-		mDetailed->addColumn((physx::PxU32)lineno);
-		mDetailed->nextRow();
+		  flushBatch(b); // the detailed log is written in allocation order
 	  }
-
-	  mMemory[hash] = t;
-
-	  PX_ASSERT( mAllocCount == mMemory.size() );
 	}
   }
 
@@ -713,17 +978,14 @@ public:
 		  char scratch[1024];
 		  scratch[0] = 0;
 
-		  size_t hash = (size_t) mem;
-		  MemTrackHash::iterator found = mMemory.find(hash);
-		  if ( found == mMemory.end() )
+		  MemTrack t;
+		  if ( !findTrack(mem,t) )
 		  {
 			  sprintf_s(scratch,1024,"Error! Tried to free memory never tracked.  Source: %s : Line: %d\r\n", fileName, lineno);
 			  PX_ALWAYS_ASSERT();
 		  }
 		  else
 		  {
-			  MemTrack &t = (MemTrack &)(*found).second;
-
 			  switch ( type )
 			  {
 			  case MT_DELETE:
@@ -779,6 +1041,7 @@ public:
 		  }
 		  if ( scratch[0] )
 		  {
+			  TrackerMutex::ScopedLock lock(mMutex);
 			  mErrorMessage = scratch;
 			  ret = mErrorMessage.c_str();
 		  }
@@ -786,74 +1049,50 @@ public:
 	  return ret;
   }
 
-  void addContextType(const char *context,const char *type,size_t size)
+  virtual void trackFree(size_t threadId,void *mem,MemoryType type,const char *context,const char *fileName,physx::PxU32 lineno)
   {
-	  ByContextIndex index(context,type);
-	  ByContextTypeHash::iterator found = mContextType.find(index);
-	  if ( found != mContextType.end() )
-	  {
-		  ContextType &c = (ContextType &)(*found).second;
-		  PX_ASSERT( c.mContext == context );
-		  PX_ASSERT( c.mType == type );
-		  c.mAllocCount++;
-		  c.mAllocSize+=size;
-	  }
-	  else
-	  {
-		  ContextType c(context,type,size);
-		  mContextType[index] = c;
-	  }
-#if 0
-	  int foundCount=0;
+	if ( mem )
+	{
+	  ThreadBatch &b = getBatch();
+	  MemTrack t;
+	  bool found = false;
 	  {
-		  for (ByContextTypeHash::iterator i=mContextType.begin(); i!=mContextType.end(); ++i)
+		  // most blocks are released by the thread that allocated them, often before their batch was published.
+		  TrackerMutex::ScopedLock lock(b.mMutex);
+		  physx::PxU32 pending = mDetailed ? BATCH_SIZE : b.findPending(mem);
+		  if ( pending != BATCH_SIZE )
 		  {
-			  const ByContextIndex &index = (*i).first;
-			  if ( index.mContext == context && index.mType == type )
-			  {
-				  foundCount++;
-			  }
+			  b.mLive[pending] = NULL;
+			  b.mFrameFreeCount++;
+			  b.mFrameFreeSize+=b.mAllocs[pending].mSize;
+			  return;
 		  }
 	  }
-	  PX_ASSERT( foundCount == 1 );
-#endif
-  }
-
-  void removeContextType(const char *context,const char *type,size_t size)
-  {
-	  ByContextIndex index(context,type);
-	  ByContextTypeHash::iterator found = mContextType.find(index);
-	  if ( found  != mContextType.end() )
+	  AllocRecord r;
+	  if ( removeRecord(mem,r) )
 	  {
-		  ContextType &c = (ContextType &)(*found).second;
-		  c.mAllocCount--;
-		  c.mAllocSize-=size;
+		  found = true;
 	  }
 	  else
 	  {
-		  PX_ALWAYS_ASSERT();
+		  flushAll(); // it may still be waiting in another thread's batch
+		  found = removeRecord(mem,r);
 	  }
-
-
-  }
-
-
-  virtual void trackFree(size_t threadId,void *mem,MemoryType type,const char *context,const char *fileName,physx::PxU32 lineno)
-  {
-	if ( mem )
-	{
-	  size_t hash = (size_t) mem;
-	  MemTrackHash::iterator found = mMemory.find(hash);
-	  if ( found == mMemory.end() )
+	  if ( !found )
 	  {
 		  PX_ALWAYS_ASSERT();
 	  }
 	  else
 	  {
-		  const MemTrack &t = (*found).second;
-		  removeContextType(t.mContext,t.mClassName,t.mSize);
+		  {
+			  TrackerMutex::ScopedLock lock(b.mMutex);
+			  b.mFrameFreeCount++;
+			  b.mFrameFreeSize+=(size_t)r.mSize;
+		  }
 		  if ( mDetailed )
 		  {
+			TrackerMutex::ScopedLock lock(mMutex);
+			expandRecord(r,t);
 			mDetailed->addColumnHex( (size_t) mem );
 			switch ( type )
 			{
@@ -886,22 +1125,15 @@ public:
 			mDetailed->addColumn((physx::PxU32)lineno);
 			mDetailed->nextRow();
 		  }
-
-		  mAllocCount--;
-		  mAllocSize-=t.mSize;
-
-		  mFreeFrameCount++;
-		  mFreeFrameSize+=t.mSize;
-
-		  mMemory.erase(hash);
-
-		  PX_ASSERT( mAllocCount == mMemory.size() );
 	  }
 	}
   }
 
+  // Publishing every batch makes the running totals exact, so a frame snapshot is just a copy of them.
   void trackFrame(void)
   {
+	flushAll();
+	TrackerMutex::ScopedLock lock(mMutex);
 	mFrameNo++;
 	if ( mAllocFrameCount || mFreeFrameCount )
 	{
@@ -947,6 +1179,19 @@ public:
 	  void *ret = NULL;
 	  saveLen = 0;
 
+	flushAll();
+
+	MemTrackVector tracks;
+	{
+		TrackerMutex::ScopedLock lock(mMutex);
+		RecordCollector collector(*this,tracks);
+		for (physx::PxU32 i=0; i<STRIPE_COUNT; i++)
+		{
+			TrackerMutex::ScopedLock stripeLock(mStripes[i].mMutex);
+			mStripes[i].visit(collector);
+		}
+	}
+
 	//
 	physx::HtmlTable *contextTable = NULL;
 	{
@@ -963,10 +1208,10 @@ public:
 	ReportContextHash rchash;
 	{
 	ReportContext *current = 0;
-	  
-	  for (MemTrackHash::iterator i=mMemory.begin(); i!=mMemory.end(); ++i)
+
+	  for (MemTrackVector::iterator i=tracks.begin(); i!=tracks.end(); ++i)
 	  {
-		  MemTrack t = (*i).second;
+		  const MemTrack &t = (*i);
 		  if ( (current == 0) || current->getContext() != t.mContext )
 		  {
 			  size_t hash = (size_t)t.mContext;
@@ -998,11 +1243,11 @@ public:
 
 		table->excludeTotals(2);
 		table->excludeTotals(8);
-		
-		for (MemTrackHash::iterator i=mMemory.begin();  i!=mMemory.end(); ++i)
+
+		for (MemTrackVector::iterator i=tracks.begin();  i!=tracks.end(); ++i)
 		{
-			MemTrack t = (*i).second;
-			table->addColumnHex( (size_t)(*i).first ); // memory address
+			const MemTrack &t = (*i);
+			table->addColumnHex( t.mMemory ); // memory address
 			table->addColumn((physx::PxU32) t.mAllocCount ); // allocation count.
 			table->addColumn((physx::PxU32) t.mSize );       // size of allocation.
 			table->addColumnHex( t.mThreadId ); // thread id
@@ -1017,7 +1262,7 @@ public:
 	  }
 	  //
 	  {
-		  
+
 		  for (ReportContextHash::iterator i=rchash.begin(); i!=rchash.end(); ++i)
 		  {
 			  ReportContext *rc = (*i).second;
@@ -1070,12 +1315,15 @@ public:
 
 	virtual void usage(void)
 	{
+		flushAll();
 		printf("On Frame Number: %d has performed %d memory allocations for a total %d bytes of memory.\r\n", mFrameNo,mAllocCount,mAllocSize );
 	}
 
 
 	virtual size_t detectLeaks(size_t &acount)
 	{
+		flushAll();
+		TrackerMutex::ScopedLock lock(mMutex);
 		acount = mAllocCount;
 		return mAllocSize;
 	}
@@ -1083,6 +1331,8 @@ public:
 
   virtual void setLogLevel(bool logEveryAllocation,bool logEveryFrame,bool verifySingleThreaded)
   {
+	flushAll();
+	TrackerMutex::ScopedLock lock(mMutex);
 	  mSingleThreaded = verifySingleThreaded;
 	mLogEveryAllocation = logEveryAllocation;
 	mLogEveryFrame      = logEveryFrame;
@@ -1120,15 +1370,13 @@ public:
 
 		if ( mem )
 		{
-		  size_t hash = (size_t) mem;
-		  MemTrackHash::iterator found = mMemory.find(hash);
-		  if ( found == mMemory.end() )
+		  MemTrack t;
+		  if ( !findTrack(mem,t) )
 		  {
 			  printf("Error! Tried to get information for memory never tracked.\r\n");
 		  }
 		  else
 		  {
-			  MemTrack &t = (MemTrack &)(*found).second;
 			  info.mMemory 		= mem;
 			  info.mType		= t.mType;
 			  info.mSize   		= t.mSize;
@@ -1146,11 +1394,216 @@ public:
 
 private:
 
+  class RecordCollector
+  {
+  public:
+	  RecordCollector(MyMemTracker &tracker,MemTrackVector &tracks) : mTracker(tracker), mTracks(tracks) { }
+	  void operator()(const AllocRecord &r)
+	  {
+		  MemTrack t;
+		  mTracker.expandRecord(r,t);
+		  mTracks.push_back(t);
+	  }
+  private:
+	  RecordCollector& operator=(const RecordCollector&);
+	  MyMemTracker   &mTracker;
+	  MemTrackVector &mTracks;
+  };
+
+  ThreadBatch & getBatch(void)
+  {
+	  ThreadBatch *b = (ThreadBatch *)TlsGetValue(mTlsIndex);
+	  if ( b == NULL )
+	  {
+		  b = new ThreadBatch;
+		  TlsSetValue(mTlsIndex,b);
+		  TrackerMutex::ScopedLock lock(mMutex);
+		  b->mNext = mBatches;
+		  mBatches = b;
+	  }
+	  return *b;
+  }
+
+  // Blocks from the same 64k region share a stripe, threads working in different heaps rarely do.
+  RecordStripe & getStripe(const void *mem)
+  {
+	  return mStripes[hashPointer((const void *)((size_t)mem >> 16)) & (STRIPE_COUNT-1)];
+  }
+
+  bool removeRecord(const void *mem,AllocRecord &r)
+  {
+	  RecordStripe &s = getStripe(mem);
+	  TrackerMutex::ScopedLock lock(s.mMutex);
+	  return s.remove((physx::PxU64)(size_t)mem,r);
+  }
+
+  bool findRecord(const void *mem,AllocRecord &r)
+  {
+	  RecordStripe &s = getStripe(mem);
+	  TrackerMutex::ScopedLock lock(s.mMutex);
+	  const AllocRecord *found = s.find((physx::PxU64)(size_t)mem);
+	  if ( found )
+	  {
+		  r = *found;
+	  }
+	  return found != NULL;
+  }
+
+  bool findTrack(const void *mem,MemTrack &t)
+  {
+	  AllocRecord r;
+	  bool found = findRecord(mem,r);
+	  if ( !found )
+	  {
+		  flushAll();
+		  found = findRecord(mem,r);
+	  }
+	  if ( found )
+	  {
+		  TrackerMutex::ScopedLock lock(mMutex);
+		  expandRecord(r,t);
+	  }
+	  return found;
+  }
+
+  // Caller holds mMutex.
+  void expandRecord(const AllocRecord &r,MemTrack &t)
+  {
+	  const AllocSite &site = mSites[r.mSite];
+	  t.mType       = site.mType;
+	  t.mSize       = (size_t)r.mSize;
+	  t.mThreadId   = r.mThreadId;
+	  t.mContext    = site.mContext;
+	  t.mClassName  = site.mClassName;
+	  t.mFileName   = site.mFileName;
+	  t.mLineNo     = site.mLineNo;
+	  t.mAllocCount = r.mAllocCount;
+	  t.mMemory     = (size_t)r.mAddress;
+  }
+
+  void flushAll(void)
+  {
+	  ThreadBatch *b;
+	  {
+		  TrackerMutex::ScopedLock lock(mMutex);
+		  b = mBatches;
+	  }
+	  // batches are only ever added at the head of the list, so walking it unlocked is safe.
+	  for (; b; b=b->mNext)
+	  {
+		  TrackerMutex::ScopedLock lock(b->mMutex);
+		  flushBatch(*b);
+	  }
+  }
+
+  // Publishes a batch.  Caller holds the batch's mutex; lock order is batch, then mMutex, then a stripe.
+  void flushBatch(ThreadBatch &b)
+  {
+	  AllocRecord records[BATCH_SIZE];
+	  void *memory[BATCH_SIZE];
+	  physx::PxU32 recordCount = 0;
+	  {
+		  TrackerMutex::ScopedLock lock(mMutex);
+		  for (physx::PxU32 i=0; i<b.mAllocCount; i++)
+		  {
+			  const PendingAlloc &p = b.mAllocs[i];
+			  physx::PxU32 site = mSites.intern(AllocSite(p.mContext,p.mClassName,p.mFileName,p.mLineNo,p.mType,INVALID_INDEX));
+			  if ( mSites[site].mSource == INVALID_INDEX )
+			  {
+				  mSites[site].mSource = mSources.intern(AllocSource(p.mFileName,p.mLineNo));
+			  }
+			  // track which allocation number this one was.
+			  physx::PxU32 allocCount = ++mSources[mSites[site].mSource].mCount;
+			  if ( b.mLive[i] == NULL )
+			  {
+				  continue;
+			  }
+			  AllocRecord &r = records[recordCount];
+			  memory[recordCount++] = p.mMemory;
+			  r.mAddress    = (physx::PxU64)(size_t)p.mMemory;
+			  r.mSize       = (physx::PxU64)p.mSize;
+			  r.mThreadId   = (physx::PxU32)p.mThreadId;
+			  r.mAllocCount = allocCount;
+			  r.mSite       = site;
+			  r.mPad        = 0;
+			  if ( mDetailed )
+			  {
+				logAlloc(p,allocCount);
+			  }
+		  }
+		  mAllocCount+=b.mFrameAllocCount;
+		  mAllocCount-=b.mFrameFreeCount;
+		  mAllocSize+=b.mFrameAllocSize;
+		  mAllocSize-=b.mFrameFreeSize;
+		  mAllocFrameCount+=b.mFrameAllocCount;
+		  mAllocFrameSize+=b.mFrameAllocSize;
+		  mFreeFrameCount+=b.mFrameFreeCount;
+		  mFreeFrameSize+=b.mFrameFreeSize;
+	  }
+	  b.clear();
+	  b.mFrameAllocCount = 0;
+	  b.mFrameAllocSize = 0;
+	  b.mFrameFreeCount = 0;
+	  b.mFrameFreeSize = 0;
+
+	  for (physx::PxU32 i=0; i<recordCount; i++)
+	  {
+		  RecordStripe &s = getStripe(memory[i]);
+		  AllocRecord previous;
+		  bool inserted;
+		  {
+			  TrackerMutex::ScopedLock lock(s.mMutex);
+			  inserted = s.insert(records[i],previous);
+		  }
+		  if ( !inserted )
+		  {
+			  PX_ALWAYS_ASSERT();
+			  TrackerMutex::ScopedLock lock(mMutex);
+			  printf("Prev: %s\r\n", mSites[previous.mSite].mClassName );
+		  }
+	  }
+  }
+
+  // Caller holds mMutex.
+  void logAlloc(const PendingAlloc &p,physx::PxU32 allocCount)
+  {
+	mDetailed->addColumnHex( (size_t)p.mMemory );
+	switch ( p.mType )
+	{
+	  case MT_NEW:
+		  mDetailed->addColumn("NEW");
+		  break;
+	  case MT_NEW_ARRAY:
+		  mDetailed->addColumn("NEW_ARRAY");
+		  break;
+	  case MT_MALLOC:
+		  mDetailed->addColumn("MALLOC");
+		  break;
+	  case MT_GLOBAL_NEW:
+		  mDetailed->addColumn("GLOBAL_NEW");
+		  break;
+	  case MT_GLOBAL_NEW_ARRAY:
+		  mDetailed->addColumn("GLOBAL_NEW_ARRAY");
+		  break;
+	  default:
+		  PX_ALWAYS_ASSERT();
+		  mDetailed->addColumn("ERROR");
+		  break;
+	}
+	mDetailed->addColumn((physx::PxU32)p.mSize);
+	mDetailed->addColumn(allocCount);
+	mDetailed->addColumnHex(p.mThreadId);
+	mDetailed->addColumn(p.mContext);
+	mDetailed->addColumn(p.mClassName);
+	mDetailed->addColumn(p.mFileName);
+	mDetailed->addColumn(p.mLineNo);
+	mDetailed->nextRow();
+  }
+
   bool           mLogEveryAllocation;
   bool           mLogEveryFrame;
 
   size_t         mFrameNo;
-  MemTrackHash  mMemory;
 
   size_t         mAllocFrameCount;
   size_t         mFreeFrameCount;
@@ -1165,8 +1618,13 @@ private:
   physx::HtmlTable    *mFrameSummary;
   physx::HtmlTable    *mDetailed;
   physx::HtmlDocument *mDocument;
-  BySourceHash           mSourceHash;
-  ByContextTypeHash		mContextType;
+
+  TrackerMutex        mMutex;		// sites, sources, totals and the report tables
+  AllocSiteTable      mSites;
+  AllocSourceTable    mSources;
+  RecordStripe        mStripes[STRIPE_COUNT];
+  ThreadBatch        *mBatches;
+  DWORD               mTlsIndex;
 
   std::string	mErrorMessage;
 };
@@ -1184,4 +1642,4 @@ void        releaseMemTracker(MemTracker *mt)
 }
 };
 
-#endif
\ No newline at end of file
+#endif
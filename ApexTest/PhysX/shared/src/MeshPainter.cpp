@@ -34,9 +34,18 @@
 
 #include <PxMat34Legacy.h>
 
+#include "WorkerPool.h"
+
 #include <algorithm>
 #include <assert.h>
 
+#if defined(PX_X86) || defined(PX_X64)
+#define SMOOTHING_SIMD 1
+#include <emmintrin.h>
+#else
+#define SMOOTHING_SIMD 0
+#endif
+
 namespace SharedTools
 {
 struct TetraFace
@@ -135,8 +144,113 @@ struct Edge
 	int faceNr;
 };
 
+struct TriangleCenterLess
+{
+	TriangleCenterLess(const physx::PxVec3* centers, int axis) : centers(centers), axis(axis) {}
+	bool operator()(physx::PxU32 a, physx::PxU32 b) const
+	{
+		return centers[a][axis] < centers[b][axis];
+	}
+	const physx::PxVec3* centers;
+	int axis;
+};
+
+static const physx::PxU32 BVH_LEAF_SIZE = 4;
+
+// smoothFloat runs on the worker threads for meshes with at least this many vertices
+static const physx::PxU32 SMOOTH_PARALLEL_THRESHOLD = 16384;
+static const physx::PxU32 SMOOTH_SLICES_PER_JOB = 256;
+
+// One Jacobi step of smoothFloat for the slices [firstSlice, lastSlice) of one channel. Every lane
+// adds its row in column order, so the sums are the same as in the former edge loop.
+static void smoothSlices(physx::PxU32 firstSlice, physx::PxU32 lastSlice, const physx::PxU32* sliceStart, const physx::PxU32* columns,
+                         const float* invLengths, float smoothingFactor, bool drain, const float* src, float* dst)
+{
+	const physx::PxU32 R = 4;
+#if SMOOTHING_SIMD
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 factor = _mm_set1_ps(smoothingFactor);
+	const __m128 notDrain = drain ? zero : _mm_castsi128_ps(_mm_set1_epi32(-1));
+	for (physx::PxU32 s = firstSlice; s < lastSlice; s++)
+	{
+		const __m128 own = _mm_loadu_ps(src + s * R);
+		// maxDistance < 0 is a drain, collisionFactor < 0 is not!
+		const __m128 ownPositive = _mm_or_ps(_mm_cmpgt_ps(own, zero), notDrain);
+		const __m128 ownActive = _mm_cmpge_ps(own, zero);
+		__m128 value = own;
+		__m128 weight = one;
+		for (physx::PxU32 k = sliceStart[s]; k < sliceStart[s + 1]; k++)
+		{
+			const physx::PxU32* c = columns + k * R;
+			const __m128 other = _mm_setr_ps(src[c[0]], src[c[1]], src[c[2]], src[c[3]]);
+			const __m128 f = _mm_mul_ps(_mm_loadu_ps(invLengths + k * R), factor);
+			const __m128 otherPositive = _mm_or_ps(_mm_cmpgt_ps(other, zero), notDrain);
+			const __m128 mask = _mm_and_ps(_mm_and_ps(ownPositive, otherPositive), ownActive);
+			value = _mm_add_ps(value, _mm_and_ps(mask, _mm_mul_ps(other, f)));
+			weight = _mm_add_ps(weight, _mm_and_ps(mask, f));
+		}
+		const __m128 valid = _mm_cmpgt_ps(weight, zero);
+		const __m128 result = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(value, weight)), _mm_andnot_ps(valid, own));
+		_mm_storeu_ps(dst + s * R, result);
+	}
+#else
+	for (physx::PxU32 s = firstSlice; s < lastSlice; s++)
+	{
+		for (physx::PxU32 r = 0; r < R; r++)
+		{
+			const float own = src[s * R + r];
+			float value = own;
+			float weight = 1.0f;
+			for (physx::PxU32 k = sliceStart[s]; k < sliceStart[s + 1]; k++)
+			{
+				const float other = src[columns[k * R + r]];
+				const float f = invLengths[k * R + r] * smoothingFactor;
+				// maxDistance < 0 is a drain, collisionFactor < 0 is not!
+				if ((!drain || (own > 0.0f && other > 0.0f)) && own >= 0.0f)
+				{
+					value += other * f;
+					weight += f;
+				}
+			}
+			dst[s * R + r] = weight > 0.0f ? value / weight : own;
+		}
+	}
+#endif
+}
+
+class SmoothingJob : public Samples::WorkerPool::Job
+{
+public:
+	SmoothingJob() : numSlices(0), numChannels(0) {}
+
+	virtual void execute(physx::PxU32 item)
+	{
+		const physx::PxU32 firstSlice = item * SMOOTH_SLICES_PER_JOB;
+		const physx::PxU32 lastSlice = physx::PxMin(firstSlice + SMOOTH_SLICES_PER_JOB, numSlices);
+		for (physx::PxU32 c = 0; c < numChannels; c++)
+		{
+			smoothSlices(firstSlice, lastSlice, sliceStart, columns, invLengths, smoothingFactor, drain[c], src[c], dst[c]);
+		}
+	}
+
+	enum { MAX_CHANNELS = 8 };
+
+	physx::PxU32 numSlices;
+	const physx::PxU32* sliceStart;
+	const physx::PxU32* columns;
+	const float* invLengths;
+	float smoothingFactor;
+
+	physx::PxU32 numChannels;
+	bool drain[MAX_CHANNELS];
+	const float* src[MAX_CHANNELS];
+	float* dst[MAX_CHANNELS];
+};
+
 
-MeshPainter::MeshPainter()
+MeshPainter::MeshPainter() :
+	mWorkers(NULL)
 {
 	clear();
 }
@@ -146,6 +260,11 @@ MeshPainter::MeshPainter()
 MeshPainter::~MeshPainter()
 {
 	clear();
+
+	if (mWorkers != NULL)
+	{
+		Samples::WorkerPool::release(mWorkers);
+	}
 }
 
 
@@ -161,6 +280,19 @@ void MeshPainter::clear()
 	mNormals.clear();
 	mTetraNormals.clear();
 	mCollectedTriangles.clear();
+	mTriangleCenters.clear();
+	mTriangleNormals.clear();
+	mTriangleInRange.clear();
+	mBvhNodes.clear();
+	mBvhTriangles.clear();
+	mUnreferencedVertices.clear();
+	mVertexMarks.clear();
+	mVertexSlots.clear();
+	mSmoothSliceStart.clear();
+	mSmoothColumns.clear();
+	mSmoothInvLengths.clear();
+	mSmoothingMatrixValid = false;
+	mSmoothChannels.clear();
 
 	for (int i = 0; i < (int)mFloatBuffers.size(); i++)
 	{
@@ -230,6 +362,8 @@ PaintFlagBuffer& MeshPainter::getInternalFlagBuffer(unsigned int id)
 void MeshPainter::clearIndexBufferRange()
 {
 	mIndexRanges.clear();
+	mTriangleInRange.assign(mIndices.size() / 3, false);
+	mSmoothingMatrixValid = false;
 }
 
 
@@ -255,6 +389,13 @@ void MeshPainter::addIndexBufferRange(physx::PxU32 start, physx::PxU32 end)
 
 	mIndexRanges.push_back(range);
 
+	mTriangleInRange.resize(mIndices.size() / 3, false);
+	for (physx::PxU32 i = start; i < end; i += 3)
+	{
+		mTriangleInRange[i / 3] = true;
+	}
+	mSmoothingMatrixValid = false;
+
 	for (physx::PxU32 i = 0; i < mVertices.size(); i++)
 	{
 		mVerticesDisabled[i] = true;
@@ -420,12 +561,32 @@ void MeshPainter::initFrom(const physx::PxVec3* vertices, int numVertices, int v
 
 
 
+void MeshPainter::updateVertices(const physx::PxVec3* vertices, int vertexStride)
+{
+	const physx::PxU8* p = (physx::PxU8*)vertices;
+	for (physx::PxU32 i = 0; i < mVertices.size(); i++, p += vertexStride)
+	{
+		mVertices[i] = *((physx::PxVec3*)p);
+	}
+
+	computeNormals();
+	computeTriangleInfo();
+	refitBvh();
+	mSmoothingMatrixValid = false;
+}
+
+
+
 void MeshPainter::complete()
 {
 	computeNormals();
 	createNeighborInfo();
 	mTriMarks.resize(mIndices.size() / 3, 0);
+	mVertexMarks.resize(mVertices.size(), 0);
+	mVertexSlots.resize(mVertices.size(), 0);
 	computeSiblingInfo(0.0f);
+	computeTriangleInfo();
+	buildBvh();
 }
 
 
@@ -501,19 +662,63 @@ bool MeshPainter::rayCast(int& triNr, float& t) const
 	mLastRaycastNormal = physx::PxVec3(0.0f);
 	mLastRaycastPos = physx::PxVec3(0.0f);
 
-	if (mRayDir.isZero())
+	if (mRayDir.isZero() || mBvhNodes.empty())
 	{
 		return false;
 	}
 
-	for (physx::PxU32 r = 0; r < mIndexRanges.size(); r++)
+	// hits behind the origin count as well, so the slabs are intersected with the whole line
+	physx::PxVec3 invDir;
+	for (int i = 0; i < 3; i++)
+	{
+		invDir[i] = mRayDir[i] != 0.0f ? 1.0f / mRayDir[i] : PX_MAX_F32;
+	}
+
+	mBvhStack.clear();
+	mBvhStack.push_back(0);
+	while (!mBvhStack.empty())
 	{
-		const IndexBufferRange range = mIndexRanges[r];
-		for (physx::PxU32 i = range.start; i < range.end; i += 3)
+		const BvhNode& node = mBvhNodes[mBvhStack.back()];
+		mBvhStack.pop_back();
+
+		float tNear = -PX_MAX_F32;
+		float tFar = t;
+		for (int i = 0; i < 3; i++)
+		{
+			float t0 = (node.bounds.minimum[i] - mRayOrig[i]) * invDir[i];
+			float t1 = (node.bounds.maximum[i] - mRayOrig[i]) * invDir[i];
+			if (t0 > t1)
+			{
+				const float tmp = t0;
+				t0 = t1;
+				t1 = tmp;
+			}
+			tNear = physx::PxMax(tNear, t0);
+			tFar = physx::PxMin(tFar, t1);
+		}
+		if (tNear > tFar)
+		{
+			continue;
+		}
+
+		if (node.count == 0)
 		{
-			const physx::PxVec3& p0 = mVertices[mIndices[i]];
-			const physx::PxVec3& p1 = mVertices[mIndices[i + 1]];
-			const physx::PxVec3& p2 = mVertices[mIndices[i + 2]];
+			mBvhStack.push_back(node.start);
+			mBvhStack.push_back(node.start + 1);
+			continue;
+		}
+
+		for (physx::PxU32 k = node.start; k < node.start + node.count; k++)
+		{
+			const physx::PxU32 tri = mBvhTriangles[k];
+			if (!mTriangleInRange[tri])
+			{
+				continue;
+			}
+
+			const physx::PxVec3& p0 = mVertices[mIndices[3 * tri]];
+			const physx::PxVec3& p1 = mVertices[mIndices[3 * tri + 1]];
+			const physx::PxVec3& p2 = mVertices[mIndices[3 * tri + 2]];
 			float triT, u, v;
 
 			bool hit = rayTriangleIntersection(mRayOrig, mRayDir, p0, p1, p2, triT, u, v);
@@ -524,7 +729,7 @@ bool MeshPainter::rayCast(int& triNr, float& t) const
 			if (triT < t)
 			{
 				t = triT;
-				triNr = i / 3;
+				triNr = (int)tri;
 				mLastRaycastNormal = (p1 - p0).cross(p2 - p0);
 				mLastRaycastPos = mRayOrig + mRayDir * t;
 			}
@@ -585,24 +790,124 @@ bool MeshPainter::rayTriangleIntersection(const physx::PxVec3& orig, const physx
 
 
 
-physx::PxVec3 MeshPainter::getTriangleCenter(int triNr) const
+void MeshPainter::computeTriangleInfo()
+{
+	const physx::PxU32 numTriangles = (physx::PxU32)mIndices.size() / 3;
+	mTriangleCenters.resize(numTriangles);
+	mTriangleNormals.resize(numTriangles);
+
+	for (physx::PxU32 i = 0; i < numTriangles; i++)
+	{
+		const physx::PxVec3& p0 = mVertices[mIndices[3 * i + 0]];
+		const physx::PxVec3& p1 = mVertices[mIndices[3 * i + 1]];
+		const physx::PxVec3& p2 = mVertices[mIndices[3 * i + 2]];
+		mTriangleCenters[i] = (p0 + p1 + p2) / 3.0f;
+		mTriangleNormals[i] = (p1 - p0).cross(p2 - p0);
+		mTriangleNormals[i].normalize();
+	}
+}
+
+
+
+void MeshPainter::buildBvh()
 {
-	const physx::PxVec3& p0 = mVertices[mIndices[3 * triNr + 0]];
-	const physx::PxVec3& p1 = mVertices[mIndices[3 * triNr + 1]];
-	const physx::PxVec3& p2 = mVertices[mIndices[3 * triNr + 2]];
-	return (p0 + p1 + p2) / 3.0f;
+	const physx::PxU32 numTriangles = (physx::PxU32)mIndices.size() / 3;
+
+	std::vector<bool> referenced(mVertices.size(), false);
+	for (physx::PxU32 i = 0; i < 3 * numTriangles; i++)
+	{
+		referenced[mIndices[i]] = true;
+	}
+	mUnreferencedVertices.clear();
+	for (physx::PxU32 i = 0; i < mVertices.size(); i++)
+	{
+		if (!referenced[i])
+		{
+			mUnreferencedVertices.push_back(i);
+		}
+	}
+
+	mBvhNodes.clear();
+	mBvhTriangles.resize(numTriangles);
+	if (numTriangles == 0)
+	{
+		return;
+	}
+
+	for (physx::PxU32 i = 0; i < numTriangles; i++)
+	{
+		mBvhTriangles[i] = i;
+	}
+
+	// median split along the largest extent of the triangle centers
+	BvhNode root;
+	root.start = 0;
+	root.count = numTriangles;
+	mBvhNodes.reserve(2 * (numTriangles / BVH_LEAF_SIZE) + 1);
+	mBvhNodes.push_back(root);
+
+	for (physx::PxU32 n = 0; n < mBvhNodes.size(); n++)
+	{
+		const physx::PxU32 start = mBvhNodes[n].start;
+		const physx::PxU32 count = mBvhNodes[n].count;
+		if (count <= BVH_LEAF_SIZE)
+		{
+			continue;
+		}
+
+		physx::PxBounds3 centerBounds;
+		centerBounds.setEmpty();
+		for (physx::PxU32 i = start; i < start + count; i++)
+		{
+			centerBounds.include(mTriangleCenters[mBvhTriangles[i]]);
+		}
+		const physx::PxVec3 extents = centerBounds.getExtents();
+		const int axis = extents.x > extents.y && extents.x > extents.z ? 0 : (extents.y > extents.z ? 1 : 2);
+
+		const physx::PxU32 half = count / 2;
+		std::nth_element(mBvhTriangles.begin() + start, mBvhTriangles.begin() + start + half, mBvhTriangles.begin() + start + count,
+		                 TriangleCenterLess(&mTriangleCenters[0], axis));
+
+		BvhNode left, right;
+		left.start = start;
+		left.count = half;
+		right.start = start + half;
+		right.count = count - half;
+
+		mBvhNodes[n].start = (physx::PxU32)mBvhNodes.size();
+		mBvhNodes[n].count = 0;
+		mBvhNodes.push_back(left);
+		mBvhNodes.push_back(right);
+	}
+
+	refitBvh();
 }
 
 
 
-physx::PxVec3 MeshPainter::getTriangleNormal(int triNr) const
+void MeshPainter::refitBvh()
 {
-	const physx::PxVec3& p0 = mVertices[mIndices[3 * triNr + 0]];
-	const physx::PxVec3& p1 = mVertices[mIndices[3 * triNr + 1]];
-	const physx::PxVec3& p2 = mVertices[mIndices[3 * triNr + 2]];
-	physx::PxVec3 normal = (p1 - p0).cross(p2 - p0);
-	normal.normalize();
-	return normal;
+	// children come after their parents, so a backwards pass sees them first
+	for (physx::PxU32 n = (physx::PxU32)mBvhNodes.size(); n-- > 0;)
+	{
+		BvhNode& node = mBvhNodes[n];
+		if (node.count == 0)
+		{
+			node.bounds = mBvhNodes[node.start].bounds;
+			node.bounds.include(mBvhNodes[node.start + 1].bounds);
+		}
+		else
+		{
+			node.bounds.setEmpty();
+			for (physx::PxU32 i = node.start; i < node.start + node.count; i++)
+			{
+				const physx::PxU32 tri = mBvhTriangles[i];
+				node.bounds.include(mVertices[mIndices[3 * tri + 0]]);
+				node.bounds.include(mVertices[mIndices[3 * tri + 1]]);
+				node.bounds.include(mVertices[mIndices[3 * tri + 2]]);
+			}
+		}
+	}
 }
 
 
@@ -621,6 +926,9 @@ void MeshPainter::collectTriangles() const
 	//if (!rayCast(triNr, t))
 	//	return;
 
+	// stop at 90 degrees
+	const float angle = physx::PxCos(physx::degToRad(70.0f));
+
 	mCurrentMark++;
 	std::vector<DistTriPair> heap;
 
@@ -642,12 +950,12 @@ void MeshPainter::collectTriangles() const
 
 		mTriMarks[dt.triNr] = mCurrentMark;
 		mCollectedTriangles.push_back(dt);
-		physx::PxVec3 center = getTriangleCenter(dt.triNr);
+		const physx::PxVec3& center = mTriangleCenters[dt.triNr];
 
 		for (int i = 0; i < 3; i++)
 		{
 			int adjNr = mNeighbors[3 * dt.triNr + i];
-			if (!isValidRange(adjNr * 3))
+			if (adjNr < 0 || !mTriangleInRange[adjNr])
 			{
 				continue;
 			}
@@ -657,19 +965,14 @@ void MeshPainter::collectTriangles() const
 				continue;
 			}
 
-			physx::PxVec3 adjCenter = getTriangleCenter(adjNr);
 			DistTriPair adj;
-			adj.set(adjNr, dt.dist - (center - adjCenter).magnitude());	// heap sorts large -> small, we need the opposite
+			adj.set(adjNr, dt.dist - (center - mTriangleCenters[adjNr]).magnitude());	// heap sorts large -> small, we need the opposite
 			if (-adj.dist > mPaintRadius)
 			{
 				continue;
 			}
 
-			physx::PxVec3 adjNormal = getTriangleNormal(adjNr);
-
-			// stop at 90 degrees
-			const float angle = physx::PxCos(physx::degToRad(70.0f));
-			if (adjNormal.dot(mLastRaycastNormal) < angle)
+			if (mTriangleNormals[adjNr].dot(mLastRaycastNormal) < angle)
 			{
 				continue;
 			}
@@ -684,17 +987,107 @@ void MeshPainter::collectTriangles() const
 
 
 
-bool MeshPainter::isValidRange(int vertexNumber) const
+void MeshPainter::collectTriangleVertices() const
 {
-	for (physx::PxU32 r = 0; r < mIndexRanges.size(); r++)
+	// unique vertices of mCollectedTriangles in order of appearance, mSmoothingCollectedIndices
+	// maps every triangle corner to its slot in mCollectedVertices
+	mCurrentMark++;
+	mCollectedVertices.clear();
+	mSmoothingCollectedIndices.clear();
+	for (physx::PxU32 i = 0; i < mCollectedTriangles.size(); i++)
 	{
-		const IndexBufferRange& range = mIndexRanges[r];
-		if ((vertexNumber >= (physx::PxI32)range.start) && (vertexNumber < (physx::PxI32)range.end))
+		const DistTriPair& dt = mCollectedTriangles[i];
+		for (int j = 0; j < 3; j++)
 		{
-			return true;
+			const physx::PxU32 index = mIndices[3 * dt.triNr + j];
+			if (mVertexMarks[index] != mCurrentMark)
+			{
+				mVertexMarks[index] = mCurrentMark;
+				mVertexSlots[index] = (physx::PxU32)mCollectedVertices.size();
+				mCollectedVertices.push_back(index);
+			}
+			mSmoothingCollectedIndices.push_back(mVertexSlots[index]);
+		}
+	}
+}
+
+
+
+void MeshPainter::collectSphereVertices(const physx::PxVec3& center, float radius) const
+{
+	mCollectedVertices.clear();
+
+	// negative radius means flood all vertices
+	if (radius < 0.0f)
+	{
+		for (physx::PxU32 i = 0; i < mVertices.size(); i++)
+		{
+			if (!mVerticesDisabled[i])
+			{
+				mCollectedVertices.push_back(i);
+			}
+		}
+		return;
+	}
+
+	const float radius2 = radius * radius;
+
+	// the BVH only reaches vertices of triangles
+	for (physx::PxU32 i = 0; i < mUnreferencedVertices.size(); i++)
+	{
+		const physx::PxU32 index = mUnreferencedVertices[i];
+		if (!mVerticesDisabled[index] && (center - mVertices[index]).magnitudeSquared() <= radius2)
+		{
+			mCollectedVertices.push_back(index);
+		}
+	}
+
+	if (mBvhNodes.empty())
+	{
+		return;
+	}
+
+	mCurrentMark++;
+
+	mBvhStack.clear();
+	mBvhStack.push_back(0);
+	while (!mBvhStack.empty())
+	{
+		const BvhNode& node = mBvhNodes[mBvhStack.back()];
+		mBvhStack.pop_back();
+
+		const physx::PxVec3 closest = center.maximum(node.bounds.minimum).minimum(node.bounds.maximum);
+		if ((closest - center).magnitudeSquared() > radius2)
+		{
+			continue;
+		}
+
+		if (node.count == 0)
+		{
+			mBvhStack.push_back(node.start);
+			mBvhStack.push_back(node.start + 1);
+			continue;
+		}
+
+		for (physx::PxU32 k = node.start; k < node.start + node.count; k++)
+		{
+			const physx::PxU32 tri = mBvhTriangles[k];
+			for (int j = 0; j < 3; j++)
+			{
+				const physx::PxU32 index = mIndices[3 * tri + j];
+				if (mVertexMarks[index] == mCurrentMark)
+				{
+					continue;
+				}
+				mVertexMarks[index] = mCurrentMark;
+
+				if (!mVerticesDisabled[index] && (center - mVertices[index]).magnitudeSquared() <= radius2)
+				{
+					mCollectedVertices.push_back(index);
+				}
+			}
 		}
 	}
-	return false;
 }
 
 
@@ -770,16 +1163,11 @@ void MeshPainter::paintFloat(unsigned int id, float min, float max, float target
 	{
 		// sphere painting
 		// also used for flooding, with a negative radius
-		const float paintRadius2 = mPaintRadius * mPaintRadius;
-		physx::PxVec3 origProj = mRayOrig - mRayDir * mRayDir.dot(mRayOrig);
+		collectSphereVertices(mLastRaycastPos, mPaintRadius);
 
-		const unsigned int numVertices = (unsigned int)mVertices.size();
-		for (unsigned int i = 0; i < numVertices; i++)
+		for (physx::PxU32 k = 0; k < mCollectedVertices.size(); k++)
 		{
-			if (mVerticesDisabled[i])
-			{
-				continue;
-			}
+			const physx::PxU32 i = mCollectedVertices[k];
 
 			// negative radius means flood all vertices
 			float dist2 = 0;
@@ -787,11 +1175,6 @@ void MeshPainter::paintFloat(unsigned int id, float min, float max, float target
 			{
 				// this is the sphere
 				dist2 = (mLastRaycastPos - mVertices[i]).magnitudeSquared();
-
-				if (dist2 > paintRadius2)
-				{
-					continue;
-				}
 			}
 
 			float relative = 1.0f - (physx::PxSqrt(dist2) / mPaintRadius);
@@ -804,7 +1187,7 @@ void MeshPainter::paintFloat(unsigned int id, float min, float max, float target
 
 			relative = physx::PxPow(relative, mFalloffExponent);
 
-			float& f = mFloatBuffers[bufferNr][i];
+			float& f = mFloatBuffers[bufferNr][(int)i];
 			f = physx::PxClamp(relative * target + (1.0f - relative) * f, min, max);
 		}
 	}
@@ -812,28 +1195,7 @@ void MeshPainter::paintFloat(unsigned int id, float min, float max, float target
 	{
 		// flat painting
 		collectTriangles();
-		mCollectedVertices.clear();
-		for (int i = 0; i < (int)mCollectedTriangles.size(); i++)
-		{
-			DistTriPair& dt = mCollectedTriangles[i];
-			for (int j = 0; j < 3; j++)
-			{
-				const physx::PxU32 index = mIndices[3 * dt.triNr + j];
-				bool found = false;
-				for (physx::PxU32 k = 0; k < mCollectedVertices.size(); k++)
-				{
-					if (mCollectedVertices[k] == index)
-					{
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					mCollectedVertices.push_back(index);
-				}
-			}
-		}
+		collectTriangleVertices();
 
 		for (physx::PxU32 i = 0; i < mCollectedVertices.size(); i++)
 		{
@@ -855,33 +1217,7 @@ void MeshPainter::paintFloat(unsigned int id, float min, float max, float target
 		// smooth painting
 		PX_ASSERT(mBrushMode == 2);
 		collectTriangles();
-
-		mSmoothingCollectedIndices.clear();
-
-		mCollectedVertices.clear();
-		for (int i = 0; i < (int)mCollectedTriangles.size(); i++)
-		{
-			DistTriPair& dt = mCollectedTriangles[i];
-			for (int j = 0; j < 3; j++)
-			{
-				const physx::PxU32 index = mIndices[3 * dt.triNr + j];
-				bool found = false;
-				for (physx::PxU32 k = 0; k < mCollectedVertices.size(); k++)
-				{
-					if (mCollectedVertices[k] == index)
-					{
-						mSmoothingCollectedIndices.push_back(k);
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					mSmoothingCollectedIndices.push_back((physx::PxU32)mCollectedVertices.size());
-					mCollectedVertices.push_back(index);
-				}
-			}
-		}
+		collectTriangleVertices();
 
 		if (mCollectedVerticesFloats.size() < mCollectedVertices.size() * 2)
 		{
@@ -970,30 +1306,12 @@ void MeshPainter::paintFlag(unsigned int id, unsigned int flag, bool useAND) con
 	if (mBrushMode == 1)
 	{
 		// sphere painting
-		const float paintRadius2 = mPaintRadius * mPaintRadius;
-		physx::PxVec3 origProj = mRayOrig - mRayDir * mRayDir.dot(mRayOrig);
+		// negative radius means flood  all vertices
+		collectSphereVertices(mLastRaycastPos, mPaintRadius);
 
-		for (size_t i = 0; i < mVertices.size(); i++)
+		for (size_t k = 0; k < mCollectedVertices.size(); k++)
 		{
-			if (mVerticesDisabled[i])
-			{
-				continue;
-			}
-
-			// negative radius means flood  all vertices
-			float dist2 = 0;
-			if (mPaintRadius >= 0.0f)
-			{
-				// this is the sphere
-				dist2 = (mLastRaycastPos - mVertices[i]).magnitudeSquared();
-
-				if (dist2 > paintRadius2)
-				{
-					continue;
-				}
-			}
-
-			unsigned int& u = mFlagBuffers[bufferNr][(int)i];
+			unsigned int& u = mFlagBuffers[bufferNr][(int)mCollectedVertices[k]];
 			if (useAND)
 			{
 				u &= flag;
@@ -1008,28 +1326,7 @@ void MeshPainter::paintFlag(unsigned int id, unsigned int flag, bool useAND) con
 	{
 		// flat painting
 		collectTriangles();
-		mCollectedVertices.clear();
-		for (int i = 0; i < (int)mCollectedTriangles.size(); i++)
-		{
-			DistTriPair& dt = mCollectedTriangles[i];
-			for (int j = 0; j < 3; j++)
-			{
-				const physx::PxU32 index = mIndices[3 * dt.triNr + j];
-				bool found = false;
-				for (size_t k = 0; k < mCollectedVertices.size(); k++)
-				{
-					if (mCollectedVertices[k] == index)
-					{
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					mCollectedVertices.push_back(index);
-				}
-			}
-		}
+		collectTriangleVertices();
 
 		const float paintRadius2 = mPaintRadius * mPaintRadius;
 
@@ -1056,21 +1353,8 @@ void MeshPainter::paintFlag(unsigned int id, unsigned int flag, bool useAND) con
 
 
 
-void MeshPainter::smoothFloat(physx::PxU32 id, float smoothingFactor, physx::PxU32 numIterations) const
+void MeshPainter::buildSmoothingMatrix() const
 {
-	int bufferNr = -1;
-	for (int i = 0; i < (int)mFloatBuffers.size(); i++)
-		if (mFloatBuffers[i].id == id)
-		{
-			bufferNr = i;
-		}
-
-	if (bufferNr < 0)
-	{
-		return;
-	}
-
-
 	struct Edge
 	{
 		Edge(physx::PxU32 _v1, physx::PxU32 _v2, float _l)
@@ -1118,76 +1402,193 @@ void MeshPainter::smoothFloat(physx::PxU32 id, float smoothingFactor, physx::PxU
 	}
 
 	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
 
-	const PaintFloatBuffer& buffer = mFloatBuffers[bufferNr];
+	// walking the sorted edges adds the neighbors of every row in increasing order
+	const physx::PxU32 numVerts = (physx::PxU32)mVertices.size();
+	std::vector<physx::PxU32> rowStart(numVerts + 1, 0);
+	for (physx::PxU32 i = 0; i < edges.size(); i++)
+	{
+		rowStart[edges[i].v1 + 1]++;
+		rowStart[edges[i].v2 + 1]++;
+	}
+	for (physx::PxU32 i = 0; i < numVerts; i++)
+	{
+		rowStart[i + 1] += rowStart[i];
+	}
 
-	std::vector<float> newValues(mVertices.size(), 0.0f);
-	std::vector<float> newWeights(mVertices.size(), 0.0f);
+	std::vector<physx::PxU32> columns(rowStart[numVerts]);
+	std::vector<float> invLengths(rowStart[numVerts]);
+	std::vector<physx::PxU32> fill(rowStart.begin(), rowStart.end() - 1);
+	for (physx::PxU32 i = 0; i < edges.size(); i++)
+	{
+		const Edge& e = edges[i];
+		columns[fill[e.v1]] = e.v2;
+		invLengths[fill[e.v1]++] = e.invLength;
+		columns[fill[e.v2]] = e.v1;
+		invLengths[fill[e.v2]++] = e.invLength;
+	}
 
-	for (physx::PxU32 iteration = 0; iteration < numIterations; iteration++)
+	// interleave SMOOTH_SLICE_ROWS rows, padding entries point to the row itself with zero weight
+	const physx::PxU32 R = SMOOTH_SLICE_ROWS;
+	const physx::PxU32 numSlices = (numVerts + R - 1) / R;
+	mSmoothSliceStart.resize(numSlices + 1);
+	mSmoothSliceStart[0] = 0;
+	for (physx::PxU32 s = 0; s < numSlices; s++)
 	{
-		for (physx::PxU32 i = 0; i < mVertices.size(); i++)
+		physx::PxU32 maxLength = 0;
+		for (physx::PxU32 r = s * R; r < physx::PxMin(s * R + R, numVerts); r++)
 		{
-			newValues[i] = buffer[i];
-			newWeights[i] = 1.0f;
+			maxLength = physx::PxMax(maxLength, rowStart[r + 1] - rowStart[r]);
 		}
+		mSmoothSliceStart[s + 1] = mSmoothSliceStart[s] + maxLength;
+	}
 
-		for (physx::PxU32 i = 0; i < edges.size(); i++)
+	mSmoothColumns.resize(mSmoothSliceStart[numSlices] * R);
+	mSmoothInvLengths.resize(mSmoothSliceStart[numSlices] * R);
+	for (physx::PxU32 s = 0; s < numSlices; s++)
+	{
+		for (physx::PxU32 r = 0; r < R; r++)
 		{
-			physx::PxU32 j = i;
-			while (j < edges.size() && edges[j] == edges[i])
+			const physx::PxU32 row = s * R + r;
+			const physx::PxU32 length = row < numVerts ? rowStart[row + 1] - rowStart[row] : 0;
+			for (physx::PxU32 k = 0; k < mSmoothSliceStart[s + 1] - mSmoothSliceStart[s]; k++)
 			{
-				i = j;
-				j++;
+				const physx::PxU32 entry = (mSmoothSliceStart[s] + k) * R + r;
+				mSmoothColumns[entry] = k < length ? columns[rowStart[row] + k] : row;
+				mSmoothInvLengths[entry] = k < length ? invLengths[rowStart[row] + k] : 0.0f;
 			}
+		}
+	}
 
-			// maxDistance < 0 is a drain, collisionFactor < 0 is not!
-			if (id != 1 || buffer[edges[i].v1] > 0.0f && buffer[edges[i].v2] > 0.0f)
-			{
-				const float factor = edges[i].invLength * smoothingFactor;
-				if (buffer[edges[i].v1] >= 0.0f)
-				{
-					newValues[edges[i].v1] += buffer[edges[i].v2] * factor;
-					newWeights[edges[i].v1] += factor;
-				}
+	mSmoothingMatrixValid = true;
+}
 
-				if (buffer[edges[i].v2] >= 0.0f)
-				{
-					newValues[edges[i].v2] += buffer[edges[i].v1] * factor;
-					newWeights[edges[i].v2] += factor;
-				}
-			}
-		}
 
-		for (physx::PxU32 i = 0; i < mVertices.size(); i++)
+
+void MeshPainter::smoothFloat(physx::PxU32 id, float smoothingFactor, physx::PxU32 numIterations) const
+{
+	smoothFloat(&id, 1, smoothingFactor, numIterations);
+}
+
+
+
+void MeshPainter::smoothFloat(const physx::PxU32* ids, physx::PxU32 numIds, float smoothingFactor, physx::PxU32 numIterations) const
+{
+	int bufferNrs[SmoothingJob::MAX_CHANNELS];
+	physx::PxU32 numChannels = 0;
+	for (physx::PxU32 c = 0; c < numIds && numChannels < SmoothingJob::MAX_CHANNELS; c++)
+	{
+		bufferNrs[numChannels] = -1;
+		for (int i = 0; i < (int)mFloatBuffers.size(); i++)
 		{
-			if (newWeights[i] > 0.0f)
+			if (mFloatBuffers[i].id == ids[c])
 			{
-				buffer[i] = newValues[i] / newWeights[i];
+				bufferNrs[numChannels] = i;
 			}
 		}
 
-		physx::PxU32 i = 0;
-		while (i < mSiblings.size())
+		if (bufferNrs[numChannels] >= 0)
 		{
-			float avg = 0.0f;
-			physx::PxU32 num = 0;
-			physx::PxU32 j = i;
-			while (mSiblings[j] >= 0)
+			numChannels++;
+		}
+	}
+
+	if (numChannels == 0)
+	{
+		return;
+	}
+
+	if (!mSmoothingMatrixValid)
+	{
+		buildSmoothingMatrix();
+	}
+
+	const physx::PxU32 numVerts = (physx::PxU32)mVertices.size();
+	const physx::PxU32 numSlices = (physx::PxU32)mSmoothSliceStart.size() - 1;
+	const physx::PxU32 channelSize = numSlices * SMOOTH_SLICE_ROWS;
+
+	// two buffers per channel, the padding rows stay zero
+	mSmoothChannels.assign(numChannels * 2 * channelSize, 0.0f);
+
+	SmoothingJob job;
+	job.numSlices = numSlices;
+	job.sliceStart = &mSmoothSliceStart[0];
+	job.columns = mSmoothColumns.empty() ? NULL : &mSmoothColumns[0];
+	job.invLengths = mSmoothInvLengths.empty() ? NULL : &mSmoothInvLengths[0];
+	job.smoothingFactor = smoothingFactor;
+	job.numChannels = numChannels;
+	for (physx::PxU32 c = 0; c < numChannels; c++)
+	{
+		const PaintFloatBuffer& buffer = mFloatBuffers[bufferNrs[c]];
+		float* channel = &mSmoothChannels[c * 2 * channelSize];
+		for (physx::PxU32 i = 0; i < numVerts; i++)
+		{
+			channel[i] = buffer[i];
+		}
+		job.drain[c] = buffer.id == 1;
+		job.src[c] = channel;
+		job.dst[c] = channel + channelSize;
+	}
+
+	const physx::PxU32 numJobs = (numSlices + SMOOTH_SLICES_PER_JOB - 1) / SMOOTH_SLICES_PER_JOB;
+	if (numVerts >= SMOOTH_PARALLEL_THRESHOLD && mWorkers == NULL)
+	{
+		mWorkers = Samples::WorkerPool::acquire();
+	}
+
+	for (physx::PxU32 iteration = 0; iteration < numIterations; iteration++)
+	{
+		if (mWorkers != NULL && numVerts >= SMOOTH_PARALLEL_THRESHOLD)
+		{
+			mWorkers->run(job, numJobs);
+		}
+		else
+		{
+			for (physx::PxU32 i = 0; i < numJobs; i++)
 			{
-				avg += buffer[mSiblings[j]];
-				num++;
-				j++;
+				job.execute(i);
 			}
-			PX_ASSERT(num > 0);
-			avg /= num;
-			j = i;
-			while (mSiblings[j] >= 0)
+		}
+
+		for (physx::PxU32 c = 0; c < numChannels; c++)
+		{
+			float* channel = job.dst[c];
+			job.dst[c] = const_cast<float*>(job.src[c]);
+			job.src[c] = channel;
+
+			physx::PxU32 i = 0;
+			while (i < mSiblings.size())
 			{
-				buffer[mSiblings[j]] = avg;
-				j++;
+				float avg = 0.0f;
+				physx::PxU32 num = 0;
+				physx::PxU32 j = i;
+				while (mSiblings[j] >= 0)
+				{
+					avg += channel[mSiblings[j]];
+					num++;
+					j++;
+				}
+				PX_ASSERT(num > 0);
+				avg /= num;
+				j = i;
+				while (mSiblings[j] >= 0)
+				{
+					channel[mSiblings[j]] = avg;
+					j++;
+				}
+				i = j + 1;
 			}
-			i = j + 1;
+		}
+	}
+
+	for (physx::PxU32 c = 0; c < numChannels; c++)
+	{
+		const PaintFloatBuffer& buffer = mFloatBuffers[bufferNrs[c]];
+		const float* channel = job.src[c];
+		for (physx::PxU32 i = 0; i < numVerts; i++)
+		{
+			buffer[i] = channel[i];
 		}
 	}
 }
@@ -1210,6 +1611,19 @@ void MeshPainter::smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) c
 
 	const PaintFloatBuffer& buffer = mFloatBuffers[bufferNr];
 
+	// the triangles are averaged in place, in order, so only the strided buffer access is avoided
+	const physx::PxU32 numVerts = (physx::PxU32)mVertices.size();
+	if (numVerts == 0)
+	{
+		return;
+	}
+	mSmoothChannels.resize(numVerts);
+	float* values = &mSmoothChannels[0];
+	for (physx::PxU32 i = 0; i < numVerts; i++)
+	{
+		values[i] = buffer[i];
+	}
+
 	float min0 = PX_MAX_F32;
 	float max0 = -PX_MAX_F32;
 	for (physx::PxU32 r = 0; r < mIndexRanges.size(); r++)
@@ -1218,7 +1632,7 @@ void MeshPainter::smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) c
 		{
 			for (physx::PxU32 j = 0; j < 3; j++)
 			{
-				const float b = buffer[mIndices[i + j]];
+				const float b = values[mIndices[i + j]];
 				if (id != 0 || b >= 0.0f)
 				{
 					min0 = physx::PxMin(min0, b);
@@ -1244,18 +1658,18 @@ void MeshPainter::smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) c
 				{
 					if (id == 0)
 					{
-						avg += physx::PxMax(buffer[mIndices[i + j]], 0.01f);
+						avg += physx::PxMax(values[mIndices[i + j]], 0.01f);
 					}
 					else
 					{
-						avg += buffer[mIndices[i + j]];
+						avg += values[mIndices[i + j]];
 					}
 				}
 				avg /= 3.0f;
 
 				for (physx::PxU32 j = 0; j < 3; j++)
 				{
-					float& b = buffer[mIndices[i + j]];
+					float& b = values[mIndices[i + j]];
 
 					if (id != 0 || (b >= 0.0f && b < 0.95f * max0))
 					{
@@ -1272,7 +1686,7 @@ void MeshPainter::smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) c
 			physx::PxU32 j = i;
 			while (mSiblings[j] >= 0)
 			{
-				avg += buffer[mSiblings[j]];
+				avg += values[mSiblings[j]];
 				num++;
 				j++;
 			}
@@ -1281,13 +1695,18 @@ void MeshPainter::smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) c
 			j = i;
 			while (mSiblings[j] >= 0)
 			{
-				buffer[mSiblings[j]] = avg;
+				values[mSiblings[j]] = avg;
 				j++;
 			}
 			i = j + 1;
 		}
 	}
 
+	for (physx::PxU32 i = 0; i < numVerts; i++)
+	{
+		buffer[i] = values[i];
+	}
+
 	float min1 = PX_MAX_F32;
 	float max1 = -PX_MAX_F32;
 	for (physx::PxU32 r = 0; r < mIndexRanges.size(); r++)
@@ -1296,7 +1715,7 @@ void MeshPainter::smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) c
 		{
 			for (physx::PxU32 j = 0; j < 3; j++)
 			{
-				float b = buffer[mIndices[i + j]];
+				float b = values[mIndices[i + j]];
 				if (id != 0 || b >= 0.0f)
 				{
 					min1 = physx::PxMin(min1, b);
@@ -1321,8 +1740,8 @@ void MeshPainter::smoothFloatFast(physx::PxU32 id, physx::PxU32 numIterations) c
 	//			if (!marked[index])
 	//			{
 	//				marked[index] = true;
-	//				if (id != 0 || buffer[index] >= 0.0f)
-	//					buffer[index] = min0 + (buffer[index] - min1) * s;
+	//				if (id != 0 || values[index] >= 0.0f)
+	//					values[index] = min0 + (values[index] - min1) * s;
 	//			}
 	//		}
 	//	}
@@ -29,6 +29,7 @@
 
 #include "NxUserRenderVertexBuffer.h"
 #include "NxUserRenderIndexBuffer.h"
+#include "NxUserRenderIndexBufferDesc.h"
 #include "NxUserRenderBoneBuffer.h"
 #include "NxUserRenderInstanceBuffer.h"
 #include "NxUserRenderSpriteBuffer.h"
@@ -39,18 +40,310 @@
 #include "NxApexRenderContext.h"
 
 
+#include "WorkerPool.h"
+
+#include "PsAtomic.h"
+#include <PsTime.h>
+
 #include <assert.h>
+#include <string.h>
+
+
+// One buffer write that is applied to every child. Deferred writes own a packed copy of the data,
+// all children share it and the last one to apply it deletes it.
+class MultiClientWrite
+{
+public:
+	MultiClientWrite() : mRefCount(0) {}
+	virtual ~MultiClientWrite() {}
+
+	virtual void apply(size_t child) = 0;
+
+	void setRefCount(physx::PxI32 refCount)
+	{
+		mRefCount = refCount;
+	}
+
+	void release()
+	{
+		if (physx::shdfnd::atomicDecrement(&mRefCount) == 0)
+		{
+			delete this;
+		}
+	}
+
+private:
+	volatile physx::PxI32 mRefCount;
+};
+
+
+
+// Storage of a packed write, every semantic becomes a tightly packed array of count elements.
+// All sizes are reserved first so the storage is allocated once.
+class MultiClientPackBuffer
+{
+public:
+	MultiClientPackBuffer() : mSize(0), mUsed(0) {}
+
+	void reserve(physx::PxU32 elementSize, physx::PxU32 count)
+	{
+		mSize += (elementSize * count + 15) & ~15;
+	}
+
+	void allocate()
+	{
+		mStorage.resize(mSize);
+	}
+
+	const void* copy(const void* src, physx::PxU32 stride, physx::PxU32 elementSize, physx::PxU32 count)
+	{
+		char* dst = &mStorage[0] + mUsed;
+		mUsed += (elementSize * count + 15) & ~15;
+		assert(mUsed <= mSize);
+
+		if (stride == elementSize)
+		{
+			memcpy(dst, src, elementSize * count);
+		}
+		else
+		{
+			const char* s = reinterpret_cast<const char*>(src);
+			for (physx::PxU32 i = 0; i < count; i++)
+			{
+				memcpy(dst + i * elementSize, s + i * stride, elementSize);
+			}
+		}
+		return dst;
+	}
+
+private:
+	std::vector<char> mStorage;
+	physx::PxU32 mSize;
+	physx::PxU32 mUsed;
+};
+
+
+
+static physx::PxU32 getElementSize(const physx::apex::NxApexRenderSemanticData& semantic)
+{
+	if (semantic.data == NULL)
+	{
+		return 0;
+	}
+	const physx::apex::NxRenderDataFormat::Enum format = semantic.srcFormat != physx::apex::NxRenderDataFormat::UNSPECIFIED ? semantic.srcFormat : semantic.format;
+	return physx::apex::NxRenderDataFormat::getFormatDataSize(format);
+}
+
+
+
+static void reserveSemantics(const physx::apex::NxApexRenderSemanticData* semantics, physx::PxU32 numSemantics, physx::PxU32 count, MultiClientPackBuffer& buffer)
+{
+	for (physx::PxU32 i = 0; i < numSemantics; i++)
+	{
+		buffer.reserve(getElementSize(semantics[i]), count);
+	}
+}
+
+
+
+static void packSemantics(physx::apex::NxApexRenderSemanticData* semantics, physx::PxU32 numSemantics, physx::PxU32 count, MultiClientPackBuffer& buffer)
+{
+	for (physx::PxU32 i = 0; i < numSemantics; i++)
+	{
+		const physx::PxU32 elementSize = getElementSize(semantics[i]);
+		if (elementSize > 0)
+		{
+			semantics[i].data = buffer.copy(semantics[i].data, semantics[i].stride, elementSize, count);
+			semantics[i].stride = elementSize;
+		}
+	}
+}
+
+
+
+// only vertex and sprite writes carry module specific semantics
+static physx::apex::NxApexModuleSpecificRenderBufferData* getModuleData(physx::apex::NxApexRenderVertexBufferData& data)
+{
+	return &data;
+}
+
+static physx::apex::NxApexModuleSpecificRenderBufferData* getModuleData(physx::apex::NxApexRenderSpriteBufferData& data)
+{
+	return &data;
+}
+
+template<typename Data>
+static physx::apex::NxApexModuleSpecificRenderBufferData* getModuleData(Data&)
+{
+	return NULL;
+}
+
+
+
+template<typename T, typename Data>
+class MultiClientDataWrite : public MultiClientWrite
+{
+public:
+	MultiClientDataWrite(MultiClientBuffer<T>& target, const Data& data, physx::PxU32 first, physx::PxU32 count) :
+		mTarget(target), mData(&data), mFirst(first), mCount(count)
+	{
+	}
+
+	// copies the caller's data so the write can outlive the writeBuffer call
+	template<typename SemanticClass, typename SemanticEnum>
+	void pack(const physx::apex::NxApexRenderBufferData<SemanticClass, SemanticEnum>&)
+	{
+		mPacked = *mData;
+
+		physx::apex::NxApexRenderSemanticData base[SemanticClass::NUM_SEMANTICS];
+		for (physx::PxU32 i = 0; i < SemanticClass::NUM_SEMANTICS; i++)
+		{
+			base[i] = mPacked.getSemanticData(SemanticEnum(i));
+		}
+
+		if (mPacked.getNumCustomSemantics() > 0)
+		{
+			mCustom.assign(&mPacked.getCustomSemanticData(0), &mPacked.getCustomSemanticData(0) + mPacked.getNumCustomSemantics());
+		}
+
+		physx::apex::NxApexModuleSpecificRenderBufferData* moduleData = getModuleData(mPacked);
+		if (moduleData != NULL && moduleData->numModuleSpecificSemantics > 0)
+		{
+			mModule.assign(moduleData->moduleSpecificSemanticData, moduleData->moduleSpecificSemanticData + moduleData->numModuleSpecificSemantics);
+		}
+
+		reserveSemantics(base, SemanticClass::NUM_SEMANTICS, mCount, mStorage);
+		reserveSemantics(mCustom.empty() ? NULL : &mCustom[0], (physx::PxU32)mCustom.size(), mCount, mStorage);
+		reserveSemantics(mModule.empty() ? NULL : &mModule[0], (physx::PxU32)mModule.size(), mCount, mStorage);
+		mStorage.allocate();
+
+		packSemantics(base, SemanticClass::NUM_SEMANTICS, mCount, mStorage);
+		packSemantics(mCustom.empty() ? NULL : &mCustom[0], (physx::PxU32)mCustom.size(), mCount, mStorage);
+		packSemantics(mModule.empty() ? NULL : &mModule[0], (physx::PxU32)mModule.size(), mCount, mStorage);
+
+		for (physx::PxU32 i = 0; i < SemanticClass::NUM_SEMANTICS; i++)
+		{
+			if (base[i].data != NULL)
+			{
+				mPacked.setSemanticData(SemanticEnum(i), base[i].data, base[i].stride, base[i].format, base[i].srcFormat);
+			}
+		}
+		mPacked.setCustomSemanticData(mCustom.empty() ? NULL : &mCustom[0], (physx::PxU32)mCustom.size());
+		if (moduleData != NULL)
+		{
+			moduleData->moduleSpecificSemanticData = mModule.empty() ? NULL : &mModule[0];
+		}
+
+		mData = &mPacked;
+	}
+
+	virtual void apply(size_t child)
+	{
+		// buffers created before a client was added have no child for it
+		T* buffer = child < mTarget.getNumChildren() ? mTarget.getChild(child) : NULL;
+		if (buffer != NULL)
+		{
+			buffer->writeBuffer(*mData, mFirst, mCount);
+		}
+	}
+
+protected:
+	MultiClientBuffer<T>& mTarget;
+	const Data* mData;
+	physx::PxU32 mFirst;
+	physx::PxU32 mCount;
+
+	Data mPacked;
+	std::vector<physx::apex::NxApexRenderSemanticData> mCustom;
+	std::vector<physx::apex::NxApexRenderSemanticData> mModule;
+	MultiClientPackBuffer mStorage;
+};
+
+
+
+class MultiClientIndexWrite : public MultiClientWrite
+{
+public:
+	MultiClientIndexWrite(MultiClientBuffer<physx::apex::NxUserRenderIndexBuffer>& target, const void* data, physx::PxU32 stride, physx::PxU32 first, physx::PxU32 count) :
+		mTarget(target), mData(data), mStride(stride), mFirst(first), mCount(count)
+	{
+	}
+
+	void pack(physx::PxU32 elementSize)
+	{
+		mStorage.reserve(elementSize, mCount);
+		mStorage.allocate();
+		mData = mStorage.copy(mData, mStride, elementSize, mCount);
+		mStride = elementSize;
+	}
+
+	virtual void apply(size_t child);
+
+protected:
+	MultiClientBuffer<physx::apex::NxUserRenderIndexBuffer>& mTarget;
+	const void* mData;
+	physx::PxU32 mStride;
+	physx::PxU32 mFirst;
+	physx::PxU32 mCount;
+
+	MultiClientPackBuffer mStorage;
+};
 
 
-MultiClientRenderResourceManager::MultiClientRenderResourceManager()
+
+// writes all children, one child per job item
+class MultiClientFanOutJob : public Samples::WorkerPool::Job
 {
+public:
+	MultiClientFanOutJob(MultiClientRenderResourceManager& manager, MultiClientWrite** writes, physx::PxU32 numWrites, bool release) :
+		mManager(manager), mWrites(writes), mNumWrites(numWrites), mRelease(release)
+	{
+	}
+
+	virtual void execute(physx::PxU32 child)
+	{
+		for (physx::PxU32 i = 0; i < mNumWrites; i++)
+		{
+			mManager.applyWrite(*mWrites[i], child);
+		}
+
+		if (mRelease)
+		{
+			for (physx::PxU32 i = 0; i < mNumWrites; i++)
+			{
+				mWrites[i]->release();
+			}
+		}
+	}
+
+private:
+	MultiClientFanOutJob& operator=(const MultiClientFanOutJob&);
+
+	MultiClientRenderResourceManager& mManager;
+	MultiClientWrite** mWrites;
+	physx::PxU32 mNumWrites;
+	bool mRelease;
+};
+
 
+
+MultiClientRenderResourceManager::MultiClientRenderResourceManager(WriteMode writeMode) : mWriteMode(WRITE_SYNCHRONOUS), mWorkerPool(NULL)
+{
+	setWriteMode(writeMode);
 }
 
 
 
 MultiClientRenderResourceManager::~MultiClientRenderResourceManager()
 {
+	flush();
+
+	if (mWorkerPool != NULL)
+	{
+		Samples::WorkerPool::release(mWorkerPool);
+		mWorkerPool = NULL;
+	}
+
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
 		if (mChildren[i].destroyRrm)
@@ -73,16 +366,127 @@ void MultiClientRenderResourceManager::addChild(physx::apex::NxUserRenderResourc
 		}
 	}
 
+	// pending writes are counted for the current children
+	flush();
+
 	mChildren.push_back(Child(rrm, destroyAutomatic));
 }
 
 
 
+void MultiClientRenderResourceManager::setWriteMode(WriteMode writeMode)
+{
+	flush();
+
+	mWriteMode = writeMode;
+
+	if (mWriteMode != WRITE_SYNCHRONOUS && mWorkerPool == NULL)
+	{
+		mWorkerPool = Samples::WorkerPool::acquire();
+	}
+}
+
+
+
+void MultiClientRenderResourceManager::flush()
+{
+	std::vector<MultiClientWrite*> writes;
+	{
+		physx::shdfnd::Mutex::ScopedLock lock(mPendingMutex);
+		if (mPendingWrites.empty())
+		{
+			return;
+		}
+		writes.swap(mPendingWrites);
+	}
+
+	fanOut(&writes[0], (physx::PxU32)writes.size(), true);
+
+	// keep the capacity for the next frame
+	writes.clear();
+	physx::shdfnd::Mutex::ScopedLock lock(mPendingMutex);
+	if (mPendingWrites.empty())
+	{
+		mPendingWrites.swap(writes);
+	}
+}
+
+
+
+void MultiClientRenderResourceManager::resetChildStats()
+{
+	for (size_t i = 0; i < mChildren.size(); i++)
+	{
+		mChildren[i].stats.numWrites = 0;
+		mChildren[i].stats.writeSeconds = 0.0;
+		mChildren[i].stats.maxWriteSeconds = 0.0;
+	}
+}
+
+
+
+void MultiClientRenderResourceManager::submitWrite(MultiClientWrite& write)
+{
+	if (mWriteMode == WRITE_DEFERRED)
+	{
+		if (mChildren.empty())
+		{
+			delete &write;
+			return;
+		}
+
+		write.setRefCount((physx::PxI32)mChildren.size());
+
+		physx::shdfnd::Mutex::ScopedLock lock(mPendingMutex);
+		mPendingWrites.push_back(&write);
+		return;
+	}
+
+	MultiClientWrite* writes = &write;
+	fanOut(&writes, 1, false);
+}
+
+
+
+void MultiClientRenderResourceManager::applyWrite(MultiClientWrite& write, size_t child)
+{
+	physx::shdfnd::Time timer;
+	write.apply(child);
+	const double seconds = timer.getElapsedSeconds();
+
+	// only the thread handling this child touches its stats
+	ChildStats& stats = mChildren[child].stats;
+	stats.numWrites++;
+	stats.writeSeconds += seconds;
+	stats.maxWriteSeconds = std::max(stats.maxWriteSeconds, seconds);
+}
+
+
+
+void MultiClientRenderResourceManager::fanOut(MultiClientWrite** writes, physx::PxU32 numWrites, bool release)
+{
+	MultiClientFanOutJob job(*this, writes, numWrites, release);
+
+	if (mWriteMode != WRITE_SYNCHRONOUS && mWorkerPool != NULL && mChildren.size() > 1)
+	{
+		mWorkerPool->run(job, (physx::PxU32)mChildren.size());
+	}
+	else
+	{
+		for (size_t i = 0; i < mChildren.size(); i++)
+		{
+			job.execute((physx::PxU32)i);
+		}
+	}
+}
+
+
+
 template<typename T>
 class MultiClientBuffer
 {
 public:
-	MultiClientBuffer() {}
+	MultiClientBuffer(MultiClientRenderResourceManager& manager) : mManager(manager) {}
 	~MultiClientBuffer() {}
 
 
@@ -97,7 +501,40 @@ public:
 		return mChildren[index];
 	}
 
+	size_t getNumChildren() const
+	{
+		return mChildren.size();
+	}
+
 protected:
+	// the write only references the caller's data unless it is deferred
+	template<typename Data>
+	void submitData(const Data& data, physx::PxU32 first, physx::PxU32 count)
+	{
+		if (isDeferred())
+		{
+			MultiClientDataWrite<T, Data>* write = new MultiClientDataWrite<T, Data>(*this, data, first, count);
+			write->pack(data);
+			submit(*write);
+		}
+		else
+		{
+			MultiClientDataWrite<T, Data> write(*this, data, first, count);
+			submit(write);
+		}
+	}
+
+	bool isDeferred() const
+	{
+		return mManager.mWriteMode == MultiClientRenderResourceManager::WRITE_DEFERRED;
+	}
+
+	void submit(MultiClientWrite& write)
+	{
+		mManager.submitWrite(write);
+	}
+
+	MultiClientRenderResourceManager& mManager;
 	std::vector<T*> mChildren;
 };
 
@@ -107,15 +544,12 @@ protected:
 class MultiClientVertexBuffer : public physx::apex::NxUserRenderVertexBuffer, public MultiClientBuffer<physx::apex::NxUserRenderVertexBuffer>
 {
 public:
-	MultiClientVertexBuffer() {}
+	MultiClientVertexBuffer(MultiClientRenderResourceManager& manager) : MultiClientBuffer<physx::apex::NxUserRenderVertexBuffer>(manager) {}
 	~MultiClientVertexBuffer() {}
 
 	virtual void writeBuffer(const physx::apex::NxApexRenderVertexBufferData& data, unsigned int firstVertex, unsigned int numVertices)
 	{
-		for (size_t i = 0; i < mChildren.size(); i++)
-		{
-			mChildren[i]->writeBuffer(data, firstVertex, numVertices);
-		}
+		submitData(data, firstVertex, numVertices);
 	}
 
 };
@@ -123,7 +557,7 @@ public:
 
 physx::apex::NxUserRenderVertexBuffer* MultiClientRenderResourceManager::createVertexBuffer(const physx::apex::NxUserRenderVertexBufferDesc& desc)
 {
-	MultiClientVertexBuffer* vb = new MultiClientVertexBuffer();
+	MultiClientVertexBuffer* vb = new MultiClientVertexBuffer(*this);
 
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
@@ -137,6 +571,8 @@ void MultiClientRenderResourceManager::releaseVertexBuffer(physx::apex::NxUserRe
 {
 	MultiClientVertexBuffer* vb = static_cast<MultiClientVertexBuffer*>(&buffer);
 
+	flush();
+
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
 		physx::apex::NxUserRenderVertexBuffer* childVb = vb->getChild(i);
@@ -154,22 +590,43 @@ void MultiClientRenderResourceManager::releaseVertexBuffer(physx::apex::NxUserRe
 class MultiClientIndexBuffer : public physx::apex::NxUserRenderIndexBuffer, public MultiClientBuffer<physx::apex::NxUserRenderIndexBuffer>
 {
 public:
-	MultiClientIndexBuffer() {}
+	MultiClientIndexBuffer(MultiClientRenderResourceManager& manager, physx::apex::NxRenderDataFormat::Enum format) : MultiClientBuffer<physx::apex::NxUserRenderIndexBuffer>(manager), mFormat(format) {}
 	~MultiClientIndexBuffer() {}
 
 	virtual void writeBuffer(const void* srcData, unsigned int srcStride, unsigned int firstDestElement, unsigned int numElements)
 	{
-		for (size_t i = 0; i < mChildren.size(); i++)
+		if (isDeferred())
 		{
-			mChildren[i]->writeBuffer(srcData, srcStride, firstDestElement, numElements);
+			MultiClientIndexWrite* write = new MultiClientIndexWrite(*this, srcData, srcStride, firstDestElement, numElements);
+			write->pack(physx::apex::NxRenderDataFormat::getFormatDataSize(mFormat));
+			submit(*write);
+		}
+		else
+		{
+			MultiClientIndexWrite write(*this, srcData, srcStride, firstDestElement, numElements);
+			submit(write);
 		}
 	}
+
+protected:
+	physx::apex::NxRenderDataFormat::Enum mFormat;
 };
 
 
+
+void MultiClientIndexWrite::apply(size_t child)
+{
+	physx::apex::NxUserRenderIndexBuffer* buffer = child < mTarget.getNumChildren() ? mTarget.getChild(child) : NULL;
+	if (buffer != NULL)
+	{
+		buffer->writeBuffer(mData, mStride, mFirst, mCount);
+	}
+}
+
+
 physx::apex::NxUserRenderIndexBuffer* MultiClientRenderResourceManager::createIndexBuffer(const physx::apex::NxUserRenderIndexBufferDesc& desc)
 {
-	MultiClientIndexBuffer* ib = new MultiClientIndexBuffer();
+	MultiClientIndexBuffer* ib = new MultiClientIndexBuffer(*this, desc.format);
 
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
@@ -183,6 +640,8 @@ void MultiClientRenderResourceManager::releaseIndexBuffer(physx::apex::NxUserRen
 {
 	MultiClientIndexBuffer* ib = static_cast<MultiClientIndexBuffer*>(&buffer);
 
+	flush();
+
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
 		physx::apex::NxUserRenderIndexBuffer* childIb = ib->getChild(i);
@@ -202,15 +661,12 @@ void MultiClientRenderResourceManager::releaseIndexBuffer(physx::apex::NxUserRen
 class MultiClientBoneBuffer : public physx::apex::NxUserRenderBoneBuffer, public MultiClientBuffer<physx::apex::NxUserRenderBoneBuffer>
 {
 public:
-	MultiClientBoneBuffer() {}
+	MultiClientBoneBuffer(MultiClientRenderResourceManager& manager) : MultiClientBuffer<physx::apex::NxUserRenderBoneBuffer>(manager) {}
 	~MultiClientBoneBuffer() {}
 
 	virtual void writeBuffer(const physx::apex::NxApexRenderBoneBufferData& data, unsigned int firstBone, unsigned int numBones)
 	{
-		for (size_t i = 0; i < mChildren.size(); i++)
-		{
-			mChildren[i]->writeBuffer(data, firstBone, numBones);
-		}
+		submitData(data, firstBone, numBones);
 	}
 };
 
@@ -218,7 +674,7 @@ public:
 
 physx::apex::NxUserRenderBoneBuffer* MultiClientRenderResourceManager::createBoneBuffer(const physx::apex::NxUserRenderBoneBufferDesc& desc)
 {
-	MultiClientBoneBuffer* bb = new MultiClientBoneBuffer();
+	MultiClientBoneBuffer* bb = new MultiClientBoneBuffer(*this);
 
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
@@ -234,6 +690,8 @@ void MultiClientRenderResourceManager::releaseBoneBuffer(physx::apex::NxUserRend
 {
 	MultiClientBoneBuffer* bb = static_cast<MultiClientBoneBuffer*>(&buffer);
 
+	flush();
+
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
 		physx::apex::NxUserRenderBoneBuffer* childBb = bb->getChild(i);
@@ -250,15 +708,12 @@ void MultiClientRenderResourceManager::releaseBoneBuffer(physx::apex::NxUserRend
 class MultiClientInstanceBuffer : public physx::apex::NxUserRenderInstanceBuffer, public MultiClientBuffer<physx::apex::NxUserRenderInstanceBuffer>
 {
 public:
-	MultiClientInstanceBuffer() {}
+	MultiClientInstanceBuffer(MultiClientRenderResourceManager& manager) : MultiClientBuffer<physx::apex::NxUserRenderInstanceBuffer>(manager) {}
 	~MultiClientInstanceBuffer() {}
 
 	virtual void writeBuffer(const physx::apex::NxApexRenderInstanceBufferData& data, unsigned int firstInstance, unsigned int numInstances)
 	{
-		for (size_t i = 0; i < mChildren.size(); i++)
-		{
-			mChildren[i]->writeBuffer(data, firstInstance, numInstances);
-		}
+		submitData(data, firstInstance, numInstances);
 	}
 };
 
@@ -267,7 +722,7 @@ public:
 
 physx::apex::NxUserRenderInstanceBuffer* MultiClientRenderResourceManager::createInstanceBuffer(const physx::apex::NxUserRenderInstanceBufferDesc& desc)
 {
-	MultiClientInstanceBuffer* ib = new MultiClientInstanceBuffer();
+	MultiClientInstanceBuffer* ib = new MultiClientInstanceBuffer(*this);
 
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
@@ -283,6 +738,8 @@ void MultiClientRenderResourceManager::releaseInstanceBuffer(physx::apex::NxUser
 {
 	MultiClientInstanceBuffer* ib = static_cast<MultiClientInstanceBuffer*>(&buffer);
 
+	flush();
+
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
 		physx::apex::NxUserRenderInstanceBuffer* childIb = ib->getChild(i);
@@ -299,15 +756,12 @@ void MultiClientRenderResourceManager::releaseInstanceBuffer(physx::apex::NxUser
 class MultiClientSpriteBuffer : public physx::apex::NxUserRenderSpriteBuffer, public MultiClientBuffer<physx::apex::NxUserRenderSpriteBuffer>
 {
 public:
-	MultiClientSpriteBuffer() {}
+	MultiClientSpriteBuffer(MultiClientRenderResourceManager& manager) : MultiClientBuffer<physx::apex::NxUserRenderSpriteBuffer>(manager) {}
 	~MultiClientSpriteBuffer() {}
 
 	virtual void writeBuffer(const physx::apex::NxApexRenderSpriteBufferData& data, unsigned int firstSprite, unsigned int numSprites)
 	{
-		for (size_t i = 0; i < mChildren.size(); i++)
-		{
-			mChildren[i]->writeBuffer(data, firstSprite, numSprites);
-		}
+		submitData(data, firstSprite, numSprites);
 	}
 };
 
@@ -315,7 +769,7 @@ public:
 
 physx::apex::NxUserRenderSpriteBuffer* MultiClientRenderResourceManager::createSpriteBuffer(const physx::apex::NxUserRenderSpriteBufferDesc& desc)
 {
-	MultiClientSpriteBuffer* sb = new MultiClientSpriteBuffer();
+	MultiClientSpriteBuffer* sb = new MultiClientSpriteBuffer(*this);
 
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
@@ -331,6 +785,8 @@ void MultiClientRenderResourceManager::releaseSpriteBuffer(physx::apex::NxUserRe
 {
 	MultiClientSpriteBuffer* sb = static_cast<MultiClientSpriteBuffer*>(&buffer);
 
+	flush();
+
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
 		physx::apex::NxUserRenderSpriteBuffer* childSb = sb->getChild(i);
@@ -352,7 +808,7 @@ void MultiClientRenderResourceManager::releaseSpriteBuffer(physx::apex::NxUserRe
 class MultiClientRenderResource : public physx::apex::NxUserRenderResource
 {
 public:
-	MultiClientRenderResource(const physx::apex::NxUserRenderResourceDesc& desc) : mDescriptor(desc)
+	MultiClientRenderResource(const physx::apex::NxUserRenderResourceDesc& desc, MultiClientRenderResourceManager& manager) : mDescriptor(desc), mManager(manager)
 	{
 		assert(desc.numVertexBuffers > 0);
 
@@ -417,6 +873,11 @@ public:
 		return mChildren[index];
 	}
 
+	MultiClientRenderResourceManager& getManager()
+	{
+		return mManager;
+	}
+
 
 
 	void setVertexBufferRange(unsigned int firstVertex, unsigned int numVerts)
@@ -544,6 +1005,7 @@ protected:
 	std::vector<physx::apex::NxUserRenderResource*> mChildren;
 
 	physx::apex::NxUserRenderResourceDesc mDescriptor;
+	MultiClientRenderResourceManager& mManager;
 };
 
 
@@ -551,7 +1013,7 @@ protected:
 
 physx::apex::NxUserRenderResource* MultiClientRenderResourceManager::createResource(const physx::apex::NxUserRenderResourceDesc& desc)
 {
-	MultiClientRenderResource* rr = new MultiClientRenderResource(desc);
+	MultiClientRenderResource* rr = new MultiClientRenderResource(desc, *this);
 
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
@@ -606,6 +1068,9 @@ void MultiClientUserRenderer::renderResource(const physx::apex::NxApexRenderCont
 {
 	MultiClientRenderResource* rr = static_cast<MultiClientRenderResource*>(context.renderResource);
 
+	// the children must have seen all deferred writes before they draw
+	rr->getManager().flush();
+
 	for (size_t i = 0; i < mChildren.size(); i++)
 	{
 		physx::apex::NxApexRenderContext newContext(context);
@@ -28,6 +28,7 @@
 #include "RecordingRenderResourceManager.h"
 
 #include <assert.h>
+#include <string.h>
 #include <time.h>
 
 #include <vector>
@@ -39,9 +40,24 @@
 #include "NxUserRenderIndexBufferDesc.h"
 #include "NxUserRenderBoneBuffer.h"
 #include "NxUserRenderBoneBufferDesc.h"
+#include "NxUserRenderSpriteBuffer.h"
+#include "NxUserRenderSpriteBufferDesc.h"
 
 #include "NxApexRenderContext.h"
 
+#include "PsThread.h"
+#include "PsSync.h"
+#include <PsTime.h>
+
+// define to 1 and provide lz4.h and the lz4 library to compress the chunks of a BinaryRecorder
+#ifndef RECORDER_USE_LZ4
+#define RECORDER_USE_LZ4 0
+#endif
+
+#if RECORDER_USE_LZ4
+#include "lz4.h"
+#endif
+
 #define BREAK_ON_UNIMPLEMENTED 1
 
 #if BREAK_ON_UNIMPLEMENTED
@@ -55,7 +71,7 @@
 #include "windows.h"
 #endif
 
-RecordingRenderResourceManager::RecordingRenderResourceManager(physx::apex::NxUserRenderResourceManager* child, bool /*ownsChild*/, RecorderInterface* recorder) : mChild(child), mRecorder(recorder)
+RecordingRenderResourceManager::RecordingRenderResourceManager(physx::apex::NxUserRenderResourceManager* child, bool ownsChild, RecorderInterface* recorder) : mChild(child), mOwnsChild(ownsChild), mRecorder(recorder)
 {
 }
 
@@ -117,6 +133,11 @@ public:
 		return mChild;
 	}
 
+	unsigned int getId() const
+	{
+		return mBufferId;
+	}
+
 protected:
 	physx::apex::NxUserRenderVertexBufferDesc mDescriptor;
 	physx::apex::NxUserRenderVertexBuffer* mChild;
@@ -195,6 +216,11 @@ public:
 		return mChild;
 	}
 
+	unsigned int getId() const
+	{
+		return mBufferId;
+	}
+
 protected:
 	physx::apex::NxUserRenderIndexBufferDesc mDescriptor;
 	physx::apex::NxUserRenderIndexBuffer* mChild;
@@ -273,6 +299,11 @@ public:
 		return mChild;
 	}
 
+	unsigned int getId() const
+	{
+		return mBufferId;
+	}
+
 protected:
 	physx::apex::NxUserRenderBoneBufferDesc mDescriptor;
 	physx::apex::NxUserRenderBoneBuffer* mChild;
@@ -305,6 +336,8 @@ void RecordingRenderResourceManager::releaseBoneBuffer(physx::apex::NxUserRender
 	{
 		mChild->releaseBoneBuffer(*reinterpret_cast<RecordingBoneBuffer&>(buffer).getChild());
 	}
+
+	delete &buffer;
 }
 
 
@@ -332,15 +365,73 @@ void RecordingRenderResourceManager::releaseInstanceBuffer(physx::apex::NxUserRe
 
 
 
+class RecordingSpriteBuffer : public physx::apex::NxUserRenderSpriteBuffer
+{
+public:
+	RecordingSpriteBuffer(const physx::apex::NxUserRenderSpriteBufferDesc& desc, physx::apex::NxUserRenderSpriteBuffer* child, RecordingRenderResourceManager::RecorderInterface* recorder) :
+		mDescriptor(desc), mChild(child), mBufferId(0), mRecorder(recorder)
+	{
+		mBufferId = spriteBufferId++;
+
+		if (mRecorder != NULL)
+		{
+			mRecorder->createSpriteBuffer(mBufferId, desc);
+		}
+	}
+
+	~RecordingSpriteBuffer()
+	{
+		if (mRecorder != NULL)
+		{
+			mRecorder->releaseSpriteBuffer(mBufferId);
+		}
+	}
+
+	virtual void writeBuffer(const physx::apex::NxApexRenderSpriteBufferData& data, physx::PxU32 firstSprite, physx::PxU32 numSprites)
+	{
+		if (mChild != NULL)
+		{
+			mChild->writeBuffer(data, firstSprite, numSprites);
+		}
+
+		if (mRecorder != NULL)
+		{
+			mRecorder->writeSpriteBuffer(mBufferId, data, firstSprite, numSprites);
+		}
+	}
+
+	physx::apex::NxUserRenderSpriteBuffer* getChild()
+	{
+		return mChild;
+	}
+
+	unsigned int getId() const
+	{
+		return mBufferId;
+	}
+
+protected:
+	physx::apex::NxUserRenderSpriteBufferDesc mDescriptor;
+	physx::apex::NxUserRenderSpriteBuffer* mChild;
+
+	static unsigned int spriteBufferId;
+	unsigned int mBufferId;
+
+	RecordingRenderResourceManager::RecorderInterface* mRecorder;
+};
+
+unsigned int RecordingSpriteBuffer::spriteBufferId = 0;
+
+
 physx::apex::NxUserRenderSpriteBuffer* RecordingRenderResourceManager::createSpriteBuffer(const physx::apex::NxUserRenderSpriteBufferDesc& desc)
 {
-	UNIMPLEMENTED;
+	physx::apex::NxUserRenderSpriteBuffer* child = NULL;
 	if (mChild != NULL)
 	{
-		return mChild->createSpriteBuffer(desc);
+		child = mChild->createSpriteBuffer(desc);
 	}
 
-	return NULL;
+	return new RecordingSpriteBuffer(desc, child, mRecorder);
 }
 
 
@@ -349,8 +440,10 @@ void RecordingRenderResourceManager::releaseSpriteBuffer(physx::apex::NxUserRend
 {
 	if (mChild != NULL)
 	{
-		mChild->releaseSpriteBuffer(buffer);
+		mChild->releaseSpriteBuffer(*reinterpret_cast<RecordingSpriteBuffer&>(buffer).getChild());
 	}
+
+	delete &buffer;
 }
 
 
@@ -360,7 +453,7 @@ class RecordingRenderResource : public physx::apex::NxUserRenderResource
 public:
 	RecordingRenderResource(const physx::apex::NxUserRenderResourceDesc& desc, physx::apex::NxUserRenderResourceManager* childRrm, RecordingRenderResourceManager::RecorderInterface* recorder) : mChild(NULL), mDescriptor(desc), mRecorder(recorder)
 	{
-		assert(desc.numVertexBuffers > 0);
+		assert(desc.numVertexBuffers > 0 || desc.spriteBuffer != NULL);
 
 		mResourceId = resourceIds++;
 
@@ -372,10 +465,10 @@ public:
 			vertexBufferChild[i] = reinterpret_cast<RecordingVertexBuffer*>(desc.vertexBuffers[i])->getChild();
 		}
 
-		mDescriptor.vertexBuffers = &vertexBufferOriginal[0];
+		mDescriptor.vertexBuffers = vertexBufferOriginal.empty() ? NULL : &vertexBufferOriginal[0];
 
 		physx::apex::NxUserRenderResourceDesc newDesc(desc);
-		newDesc.vertexBuffers = &vertexBufferChild[0];
+		newDesc.vertexBuffers = vertexBufferChild.empty() ? NULL : &vertexBufferChild[0];
 
 		if (desc.indexBuffer != NULL)
 		{
@@ -387,6 +480,11 @@ public:
 			newDesc.boneBuffer = reinterpret_cast<RecordingBoneBuffer*>(desc.boneBuffer)->getChild();
 		}
 
+		if (desc.spriteBuffer != NULL)
+		{
+			newDesc.spriteBuffer = reinterpret_cast<RecordingSpriteBuffer*>(desc.spriteBuffer)->getChild();
+		}
+
 		if (childRrm != NULL)
 		{
 			mChild = childRrm->createResource(newDesc);
@@ -400,7 +498,10 @@ public:
 
 	~RecordingRenderResource()
 	{
-
+		if (mRecorder != NULL)
+		{
+			mRecorder->releaseResource(mResourceId);
+		}
 	}
 
 
@@ -531,11 +632,11 @@ public:
 		return mDescriptor.spriteBuffer;
 	}
 
-	void render()
+	void render(const physx::apex::NxApexRenderContext& context)
 	{
 		if (mRecorder != NULL)
 		{
-			mRecorder->renderResource(mResourceId, mDescriptor);
+			mRecorder->renderResource(mResourceId, mDescriptor, context);
 		}
 	}
 
@@ -594,6 +695,16 @@ unsigned int RecordingRenderResourceManager::getMaxBonesForMaterial(void* materi
 
 
 
+void RecordingRenderResourceManager::endFrame()
+{
+	if (mRecorder != NULL)
+	{
+		mRecorder->endFrame();
+	}
+}
+
+
+
 
 RecordingRenderer::RecordingRenderer(physx::apex::NxUserRenderer* child, RecordingRenderResourceManager::RecorderInterface* recorder) : mChild(child), mRecorder(recorder)
 {
@@ -613,7 +724,7 @@ void RecordingRenderer::renderResource(const physx::apex::NxApexRenderContext& c
 {
 	RecordingRenderResource* resource = reinterpret_cast<RecordingRenderResource*>(context.renderResource);
 
-	resource->render();
+	resource->render(context);
 
 	physx::apex::NxUserRenderResource* child = resource->getChild();
 	if (mChild != NULL && child != NULL)
@@ -834,6 +945,37 @@ void FileRecorder::releaseBoneBuffer(unsigned int id)
 
 
 
+void FileRecorder::createSpriteBuffer(unsigned int id, const physx::apex::NxUserRenderSpriteBufferDesc& desc)
+{
+	fprintf(mOutputFile, "SpriteBuffer[%d]::create: ", id);
+
+	WRITE_DESC_ELEM(maxSprites);
+	WRITE_DESC_ELEM(hint);
+	WRITE_DESC_ELEM(stride);
+
+	fprintf(mOutputFile, "\n");
+}
+
+
+
+void FileRecorder::writeSpriteBuffer(unsigned int id, const physx::apex::NxApexRenderSpriteBufferData& /*data*/, unsigned int firstSprite, unsigned int numSprites)
+{
+	fprintf(mOutputFile, "SpriteBuffer[%d]::write: ", id);
+	WRITE_ITEM(firstSprite);
+	WRITE_ITEM(numSprites);
+
+	fprintf(mOutputFile, "\n");
+}
+
+
+
+void FileRecorder::releaseSpriteBuffer(unsigned int id)
+{
+	fprintf(mOutputFile, "SpriteBuffer[%d]::release\n", id);
+}
+
+
+
 void FileRecorder::createResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& /*desc*/)
 {
 	fprintf(mOutputFile, "Resource[%d]::create\n", id);
@@ -841,7 +983,7 @@ void FileRecorder::createResource(unsigned int id, const physx::apex::NxUserRend
 
 
 
-void FileRecorder::renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& /*desc*/)
+void FileRecorder::renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& /*desc*/, const physx::apex::NxApexRenderContext& /*context*/)
 {
 	fprintf(mOutputFile, "Resource[%d]::render\n", id);
 }
@@ -862,6 +1004,13 @@ void FileRecorder::setMaxBonesForMaterial(void* material, unsigned int maxBones)
 
 
 
+void FileRecorder::endFrame()
+{
+	fprintf(mOutputFile, "EndFrame\n");
+}
+
+
+
 void FileRecorder::writeElem(const char* name, unsigned int value)
 {
 	fprintf(mOutputFile, "%s=%d ", name, value);
@@ -945,3 +1094,1344 @@ void FileRecorder::writeBufferDataLong(const void* data, unsigned int stride, un
 		fprintf(mOutputFile, "),");
 	}
 }
+
+
+
+// Binary recording format: a file header followed by chunks. Every chunk holds RECORDING_CHUNK_SIZE
+// bytes of the packet stream (less for the last one), stored raw or LZ4 compressed. Packets are a
+// PacketHeader and a payload and can straddle chunk boundaries. Values are stored in the native
+// byte order of the recording machine.
+namespace
+{
+
+const physx::PxU32 RECORDING_FILE_MAGIC = 0x4d525242;	// "BRRM"
+const physx::PxU32 RECORDING_FILE_VERSION = 1;
+const physx::PxU32 RECORDING_CHUNK_MAGIC = 0x4b4e4843;	// "CHNK"
+const physx::PxU32 RECORDING_CHUNK_SIZE = 4 * 1024 * 1024;
+const physx::PxU32 RECORDING_NUM_CHUNKS = 8;
+const physx::PxU32 RECORDING_INVALID_ID = 0xffffffff;
+
+struct RecordingCodec
+{
+	enum Enum
+	{
+		RAW = 0,
+		LZ4,
+	};
+};
+
+struct RecordingPacket
+{
+	enum Enum
+	{
+		CREATE_VERTEX_BUFFER = 1,
+		WRITE_VERTEX_BUFFER,
+		RELEASE_VERTEX_BUFFER,
+		CREATE_INDEX_BUFFER,
+		WRITE_INDEX_BUFFER,
+		RELEASE_INDEX_BUFFER,
+		CREATE_BONE_BUFFER,
+		WRITE_BONE_BUFFER,
+		RELEASE_BONE_BUFFER,
+		CREATE_SPRITE_BUFFER,
+		WRITE_SPRITE_BUFFER,
+		RELEASE_SPRITE_BUFFER,
+		CREATE_RESOURCE,
+		RENDER_RESOURCE,
+		RELEASE_RESOURCE,
+		MAX_BONES_FOR_MATERIAL,
+		END_FRAME,
+	};
+};
+
+struct FileHeader
+{
+	physx::PxU32 magic;
+	physx::PxU32 version;
+	physx::PxU32 chunkSize;
+	physx::PxU32 reserved;
+};
+
+struct ChunkHeader
+{
+	physx::PxU32 magic;
+	physx::PxU32 codec;
+	physx::PxU32 rawSize;
+	physx::PxU32 storedSize;
+};
+
+struct PacketHeader
+{
+	physx::PxU32 type;
+	physx::PxU32 size;	// payload bytes following the header
+};
+
+struct CreateVertexBufferPacket
+{
+	physx::PxU32 id;
+	physx::PxU32 maxVerts;
+	physx::PxU32 hint;
+	physx::PxU32 buffersRequest[physx::apex::NxRenderVertexSemantic::NUM_SEMANTICS];
+	physx::PxU32 moduleIdentifier;
+	physx::PxU32 uvOrigin;
+	physx::PxU32 canBeShared;
+};
+
+struct CreateIndexBufferPacket
+{
+	physx::PxU32 id;
+	physx::PxU32 maxIndices;
+	physx::PxU32 hint;
+	physx::PxU32 format;
+	physx::PxU32 primitives;
+};
+
+struct CreateBoneBufferPacket
+{
+	physx::PxU32 id;
+	physx::PxU32 maxBones;
+	physx::PxU32 hint;
+	physx::PxU32 buffersRequest[physx::apex::NxRenderBoneSemantic::NUM_SEMANTICS];
+};
+
+struct CreateSpriteBufferPacket
+{
+	physx::PxU32 id;
+	physx::PxU32 maxSprites;
+	physx::PxU32 hint;
+	physx::PxU32 semanticFormats[physx::apex::NxRenderSpriteSemantic::NUM_SEMANTICS];
+	physx::PxU32 semanticOffsets[physx::apex::NxRenderSpriteSemantic::NUM_SEMANTICS];
+	physx::PxU32 stride;
+};
+
+// followed by numSemantics SemanticPacket and, with hasData, count * elementSize bytes per semantic
+struct WriteBufferPacket
+{
+	physx::PxU32 id;
+	physx::PxU32 first;
+	physx::PxU32 count;
+	physx::PxU32 moduleId;
+	physx::PxU32 numSemantics;
+	physx::PxU32 hasData;
+};
+
+struct SemanticPacket
+{
+	physx::PxU32 semantic;
+	physx::PxU32 format;
+	physx::PxU32 srcFormat;
+	physx::PxU32 elementSize;
+};
+
+struct ResourceRanges
+{
+	enum Enum
+	{
+		FIRST_VERTEX = 0,
+		NUM_VERTS,
+		FIRST_INDEX,
+		NUM_INDICES,
+		FIRST_BONE,
+		NUM_BONES,
+		FIRST_SPRITE,
+		NUM_SPRITES,
+		COUNT
+	};
+};
+
+// followed by numVertexBuffers vertex buffer ids
+struct CreateResourcePacket
+{
+	physx::PxU64 material;
+	physx::PxU32 id;
+	physx::PxU32 numVertexBuffers;
+	physx::PxU32 indexBuffer;
+	physx::PxU32 boneBuffer;
+	physx::PxU32 spriteBuffer;
+	physx::PxU32 ranges[ResourceRanges::COUNT];
+	physx::PxU32 submeshIndex;
+	physx::PxU32 cullMode;
+	physx::PxU32 primitives;
+};
+
+struct RenderResourcePacket
+{
+	physx::PxU64 material;
+	physx::PxU32 id;
+	physx::PxU32 isScreenSpace;
+	physx::PxU32 ranges[ResourceRanges::COUNT];
+	physx::PxF32 local2world[16];
+	physx::PxF32 world2local[16];
+};
+
+struct MaxBonesPacket
+{
+	physx::PxU64 material;
+	physx::PxU32 maxBones;
+	physx::PxU32 padding;
+};
+
+void getRanges(const physx::apex::NxUserRenderResourceDesc& desc, physx::PxU32* ranges)
+{
+	ranges[ResourceRanges::FIRST_VERTEX] = desc.firstVertex;
+	ranges[ResourceRanges::NUM_VERTS] = desc.numVerts;
+	ranges[ResourceRanges::FIRST_INDEX] = desc.firstIndex;
+	ranges[ResourceRanges::NUM_INDICES] = desc.numIndices;
+	ranges[ResourceRanges::FIRST_BONE] = desc.firstBone;
+	ranges[ResourceRanges::NUM_BONES] = desc.numBones;
+	ranges[ResourceRanges::FIRST_SPRITE] = desc.firstSprite;
+	ranges[ResourceRanges::NUM_SPRITES] = desc.numSprites;
+}
+
+}
+
+
+
+// ---------------------------------------------------------------------------
+// Packs the packet stream into a small pool of chunks. Full chunks are handed to the thread, which
+// compresses and writes them while the recording thread fills the next one. The recording thread
+// only blocks when all chunks are waiting for the disk.
+class RecordingStreamWriter : public physx::shdfnd::Thread
+{
+public:
+	RecordingStreamWriter(FILE* file, bool compress) : mFile(file), mCompress(compress), mCurrent(NULL)
+	{
+#if !RECORDER_USE_LZ4
+		mCompress = false;
+#endif
+		mMemory.resize(RECORDING_CHUNK_SIZE * RECORDING_NUM_CHUNKS);
+		mChunks.resize(RECORDING_NUM_CHUNKS);
+		for (physx::PxU32 i = 0; i < RECORDING_NUM_CHUNKS; i++)
+		{
+			mChunks[i].data = &mMemory[i * RECORDING_CHUNK_SIZE];
+			mChunks[i].size = 0;
+			mFree.push_back(&mChunks[i]);
+		}
+#if RECORDER_USE_LZ4
+		if (mCompress)
+		{
+			mCompressed.resize(LZ4_compressBound(RECORDING_CHUNK_SIZE));
+		}
+#endif
+
+		FileHeader header;
+		header.magic = RECORDING_FILE_MAGIC;
+		header.version = RECORDING_FILE_VERSION;
+		header.chunkSize = RECORDING_CHUNK_SIZE;
+		header.reserved = 0;
+		fwrite(&header, sizeof(header), 1, mFile);
+
+		mCurrent = acquireChunk();
+
+		setName("RecordingStreamWriter");
+		start(physx::shdfnd::Thread::getDefaultStackSize());
+	}
+
+	~RecordingStreamWriter()
+	{
+		submit();
+		signalQuit();
+		mWorkAvailable.set();
+		waitForQuit();
+
+		fclose(mFile);
+	}
+
+	void write(const void* data, physx::PxU32 size)
+	{
+		const char* src = reinterpret_cast<const char*>(data);
+		while (size > 0)
+		{
+			if (mCurrent->size == RECORDING_CHUNK_SIZE)
+			{
+				submit();
+				mCurrent = acquireChunk();
+			}
+
+			const physx::PxU32 n = physx::PxMin(size, RECORDING_CHUNK_SIZE - mCurrent->size);
+			memcpy(mCurrent->data + mCurrent->size, src, n);
+			mCurrent->size += n;
+			src += n;
+			size -= n;
+		}
+	}
+
+	// gathers count elements of elementSize bytes each from a strided source
+	void writeStrided(const void* data, physx::PxU32 stride, physx::PxU32 elementSize, physx::PxU32 count)
+	{
+		if (stride == elementSize)
+		{
+			write(data, elementSize * count);
+			return;
+		}
+
+		const char* src = reinterpret_cast<const char*>(data);
+		for (physx::PxU32 i = 0; i < count; i++, src += stride)
+		{
+			if (mCurrent->size + elementSize <= RECORDING_CHUNK_SIZE)
+			{
+				memcpy(mCurrent->data + mCurrent->size, src, elementSize);
+				mCurrent->size += elementSize;
+			}
+			else
+			{
+				write(src, elementSize);
+			}
+		}
+	}
+
+	virtual void execute()
+	{
+		for (;;)
+		{
+			mWorkAvailable.wait();
+
+			for (;;)
+			{
+				Chunk* chunk = NULL;
+				{
+					physx::shdfnd::Mutex::ScopedLock lock(mMutex);
+					if (mFull.empty())
+					{
+						mWorkAvailable.reset();
+					}
+					else
+					{
+						chunk = mFull.front();
+						mFull.erase(mFull.begin());
+					}
+				}
+
+				if (chunk == NULL)
+				{
+					break;
+				}
+
+				writeChunk(*chunk);
+
+				{
+					physx::shdfnd::Mutex::ScopedLock lock(mMutex);
+					chunk->size = 0;
+					mFree.push_back(chunk);
+				}
+				mFreeAvailable.set();
+			}
+
+			if (quitIsSignalled())
+			{
+				break;
+			}
+		}
+	}
+
+private:
+	struct Chunk
+	{
+		char* data;
+		physx::PxU32 size;
+	};
+
+	Chunk* acquireChunk()
+	{
+		for (;;)
+		{
+			{
+				physx::shdfnd::Mutex::ScopedLock lock(mMutex);
+				if (!mFree.empty())
+				{
+					Chunk* chunk = mFree.back();
+					mFree.pop_back();
+					return chunk;
+				}
+				mFreeAvailable.reset();
+			}
+			mFreeAvailable.wait();
+		}
+	}
+
+	void submit()
+	{
+		if (mCurrent == NULL || mCurrent->size == 0)
+		{
+			return;
+		}
+
+		{
+			physx::shdfnd::Mutex::ScopedLock lock(mMutex);
+			mFull.push_back(mCurrent);
+		}
+		mCurrent = NULL;
+		mWorkAvailable.set();
+	}
+
+	void writeChunk(const Chunk& chunk)
+	{
+		ChunkHeader header;
+		header.magic = RECORDING_CHUNK_MAGIC;
+		header.codec = RecordingCodec::RAW;
+		header.rawSize = chunk.size;
+		header.storedSize = chunk.size;
+		const char* stored = chunk.data;
+
+#if RECORDER_USE_LZ4
+		if (mCompress)
+		{
+			const int size = LZ4_compress_default(chunk.data, &mCompressed[0], (int)chunk.size, (int)mCompressed.size());
+			if (size > 0 && physx::PxU32(size) < chunk.size)
+			{
+				header.codec = RecordingCodec::LZ4;
+				header.storedSize = physx::PxU32(size);
+				stored = &mCompressed[0];
+			}
+		}
+#endif
+
+		fwrite(&header, sizeof(header), 1, mFile);
+		fwrite(stored, 1, header.storedSize, mFile);
+	}
+
+	FILE* mFile;
+	bool mCompress;
+
+	std::vector<char> mMemory;
+	std::vector<Chunk> mChunks;
+	std::vector<char> mCompressed;
+
+	// mCurrent is owned by the recording thread, the queues are shared with the writer thread
+	Chunk* mCurrent;
+	std::vector<Chunk*> mFree;
+	std::vector<Chunk*> mFull;
+
+	physx::shdfnd::Mutex mMutex;
+	physx::shdfnd::Sync mFreeAvailable;
+	physx::shdfnd::Sync mWorkAvailable;
+};
+
+
+
+// ---------------------------------------------------------------------------
+class RecordingStreamReader
+{
+public:
+	RecordingStreamReader(FILE* file) : mFile(file), mPos(0)
+	{
+	}
+
+	~RecordingStreamReader()
+	{
+		fclose(mFile);
+	}
+
+	bool readHeader()
+	{
+		FileHeader header;
+		if (fread(&header, sizeof(header), 1, mFile) != 1)
+		{
+			return false;
+		}
+		return header.magic == RECORDING_FILE_MAGIC && header.version == RECORDING_FILE_VERSION;
+	}
+
+	bool read(void* data, physx::PxU32 size)
+	{
+		char* dst = reinterpret_cast<char*>(data);
+		while (size > 0)
+		{
+			if (mPos == mChunk.size() && !nextChunk())
+			{
+				return false;
+			}
+
+			const physx::PxU32 n = physx::PxMin(size, physx::PxU32(mChunk.size() - mPos));
+			if (dst != NULL)
+			{
+				memcpy(dst, &mChunk[mPos], n);
+				dst += n;
+			}
+			mPos += n;
+			size -= n;
+		}
+		return true;
+	}
+
+	bool skip(physx::PxU32 size)
+	{
+		return read(NULL, size);
+	}
+
+private:
+	bool nextChunk()
+	{
+		ChunkHeader header;
+		if (fread(&header, sizeof(header), 1, mFile) != 1 || header.magic != RECORDING_CHUNK_MAGIC || header.rawSize == 0)
+		{
+			return false;
+		}
+
+		mChunk.resize(header.rawSize);
+		mPos = 0;
+
+		if (header.codec == RecordingCodec::RAW)
+		{
+			return header.storedSize == header.rawSize && fread(&mChunk[0], 1, header.rawSize, mFile) == header.rawSize;
+		}
+
+#if RECORDER_USE_LZ4
+		if (header.codec == RecordingCodec::LZ4)
+		{
+			mStored.resize(header.storedSize);
+			if (fread(&mStored[0], 1, header.storedSize, mFile) != header.storedSize)
+			{
+				return false;
+			}
+			return LZ4_decompress_safe(&mStored[0], &mChunk[0], (int)header.storedSize, (int)header.rawSize) == (int)header.rawSize;
+		}
+#endif
+
+		// compressed recording, but no LZ4 support compiled in
+		return false;
+	}
+
+	FILE* mFile;
+	std::vector<char> mChunk;
+	std::vector<char> mStored;
+	physx::PxU32 mPos;
+};
+
+
+
+// ---------------------------------------------------------------------------
+BinaryRecorder::BinaryRecorder(const char* filename, bool captureBufferData, bool compress) :
+	mStream(NULL),
+	mCaptureBufferData(captureBufferData),
+	mFrame(0)
+{
+	FILE* file = fopen(filename, "wb");
+	assert(file);
+
+	if (file != NULL)
+	{
+		mStream = PX_NEW(RecordingStreamWriter)(file, compress);
+	}
+}
+
+
+
+BinaryRecorder::~BinaryRecorder()
+{
+	if (mStream != NULL)
+	{
+		PX_DELETE(mStream);
+		mStream = NULL;
+	}
+}
+
+
+
+#define BEGIN_PACKET(_type, _size) \
+	if (mStream == NULL) return; \
+	physx::shdfnd::Mutex::ScopedLock lock(mMutex); \
+	PacketHeader header; \
+	header.type = RecordingPacket::_type; \
+	header.size = _size; \
+	mStream->write(&header, sizeof(header))
+
+
+
+void BinaryRecorder::createVertexBuffer(unsigned int id, const physx::apex::NxUserRenderVertexBufferDesc& desc)
+{
+	CreateVertexBufferPacket packet;
+	packet.id = id;
+	packet.maxVerts = desc.maxVerts;
+	packet.hint = desc.hint;
+	for (physx::PxU32 i = 0; i < physx::apex::NxRenderVertexSemantic::NUM_SEMANTICS; i++)
+	{
+		packet.buffersRequest[i] = desc.buffersRequest[i];
+	}
+	packet.moduleIdentifier = desc.moduleIdentifier;
+	packet.uvOrigin = desc.uvOrigin;
+	packet.canBeShared = desc.canBeShared ? 1u : 0u;
+
+	BEGIN_PACKET(CREATE_VERTEX_BUFFER, sizeof(packet));
+	mStream->write(&packet, sizeof(packet));
+}
+
+
+
+template<class SemanticClass, class SemanticEnum>
+void BinaryRecorder::writeBufferData(physx::PxU32 type, unsigned int id, const physx::apex::NxApexRenderBufferData<SemanticClass, SemanticEnum>& data, physx::PxU32 moduleId, unsigned int first, unsigned int count)
+{
+	// custom and module specific semantics are not recorded, their idents can not be replayed
+	SemanticPacket semantics[SemanticClass::NUM_SEMANTICS];
+	const void* sources[SemanticClass::NUM_SEMANTICS];
+	physx::PxU32 strides[SemanticClass::NUM_SEMANTICS];
+
+	WriteBufferPacket packet;
+	packet.id = id;
+	packet.first = first;
+	packet.count = count;
+	packet.moduleId = moduleId;
+	packet.numSemantics = 0;
+	packet.hasData = mCaptureBufferData ? 1u : 0u;
+
+	physx::PxU32 dataSize = 0;
+	for (physx::PxU32 i = 0; i < SemanticClass::NUM_SEMANTICS; i++)
+	{
+		const physx::apex::NxApexRenderSemanticData& semanticData = data.getSemanticData(SemanticEnum(i));
+		if (semanticData.data == NULL || semanticData.format == physx::apex::NxRenderDataFormat::UNSPECIFIED)
+		{
+			continue;
+		}
+
+		const physx::apex::NxRenderDataFormat::Enum srcFormat = semanticData.srcFormat != physx::apex::NxRenderDataFormat::UNSPECIFIED ? semanticData.srcFormat : semanticData.format;
+
+		SemanticPacket& semantic = semantics[packet.numSemantics];
+		semantic.semantic = i;
+		semantic.format = semanticData.format;
+		semantic.srcFormat = srcFormat;
+		semantic.elementSize = physx::apex::NxRenderDataFormat::getFormatDataSize(srcFormat);
+		sources[packet.numSemantics] = semanticData.data;
+		strides[packet.numSemantics] = semanticData.stride;
+		dataSize += semantic.elementSize * count;
+		packet.numSemantics++;
+	}
+
+	BEGIN_PACKET(Enum(type), sizeof(packet) + packet.numSemantics * sizeof(SemanticPacket) + (mCaptureBufferData ? dataSize : 0));
+	mStream->write(&packet, sizeof(packet));
+	mStream->write(semantics, packet.numSemantics * sizeof(SemanticPacket));
+
+	if (mCaptureBufferData)
+	{
+		for (physx::PxU32 i = 0; i < packet.numSemantics; i++)
+		{
+			mStream->writeStrided(sources[i], strides[i], semantics[i].elementSize, count);
+		}
+	}
+}
+
+
+
+void BinaryRecorder::writeVertexBuffer(unsigned int id, const physx::apex::NxApexRenderVertexBufferData& data, unsigned int firstVertex, unsigned int numVertices)
+{
+	writeBufferData(RecordingPacket::WRITE_VERTEX_BUFFER, id, data, data.moduleId, firstVertex, numVertices);
+}
+
+
+
+void BinaryRecorder::releaseVertexBuffer(unsigned int id)
+{
+	writeRelease(RecordingPacket::RELEASE_VERTEX_BUFFER, id);
+}
+
+
+
+void BinaryRecorder::createIndexBuffer(unsigned int id, const physx::apex::NxUserRenderIndexBufferDesc& desc)
+{
+	CreateIndexBufferPacket packet;
+	packet.id = id;
+	packet.maxIndices = desc.maxIndices;
+	packet.hint = desc.hint;
+	packet.format = desc.format;
+	packet.primitives = desc.primitives;
+
+	BEGIN_PACKET(CREATE_INDEX_BUFFER, sizeof(packet));
+	mStream->write(&packet, sizeof(packet));
+}
+
+
+
+void BinaryRecorder::writeIndexBuffer(unsigned int id, const void* srcData, physx::PxU32 srcStride, unsigned int firstDestElement, unsigned int numElements, physx::apex::NxRenderDataFormat::Enum format)
+{
+	WriteBufferPacket packet;
+	packet.id = id;
+	packet.first = firstDestElement;
+	packet.count = numElements;
+	packet.moduleId = 0;
+	packet.numSemantics = 1;
+	packet.hasData = mCaptureBufferData ? 1u : 0u;
+
+	SemanticPacket semantic;
+	semantic.semantic = 0;
+	semantic.format = format;
+	semantic.srcFormat = format;
+	semantic.elementSize = physx::apex::NxRenderDataFormat::getFormatDataSize(format);
+
+	BEGIN_PACKET(WRITE_INDEX_BUFFER, sizeof(packet) + sizeof(semantic) + (mCaptureBufferData ? semantic.elementSize * numElements : 0));
+	mStream->write(&packet, sizeof(packet));
+	mStream->write(&semantic, sizeof(semantic));
+
+	if (mCaptureBufferData)
+	{
+		mStream->writeStrided(srcData, srcStride, semantic.elementSize, numElements);
+	}
+}
+
+
+
+void BinaryRecorder::releaseIndexBuffer(unsigned int id)
+{
+	writeRelease(RecordingPacket::RELEASE_INDEX_BUFFER, id);
+}
+
+
+
+void BinaryRecorder::createBoneBuffer(unsigned int id, const physx::apex::NxUserRenderBoneBufferDesc& desc)
+{
+	CreateBoneBufferPacket packet;
+	packet.id = id;
+	packet.maxBones = desc.maxBones;
+	packet.hint = desc.hint;
+	for (physx::PxU32 i = 0; i < physx::apex::NxRenderBoneSemantic::NUM_SEMANTICS; i++)
+	{
+		packet.buffersRequest[i] = desc.buffersRequest[i];
+	}
+
+	BEGIN_PACKET(CREATE_BONE_BUFFER, sizeof(packet));
+	mStream->write(&packet, sizeof(packet));
+}
+
+
+
+void BinaryRecorder::writeBoneBuffer(unsigned int id, const physx::apex::NxApexRenderBoneBufferData& data, unsigned int firstBone, unsigned int numBones)
+{
+	writeBufferData(RecordingPacket::WRITE_BONE_BUFFER, id, data, 0, firstBone, numBones);
+}
+
+
+
+void BinaryRecorder::releaseBoneBuffer(unsigned int id)
+{
+	writeRelease(RecordingPacket::RELEASE_BONE_BUFFER, id);
+}
+
+
+
+void BinaryRecorder::createSpriteBuffer(unsigned int id, const physx::apex::NxUserRenderSpriteBufferDesc& desc)
+{
+	CreateSpriteBufferPacket packet;
+	packet.id = id;
+	packet.maxSprites = desc.maxSprites;
+	packet.hint = desc.hint;
+	for (physx::PxU32 i = 0; i < physx::apex::NxRenderSpriteSemantic::NUM_SEMANTICS; i++)
+	{
+		packet.semanticFormats[i] = desc.semanticFormats[i];
+		packet.semanticOffsets[i] = desc.semanticOffsets[i];
+	}
+	packet.stride = desc.stride;
+
+	BEGIN_PACKET(CREATE_SPRITE_BUFFER, sizeof(packet));
+	mStream->write(&packet, sizeof(packet));
+}
+
+
+
+void BinaryRecorder::writeSpriteBuffer(unsigned int id, const physx::apex::NxApexRenderSpriteBufferData& data, unsigned int firstSprite, unsigned int numSprites)
+{
+	writeBufferData(RecordingPacket::WRITE_SPRITE_BUFFER, id, data, data.moduleId, firstSprite, numSprites);
+}
+
+
+
+void BinaryRecorder::releaseSpriteBuffer(unsigned int id)
+{
+	writeRelease(RecordingPacket::RELEASE_SPRITE_BUFFER, id);
+}
+
+
+
+void BinaryRecorder::createResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc)
+{
+	CreateResourcePacket packet;
+	packet.material = (physx::PxU64)(size_t)desc.material;
+	packet.id = id;
+	packet.numVertexBuffers = desc.numVertexBuffers;
+	packet.indexBuffer = desc.indexBuffer != NULL ? reinterpret_cast<RecordingIndexBuffer*>(desc.indexBuffer)->getId() : RECORDING_INVALID_ID;
+	packet.boneBuffer = desc.boneBuffer != NULL ? reinterpret_cast<RecordingBoneBuffer*>(desc.boneBuffer)->getId() : RECORDING_INVALID_ID;
+	packet.spriteBuffer = desc.spriteBuffer != NULL ? reinterpret_cast<RecordingSpriteBuffer*>(desc.spriteBuffer)->getId() : RECORDING_INVALID_ID;
+	getRanges(desc, packet.ranges);
+	packet.submeshIndex = desc.submeshIndex;
+	packet.cullMode = desc.cullMode;
+	packet.primitives = desc.primitives;
+
+	BEGIN_PACKET(CREATE_RESOURCE, sizeof(packet) + desc.numVertexBuffers * sizeof(physx::PxU32));
+	mStream->write(&packet, sizeof(packet));
+	for (physx::PxU32 i = 0; i < desc.numVertexBuffers; i++)
+	{
+		const physx::PxU32 vertexBuffer = reinterpret_cast<RecordingVertexBuffer*>(desc.vertexBuffers[i])->getId();
+		mStream->write(&vertexBuffer, sizeof(vertexBuffer));
+	}
+}
+
+
+
+void BinaryRecorder::renderResource(unsigned int id, const physx::apex::NxUserRenderResourceDesc& desc, const physx::apex::NxApexRenderContext& context)
+{
+	RenderResourcePacket packet;
+	packet.material = (physx::PxU64)(size_t)desc.material;
+	packet.id = id;
+	packet.isScreenSpace = context.isScreenSpace ? 1u : 0u;
+	getRanges(desc, packet.ranges);
+	memcpy(packet.local2world, context.local2world.front(), sizeof(packet.local2world));
+	memcpy(packet.world2local, context.world2local.front(), sizeof(packet.world2local));
+
+	BEGIN_PACKET(RENDER_RESOURCE, sizeof(packet));
+	mStream->write(&packet, sizeof(packet));
+}
+
+
+
+void BinaryRecorder::releaseResource(unsigned int id)
+{
+	writeRelease(RecordingPacket::RELEASE_RESOURCE, id);
+}
+
+
+
+void BinaryRecorder::setMaxBonesForMaterial(void* material, unsigned int maxBones)
+{
+	MaxBonesPacket packet;
+	packet.material = (physx::PxU64)(size_t)material;
+	packet.maxBones = maxBones;
+	packet.padding = 0;
+
+	BEGIN_PACKET(MAX_BONES_FOR_MATERIAL, sizeof(packet));
+	mStream->write(&packet, sizeof(packet));
+}
+
+
+
+void BinaryRecorder::endFrame()
+{
+	BEGIN_PACKET(END_FRAME, sizeof(mFrame));
+	mStream->write(&mFrame, sizeof(mFrame));
+	mFrame++;
+}
+
+
+
+void BinaryRecorder::writeRelease(physx::PxU32 type, unsigned int id)
+{
+	const physx::PxU32 packet = id;
+
+	BEGIN_PACKET(Enum(type), sizeof(packet));
+	mStream->write(&packet, sizeof(packet));
+}
+
+#undef BEGIN_PACKET
+
+
+
+// ---------------------------------------------------------------------------
+RecordingPlayer::RecordingPlayer(physx::apex::NxUserRenderResourceManager& rrm, physx::apex::NxUserRenderer* renderer, void* defaultMaterial) :
+	mRrm(rrm),
+	mRenderer(renderer),
+	mDefaultMaterial(defaultMaterial),
+	mStream(NULL),
+	mFrame(0)
+{
+}
+
+
+
+RecordingPlayer::~RecordingPlayer()
+{
+	close();
+}
+
+
+
+bool RecordingPlayer::open(const char* filename)
+{
+	close();
+
+	FILE* file = fopen(filename, "rb");
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	mStream = new RecordingStreamReader(file);
+	if (!mStream->readHeader())
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void RecordingPlayer::close()
+{
+	// resources first, they reference the buffers
+	for (std::map<physx::PxU32, Resource>::iterator it = mResources.begin(); it != mResources.end(); ++it)
+	{
+		mRrm.releaseResource(*it->second.resource);
+	}
+	mResources.clear();
+
+	for (std::map<physx::PxU32, physx::apex::NxUserRenderVertexBuffer*>::iterator it = mVertexBuffers.begin(); it != mVertexBuffers.end(); ++it)
+	{
+		mRrm.releaseVertexBuffer(*it->second);
+	}
+	mVertexBuffers.clear();
+
+	for (std::map<physx::PxU32, physx::apex::NxUserRenderIndexBuffer*>::iterator it = mIndexBuffers.begin(); it != mIndexBuffers.end(); ++it)
+	{
+		mRrm.releaseIndexBuffer(*it->second);
+	}
+	mIndexBuffers.clear();
+
+	for (std::map<physx::PxU32, physx::apex::NxUserRenderBoneBuffer*>::iterator it = mBoneBuffers.begin(); it != mBoneBuffers.end(); ++it)
+	{
+		mRrm.releaseBoneBuffer(*it->second);
+	}
+	mBoneBuffers.clear();
+
+	for (std::map<physx::PxU32, physx::apex::NxUserRenderSpriteBuffer*>::iterator it = mSpriteBuffers.begin(); it != mSpriteBuffers.end(); ++it)
+	{
+		mRrm.releaseSpriteBuffer(*it->second);
+	}
+	mSpriteBuffers.clear();
+
+	delete mStream;
+	mStream = NULL;
+	mFrame = 0;
+}
+
+
+
+void RecordingPlayer::mapMaterial(physx::PxU64 recordedMaterial, void* material)
+{
+	mMaterials[recordedMaterial] = material;
+}
+
+
+
+void* RecordingPlayer::resolveMaterial(physx::PxU64 material) const
+{
+	std::map<physx::PxU64, void*>::const_iterator it = mMaterials.find(material);
+	return it != mMaterials.end() ? it->second : mDefaultMaterial;
+}
+
+
+
+template<class T>
+static T* findObject(const std::map<physx::PxU32, T*>& objects, physx::PxU32 id)
+{
+	typename std::map<physx::PxU32, T*>::const_iterator it = objects.find(id);
+	return it != objects.end() ? it->second : NULL;
+}
+
+
+
+template<class T>
+static T* removeObject(std::map<physx::PxU32, T*>& objects, physx::PxU32 id)
+{
+	typename std::map<physx::PxU32, T*>::iterator it = objects.find(id);
+	if (it == objects.end())
+	{
+		return NULL;
+	}
+
+	T* object = it->second;
+	objects.erase(it);
+	return object;
+}
+
+
+
+// reads the semantic table and payload of a buffer write into mSemantics and mScratch, recordings
+// without buffer data get zeroes of the same size
+bool RecordingPlayer::readBufferData(physx::PxU32 numSemantics, bool hasData, physx::PxU32 count)
+{
+	mSemantics.resize(numSemantics * 4);
+	physx::PxU32 dataSize = 0;
+	for (physx::PxU32 i = 0; i < numSemantics; i++)
+	{
+		SemanticPacket semantic;
+		if (!mStream->read(&semantic, sizeof(semantic)))
+		{
+			return false;
+		}
+
+		mSemantics[i * 4 + 0] = semantic.semantic;
+		mSemantics[i * 4 + 1] = semantic.format;
+		mSemantics[i * 4 + 2] = semantic.srcFormat;
+		mSemantics[i * 4 + 3] = semantic.elementSize;
+		dataSize += semantic.elementSize * count;
+	}
+
+	if (mScratch.size() < dataSize + 16)
+	{
+		mScratch.resize(dataSize + 16);
+	}
+
+	if (hasData)
+	{
+		return mStream->read(&mScratch[0], dataSize);
+	}
+
+	memset(&mScratch[0], 0, dataSize);
+	return true;
+}
+
+
+
+bool RecordingPlayer::playFrame(FrameTimings* timings)
+{
+	FrameTimings frame;
+	memset(&frame, 0, sizeof(frame));
+
+	bool endOfFrame = false;
+	while (mStream != NULL && !endOfFrame)
+	{
+		PacketHeader header;
+		if (!mStream->read(&header, sizeof(header)))
+		{
+			break;
+		}
+
+		physx::shdfnd::Time timer;
+		double* category = NULL;
+		bool valid = true;
+
+		switch (header.type)
+		{
+		case RecordingPacket::CREATE_VERTEX_BUFFER:
+		{
+			CreateVertexBufferPacket packet;
+			valid = mStream->read(&packet, sizeof(packet));
+
+			physx::apex::NxUserRenderVertexBufferDesc desc;
+			desc.maxVerts = packet.maxVerts;
+			desc.hint = physx::apex::NxRenderBufferHint::Enum(packet.hint);
+			for (physx::PxU32 i = 0; i < physx::apex::NxRenderVertexSemantic::NUM_SEMANTICS; i++)
+			{
+				desc.buffersRequest[i] = physx::apex::NxRenderDataFormat::Enum(packet.buffersRequest[i]);
+			}
+			desc.moduleIdentifier = packet.moduleIdentifier;
+			desc.uvOrigin = physx::apex::NxTextureUVOrigin::Enum(packet.uvOrigin);
+			desc.canBeShared = packet.canBeShared != 0;
+
+			timer.getElapsedSeconds();
+			mVertexBuffers[packet.id] = mRrm.createVertexBuffer(desc);
+			category = &frame.create;
+			break;
+		}
+		case RecordingPacket::CREATE_INDEX_BUFFER:
+		{
+			CreateIndexBufferPacket packet;
+			valid = mStream->read(&packet, sizeof(packet));
+
+			physx::apex::NxUserRenderIndexBufferDesc desc;
+			desc.maxIndices = packet.maxIndices;
+			desc.hint = physx::apex::NxRenderBufferHint::Enum(packet.hint);
+			desc.format = physx::apex::NxRenderDataFormat::Enum(packet.format);
+			desc.primitives = physx::apex::NxRenderPrimitiveType::Enum(packet.primitives);
+
+			timer.getElapsedSeconds();
+			mIndexBuffers[packet.id] = mRrm.createIndexBuffer(desc);
+			category = &frame.create;
+			break;
+		}
+		case RecordingPacket::CREATE_BONE_BUFFER:
+		{
+			CreateBoneBufferPacket packet;
+			valid = mStream->read(&packet, sizeof(packet));
+
+			physx::apex::NxUserRenderBoneBufferDesc desc;
+			desc.maxBones = packet.maxBones;
+			desc.hint = physx::apex::NxRenderBufferHint::Enum(packet.hint);
+			for (physx::PxU32 i = 0; i < physx::apex::NxRenderBoneSemantic::NUM_SEMANTICS; i++)
+			{
+				desc.buffersRequest[i] = physx::apex::NxRenderDataFormat::Enum(packet.buffersRequest[i]);
+			}
+
+			timer.getElapsedSeconds();
+			mBoneBuffers[packet.id] = mRrm.createBoneBuffer(desc);
+			category = &frame.create;
+			break;
+		}
+		case RecordingPacket::CREATE_SPRITE_BUFFER:
+		{
+			CreateSpriteBufferPacket packet;
+			valid = mStream->read(&packet, sizeof(packet));
+
+			physx::apex::NxUserRenderSpriteBufferDesc desc;
+			desc.maxSprites = packet.maxSprites;
+			desc.hint = physx::apex::NxRenderBufferHint::Enum(packet.hint);
+			for (physx::PxU32 i = 0; i < physx::apex::NxRenderSpriteSemantic::NUM_SEMANTICS; i++)
+			{
+				desc.semanticFormats[i] = physx::apex::NxRenderDataFormat::Enum(packet.semanticFormats[i]);
+				desc.semanticOffsets[i] = packet.semanticOffsets[i];
+			}
+			desc.stride = packet.stride;
+
+			timer.getElapsedSeconds();
+			mSpriteBuffers[packet.id] = mRrm.createSpriteBuffer(desc);
+			category = &frame.create;
+			break;
+		}
+		case RecordingPacket::CREATE_RESOURCE:
+		{
+			CreateResourcePacket packet;
+			valid = mStream->read(&packet, sizeof(packet));
+
+			std::vector<physx::apex::NxUserRenderVertexBuffer*> vertexBuffers(packet.numVertexBuffers);
+			for (physx::PxU32 i = 0; valid && i < packet.numVertexBuffers; i++)
+			{
+				physx::PxU32 id;
+				valid = mStream->read(&id, sizeof(id));
+				vertexBuffers[i] = findObject(mVertexBuffers, id);
+			}
+
+			physx::apex::NxUserRenderResourceDesc desc;
+			desc.vertexBuffers = vertexBuffers.empty() ? NULL : &vertexBuffers[0];
+			desc.numVertexBuffers = packet.numVertexBuffers;
+			desc.indexBuffer = findObject(mIndexBuffers, packet.indexBuffer);
+			desc.boneBuffer = findObject(mBoneBuffers, packet.boneBuffer);
+			desc.spriteBuffer = findObject(mSpriteBuffers, packet.spriteBuffer);
+			desc.firstVertex = packet.ranges[ResourceRanges::FIRST_VERTEX];
+			desc.numVerts = packet.ranges[ResourceRanges::NUM_VERTS];
+			desc.firstIndex = packet.ranges[ResourceRanges::FIRST_INDEX];
+			desc.numIndices = packet.ranges[ResourceRanges::NUM_INDICES];
+			desc.firstBone = packet.ranges[ResourceRanges::FIRST_BONE];
+			desc.numBones = packet.ranges[ResourceRanges::NUM_BONES];
+			desc.firstSprite = packet.ranges[ResourceRanges::FIRST_SPRITE];
+			desc.numSprites = packet.ranges[ResourceRanges::NUM_SPRITES];
+			desc.material = resolveMaterial(packet.material);
+			desc.submeshIndex = packet.submeshIndex;
+			desc.cullMode = physx::apex::NxRenderCullMode::Enum(packet.cullMode);
+			desc.primitives = physx::apex::NxRenderPrimitiveType::Enum(packet.primitives);
+
+			Resource resource;
+			memcpy(resource.ranges, packet.ranges, sizeof(resource.ranges));
+			resource.material = packet.material;
+
+			timer.getElapsedSeconds();
+			resource.resource = mRrm.createResource(desc);
+			category = &frame.create;
+
+			if (resource.resource != NULL)
+			{
+				mResources[packet.id] = resource;
+			}
+			break;
+		}
+		case RecordingPacket::WRITE_VERTEX_BUFFER:
+		case RecordingPacket::WRITE_INDEX_BUFFER:
+		case RecordingPacket::WRITE_BONE_BUFFER:
+		case RecordingPacket::WRITE_SPRITE_BUFFER:
+		{
+			WriteBufferPacket packet;
+			valid = mStream->read(&packet, sizeof(packet)) && readBufferData(packet.numSemantics, packet.hasData != 0, packet.count);
+			if (!valid)
+			{
+				break;
+			}
+
+			physx::apex::NxApexRenderVertexBufferData vertexData;
+			physx::apex::NxApexRenderBoneBufferData boneData;
+			physx::apex::NxApexRenderSpriteBufferData spriteData;
+			vertexData.moduleId = packet.moduleId;
+			spriteData.moduleId = packet.moduleId;
+
+			const char* data = &mScratch[0];
+			for (physx::PxU32 i = 0; i < packet.numSemantics; i++)
+			{
+				const physx::PxU32 semantic = mSemantics[i * 4 + 0];
+				const physx::apex::NxRenderDataFormat::Enum format = physx::apex::NxRenderDataFormat::Enum(mSemantics[i * 4 + 1]);
+				const physx::apex::NxRenderDataFormat::Enum srcFormat = physx::apex::NxRenderDataFormat::Enum(mSemantics[i * 4 + 2]);
+				const physx::PxU32 elementSize = mSemantics[i * 4 + 3];
+
+				if (header.type == RecordingPacket::WRITE_VERTEX_BUFFER)
+				{
+					vertexData.setSemanticData(physx::apex::NxRenderVertexSemantic::Enum(semantic), data, elementSize, format, srcFormat);
+				}
+				else if (header.type == RecordingPacket::WRITE_BONE_BUFFER)
+				{
+					boneData.setSemanticData(physx::apex::NxRenderBoneSemantic::Enum(semantic), data, elementSize, format, srcFormat);
+				}
+				else if (header.type == RecordingPacket::WRITE_SPRITE_BUFFER)
+				{
+					spriteData.setSemanticData(physx::apex::NxRenderSpriteSemantic::Enum(semantic), data, elementSize, format, srcFormat);
+				}
+				frame.numBytesWritten += elementSize * packet.count;
+				data += elementSize * packet.count;
+			}
+
+			timer.getElapsedSeconds();
+			if (header.type == RecordingPacket::WRITE_VERTEX_BUFFER)
+			{
+				physx::apex::NxUserRenderVertexBuffer* buffer = findObject(mVertexBuffers, packet.id);
+				if (buffer != NULL)
+				{
+					buffer->writeBuffer(vertexData, packet.first, packet.count);
+				}
+			}
+			else if (header.type == RecordingPacket::WRITE_INDEX_BUFFER)
+			{
+				physx::apex::NxUserRenderIndexBuffer* buffer = findObject(mIndexBuffers, packet.id);
+				if (buffer != NULL && packet.numSemantics == 1)
+				{
+					buffer->writeBuffer(&mScratch[0], mSemantics[3], packet.first, packet.count);
+				}
+			}
+			else if (header.type == RecordingPacket::WRITE_BONE_BUFFER)
+			{
+				physx::apex::NxUserRenderBoneBuffer* buffer = findObject(mBoneBuffers, packet.id);
+				if (buffer != NULL)
+				{
+					buffer->writeBuffer(boneData, packet.first, packet.count);
+				}
+			}
+			else
+			{
+				physx::apex::NxUserRenderSpriteBuffer* buffer = findObject(mSpriteBuffers, packet.id);
+				if (buffer != NULL)
+				{
+					buffer->writeBuffer(spriteData, packet.first, packet.count);
+				}
+			}
+			category = &frame.write;
+			break;
+		}
+		case RecordingPacket::RENDER_RESOURCE:
+		{
+			RenderResourcePacket packet;
+			valid = mStream->read(&packet, sizeof(packet));
+
+			std::map<physx::PxU32, Resource>::iterator it = mResources.find(packet.id);
+			if (!valid || it == mResources.end())
+			{
+				break;
+			}
+
+			Resource& resource = it->second;
+			physx::apex::NxUserRenderResource* renderResource = resource.resource;
+			const physx::PxU32* ranges = packet.ranges;
+
+			timer.getElapsedSeconds();
+			if (ranges[ResourceRanges::FIRST_VERTEX] != resource.ranges[ResourceRanges::FIRST_VERTEX] || ranges[ResourceRanges::NUM_VERTS] != resource.ranges[ResourceRanges::NUM_VERTS])
+			{
+				renderResource->setVertexBufferRange(ranges[ResourceRanges::FIRST_VERTEX], ranges[ResourceRanges::NUM_VERTS]);
+			}
+			if (ranges[ResourceRanges::FIRST_INDEX] != resource.ranges[ResourceRanges::FIRST_INDEX] || ranges[ResourceRanges::NUM_INDICES] != resource.ranges[ResourceRanges::NUM_INDICES])
+			{
+				renderResource->setIndexBufferRange(ranges[ResourceRanges::FIRST_INDEX], ranges[ResourceRanges::NUM_INDICES]);
+			}
+			if (ranges[ResourceRanges::FIRST_BONE] != resource.ranges[ResourceRanges::FIRST_BONE] || ranges[ResourceRanges::NUM_BONES] != resource.ranges[ResourceRanges::NUM_BONES])
+			{
+				renderResource->setBoneBufferRange(ranges[ResourceRanges::FIRST_BONE], ranges[ResourceRanges::NUM_BONES]);
+			}
+			if (ranges[ResourceRanges::FIRST_SPRITE] != resource.ranges[ResourceRanges::FIRST_SPRITE] || ranges[ResourceRanges::NUM_SPRITES] != resource.ranges[ResourceRanges::NUM_SPRITES])
+			{
+				renderResource->setSpriteBufferRange(ranges[ResourceRanges::FIRST_SPRITE], ranges[ResourceRanges::NUM_SPRITES]);
+			}
+			if (packet.material != resource.material)
+			{
+				renderResource->setMaterial(resolveMaterial(packet.material));
+			}
+
+			if (mRenderer != NULL)
+			{
+				physx::apex::NxApexRenderContext context;
+				context.renderResource = renderResource;
+				context.isScreenSpace = packet.isScreenSpace != 0;
+				context.local2world = physx::PxMat44(packet.local2world);
+				context.world2local = physx::PxMat44(packet.world2local);
+				mRenderer->renderResource(context);
+			}
+			category = &frame.render;
+
+			memcpy(resource.ranges, ranges, sizeof(resource.ranges));
+			resource.material = packet.material;
+			break;
+		}
+		case RecordingPacket::RELEASE_VERTEX_BUFFER:
+		case RecordingPacket::RELEASE_INDEX_BUFFER:
+		case RecordingPacket::RELEASE_BONE_BUFFER:
+		case RecordingPacket::RELEASE_SPRITE_BUFFER:
+		case RecordingPacket::RELEASE_RESOURCE:
+		{
+			physx::PxU32 id;
+			valid = mStream->read(&id, sizeof(id));
+
+			timer.getElapsedSeconds();
+			if (header.type == RecordingPacket::RELEASE_VERTEX_BUFFER)
+			{
+				physx::apex::NxUserRenderVertexBuffer* buffer = removeObject(mVertexBuffers, id);
+				if (buffer != NULL)
+				{
+					mRrm.releaseVertexBuffer(*buffer);
+				}
+			}
+			else if (header.type == RecordingPacket::RELEASE_INDEX_BUFFER)
+			{
+				physx::apex::NxUserRenderIndexBuffer* buffer = removeObject(mIndexBuffers, id);
+				if (buffer != NULL)
+				{
+					mRrm.releaseIndexBuffer(*buffer);
+				}
+			}
+			else if (header.type == RecordingPacket::RELEASE_BONE_BUFFER)
+			{
+				physx::apex::NxUserRenderBoneBuffer* buffer = removeObject(mBoneBuffers, id);
+				if (buffer != NULL)
+				{
+					mRrm.releaseBoneBuffer(*buffer);
+				}
+			}
+			else if (header.type == RecordingPacket::RELEASE_SPRITE_BUFFER)
+			{
+				physx::apex::NxUserRenderSpriteBuffer* buffer = removeObject(mSpriteBuffers, id);
+				if (buffer != NULL)
+				{
+					mRrm.releaseSpriteBuffer(*buffer);
+				}
+			}
+			else
+			{
+				std::map<physx::PxU32, Resource>::iterator it = mResources.find(id);
+				if (it != mResources.end())
+				{
+					mRrm.releaseResource(*it->second.resource);
+					mResources.erase(it);
+				}
+			}
+			category = &frame.release;
+			break;
+		}
+		case RecordingPacket::END_FRAME:
+			valid = mStream->skip(header.size);
+			endOfFrame = true;
+			mFrame++;
+			break;
+		default:
+			// MAX_BONES_FOR_MATERIAL is informational, unknown packets come from newer recordings
+			valid = mStream->skip(header.size);
+			break;
+		}
+
+		if (category != NULL)
+		{
+			*category += timer.getElapsedSeconds();
+			frame.numCalls++;
+		}
+
+		if (!valid)
+		{
+			endOfFrame = false;
+			break;
+		}
+	}
+
+	if (timings != NULL)
+	{
+		*timings = frame;
+	}
+
+	return endOfFrame;
+}
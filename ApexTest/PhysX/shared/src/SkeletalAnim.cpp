@@ -34,6 +34,7 @@
 
 #include "SkeletalAnim.h"
 #include "TriangleMesh.h"
+#include "WorkerPool.h"
 #include "NxFromPx.h"
 #include <NxApexRenderDebug.h>
 
@@ -92,7 +93,60 @@ void SkeletalAnimation::clear()
 };
 
 // -------------------------------------------------------------------
-SkeletalAnim::SkeletalAnim()
+void CompiledAnimation::clear()
+{
+	trackFirstKey.clear();
+	trackNumKeys.clear();
+	times.clear();
+	rotations.clear();
+	translations.clear();
+	scales.clear();
+}
+
+// -------------------------------------------------------------------
+SkeletalAnimInstance::SkeletalAnimInstance()
+{
+	clear();
+}
+
+// -------------------------------------------------------------------
+void SkeletalAnimInstance::clear()
+{
+	animNr = -1;
+	time = 0.0f;
+	lockRootbone = false;
+	skinningMatrices.clear();
+	skinningMatricesWorld.clear();
+	cursorAnimNr = -1;
+	keyCursors.clear();
+	worldPoses.clear();
+}
+
+// -------------------------------------------------------------------
+// evaluates one instance per job item
+class SkeletalAnimJob : public WorkerPool::Job
+{
+public:
+	SkeletalAnimJob(const SkeletalAnim& anim, SkeletalAnimInstance* instances) : mAnim(anim), mInstances(instances) {}
+
+	virtual void execute(physx::PxU32 item)
+	{
+		mAnim.evaluateInstance(mInstances[item]);
+	}
+
+private:
+	SkeletalAnimJob& operator=(const SkeletalAnimJob&);
+
+	const SkeletalAnim& mAnim;
+	SkeletalAnimInstance* mInstances;
+};
+
+// only batches with at least this many instances are distributed over the worker threads
+static const physx::PxU32 PARALLEL_INSTANCES = 4;
+
+// -------------------------------------------------------------------
+SkeletalAnim::SkeletalAnim() :
+	mWorkers(NULL)
 {
 	clear();
 }
@@ -101,6 +155,11 @@ SkeletalAnim::SkeletalAnim()
 SkeletalAnim::~SkeletalAnim()
 {
 	clear();
+
+	if (mWorkers != NULL)
+	{
+		WorkerPool::release(mWorkers);
+	}
 }
 
 // -------------------------------------------------------------------
@@ -127,6 +186,13 @@ void SkeletalAnim::clear()
 	mSkinningMatricesWorld.clear();
 	mSkinningMatricesWorld.resize(0);
 
+	mCompiledAnimations.clear();
+	mEvalOrder.clear();
+	mAnimationsCompiled = false;
+	mCursorAnimNr = -1;
+	mKeyCursors.clear();
+	mWorldPoses.clear();
+
 	mParent = NULL;
 }
 
@@ -144,90 +210,82 @@ int SkeletalAnim::findBone(const std::string& name)
 }
 
 // -------------------------------------------------------------------
-void SkeletalAnim::interpolateBonePose(int animNr, int boneNr, float time, physx::PxMat34Legacy& pose, physx::PxVec3& scale)
+static void sampleTrack(const CompiledAnimation& anim, int boneNr, float time, physx::PxU32& keyCursor, physx::PxMat34Legacy& pose)
 {
-	// the default
-	pose.id();
-	scale = physx::PxVec3(1.0f, 1.0f, 1.0f);
-
-	const std::vector<SkeletalAnimation*>& animations = mParent == NULL ? mAnimations : mParent->mAnimations;
-	const std::vector<BoneKeyFrame>& keyFrames = mParent == NULL ? mKeyFrames : mParent->mKeyFrames;
-
-	if (animNr < 0 || animNr >= (int)animations.size())
-	{
-		return;
-	}
-	if (boneNr < 0 || boneNr >= (int)animations[animNr]->mBoneTracks.size())
+	const physx::PxU32 numKeys = anim.trackNumKeys[boneNr];
+	if (numKeys == 0)
 	{
+		pose.id();
 		return;
 	}
 
-	BoneTrack& t = animations[animNr]->mBoneTracks[boneNr];
-	if (t.numFrames == 0)
-	{
-		return;
-	}
+	const physx::PxU32 firstKey = anim.trackFirstKey[boneNr];
+	const float* times = &anim.times[firstKey];
 
 	// special cases
-	int frameNr = -1;
-	if (t.numFrames == 1)
-	{
-		frameNr = t.firstFrame;
-	}
-	else if (time <= keyFrames[t.firstFrame].time)
+	physx::PxU32 key = 0;
+	if (numKeys == 1 || time <= times[0])
 	{
-		frameNr = t.firstFrame;
+		key = 0;
 	}
-	else if (time >= keyFrames[t.firstFrame + t.numFrames - 1].time)
+	else if (time >= times[numKeys - 1])
 	{
-		frameNr = t.firstFrame + t.numFrames - 1;
+		key = numKeys - 1;
 	}
-
-	if (frameNr >= 0)
-	{
-		pose = keyFrames[frameNr].relPose;
-		scale = keyFrames[frameNr].scale;
-		return;
-	}
-	// binary search
-	int l = t.firstFrame;
-	int r = t.firstFrame + t.numFrames - 1;
-	while (r > l + 1)
+	else
 	{
-		int m = (l + r) / 2;
-		if (keyFrames[m].time == time)
+		// find l with times[l] <= time < times[l + 1], starting at the pair of the last call
+		physx::PxU32 l = keyCursor < numKeys - 1 ? keyCursor : 0;
+		physx::PxU32 lo = 0;
+		physx::PxU32 hi = numKeys - 1;
+		if (times[l] > time)
 		{
-			pose = keyFrames[m].relPose;
-			scale = keyFrames[m].scale;
-			return;
+			hi = l;
 		}
-		else if (keyFrames[m].time > time)
+		else
 		{
-			r = m;
+			for (physx::PxU32 steps = 0; steps < 4 && times[l + 1] <= time; steps++)
+			{
+				l++;
+			}
+			lo = l;
 		}
-		else
+
+		if (times[lo + 1] <= time)
 		{
-			l = m;
+			// binary search
+			while (hi > lo + 1)
+			{
+				const physx::PxU32 m = (lo + hi) / 2;
+				if (times[m] <= time)
+				{
+					lo = m;
+				}
+				else
+				{
+					hi = m;
+				}
+			}
 		}
-	}
-	float dt = keyFrames[r].time - keyFrames[l].time;
-	// avoid singular case
-	if (dt == 0.0f)
-	{
-		pose = keyFrames[l].relPose;
-		scale = keyFrames[l].scale;
-	}
+		l = lo;
+		keyCursor = l;
 
-	// interpolation
-	float sr = (time - keyFrames[l].time) / dt;
-	float sl = 1.0f - sr;
+		if (times[l] < time)
+		{
+			// interpolation
+			const physx::PxU32 r = firstKey + l + 1;
+			const float sr = (time - times[l]) / (times[l + 1] - times[l]);
+			const float sl = 1.0f - sr;
+
+			pose.t = anim.translations[r - 1] * sl + anim.translations[r] * sr;
+			pose.M.fromQuat(physx::slerp(sr, anim.rotations[r - 1], anim.rotations[r]));
+			return;
+		}
+		key = l;
+	}
 
-	scale = keyFrames[l].scale * sl + keyFrames[r].scale * sr;
-	pose.t = keyFrames[l].relPose.t * sl + keyFrames[r].relPose.t * sr;
-	physx::PxQuat ql = physx::PxQuat(keyFrames[l].relPose.M);
-	physx::PxQuat qr = physx::PxQuat(keyFrames[r].relPose.M);
-	physx::PxQuat q = physx::slerp(sr, ql, qr);
-	pose.M.fromQuat(q);
+	pose.t = anim.translations[firstKey + key];
+	pose.M.fromQuat(anim.rotations[firstKey + key]);
 }
 
 // -------------------------------------------------------------------
@@ -248,21 +306,23 @@ void SkeletalAnim::setAnimPose(int animNr, float time, bool lockRootbone /* = fa
 {
 	if (animNr >= 0)
 	{
-		for (physx::PxU32 i = 0; i < mBones.size(); i++)
+		if (mBones.empty())
 		{
-			if (mBones[i].parent < 0)
-			{
-				setAnimPoseRec(animNr, i, time, lockRootbone);
-			}
+			return;
+		}
+
+		if (!mAnimationsCompiled)
+		{
+			compileAnimations();
 		}
 
 		PX_ASSERT(mBones.size() == mSkinningMatrices.size());
 		PX_ASSERT(mBones.size() == mSkinningMatricesWorld.size());
+		evaluatePose(animNr, time, lockRootbone, mCursorAnimNr, &mKeyCursors[0], &mWorldPoses[0], &mSkinningMatrices[0], &mSkinningMatricesWorld[0]);
+
 		for (physx::PxU32 i = 0; i < mBones.size(); i++)
 		{
-			SkeletalBone& b = mBones[i];
-			mSkinningMatrices[i] = b.currentWorldPose * b.invBindWorldPose;
-			mSkinningMatricesWorld[i] = b.currentWorldPose;
+			mBones[i].currentWorldPose = mWorldPoses[i];
 		}
 	}
 	else
@@ -338,17 +398,106 @@ void SkeletalAnim::setBoneCollision(physx::PxU32 boneNr, int option)
 }
 
 // -------------------------------------------------------------------
-void SkeletalAnim::setAnimPoseRec(int animNr, int boneNr, float time, bool lockBoneTranslation)
+void SkeletalAnim::compileAnimations()
 {
-	SkeletalBone& b = mBones[boneNr];
+	const std::vector<SkeletalAnimation*>& animations = getAnimations();
+	const std::vector<BoneKeyFrame>& keyFrames = mParent == NULL ? mKeyFrames : mParent->mKeyFrames;
+	const std::vector<int>& children = mParent == NULL ? mChildren : mParent->mChildren;
+	const physx::PxU32 numBones = (physx::PxU32)mBones.size();
 
+	mCompiledAnimations.resize(animations.size());
+	for (physx::PxU32 a = 0; a < animations.size(); a++)
 	{
-		physx::PxMat34Legacy keyPose;
-		physx::PxVec3 keyScale;
+		const SkeletalAnimation& anim = *animations[a];
+		CompiledAnimation& c = mCompiledAnimations[a];
+		c.clear();
+		c.trackFirstKey.resize(numBones, 0);
+		c.trackNumKeys.resize(numBones, 0);
 
-		// query the first frame instead of the current one if you want to lock this bone
-		float myTime = (lockBoneTranslation && b.isRootLock) ? 0.0f : time;
-		interpolateBonePose(animNr, boneNr, myTime, keyPose, keyScale);
+		for (physx::PxU32 boneNr = 0; boneNr < numBones && boneNr < anim.mBoneTracks.size(); boneNr++)
+		{
+			const BoneTrack& t = anim.mBoneTracks[boneNr];
+			if (t.numFrames <= 0)
+			{
+				continue;
+			}
+
+			c.trackFirstKey[boneNr] = (physx::PxU32)c.times.size();
+			c.trackNumKeys[boneNr] = (physx::PxU32)t.numFrames;
+			for (int k = t.firstFrame; k < t.firstFrame + t.numFrames; k++)
+			{
+				const BoneKeyFrame& frame = keyFrames[k];
+				c.times.push_back(frame.time);
+				c.rotations.push_back(physx::PxQuat(frame.relPose.M));
+				c.translations.push_back(frame.relPose.t);
+				c.scales.push_back(frame.scale);
+			}
+		}
+	}
+
+	// parents first, so the world poses can be built in a single pass
+	mEvalOrder.clear();
+	for (physx::PxU32 i = 0; i < numBones; i++)
+	{
+		if (mBones[i].parent < 0)
+		{
+			mEvalOrder.push_back((int)i);
+		}
+	}
+	for (physx::PxU32 i = 0; i < mEvalOrder.size(); i++)
+	{
+		const SkeletalBone& b = mBones[mEvalOrder[i]];
+		for (int c = b.firstChild; c < b.firstChild + b.numChildren; c++)
+		{
+			mEvalOrder.push_back(children[c]);
+		}
+	}
+
+	mCursorAnimNr = -1;
+	mKeyCursors.resize(numBones, 0);
+	mWorldPoses.resize(numBones);
+	for (physx::PxU32 i = 0; i < numBones; i++)
+	{
+		mWorldPoses[i] = mBones[i].currentWorldPose;
+	}
+
+	mAnimationsCompiled = true;
+}
+
+// -------------------------------------------------------------------
+void SkeletalAnim::evaluatePose(int animNr, float time, bool lockBoneTranslation, int& cursorAnimNr, physx::PxU32* keyCursors,
+                                physx::PxMat34Legacy* worldPoses, physx::PxMat44* skinningMatrices, physx::PxMat44* skinningMatricesWorld) const
+{
+	PX_ASSERT(mAnimationsCompiled);
+
+	const CompiledAnimation* anim = animNr < (int)mCompiledAnimations.size() ? &mCompiledAnimations[animNr] : NULL;
+	const physx::PxU32 numBones = (physx::PxU32)mBones.size();
+
+	if (cursorAnimNr != animNr)
+	{
+		for (physx::PxU32 i = 0; i < numBones; i++)
+		{
+			keyCursors[i] = 0;
+		}
+		cursorAnimNr = animNr;
+	}
+
+	for (physx::PxU32 i = 0; i < mEvalOrder.size(); i++)
+	{
+		const int boneNr = mEvalOrder[i];
+		const SkeletalBone& b = mBones[boneNr];
+
+		physx::PxMat34Legacy keyPose;
+		if (anim != NULL)
+		{
+			// query the first frame instead of the current one if you want to lock this bone
+			const float myTime = (lockBoneTranslation && b.isRootLock) ? 0.0f : time;
+			sampleTrack(*anim, boneNr, myTime, keyCursors[boneNr], keyPose);
+		}
+		else
+		{
+			keyPose.id();
+		}
 
 		// todo: consider scale
 		physx::PxMat34Legacy combinedPose;
@@ -357,18 +506,86 @@ void SkeletalAnim::setAnimPoseRec(int animNr, int boneNr, float time, bool lockB
 
 		if (b.parent < 0)
 		{
-			b.currentWorldPose = combinedPose;
+			worldPoses[boneNr] = combinedPose;
 		}
 		else
 		{
-			b.currentWorldPose = mBones[b.parent].currentWorldPose * combinedPose;
+			worldPoses[boneNr] = worldPoses[b.parent] * combinedPose;
 		}
 	}
 
-	const int* children = mParent == NULL ? &mChildren[0] : &mParent->mChildren[0];
-	for (int i = b.firstChild; i < b.firstChild + b.numChildren; i++)
+	for (physx::PxU32 i = 0; i < numBones; i++)
 	{
-		setAnimPoseRec(animNr, children[i], time, lockBoneTranslation);
+		skinningMatrices[i] = worldPoses[i] * mBones[i].invBindWorldPose;
+		skinningMatricesWorld[i] = worldPoses[i];
+	}
+}
+
+// -------------------------------------------------------------------
+void SkeletalAnim::evaluateInstance(SkeletalAnimInstance& instance) const
+{
+	if (instance.animNr >= 0)
+	{
+		evaluatePose(instance.animNr, instance.time, instance.lockRootbone, instance.cursorAnimNr, &instance.keyCursors[0],
+		             &instance.worldPoses[0], &instance.skinningMatrices[0], &instance.skinningMatricesWorld[0]);
+	}
+	else
+	{
+		for (physx::PxU32 i = 0; i < mBones.size(); i++)
+		{
+			instance.skinningMatrices[i] = physx::PxMat44::createIdentity();
+			instance.skinningMatricesWorld[i] = mBones[i].bindWorldPose;
+		}
+	}
+}
+
+// -------------------------------------------------------------------
+void SkeletalAnim::evaluateInstances(SkeletalAnimInstance* instances, physx::PxU32 numInstances)
+{
+	const physx::PxU32 numBones = (physx::PxU32)mBones.size();
+	if (numBones == 0 || numInstances == 0)
+	{
+		return;
+	}
+
+	if (!mAnimationsCompiled)
+	{
+		compileAnimations();
+	}
+
+	for (physx::PxU32 i = 0; i < numInstances; i++)
+	{
+		SkeletalAnimInstance& instance = instances[i];
+		if (instance.worldPoses.size() != numBones)
+		{
+			instance.cursorAnimNr = -1;
+			instance.keyCursors.resize(numBones, 0);
+			instance.worldPoses.resize(numBones);
+			for (physx::PxU32 j = 0; j < numBones; j++)
+			{
+				instance.worldPoses[j] = mBones[j].bindWorldPose;
+			}
+			instance.skinningMatrices.resize(numBones);
+			instance.skinningMatricesWorld.resize(numBones);
+		}
+	}
+
+	if (numInstances >= PARALLEL_INSTANCES && mWorkers == NULL)
+	{
+		mWorkers = WorkerPool::acquire();
+	}
+
+	if (mWorkers != NULL && numInstances >= PARALLEL_INSTANCES)
+	{
+		SkeletalAnimJob job(*this, instances);
+		mWorkers->run(job, numInstances);
+	}
+	else
+	{
+		for (physx::PxU32 i = 0; i < numInstances; i++)
+		{
+			evaluateInstance(instances[i]);
+		}
 	}
 }
 
@@ -823,6 +1040,7 @@ bool SkeletalAnim::loadFromParent(const SkeletalAnim* parent)
 	}
 
 	mParent = parent;
+	mAnimationsCompiled = false;
 
 	mBones.resize(mParent->mBones.size());
 	physx::PxMat34Legacy matId;
@@ -936,6 +1154,8 @@ bool SkeletalAnim::saveToXML(const std::string& xmlFile) const
 // -------------------------------------------------------------------
 void SkeletalAnim::init(bool firstTime)
 {
+	mAnimationsCompiled = false;
+
 	if (firstTime)
 	{
 		setupConnectivity();
@@ -0,0 +1,347 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+#include "SkinningEngine.h"
+
+#include "WorkerPool.h"
+
+#if defined(PX_X86) || defined(PX_X64)
+#define SKINNING_SIMD 1
+#include <emmintrin.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+#else
+#define SKINNING_SIMD 0
+#endif
+
+namespace Samples
+{
+
+// ---------------------------------------------------------------------------
+class SkinningJob : public WorkerPool::Job
+{
+public:
+	SkinningJob(const SkinningEngine& engine, const physx::PxVec3* positions, const physx::PxVec3* normals, physx::PxVec3* destPositions, physx::PxVec3* destNormals) :
+		mEngine(engine), mPositions(positions), mNormals(normals), mDestPositions(destPositions), mDestNormals(destNormals)
+	{
+	}
+
+	virtual void execute(physx::PxU32 item)
+	{
+		mEngine.skinChunk(mEngine.mChunks[item], mPositions, mNormals, mDestPositions, mDestNormals);
+	}
+
+private:
+	SkinningJob& operator=(const SkinningJob&);
+
+	const SkinningEngine& mEngine;
+	const physx::PxVec3* mPositions;
+	const physx::PxVec3* mNormals;
+	physx::PxVec3* mDestPositions;
+	physx::PxVec3* mDestNormals;
+};
+
+
+
+// ---------------------------------------------------------------------------
+// Kernels. The bone matrices of a vertex are blended first, then position and normal are
+// transformed once, which is the same sum as transforming per bone up to rounding.
+namespace
+{
+
+#if SKINNING_SIMD
+
+PX_FORCE_INLINE void storeVec3(physx::PxVec3& dest, __m128 v)
+{
+	_mm_storel_pi(reinterpret_cast<__m64*>(&dest.x), v);
+	_mm_store_ss(&dest.z, _mm_movehl_ps(v, v));
+}
+
+// matches n * (1.0f / sqrtf(n.magnitudeSquared())) of the scalar path
+PX_FORCE_INLINE __m128 normalize3(__m128 n)
+{
+	const __m128 sq = _mm_mul_ps(n, n);
+	const __m128 len2 = _mm_add_ss(_mm_add_ss(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 2, 2, 2)));
+	const __m128 recip = _mm_div_ss(_mm_set_ss(1.0f), _mm_sqrt_ss(len2));
+	return _mm_mul_ps(n, _mm_shuffle_ps(recip, recip, _MM_SHUFFLE(0, 0, 0, 0)));
+}
+
+template<physx::PxU32 NB>
+PX_FORCE_INLINE void blendSSE(const physx::PxMat44* bones, const physx::PxU16* boneIndices, const float* weights, __m128& c0, __m128& c1, __m128& c2, __m128& c3)
+{
+	const physx::PxMat44& m0 = bones[boneIndices[0]];
+	const __m128 w0 = _mm_set1_ps(weights[0]);
+	c0 = _mm_mul_ps(_mm_loadu_ps(&m0.column0.x), w0);
+	c1 = _mm_mul_ps(_mm_loadu_ps(&m0.column1.x), w0);
+	c2 = _mm_mul_ps(_mm_loadu_ps(&m0.column2.x), w0);
+	c3 = _mm_mul_ps(_mm_loadu_ps(&m0.column3.x), w0);
+
+	for (physx::PxU32 k = 1; k < NB; k++)
+	{
+		const physx::PxMat44& m = bones[boneIndices[k]];
+		const __m128 w = _mm_set1_ps(weights[k]);
+		c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(&m.column0.x), w));
+		c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(&m.column1.x), w));
+		c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(&m.column2.x), w));
+		c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(&m.column3.x), w));
+	}
+}
+
+template<physx::PxU32 NB>
+void skinBatch(const SkinningEngine::Batch& batch, physx::PxU32 first, physx::PxU32 count, const physx::PxMat44* bones,
+               const physx::PxVec3* positions, const physx::PxVec3* normals, physx::PxVec3* destPositions, physx::PxVec3* destNormals)
+{
+	const physx::PxU32* vertices = &batch.vertices[first];
+	const physx::PxU16* boneIndices = &batch.bones[first * NB];
+	const float* weights = &batch.weights[first * NB];
+
+	physx::PxU32 i = 0;
+
+#if defined(__AVX__)
+	// two vertices per iteration, one in each 128 bit half
+	for (; i + 1 < count; i += 2)
+	{
+		__m128 a0, a1, a2, a3, b0, b1, b2, b3;
+		blendSSE<NB>(bones, boneIndices, weights, a0, a1, a2, a3);
+		blendSSE<NB>(bones, boneIndices + NB, weights + NB, b0, b1, b2, b3);
+		const __m256 c0 = _mm256_insertf128_ps(_mm256_castps128_ps256(a0), b0, 1);
+		const __m256 c1 = _mm256_insertf128_ps(_mm256_castps128_ps256(a1), b1, 1);
+		const __m256 c2 = _mm256_insertf128_ps(_mm256_castps128_ps256(a2), b2, 1);
+		const __m256 c3 = _mm256_insertf128_ps(_mm256_castps128_ps256(a3), b3, 1);
+
+		const physx::PxVec3& pa = positions[vertices[i]];
+		const physx::PxVec3& pb = positions[vertices[i + 1]];
+		const physx::PxVec3& na = normals[vertices[i]];
+		const physx::PxVec3& nb = normals[vertices[i + 1]];
+
+		const __m256 p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c0, _mm256_setr_ps(pa.x, pa.x, pa.x, pa.x, pb.x, pb.x, pb.x, pb.x)),
+		                                             _mm256_mul_ps(c1, _mm256_setr_ps(pa.y, pa.y, pa.y, pa.y, pb.y, pb.y, pb.y, pb.y))),
+		                               _mm256_add_ps(_mm256_mul_ps(c2, _mm256_setr_ps(pa.z, pa.z, pa.z, pa.z, pb.z, pb.z, pb.z, pb.z)), c3));
+		const __m256 n = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c0, _mm256_setr_ps(na.x, na.x, na.x, na.x, nb.x, nb.x, nb.x, nb.x)),
+		                                             _mm256_mul_ps(c1, _mm256_setr_ps(na.y, na.y, na.y, na.y, nb.y, nb.y, nb.y, nb.y))),
+		                               _mm256_mul_ps(c2, _mm256_setr_ps(na.z, na.z, na.z, na.z, nb.z, nb.z, nb.z, nb.z)));
+
+		const __m256 sq = _mm256_mul_ps(n, n);
+		const __m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_permute_ps(sq, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_permute_ps(sq, _MM_SHUFFLE(1, 1, 1, 1))),
+		                                  _mm256_permute_ps(sq, _MM_SHUFFLE(2, 2, 2, 2)));
+		const __m256 nn = _mm256_mul_ps(n, _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(len2)));
+
+		storeVec3(destPositions[vertices[i]], _mm256_castps256_ps128(p));
+		storeVec3(destPositions[vertices[i + 1]], _mm256_extractf128_ps(p, 1));
+		storeVec3(destNormals[vertices[i]], _mm256_castps256_ps128(nn));
+		storeVec3(destNormals[vertices[i + 1]], _mm256_extractf128_ps(nn, 1));
+
+		boneIndices += 2 * NB;
+		weights += 2 * NB;
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		__m128 c0, c1, c2, c3;
+		blendSSE<NB>(bones, boneIndices, weights, c0, c1, c2, c3);
+
+		const physx::PxU32 v = vertices[i];
+		const physx::PxVec3& p = positions[v];
+		const physx::PxVec3& n = normals[v];
+
+		const __m128 sp = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p.x)), _mm_mul_ps(c1, _mm_set1_ps(p.y))),
+		                             _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(p.z)), c3));
+		const __m128 sn = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(n.x)), _mm_mul_ps(c1, _mm_set1_ps(n.y))),
+		                             _mm_mul_ps(c2, _mm_set1_ps(n.z)));
+
+		storeVec3(destPositions[v], sp);
+		storeVec3(destNormals[v], normalize3(sn));
+
+		boneIndices += NB;
+		weights += NB;
+	}
+}
+
+#else // SKINNING_SIMD
+
+template<physx::PxU32 NB>
+void skinBatch(const SkinningEngine::Batch& batch, physx::PxU32 first, physx::PxU32 count, const physx::PxMat44* bones,
+               const physx::PxVec3* positions, const physx::PxVec3* normals, physx::PxVec3* destPositions, physx::PxVec3* destNormals)
+{
+	const physx::PxU32* vertices = &batch.vertices[first];
+	const physx::PxU16* boneIndices = &batch.bones[first * NB];
+	const float* weights = &batch.weights[first * NB];
+
+	for (physx::PxU32 i = 0; i < count; i++)
+	{
+		physx::PxMat44 m = bones[boneIndices[0]] * weights[0];
+		for (physx::PxU32 k = 1; k < NB; k++)
+		{
+			const physx::PxMat44& b = bones[boneIndices[k]];
+			m.column0 += b.column0 * weights[k];
+			m.column1 += b.column1 * weights[k];
+			m.column2 += b.column2 * weights[k];
+			m.column3 += b.column3 * weights[k];
+		}
+
+		const physx::PxU32 v = vertices[i];
+		destPositions[v] = m.transform(positions[v]);
+		const physx::PxVec3 n = m.rotate(normals[v]);
+		destNormals[v] = n * physx::recipSqrtFast(n.magnitudeSquared());
+
+		boneIndices += NB;
+		weights += NB;
+	}
+}
+
+#endif // SKINNING_SIMD
+
+}
+
+
+
+// ---------------------------------------------------------------------------
+SkinningEngine::SkinningEngine() :
+	mNumVertices(0),
+	mVersion(0xffffffff),
+	mWorkers(NULL)
+{
+}
+
+
+
+SkinningEngine::~SkinningEngine()
+{
+	if (mWorkers != NULL)
+	{
+		WorkerPool::release(mWorkers);
+	}
+}
+
+
+
+void SkinningEngine::setup(physx::PxU32 numVertices, const physx::PxU16* boneIndices, const physx::PxVec4* boneWeights, const physx::PxU32* numBoneWeights)
+{
+	for (physx::PxU32 b = 0; b < 4; b++)
+	{
+		mBatches[b].vertices.clear();
+		mBatches[b].bones.clear();
+		mBatches[b].weights.clear();
+	}
+
+	// vertices keep their mesh order inside a batch, so the scattered writes stay mostly sequential
+	for (physx::PxU32 i = 0; i < numVertices; i++)
+	{
+		const physx::PxU32 numInfluences = ((numBoneWeights[i / 16] >> ((i % 16) * 2)) & 0x3) + 1;
+		Batch& batch = mBatches[numInfluences - 1];
+
+		batch.vertices.push_back(i);
+		for (physx::PxU32 k = 0; k < numInfluences; k++)
+		{
+			PX_ASSERT(boneWeights[i][k] > 0.0f);
+			batch.bones.push_back(boneIndices[i * 4 + k]);
+			batch.weights.push_back(boneWeights[i][k]);
+		}
+	}
+
+	mChunks.clear();
+	for (physx::PxU32 b = 0; b < 4; b++)
+	{
+		const physx::PxU32 size = (physx::PxU32)mBatches[b].vertices.size();
+		for (physx::PxU32 first = 0; first < size; first += CHUNK_SIZE)
+		{
+			Chunk chunk;
+			chunk.batch = b;
+			chunk.first = first;
+			chunk.count = physx::PxMin(CHUNK_SIZE, size - first);
+			mChunks.push_back(chunk);
+		}
+	}
+
+	mNumVertices = numVertices;
+}
+
+
+
+void SkinningEngine::setBoneMatrices(const physx::PxMat44* matrices, const int* mapping, physx::PxU32 numBones, float scale)
+{
+	mBoneMatrices.resize(numBones);
+	for (physx::PxU32 i = 0; i < numBones; i++)
+	{
+		mBoneMatrices[i] = matrices[mapping[i]] * scale;
+	}
+}
+
+
+
+void SkinningEngine::skin(const physx::PxVec3* positions, const physx::PxVec3* normals, physx::PxVec3* destPositions, physx::PxVec3* destNormals)
+{
+	if (mChunks.empty())
+	{
+		return;
+	}
+
+	if (mNumVertices >= PARALLEL_THRESHOLD && mWorkers == NULL)
+	{
+		mWorkers = WorkerPool::acquire();
+	}
+
+	if (mWorkers != NULL && mChunks.size() > 1)
+	{
+		SkinningJob job(*this, positions, normals, destPositions, destNormals);
+		mWorkers->run(job, (physx::PxU32)mChunks.size());
+	}
+	else
+	{
+		for (size_t i = 0; i < mChunks.size(); i++)
+		{
+			skinChunk(mChunks[i], positions, normals, destPositions, destNormals);
+		}
+	}
+}
+
+
+
+void SkinningEngine::skinChunk(const Chunk& chunk, const physx::PxVec3* positions, const physx::PxVec3* normals, physx::PxVec3* destPositions, physx::PxVec3* destNormals) const
+{
+	const Batch& batch = mBatches[chunk.batch];
+	const physx::PxMat44* bones = &mBoneMatrices[0];
+
+	switch (chunk.batch)
+	{
+	case 0:
+		skinBatch<1>(batch, chunk.first, chunk.count, bones, positions, normals, destPositions, destNormals);
+		break;
+	case 1:
+		skinBatch<2>(batch, chunk.first, chunk.count, bones, positions, normals, destPositions, destNormals);
+		break;
+	case 2:
+		skinBatch<3>(batch, chunk.first, chunk.count, bones, positions, normals, destPositions, destNormals);
+		break;
+	case 3:
+		skinBatch<4>(batch, chunk.first, chunk.count, bones, positions, normals, destPositions, destNormals);
+		break;
+	}
+}
+
+} // namespace Samples
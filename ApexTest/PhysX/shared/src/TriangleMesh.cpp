@@ -34,6 +34,7 @@
 #include "NxApexRenderDataFormat.h"
 #include "PxFileBuffer.h"
 #include "NxClothingIsoMesh.h"
+#include "WorkerPool.h"
 
 #include "foundation/PxStrideIterator.h"
 
@@ -44,6 +45,9 @@
 
 #include <algorithm>
 #include <vector>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
 
 #if defined(PX_PS3)
 #include "RendererConfig.h"
@@ -76,7 +80,7 @@
 #include <SampleAssetManager.h>
 #endif
 
-const physx::PxU32 OBJ_STR_LEN = 256;
+const size_t OBJ_CHUNK_SIZE = 1 << 20;
 
 #if defined(PX_WINDOWS)
 #define NOMINMAX
@@ -87,6 +91,13 @@ const physx::PxU32 OBJ_STR_LEN = 256;
 #include <stdio.h>
 #endif
 
+#if defined(PX_LINUX) || defined(PX_APPLE) || defined(PX_ANDROID)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <PsIntrinsics.h>
 
 mimp::MeshImport* gMeshImport = NULL; // has to be declared somewhere in the code
@@ -182,77 +193,714 @@ struct TexCoord
 };
 
 // -------------------------------------------------------------------
-struct SimpleVertexRef
+// Read-only view of a whole file, memory mapped where the platform supports it and read into a
+// buffer otherwise.
+class ObjFileView
 {
-	int vert, normal, texCoord;
-	int indexNr;
-	float handedNess;
+public:
+	ObjFileView() : mData(NULL), mSize(0)
+#if defined(PX_WINDOWS)
+		, mFile(INVALID_HANDLE_VALUE), mMapping(NULL)
+#endif
+	{
+	}
 
-	bool operator < (const SimpleVertexRef& r) const
+	~ObjFileView()
 	{
-		if (vert < r.vert)
+		close();
+	}
+
+	bool open(const char* filename)
+	{
+		close();
+#if defined(PX_WINDOWS)
+		mFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (mFile == INVALID_HANDLE_VALUE)
 		{
-			return true;
+			return false;
 		}
-		if (vert > r.vert)
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(mFile, &size))
 		{
+			close();
 			return false;
 		}
-		if (normal < r.normal)
+		mSize = (size_t)size.QuadPart;
+		if (mSize > 0)
 		{
-			return true;
+			mMapping = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+			mData = mMapping != NULL ? (const char*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+			if (mData == NULL)
+			{
+				close();
+				return false;
+			}
 		}
-		if (normal > r.normal)
+		return true;
+#elif defined(PX_LINUX) || defined(PX_APPLE) || defined(PX_ANDROID)
+		const int fd = ::open(filename, O_RDONLY);
+		if (fd < 0)
 		{
 			return false;
 		}
-		if (texCoord < r.texCoord)
+		struct stat info;
+		bool ok = fstat(fd, &info) == 0;
+		if (ok && info.st_size > 0)
 		{
-			return true;
+			void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			ok = data != MAP_FAILED;
+			if (ok)
+			{
+				madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+				mData = (const char*)data;
+				mSize = (size_t)info.st_size;
+			}
 		}
-		else if (texCoord > r.texCoord)
+		::close(fd);
+		return ok;
+#else
+		FILE* f = 0;
+		if (physx::fopen_s(&f, filename, "rb") != 0)
 		{
 			return false;
 		}
-		return handedNess > r.handedNess;
+		char block[16384];
+		size_t numRead;
+		while ((numRead = fread(block, 1, sizeof(block), f)) > 0)
+		{
+			mBuffer.insert(mBuffer.end(), block, block + numRead);
+		}
+		fclose(f);
+		mData = mBuffer.empty() ? NULL : &mBuffer[0];
+		mSize = mBuffer.size();
+		return true;
+#endif
 	}
-	bool operator == (const SimpleVertexRef& r) const
+
+	void close()
 	{
-		return vert == r.vert && normal == r.normal && texCoord == r.texCoord && handedNess == r.handedNess;
+#if defined(PX_WINDOWS)
+		if (mData != NULL)
+		{
+			UnmapViewOfFile(mData);
+		}
+		if (mMapping != NULL)
+		{
+			CloseHandle(mMapping);
+			mMapping = NULL;
+		}
+		if (mFile != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(mFile);
+			mFile = INVALID_HANDLE_VALUE;
+		}
+#elif defined(PX_LINUX) || defined(PX_APPLE) || defined(PX_ANDROID)
+		if (mData != NULL)
+		{
+			munmap((void*)mData, mSize);
+		}
+#else
+		std::vector<char>().swap(mBuffer);
+#endif
+		mData = NULL;
+		mSize = 0;
+	}
+
+	const char* begin() const
+	{
+		return mData;
 	}
-	void parse(char* s, int indexNr)
+	const char* end() const
 	{
-		int nr[3] = {0, 0, 0};
-		char* p = s;
-		int i = 0;
-		while (*p != 0 && i < 3 && sscanf(p, "%d", &nr[i]) == 1)
+		return mData + mSize;
+	}
+
+private:
+	const char* mData;
+	size_t mSize;
+#if defined(PX_WINDOWS)
+	HANDLE mFile;
+	HANDLE mMapping;
+#elif !defined(PX_LINUX) && !defined(PX_APPLE) && !defined(PX_ANDROID)
+	std::vector<char> mBuffer;
+#endif
+};
+
+// -------------------------------------------------------------------
+// One line aligned piece of an OBJ file. The chunks are parsed independently, v/vt/vn numbers in
+// faces are absolute so the per chunk arrays only have to be concatenated afterwards.
+struct ObjCorner
+{
+	int vert, texCoord, normal;
+};
+
+struct ObjGroup
+{
+	physx::PxU32 firstTriangle;	// triangles of the chunk that precede the usemtl or g line
+	bool isMaterial;
+	std::string name;
+};
+
+struct ObjChunk
+{
+	const char* begin;
+	const char* end;
+	std::vector<physx::PxVec3> vertices;
+	std::vector<physx::PxVec3> normals;
+	std::vector<physx::NxVertexUV> texCoords;
+	std::vector<ObjCorner> corners;			// three per triangle
+	std::vector<physx::PxU8> rightHanded;	// one per triangle
+	std::vector<ObjGroup> groups;
+	bool valid;
+};
+
+inline bool isObjSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline bool isObjDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+inline const char* skipObjSpace(const char* p, const char* end)
+{
+	while (p < end && isObjSpace(*p))
+	{
+		p++;
+	}
+	return p;
+}
+
+inline const char* skipObjToken(const char* p, const char* end)
+{
+	while (p < end && !isObjSpace(*p))
+	{
+		p++;
+	}
+	return p;
+}
+
+inline bool hasObjPrefix(const char* line, size_t length, const char* prefix)
+{
+	const size_t prefixLength = strlen(prefix);
+	return length >= prefixLength && strncmp(line, prefix, prefixLength) == 0;
+}
+
+// -------------------------------------------------------------------
+// Reads a float with the same result as sscanf("%f"). Plain decimals with up to 15 significant
+// digits and a small exponent are exact in double arithmetic, the double is then rounded to float
+// unless it sits exactly between two floats. Everything else goes through strtof.
+static bool parseObjFloat(const char*& p, const char* end, float& result)
+{
+	static const double powersOf10[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char* start = skipObjSpace(p, end);
+	const char* q = start;
+
+	bool negative = false;
+	if (q < end && (*q == '+' || *q == '-'))
+	{
+		negative = *q == '-';
+		q++;
+	}
+
+	physx::PxU64 mantissa = 0;
+	int numDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+	for (; q < end && isObjDigit(*q); q++)
+	{
+		anyDigits = true;
+		if (numDigits > 0 || *q != '0')
+		{
+			mantissa = numDigits < 16 ? mantissa * 10 + (*q - '0') : mantissa;
+			exponent += numDigits < 16 ? 0 : 1;
+			numDigits++;
+		}
+	}
+	if (q < end && *q == '.')
+	{
+		for (q++; q < end && isObjDigit(*q); q++)
 		{
-			while (*p != '/' && *p != 0)
+			anyDigits = true;
+			if (numDigits > 0 || *q != '0')
 			{
-				p++;
+				mantissa = numDigits < 16 ? mantissa * 10 + (*q - '0') : mantissa;
+				exponent -= numDigits < 16 ? 1 : 0;
+				numDigits++;
 			}
+			else
+			{
+				exponent--;
+			}
+		}
+	}
+	if (anyDigits && q < end && (*q == 'e' || *q == 'E'))
+	{
+		const char* e = q + 1;
+		bool negativeExponent = false;
+		if (e < end && (*e == '+' || *e == '-'))
+		{
+			negativeExponent = *e == '-';
+			e++;
+		}
+		if (e < end && isObjDigit(*e))
+		{
+			int value = 0;
+			for (; e < end && isObjDigit(*e); e++)
+			{
+				value = value < 10000 ? value * 10 + (*e - '0') : value;
+			}
+			exponent += negativeExponent ? -value : value;
+			q = e;
+		}
+	}
 
-			if (*p == 0)
+	if (anyDigits && numDigits <= 15 && (q == end || isObjSpace(*q)))
+	{
+		if (mantissa == 0)
+		{
+			result = negative ? -0.0f : 0.0f;
+			p = q;
+			return true;
+		}
+		if (exponent >= -22 && exponent <= 22)
+		{
+			double d = (double)mantissa;
+			d = exponent < 0 ? d / powersOf10[-exponent] : d * powersOf10[exponent];
+			if (d >= FLT_MIN && d <= FLT_MAX)
 			{
-				break;
+				physx::PxU64 bits;
+				memcpy(&bits, &d, sizeof(bits));
+				if ((bits & 0x1fffffff) != 0x10000000)
+				{
+					result = (float)(negative ? -d : d);
+					p = q;
+					return true;
+				}
 			}
+		}
+	}
+
+	// long mantissas, hex floats, inf, nan or trailing garbage
+	char buffer[64];
+	const size_t length = physx::PxMin<size_t>((size_t)(skipObjToken(start, end) - start), sizeof(buffer) - 1);
+	memcpy(buffer, start, length);
+	buffer[length] = 0;
+	char* stop = buffer;
+	const float value = strtof(buffer, &stop);
+	if (stop == buffer)
+	{
+		return false;
+	}
+	result = value;
+	p = start + (stop - buffer);
+	return true;
+}
+
+inline bool parseObjInt(const char* p, const char* end, int& result)
+{
+	bool negative = false;
+	if (p < end && (*p == '+' || *p == '-'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+	if (p == end || !isObjDigit(*p))
+	{
+		return false;
+	}
+	int value = 0;
+	for (; p < end && isObjDigit(*p); p++)
+	{
+		value = value * 10 + (*p - '0');
+	}
+	result = negative ? -value : value;
+	return true;
+}
 
+// v, v/t, v//n or v/t/n
+static ObjCorner parseObjCorner(const char* p, const char* end)
+{
+	int nr[3] = {0, 0, 0};
+	int i = 0;
+	while (p < end && i < 3 && parseObjInt(p, end, nr[i]))
+	{
+		while (p < end && *p != '/')
+		{
+			p++;
+		}
+
+		if (p == end)
+		{
+			break;
+		}
+
+		p++;
+		i++;
+		if (p < end && *p == '/')
+		{
 			p++;
 			i++;
-			if (*p == '/')
+		}
+	}
+	PX_ASSERT(nr[0] > 0);
+	ObjCorner corner;
+	corner.vert = nr[0] - 1;
+	corner.texCoord = nr[1] - 1;
+	corner.normal = nr[2] - 1;
+	return corner;
+}
+
+// -------------------------------------------------------------------
+static void parseObjChunk(ObjChunk& chunk)
+{
+	// like sscanf, values missing from a line keep the ones of the previous line
+	physx::PxVec3 v(0.0f);
+	physx::NxVertexUV tc(0.0f, 0.0f);
+
+	const char* line = chunk.begin;
+	while (line < chunk.end)
+	{
+		const char* lineEnd = (const char*)memchr(line, '\n', (size_t)(chunk.end - line));
+		const char* next = lineEnd != NULL ? lineEnd + 1 : chunk.end;
+		lineEnd = lineEnd != NULL ? lineEnd : chunk.end;
+		const size_t length = (size_t)(lineEnd - line);
+
+		if (hasObjPrefix(line, length, "usemtl") || hasObjPrefix(line, length, "g "))    // new group
+		{
+			ObjGroup group;
+			group.firstTriangle = (physx::PxU32)(chunk.corners.size() / 3);
+			group.isMaterial = line[0] == 'u';
+			const char* name = skipObjSpace(line + (group.isMaterial ? physx::PxMin<size_t>(7, length) : 2), lineEnd);
+			group.name.assign(name, skipObjToken(name, lineEnd));
+			chunk.groups.push_back(group);
+		}
+		else if (hasObjPrefix(line, length, "v "))  	// vertex
+		{
+			const char* p = line + 2;
+			parseObjFloat(p, lineEnd, v.x) && parseObjFloat(p, lineEnd, v.y) && parseObjFloat(p, lineEnd, v.z);
+			chunk.vertices.push_back(v);
+		}
+		else if (hasObjPrefix(line, length, "vn "))  	// normal
+		{
+			const char* p = line + 3;
+			parseObjFloat(p, lineEnd, v.x) && parseObjFloat(p, lineEnd, v.y) && parseObjFloat(p, lineEnd, v.z);
+			chunk.normals.push_back(v);
+		}
+		else if (hasObjPrefix(line, length, "vt "))  	// texture coords
+		{
+			const char* p = line + 3;
+			parseObjFloat(p, lineEnd, tc.u) && parseObjFloat(p, lineEnd, tc.v);
+			chunk.texCoords.push_back(tc);
+		}
+		else if (hasObjPrefix(line, length, "f "))  	// face, triangulated as a fan
+		{
+			ObjCorner ref[3];
+			size_t index = 0;
+			const char* p = skipObjSpace(line + 2, lineEnd);
+			while (p < lineEnd)
+			{
+				const char* tokenEnd = skipObjToken(p, lineEnd);
+				if (index >= 2)
+				{
+					ref[2] = parseObjCorner(p, tokenEnd);
+					chunk.corners.push_back(ref[0]);
+					chunk.corners.push_back(ref[1]);
+					chunk.corners.push_back(ref[2]);
+					ref[1] = ref[2];
+				}
+				else
+				{
+					ref[index] = parseObjCorner(p, tokenEnd);
+				}
+				index++;
+				p = skipObjSpace(tokenEnd, lineEnd);
+			}
+		}
+
+		line = next;
+	}
+}
+
+// -------------------------------------------------------------------
+// make sure that vertices with left/right handed tangent space don't get merged
+static void computeObjHandedness(ObjChunk& chunk, const std::vector<physx::PxVec3>& vertices, const std::vector<physx::PxVec3>& normals, const std::vector<physx::NxVertexUV>& texCoords)
+{
+	const int numVertices = (int)vertices.size();
+	const int numNormals = (int)normals.size();
+	const int numTexCoords = (int)texCoords.size();
+
+	const size_t numTriangles = chunk.corners.size() / 3;
+	chunk.rightHanded.resize(numTriangles);
+	chunk.valid = true;
+
+	for (size_t i = 0; i < numTriangles; i++)
+	{
+		const ObjCorner* refs = &chunk.corners[i * 3];
+
+		bool texCoordsOK = true;
+		for (int j = 0; j < 3; j++)
+		{
+			chunk.valid &= refs[j].vert >= 0 && refs[j].vert < numVertices && refs[j].normal < numNormals;
+			texCoordsOK &= refs[j].texCoord >= 0 && refs[j].texCoord < numTexCoords;
+		}
+		if (!chunk.valid)
+		{
+			return;
+		}
+
+		const physx::PxVec3 p0 = vertices[refs[0].vert];
+		const physx::PxVec3 p1 = vertices[refs[1].vert];
+		const physx::PxVec3 p2 = vertices[refs[2].vert];
+
+		float handedNess = 1.0f;
+
+		if (texCoordsOK)
+		{
+			const physx::PxVec3 faceNormal = (p1 - p0).cross(p2 - p0);
+
+			const physx::NxVertexUV w0 = texCoords[refs[0].texCoord];
+			const physx::NxVertexUV w1 = texCoords[refs[1].texCoord];
+			const physx::NxVertexUV w2 = texCoords[refs[2].texCoord];
+
+			const float x1 = p1.x - p0.x;
+			const float x2 = p2.x - p0.x;
+			const float y1 = p1.y - p0.y;
+			const float y2 = p2.y - p0.y;
+			const float z1 = p1.z - p0.z;
+			const float z2 = p2.z - p0.z;
+
+			const float s1 = w1.u - w0.u;
+			const float s2 = w2.u - w0.u;
+			const float t1 = w1.v - w0.v;
+			const float t2 = w2.v - w0.v;
+
+			const float r = 1.0F / (s1 * t2 - s2 * t1);
+			const physx::PxVec3 tangentDir((t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r);
+			const physx::PxVec3 bitangentDir((s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r);
+
+			handedNess = faceNormal.cross(tangentDir).dot(bitangentDir) > 0.0f ? 1.0f : -1.0f;
+		}
+
+		chunk.rightHanded[i] = handedNess > 0.0f ? 1 : 0;
+	}
+}
+
+// -------------------------------------------------------------------
+class ObjChunkJob : public WorkerPool::Job
+{
+public:
+	ObjChunkJob(std::vector<ObjChunk>& chunks) : chunks(chunks), vertices(NULL), normals(NULL), texCoords(NULL) {}
+
+	virtual void execute(physx::PxU32 item)
+	{
+		if (vertices == NULL)
+		{
+			parseObjChunk(chunks[item]);
+		}
+		else
+		{
+			computeObjHandedness(chunks[item], *vertices, *normals, *texCoords);
+		}
+	}
+
+	void run(WorkerPool* workers)
+	{
+		if (workers != NULL)
+		{
+			workers->run(*this, (physx::PxU32)chunks.size());
+		}
+		else
+		{
+			for (physx::PxU32 i = 0; i < chunks.size(); i++)
 			{
-				p++;
-				i++;
+				execute(i);
 			}
 		}
-		PX_ASSERT(nr[0] > 0);
-		vert = nr[0] - 1;
-		texCoord = nr[1] - 1;
-		normal = nr[2] - 1;
-		this->indexNr = indexNr;
 	}
+
+	std::vector<ObjChunk>& chunks;
+
+	// set for the second pass
+	const std::vector<physx::PxVec3>* vertices;
+	const std::vector<physx::PxVec3>* normals;
+	const std::vector<physx::NxVertexUV>* texCoords;
+
+private:
+	ObjChunkJob& operator=(const ObjChunkJob&);
 };
 
+// -------------------------------------------------------------------
+// Table of the distinct v/vn/vt/handedness combinations of an OBJ file. The first combination of
+// every position sits in an array indexed by the position, faces mostly reference nearby positions
+// so those lookups stay in cache. Further combinations (seams, hard edges) go into an open
+// addressed hash table with linear probing.
+class ObjVertexTable
+{
+public:
+	struct Key
+	{
+		int vert, normal, texCoord;
+		physx::PxU32 rightHanded;
+
+		bool operator == (const Key& k) const
+		{
+			return vert == k.vert && normal == k.normal && texCoord == k.texCoord && rightHanded == k.rightHanded;
+		}
+	};
+
+	ObjVertexTable(physx::PxU32 numPositions) : mNumSeams(0)
+	{
+		Slot empty;
+		empty.id = EMPTY;
+		mFirst.resize(numPositions, empty);
+		mSeams.resize(1024, empty);
+	}
+
+	// returns the id of the combination, ids are handed out in order of first appearance
+	physx::PxU32 insert(const Key& key)
+	{
+		Slot& first = mFirst[(physx::PxU32)key.vert];
+		if (first.id == EMPTY)
+		{
+			return add(first, key);
+		}
+		if (first.key == key)
+		{
+			return first.id;
+		}
+
+		const physx::PxU32 mask = (physx::PxU32)mSeams.size() - 1;
+		physx::PxU32 slot = hash(key) & mask;
+		while (mSeams[slot].id != EMPTY)
+		{
+			if (mSeams[slot].key == key)
+			{
+				return mSeams[slot].id;
+			}
+			slot = (slot + 1) & mask;
+		}
+
+		const physx::PxU32 id = add(mSeams[slot], key);
+		if (++mNumSeams * 2 > mSeams.size())
+		{
+			grow();
+		}
+		return id;
+	}
+
+	const std::vector<Key>& getKeys() const
+	{
+		return mKeys;
+	}
+
+private:
+	enum { EMPTY = 0xffffffff };
+
+	struct Slot
+	{
+		Key key;
+		physx::PxU32 id;
+	};
+
+	physx::PxU32 add(Slot& slot, const Key& key)
+	{
+		slot.key = key;
+		slot.id = (physx::PxU32)mKeys.size();
+		mKeys.push_back(key);
+		return slot.id;
+	}
+
+	static physx::PxU32 hash(const Key& key)
+	{
+		physx::PxU32 h = (physx::PxU32)key.vert * 0x9e3779b1u;
+		h = (h ^ (physx::PxU32)key.normal) * 0x85ebca77u;
+		h = (h ^ (physx::PxU32)key.texCoord) * 0xc2b2ae3du;
+		h ^= key.rightHanded;
+		return h ^ (h >> 16);
+	}
+
+	void grow()
+	{
+		std::vector<Slot> old;
+		old.swap(mSeams);
+
+		Slot empty;
+		empty.id = EMPTY;
+		mSeams.resize(old.size() * 2, empty);
+
+		const physx::PxU32 mask = (physx::PxU32)mSeams.size() - 1;
+		for (size_t i = 0; i < old.size(); i++)
+		{
+			if (old[i].id != EMPTY)
+			{
+				physx::PxU32 slot = hash(old[i].key) & mask;
+				while (mSeams[slot].id != EMPTY)
+				{
+					slot = (slot + 1) & mask;
+				}
+				mSeams[slot] = old[i];
+			}
+		}
+	}
+
+	std::vector<Slot> mFirst;
+	std::vector<Slot> mSeams;
+	physx::PxU32 mNumSeams;
+	std::vector<Key> mKeys;
+};
+
+// orders combinations sharing a position the way the vertices used to be sorted
+struct ObjVertexOrder
+{
+	ObjVertexOrder(const std::vector<ObjVertexTable::Key>& keys) : keys(keys) {}
+
+	bool operator()(physx::PxU32 a, physx::PxU32 b) const
+	{
+		const ObjVertexTable::Key& ka = keys[a];
+		const ObjVertexTable::Key& kb = keys[b];
+		if (ka.normal != kb.normal)
+		{
+			return ka.normal < kb.normal;
+		}
+		if (ka.texCoord != kb.texCoord)
+		{
+			return ka.texCoord < kb.texCoord;
+		}
+		return ka.rightHanded > kb.rightHanded;
+	}
+
+	const std::vector<ObjVertexTable::Key>& keys;
+
+private:
+	ObjVertexOrder& operator=(const ObjVertexOrder&);
+};
+
+static physx::PxU32 insertObjTriangles(ObjVertexTable& table, const ObjChunk& chunk, physx::PxU32 firstTriangle, physx::PxU32 lastTriangle, physx::PxU32* indices)
+{
+	for (physx::PxU32 i = firstTriangle; i < lastTriangle; i++)
+	{
+		for (physx::PxU32 j = 0; j < 3; j++)
+		{
+			const ObjCorner& corner = chunk.corners[i * 3 + j];
+			ObjVertexTable::Key key;
+			key.vert = corner.vert;
+			key.normal = corner.normal;
+			key.texCoord = corner.texCoord;
+			key.rightHanded = chunk.rightHanded[i];
+			*indices++ = table.insert(key);
+		}
+	}
+	return (lastTriangle - firstTriangle) * 3;
+}
+
 // ----------------------------------------------------------------------
 void TriangleSubMesh::setMaterialReference(SampleRenderer::RendererMaterial* material, SampleRenderer::RendererMaterialInstance* materialInstance)
 {
@@ -269,15 +917,90 @@ void TriangleSubMesh::setMaterialReference(SampleRenderer::RendererMaterial* mat
 
 	if (mRendererMaterialInstance == NULL && materialInstance != NULL && mRendererMaterialReference != NULL)
 	{
-		mRendererMaterialInstance = new SampleRenderer::RendererMaterialInstance(*mRendererMaterialReference);
+		mRendererMaterialInstance = new SampleRenderer::RendererMaterialInstance(*mRendererMaterialReference);
+	}
+
+	if (mRendererMaterialInstance != NULL && materialInstance != NULL)
+	{
+		// copy the values of all variables
+		*mRendererMaterialInstance = *materialInstance;
+	}
+#endif // USE_SAMPLE_RENDERER
+}
+
+// ----------------------------------------------------------------------
+void DirtyVertexRanges::add(physx::PxU32 first, physx::PxU32 count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	physx::PxU32 end = first + count;
+
+	// skip the ranges in front, then swallow all ranges that overlap or touch the new one
+	physx::PxU32 begin = 0;
+	while (begin < mNumRanges && mEnd[begin] < first)
+	{
+		begin++;
+	}
+	physx::PxU32 next = begin;
+	while (next < mNumRanges && mFirst[next] <= end)
+	{
+		first = physx::PxMin(first, mFirst[next]);
+		end = physx::PxMax(end, mEnd[next]);
+		next++;
+	}
+
+	if (next == begin)
+	{
+		for (physx::PxU32 i = mNumRanges; i > begin; i--)
+		{
+			mFirst[i] = mFirst[i - 1];
+			mEnd[i] = mEnd[i - 1];
+		}
+		mNumRanges++;
+	}
+	else if (next > begin + 1)
+	{
+		const physx::PxU32 removed = next - begin - 1;
+		for (physx::PxU32 i = next; i < mNumRanges; i++)
+		{
+			mFirst[i - removed] = mFirst[i];
+			mEnd[i - removed] = mEnd[i];
+		}
+		mNumRanges -= removed;
+	}
+	mFirst[begin] = first;
+	mEnd[begin] = end;
+
+	if (mNumRanges > MAX_RANGES)
+	{
+		// join the two neighbours with the smallest gap
+		physx::PxU32 closest = 0;
+		for (physx::PxU32 i = 1; i + 1 < mNumRanges; i++)
+		{
+			if (mFirst[i + 1] - mEnd[i] < mFirst[closest + 1] - mEnd[closest])
+			{
+				closest = i;
+			}
+		}
+		mEnd[closest] = mEnd[closest + 1];
+		for (physx::PxU32 i = closest + 1; i + 1 < mNumRanges; i++)
+		{
+			mFirst[i] = mFirst[i + 1];
+			mEnd[i] = mEnd[i + 1];
+		}
+		mNumRanges--;
 	}
+}
 
-	if (mRendererMaterialInstance != NULL && materialInstance != NULL)
+// ----------------------------------------------------------------------
+void DirtyVertexRanges::add(const DirtyVertexRanges& other)
+{
+	for (physx::PxU32 i = 0; i < other.mNumRanges; i++)
 	{
-		// copy the values of all variables
-		*mRendererMaterialInstance = *materialInstance;
+		add(other.mFirst[i], other.mEnd[i] - other.mFirst[i]);
 	}
-#endif // USE_SAMPLE_RENDERER
 }
 
 // ----------------------------------------------------------------------
@@ -286,6 +1009,13 @@ TriangleMesh::TriangleMesh(physx::PxU32 /*moduleIdentifier*/, SampleRenderer::Re
 	mStaticVertexBuffer(NULL),
 	mIndexBuffer(NULL),
 	mBoneBuffer(NULL),
+	mBoneWeightsVersion(0),
+	mRenderOptimization(0),
+	mRenderOrderOutdated(true),
+	mParent(NULL),
+	mNumChildren(0),
+	mVertexVersion(0),
+	mParentVertexVersion(0),
 	mTextureUVOrigin(physx::NxTextureUVOrigin::ORIGIN_TOP_LEFT),
 	mRenderer(renderer),
 	mRendererVertexBufferDynamic(NULL),
@@ -339,6 +1069,12 @@ void TriangleMesh::clear(physx::apex::NxUserRenderResourceManager* rrm, physx::a
 	vertexValuesChangedStatic = false;
 	vertexCountChanged = false;
 	indicesChanged = false;
+	mDirtyPositions.clear();
+	mDirtyNormals.clear();
+	mVertexFirstSplit.clear();
+	mVertexSplits.clear();
+	mVertexVersion++;
+	mRenderUploadStats = RenderUploadStats();
 
 	for (int i = 0; i < PC_NUM_CHANNELS; i++)
 	{
@@ -360,6 +1096,10 @@ void TriangleMesh::clear(physx::apex::NxUserRenderResourceManager* rrm, physx::a
 	mVertexMarks.clear();
 	mActiveSubmeshVertices.clear();
 
+	mRenderOrderOutdated = true;
+	mVertexCacheOriginal = VertexCacheStatistics();
+	mVertexCacheOptimized = VertexCacheStatistics();
+
 	for (physx::PxU32 i = 0; i < mSubMeshes.size(); i++)
 	{
 		if (mSubMeshes[i].mRenderResource != NULL)
@@ -469,6 +1209,11 @@ void TriangleMesh::clear(physx::apex::NxUserRenderResourceManager* rrm, physx::a
 	}
 #endif // USE_SAMPLE_RENDERER
 
+	if (mParent != NULL)
+	{
+		PX_ASSERT(mParent->mNumChildren > 0);
+		mParent->mNumChildren--;
+	}
 	mParent = NULL;
 	mUseGpuSkinning = false;
 }
@@ -583,9 +1328,13 @@ void TriangleMesh::moveAboveGround(physx::PxF32 level)
 	}
 
 	const physx::PxF32 change = std::max(0.0f, level - lowest);
-	for (physx::PxU32 i = 0; i < mVertices.size(); i++)
+	if (change > 0.0f)
 	{
-		mVertices[i].y += change;
+		for (physx::PxU32 i = 0; i < mVertices.size(); i++)
+		{
+			mVertices[i].y += change;
+		}
+		markVerticesChanged(0, (physx::PxU32)mVertices.size(), RC_POSITION);
 	}
 	mBounds.minimum.y += change;
 	mBounds.maximum.y += change;
@@ -881,57 +1630,96 @@ bool TriangleMesh::loadFromObjFile(const std::string& filename, bool useCustomCh
 	initSingleMesh();
 	mName = filename;
 
-	// extract path
-	size_t slashPos = filename.rfind('\\', std::string::npos);
-	size_t columnPos = filename.rfind(':', std::string::npos);
+	ObjFileView file;
+	if (!file.open(filename.c_str()))
+	{
+		return false;
+	}
+
+	// cut the file into line aligned chunks and parse them in parallel
+	std::vector<ObjChunk> chunks;
+	chunks.reserve((size_t)(file.end() - file.begin()) / OBJ_CHUNK_SIZE + 1);
+	for (const char* begin = file.begin(); begin < file.end();)
+	{
+		const char* split = file.end();
+		if ((size_t)(file.end() - begin) > OBJ_CHUNK_SIZE)
+		{
+			const char* newLine = (const char*)memchr(begin + OBJ_CHUNK_SIZE, '\n', (size_t)(file.end() - begin) - OBJ_CHUNK_SIZE);
+			split = newLine != NULL ? newLine + 1 : file.end();
+		}
+		chunks.resize(chunks.size() + 1);
+		chunks.back().begin = begin;
+		chunks.back().end = split;
+		begin = split;
+	}
 
-	size_t pos = slashPos > columnPos ? slashPos : columnPos;
-	std::string path = pos == std::string::npos ? "" : filename.substr(0, pos);
+	WorkerPool* workers = chunks.size() > 1 ? WorkerPool::acquire() : NULL;
 
-	char s[OBJ_STR_LEN], ps[OBJ_STR_LEN];
-	physx::PxVec3 v;
-	physx::NxVertexUV tc;
-	std::vector<SimpleVertexRef> refs;
-	SimpleVertexRef ref[3];
+	ObjChunkJob job(chunks);
+	job.run(workers);
+	file.close();
 
-	int numIndices = 0;
 	std::vector<physx::PxVec3> vertices;
 	std::vector<physx::PxVec3> normals;
 	std::vector<physx::NxVertexUV> texCoords;
+	size_t numCorners = 0;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		vertices.insert(vertices.end(), chunks[i].vertices.begin(), chunks[i].vertices.end());
+		normals.insert(normals.end(), chunks[i].normals.begin(), chunks[i].normals.end());
+		texCoords.insert(texCoords.end(), chunks[i].texCoords.begin(), chunks[i].texCoords.end());
+		std::vector<physx::PxVec3>().swap(chunks[i].vertices);
+		std::vector<physx::PxVec3>().swap(chunks[i].normals);
+		std::vector<physx::NxVertexUV>().swap(chunks[i].texCoords);
+		numCorners += chunks[i].corners.size();
+	}
 
+	job.vertices = &vertices;
+	job.normals = &normals;
+	job.texCoords = &texCoords;
+	job.run(workers);
 
-	FILE* f = 0;
+	if (workers != NULL)
+	{
+		WorkerPool::release(workers);
+	}
 
-	if (physx::fopen_s(&f, filename.c_str(), "r") != 0)
+	for (size_t i = 0; i < chunks.size(); i++)
 	{
-		return false;
+		if (!chunks[i].valid)
+		{
+			return false;
+		}
 	}
 
+	// replay the groups and merge multiple v/n/t triplets, ids are first appearance order for now
+	mIndices.resize(numCorners);
+	physx::PxU32* indices = numCorners > 0 ? &mIndices[0] : NULL;
+	ObjVertexTable table((physx::PxU32)vertices.size());
+	physx::PxU32 numIndices = 0;
+
 	std::string groupName;
 	std::string useMtl;
 
-	// first a vertex ref is generated for each v/n/t combination
-	while (!feof(f))
+	for (size_t i = 0; i < chunks.size(); i++)
 	{
-		if (fgets(s, OBJ_STR_LEN, f) == NULL)
+		const ObjChunk& chunk = chunks[i];
+		physx::PxU32 triangle = 0;
+		for (size_t j = 0; j < chunk.groups.size(); j++)
 		{
-			break;
-		}
+			const ObjGroup& group = chunk.groups[j];
+			const physx::PxU32 numNew = insertObjTriangles(table, chunk, triangle, group.firstTriangle, indices + numIndices);
+			mSubMeshes[mSubMeshes.size() - 1].numIndices += numNew;
+			numIndices += numNew;
+			triangle = group.firstTriangle;
 
-		//wxMessageBox(s);
-		if (strncmp(s, "usemtl", 6) == 0 || strncmp(s, "g ", 2) == 0)    // new group
-		{
-			if (strncmp(s, "usemtl", 6) == 0)
+			if (group.isMaterial)
 			{
-				char sub[OBJ_STR_LEN];
-				sscanf(&s[7], "%s", sub);
-				useMtl = sub;
+				useMtl = group.name;
 			}
 			else
 			{
-				char sub[OBJ_STR_LEN];
-				sscanf(&s[2], "%s", sub);
-				groupName = sub;
+				groupName = group.name;
 			}
 
 			size_t numSubs = mSubMeshes.size();
@@ -939,7 +1727,7 @@ bool TriangleMesh::loadFromObjFile(const std::string& filename, bool useCustomCh
 			{
 				mSubMeshes.resize(numSubs + 1);
 				mSubMeshes[numSubs].init();
-				mSubMeshes[numSubs].firstIndex = (physx::PxU32)(mIndices.size());
+				mSubMeshes[numSubs].firstIndex = numIndices;
 				mSubMeshes[numSubs].materialName = useMtl;
 				mSubMeshes[numSubs].originalMaterialName = useMtl;
 			}
@@ -951,143 +1739,82 @@ bool TriangleMesh::loadFromObjFile(const std::string& filename, bool useCustomCh
 			size_t subNr = mSubMeshes.size() - 1;
 			mSubMeshes[subNr].name = groupName;
 		}
-		else if (strncmp(s, "v ", 2) == 0)  	// vertex
-		{
-			sscanf(s, "v %f %f %f", &v.x, &v.y, &v.z);
-			vertices.push_back(v);
-		}
-		else if (strncmp(s, "vn ", 3) == 0)  	// normal
-		{
-			sscanf(s, "vn %f %f %f", &v.x, &v.y, &v.z);
-			normals.push_back(v);
-		}
-		else if (strncmp(s, "vt ", 3) == 0)  	// texture coords
-		{
-			sscanf(s, "vt %f %f", &tc.u, &tc.v);
-			texCoords.push_back(tc);
-		}
-		else if (strncmp(s, "f ", 2) == 0)  	// face, tri or quad
-		{
-			size_t offset = 2;
-			size_t index = 0;
-			while (sscanf(s + offset, "%s", ps) > 0)
-			{
-				offset += strlen(ps);
-				while (s[offset] == ' ' || s[offset] == '\t')
-				{
-					offset++;
-				}
 
-				if (index >= 2)
-				{
-					// submit triangle
-					ref[2].parse(ps, 0);
-					ref[0].indexNr = numIndices++;
-					refs.push_back(ref[0]);
-					mIndices.push_back(0);
-					ref[1].indexNr = numIndices++;
-					refs.push_back(ref[1]);
-					mIndices.push_back(0);
-					ref[2].indexNr = numIndices++;
-					refs.push_back(ref[2]);
-					mIndices.push_back(0);
-					mSubMeshes[mSubMeshes.size() - 1].numIndices += 3;
-
-					ref[1] = ref[2];
-					index++;
-				}
-				else
-				{
-					ref[index].parse(ps, 0);
-					index++;
-				}
-			}
-		}
+		const physx::PxU32 numNew = insertObjTriangles(table, chunk, triangle, (physx::PxU32)(chunk.corners.size() / 3), indices + numIndices);
+		mSubMeshes[mSubMeshes.size() - 1].numIndices += numNew;
+		numIndices += numNew;
 	}
-	fclose(f);
+	std::vector<ObjChunk>().swap(chunks);
+
+	// vertices are ordered by position, normal, texture coordinate and handedness,
+	// a counting sort over the positions followed by small sorts within each position
+	const std::vector<ObjVertexTable::Key>& keys = table.getKeys();
+	const physx::PxU32 numKeys = (physx::PxU32)keys.size();
 
-	// make sure that vertices with left/right handed tangent space don't get merged
-	for (size_t i = 0; i < refs.size(); i += 3)
+	std::vector<physx::PxU32> firstKey(vertices.size() + 1, 0);
+	for (physx::PxU32 i = 0; i < numKeys; i++)
 	{
-		const physx::PxVec3 p0 = vertices[refs[i + 0].vert];
-		const physx::PxVec3 p1 = vertices[refs[i + 1].vert];
-		const physx::PxVec3 p2 = vertices[refs[i + 2].vert];
+		firstKey[keys[i].vert + 1]++;
+	}
+	for (size_t i = 1; i < firstKey.size(); i++)
+	{
+		firstKey[i] += firstKey[i - 1];
+	}
 
-		float handedNess = 1.0f;
+	std::vector<physx::PxU32> order(numKeys);
+	std::vector<physx::PxU32> next(firstKey.begin(), firstKey.end() - 1);
+	for (physx::PxU32 i = 0; i < numKeys; i++)
+	{
+		order[next[keys[i].vert]++] = i;
+	}
+	std::vector<physx::PxU32>().swap(next);
 
-		if (refs[i + 0].texCoord >= 0)
+	const ObjVertexOrder compare(keys);
+	for (size_t i = 0; i + 1 < firstKey.size(); i++)
+	{
+		if (firstKey[i + 1] - firstKey[i] > 1)
 		{
-			const physx::PxVec3 faceNormal = (p1 - p0).cross(p2 - p0);
-
-			const physx::NxVertexUV w0 = texCoords[refs[i + 0].texCoord];
-			const physx::NxVertexUV w1 = texCoords[refs[i + 1].texCoord];
-			const physx::NxVertexUV w2 = texCoords[refs[i + 2].texCoord];
-
-			const float x1 = p1.x - p0.x;
-			const float x2 = p2.x - p0.x;
-			const float y1 = p1.y - p0.y;
-			const float y2 = p2.y - p0.y;
-			const float z1 = p1.z - p0.z;
-			const float z2 = p2.z - p0.z;
-
-			const float s1 = w1.u - w0.u;
-			const float s2 = w2.u - w0.u;
-			const float t1 = w1.v - w0.v;
-			const float t2 = w2.v - w0.v;
-
-			const float r = 1.0F / (s1 * t2 - s2 * t1);
-			const physx::PxVec3 tangentDir((t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r);
-			const physx::PxVec3 bitangentDir((s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r);
-
-			handedNess = faceNormal.cross(tangentDir).dot(bitangentDir) > 0.0f ? 1.0f : -1.0f;
+			std::sort(order.begin() + firstKey[i], order.begin() + firstKey[i + 1], compare);
 		}
-
-		refs[i + 0].handedNess = handedNess;
-		refs[i + 1].handedNess = handedNess;
-		refs[i + 2].handedNess = handedNess;
 	}
 
-	// now we merge multiple v/n/t triplets
-	std::sort(refs.begin(), refs.end());
-
-	size_t readRefs = 0;
 	physx::PxVec3 defNormal(1.0f, 0.0f, 0.0f);
 	bool normalsOK = true;
 	int numTexCoords = (int)(texCoords.size());
 
-	while (readRefs < refs.size())
+	mVertices.resize(numKeys);
+	mNormals.resize(numKeys);
+	mTexCoords[0].resize(numKeys);
+	std::vector<physx::PxU32> vertNr(numKeys);
+	for (physx::PxU32 i = 0; i < numKeys; i++)
 	{
-		int vertNr = (int)(mVertices.size());
-		SimpleVertexRef& r = refs[readRefs];
-		mVertices.push_back(vertices[r.vert]);
+		const ObjVertexTable::Key& r = keys[order[i]];
+		vertNr[order[i]] = i;
+		mVertices[i] = vertices[r.vert];
 
 		if (r.normal >= 0)
 		{
-			mNormals.push_back(normals[r.normal]);
+			mNormals[i] = normals[r.normal];
 		}
 		else
 		{
-			mNormals.push_back(defNormal);
+			mNormals[i] = defNormal;
 			normalsOK = false;
 		}
 
 		if (r.texCoord >= 0 && r.texCoord < numTexCoords)
 		{
-
-			mTexCoords[0].push_back(texCoords[r.texCoord]);
+			mTexCoords[0][i] = texCoords[r.texCoord];
 		}
 		else
 		{
-			mTexCoords[0].push_back(physx::NxVertexUV(0.0f, 0.0f));
+			mTexCoords[0][i] = physx::NxVertexUV(0.0f, 0.0f);
 		}
+	}
 
-		mIndices[r.indexNr] = vertNr;
-		readRefs++;
-		while (readRefs < refs.size() && r == refs[readRefs])
-		{
-			mIndices[refs[readRefs].indexNr] = vertNr;
-			readRefs++;
-		}
+	for (size_t i = 0; i < mIndices.size(); i++)
+	{
+		mIndices[i] = vertNr[mIndices[i]];
 	}
 
 	complete(useCustomChannels);
@@ -1352,7 +2079,13 @@ bool TriangleMesh::loadFromParent(TriangleMesh* parent)
 		return false;
 	}
 
+	if (mParent != NULL)
+	{
+		mParent->mNumChildren--;
+	}
 	mParent = parent;
+	mParent->mNumChildren++;
+	mParentVertexVersion = mParent->mVertexVersion - 1;
 	mMaxBoneIndexExternal = mParent->mMaxBoneIndexExternal;
 	mMaxBoneIndexInternal = mParent->mMaxBoneIndexInternal;
 
@@ -2117,6 +2850,7 @@ void TriangleMesh::applyMorphDisplacements(const std::vector<physx::PxVec3>& dis
 			{
 				mVertices[i] = mParent->mVertices[i] + displacements[i];
 			}
+			markVerticesChanged(0, (physx::PxU32)mVertices.size(), RC_POSITION);
 
 			mUseGpuSkinning = false;
 		}
@@ -2437,6 +3171,8 @@ void TriangleMesh::updateRenderResourcesInternal(bool rewriteBuffers, physx::ape
 		mParent->updateRenderResourcesInternal(rewriteBuffers, rrm, userRenderData, false);
 	}
 
+	mRenderUploadStats = RenderUploadStats();
+
 	const physx::PxU32 numIndices = mParent != NULL ? (physx::PxU32)(mParent->mIndices.size()) : (physx::PxU32)(mIndices.size());
 	const physx::PxU32 numVertices = mParent != NULL ? (physx::PxU32)(mParent->mVertices.size()) : (physx::PxU32)(mVertices.size());
 
@@ -2465,6 +3201,8 @@ void TriangleMesh::updateRenderResourcesInternal(bool rewriteBuffers, physx::ape
 			physx::apex::NxApexRenderBoneBufferData boneWriteData;
 			boneWriteData.setSemanticData(physx::NxRenderBoneSemantic::POSE, &mSkinningMatrices[0], sizeof(physx::PxMat34Legacy), physx::NxRenderDataFormat::FLOAT3x4);
 			mBoneBuffer->writeBuffer(boneWriteData, 0, (physx::PxU32)mSkinningMatrices.size());
+			mRenderUploadStats.boneBytes += (physx::PxU32)(mSkinningMatrices.size() * sizeof(physx::PxMat34Legacy));
+			mRenderUploadStats.numWrites++;
 		}
 
 		skinningMatricesChanged = false;
@@ -2549,33 +3287,74 @@ void TriangleMesh::updateRenderResourcesInternal(bool rewriteBuffers, physx::ape
 	}
 
 
-	if (mDynamicVertexBuffer && (vertexValuesChangedDynamic || rewriteBuffers))
+	const bool dynamicBufferDirty = vertexValuesChangedDynamic || rewriteBuffers;
+	const bool parentVerticesChanged = mParent != NULL && mParentVertexVersion != mParent->mVertexVersion;
+	if (mDynamicVertexBuffer && (dynamicBufferDirty || parentVerticesChanged || !mDirtyPositions.isEmpty() || !mDirtyNormals.isEmpty()))
 	{
-		physx::apex::NxApexRenderVertexBufferData writeData;
+		bool rewriteAll = dynamicBufferDirty;
+
+		const physx::PxVec3* positions = NULL;
+		const physx::PxVec3* normals = NULL;
 
 		const physx::PxU32 numVertices = mParent != NULL ? (physx::PxU32)(mParent->mVertices.size()) : (physx::PxU32)(mVertices.size());
 		if (mSkinnedVertices.size() == numVertices && !mUseGpuSkinning)
 		{
 			PX_ASSERT(mSkinnedNormals.size() == mSkinnedVertices.size());
-			writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::POSITION, &mSkinnedVertices[0], sizeof(physx::PxVec3), physx::apex::NxRenderDataFormat::FLOAT3);
-			writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::NORMAL,   &mSkinnedNormals[0],  sizeof(physx::PxVec3), physx::apex::NxRenderDataFormat::FLOAT3);
+			positions = &mSkinnedVertices[0];
+			normals = &mSkinnedNormals[0];
+		}
+		else
+		{
+			std::vector<physx::PxVec3>& sourceVertices = mParent != NULL ? mParent->mVertices : mVertices;
+			std::vector<physx::PxVec3>& sourceNormals = mParent != NULL ? mParent->mNormals : mNormals;
+			PX_ASSERT(sourceVertices.size() == numVertices);
+			PX_ASSERT(sourceNormals.size()  == numVertices);
+			positions = &sourceVertices[0];
+			normals = &sourceNormals[0];
+
+			// which parent vertices changed is not known here
+			rewriteAll |= parentVerticesChanged;
+		}
+
+		// every write has to carry all semantics of the buffer, so both channels go out for the union of their ranges
+		DirtyVertexRanges ranges;
+		if (rewriteAll)
+		{
+			ranges.add(0, numVertices);
 		}
 		else
 		{
-			std::vector<physx::PxVec3>& vertices = mParent != NULL ? mParent->mVertices : mVertices;
-			std::vector<physx::PxVec3>& normals = mParent != NULL ? mParent->mNormals : mNormals;
-			PX_ASSERT(vertices.size() == numVertices);
-			PX_ASSERT(normals.size()  == numVertices);
-			writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::POSITION, &vertices[0], sizeof(physx::PxVec3), physx::apex::NxRenderDataFormat::FLOAT3);
-			writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::NORMAL,   &normals[0],  sizeof(physx::PxVec3), physx::apex::NxRenderDataFormat::FLOAT3);
+			ranges.add(mDirtyPositions);
+			ranges.add(mDirtyNormals);
+		}
+
+		for (physx::PxU32 i = 0; i < ranges.getNumRanges() && ranges.getFirst(i) < numVertices; i++)
+		{
+			const physx::PxU32 firstVertex = ranges.getFirst(i);
+			const physx::PxU32 numRangeVertices = physx::PxMin(ranges.getCount(i), numVertices - firstVertex);
+
+			physx::apex::NxApexRenderVertexBufferData writeData;
+			writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::POSITION, positions + firstVertex, sizeof(physx::PxVec3), physx::apex::NxRenderDataFormat::FLOAT3);
+			writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::NORMAL,   normals + firstVertex,   sizeof(physx::PxVec3), physx::apex::NxRenderDataFormat::FLOAT3);
+			mDynamicVertexBuffer->writeBuffer(writeData, firstVertex, numRangeVertices);
+
+			mRenderUploadStats.dynamicBytes += numRangeVertices * (physx::PxU32)(2 * sizeof(physx::PxVec3));
+			mRenderUploadStats.numWrites++;
 		}
-		mDynamicVertexBuffer->writeBuffer(writeData, 0, numVertices);
 		vertexValuesChangedDynamic = false;
 	}
+	mDirtyPositions.clear();
+	mDirtyNormals.clear();
+	if (mParent != NULL)
+	{
+		mParentVertexVersion = mParent->mVertexVersion;
+	}
 
+	// static vertices and indices are only written once after their buffers got created
 	if (mStaticVertexBuffer != NULL && vertexValuesChangedStatic)
 	{
 		physx::apex::NxApexRenderVertexBufferData writeData;
+		physx::PxU32 vertexSize = 0;
 
 		if (mParent == NULL || !mUseGpuSkinning)
 		{
@@ -2592,6 +3371,7 @@ void TriangleMesh::updateRenderResourcesInternal(bool rewriteBuffers, physx::ape
 				if (numTexCoords == numVertices)
 				{
 					writeData.setSemanticData(semantics[i], mParent != NULL ? &mParent->mTexCoords[i][0] : &mTexCoords[i][0], sizeof(physx::apex::NxVertexUV), physx::apex::NxRenderDataFormat::FLOAT2);
+					vertexSize += sizeof(physx::apex::NxVertexUV);
 				}
 			}
 
@@ -2601,13 +3381,17 @@ void TriangleMesh::updateRenderResourcesInternal(bool rewriteBuffers, physx::ape
 				PX_ASSERT(mParent == NULL);
 				writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::BONE_INDEX,  &mBoneIndicesInternal[0], sizeof(physx::PxU16) * 4, physx::apex::NxRenderDataFormat::USHORT4);
 				writeData.setSemanticData(physx::apex::NxRenderVertexSemantic::BONE_WEIGHT, &mBoneWeights[0], sizeof(physx::PxVec4), physx::apex::NxRenderDataFormat::FLOAT4);
+				vertexSize += sizeof(physx::PxU16) * 4 + sizeof(physx::PxVec4);
 			}
 		}
 		mStaticVertexBuffer->writeBuffer(writeData, 0, numVertices);
 		vertexValuesChangedStatic = false;
+
+		mRenderUploadStats.staticBytes += numVertices * vertexSize;
+		mRenderUploadStats.numWrites++;
 	}
 
-	if (mIndexBuffer != NULL && numIndices == 0 || vertexCountChanged)
+	if (mIndexBuffer != NULL && (numIndices == 0 || vertexCountChanged))
 	{
 		rrm.releaseIndexBuffer(*mIndexBuffer);
 		mIndexBuffer = NULL;
@@ -2628,6 +3412,9 @@ void TriangleMesh::updateRenderResourcesInternal(bool rewriteBuffers, physx::ape
 	{
 		mIndexBuffer->writeBuffer(mParent != NULL ? &mParent->mIndices[0] : &mIndices[0], sizeof(physx::PxU32), 0, mParent != NULL ? (physx::PxU32)(mParent->mIndices.size()) : (physx::PxU32)(mIndices.size()));
 		indicesChanged = false;
+
+		mRenderUploadStats.indexBytes += numIndices * (physx::PxU32)sizeof(physx::PxU32);
+		mRenderUploadStats.numWrites++;
 	}
 
 	if (boneBufferSwitch || numIndices == 0 || numVertices == 0 || vertexCountChanged || oneCullModeChanged)
@@ -2757,6 +3544,8 @@ void TriangleMesh::updateRenderer(bool rewriteBuffers, bool overrideMaterial, bo
 		return;
 	}
 
+	mRenderUploadStats = RenderUploadStats();
+
 	const size_t numVertices = mParent != NULL ? mParent->mVertices.size() : mVertices.size();
 	const size_t numIndices  = mParent != NULL ? mParent->mIndices.size() : mIndices.size();
 
@@ -2785,37 +3574,62 @@ void TriangleMesh::updateRenderer(bool rewriteBuffers, bool overrideMaterial, bo
 		vertexBufferDynamicDirty = true;
 	}
 
+	// a child drawing the vertices of its parent rewrites them whenever the parent changed them
+	if (mParent != NULL && mParentVertexVersion != mParent->mVertexVersion)
+	{
+		vertexBufferDynamicDirty |= mSkinnedVertices.size() != numVertices || mSkinnedNormals.size() != numVertices;
+		mParentVertexVersion = mParent->mVertexVersion;
+	}
+
 	if (mRendererVertexBufferDynamic && vertexBufferDynamicDirty)
 	{
-		using SampleRenderer::RendererVertexBuffer;
+		mDirtyPositions.clear();
+		mDirtyPositions.add(0, (physx::PxU32)numVertices);
+		mDirtyNormals = mDirtyPositions;
+	}
 
-		physx::PxStrideIterator<physx::PxVec3> positions;
-		{
-			unsigned int stride = 0;
-			void* data = mRendererVertexBufferDynamic->lockSemantic(RendererVertexBuffer::SEMANTIC_POSITION, stride);
-			positions = PxMakeIterator((physx::PxVec3*)data, stride);
-		}
-		physx::PxStrideIterator<physx::PxVec3> normals;
-		{
-			unsigned int stride = 0;
-			void* data = mRendererVertexBufferDynamic->lockSemantic(RendererVertexBuffer::SEMANTIC_NORMAL, stride);
-			normals = PxMakeIterator((physx::PxVec3*)data, stride);
-		}
+	if (mRendererVertexBufferDynamic && (!mDirtyPositions.isEmpty() || !mDirtyNormals.isEmpty()))
+	{
+		using SampleRenderer::RendererVertexBuffer;
 
 		std::vector<physx::PxVec3>& realVertices = mParent != NULL ? mParent->mVertices : mVertices;
 		std::vector<physx::PxVec3>& realNormals = mParent != NULL ? mParent->mNormals : mNormals;
 		
 		physx::PxVec3* inPositions = mSkinnedVertices.size() == realVertices.size() ? &mSkinnedVertices[0] : &realVertices[0];
 		physx::PxVec3* inNormals = mSkinnedNormals.size() == realNormals.size() ? &mSkinnedNormals[0] : &realNormals[0];
-		for (unsigned int i = 0; i < numVertices; i++)
+
+		// the semantics are locked separately, so a channel without changes is not touched at all
+		const RendererVertexBuffer::Semantic semantics[2] = { RendererVertexBuffer::SEMANTIC_POSITION, RendererVertexBuffer::SEMANTIC_NORMAL };
+		const physx::PxVec3* inValues[2] = { inPositions, inNormals };
+		const DirtyVertexRanges* ranges[2] = { &mDirtyPositions, &mDirtyNormals };
+		for (physx::PxU32 c = 0; c < 2; c++)
 		{
-			positions[i] = inPositions[i];
-			normals[i] = inNormals[i];
-		}
+			if (ranges[c]->isEmpty())
+			{
+				continue;
+			}
 
-		mRendererVertexBufferDynamic->unlockSemantic(RendererVertexBuffer::SEMANTIC_POSITION);
-		mRendererVertexBufferDynamic->unlockSemantic(RendererVertexBuffer::SEMANTIC_NORMAL);
+			unsigned int stride = 0;
+			void* data = mRendererVertexBufferDynamic->lockSemantic(semantics[c], stride);
+			physx::PxStrideIterator<physx::PxVec3> values = PxMakeIterator((physx::PxVec3*)data, stride);
+
+			for (physx::PxU32 r = 0; r < ranges[c]->getNumRanges(); r++)
+			{
+				const physx::PxU32 first = ranges[c]->getFirst(r);
+				const physx::PxU32 last = physx::PxMin(first + ranges[c]->getCount(r), (physx::PxU32)numVertices);
+				for (physx::PxU32 i = first; i < last; i++)
+				{
+					values[i] = inValues[c][i];
+				}
+				mRenderUploadStats.dynamicBytes += last > first ? (last - first) * (physx::PxU32)sizeof(physx::PxVec3) : 0;
+			}
+
+			mRendererVertexBufferDynamic->unlockSemantic(semantics[c]);
+			mRenderUploadStats.numWrites++;
+		}
 	}
+	mDirtyPositions.clear();
+	mDirtyNormals.clear();
 
 
 	bool vertexBufferSharedDirty = rewriteBuffers || textureUvOriginChanged;
@@ -2916,6 +3730,10 @@ void TriangleMesh::updateRenderer(bool rewriteBuffers, bool overrideMaterial, bo
 		{
 			mRendererVertexBufferShared->unlockSemantic(RendererVertexBuffer::SEMANTIC_TEXCOORD0);
 		}
+
+		const size_t vertexSize = (hasBoneBuffer ? sizeof(ushort4) + sizeof(physx::PxVec4) : 0) + (hasTexCoords ? sizeof(physx::PxVec2) : 0);
+		mRenderUploadStats.staticBytes += (physx::PxU32)(numVertices * vertexSize);
+		mRenderUploadStats.numWrites++;
 	}
 
 	bool indexBufferDirty = rewriteBuffers;
@@ -2950,6 +3768,9 @@ void TriangleMesh::updateRenderer(bool rewriteBuffers, bool overrideMaterial, bo
 		}
 
 		mRendererIndexBuffer->unlock();
+
+		mRenderUploadStats.indexBytes += (physx::PxU32)(numIndices * sizeof(unsigned int));
+		mRenderUploadStats.numWrites++;
 	}
 
 	// only create render meshes and materials for a mesh we actually want to render
@@ -3147,7 +3968,7 @@ void TriangleMesh::skin(const SkeletalAnim& anim, float scale /* = 1.0f */)
 		return;
 	}
 
-	vertexValuesChangedDynamic = true;
+	markVerticesChanged(0, (physx::PxU32)numVerts);
 
 	if (mSkinnedVertices.size() != numVerts)
 	{
@@ -3159,67 +3980,18 @@ void TriangleMesh::skin(const SkeletalAnim& anim, float scale /* = 1.0f */)
 	PX_ASSERT((int)numBones > mMaxBoneIndexInternal);
 	PX_FORCE_PARAMETER_REFERENCE(numBones);
 
-	const physx::PxVec3* __restrict originalVertices = mParent == NULL || (mVertices.size() == mParent->mVertices.size()) ? &mVertices[0] : &mParent->mVertices[0];
-	const physx::PxVec3* __restrict originalNormals = mParent == NULL ? &mNormals[0] : &mParent->mNormals[0];
-	const physx::PxU16* __restrict skinningIndices = mParent == NULL ? &mBoneIndicesInternal[0] : &mParent->mBoneIndicesInternal[0];
-	const physx::PxVec4* __restrict skinningWeights = mParent == NULL ? &mBoneWeights[0] : &mParent->mBoneWeights[0];
-	physx::PxVec3* __restrict destVertices = &mSkinnedVertices[0];
-	physx::PxVec3* __restrict destNormals = &mSkinnedNormals[0];
-	physx::PxU32* __restrict numBoneWeights = mParent == NULL ? &mNumBoneWeights[0] : &mParent->mNumBoneWeights[0];
-
+	const physx::PxVec3* originalVertices = mParent == NULL || (mVertices.size() == mParent->mVertices.size()) ? &mVertices[0] : &mParent->mVertices[0];
+	const physx::PxVec3* originalNormals = mParent == NULL ? &mNormals[0] : &mParent->mNormals[0];
 
-	physx::prefetch128(skinningWeights, 0);
-
-	const size_t count16 = (numVerts + 15) / 16;
-	for (size_t i = 0; i < count16; i++)
+	const TriangleMesh& weightsOwner = mParent != NULL ? *mParent : *this;
+	if (!mSkinningEngine.isSetUp((physx::PxU32)numVerts, weightsOwner.mBoneWeightsVersion))
 	{
-		physx::PxU32 numBoneWeight = *numBoneWeights;
-
-		const size_t maxVerts = (i + 1) * 16 > numVerts ? numVerts - (i * 16) : 16;
-
-		for (size_t j = 0; j < maxVerts; j++)
-		{
-			physx::prefetch128(skinningWeights + 1, 0);
-
-			size_t twoBit = numBoneWeight & 0x3;
-			numBoneWeight >>= 2;
-
-			const physx::PxVec3 v = *originalVertices;
-			const physx::PxVec3 n = *originalNormals;
-
-			physx::PxVec3 vs(0.0f, 0.0f, 0.0f);
-			physx::PxVec3 ns(0.0f, 0.0f, 0.0f);
-
-			physx::PxVec4 skinningWeight = *skinningWeights;
-
-			for (unsigned int k = 0; k <= twoBit; k++)
-			{
-				//const physx::PxU32 weightIdx = i*4 + k;
-				PX_ASSERT(physx::PxIsFinite(skinningWeight[k]));
-				const float weight = skinningWeight[k];
-
-				PX_ASSERT(weight > 0.0f);
-				const physx::PxU16 boneNr = skinningIndices[k];
-
-				vs += mSkinningMatrices[boneNr] * v * weight;
-				ns += mSkinningMatrices[boneNr].M * n * weight;
-			}
-			ns *= physx::recipSqrtFast(ns.magnitudeSquared());
-			//ns.normalize();
-
-			*destVertices = vs;
-			*destNormals = ns;
-
-			originalVertices++;
-			originalNormals++;
-			skinningWeights++;
-			skinningIndices += 4;
-			destVertices++;
-			destNormals++;
-		}
-
-		numBoneWeights++;
+		mSkinningEngine.setup((physx::PxU32)numVerts, &weightsOwner.mBoneIndicesInternal[0], &weightsOwner.mBoneWeights[0], &weightsOwner.mNumBoneWeights[0]);
+		mSkinningEngine.setVersion(weightsOwner.mBoneWeightsVersion);
 	}
+
+	mSkinningEngine.setBoneMatrices(&skinningMatrices[0], &boneMappingInt2Ext[0], numSkinningMatricesNeeded, scale);
+	mSkinningEngine.skin(originalVertices, originalNormals, &mSkinnedVertices[0], &mSkinnedNormals[0]);
 }
 
 // ----------------------------------------------------------------------
@@ -3235,6 +4007,20 @@ void TriangleMesh::unskin()
 	PX_ASSERT(mSkinnedVertices.empty());
 }
 
+// ----------------------------------------------------------------------
+void TriangleMesh::markVerticesChanged(physx::PxU32 firstVertex, physx::PxU32 numVertices, physx::PxU32 channels /* = RC_ALL */)
+{
+	mVertexVersion++;
+	if ((channels & RC_POSITION) != 0)
+	{
+		mDirtyPositions.add(firstVertex, numVertices);
+	}
+	if ((channels & RC_NORMAL) != 0)
+	{
+		mDirtyNormals.add(firstVertex, numVertices);
+	}
+}
+
 // ----------------------------------------------------------------------
 void TriangleMesh::showSubmesh(size_t index, bool on)
 {
@@ -3387,6 +4173,7 @@ void TriangleMesh::displaceAlongNormal(float displacement)
 	{
 		mVertices[i] += mNormals[i] * displacement;
 	}
+	markVerticesChanged(0, (physx::PxU32)mVertices.size(), RC_POSITION);
 	updateBounds();
 }
 
@@ -4041,6 +4828,9 @@ void TriangleMesh::updatePaintingColors(PaintChannelType channelType, float maxD
 			mPaintChannels[PC_LATCH_TO_NEAREST_MASTER][i].color = color;
 		}
 	}
+
+	// every brush stroke ends up here, the painted vertices get their render data written again
+	markVerticesChanged(0, (physx::PxU32)mVertices.size());
 }
 
 // ----------------------------------------------------------------------
@@ -4314,6 +5104,7 @@ void TriangleMesh::updateNormals(int subMeshNr)
 		{
 			mNormals[i] = newNormals[i];
 		}
+		markVerticesChanged(0, (physx::PxU32)mNormals.size(), RC_NORMAL);
 	}
 }
 
@@ -4434,6 +5225,8 @@ void TriangleMesh::updateBoneWeights()
 			mNumBoneWeights.clear();
 		}
 
+		// every change of the triangles ends up here
+		mRenderOrderOutdated = true;
 		optimizeForRendering();
 	}
 }
@@ -4443,6 +5236,15 @@ void TriangleMesh::optimizeForRendering()
 {
 	PX_ASSERT(mParent == NULL);
 
+	// the internal bone indices are rebuilt below
+	mBoneWeightsVersion++;
+
+	if (mRenderOrderOutdated && mRenderOptimization != 0)
+	{
+		optimizeRenderOrder();
+	}
+	mRenderOrderOutdated = false;
+
 	if (mBoneWeights.size() == mVertices.size() && mVertices.size() > 0)
 	{
 		PX_ASSERT(mMaxBoneIndexExternal >= 0);
@@ -4589,6 +5391,152 @@ void TriangleMesh::optimizeForRendering()
 #endif
 }
 
+// ----------------------------------------------------------------------
+template<class T>
+static void remapVertexData(std::vector<T>& data, const std::vector<physx::PxU32>& oldToNew, size_t stride)
+{
+	if (data.size() != oldToNew.size() * stride)
+	{
+		return;
+	}
+
+	std::vector<T> remapped(data);
+	for (size_t i = 0; i < oldToNew.size(); i++)
+	{
+		for (size_t j = 0; j < stride; j++)
+		{
+			remapped[oldToNew[i] * stride + j] = data[i * stride + j];
+		}
+	}
+	data.swap(remapped);
+}
+
+// ----------------------------------------------------------------------
+void TriangleMesh::setRenderOptimization(physx::PxU32 flags)
+{
+	if (flags != mRenderOptimization)
+	{
+		mRenderOptimization = flags;
+		mRenderOrderOutdated = true;
+
+		if (mParent == NULL && !mIndices.empty())
+		{
+			optimizeForRendering();
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+void TriangleMesh::optimizeRenderOrder()
+{
+	const physx::PxU32 numVertices = (physx::PxU32)mVertices.size();
+	mVertexCacheOriginal = VertexCacheStatistics();
+	mVertexCacheOptimized = VertexCacheStatistics();
+
+	for (size_t i = 0; i < mSubMeshes.size(); i++)
+	{
+		const TriangleSubMesh& submesh = mSubMeshes[i];
+		if (submesh.numIndices < 3)
+		{
+			continue;
+		}
+		physx::PxU32* indices = &mIndices[submesh.firstIndex];
+
+		VertexCacheStatistics stats;
+		measureVertexCache(indices, submesh.numIndices, numVertices, stats);
+		mVertexCacheOriginal.add(stats);
+
+		if ((mRenderOptimization & (RO_VERTEX_CACHE | RO_OVERDRAW)) != 0)
+		{
+			std::vector<physx::PxU32> clusters;
+			const bool overdraw = (mRenderOptimization & RO_OVERDRAW) != 0;
+			optimizeVertexCache(indices, submesh.numIndices, numVertices, overdraw ? &clusters : NULL);
+			if (overdraw)
+			{
+				optimizeOverdraw(indices, submesh.numIndices, &mVertices[0], clusters);
+			}
+		}
+	}
+
+	// children combine the vertex arrays of this mesh with per vertex data of their own, so the vertices
+	// keep their numbers while there are any
+	if ((mRenderOptimization & RO_VERTEX_FETCH) != 0 && !mIndices.empty() && mNumChildren == 0)
+	{
+		std::vector<physx::PxU32> oldToNew;
+		optimizeVertexFetch(&mIndices[0], (physx::PxU32)mIndices.size(), numVertices, oldToNew);
+
+		remapVertexData(mVertices, oldToNew, 1);
+		remapVertexData(mNormals, oldToNew, 1);
+		remapVertexData(mTangents, oldToNew, 1);
+		remapVertexData(mBitangents, oldToNew, 1);
+		remapVertexData(mSkinnedVertices, oldToNew, 1);
+		remapVertexData(mSkinnedNormals, oldToNew, 1);
+		for (int i = 0; i < PC_NUM_CHANNELS; i++)
+		{
+			remapVertexData(mPaintChannels[i], oldToNew, 1);
+		}
+		for (int i = 0; i < NUM_TEXCOORDS; i++)
+		{
+			remapVertexData(mTexCoords[i], oldToNew, 1);
+		}
+		remapVertexData(mBoneIndicesExternal, oldToNew, 4);
+		remapVertexData(mBoneWeights, oldToNew, 1);
+
+		// 2 bits per vertex, see updateBoneWeights
+		if (mNumBoneWeights.size() == (numVertices + 15) / 16)
+		{
+			std::vector<physx::PxU32> numBoneWeights(mNumBoneWeights);
+			for (physx::PxU32 i = 0; i < numVertices; i++)
+			{
+				const physx::PxU32 count = (mNumBoneWeights[i / 16] >> ((i % 16) * 2)) & 0x3;
+				const physx::PxU32 newIndex = oldToNew[i];
+				const physx::PxU32 offset = (newIndex % 16) * 2;
+				numBoneWeights[newIndex / 16] = (numBoneWeights[newIndex / 16] & ~(0x3 << offset)) | count << offset;
+			}
+			mNumBoneWeights.swap(numBoneWeights);
+		}
+
+		// subdivide runs the reorder after its last split, keep the split vertices findable by their new numbers
+		if (mVertexFirstSplit.size() > numVertices)
+		{
+			mVertexFirstSplit.clear();
+			mVertexSplits.clear();
+		}
+		else if (!mVertexFirstSplit.empty())
+		{
+			std::vector<int> vertexFirstSplit(numVertices, -1);
+			for (size_t i = 0; i < mVertexFirstSplit.size(); i++)
+			{
+				vertexFirstSplit[oldToNew[i]] = mVertexFirstSplit[i];
+			}
+			mVertexFirstSplit.swap(vertexFirstSplit);
+			for (size_t i = 0; i < mVertexSplits.size(); i++)
+			{
+				mVertexSplits[i].adjVertNr = (int)oldToNew[mVertexSplits[i].adjVertNr];
+				mVertexSplits[i].newVertNr = (int)oldToNew[mVertexSplits[i].newVertNr];
+			}
+		}
+
+		// per vertex caches are rebuilt on demand
+		mActiveSubmeshVertices.clear();
+		mVertexMarks.clear();
+	}
+
+	for (size_t i = 0; i < mSubMeshes.size(); i++)
+	{
+		const TriangleSubMesh& submesh = mSubMeshes[i];
+		if (submesh.numIndices >= 3)
+		{
+			VertexCacheStatistics stats;
+			measureVertexCache(&mIndices[submesh.firstIndex], submesh.numIndices, numVertices, stats);
+			mVertexCacheOptimized.add(stats);
+		}
+	}
+
+	// vertex numbers changed, existing buffers are recreated and get their one upload again
+	vertexCountChanged = true;
+}
+
 // ----------------------------------------------------------------------
 void TriangleMesh::complete(bool useCustomChannels)
 {
@@ -0,0 +1,321 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+#include "VertexCacheOptimizer.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace Samples
+{
+
+// soft cluster boundaries are placed where the ACMR of the cluster so far drops below this,
+// lower values give fewer and longer clusters with better cache efficiency but less overdraw freedom
+static const float OVERDRAW_CLUSTER_ACMR = 0.65f;
+
+static const physx::PxU32 UNUSED_VERTEX = 0xffffffff;
+
+// ---------------------------------------------------------------------------
+void measureVertexCache(const physx::PxU32* indices, physx::PxU32 numIndices, physx::PxU32 numVertices, VertexCacheStatistics& stats)
+{
+	stats = VertexCacheStatistics();
+	stats.numTriangles = numIndices / 3;
+
+	// a vertex is in the FIFO if fewer than VERTEX_CACHE_SIZE vertices were transformed after it
+	std::vector<physx::PxU32> timestamps(numVertices, 0);
+	physx::PxU32 time = VERTEX_CACHE_SIZE + 1;
+
+	for (physx::PxU32 i = 0; i < stats.numTriangles * 3; i++)
+	{
+		const physx::PxU32 v = indices[i];
+		stats.numVertices += timestamps[v] == 0 ? 1 : 0;
+		if (time - timestamps[v] > VERTEX_CACHE_SIZE)
+		{
+			timestamps[v] = time++;
+			stats.numTransforms++;
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+void optimizeVertexCache(physx::PxU32* indices, physx::PxU32 numIndices, physx::PxU32 numVertices, std::vector<physx::PxU32>* clusters)
+{
+	if (clusters != NULL)
+	{
+		clusters->clear();
+	}
+
+	const physx::PxU32 numTriangles = numIndices / 3;
+	if (numTriangles == 0)
+	{
+		return;
+	}
+
+	// vertex to triangle adjacency
+	std::vector<physx::PxU32> firstTriangle(numVertices + 1, 0);
+	for (physx::PxU32 i = 0; i < numTriangles * 3; i++)
+	{
+		firstTriangle[indices[i] + 1]++;
+	}
+	for (physx::PxU32 v = 0; v < numVertices; v++)
+	{
+		firstTriangle[v + 1] += firstTriangle[v];
+	}
+	std::vector<physx::PxU32> adjacency(numTriangles * 3);
+	std::vector<physx::PxU32> liveTriangles(numVertices);
+	for (physx::PxU32 v = 0; v < numVertices; v++)
+	{
+		liveTriangles[v] = firstTriangle[v + 1] - firstTriangle[v];
+	}
+	{
+		std::vector<physx::PxU32> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+		for (physx::PxU32 i = 0; i < numTriangles * 3; i++)
+		{
+			adjacency[fill[indices[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<physx::PxU32> timestamps(numVertices, 0);
+	std::vector<bool> emitted(numTriangles, false);
+	std::vector<physx::PxU32> deadEnd;
+	std::vector<physx::PxU32> candidates;
+	std::vector<physx::PxU32> output;
+	output.reserve(numTriangles * 3);
+
+	physx::PxU32 time = VERTEX_CACHE_SIZE + 1;
+	physx::PxU32 cursor = 0;
+	bool hardBoundary = true;
+	int fanning = (int)indices[0];
+
+	while (fanning >= 0)
+	{
+		// emit all remaining triangles around the fanning vertex
+		candidates.clear();
+		for (physx::PxU32 a = firstTriangle[fanning]; a < firstTriangle[fanning + 1]; a++)
+		{
+			const physx::PxU32 t = adjacency[a];
+			if (emitted[t])
+			{
+				continue;
+			}
+			if (hardBoundary && clusters != NULL)
+			{
+				clusters->push_back((physx::PxU32)output.size() / 3);
+			}
+			hardBoundary = false;
+
+			for (physx::PxU32 j = 0; j < 3; j++)
+			{
+				const physx::PxU32 v = indices[t * 3 + j];
+				output.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				liveTriangles[v]--;
+				if (time - timestamps[v] > VERTEX_CACHE_SIZE)
+				{
+					timestamps[v] = time++;
+				}
+			}
+			emitted[t] = true;
+		}
+
+		// continue with the oldest candidate that stays in the cache while its remaining
+		// triangles are emitted, or any candidate with triangles left
+		fanning = -1;
+		int bestPriority = -1;
+		for (size_t i = 0; i < candidates.size(); i++)
+		{
+			const physx::PxU32 v = candidates[i];
+			if (liveTriangles[v] > 0)
+			{
+				int priority = 0;
+				if (time - timestamps[v] + 2 * liveTriangles[v] <= VERTEX_CACHE_SIZE)
+				{
+					priority = (int)(time - timestamps[v]);
+				}
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					fanning = (int)v;
+				}
+			}
+		}
+
+		if (fanning < 0)
+		{
+			// dead end, the cache contents are lost for the next fan
+			hardBoundary = true;
+			while (fanning < 0 && !deadEnd.empty())
+			{
+				const physx::PxU32 v = deadEnd.back();
+				deadEnd.pop_back();
+				fanning = liveTriangles[v] > 0 ? (int)v : -1;
+			}
+			for (; fanning < 0 && cursor < numTriangles * 3; cursor++)
+			{
+				fanning = liveTriangles[indices[cursor]] > 0 ? (int)indices[cursor] : -1;
+			}
+		}
+	}
+
+	PX_ASSERT(output.size() == numTriangles * 3);
+	memcpy(indices, &output[0], sizeof(physx::PxU32) * output.size());
+
+	if (clusters != NULL)
+	{
+		// split the hard clusters further where the cache has warmed up
+		std::vector<physx::PxU32> hardClusters;
+		hardClusters.swap(*clusters);
+		hardClusters.push_back(numTriangles);
+
+		for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+		{
+			const physx::PxU32 end = hardClusters[c + 1];
+			physx::PxU32 start = hardClusters[c];
+			physx::PxU32 misses = 0;
+			time += VERTEX_CACHE_SIZE + 1;
+			clusters->push_back(start);
+
+			for (physx::PxU32 t = start; t < end; t++)
+			{
+				for (physx::PxU32 j = 0; j < 3; j++)
+				{
+					const physx::PxU32 v = indices[t * 3 + j];
+					if (time - timestamps[v] > VERTEX_CACHE_SIZE)
+					{
+						timestamps[v] = time++;
+						misses++;
+					}
+				}
+				if (t + 1 < end && misses < OVERDRAW_CLUSTER_ACMR * (t + 1 - start))
+				{
+					start = t + 1;
+					misses = 0;
+					time += VERTEX_CACHE_SIZE + 1;
+					clusters->push_back(start);
+				}
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+struct OverdrawCluster
+{
+	float sortKey;
+	physx::PxU32 first;
+	physx::PxU32 count;
+
+	bool operator < (const OverdrawCluster& other) const
+	{
+		return sortKey != other.sortKey ? sortKey > other.sortKey : first < other.first;
+	}
+};
+
+void optimizeOverdraw(physx::PxU32* indices, physx::PxU32 numIndices, const physx::PxVec3* positions, const std::vector<physx::PxU32>& clusters)
+{
+	const physx::PxU32 numTriangles = numIndices / 3;
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	std::vector<OverdrawCluster> sorted(clusters.size());
+	std::vector<physx::PxVec3> clusterNormals(clusters.size(), physx::PxVec3(0.0f));
+	std::vector<physx::PxVec3> clusterCenters(clusters.size(), physx::PxVec3(0.0f));
+	physx::PxVec3 center(0.0f);
+	float totalArea = 0.0f;
+
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		sorted[c].first = clusters[c];
+		sorted[c].count = (c + 1 < clusters.size() ? clusters[c + 1] : numTriangles) - clusters[c];
+
+		float clusterArea = 0.0f;
+		for (physx::PxU32 t = sorted[c].first; t < sorted[c].first + sorted[c].count; t++)
+		{
+			const physx::PxVec3& p0 = positions[indices[t * 3 + 0]];
+			const physx::PxVec3& p1 = positions[indices[t * 3 + 1]];
+			const physx::PxVec3& p2 = positions[indices[t * 3 + 2]];
+			const physx::PxVec3 normal = (p1 - p0).cross(p2 - p0);
+			const float area = normal.magnitude();
+			const physx::PxVec3 centroid = (p0 + p1 + p2) * (1.0f / 3.0f);
+
+			clusterNormals[c] += normal;
+			clusterCenters[c] += centroid * area;
+			clusterArea += area;
+		}
+
+		center += clusterCenters[c];
+		totalArea += clusterArea;
+		clusterCenters[c] = clusterArea > 0.0f ? clusterCenters[c] / clusterArea : positions[indices[sorted[c].first * 3]];
+	}
+	center = totalArea > 0.0f ? center / totalArea : center;
+
+	// clusters on the outside facing away from the center occlude the inner ones, draw them first
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		physx::PxVec3 normal = clusterNormals[c];
+		normal.normalize();
+		sorted[c].sortKey = (clusterCenters[c] - center).dot(normal);
+	}
+	std::sort(sorted.begin(), sorted.end());
+
+	std::vector<physx::PxU32> output(indices, indices + numTriangles * 3);
+	physx::PxU32* dst = indices;
+	for (size_t c = 0; c < sorted.size(); c++)
+	{
+		memcpy(dst, &output[sorted[c].first * 3], sizeof(physx::PxU32) * sorted[c].count * 3);
+		dst += sorted[c].count * 3;
+	}
+}
+
+// ---------------------------------------------------------------------------
+void optimizeVertexFetch(physx::PxU32* indices, physx::PxU32 numIndices, physx::PxU32 numVertices, std::vector<physx::PxU32>& oldToNew)
+{
+	oldToNew.assign(numVertices, UNUSED_VERTEX);
+	physx::PxU32 next = 0;
+
+	for (physx::PxU32 i = 0; i < numIndices; i++)
+	{
+		physx::PxU32& v = indices[i];
+		if (oldToNew[v] == UNUSED_VERTEX)
+		{
+			oldToNew[v] = next++;
+		}
+		v = oldToNew[v];
+	}
+
+	for (physx::PxU32 v = 0; v < numVertices; v++)
+	{
+		if (oldToNew[v] == UNUSED_VERTEX)
+		{
+			oldToNew[v] = next++;
+		}
+	}
+}
+
+} // namespace Samples
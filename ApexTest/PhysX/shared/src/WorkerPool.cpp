@@ -0,0 +1,197 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2012 NVIDIA Corporation. All rights reserved.
+#include "WorkerPool.h"
+
+#include "PsThread.h"
+#include "PsAtomic.h"
+#include "PsIntrinsics.h"
+
+#if defined(PX_WINDOWS)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Samples
+{
+
+static const physx::PxU32 MAX_THREADS = 16;
+
+WorkerPool* WorkerPool::sInstance = NULL;
+physx::PxU32 WorkerPool::sRefCount = 0;
+
+// guards sInstance and sRefCount, constructed before main so it cannot race and needs no foundation allocator
+typedef physx::shdfnd::MutexT<physx::shdfnd::RawAllocator> InstanceMutex;
+static InstanceMutex sInstanceMutex;
+
+// ---------------------------------------------------------------------------
+class WorkerPool::Worker : public physx::shdfnd::Thread
+{
+public:
+	Worker(WorkerPool& pool) : mPool(pool) {}
+
+	virtual void execute()
+	{
+		for (;;)
+		{
+			mStart.wait();
+			mStart.reset();
+			if (quitIsSignalled())
+			{
+				break;
+			}
+
+			mPool.work();
+			if (physx::shdfnd::atomicDecrement(&mPool.mPending) == 0)
+			{
+				mPool.mDone.set();
+			}
+		}
+	}
+
+	WorkerPool& mPool;
+	physx::shdfnd::Sync mStart;
+};
+
+
+
+// ---------------------------------------------------------------------------
+WorkerPool* WorkerPool::acquire()
+{
+	InstanceMutex::ScopedLock lock(sInstanceMutex);
+
+	if (sInstance == NULL)
+	{
+		const physx::PxU32 numWorkers = physx::PxMin<physx::PxU32>(getNumProcessors(), MAX_THREADS) - 1;
+		if (numWorkers == 0)
+		{
+			return NULL;
+		}
+		sInstance = PX_NEW(WorkerPool)(numWorkers);
+	}
+	sRefCount++;
+	return sInstance;
+}
+
+
+
+void WorkerPool::release(WorkerPool* pool)
+{
+	InstanceMutex::ScopedLock lock(sInstanceMutex);
+
+	PX_ASSERT(pool == sInstance && sRefCount > 0);
+	PX_FORCE_PARAMETER_REFERENCE(pool);
+	if (--sRefCount == 0)
+	{
+		PX_DELETE(sInstance);
+		sInstance = NULL;
+	}
+}
+
+
+
+void WorkerPool::run(Job& job, physx::PxU32 count)
+{
+	physx::shdfnd::Mutex::ScopedLock lock(mRunMutex);
+
+	mJob = &job;
+	mCount = (physx::PxI32)count;
+	mNextItem = 0;
+	mPending = (physx::PxI32)mWorkers.size();
+	mDone.reset();
+	physx::shdfnd::memoryBarrier();
+
+	for (size_t i = 0; i < mWorkers.size(); i++)
+	{
+		mWorkers[i]->mStart.set();
+	}
+
+	work();
+	mDone.wait();
+}
+
+
+
+WorkerPool::WorkerPool(physx::PxU32 numWorkers) :
+	mNextItem(0),
+	mPending(0),
+	mJob(NULL),
+	mCount(0)
+{
+	mWorkers.resize(numWorkers);
+	for (physx::PxU32 i = 0; i < numWorkers; i++)
+	{
+		mWorkers[i] = PX_NEW(Worker)(*this);
+		mWorkers[i]->setName("SampleWorker");
+		mWorkers[i]->start(physx::shdfnd::Thread::getDefaultStackSize());
+	}
+}
+
+
+
+WorkerPool::~WorkerPool()
+{
+	for (size_t i = 0; i < mWorkers.size(); i++)
+	{
+		mWorkers[i]->signalQuit();
+		mWorkers[i]->mStart.set();
+		mWorkers[i]->waitForQuit();
+		PX_DELETE(mWorkers[i]);
+	}
+}
+
+
+
+void WorkerPool::work()
+{
+	for (;;)
+	{
+		const physx::PxI32 item = physx::shdfnd::atomicIncrement(&mNextItem) - 1;
+		if (item >= mCount)
+		{
+			break;
+		}
+		mJob->execute((physx::PxU32)item);
+	}
+}
+
+
+
+physx::PxU32 WorkerPool::getNumProcessors()
+{
+#if defined(PX_WINDOWS)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (physx::PxU32)info.dwNumberOfProcessors;
+#else
+	const long num = sysconf(_SC_NPROCESSORS_ONLN);
+	return num > 0 ? (physx::PxU32)num : 1;
+#endif
+}
+
+} // namespace Samples
@@ -1,11 +1,14 @@
 #include "apex.h"
+#include <stdlib.h>
 
 Apex::Apex() :
     mNbThreads(8),
     mPhysics(0),
     mFoundation(0),
     mCooking(0),
-    mScene(0)
+    mScene(0),
+    pvdConnection(0),
+    mPvdCapture(0)
 
 {
     return;
@@ -24,6 +27,9 @@ Apex::~Apex()
     // remember to release the connection by manual in the end
     if (pvdConnection)
             pvdConnection->release();
+    // writes the last frames to disk
+    if (mPvdCapture)
+            mPvdCapture->release();
     mPhysics->release();
     mFoundation->release();
 
@@ -52,6 +58,8 @@ bool Apex::advance(float dt)
 void Apex::fetch()
 {
     gApexScene->fetchResults(true, NULL);
+    if(mPvdCapture)
+        mPvdCapture->endFrame(*mScene);
 }
 
 bool Apex::Init(ID3D11Device* dev, ID3D11DeviceContext* devcon)
@@ -196,6 +204,12 @@ bool Apex::InitPhysX()
     pvdConnection = PxVisualDebuggerExt::createConnection(mPhysics->getPvdConnectionManager(),
         pvd_host_ip, port, timeout, connectionFlags);
 
+    // no PVD running (e.g. headless servers): when APEXTEST_PVD_CAPTURE=<frames> is set, keep the
+    // last frames in memory and write them on shutdown, inspect them with PvdCaptureStats
+    const char*     captureFrames = getenv("APEXTEST_PVD_CAPTURE");
+    if(!pvdConnection && captureFrames && atoi(captureFrames) > 0)
+        mPvdCapture = PxVisualDebuggerExt::createCapture(*mPhysics, "ApexTest.pvdcap", PxU32(atoi(captureFrames)), connectionFlags);
+
     mPhysics->getVisualDebugger()->setVisualDebuggerFlag(PxVisualDebuggerFlags::eTRANSMIT_CONTACTS, true);
 
     return true;
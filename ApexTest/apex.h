@@ -4,6 +4,7 @@
 #include "PxPhysicsAPI.h"
 #include "PxVisualDebugger.h"
 #include "PxVisualDebuggerExt.h"
+#include "PxVisualDebuggerCapture.h"
 #include "PvdNetworkStreams.h"
 
 #include "PhysXHeightField.h"
@@ -62,6 +63,7 @@ private:
     PxU32                       mNbThreads;
     PxMaterial*					defaultMaterial;
     PVD::PvdConnection*	        pvdConnection;
+    PxVisualDebuggerCapture*    mPvdCapture;        // used when no PVD is listening
 };
 
 #endif
\ No newline at end of file